@@ -1141,7 +1141,8 @@ cdef class CoreWorker:
                      int64_t placement_group_bundle_index,
                      c_bool placement_group_capture_child_tasks,
                      c_string extension_data,
-                     override_environment_variables
+                     override_environment_variables,
+                     c_bool allow_out_of_order_execution=False
                      ):
         cdef:
             CRayFunction ray_function
@@ -1174,7 +1175,8 @@ cdef class CoreWorker:
                             c_placement_group_id,
                             placement_group_bundle_index),
                         placement_group_capture_child_tasks,
-                        c_override_environment_variables),
+                        c_override_environment_variables,
+                        allow_out_of_order_execution),
                     extension_data,
                     &c_actor_id))
 
@@ -426,7 +426,8 @@ class ActorClass:
                 placement_group=None,
                 placement_group_bundle_index=-1,
                 placement_group_capture_child_tasks=None,
-                override_environment_variables=None):
+                override_environment_variables=None,
+                allow_out_of_order_execution=False):
         """Configures and overrides the actor instantiation parameters.
 
         The arguments are the same as those that can be passed
@@ -468,7 +469,8 @@ class ActorClass:
                     placement_group_capture_child_tasks=(
                         placement_group_capture_child_tasks),
                     override_environment_variables=(
-                        override_environment_variables))
+                        override_environment_variables),
+                    allow_out_of_order_execution=allow_out_of_order_execution)
 
         return ActorOptionWrapper()
 
@@ -489,7 +491,8 @@ class ActorClass:
                 placement_group=None,
                 placement_group_bundle_index=-1,
                 placement_group_capture_child_tasks=None,
-                override_environment_variables=None):
+                override_environment_variables=None,
+                allow_out_of_order_execution=False):
         """Create an actor.
 
         This method allows more flexibility than the remote method because
@@ -529,6 +532,10 @@ class ActorClass:
             override_environment_variables: Environment variables to override
                 and/or introduce for this actor.  This is a dictionary mapping
                 variable names to their values.
+            allow_out_of_order_execution: Whether the actor may execute the
+                tasks from a caller in a different order than they were
+                submitted. Tasks then run as soon as their arguments are ready,
+                and callers do not wait on each other's sequence numbers.
 
         Returns:
             A handle to the newly created actor.
@@ -677,7 +684,8 @@ class ActorClass:
             # Store actor_method_cpu in actor handle's extension data.
             extension_data=str(actor_method_cpu),
             override_environment_variables=override_environment_variables
-            or dict())
+            or dict(),
+            allow_out_of_order_execution=allow_out_of_order_execution)
 
         actor_handle = ActorHandle(
             meta.language,
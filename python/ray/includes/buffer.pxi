@@ -1,4 +1,5 @@
 from cpython cimport Py_buffer, PyBytes_FromStringAndSize
+from cpython.buffer cimport PyBUF_WRITABLE
 from libc.stdint cimport int64_t, uintptr_t
 from libc.stdio cimport printf
 from libcpp.memory cimport shared_ptr
@@ -42,7 +43,10 @@ cdef class Buffer:
             self.buffer.get().Size())
 
     def __getbuffer__(self, Py_buffer* buffer, int flags):
-        buffer.readonly = 0
+        cdef c_bool readonly = self.buffer.get().IsReadOnly()
+        if readonly and (flags & PyBUF_WRITABLE):
+            raise BufferError("Buffer is read-only")
+        buffer.readonly = readonly
         buffer.buf = <char *>self.buffer.get().Data()
         buffer.format = 'B'
         buffer.internal = NULL
@@ -69,6 +73,8 @@ cdef class Buffer:
     def __getwritebuffer__(self, Py_ssize_t idx, void **p):
         if idx != 0:
             raise SystemError("accessing non-existent buffer segment")
+        if self.buffer.get().IsReadOnly():
+            raise BufferError("Buffer is read-only")
         if p != NULL:
             p[0] = <void*> self.buffer.get().Data()
         return self.size
@@ -205,6 +205,7 @@ cdef extern from "ray/common/buffer.h" namespace "ray" nogil:
     cdef cppclass CBuffer "ray::Buffer":
         uint8_t *Data() const
         size_t Size() const
+        c_bool IsReadOnly() const
 
     cdef cppclass LocalMemoryBuffer(CBuffer):
         LocalMemoryBuffer(uint8_t *data, size_t size, c_bool copy_data)
@@ -262,7 +263,8 @@ cdef extern from "ray/core_worker/common.h" nogil:
             c_pair[CPlacementGroupID, int64_t] placement_options,
             c_bool placement_group_capture_child_tasks,
             const unordered_map[c_string, c_string]
-            &override_environment_variables)
+            &override_environment_variables,
+            c_bool allow_out_of_order_execution)
 
     cdef cppclass CPlacementGroupCreationOptions \
             "ray::PlacementGroupCreationOptions":
@@ -65,9 +65,14 @@ cdef int64_t padded_length(int64_t offset, int64_t alignment):
     return ((offset + alignment - 1) // alignment) * alignment
 
 
-cdef uint8_t* aligned_address(uint8_t* addr, uint64_t alignment) nogil:
-    cdef uintptr_t u_addr = <uintptr_t>addr
-    return <uint8_t*>(((u_addr + alignment - 1) // alignment) * alignment)
+cdef uint8_t* aligned_address(const uint8_t* base, const uint8_t* addr,
+                              uint64_t alignment) nogil:
+    # Align the offset from the start of the serialized object rather than the
+    # absolute address. The two are the same when the object is written to an
+    # aligned buffer, but this also lets us read objects in place from
+    # unaligned buffers, such as task arguments inlined in the task spec.
+    cdef uint64_t offset = addr - base
+    return <uint8_t*>base + ((offset + alignment - 1) // alignment) * alignment
 
 
 cdef class SubBuffer:
@@ -188,7 +193,7 @@ def split_buffer(Buffer buf):
     cdef:
         const uint8_t *data = buf.buffer.get().Data()
         size_t size = buf.buffer.get().Size()
-        uint8_t[:] bufferview = buf
+        const uint8_t[:] bufferview = buf
         int64_t msgpack_bytes_length
 
     assert kMessagePackOffset <= size
@@ -210,7 +215,7 @@ def split_buffer(Buffer buf):
 
 @cython.boundscheck(False)
 @cython.wraparound(False)
-def unpack_pickle5_buffers(uint8_t[:] bufferview):
+def unpack_pickle5_buffers(const uint8_t[:] bufferview):
     cdef:
         const uint8_t *data = &bufferview[0]
         CPythonObject python_object
@@ -234,7 +239,7 @@ def unpack_pickle5_buffers(uint8_t[:] bufferview):
             data + inband_offset + inband_size, <int32_t>protobuf_size):
         raise ValueError("Protobuf object is corrupted.")
     buffers_segment = aligned_address(
-        <uint8_t*>data + inband_offset + inband_size + protobuf_size,
+        data, data + inband_offset + inband_size + protobuf_size,
         kMajorBufferAlign)
     pickled_buffers = []
     # Now read buffer meta
@@ -360,7 +365,7 @@ cdef class Pickle5Writer:
             # End of serialization. Writing more stuff will corrupt the memory.
             return
         # aligned to 64 bytes
-        ptr = aligned_address(ptr, kMajorBufferAlign)
+        ptr = aligned_address(&data[0], ptr, kMajorBufferAlign)
         for i in range(self.python_object.buffer_size()):
             buffer_addr = self.python_object.buffer(i).address()
             buffer_len = self.python_object.buffer(i).length()
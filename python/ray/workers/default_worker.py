@@ -2,6 +2,10 @@ import argparse
 import base64
 import json
 import time
+import select
+import signal
+import socket
+import struct
 import sys
 import os
 
@@ -109,12 +113,114 @@ parser.add_argument(
     help="A list of directories or jar files separated by colon that specify "
     "the search path for user code. This will be used as `CLASSPATH` in "
     "Java and `PYTHONPATH` in Python.")
+parser.add_argument(
+    "--zygote-fd",
+    required=False,
+    type=int,
+    default=None,
+    help="If set, this process is a zygote that forks workers on request from "
+    "the raylet, over the socket with this file descriptor.")
+
+
+# The messages between the raylet and a zygote: a type, a pid and a signal.
+# See src/ray/raylet/worker_zygote.h.
+ZYGOTE_MESSAGE = struct.Struct("=iii")
+# Requests from the raylet.
+ZYGOTE_FORK = 0
+ZYGOTE_KILL = 1
+# Messages to the raylet.
+ZYGOTE_READY = 0
+ZYGOTE_FORKED = 1
+ZYGOTE_WORKER_EXITED = 2
+
+
+def run_zygote(zygote_fd):
+    """Fork workers on request from the raylet.
+
+    The zygote sends its pid once it is initialized. For each fork request, it
+    forks a worker and replies with the worker's pid, or -1 if the fork
+    failed. It reaps its workers and tells the raylet when each one exits, and
+    it signals its workers for the raylet, so the raylet never signals a pid
+    that was recycled. This returns in each forked worker, which then goes on
+    to start like any other worker. The zygote exits once the raylet closes
+    the socket.
+    """
+    zygote_socket = socket.socket(fileno=zygote_fd)
+    # SIGCHLD wakes up the loop below through this pipe.
+    wakeup_read, wakeup_write = os.pipe()
+    os.set_blocking(wakeup_read, False)
+    os.set_blocking(wakeup_write, False)
+    signal.signal(signal.SIGCHLD, lambda signum, frame: None)
+    signal.set_wakeup_fd(wakeup_write)
+    workers = set()
+
+    def send(message_type, pid):
+        zygote_socket.sendall(ZYGOTE_MESSAGE.pack(message_type, pid, 0))
+
+    send(ZYGOTE_READY, os.getpid())
+    request = b""
+    while True:
+        readable, _, _ = select.select([zygote_socket, wakeup_read], [], [])
+        if wakeup_read in readable:
+            try:
+                while os.read(wakeup_read, 4096):
+                    pass
+            except BlockingIOError:
+                pass
+            while workers:
+                pid, _ = os.waitpid(-1, os.WNOHANG)
+                if pid == 0:
+                    break
+                workers.discard(pid)
+                send(ZYGOTE_WORKER_EXITED, pid)
+        if zygote_socket not in readable:
+            continue
+        data = zygote_socket.recv(ZYGOTE_MESSAGE.size - len(request))
+        if not data:
+            # The raylet closed the socket.
+            os._exit(0)
+        request += data
+        if len(request) < ZYGOTE_MESSAGE.size:
+            continue
+        request_type, pid, signum = ZYGOTE_MESSAGE.unpack(request)
+        request = b""
+        if request_type == ZYGOTE_KILL:
+            # A worker that was not reaped yet still holds its pid.
+            if pid in workers:
+                os.kill(pid, signum)
+            continue
+        # The worker waits until the raylet has the reply, so that the raylet
+        # knows its pid by the time it registers.
+        start_read, start_write = os.pipe()
+        try:
+            pid = os.fork()
+        except OSError:
+            pid = -1
+        if pid == 0:
+            signal.set_wakeup_fd(-1)
+            signal.signal(signal.SIGCHLD, signal.SIG_DFL)
+            zygote_socket.close()
+            os.close(wakeup_read)
+            os.close(wakeup_write)
+            os.close(start_write)
+            os.read(start_read, 1)
+            os.close(start_read)
+            return
+        if pid > 0:
+            workers.add(pid)
+        send(ZYGOTE_FORKED, pid)
+        os.close(start_read)
+        os.close(start_write)
+
+
 if __name__ == "__main__":
     # NOTE(sang): For some reason, if we move the code below
     # to a separate function, tensorflow will capture that method
     # as a step function. For more details, check out
     # https://github.com/ray-project/ray/pull/12225#issue-525059663.
     args = parser.parse_args()
+    if args.zygote_fd is not None:
+        run_zygote(args.zygote_fd)
     ray.ray_logging.setup_logger(args.logging_level, args.logging_format)
 
     if args.worker_type == "WORKER":
@@ -41,6 +41,9 @@ class Buffer {
 
   virtual bool IsPlasmaBuffer() const = 0;
 
+  /// Whether the data must not be written through this buffer.
+  virtual bool IsReadOnly() const { return false; }
+
   virtual ~Buffer(){};
 
   bool operator==(const Buffer &rhs) const {
@@ -172,6 +175,44 @@ class SharedMemoryBuffer : public Buffer {
   std::shared_ptr<Buffer> parent_;
 };
 
+/// Represents a read-only byte buffer that points into memory owned by another object,
+/// such as a bytes field of a protobuf message. The buffer keeps its owner alive, so the
+/// data stays valid for as long as the buffer is used without being copied.
+class AliasedBuffer : public Buffer {
+ public:
+  /// Constructor.
+  ///
+  /// \param owner The object that owns the data.
+  /// \param data The data pointer into the owner.
+  /// \param size The size of the data.
+  AliasedBuffer(std::shared_ptr<const void> owner, const uint8_t *data, size_t size)
+      : owner_(std::move(owner)), data_(data), size_(size) {}
+
+  /// The data must not be written through the returned pointer, see `IsReadOnly`.
+  uint8_t *Data() const override { return const_cast<uint8_t *>(data_); }
+
+  size_t Size() const override { return size_; }
+
+  bool OwnsData() const override { return true; }
+
+  bool IsPlasmaBuffer() const override { return false; }
+
+  bool IsReadOnly() const override { return true; }
+
+  ~AliasedBuffer() = default;
+
+ private:
+  AliasedBuffer &operator=(const AliasedBuffer &) = delete;
+  AliasedBuffer(const AliasedBuffer &) = delete;
+
+  /// The owner of the data.
+  std::shared_ptr<const void> owner_;
+  /// Pointer to the data.
+  const uint8_t *data_;
+  /// Size of the buffer.
+  size_t size_;
+};
+
 /// Represents a byte buffer for plasma object. This can be used to hold the
 /// reference to a plasma object (via the underlying plasma::PlasmaBuffer).
 class PlasmaBuffer : public Buffer {
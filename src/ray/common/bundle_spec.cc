@@ -14,6 +14,8 @@
 
 #include "ray/common/bundle_spec.h"
 
+#include <cctype>
+
 namespace ray {
 
 void BundleSpecification::ComputeResources() {
@@ -113,4 +115,43 @@ std::string GetOriginalResourceName(const std::string &resource) {
   return resource.substr(0, idx);
 }
 
+bool ParsePlacementGroupResource(const std::string &resource,
+                                 std::string *original_resource_name,
+                                 BundleID *bundle_id) {
+  static const std::string kGroupInfix = "_group_";
+  auto idx = resource.find(kGroupInfix);
+  if (idx == std::string::npos) {
+    return false;
+  }
+  const size_t suffix_start = idx + kGroupInfix.size();
+  const size_t hex_length = 2 * PlacementGroupID::Size();
+  if (resource.size() < suffix_start + hex_length) {
+    return false;
+  }
+  const size_t hex_start = resource.size() - hex_length;
+  int64_t bundle_index = -1;
+  if (hex_start != suffix_start) {
+    // With bundle index (e.g., CPU_group_i_zzz).
+    if (hex_start < suffix_start + 2 || resource[hex_start - 1] != '_') {
+      return false;
+    }
+    bundle_index = 0;
+    for (size_t i = suffix_start; i < hex_start - 1; i++) {
+      if (!std::isdigit(static_cast<unsigned char>(resource[i]))) {
+        return false;
+      }
+      bundle_index = bundle_index * 10 + (resource[i] - '0');
+    }
+  }
+  for (size_t i = hex_start; i < resource.size(); i++) {
+    if (!std::isxdigit(static_cast<unsigned char>(resource[i]))) {
+      return false;
+    }
+  }
+  *original_resource_name = resource.substr(0, idx);
+  *bundle_id = std::make_pair(PlacementGroupID::FromHex(resource.substr(hex_start)),
+                              bundle_index);
+  return true;
+}
+
 }  // namespace ray
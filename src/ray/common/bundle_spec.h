@@ -123,4 +123,16 @@ bool IsBundleIndex(const std::string &resource, const PlacementGroupID &group_id
 /// Return the original resource name of the placement group resource.
 std::string GetOriginalResourceName(const std::string &resource);
 
+/// Parse a placement group resource, e.g., CPU_group_i_YYY -> (CPU, (YYY, i)), or
+/// CPU_group_YYY -> (CPU, (YYY, -1)).
+///
+/// \param resource The formatted resource name.
+/// \param[out] original_resource_name The original resource name, e.g., CPU.
+/// \param[out] bundle_id The placement group and the bundle index, or -1 if the
+/// resource is for the whole placement group.
+/// \return Whether the resource is a placement group resource.
+bool ParsePlacementGroupResource(const std::string &resource,
+                                 std::string *original_resource_name,
+                                 BundleID *bundle_id);
+
 }  // namespace ray
@@ -14,19 +14,46 @@
 
 #include "ray/common/client_connection.h"
 
+#include <algorithm>
 #include <boost/asio/buffer.hpp>
 #include <boost/asio/generic/stream_protocol.hpp>
 #include <boost/asio/placeholders.hpp>
+#include <boost/asio/post.hpp>
 #include <boost/asio/read.hpp>
 #include <boost/asio/write.hpp>
 #include <boost/bind.hpp>
 #include <chrono>
+#include <cstring>
+#include <limits>
 #include <sstream>
 #include <thread>
 
 #include "ray/common/ray_config.h"
 #include "ray/util/util.h"
 
+namespace {
+
+/// The size of the header of a message: the cookie, type and length.
+const size_t kMessageHeaderSize = 3 * sizeof(int64_t);
+
+/// Advance a sequence of buffers past the given number of bytes, and drop the buffers
+/// that are used up.
+template <typename Buffer>
+void ConsumeBuffers(std::vector<Buffer> *buffers, size_t num_bytes) {
+  size_t num_used_up = 0;
+  while (num_used_up < buffers->size() &&
+         num_bytes >= boost::asio::buffer_size((*buffers)[num_used_up])) {
+    num_bytes -= boost::asio::buffer_size((*buffers)[num_used_up]);
+    num_used_up++;
+  }
+  buffers->erase(buffers->begin(), buffers->begin() + num_used_up);
+  if (!buffers->empty()) {
+    (*buffers)[0] += num_bytes;
+  }
+}
+
+}  // namespace
+
 namespace ray {
 
 Status ConnectSocketRetry(local_stream_socket &socket, const std::string &endpoint,
@@ -67,7 +94,8 @@ std::shared_ptr<ServerConnection> ServerConnection::Create(local_stream_socket &
 
 ServerConnection::ServerConnection(local_stream_socket &&socket)
     : socket_(std::move(socket)),
-      async_write_max_messages_(1),
+      async_write_max_messages_(
+          RayConfig::instance().client_connection_max_coalesced_writes()),
       async_write_queue_(),
       async_write_in_flight_(false),
       async_write_broken_pipe_(false) {}
@@ -82,22 +110,23 @@ ServerConnection::~ServerConnection() {
 Status ServerConnection::WriteBuffer(
     const std::vector<boost::asio::const_buffer> &buffer) {
   boost::system::error_code error;
-  // Loop until all bytes are written while handling interrupts.
+  // Write all the buffers at once, and loop until all bytes are written while handling
+  // interrupts.
   // When profiling with pprof, unhandled interrupts were being sent by the profiler to
   // the raylet process, which was causing synchronous reads and writes to fail.
+  std::vector<boost::asio::const_buffer> remaining;
   for (const auto &b : buffer) {
-    uint64_t bytes_remaining = boost::asio::buffer_size(b);
-    uint64_t position = 0;
-    while (bytes_remaining != 0) {
-      size_t bytes_written =
-          socket_.write_some(boost::asio::buffer(b + position, bytes_remaining), error);
-      position += bytes_written;
-      bytes_remaining -= bytes_written;
-      if (error.value() == EINTR) {
-        continue;
-      } else if (error.value() != boost::system::errc::errc_t::success) {
-        return boost_to_ray_status(error);
-      }
+    if (boost::asio::buffer_size(b) > 0) {
+      remaining.push_back(b);
+    }
+  }
+  while (!remaining.empty()) {
+    size_t bytes_written = socket_.write_some(remaining, error);
+    ConsumeBuffers(&remaining, bytes_written);
+    if (error.value() == EINTR) {
+      continue;
+    } else if (error.value() != boost::system::errc::errc_t::success) {
+      return boost_to_ray_status(error);
     }
   }
   return ray::Status::OK();
@@ -117,25 +146,39 @@ void ServerConnection::WriteBufferAsync(
 Status ServerConnection::ReadBuffer(
     const std::vector<boost::asio::mutable_buffer> &buffer) {
   boost::system::error_code error;
-  // Loop until all bytes are read while handling interrupts.
+  std::vector<boost::asio::mutable_buffer> remaining;
   for (const auto &b : buffer) {
-    uint64_t bytes_remaining = boost::asio::buffer_size(b);
-    uint64_t position = 0;
-    while (bytes_remaining != 0) {
-      size_t bytes_read =
-          socket_.read_some(boost::asio::buffer(b + position, bytes_remaining), error);
-      position += bytes_read;
-      bytes_remaining -= bytes_read;
-      if (error.value() == EINTR) {
-        continue;
-      } else if (error.value() != boost::system::errc::errc_t::success) {
-        return boost_to_ray_status(error);
-      }
+    if (boost::asio::buffer_size(b) > 0) {
+      remaining.push_back(b);
+    }
+  }
+  // Bytes that a client connection read ahead come first.
+  ConsumeReadBuffer(&remaining);
+  // Loop until all bytes are read while handling interrupts.
+  while (!remaining.empty()) {
+    size_t bytes_read = socket_.read_some(remaining, error);
+    ConsumeBuffers(&remaining, bytes_read);
+    if (error.value() == EINTR) {
+      continue;
+    } else if (error.value() != boost::system::errc::errc_t::success) {
+      return boost_to_ray_status(error);
     }
   }
   return Status::OK();
 }
 
+void ServerConnection::ConsumeReadBuffer(
+    std::vector<boost::asio::mutable_buffer> *buffer) {
+  while (read_buffer_start_ < read_buffer_end_ && !buffer->empty()) {
+    size_t num_bytes = std::min(read_buffer_end_ - read_buffer_start_,
+                                boost::asio::buffer_size(buffer->front()));
+    std::memcpy(buffer->front().data(), read_buffer_.data() + read_buffer_start_,
+                num_bytes);
+    read_buffer_start_ += num_bytes;
+    ConsumeBuffers(buffer, num_bytes);
+  }
+}
+
 void ServerConnection::ReadBufferAsync(
     const std::vector<boost::asio::mutable_buffer> &buffer,
     const std::function<void(const ray::Status &)> &handler) {
@@ -193,11 +236,14 @@ void ServerConnection::WriteMessageAsync(
   bytes_written_ += length;
 
   auto write_buffer = std::unique_ptr<AsyncWriteBuffer>(new AsyncWriteBuffer());
-  write_buffer->write_cookie = RayConfig::instance().ray_cookie();
-  write_buffer->write_type = type;
+  const int64_t header[3] = {RayConfig::instance().ray_cookie(), type, length};
   write_buffer->write_length = length;
-  write_buffer->write_message.resize(length);
-  write_buffer->write_message.assign(message, message + length);
+  write_buffer->write_message.resize(kMessageHeaderSize + length);
+  std::memcpy(write_buffer->write_message.data(), header, kMessageHeaderSize);
+  if (length > 0) {
+    std::memcpy(write_buffer->write_message.data() + kMessageHeaderSize, message,
+                length);
+  }
   write_buffer->handler = handler;
 
   auto size = async_write_queue_.size();
@@ -209,25 +255,23 @@ void ServerConnection::WriteMessageAsync(
   async_write_queue_.push_back(std::move(write_buffer));
 
   if (!async_write_in_flight_) {
-    DoAsyncWrites();
+    // Flush once the current handler returns, so that the messages it writes are
+    // coalesced into one write.
+    async_write_in_flight_ = true;
+    auto this_ptr = this->shared_from_this();
+    boost::asio::post(socket_.get_executor(), [this, this_ptr]() { DoAsyncWrites(); });
   }
 }
 
 void ServerConnection::DoAsyncWrites() {
-  // Make sure we were not writing to the socket.
-  RAY_CHECK(!async_write_in_flight_);
-  async_write_in_flight_ = true;
+  RAY_CHECK(async_write_in_flight_);
 
-  // Do an async write of everything currently in the queue to the socket.
+  // Do an async write of everything currently in the queue to the socket, up to the
+  // limit. Each message is a single buffer, so the messages are written with one
+  // system call.
   std::vector<boost::asio::const_buffer> message_buffers;
   int num_messages = 0;
   for (const auto &write_buffer : async_write_queue_) {
-    message_buffers.push_back(boost::asio::buffer(&write_buffer->write_cookie,
-                                                  sizeof(write_buffer->write_cookie)));
-    message_buffers.push_back(
-        boost::asio::buffer(&write_buffer->write_type, sizeof(write_buffer->write_type)));
-    message_buffers.push_back(boost::asio::buffer(&write_buffer->write_length,
-                                                  sizeof(write_buffer->write_length)));
     message_buffers.push_back(boost::asio::buffer(write_buffer->write_message));
     num_messages++;
     if (num_messages >= async_write_max_messages_) {
@@ -242,11 +286,12 @@ void ServerConnection::DoAsyncWrites() {
       write_buffer->handler(status);
       async_write_queue_.pop_front();
     }
-    // We finished writing, so mark that we're no longer doing an async write.
-    async_write_in_flight_ = false;
-    // If there is more to write, try to write the rest.
+    // If there is more to write, e.g., messages queued during the write or by the
+    // handlers, try to write the rest. Otherwise, we are no longer writing.
     if (!async_write_queue_.empty()) {
       DoAsyncWrites();
+    } else {
+      async_write_in_flight_ = false;
     }
   };
 
@@ -256,6 +301,7 @@ void ServerConnection::DoAsyncWrites() {
     call_handlers(ray::Status::IOError("Broken pipe"), num_messages);
     return;
   }
+  async_write_calls_ += 1;
   auto this_ptr = this->shared_from_this();
   boost::asio::async_write(
       ServerConnection::socket_, message_buffers,
@@ -307,42 +353,95 @@ void ClientConnection::Register() {
 }
 
 void ClientConnection::ProcessMessages() {
-  // Wait for a message header from the client. The message header includes the
-  // protocol version, the message type, and the length of the message.
-  std::vector<boost::asio::mutable_buffer> header{
-      boost::asio::buffer(&read_cookie_, sizeof(read_cookie_)),
-      boost::asio::buffer(&read_type_, sizeof(read_type_)),
-      boost::asio::buffer(&read_length_, sizeof(read_length_)),
-  };
-  boost::asio::async_read(
-      ServerConnection::socket_, header,
-      boost::bind(&ClientConnection::ProcessMessageHeader,
-                  shared_ClientConnection_from_this(), boost::asio::placeholders::error));
+  if (read_in_flight_) {
+    return;
+  }
+  read_in_flight_ = true;
+  if (handling_message_) {
+    // The message handler called us. The next message is processed once it returns.
+    return;
+  }
+  if (read_buffer_start_ < read_buffer_end_) {
+    // Messages may have been received already. Handle them on the event loop, like
+    // the messages that are read from the socket.
+    boost::asio::post(ServerConnection::socket_.get_executor(),
+                      boost::bind(&ClientConnection::ProcessReceivedMessages,
+                                  shared_ClientConnection_from_this()));
+  } else {
+    ReadMoreBytes(kMessageHeaderSize);
+  }
+}
+
+void ClientConnection::ProcessReceivedMessages() {
+  while (read_in_flight_) {
+    const size_t num_bytes = read_buffer_end_ - read_buffer_start_;
+    if (num_bytes < kMessageHeaderSize) {
+      ReadMoreBytes(kMessageHeaderSize);
+      return;
+    }
+    // The message header includes the protocol version, the message type, and the
+    // length of the message.
+    const uint8_t *header = read_buffer_.data() + read_buffer_start_;
+    std::memcpy(&read_cookie_, header, sizeof(read_cookie_));
+    std::memcpy(&read_type_, header + sizeof(read_cookie_), sizeof(read_type_));
+    std::memcpy(&read_length_, header + sizeof(read_cookie_) + sizeof(read_type_),
+                sizeof(read_length_));
+    // Make sure the ray cookie matches.
+    if (!CheckRayCookie()) {
+      ServerConnection::Close();
+      return;
+    }
+    if (num_bytes < kMessageHeaderSize + read_length_) {
+      ReadMoreBytes(kMessageHeaderSize + read_length_);
+      return;
+    }
+    const uint8_t *message = header + kMessageHeaderSize;
+    read_message_.assign(message, message + read_length_);
+    read_buffer_start_ += kMessageHeaderSize + read_length_;
+    ServerConnection::bytes_read_ += read_length_;
+    // This stops the loop, unless the handler calls ProcessMessages.
+    ProcessMessage(boost::system::error_code());
+  }
 }
 
-void ClientConnection::ProcessMessageHeader(const boost::system::error_code &error) {
+void ClientConnection::ReadMoreBytes(size_t min_bytes) {
+  // Move the start of the next message to the front of the buffer, and make room for
+  // the whole message and for the messages after it.
+  const size_t num_bytes = read_buffer_end_ - read_buffer_start_;
+  if (read_buffer_start_ > 0) {
+    std::memmove(read_buffer_.data(), read_buffer_.data() + read_buffer_start_,
+                 num_bytes);
+    read_buffer_start_ = 0;
+    read_buffer_end_ = num_bytes;
+  }
+  const size_t buffer_size = std::max(
+      min_bytes,
+      static_cast<size_t>(RayConfig::instance().client_connection_read_buffer_bytes()));
+  if (read_buffer_.size() != buffer_size) {
+    // Grow the buffer for a large message, and shrink it back after it.
+    read_buffer_.resize(buffer_size);
+    read_buffer_.shrink_to_fit();
+  }
+  ServerConnection::socket_.async_read_some(
+      boost::asio::buffer(read_buffer_.data() + read_buffer_end_,
+                          read_buffer_.size() - read_buffer_end_),
+      boost::bind(&ClientConnection::ProcessReadBytes, shared_ClientConnection_from_this(),
+                  boost::asio::placeholders::error,
+                  boost::asio::placeholders::bytes_transferred));
+}
+
+void ClientConnection::ProcessReadBytes(const boost::system::error_code &error,
+                                        size_t bytes_read) {
   if (error) {
     // If there was an error, disconnect the client.
     read_type_ = error_message_type_;
     read_length_ = 0;
+    read_message_.clear();
     ProcessMessage(error);
     return;
   }
-
-  // If there was no error, make sure the ray cookie matches.
-  if (!CheckRayCookie()) {
-    ServerConnection::Close();
-    return;
-  }
-
-  // Resize the message buffer to match the received length.
-  read_message_.resize(read_length_);
-  ServerConnection::bytes_read_ += read_length_;
-  // Wait for the message to be read.
-  boost::asio::async_read(
-      ServerConnection::socket_, boost::asio::buffer(read_message_),
-      boost::bind(&ClientConnection::ProcessMessage, shared_ClientConnection_from_this(),
-                  boost::asio::placeholders::error));
+  read_buffer_end_ += bytes_read;
+  ProcessReceivedMessages();
 }
 
 bool ClientConnection::CheckRayCookie() {
@@ -380,29 +479,158 @@ std::string ClientConnection::RemoteEndpointInfo() {
 void ClientConnection::ProcessMessage(const boost::system::error_code &error) {
   if (error) {
     read_type_ = error_message_type_;
+    if (message_ring_) {
+      // The client may have written more messages, e.g., an intentional disconnect,
+      // before it closed the socket. No more messages will arrive on the socket.
+      num_socket_messages_ = std::numeric_limits<int64_t>::max();
+      ring_paused_ = false;
+      while (ProcessRingMessages(std::numeric_limits<size_t>::max())) {
+      }
+    }
+  } else if (message_ring_) {
+    num_socket_messages_++;
+  }
+
+  read_in_flight_ = false;
+  handling_message_ = true;
+  HandleMessage(read_type_, read_message_);
+  if (ring_paused_ && num_socket_messages_ >= num_socket_markers_) {
+    // The messages that the client wrote to the ring after this one can be handled now.
+    ring_paused_ = false;
+    ProcessRingMessages(std::numeric_limits<size_t>::max());
   }
+  handling_message_ = false;
+}
 
+void ClientConnection::HandleMessage(int64_t type, const std::vector<uint8_t> &message) {
   int64_t start_ms = current_time_ms();
-  message_handler_(shared_ClientConnection_from_this(), read_type_, read_message_);
+  message_handler_(shared_ClientConnection_from_this(), type, message);
   int64_t interval = current_time_ms() - start_ms;
   if (interval > RayConfig::instance().handler_warning_timeout_ms()) {
     std::string message_type;
     if (message_type_enum_names_.empty()) {
-      message_type = std::to_string(read_type_);
+      message_type = std::to_string(type);
     } else {
-      message_type = message_type_enum_names_[read_type_];
+      message_type = message_type_enum_names_[type];
     }
     RAY_LOG(WARNING) << "[" << debug_label_ << "]ProcessMessage with type "
                      << message_type << " took " << interval << " ms.";
   }
 }
 
+void ClientConnection::AttachMessageRing(std::shared_ptr<SharedMemoryRing> ring) {
+  RAY_CHECK(!message_ring_);
+  message_ring_ = std::move(ring);
+}
+
+bool ClientConnection::HasOpenMessageRing() const {
+  return message_ring_ && ServerConnection::socket_.is_open();
+}
+
+bool ClientConnection::ProcessRingMessages(size_t max_messages) {
+  if (ring_paused_) {
+    return false;
+  }
+  // Keep the ring alive, in case a handler disconnects the client.
+  auto ring = message_ring_;
+  // The client rings the doorbell again for any message written after this.
+  ring->ClearNotified();
+  auto status = ring->Read(
+      max_messages, [this](int64_t type, const std::vector<uint8_t> &message) {
+        if (type == kMessageOnSocketType) {
+          // Wait for the message on the socket, unless it was already handled.
+          num_socket_markers_++;
+          ring_paused_ = num_socket_messages_ < num_socket_markers_;
+          return !ring_paused_;
+        }
+        HandleMessage(type, message);
+        // Stop once the client is disconnected.
+        return ServerConnection::socket_.is_open();
+      });
+  if (!status.ok()) {
+    // The client wrote garbage to the ring, so it can't be trusted anymore. Disconnect
+    // it, like on a socket error. The ring is dropped, so that the socket error isn't
+    // followed by another read of the ring.
+    RAY_LOG(WARNING) << "[" << debug_label_ << "]Disconnecting client: " << status;
+    message_ring_.reset();
+    ServerConnection::Close();
+    HandleMessage(error_message_type_, std::vector<uint8_t>());
+    return false;
+  }
+  return !ring_paused_ && ServerConnection::socket_.is_open() && !ring->Empty();
+}
+
+MessageRingPoller::MessageRingPoller(boost::asio::io_service &io_service,
+                                     std::unique_ptr<SharedMemoryDoorbell> doorbell,
+                                     size_t batch_size)
+    : io_service_(io_service),
+      doorbell_(std::move(doorbell)),
+      batch_size_(batch_size),
+      processing_posted_(false),
+      stopped_(false) {
+  RAY_CHECK(doorbell_);
+  thread_ = std::thread(&MessageRingPoller::WaitForMessages, this);
+}
+
+MessageRingPoller::~MessageRingPoller() {
+  stopped_ = true;
+  doorbell_->Ring();
+  thread_.join();
+}
+
+void MessageRingPoller::AddClient(const std::shared_ptr<ClientConnection> &client) {
+  RAY_CHECK(client->HasOpenMessageRing());
+  clients_.push_back(client);
+  // The client may have written to the ring before it was added.
+  PostProcessMessages();
+}
+
+void MessageRingPoller::WaitForMessages() {
+  uint32_t last_seen = doorbell_->Sequence();
+  while (!stopped_) {
+    // Wake up once in a while anyway, to notice that the poller is stopped.
+    uint32_t sequence = doorbell_->Wait(last_seen, /*timeout_ms=*/100);
+    if (sequence != last_seen && !stopped_) {
+      last_seen = sequence;
+      PostProcessMessages();
+    }
+  }
+}
+
+void MessageRingPoller::PostProcessMessages() {
+  if (!processing_posted_.exchange(true)) {
+    io_service_.post([this]() { ProcessMessages(); });
+  }
+}
+
+void MessageRingPoller::ProcessMessages() {
+  processing_posted_ = false;
+  bool more_messages = false;
+  // Index the clients, since a handler may add one.
+  for (size_t i = 0; i < clients_.size(); i++) {
+    auto client = clients_[i].lock();
+    if (client && client->HasOpenMessageRing()) {
+      more_messages |= client->ProcessRingMessages(batch_size_);
+    }
+  }
+  clients_.erase(std::remove_if(clients_.begin(), clients_.end(),
+                                [](const std::weak_ptr<ClientConnection> &client) {
+                                  auto locked = client.lock();
+                                  return !locked || !locked->HasOpenMessageRing();
+                                }),
+                 clients_.end());
+  if (more_messages) {
+    PostProcessMessages();
+  }
+}
+
 std::string ServerConnection::DebugString() const {
   std::stringstream result;
   result << "\n- bytes read: " << bytes_read_;
   result << "\n- bytes written: " << bytes_written_;
   result << "\n- num async writes: " << async_writes_;
   result << "\n- num sync writes: " << sync_writes_;
+  result << "\n- num async write calls: " << async_write_calls_;
   result << "\n- writing: " << async_write_in_flight_;
   int64_t num_bytes = 0;
   for (auto &buffer : async_write_queue_) {
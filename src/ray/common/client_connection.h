@@ -18,14 +18,21 @@
 #include <boost/asio/buffer.hpp>
 #include <boost/asio/error.hpp>
 #include <boost/asio/generic/stream_protocol.hpp>
+#include <boost/asio/io_service.hpp>
 #include <deque>
 #include <memory>
+#include <thread>
 
 #include "ray/common/id.h"
+#include "ray/common/shared_memory_channel.h"
 #include "ray/common/status.h"
 
 namespace ray {
 
+/// The type of the message ring entry that a client writes before it writes a message
+/// that does not fit in its message ring to the socket.
+constexpr int64_t kMessageOnSocketType = -2;
+
 typedef boost::asio::generic::stream_protocol local_stream_protocol;
 typedef boost::asio::basic_stream_socket<local_stream_protocol> local_stream_socket;
 
@@ -124,13 +131,19 @@ class ServerConnection : public std::enable_shared_from_this<ServerConnection> {
 
   /// A message that is queued for writing asynchronously.
   struct AsyncWriteBuffer {
-    int64_t write_cookie;
-    int64_t write_type;
+    /// The length of the message, without its header.
     uint64_t write_length;
+    /// The framed message: the cookie, type and length, followed by the message, so
+    /// that it is written from a single buffer.
     std::vector<uint8_t> write_message;
     std::function<void(const ray::Status &)> handler;
   };
 
+  /// Copy the bytes that were received but not consumed yet to the given buffers.
+  ///
+  /// \param buffer The buffers. They are advanced past the copied bytes.
+  void ConsumeReadBuffer(std::vector<boost::asio::mutable_buffer> *buffer);
+
   /// The socket connection to the server.
   local_stream_socket socket_;
 
@@ -140,7 +153,7 @@ class ServerConnection : public std::enable_shared_from_this<ServerConnection> {
   /// List of pending messages to write.
   std::deque<std::unique_ptr<AsyncWriteBuffer>> async_write_queue_;
 
-  /// Whether we are in the middle of an async write.
+  /// Whether we are in the middle of an async write, or one is about to start.
   bool async_write_in_flight_;
 
   /// Whether we've met a broken-pipe error during writing.
@@ -158,10 +171,21 @@ class ServerConnection : public std::enable_shared_from_this<ServerConnection> {
   /// Count of bytes read total.
   int64_t bytes_read_ = 0;
 
+  /// Count of system calls that wrote async messages.
+  int64_t async_write_calls_ = 0;
+
+  /// Bytes that were received from the socket, at [read_buffer_start_,
+  /// read_buffer_end_) of read_buffer_, and were not consumed yet. Several messages
+  /// may be received at once.
+  std::vector<uint8_t> read_buffer_;
+  size_t read_buffer_start_ = 0;
+  size_t read_buffer_end_ = 0;
+
  private:
-  /// Asynchronously flushes the write queue. While async writes are running, the flag
-  /// async_write_in_flight_ will be set. This should only be called when no async writes
-  /// are currently in flight.
+  /// Asynchronously flushes the write queue, coalescing up to async_write_max_messages_
+  /// messages into one write. This should only be called when async_write_in_flight_
+  /// is set and no write is running, and it keeps the flag set until the queue is
+  /// empty.
   void DoAsyncWrites();
 };
 
@@ -205,21 +229,51 @@ class ClientConnection : public ServerConnection {
 
   /// Listen for and process messages from the client connection. Once a
   /// message has been fully received, the client manager's
-  /// ProcessClientMessage handler will be called.
+  /// ProcessClientMessage handler will be called. This does nothing if we are
+  /// already listening, e.g., when a message from the message ring was handled.
+  /// Several messages may be received with one read, and are then handled one
+  /// after the other, as long as the handler keeps calling this method.
   void ProcessMessages();
 
+  /// Also receive messages from the client through a shared-memory ring. The client
+  /// writes all its messages to the ring from now on, except for those that do not
+  /// fit in it. For those, it waits until the ring is empty, writes a
+  /// kMessageOnSocketType entry to the ring, and then writes the message to the socket.
+  /// The messages in the ring after the entry are handled after the message on the
+  /// socket.
+  ///
+  /// \param ring The ring, created by us.
+  void AttachMessageRing(std::shared_ptr<SharedMemoryRing> ring);
+
+  /// Whether the client has a message ring and is still connected.
+  bool HasOpenMessageRing() const;
+
+  /// Handle a batch of messages from the message ring.
+  ///
+  /// \param max_messages The largest number of messages to handle.
+  /// \return Whether there are more messages in the ring.
+  bool ProcessRingMessages(size_t max_messages);
+
  protected:
   /// A protected constructor for a node client connection.
   ClientConnection(MessageHandler &message_handler, local_stream_socket &&socket,
                    const std::string &debug_label,
                    const std::vector<std::string> &message_type_enum_names,
                    int64_t error_message_type);
-  /// Process an error from the last operation, then process the  message
-  /// header from the client.
-  void ProcessMessageHeader(const boost::system::error_code &error);
-  /// Process an error from reading the message header, then process the
-  /// message from the client.
+  /// Handle the messages that were fully received, until the message handler stops
+  /// listening. Then read more from the socket if needed.
+  void ProcessReceivedMessages();
+  /// Read more bytes from the socket, at least enough to complete the next message.
+  ///
+  /// \param min_bytes The number of bytes the buffer must hold for the next message.
+  void ReadMoreBytes(size_t min_bytes);
+  /// Process an error from reading from the socket, or else the received bytes.
+  void ProcessReadBytes(const boost::system::error_code &error, size_t bytes_read);
+  /// Process an error from reading from the socket, or else pass the message that was
+  /// received to the message handler.
   void ProcessMessage(const boost::system::error_code &error);
+  /// Pass a message to the message handler, and warn if it takes too long.
+  void HandleMessage(int64_t type, const std::vector<uint8_t> &message);
   /// Check if the ray cookie in a received message is correct. Note, if the cookie
   /// is wrong and the remote endpoint is known, raylet process will crash. If the remote
   /// endpoint is unknown, this method will only print a warning.
@@ -248,6 +302,65 @@ class ClientConnection : public ServerConnection {
   int64_t read_type_;
   uint64_t read_length_;
   std::vector<uint8_t> read_message_;
+  /// Whether we are waiting for a message on the socket.
+  bool read_in_flight_ = false;
+  /// Whether a message is being passed to the message handler. The next message is
+  /// processed once the handler returns, instead of recursively.
+  bool handling_message_ = false;
+  /// The shared-memory ring that the client writes messages to, if any.
+  std::shared_ptr<SharedMemoryRing> message_ring_;
+  /// The number of messages received on the socket since the ring was attached.
+  int64_t num_socket_messages_ = 0;
+  /// The number of kMessageOnSocketType entries read from the ring.
+  int64_t num_socket_markers_ = 0;
+  /// Whether the ring is not read until the next message on the socket is handled.
+  bool ring_paused_ = false;
+};
+
+/// \class MessageRingPoller
+///
+/// Delivers the messages that clients write to their shared-memory message rings. A
+/// thread waits on the doorbell that the clients ring after writing to a drained ring,
+/// and the rings are then drained on the event loop, a batch of messages per client at
+/// a time.
+class MessageRingPoller {
+ public:
+  /// \param io_service The event loop to handle the messages on.
+  /// \param doorbell The doorbell that the clients ring.
+  /// \param batch_size The largest number of messages handled per client before the
+  /// other clients get their turn.
+  MessageRingPoller(boost::asio::io_service &io_service,
+                    std::unique_ptr<SharedMemoryDoorbell> doorbell, size_t batch_size);
+
+  ~MessageRingPoller();
+
+  /// Start delivering the messages of a client with a message ring.
+  void AddClient(const std::shared_ptr<ClientConnection> &client);
+
+  /// The name of the doorbell, for the clients to open it.
+  const std::string &DoorbellName() const { return doorbell_->Name(); }
+
+ private:
+  /// Wait for the doorbell in a loop, and post ProcessMessages to the event loop.
+  void WaitForMessages();
+
+  /// Post ProcessMessages to the event loop, unless it is already posted.
+  void PostProcessMessages();
+
+  /// Drain the rings of all clients. This runs on the event loop.
+  void ProcessMessages();
+
+  boost::asio::io_service &io_service_;
+  std::unique_ptr<SharedMemoryDoorbell> doorbell_;
+  const size_t batch_size_;
+  /// The clients with message rings. This is only accessed on the event loop.
+  std::vector<std::weak_ptr<ClientConnection>> clients_;
+  /// Whether ProcessMessages is posted and has not started yet.
+  std::atomic<bool> processing_posted_;
+  /// Whether the poller is being destroyed.
+  std::atomic<bool> stopped_;
+  /// The thread that waits for the doorbell.
+  std::thread thread_;
 };
 
 }  // namespace ray
@@ -34,6 +34,14 @@ RAY_CONFIG(int64_t, ray_cookie, 0x5241590000000000)
 /// warning is logged that the handler is taking too long.
 RAY_CONFIG(int64_t, handler_warning_timeout_ms, 1000)
 
+/// The largest number of queued messages that a connection writes to its socket with
+/// one system call.
+RAY_CONFIG(int64_t, client_connection_max_coalesced_writes, 64)
+
+/// The size in bytes of the buffer that a connection reads messages into. All the
+/// messages that fit in the buffer are received with one system call.
+RAY_CONFIG(int64_t, client_connection_read_buffer_bytes, 64 * 1024)
+
 /// The duration between heartbeats sent by the raylets.
 RAY_CONFIG(int64_t, raylet_heartbeat_timeout_milliseconds, 100)
 /// If a component has not sent a heartbeat in the last num_heartbeats_timeout
@@ -47,6 +55,14 @@ RAY_CONFIG(uint64_t, num_heartbeats_warning, 5)
 
 /// The duration between reporting resources sent by the raylets.
 RAY_CONFIG(int64_t, raylet_report_resources_period_milliseconds, 100)
+/// If true, a resource usage report also counts as a heartbeat, and the raylet
+/// skips its next heartbeat RPC if it reported resources within the last
+/// heartbeat period.
+RAY_CONFIG(bool, raylet_liveness_from_resource_reports, true)
+/// The largest number of heartbeat RPCs in a row that the raylet skips because of
+/// resource reports. Only the heartbeat reply tells the raylet that the GCS marked it
+/// as dead, so it must still send one once in a while.
+RAY_CONFIG(int64_t, raylet_liveness_max_skipped_heartbeats, 9)
 
 /// The duration between dumping debug info to logs, or -1 to disable.
 RAY_CONFIG(int64_t, debug_dump_period_milliseconds, 10000)
@@ -113,10 +129,38 @@ RAY_CONFIG(bool, new_scheduler_enabled,
            getenv("RAY_ENABLE_NEW_SCHEDULER") == nullptr ||
                getenv("RAY_ENABLE_NEW_SCHEDULER") == std::string("1"))
 
+/// How much the new scheduler prefers the nodes that already have a task's arguments
+/// local over less loaded nodes, in percent. A node scores this weight times the
+/// fraction of the argument bytes it has local, minus its utilization. 0 disables
+/// locality-aware scheduling in the raylet.
+RAY_CONFIG(int64_t, scheduler_locality_weight_percent, 100)
+
+/// Tasks whose arguments local to any one node add up to fewer bytes than this
+/// are scheduled without regard to locality, because they are cheap to transfer.
+RAY_CONFIG(int64_t, scheduler_locality_min_bytes, 1024 * 1024)
+
+/// Whether the raylet allocates the CPU and GPU instances of a task on as few sockets
+/// as possible, and with neighboring indexes, according to the node topology.
+RAY_CONFIG(bool, topology_aware_instance_allocation, true)
+
+/// The file that describes the socket of each CPU and GPU of the node, with lines like
+/// `GPU <socket> <device IDs>`. If empty, the topology is read from sysfs, where GPUs
+/// are numbered in PCI bus order.
+RAY_CONFIG(std::string, node_topology_file, "")
+
+/// Whether the raylet pins the main thread of each worker to the CPUs of the whole CPU
+/// instances allocated to its task. This requires a known node topology.
+RAY_CONFIG(bool, worker_cpu_affinity, false)
+
 // The max allowed size in bytes of a return object from direct actor calls.
 // Objects larger than this size will be spilled/promoted to plasma.
 RAY_CONFIG(int64_t, max_direct_call_object_size, 100 * 1024)
 
+/// The maximum total size in bytes of the objects that a worker keeps in its
+/// in-memory store. Past this, the least recently used objects that the worker
+/// owns are promoted to plasma. Set to 0 to leave the store unbounded.
+RAY_CONFIG(int64_t, memory_store_max_bytes, 0)
+
 // The max gRPC message size (the gRPC internal default is 4MB). We use a higher
 // limit in Ray to avoid crashing with many small inlined task arguments.
 RAY_CONFIG(int64_t, max_grpc_message_size, 100 * 1024 * 1024)
@@ -143,6 +187,11 @@ RAY_CONFIG(int64_t, object_timeout_milliseconds, 100)
 /// for direct task submission until it must be returned to the raylet.
 RAY_CONFIG(int64_t, worker_lease_timeout_milliseconds, 500)
 
+/// How long a worker that holds another worker's lease keeps it once there are no
+/// more tasks to run on it, so that tasks with the same resource shape submitted
+/// shortly after can reuse it instead of requesting a new lease.
+RAY_CONFIG(int64_t, worker_lease_idle_grace_period_ms, 100)
+
 /// The interval at which the workers will check if their raylet has gone down.
 /// When this happens, they will kill themselves.
 RAY_CONFIG(int64_t, raylet_death_check_interval_milliseconds, 1000)
@@ -153,6 +202,21 @@ RAY_CONFIG(int64_t, get_timeout_milliseconds, 1000)
 RAY_CONFIG(int64_t, worker_get_request_size, 10000)
 RAY_CONFIG(int64_t, worker_fetch_request_size, 10000)
 
+/// Whether workers and drivers send their messages to the raylet through shared-memory
+/// rings instead of the raylet socket. Only supported on Linux.
+RAY_CONFIG(bool, raylet_shared_memory_ipc_enabled, false)
+
+/// The size in bytes of the shared-memory ring of each worker.
+RAY_CONFIG(int64_t, raylet_shared_memory_ipc_ring_bytes, 1024 * 1024)
+
+/// The largest number of messages from one worker that the raylet handles before it
+/// handles the messages of the other workers.
+RAY_CONFIG(int64_t, raylet_shared_memory_ipc_batch_size, 64)
+
+/// How long a worker blocks waiting for space in its shared-memory ring before it
+/// fails.
+RAY_CONFIG(int64_t, raylet_shared_memory_ipc_write_timeout_ms, 60000)
+
 /// Number of times raylet client tries connecting to a raylet.
 RAY_CONFIG(int64_t, raylet_client_num_connect_attempts, 10)
 RAY_CONFIG(int64_t, raylet_client_connect_timeout_milliseconds, 1000)
@@ -170,6 +234,14 @@ RAY_CONFIG(int64_t, kill_worker_timeout_milliseconds, 100)
 /// starting_worker_timeout_callback() is called.
 RAY_CONFIG(int64_t, worker_register_timeout_seconds, 30)
 
+/// Whether to fork Python workers from a zygote, a process per job that has already
+/// loaded the worker code, instead of starting a new interpreter for each worker.
+RAY_CONFIG(bool, worker_zygote_enabled, false)
+
+/// How long the raylet waits for a zygote to fork a worker. If the zygote does not
+/// reply in time, it is killed, and the job's workers are started from scratch.
+RAY_CONFIG(int64_t, worker_zygote_fork_timeout_ms, 1000)
+
 /// Allow up to 5 seconds for connecting to Redis.
 RAY_CONFIG(int64_t, redis_db_connect_retries, 50)
 RAY_CONFIG(int64_t, redis_db_connect_wait_milliseconds, 100)
@@ -225,12 +297,23 @@ RAY_CONFIG(int64_t, internal_gcs_service_connect_wait_milliseconds, 100)
 /// The interval at which the gcs server will check if redis has gone down.
 /// When this happens, gcs server will kill itself.
 RAY_CONFIG(int64_t, gcs_redis_heartbeat_interval_milliseconds, 100)
+/// The interval at which a gcs server with a standby tells the standby that it is
+/// alive, when it has no writes to stream. A standby that failed is attached again
+/// at the same interval.
+RAY_CONFIG(int64_t, gcs_standby_heartbeat_interval_milliseconds, 100)
+/// A standby gcs server takes over once it has not heard from its primary for this
+/// long.
+RAY_CONFIG(int64_t, gcs_standby_failover_timeout_milliseconds, 2000)
 /// Duration to wait between retries for leasing worker in gcs server.
 RAY_CONFIG(uint32_t, gcs_lease_worker_retry_interval_ms, 200)
 /// Duration to wait between retries for creating actor in gcs server.
 RAY_CONFIG(uint32_t, gcs_create_actor_retry_interval_ms, 200)
 /// Duration to wait between retries for creating placement group in gcs server.
 RAY_CONFIG(uint32_t, gcs_create_placement_group_retry_interval_ms, 200)
+/// Whether the gcs server places the bundles of a placement group with the bin packing
+/// solver, which sees all the bundles of the group at once. If false, each bundle is
+/// placed greedily on the node with the best score.
+RAY_CONFIG(bool, gcs_placement_group_bin_packing_solver_enabled, true)
 /// Maximum number of destroyed actors in GCS server memory cache.
 RAY_CONFIG(uint32_t, maximum_gcs_destroyed_actor_cached_count, 100000)
 /// Maximum number of dead nodes in GCS server memory cache.
@@ -293,6 +376,31 @@ RAY_CONFIG(bool, put_small_object_in_memory_store, false)
 /// pipelining task submission.
 RAY_CONFIG(uint32_t, max_tasks_in_flight_per_worker, 1)
 
+/// Maximum number of normal tasks that an owner pushes to a leased worker in a single
+/// PushTasks RPC. Each batch takes one slot of the pipeline to the worker. A value >1
+/// enables batching, which amortizes the per-RPC overhead of very short tasks.
+RAY_CONFIG(uint32_t, max_tasks_per_push_batch, 1)
+
+/// The batched task pushes are sized so that a batch takes about this long to execute,
+/// based on the task durations observed by the owner.
+RAY_CONFIG(uint64_t, task_push_batch_target_duration_us, 2000)
+
+/// Maximum number of actor tasks that a caller pushes to an actor in a single PushTasks
+/// RPC. While a push to the actor is in flight, the tasks that become ready are held
+/// back and sent together in batches sized like the normal task batches. A value >1
+/// enables batching, which amortizes the per-RPC overhead of very short actor methods.
+RAY_CONFIG(uint32_t, max_actor_tasks_per_push_batch, 1)
+
+/// Maximum number of actors that a worker registers or creates in a single request to
+/// the GCS. The actors that a worker starts while its previous requests are being sent
+/// are registered and created together.
+RAY_CONFIG(uint32_t, max_actors_per_creation_batch, 1000)
+
+/// The number of shards of the task submission state of an owner. The state is sharded
+/// by scheduling class, so that threads that submit tasks of different resource shapes
+/// don't contend on a lock.
+RAY_CONFIG(uint32_t, task_submitter_num_shards, 16)
+
 /// Interval to restart dashboard agent after the process exit.
 RAY_CONFIG(uint32_t, agent_restart_interval_ms, 1000)
 
@@ -322,9 +430,24 @@ RAY_CONFIG(int64_t, kill_idle_workers_interval_ms, 200)
 /// The idle time threshold for an idle worker to be killed.
 RAY_CONFIG(int64_t, idle_worker_killing_time_threshold_ms, 1000)
 
+/// Whether to forecast the worker demand of each job, and to keep a warm pool of idle
+/// workers of the forecasted size instead of killing and restarting them.
+RAY_CONFIG(bool, worker_demand_forecasting_enabled, false)
+
+/// The length of the intervals over which the peak worker demand is measured.
+RAY_CONFIG(int64_t, worker_demand_forecast_interval_ms, 1000)
+
+/// The number of past intervals used to detect periodic worker demand.
+RAY_CONFIG(int64_t, worker_demand_forecast_history_size, 60)
+
 /// Whether start the Plasma Store as a Raylet thread.
 RAY_CONFIG(bool, ownership_based_object_directory_enabled, false)
 
+/// The maximum number of object location updates that an owner sends in one reply to
+/// a node subscribed to the locations of its objects. The remaining updates are sent
+/// when the node polls again.
+RAY_CONFIG(int64_t, max_object_location_updates_per_reply, 1000)
+
 // The interval where metrics are exported in milliseconds.
 RAY_CONFIG(uint64_t, metrics_report_interval_ms, 10000)
 
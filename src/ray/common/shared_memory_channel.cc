@@ -0,0 +1,410 @@
+// Copyright 2017 The Ray Authors.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//  http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "ray/common/shared_memory_channel.h"
+
+#ifdef __linux__
+#include <fcntl.h>
+#include <linux/futex.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+#endif
+
+#include <algorithm>
+#include <chrono>
+#include <climits>
+#include <cstring>
+#include <thread>
+
+#include "ray/util/logging.h"
+
+namespace {
+
+/// The type of the frame that pads the end of the ring, before a message that does not
+/// fit there.
+const int64_t kWrapFrameType = -1;
+
+/// Frames are aligned to their header size, so that a frame header always fits at the
+/// end of the ring.
+struct FrameHeader {
+  int64_t type;
+  int64_t length;
+};
+
+uint64_t FrameSize(int64_t length) {
+  const uint64_t alignment = sizeof(FrameHeader);
+  return sizeof(FrameHeader) + (length + alignment - 1) / alignment * alignment;
+}
+
+/// Wait until a futex word in shared memory no longer equals `expected`, or until the
+/// timeout. This may also return spuriously.
+void FutexWait(std::atomic<uint32_t> *word, uint32_t expected, int64_t timeout_ms) {
+#ifdef __linux__
+  struct timespec timeout;
+  timeout.tv_sec = timeout_ms / 1000;
+  timeout.tv_nsec = (timeout_ms % 1000) * 1000000;
+  // This returns immediately if the word changed since the caller loaded it. The futex
+  // is shared between processes, so it must not be FUTEX_PRIVATE.
+  syscall(SYS_futex, word, FUTEX_WAIT, expected, &timeout, nullptr, 0);
+#else
+  std::this_thread::sleep_for(
+      std::chrono::milliseconds(std::min<int64_t>(1, timeout_ms)));
+#endif
+}
+
+/// Wake up the threads that wait on a futex word.
+void FutexWake(std::atomic<uint32_t> *word) {
+#ifdef __linux__
+  syscall(SYS_futex, word, FUTEX_WAKE, INT_MAX, nullptr, nullptr, 0);
+#endif
+}
+
+int64_t NowMs() {
+  return std::chrono::duration_cast<std::chrono::milliseconds>(
+             std::chrono::steady_clock::now().time_since_epoch())
+      .count();
+}
+
+}  // namespace
+
+namespace ray {
+
+std::unique_ptr<SharedMemorySegment> SharedMemorySegment::Create(const std::string &name,
+                                                                 size_t size) {
+#ifdef __linux__
+  int fd = shm_open(name.c_str(), O_CREAT | O_EXCL | O_RDWR, S_IRUSR | S_IWUSR);
+  if (fd < 0) {
+    RAY_LOG(WARNING) << "Failed to create shared memory segment " << name << ": "
+                     << strerror(errno);
+    return nullptr;
+  }
+  void *data = MAP_FAILED;
+  if (ftruncate(fd, size) == 0) {
+    data = mmap(nullptr, size, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+  }
+  close(fd);
+  if (data == MAP_FAILED) {
+    RAY_LOG(WARNING) << "Failed to map shared memory segment " << name << ": "
+                     << strerror(errno);
+    shm_unlink(name.c_str());
+    return nullptr;
+  }
+  return std::unique_ptr<SharedMemorySegment>(
+      new SharedMemorySegment(name, static_cast<uint8_t *>(data), size, true));
+#else
+  return nullptr;
+#endif
+}
+
+std::unique_ptr<SharedMemorySegment> SharedMemorySegment::Open(const std::string &name) {
+#ifdef __linux__
+  int fd = shm_open(name.c_str(), O_RDWR, 0);
+  if (fd < 0) {
+    RAY_LOG(WARNING) << "Failed to open shared memory segment " << name << ": "
+                     << strerror(errno);
+    return nullptr;
+  }
+  struct stat info;
+  void *data = MAP_FAILED;
+  if (fstat(fd, &info) == 0) {
+    data = mmap(nullptr, info.st_size, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+  }
+  close(fd);
+  if (data == MAP_FAILED) {
+    RAY_LOG(WARNING) << "Failed to map shared memory segment " << name << ": "
+                     << strerror(errno);
+    return nullptr;
+  }
+  return std::unique_ptr<SharedMemorySegment>(
+      new SharedMemorySegment(name, static_cast<uint8_t *>(data), info.st_size, false));
+#else
+  return nullptr;
+#endif
+}
+
+SharedMemorySegment::SharedMemorySegment(const std::string &name, uint8_t *data,
+                                         size_t size, bool owner)
+    : name_(name), data_(data), size_(size), owner_(owner) {}
+
+SharedMemorySegment::~SharedMemorySegment() {
+#ifdef __linux__
+  munmap(data_, size_);
+  if (owner_) {
+    Unlink();
+  }
+#endif
+}
+
+void SharedMemorySegment::Unlink() {
+#ifdef __linux__
+  // The name may already be gone, if the other side unlinked it.
+  shm_unlink(name_.c_str());
+  owner_ = false;
+#endif
+}
+
+std::unique_ptr<SharedMemoryDoorbell> SharedMemoryDoorbell::Create(
+    const std::string &name) {
+  auto segment = SharedMemorySegment::Create(name, sizeof(std::atomic<uint32_t>));
+  if (!segment) {
+    return nullptr;
+  }
+  new (segment->Data()) std::atomic<uint32_t>(0);
+  return std::unique_ptr<SharedMemoryDoorbell>(
+      new SharedMemoryDoorbell(std::move(segment)));
+}
+
+std::unique_ptr<SharedMemoryDoorbell> SharedMemoryDoorbell::Open(
+    const std::string &name) {
+  auto segment = SharedMemorySegment::Open(name);
+  if (!segment || segment->Size() < sizeof(std::atomic<uint32_t>)) {
+    return nullptr;
+  }
+  return std::unique_ptr<SharedMemoryDoorbell>(
+      new SharedMemoryDoorbell(std::move(segment)));
+}
+
+SharedMemoryDoorbell::SharedMemoryDoorbell(std::unique_ptr<SharedMemorySegment> segment)
+    : segment_(std::move(segment)),
+      sequence_(reinterpret_cast<std::atomic<uint32_t> *>(segment_->Data())) {}
+
+void SharedMemoryDoorbell::Ring() {
+  sequence_->fetch_add(1);
+  FutexWake(sequence_);
+}
+
+uint32_t SharedMemoryDoorbell::Wait(uint32_t last_seen, int64_t timeout_ms) {
+  uint32_t sequence = sequence_->load();
+  if (sequence != last_seen) {
+    return sequence;
+  }
+  FutexWait(sequence_, last_seen, timeout_ms);
+  return sequence_->load();
+}
+
+uint32_t SharedMemoryDoorbell::Sequence() const { return sequence_->load(); }
+
+/// The header of a ring, at the start of its segment. The positions only grow, and
+/// are taken modulo the capacity to index the data.
+struct SharedMemoryRing::Header {
+  /// The number of bytes for messages, a power of two. Only the producer reads it,
+  /// when it opens the ring.
+  uint64_t capacity;
+  /// The position of the next message to read. Written only by the consumer.
+  alignas(64) std::atomic<uint64_t> head;
+  /// The position of the next message to write. Written only by the producer.
+  alignas(64) std::atomic<uint64_t> tail;
+  /// Whether the producer rang the doorbell since the consumer last drained the ring.
+  alignas(64) std::atomic<uint32_t> notified;
+  /// A futex word that the consumer bumps when it frees space while the producer waits.
+  alignas(64) std::atomic<uint32_t> space_sequence;
+  /// Whether the producer waits on space_sequence.
+  std::atomic<uint32_t> producer_waiting;
+};
+
+std::unique_ptr<SharedMemoryRing> SharedMemoryRing::Create(const std::string &name,
+                                                           size_t capacity) {
+  uint64_t rounded_capacity = 2 * sizeof(FrameHeader);
+  while (rounded_capacity < capacity) {
+    rounded_capacity *= 2;
+  }
+  auto segment = SharedMemorySegment::Create(name, sizeof(Header) + rounded_capacity);
+  if (!segment) {
+    return nullptr;
+  }
+  auto header = new (segment->Data()) Header();
+  header->capacity = rounded_capacity;
+  header->head.store(0);
+  header->tail.store(0);
+  // The consumer is not waiting on anything yet, so the first message rings the
+  // doorbell.
+  header->notified.store(0);
+  header->space_sequence.store(0);
+  header->producer_waiting.store(0);
+  return std::unique_ptr<SharedMemoryRing>(
+      new SharedMemoryRing(std::move(segment), rounded_capacity, nullptr));
+}
+
+std::unique_ptr<SharedMemoryRing> SharedMemoryRing::Open(
+    const std::string &name, std::shared_ptr<SharedMemoryDoorbell> doorbell) {
+  auto segment = SharedMemorySegment::Open(name);
+  if (!segment || segment->Size() < sizeof(Header)) {
+    return nullptr;
+  }
+  // Nothing else needs to find the ring, and the name would leak if this process and
+  // the creator both crashed.
+  segment->Unlink();
+  const uint64_t capacity = reinterpret_cast<Header *>(segment->Data())->capacity;
+  if (capacity < 2 * sizeof(FrameHeader) || (capacity & (capacity - 1)) != 0 ||
+      capacity != segment->Size() - sizeof(Header)) {
+    RAY_LOG(WARNING) << "Ring " << name << " has an invalid capacity of " << capacity
+                     << " bytes";
+    return nullptr;
+  }
+  return std::unique_ptr<SharedMemoryRing>(
+      new SharedMemoryRing(std::move(segment), capacity, std::move(doorbell)));
+}
+
+SharedMemoryRing::SharedMemoryRing(std::unique_ptr<SharedMemorySegment> segment,
+                                   uint64_t capacity,
+                                   std::shared_ptr<SharedMemoryDoorbell> doorbell)
+    : segment_(std::move(segment)),
+      doorbell_(std::move(doorbell)),
+      header_(reinterpret_cast<Header *>(segment_->Data())),
+      data_(segment_->Data() + sizeof(Header)),
+      capacity_(capacity) {}
+
+Status SharedMemoryRing::Write(int64_t type, int64_t length, const uint8_t *message,
+                               int64_t timeout_ms) {
+  RAY_CHECK(length <= MaxMessageLength())
+      << "Message of " << length << " bytes does not fit in ring " << Name();
+  const uint64_t capacity = capacity_;
+  uint64_t tail = header_->tail.load(std::memory_order_relaxed);
+  uint64_t offset = tail & (capacity - 1);
+  const uint64_t frame_size = FrameSize(length);
+  // If the message does not fit before the end of the ring, the rest of the ring is
+  // skipped.
+  const uint64_t contiguous = capacity - offset;
+  const uint64_t needed = frame_size <= contiguous ? frame_size : contiguous + frame_size;
+
+  if (!WaitForConsumer(
+          [this, capacity, tail, needed]() {
+            return capacity - (tail - header_->head.load()) >= needed;
+          },
+          timeout_ms)) {
+    return Status::TimedOut("Timed out waiting for space in ring " + Name());
+  }
+
+  if (frame_size > contiguous) {
+    FrameHeader wrap{kWrapFrameType, 0};
+    std::memcpy(data_ + offset, &wrap, sizeof(wrap));
+    tail += contiguous;
+    offset = 0;
+  }
+  FrameHeader frame{type, length};
+  std::memcpy(data_ + offset, &frame, sizeof(frame));
+  if (length > 0) {
+    std::memcpy(data_ + offset + sizeof(frame), message, length);
+  }
+  // The message must be visible before the consumer can see that it was notified.
+  header_->tail.store(tail + frame_size);
+  if (header_->notified.exchange(1) == 0 && doorbell_) {
+    doorbell_->Ring();
+  }
+  return Status::OK();
+}
+
+Status SharedMemoryRing::WaitUntilEmpty(int64_t timeout_ms) const {
+  if (!WaitForConsumer([this]() { return Empty(); }, timeout_ms)) {
+    return Status::TimedOut("Timed out waiting for ring " + Name() + " to drain");
+  }
+  return Status::OK();
+}
+
+bool SharedMemoryRing::WaitForConsumer(const std::function<bool()> &done,
+                                       int64_t timeout_ms) const {
+  if (done()) {
+    return true;
+  }
+  const int64_t deadline_ms = NowMs() + timeout_ms;
+  while (true) {
+    const uint32_t sequence = header_->space_sequence.load();
+    // Ask the consumer to bump the sequence, then check again, so that the wait below
+    // can't miss space that the consumer frees in between.
+    header_->producer_waiting.store(1);
+    if (done()) {
+      return true;
+    }
+    const int64_t remaining_ms = deadline_ms - NowMs();
+    if (remaining_ms <= 0) {
+      return false;
+    }
+    FutexWait(&header_->space_sequence, sequence, remaining_ms);
+  }
+}
+
+void SharedMemoryRing::ReleaseTo(uint64_t head) {
+  header_->head.store(head);
+  if (header_->producer_waiting.exchange(0) != 0) {
+    header_->space_sequence.fetch_add(1);
+    FutexWake(&header_->space_sequence);
+  }
+}
+
+Status SharedMemoryRing::Read(
+    size_t max_messages,
+    const std::function<bool(int64_t, const std::vector<uint8_t> &)> &handler,
+    size_t *num_read) {
+  const uint64_t capacity = capacity_;
+  size_t num_handled = 0;
+  Status status;
+  while (num_handled < max_messages) {
+    const uint64_t head = header_->head.load(std::memory_order_relaxed);
+    const uint64_t tail = header_->tail.load();
+    if (head == tail) {
+      break;
+    }
+    // The producer writes the ring, so nothing in it can be trusted.
+    const uint64_t available = tail - head;
+    const uint64_t offset = head & (capacity - 1);
+    if (available > capacity || available < sizeof(FrameHeader)) {
+      status = Status::IOError("Corrupted positions in ring " + Name());
+      break;
+    }
+    FrameHeader frame;
+    std::memcpy(&frame, data_ + offset, sizeof(frame));
+    if (frame.type == kWrapFrameType) {
+      if (capacity - offset > available) {
+        status = Status::IOError("Corrupted wrap frame in ring " + Name());
+        break;
+      }
+      ReleaseTo(head + capacity - offset);
+      continue;
+    }
+    if (frame.length < 0 || frame.length > MaxMessageLength() ||
+        FrameSize(frame.length) > std::min(available, capacity - offset)) {
+      status = Status::IOError("Corrupted message of " + std::to_string(frame.length) +
+                               " bytes in ring " + Name());
+      break;
+    }
+    const uint8_t *message = data_ + offset + sizeof(frame);
+    read_message_.assign(message, message + frame.length);
+    // Only release the message after it was handled, so that an empty ring means that
+    // all the messages were handled.
+    bool keep_reading = handler(frame.type, read_message_);
+    ReleaseTo(head + FrameSize(frame.length));
+    num_handled++;
+    if (!keep_reading) {
+      break;
+    }
+  }
+  if (num_read != nullptr) {
+    *num_read = num_handled;
+  }
+  return status;
+}
+
+void SharedMemoryRing::ClearNotified() { header_->notified.store(0); }
+
+bool SharedMemoryRing::Empty() const {
+  return header_->head.load(std::memory_order_acquire) == header_->tail.load();
+}
+
+int64_t SharedMemoryRing::MaxMessageLength() const {
+  return capacity_ / 2 - sizeof(FrameHeader);
+}
+
+}  // namespace ray
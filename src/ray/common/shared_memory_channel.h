@@ -0,0 +1,202 @@
+// Copyright 2017 The Ray Authors.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//  http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#pragma once
+
+#include <atomic>
+#include <functional>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "ray/common/status.h"
+
+namespace ray {
+
+/// A named POSIX shared memory segment, mapped into this process.
+class SharedMemorySegment {
+ public:
+  /// Create a new segment. The segment is unlinked when the returned object is
+  /// destroyed.
+  ///
+  /// \param name The name of the segment, starting with a slash.
+  /// \param size The size of the segment in bytes.
+  /// \return The segment, or nullptr if it could not be created.
+  static std::unique_ptr<SharedMemorySegment> Create(const std::string &name,
+                                                     size_t size);
+
+  /// Map an existing segment.
+  ///
+  /// \param name The name of the segment.
+  /// \return The segment, or nullptr if it could not be opened.
+  static std::unique_ptr<SharedMemorySegment> Open(const std::string &name);
+
+  ~SharedMemorySegment();
+
+  /// Remove the name of the segment, so that no more processes can open it. The
+  /// processes that mapped it keep their mappings.
+  void Unlink();
+
+  uint8_t *Data() const { return data_; }
+
+  size_t Size() const { return size_; }
+
+  const std::string &Name() const { return name_; }
+
+ private:
+  SharedMemorySegment(const std::string &name, uint8_t *data, size_t size, bool owner);
+
+  const std::string name_;
+  uint8_t *data_;
+  const size_t size_;
+  /// Whether this process created the segment and should unlink it.
+  bool owner_;
+};
+
+/// \class SharedMemoryDoorbell
+///
+/// A futex word in shared memory. Processes that map it ring it to wake up a thread
+/// that waits on it, e.g., when they write to a SharedMemoryRing.
+class SharedMemoryDoorbell {
+ public:
+  /// Create a new doorbell.
+  ///
+  /// \param name The name of the shared memory segment, starting with a slash.
+  /// \return The doorbell, or nullptr if shared memory is not available.
+  static std::unique_ptr<SharedMemoryDoorbell> Create(const std::string &name);
+
+  /// Open a doorbell that another process created.
+  static std::unique_ptr<SharedMemoryDoorbell> Open(const std::string &name);
+
+  /// Wake up the threads that wait on the doorbell.
+  void Ring();
+
+  /// Wait until the doorbell is rung, unless it was already rung since the caller
+  /// last saw it.
+  ///
+  /// \param last_seen The sequence number that the caller last saw.
+  /// \param timeout_ms The longest time to wait.
+  /// \return The current sequence number. It equals `last_seen` if the wait timed out.
+  uint32_t Wait(uint32_t last_seen, int64_t timeout_ms);
+
+  /// The number of times the doorbell was rung, modulo 2^32.
+  uint32_t Sequence() const;
+
+  const std::string &Name() const { return segment_->Name(); }
+
+ private:
+  explicit SharedMemoryDoorbell(std::unique_ptr<SharedMemorySegment> segment);
+
+  std::unique_ptr<SharedMemorySegment> segment_;
+  std::atomic<uint32_t> *sequence_;
+};
+
+/// \class SharedMemoryRing
+///
+/// A single-producer, single-consumer queue of messages in shared memory. Each message
+/// is framed like a message on a ServerConnection, by its type and length. The
+/// producer rings a doorbell when the consumer may be waiting for messages, i.e., when
+/// it writes to a ring that the consumer has drained.
+///
+/// The consumer advances past a message only after it handled the message, so once the
+/// ring is empty, the producer knows that the consumer handled all the messages.
+class SharedMemoryRing {
+ public:
+  /// Create a new ring, as the consumer. The ring is unlinked when it is destroyed.
+  ///
+  /// \param name The name of the shared memory segment, starting with a slash.
+  /// \param capacity The number of bytes for messages. It is rounded up to a power of
+  /// two.
+  /// \return The ring, or nullptr if shared memory is not available.
+  static std::unique_ptr<SharedMemoryRing> Create(const std::string &name,
+                                                  size_t capacity);
+
+  /// Open a ring that another process created, as the producer. The name of the ring
+  /// is unlinked once it is mapped. The ring is rejected if its capacity does not
+  /// match the size of the segment.
+  ///
+  /// \param name The name of the shared memory segment.
+  /// \param doorbell The doorbell to ring when the consumer may be waiting.
+  /// \return The ring, or nullptr if it could not be opened.
+  static std::unique_ptr<SharedMemoryRing> Open(
+      const std::string &name, std::shared_ptr<SharedMemoryDoorbell> doorbell);
+
+  /// Write a message to the ring. If the ring is full, block until the consumer makes
+  /// space.
+  ///
+  /// \param type The message type (e.g., a flatbuffer enum).
+  /// \param length The size in bytes of the message. It must be at most
+  /// MaxMessageLength().
+  /// \param message A pointer to the message buffer.
+  /// \param timeout_ms The longest time to wait for space.
+  /// \return Status::TimedOut if the consumer did not make space in time.
+  Status Write(int64_t type, int64_t length, const uint8_t *message,
+               int64_t timeout_ms);
+
+  /// Wait until the consumer handled all the messages in the ring.
+  ///
+  /// \param timeout_ms The longest time to wait.
+  /// \return Status::TimedOut if the ring is still not empty.
+  Status WaitUntilEmpty(int64_t timeout_ms) const;
+
+  /// Handle the messages in the ring, oldest first.
+  ///
+  /// \param max_messages The largest number of messages to handle.
+  /// \param handler The handler of a message. It returns false to stop reading.
+  /// \param[out] num_read If not null, set to the number of messages handled.
+  /// \return Status::IOError if the producer corrupted the ring. The ring can't be
+  /// read anymore in that case.
+  Status Read(size_t max_messages,
+              const std::function<bool(int64_t, const std::vector<uint8_t> &)> &handler,
+              size_t *num_read = nullptr);
+
+  /// Mark that the consumer is about to drain the ring, so that the producer rings the
+  /// doorbell for the next message that it writes.
+  void ClearNotified();
+
+  /// Whether the ring has no messages.
+  bool Empty() const;
+
+  /// The longest message that fits in the ring.
+  int64_t MaxMessageLength() const;
+
+  const std::string &Name() const { return segment_->Name(); }
+
+ private:
+  struct Header;
+
+  SharedMemoryRing(std::unique_ptr<SharedMemorySegment> segment, uint64_t capacity,
+                   std::shared_ptr<SharedMemoryDoorbell> doorbell);
+
+  /// Block the producer until `done` returns true, or until the timeout. The consumer
+  /// wakes it up whenever it frees space.
+  ///
+  /// \return Whether `done` returned true.
+  bool WaitForConsumer(const std::function<bool()> &done, int64_t timeout_ms) const;
+
+  /// Free the space before a position, and wake up the producer if it waits for space.
+  void ReleaseTo(uint64_t head);
+
+  std::unique_ptr<SharedMemorySegment> segment_;
+  std::shared_ptr<SharedMemoryDoorbell> doorbell_;
+  Header *header_;
+  uint8_t *data_;
+  /// The number of bytes for messages. The producer can write the header, so the
+  /// consumer only trusts the capacity that it created the ring with.
+  const uint64_t capacity_;
+  /// The buffer that a message is copied to before it is handled.
+  std::vector<uint8_t> read_message_;
+};
+
+}  // namespace ray
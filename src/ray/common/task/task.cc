@@ -39,6 +39,15 @@ void Task::SetBacklogSize(int64_t backlog_size) { backlog_size_ = backlog_size;
 
 int64_t Task::BacklogSize() const { return backlog_size_; }
 
+void Task::SetLocalObjectBytes(
+    std::unordered_map<std::string, int64_t> local_object_bytes) {
+  local_object_bytes_ = std::move(local_object_bytes);
+}
+
+const std::unordered_map<std::string, int64_t> &Task::LocalObjectBytes() const {
+  return local_object_bytes_;
+}
+
 std::string Task::DebugString() const {
   std::ostringstream stream;
   stream << "task_spec={" << task_spec_.DebugString() << "}, task_execution_spec={"
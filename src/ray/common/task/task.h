@@ -2,6 +2,9 @@
 
 #include <inttypes.h>
 
+#include <string>
+#include <unordered_map>
+
 #include "ray/common/task/task_common.h"
 #include "ray/common/task/task_execution_spec.h"
 #include "ray/common/task/task_spec.h"
@@ -93,6 +96,14 @@ class Task {
 
   int64_t BacklogSize() const;
 
+  /// Set the number of bytes of the task's arguments that each node has local, as
+  /// reported by the task's owner.
+  ///
+  /// \param local_object_bytes The bytes local to each node, by binary node ID.
+  void SetLocalObjectBytes(std::unordered_map<std::string, int64_t> local_object_bytes);
+
+  const std::unordered_map<std::string, int64_t> &LocalObjectBytes() const;
+
   std::string DebugString() const;
 
  private:
@@ -121,6 +132,9 @@ class Task {
   mutable CancelTaskCallback on_cancellation_ = nullptr;
   /// The size of the core worker's backlog when this task was submitted.
   int64_t backlog_size_ = -1;
+  /// The number of bytes of the task's arguments that each node has local, by binary
+  /// node ID. Empty if the owner did not report the locations of the arguments.
+  std::unordered_map<std::string, int64_t> local_object_bytes_;
 };
 
 }  // namespace ray
@@ -153,6 +153,31 @@ size_t TaskSpecification::ArgMetadataSize(size_t arg_index) const {
   return message_->args(arg_index).metadata().size();
 }
 
+std::shared_ptr<Buffer> TaskSpecification::ArgDataBuffer(size_t arg_index) const {
+  const auto &data = message_->args(arg_index).data();
+  if (data.empty()) {
+    return nullptr;
+  }
+  auto ptr = reinterpret_cast<const uint8_t *>(data.data());
+  if (GetLanguage() == Language::PYTHON &&
+      reinterpret_cast<uintptr_t>(ptr) % BUFFER_ALIGNMENT != 0) {
+    // Python values may contain pickle5 buffers, such as numpy arrays, that are read
+    // in place and must stay aligned, so copy the value to aligned memory.
+    return std::make_shared<LocalMemoryBuffer>(const_cast<uint8_t *>(ptr), data.size(),
+                                               /*copy_data=*/true);
+  }
+  return std::make_shared<AliasedBuffer>(message_, ptr, data.size());
+}
+
+std::shared_ptr<Buffer> TaskSpecification::ArgMetadataBuffer(size_t arg_index) const {
+  const auto &metadata = message_->args(arg_index).metadata();
+  if (metadata.empty()) {
+    return nullptr;
+  }
+  return std::make_shared<AliasedBuffer>(
+      message_, reinterpret_cast<const uint8_t *>(metadata.data()), metadata.size());
+}
+
 const std::vector<ObjectID> TaskSpecification::ArgInlinedIds(size_t arg_index) const {
   return IdVectorFromProtobuf<ObjectID>(message_->args(arg_index).nested_inlined_ids());
 }
@@ -291,6 +316,11 @@ bool TaskSpecification::IsAsyncioActor() const {
   return message_->actor_creation_task_spec().is_asyncio();
 }
 
+bool TaskSpecification::AllowOutOfOrderExecution() const {
+  RAY_CHECK(IsActorCreationTask());
+  return message_->actor_creation_task_spec().allow_out_of_order_execution();
+}
+
 bool TaskSpecification::IsDetachedActor() const {
   return IsActorCreationTask() && message_->actor_creation_task_spec().is_detached();
 }
@@ -325,6 +355,7 @@ std::string TaskSpecification::DebugString() const {
            << ", max_restarts=" << MaxActorRestarts()
            << ", max_concurrency=" << MaxActorConcurrency()
            << ", is_asyncio_actor=" << IsAsyncioActor()
+           << ", allow_out_of_order_execution=" << AllowOutOfOrderExecution()
            << ", is_detached=" << IsDetachedActor() << "}";
   } else if (IsActorTask()) {
     // Print actor task spec.
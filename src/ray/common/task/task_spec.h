@@ -6,6 +6,7 @@
 #include <vector>
 
 #include "absl/synchronization/mutex.h"
+#include "ray/common/buffer.h"
 #include "ray/common/function_descriptor.h"
 #include "ray/common/grpc_util.h"
 #include "ray/common/id.h"
@@ -51,6 +52,20 @@ class TaskSpecification : public MessageWrapper<rpc::TaskSpec> {
     ComputeResources();
   }
 
+  /// Construct from a protobuf message shared_ptr whose resources are the same as
+  /// those of another task spec. The resources and the scheduling class computed for
+  /// the other task spec are shared instead of computed again.
+  ///
+  /// \param message The protobuf message.
+  /// \param same_resources A normal task spec with the same required resources and
+  /// required placement resources.
+  TaskSpecification(std::shared_ptr<rpc::TaskSpec> message,
+                    const TaskSpecification &same_resources)
+      : MessageWrapper(message),
+        required_resources_(same_resources.required_resources_),
+        required_placement_resources_(same_resources.required_placement_resources_),
+        sched_cls_id_(same_resources.sched_cls_id_) {}
+
   /// Construct from protobuf-serialized binary.
   ///
   /// \param serialized_binary Protobuf-serialized binary.
@@ -90,6 +105,17 @@ class TaskSpecification : public MessageWrapper<rpc::TaskSpec> {
 
   size_t ArgMetadataSize(size_t arg_index) const;
 
+  /// Return the data of an argument passed by value, or nullptr if it has none.
+  /// The returned read-only buffer points into this task spec's message and keeps
+  /// the message alive. Only for Python tasks, data that is not aligned to
+  /// BUFFER_ALIGNMENT is copied to an aligned buffer instead.
+  std::shared_ptr<Buffer> ArgDataBuffer(size_t arg_index) const;
+
+  /// Return the metadata of an argument passed by value, or nullptr if it has none.
+  /// The read-only buffer always points into this task spec's message, since
+  /// metadata has no alignment requirements.
+  std::shared_ptr<Buffer> ArgMetadataBuffer(size_t arg_index) const;
+
   /// Return the ObjectIDs that were inlined in this task argument.
   const std::vector<ObjectID> ArgInlinedIds(size_t arg_index) const;
 
@@ -181,6 +207,10 @@ class TaskSpecification : public MessageWrapper<rpc::TaskSpec> {
 
   bool IsAsyncioActor() const;
 
+  /// Whether the actor may execute tasks as soon as their dependencies are ready,
+  /// instead of in the order in which each caller submitted them.
+  bool AllowOutOfOrderExecution() const;
+
   bool IsDetachedActor() const;
 
   ObjectID ActorDummyObject() const;
@@ -1,5 +1,7 @@
 #pragma once
 
+#include <google/protobuf/arena.h>
+
 #include "ray/common/buffer.h"
 #include "ray/common/ray_object.h"
 #include "ray/common/task/task_spec.h"
@@ -64,13 +66,109 @@ class TaskArgByValue : public TaskArg {
   const std::shared_ptr<RayObject> value_;
 };
 
+/// Allocate a task spec message on a protobuf arena of its own. The fields of the
+/// message are allocated from a few arena blocks instead of one by one, and they are
+/// all freed at once with the last reference to the message.
+inline std::shared_ptr<rpc::TaskSpec> NewTaskSpecMessage() {
+  google::protobuf::ArenaOptions options;
+  // Large enough for the common fields and a few small arguments.
+  options.start_block_size = 1024;
+  auto arena = std::make_shared<google::protobuf::Arena>(options);
+  auto message = google::protobuf::Arena::CreateMessage<rpc::TaskSpec>(arena.get());
+  // The message shares the ownership of its arena.
+  return std::shared_ptr<rpc::TaskSpec>(arena, message);
+}
+
+/// The fields of a normal task spec that are the same for repeated submissions of one
+/// remote function with the same resources: the language, the function descriptor, the
+/// caller address and the resources. The resource sets and the scheduling class are
+/// computed once, when the template is created, and shared by the task specs built
+/// from it.
+class TaskSpecTemplate {
+ public:
+  TaskSpecTemplate(
+      const Language &language, const ray::FunctionDescriptor &function_descriptor,
+      const rpc::Address &caller_address,
+      const std::unordered_map<std::string, double> &required_resources,
+      const std::unordered_map<std::string, double> &required_placement_resources)
+      : language_(language),
+        function_descriptor_(function_descriptor),
+        required_resources_(required_resources),
+        required_placement_resources_(required_placement_resources) {
+    auto message = std::make_shared<rpc::TaskSpec>();
+    message->set_type(TaskType::NORMAL_TASK);
+    message->set_language(language);
+    *message->mutable_function_descriptor() = function_descriptor->GetMessage();
+    message->mutable_caller_address()->CopyFrom(caller_address);
+    message->mutable_required_resources()->insert(required_resources.begin(),
+                                                  required_resources.end());
+    message->mutable_required_placement_resources()->insert(
+        required_placement_resources.begin(), required_placement_resources.end());
+    spec_ = TaskSpecification(std::move(message));
+  }
+
+  /// Hash the fields that select a template. This doesn't allocate memory.
+  static size_t Hash(
+      const Language &language, const ray::FunctionDescriptor &function_descriptor,
+      const std::unordered_map<std::string, double> &required_resources,
+      const std::unordered_map<std::string, double> &required_placement_resources) {
+    size_t hash = function_descriptor->Hash() ^ std::hash<int>()(language);
+    // The maps are unordered, so combine the hashes of their entries commutatively.
+    for (const auto &resource : required_resources) {
+      hash += std::hash<std::string>()(resource.first) ^
+              std::hash<double>()(resource.second);
+    }
+    for (const auto &resource : required_placement_resources) {
+      hash += 31 * (std::hash<std::string>()(resource.first) ^
+                    std::hash<double>()(resource.second));
+    }
+    return hash;
+  }
+
+  /// Whether task specs with the given fields can be built from this template. The
+  /// caller address isn't compared, since the templates are kept per worker.
+  bool Matches(
+      const Language &language, const ray::FunctionDescriptor &function_descriptor,
+      const std::unordered_map<std::string, double> &required_resources,
+      const std::unordered_map<std::string, double> &required_placement_resources) const {
+    return language_ == language && function_descriptor_ == function_descriptor &&
+           required_resources_ == required_resources &&
+           required_placement_resources_ == required_placement_resources;
+  }
+
+  /// The template task spec, with only the fields of the template set.
+  const TaskSpecification &Spec() const { return spec_; }
+
+ private:
+  const Language language_;
+  const ray::FunctionDescriptor function_descriptor_;
+  const std::unordered_map<std::string, double> required_resources_;
+  const std::unordered_map<std::string, double> required_placement_resources_;
+  TaskSpecification spec_;
+};
+
 /// Helper class for building a `TaskSpecification` object.
 class TaskSpecBuilder {
  public:
-  TaskSpecBuilder() : message_(std::make_shared<rpc::TaskSpec>()) {}
+  TaskSpecBuilder() : message_(NewTaskSpecMessage()) {}
+
+  /// Build a normal task spec from a template. The fields of the template are copied
+  /// into the message, and `SetCommonTaskSpec` leaves them as they are.
+  ///
+  /// \param task_template The template. It must match the arguments later given to
+  /// `SetCommonTaskSpec`.
+  explicit TaskSpecBuilder(std::shared_ptr<const TaskSpecTemplate> task_template)
+      : message_(NewTaskSpecMessage()), task_template_(std::move(task_template)) {
+    message_->CopyFrom(task_template_->Spec().GetMessage());
+  }
 
   /// Build the `TaskSpecification` object.
-  TaskSpecification Build() { return TaskSpecification(message_); }
+  TaskSpecification Build() {
+    if (task_template_ != nullptr) {
+      return TaskSpecification(message_, task_template_->Spec());
+    }
+    return TaskSpecification(message_);
+  }
 
   /// Get a reference to the internal protobuf message object.
   const rpc::TaskSpec &GetMessage() const { return *message_; }
@@ -92,19 +190,21 @@ class TaskSpecBuilder {
           {}) {
     message_->set_type(TaskType::NORMAL_TASK);
     message_->set_name(name);
-    message_->set_language(language);
-    *message_->mutable_function_descriptor() = function_descriptor->GetMessage();
+    if (task_template_ == nullptr) {
+      message_->set_language(language);
+      *message_->mutable_function_descriptor() = function_descriptor->GetMessage();
+      message_->mutable_caller_address()->CopyFrom(caller_address);
+      message_->mutable_required_resources()->insert(required_resources.begin(),
+                                                     required_resources.end());
+      message_->mutable_required_placement_resources()->insert(
+          required_placement_resources.begin(), required_placement_resources.end());
+    }
     message_->set_job_id(job_id.Binary());
     message_->set_task_id(task_id.Binary());
     message_->set_parent_task_id(parent_task_id.Binary());
     message_->set_parent_counter(parent_counter);
     message_->set_caller_id(caller_id.Binary());
-    message_->mutable_caller_address()->CopyFrom(caller_address);
     message_->set_num_returns(num_returns);
-    message_->mutable_required_resources()->insert(required_resources.begin(),
-                                                   required_resources.end());
-    message_->mutable_required_placement_resources()->insert(
-        required_placement_resources.begin(), required_placement_resources.end());
     message_->set_placement_group_id(bundle_id.first.Binary());
     message_->set_placement_group_bundle_index(bundle_id.second);
     message_->set_placement_group_capture_child_tasks(
@@ -151,7 +251,8 @@ class TaskSpecBuilder {
       const ActorID &actor_id, int64_t max_restarts = 0, int64_t max_task_retries = 0,
       const std::vector<std::string> &dynamic_worker_options = {},
       int max_concurrency = 1, bool is_detached = false, std::string name = "",
-      bool is_asyncio = false, const std::string &extension_data = "") {
+      bool is_asyncio = false, const std::string &extension_data = "",
+      bool allow_out_of_order_execution = false) {
     message_->set_type(TaskType::ACTOR_CREATION_TASK);
     auto actor_creation_spec = message_->mutable_actor_creation_task_spec();
     actor_creation_spec->set_actor_id(actor_id.Binary());
@@ -165,6 +266,7 @@ class TaskSpecBuilder {
     actor_creation_spec->set_name(name);
     actor_creation_spec->set_is_asyncio(is_asyncio);
     actor_creation_spec->set_extension_data(extension_data);
+    actor_creation_spec->set_allow_out_of_order_execution(allow_out_of_order_execution);
     return *this;
   }
 
@@ -189,6 +291,8 @@ class TaskSpecBuilder {
 
  private:
   std::shared_ptr<rpc::TaskSpec> message_;
+  /// The template that the task spec is built from, if any.
+  std::shared_ptr<const TaskSpecTemplate> task_template_;
 };
 
 }  // namespace ray
@@ -16,11 +16,16 @@
 
 #include <boost/asio.hpp>
 #include <boost/asio/error.hpp>
+#include <chrono>
+#include <cstring>
 #include <list>
 #include <memory>
+#include <thread>
 
 #include "gmock/gmock.h"
 #include "gtest/gtest.h"
+#include "ray/common/shared_memory_channel.h"
+#include "ray/util/util.h"
 
 namespace ray {
 namespace raylet {
@@ -55,6 +60,17 @@ class ClientConnectionTest : public ::testing::Test {
     return conn->WriteBuffer(message_buffers);
   }
 
+  /// Run the event loop until the condition holds, or the timeout expires.
+  bool RunUntil(const std::function<bool()> &condition, int64_t timeout_ms = 10000) {
+    int64_t deadline_ms = current_time_ms() + timeout_ms;
+    while (!condition() && current_time_ms() < deadline_ms) {
+      io_service_.poll();
+      io_service_.reset();
+      std::this_thread::sleep_for(std::chrono::milliseconds(1));
+    }
+    return condition();
+  }
+
  protected:
   boost::asio::io_service io_service_;
   local_stream_socket in_;
@@ -138,6 +154,104 @@ TEST_F(ClientConnectionTest, SimpleAsyncWrite) {
   ASSERT_EQ(num_messages, 3);
 }
 
+TEST_F(ClientConnectionTest, CoalescedAsyncWrites) {
+  const int num_messages = 100;
+  std::vector<int64_t> message_types;
+  ClientHandler client_handler = [](ClientConnection &client) {};
+  MessageHandler noop_handler = [](std::shared_ptr<ClientConnection> client,
+                                   int64_t message_type,
+                                   const std::vector<uint8_t> &message) {};
+  MessageHandler message_handler =
+      [&message_types](std::shared_ptr<ClientConnection> client, int64_t message_type,
+                       const std::vector<uint8_t> &message) {
+        ASSERT_EQ(message.size(), message_type % 10);
+        message_types.push_back(message_type);
+        // Stop listening in the middle of the received messages, and after the last.
+        if (message_types.size() != num_messages / 2 &&
+            message_types.size() != num_messages) {
+          client->ProcessMessages();
+        }
+      };
+
+  auto writer = ClientConnection::Create(client_handler, noop_handler, std::move(in_),
+                                         "writer", {}, error_message_type_);
+  auto reader = ClientConnection::Create(client_handler, message_handler,
+                                         std::move(out_), "reader", {},
+                                         error_message_type_);
+
+  const std::vector<uint8_t> message(10, 1);
+  int num_written = 0;
+  for (int64_t type = 0; type < num_messages; type++) {
+    writer->WriteMessageAsync(type, type % 10, message.data(),
+                              [&num_written](const ray::Status &status) {
+                                RAY_CHECK_OK(status);
+                                num_written++;
+                              });
+  }
+  reader->ProcessMessages();
+  io_service_.run();
+  io_service_.reset();
+  ASSERT_EQ(num_written, num_messages);
+  // The queued messages are written with as few system calls as possible.
+  ASSERT_NE(writer->DebugString().find("num async write calls: 2"), std::string::npos)
+      << writer->DebugString();
+  ASSERT_EQ(message_types.size(), num_messages / 2);
+
+  // The messages that were already received are handled once we listen again.
+  reader->ProcessMessages();
+  io_service_.run();
+  ASSERT_EQ(message_types.size(), num_messages);
+  for (int64_t type = 0; type < num_messages; type++) {
+    ASSERT_EQ(message_types[type], type);
+  }
+}
+
+// Measure the rate of small messages written asynchronously to one connection. Run it
+// with --gtest_also_run_disabled_tests.
+TEST_F(ClientConnectionTest, DISABLED_BenchmarkAsyncMessageRate) {
+  const int num_messages = 1000 * 1000;
+  const int batch_size = 100;
+  int num_read = 0;
+  ClientHandler client_handler = [](ClientConnection &client) {};
+  MessageHandler noop_handler = [](std::shared_ptr<ClientConnection> client,
+                                   int64_t message_type,
+                                   const std::vector<uint8_t> &message) {};
+  MessageHandler message_handler = [&num_read](std::shared_ptr<ClientConnection> client,
+                                               int64_t message_type,
+                                               const std::vector<uint8_t> &message) {
+    if (++num_read < num_messages) {
+      client->ProcessMessages();
+    }
+  };
+  auto writer = ClientConnection::Create(client_handler, noop_handler, std::move(in_),
+                                         "writer", {}, error_message_type_);
+  auto reader = ClientConnection::Create(client_handler, message_handler,
+                                         std::move(out_), "reader", {},
+                                         error_message_type_);
+
+  // Write the messages in batches from the event loop, like handlers that reply to
+  // several requests.
+  const std::vector<uint8_t> message(64, 1);
+  std::function<void(int)> write_batch = [&](int num_written) {
+    for (int i = 0; i < batch_size; i++) {
+      writer->WriteMessageAsync(0, message.size(), message.data(),
+                                [](const ray::Status &status) { RAY_CHECK_OK(status); });
+    }
+    if (num_written + batch_size < num_messages) {
+      io_service_.post([&, num_written]() { write_batch(num_written + batch_size); });
+    }
+  };
+  int64_t start_us = current_sys_time_us();
+  io_service_.post([&]() { write_batch(0); });
+  reader->ProcessMessages();
+  io_service_.run();
+  int64_t elapsed_us = current_sys_time_us() - start_us;
+  ASSERT_EQ(num_read, num_messages);
+  RAY_LOG(INFO) << "Async messages per second: "
+                << static_cast<double>(num_messages) * 1e6 / elapsed_us
+                << writer->DebugString();
+}
+
 TEST_F(ClientConnectionTest, SimpleSyncReadWriteMessage) {
   auto writer = ServerConnection::Create(std::move(in_));
   auto reader = ServerConnection::Create(std::move(out_));
@@ -240,6 +354,157 @@ TEST_F(ClientConnectionTest, ProcessBadMessage) {
   ASSERT_EQ(num_messages, 0);
 }
 
+// Shared-memory message rings are only implemented on Linux.
+#ifdef __linux__
+
+TEST_F(ClientConnectionTest, MessageRing) {
+  std::vector<int64_t> message_types;
+  ClientHandler client_handler = [](ClientConnection &client) {};
+  MessageHandler message_handler =
+      [&message_types](std::shared_ptr<ClientConnection> client, int64_t message_type,
+                       const std::vector<uint8_t> &message) {
+        ASSERT_EQ(message.size(), message_type);
+        message_types.push_back(message_type);
+        client->ProcessMessages();
+      };
+  auto writer = ServerConnection::Create(std::move(in_));
+  auto reader = ClientConnection::Create(client_handler, message_handler,
+                                         std::move(out_), "reader", {}, 100);
+
+  const std::string ring_name = "/ray_test_ring_" + UniqueID::FromRandom().Hex();
+  std::shared_ptr<SharedMemoryRing> ring =
+      SharedMemoryRing::Create(ring_name, /*capacity=*/1024);
+  ASSERT_TRUE(ring != nullptr);
+  reader->AttachMessageRing(ring);
+  MessageRingPoller poller(
+      io_service_,
+      SharedMemoryDoorbell::Create("/ray_test_doorbell_" + UniqueID::FromRandom().Hex()),
+      /*batch_size=*/2);
+  auto producer = SharedMemoryRing::Open(
+      ring_name, SharedMemoryDoorbell::Open(poller.DoorbellName()));
+  ASSERT_TRUE(producer != nullptr);
+
+  // Messages written before the client is added are delivered, in batches.
+  const std::vector<uint8_t> message(10, 1);
+  for (int64_t type = 0; type < 5; type++) {
+    RAY_CHECK_OK(producer->Write(type, type, message.data(), 0));
+  }
+  reader->ProcessMessages();
+  poller.AddClient(reader);
+  ASSERT_TRUE(RunUntil([&message_types]() { return message_types.size() == 5; }));
+
+  // A message that does not fit in the ring goes to the socket, once the ring is
+  // drained. The messages written to the ring after it are handled after it.
+  RAY_CHECK_OK(producer->Write(5, 5, message.data(), 0));
+  ASSERT_TRUE(RunUntil([&producer]() { return producer->Empty(); }));
+  RAY_CHECK_OK(producer->Write(kMessageOnSocketType, 0, nullptr, 0));
+  RAY_CHECK_OK(producer->Write(7, 7, message.data(), 0));
+  ASSERT_FALSE(RunUntil([&message_types]() { return message_types.size() > 6; }, 100));
+  RAY_CHECK_OK(writer->WriteMessage(6, 6, message.data()));
+  ASSERT_TRUE(RunUntil([&message_types]() { return message_types.size() == 8; }));
+  ASSERT_EQ(message_types, std::vector<int64_t>({0, 1, 2, 3, 4, 5, 6, 7}));
+}
+
+TEST_F(ClientConnectionTest, CorruptedMessageRing) {
+  std::vector<int64_t> message_types;
+  ClientHandler client_handler = [](ClientConnection &client) {};
+  MessageHandler message_handler =
+      [&message_types](std::shared_ptr<ClientConnection> client, int64_t message_type,
+                       const std::vector<uint8_t> &message) {
+        message_types.push_back(message_type);
+      };
+  auto writer = ServerConnection::Create(std::move(in_));
+  auto reader = ClientConnection::Create(client_handler, message_handler,
+                                         std::move(out_), "reader", {}, 100);
+
+  const std::string ring_name = "/ray_test_ring_" + UniqueID::FromRandom().Hex();
+  std::shared_ptr<SharedMemoryRing> ring =
+      SharedMemoryRing::Create(ring_name, /*capacity=*/1024);
+  ASSERT_TRUE(ring != nullptr);
+  reader->AttachMessageRing(ring);
+  auto segment = SharedMemorySegment::Open(ring_name);
+  ASSERT_TRUE(segment != nullptr);
+  auto producer = SharedMemoryRing::Open(ring_name, nullptr);
+  ASSERT_TRUE(producer != nullptr);
+
+  // A client that writes an impossible message length is disconnected, instead of
+  // crashing the reader.
+  const int64_t type = 0x5eadbeef5eadbeef;
+  const int64_t length = 1L << 40;
+  const std::vector<uint8_t> message(10, 1);
+  RAY_CHECK_OK(producer->Write(type, message.size(), message.data(), 0));
+  for (size_t offset = 0; offset + 2 * sizeof(int64_t) <= segment->Size();
+       offset += sizeof(int64_t)) {
+    if (std::memcmp(segment->Data() + offset, &type, sizeof(type)) == 0) {
+      std::memcpy(segment->Data() + offset + sizeof(type), &length, sizeof(length));
+      break;
+    }
+  }
+  ASSERT_FALSE(reader->ProcessRingMessages(10));
+  ASSERT_FALSE(reader->HasOpenMessageRing());
+  ASSERT_EQ(message_types, std::vector<int64_t>({100}));
+}
+
+// Measure the round trip of a request from a worker to the raylet and the reply, with
+// the request written to the socket or to a message ring. The reply is always written
+// to the socket. Run it with --gtest_also_run_disabled_tests.
+TEST_F(ClientConnectionTest, DISABLED_BenchmarkRequestLatency) {
+  const int num_requests = 100 * 1000;
+  const int64_t request_type = 1;
+  const int64_t reply_type = 2;
+  ClientHandler client_handler = [](ClientConnection &client) {};
+  MessageHandler message_handler = [reply_type](std::shared_ptr<ClientConnection> client,
+                                                int64_t message_type,
+                                                const std::vector<uint8_t> &message) {
+    RAY_CHECK_OK(client->WriteMessage(reply_type, message.size(), message.data()));
+    client->ProcessMessages();
+  };
+  auto worker = ServerConnection::Create(std::move(in_));
+  auto raylet = ClientConnection::Create(client_handler, message_handler,
+                                         std::move(out_), "raylet", {}, 100);
+
+  const std::string ring_name = "/ray_test_ring_" + UniqueID::FromRandom().Hex();
+  std::shared_ptr<SharedMemoryRing> ring =
+      SharedMemoryRing::Create(ring_name, /*capacity=*/1024 * 1024);
+  ASSERT_TRUE(ring != nullptr);
+  raylet->AttachMessageRing(ring);
+  MessageRingPoller poller(
+      io_service_,
+      SharedMemoryDoorbell::Create("/ray_test_doorbell_" + UniqueID::FromRandom().Hex()),
+      /*batch_size=*/64);
+  auto producer = SharedMemoryRing::Open(
+      ring_name, SharedMemoryDoorbell::Open(poller.DoorbellName()));
+  ASSERT_TRUE(producer != nullptr);
+  raylet->ProcessMessages();
+  poller.AddClient(raylet);
+
+  boost::asio::io_service::work work(io_service_);
+  std::thread raylet_thread([this]() { io_service_.run(); });
+
+  const std::vector<uint8_t> request(100, 1);
+  std::vector<uint8_t> reply;
+  int64_t start_us = current_sys_time_us();
+  for (int i = 0; i < num_requests; i++) {
+    RAY_CHECK_OK(worker->WriteMessage(request_type, request.size(), request.data()));
+    RAY_CHECK_OK(worker->ReadMessage(reply_type, &reply));
+  }
+  int64_t socket_us = current_sys_time_us() - start_us;
+  start_us = current_sys_time_us();
+  for (int i = 0; i < num_requests; i++) {
+    RAY_CHECK_OK(producer->Write(request_type, request.size(), request.data(), 1000));
+    RAY_CHECK_OK(worker->ReadMessage(reply_type, &reply));
+  }
+  int64_t ring_us = current_sys_time_us() - start_us;
+
+  io_service_.stop();
+  raylet_thread.join();
+  RAY_LOG(INFO) << "Round trip per request: socket "
+                << static_cast<double>(socket_us) / num_requests << " us, ring "
+                << static_cast<double>(ring_us) / num_requests << " us";
+}
+
+#endif  // __linux__
+
 }  // namespace raylet
 
 }  // namespace ray
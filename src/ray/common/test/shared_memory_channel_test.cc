@@ -0,0 +1,217 @@
+// Copyright 2017 The Ray Authors.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//  http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "ray/common/shared_memory_channel.h"
+
+#include <chrono>
+#include <cstring>
+#include <limits>
+#include <thread>
+
+#include "gtest/gtest.h"
+#include "ray/common/id.h"
+
+namespace ray {
+
+// Shared-memory rings are only implemented on Linux.
+#ifdef __linux__
+
+class SharedMemoryChannelTest : public ::testing::Test {
+ public:
+  SharedMemoryChannelTest()
+      : ring_name_("/ray_test_ring_" + UniqueID::FromRandom().Hex()),
+        doorbell_name_("/ray_test_doorbell_" + UniqueID::FromRandom().Hex()) {}
+
+  void SetUp() override {
+    consumer_ = SharedMemoryRing::Create(ring_name_, /*capacity=*/256);
+    ASSERT_TRUE(consumer_ != nullptr);
+    doorbell_ = SharedMemoryDoorbell::Create(doorbell_name_);
+    ASSERT_TRUE(doorbell_ != nullptr);
+    // Map the ring before the producer unlinks its name, to corrupt it in tests.
+    segment_ = SharedMemorySegment::Open(ring_name_);
+    ASSERT_TRUE(segment_ != nullptr);
+    producer_ =
+        SharedMemoryRing::Open(ring_name_, SharedMemoryDoorbell::Open(doorbell_name_));
+    ASSERT_TRUE(producer_ != nullptr);
+  }
+
+  std::vector<std::vector<uint8_t>> ReadAll() {
+    std::vector<std::vector<uint8_t>> messages;
+    RAY_CHECK_OK(
+        consumer_->Read(std::numeric_limits<size_t>::max(),
+                        [&messages](int64_t type, const std::vector<uint8_t> &message) {
+                          messages.push_back(message);
+                          return true;
+                        }));
+    return messages;
+  }
+
+  /// Overwrite the length of the message of the given type, as a broken producer
+  /// would.
+  void CorruptMessageLength(int64_t type, int64_t length) {
+    for (size_t offset = 0; offset + 2 * sizeof(int64_t) <= segment_->Size();
+         offset += sizeof(int64_t)) {
+      if (std::memcmp(segment_->Data() + offset, &type, sizeof(type)) == 0) {
+        std::memcpy(segment_->Data() + offset + sizeof(type), &length, sizeof(length));
+        return;
+      }
+    }
+    FAIL() << "Message not found";
+  }
+
+ protected:
+  std::string ring_name_;
+  std::string doorbell_name_;
+  std::unique_ptr<SharedMemoryRing> consumer_;
+  std::unique_ptr<SharedMemoryDoorbell> doorbell_;
+  std::unique_ptr<SharedMemorySegment> segment_;
+  std::unique_ptr<SharedMemoryRing> producer_;
+};
+
+TEST_F(SharedMemoryChannelTest, TestWriteAndRead) {
+  const std::vector<uint8_t> message = {1, 2, 3, 4, 5};
+  ASSERT_TRUE(consumer_->Empty());
+  RAY_CHECK_OK(producer_->Write(42, message.size(), message.data(), 0));
+  RAY_CHECK_OK(producer_->Write(43, 0, nullptr, 0));
+  ASSERT_FALSE(consumer_->Empty());
+
+  std::vector<int64_t> types;
+  std::vector<std::vector<uint8_t>> messages;
+  auto handler = [&](int64_t type, const std::vector<uint8_t> &message) {
+    types.push_back(type);
+    messages.push_back(message);
+    return true;
+  };
+  // Messages are read in batches.
+  size_t num_read = 0;
+  RAY_CHECK_OK(consumer_->Read(1, handler, &num_read));
+  ASSERT_EQ(num_read, 1);
+  RAY_CHECK_OK(consumer_->Read(10, handler, &num_read));
+  ASSERT_EQ(num_read, 1);
+  ASSERT_EQ(types, std::vector<int64_t>({42, 43}));
+  ASSERT_EQ(messages[0], message);
+  ASSERT_TRUE(messages[1].empty());
+  ASSERT_TRUE(consumer_->Empty());
+}
+
+TEST_F(SharedMemoryChannelTest, TestWrapAround) {
+  // Messages of different sizes end at different offsets, so that some of them do not
+  // fit before the end of the ring.
+  for (uint8_t i = 0; i < 100; i++) {
+    std::vector<uint8_t> message(i % 50, i);
+    RAY_CHECK_OK(producer_->Write(i, message.size(), message.data(), 0));
+    auto messages = ReadAll();
+    ASSERT_EQ(messages.size(), 1);
+    ASSERT_EQ(messages[0], message);
+  }
+}
+
+TEST_F(SharedMemoryChannelTest, TestWriteToFullRing) {
+  const std::vector<uint8_t> message(producer_->MaxMessageLength(), 7);
+  RAY_CHECK_OK(producer_->Write(0, message.size(), message.data(), 0));
+  RAY_CHECK_OK(producer_->Write(0, message.size(), message.data(), 0));
+  // There is no space left for a third message until the others are read.
+  ASSERT_TRUE(producer_->Write(0, message.size(), message.data(), 10).IsTimedOut());
+  ASSERT_TRUE(producer_->WaitUntilEmpty(10).IsTimedOut());
+  ASSERT_EQ(ReadAll().size(), 2);
+  RAY_CHECK_OK(producer_->WaitUntilEmpty(0));
+  RAY_CHECK_OK(producer_->Write(0, message.size(), message.data(), 0));
+}
+
+TEST_F(SharedMemoryChannelTest, TestWriteBlocksUntilSpace) {
+  const std::vector<uint8_t> message(producer_->MaxMessageLength(), 7);
+  RAY_CHECK_OK(producer_->Write(0, message.size(), message.data(), 0));
+  RAY_CHECK_OK(producer_->Write(0, message.size(), message.data(), 0));
+  Status status;
+  std::thread producer([this, &message, &status]() {
+    status = producer_->Write(0, message.size(), message.data(), 60000);
+  });
+  // The producer wakes up as soon as the consumer frees space.
+  auto start = std::chrono::steady_clock::now();
+  ASSERT_EQ(ReadAll().size(), 2);
+  producer.join();
+  RAY_CHECK_OK(status);
+  ASSERT_LT(std::chrono::steady_clock::now() - start, std::chrono::seconds(30));
+  ASSERT_EQ(ReadAll().size(), 1);
+}
+
+TEST_F(SharedMemoryChannelTest, TestCorruptedRing) {
+  const std::vector<uint8_t> message(10, 1);
+  const int64_t type = 0x5eadbeef5eadbeef;
+  RAY_CHECK_OK(producer_->Write(type, message.size(), message.data(), 0));
+  CorruptMessageLength(type, 1L << 40);
+  int num_handled = 0;
+  auto status =
+      consumer_->Read(10, [&num_handled](int64_t, const std::vector<uint8_t> &) {
+        num_handled++;
+        return true;
+      });
+  ASSERT_TRUE(status.IsIOError());
+  ASSERT_EQ(num_handled, 0);
+}
+
+TEST_F(SharedMemoryChannelTest, TestCorruptedCapacity) {
+  const std::vector<uint8_t> message(10, 1);
+  RAY_CHECK_OK(producer_->Write(0, message.size(), message.data(), 0));
+  const int64_t max_message_length = consumer_->MaxMessageLength();
+  // The capacity is the first field of the header.
+  const uint64_t capacity = 1UL << 40;
+  std::memcpy(segment_->Data(), &capacity, sizeof(capacity));
+  // The consumer keeps the capacity that it created the ring with.
+  ASSERT_EQ(consumer_->MaxMessageLength(), max_message_length);
+  auto messages = ReadAll();
+  ASSERT_EQ(messages.size(), 1);
+  ASSERT_EQ(messages[0], message);
+
+  // A ring whose capacity does not match its segment can't be opened.
+  const std::string name = "/ray_test_ring_" + UniqueID::FromRandom().Hex();
+  auto ring = SharedMemoryRing::Create(name, /*capacity=*/256);
+  ASSERT_TRUE(ring != nullptr);
+  auto segment = SharedMemorySegment::Open(name);
+  ASSERT_TRUE(segment != nullptr);
+  std::memcpy(segment->Data(), &capacity, sizeof(capacity));
+  ASSERT_TRUE(SharedMemoryRing::Open(name, nullptr) == nullptr);
+}
+
+TEST_F(SharedMemoryChannelTest, TestDoorbell) {
+  const uint8_t message[1] = {1};
+  uint32_t sequence = doorbell_->Sequence();
+  // The first message to a drained ring rings the doorbell.
+  RAY_CHECK_OK(producer_->Write(0, 1, message, 0));
+  sequence = doorbell_->Wait(sequence, 1000);
+  ASSERT_EQ(sequence, doorbell_->Sequence());
+  // The consumer did not drain the ring since, so the next message does not.
+  RAY_CHECK_OK(producer_->Write(0, 1, message, 0));
+  ASSERT_EQ(doorbell_->Wait(sequence, 10), sequence);
+
+  consumer_->ClearNotified();
+  ASSERT_EQ(ReadAll().size(), 2);
+  std::thread producer([this, &message]() {
+    std::this_thread::sleep_for(std::chrono::milliseconds(10));
+    RAY_CHECK_OK(producer_->Write(0, 1, message, 0));
+  });
+  // Wake up as soon as the producer writes again.
+  ASSERT_NE(doorbell_->Wait(sequence, 10000), sequence);
+  producer.join();
+  ASSERT_EQ(ReadAll().size(), 1);
+}
+
+#endif  // __linux__
+
+}  // namespace ray
+
+int main(int argc, char **argv) {
+  ::testing::InitGoogleTest(&argc, argv);
+  return RUN_ALL_TESTS();
+}
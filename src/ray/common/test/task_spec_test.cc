@@ -0,0 +1,243 @@
+// Copyright 2017 The Ray Authors.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//  http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "ray/common/task/task_spec.h"
+
+#include <atomic>
+#include <cstdlib>
+#include <cstring>
+#include <new>
+
+#include "gtest/gtest.h"
+#include "ray/common/task/task_util.h"
+
+namespace {
+
+/// The number of heap allocations made by this process, for the allocation benchmark.
+std::atomic<int64_t> num_allocations(0);
+
+}  // namespace
+
+void *operator new(size_t size) {
+  num_allocations++;
+  void *ptr = std::malloc(size);
+  if (ptr == nullptr) {
+    throw std::bad_alloc();
+  }
+  return ptr;
+}
+
+void operator delete(void *ptr) noexcept { std::free(ptr); }
+
+void operator delete(void *ptr, size_t size) noexcept { std::free(ptr); }
+
+namespace ray {
+
+class TaskSpecTest : public ::testing::Test {
+ protected:
+  TaskSpecTest()
+      : function_descriptor_(
+            FunctionDescriptorBuilder::BuildPython("module", "", "function", "hash")),
+        resources_({{"CPU", 1}, {"custom", 0.5}}),
+        arg_id_(ObjectID::FromRandom()) {
+    caller_address_.set_ip_address("127.0.0.1");
+    caller_address_.set_port(1234);
+    caller_address_.set_worker_id(WorkerID::FromRandom().Binary());
+  }
+
+  TaskSpecification BuildTask(TaskSpecBuilder &builder, int index,
+                              Language language = Language::PYTHON) {
+    const TaskID task_id = TaskID::ForNormalTask(JobID::FromInt(1), TaskID::Nil(), index);
+    builder.SetCommonTaskSpec(task_id, "function()", language,
+                              function_descriptor_, JobID::FromInt(1), TaskID::Nil(),
+                              index, TaskID::Nil(), caller_address_, 1, resources_, {},
+                              std::make_pair(PlacementGroupID::Nil(), -1), true, "");
+    builder.AddArg(TaskArgByReference(arg_id_, caller_address_));
+    return builder.Build();
+  }
+
+  std::shared_ptr<const TaskSpecTemplate> MakeTemplate() {
+    return std::make_shared<const TaskSpecTemplate>(
+        Language::PYTHON, function_descriptor_, caller_address_, resources_,
+        std::unordered_map<std::string, double>());
+  }
+
+  FunctionDescriptor function_descriptor_;
+  std::unordered_map<std::string, double> resources_;
+  ObjectID arg_id_;
+  rpc::Address caller_address_;
+};
+
+TEST_F(TaskSpecTest, TestBuildFromTemplate) {
+  auto task_template = MakeTemplate();
+  TaskSpecBuilder builder;
+  auto spec = BuildTask(builder, 1);
+  TaskSpecBuilder template_builder(task_template);
+  auto template_spec = BuildTask(template_builder, 1);
+
+  ASSERT_EQ(template_spec.TaskId(), spec.TaskId());
+  ASSERT_TRUE(template_spec.IsNormalTask());
+  ASSERT_EQ(template_spec.GetLanguage(), Language::PYTHON);
+  ASSERT_EQ(template_spec.FunctionDescriptor(), function_descriptor_);
+  ASSERT_EQ(template_spec.CallerAddress().port(), caller_address_.port());
+  ASSERT_EQ(template_spec.NumArgs(), 1);
+  ASSERT_EQ(template_spec.ArgId(0), arg_id_);
+  ASSERT_TRUE(template_spec.GetRequiredResources().IsEqual(spec.GetRequiredResources()));
+  ASSERT_TRUE(template_spec.GetRequiredPlacementResources().IsEqual(
+      spec.GetRequiredPlacementResources()));
+  ASSERT_EQ(template_spec.GetSchedulingClass(), spec.GetSchedulingClass());
+  // The resources are computed once per template.
+  ASSERT_EQ(&template_spec.GetRequiredResources(),
+            &task_template->Spec().GetRequiredResources());
+
+  // A task spec built from the template survives the builder and the template.
+  TaskSpecification copy;
+  {
+    TaskSpecBuilder other_builder(MakeTemplate());
+    copy = BuildTask(other_builder, 2);
+  }
+  ASSERT_EQ(copy.ParentCounter(), 2);
+  ASSERT_EQ(copy.GetSchedulingClass(), spec.GetSchedulingClass());
+}
+
+TEST_F(TaskSpecTest, TestTemplateMatches) {
+  auto task_template = MakeTemplate();
+  const std::unordered_map<std::string, double> no_resources;
+  ASSERT_TRUE(task_template->Matches(Language::PYTHON, function_descriptor_, resources_,
+                                     no_resources));
+  ASSERT_EQ(TaskSpecTemplate::Hash(Language::PYTHON, function_descriptor_, resources_,
+                                   no_resources),
+            TaskSpecTemplate::Hash(Language::PYTHON,
+                                   FunctionDescriptorBuilder::BuildPython(
+                                       "module", "", "function", "hash"),
+                                   {{"custom", 0.5}, {"CPU", 1}}, no_resources));
+
+  auto other_function =
+      FunctionDescriptorBuilder::BuildPython("module", "", "other_function", "hash");
+  ASSERT_FALSE(task_template->Matches(Language::PYTHON, other_function, resources_,
+                                      no_resources));
+  ASSERT_FALSE(task_template->Matches(Language::PYTHON, function_descriptor_,
+                                      {{"CPU", 2}}, no_resources));
+  ASSERT_FALSE(task_template->Matches(Language::PYTHON, function_descriptor_, resources_,
+                                      resources_));
+  ASSERT_FALSE(task_template->Matches(Language::JAVA, function_descriptor_, resources_,
+                                      no_resources));
+}
+
+TEST_F(TaskSpecTest, TestArgBuffers) {
+  uint8_t data[] = {1, 2, 3, 4};
+  uint8_t metadata[] = {5, 6};
+  std::shared_ptr<Buffer> data_buffer;
+  std::shared_ptr<Buffer> metadata_buffer;
+  {
+    TaskSpecBuilder builder(MakeTemplate());
+    BuildTask(builder, 1);
+    builder.AddArg(TaskArgByValue(std::make_shared<RayObject>(
+        std::make_shared<LocalMemoryBuffer>(data, sizeof(data)),
+        std::make_shared<LocalMemoryBuffer>(metadata, sizeof(metadata)),
+        std::vector<ObjectID>())));
+    auto spec = builder.Build();
+    ASSERT_EQ(spec.NumArgs(), 2);
+    data_buffer = spec.ArgDataBuffer(1);
+    metadata_buffer = spec.ArgMetadataBuffer(1);
+    ASSERT_EQ(spec.ArgDataBuffer(0), nullptr);
+    // The metadata points into the task spec instead of a copy of the argument.
+    ASSERT_EQ(metadata_buffer->Data(), spec.ArgMetadata(1));
+    ASSERT_TRUE(metadata_buffer->IsReadOnly());
+    // The data is always aligned. It only points into the task spec if the task spec
+    // already holds it at an aligned address.
+    ASSERT_EQ(reinterpret_cast<uintptr_t>(data_buffer->Data()) % BUFFER_ALIGNMENT, 0);
+    if (reinterpret_cast<uintptr_t>(spec.ArgData(1)) % BUFFER_ALIGNMENT == 0) {
+      ASSERT_EQ(data_buffer->Data(), spec.ArgData(1));
+      ASSERT_TRUE(data_buffer->IsReadOnly());
+    } else {
+      ASSERT_NE(data_buffer->Data(), spec.ArgData(1));
+    }
+  }
+  // The buffers stay valid after the task spec goes away.
+  ASSERT_EQ(data_buffer->Size(), sizeof(data));
+  ASSERT_EQ(std::memcmp(data_buffer->Data(), data, sizeof(data)), 0);
+  ASSERT_EQ(metadata_buffer->Size(), sizeof(metadata));
+  ASSERT_EQ(std::memcmp(metadata_buffer->Data(), metadata, sizeof(metadata)), 0);
+}
+
+TEST_F(TaskSpecTest, TestMisalignedArgBufferAliasedForNonPython) {
+  const std::vector<uint8_t> data(100, 1);
+  // Build tasks until the argument lands at a misaligned address.
+  std::vector<std::unique_ptr<TaskSpecBuilder>> builders;
+  for (int i = 0; i < 100; i++) {
+    builders.emplace_back(new TaskSpecBuilder());
+    BuildTask(*builders.back(), i, Language::JAVA);
+    builders.back()->AddArg(TaskArgByValue(std::make_shared<RayObject>(
+        std::make_shared<LocalMemoryBuffer>(const_cast<uint8_t *>(data.data()),
+                                            data.size()),
+        nullptr, std::vector<ObjectID>())));
+    auto spec = builders.back()->Build();
+    if (reinterpret_cast<uintptr_t>(spec.ArgData(1)) % BUFFER_ALIGNMENT == 0) {
+      continue;
+    }
+    // Only Python needs aligned arguments, so the data of other languages is not
+    // copied.
+    auto data_buffer = spec.ArgDataBuffer(1);
+    ASSERT_EQ(data_buffer->Data(), spec.ArgData(1));
+    ASSERT_TRUE(data_buffer->IsReadOnly());
+    ASSERT_EQ(data_buffer->Size(), data.size());
+    return;
+  }
+  FAIL() << "No argument landed at a misaligned address";
+}
+
+// Count the heap allocations of building a task spec on an arena, with and without a
+// template. For reference, also count the allocations of copying the same task spec
+// into a message on the heap. Run it with --gtest_also_run_disabled_tests.
+TEST_F(TaskSpecTest, DISABLED_BenchmarkTaskSpecAllocations) {
+  const int num_tasks = 100 * 1000;
+  auto task_template = MakeTemplate();
+
+  int64_t heap_allocations = 0;
+  int64_t arena_allocations = 0;
+  int64_t template_allocations = 0;
+  for (int i = 0; i < num_tasks; i++) {
+    TaskSpecBuilder builder;
+    auto spec = BuildTask(builder, i);
+    int64_t start = num_allocations.load();
+    TaskSpecification heap_spec(std::make_shared<rpc::TaskSpec>(spec.GetMessage()));
+    heap_allocations += num_allocations.load() - start;
+  }
+  for (int i = 0; i < num_tasks; i++) {
+    int64_t start = num_allocations.load();
+    TaskSpecBuilder builder;
+    auto spec = BuildTask(builder, i);
+    arena_allocations += num_allocations.load() - start;
+  }
+  for (int i = 0; i < num_tasks; i++) {
+    int64_t start = num_allocations.load();
+    TaskSpecBuilder builder(task_template);
+    auto spec = BuildTask(builder, i);
+    template_allocations += num_allocations.load() - start;
+  }
+  RAY_LOG(INFO) << "Heap allocations per task spec: copy to the heap "
+                << static_cast<double>(heap_allocations) / num_tasks << ", arena "
+                << static_cast<double>(arena_allocations) / num_tasks
+                << ", arena with template "
+                << static_cast<double>(template_allocations) / num_tasks;
+  ASSERT_LT(template_allocations, arena_allocations);
+}
+
+}  // namespace ray
+
+int main(int argc, char **argv) {
+  ::testing::InitGoogleTest(&argc, argv);
+  return RUN_ALL_TESTS();
+}
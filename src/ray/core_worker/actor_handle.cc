@@ -23,7 +23,8 @@ ray::rpc::ActorHandle CreateInnerActorHandle(
     const ray::rpc::Address &owner_address, const class JobID &job_id,
     const ObjectID &initial_cursor, const Language actor_language,
     const ray::FunctionDescriptor &actor_creation_task_function_descriptor,
-    const std::string &extension_data, int64_t max_task_retries) {
+    const std::string &extension_data, int64_t max_task_retries,
+    bool allow_out_of_order_execution, bool executes_tasks_concurrently) {
   ray::rpc::ActorHandle inner;
   inner.set_actor_id(actor_id.Data(), actor_id.Size());
   inner.set_owner_id(owner_id.Binary());
@@ -35,6 +36,8 @@ ray::rpc::ActorHandle CreateInnerActorHandle(
   inner.set_actor_cursor(initial_cursor.Binary());
   inner.set_extension_data(extension_data);
   inner.set_max_task_retries(max_task_retries);
+  inner.set_allow_out_of_order_execution(allow_out_of_order_execution);
+  inner.set_executes_tasks_concurrently(executes_tasks_concurrently);
   return inner;
 }
 
@@ -60,6 +63,14 @@ ray::rpc::ActorHandle CreateInnerActorHandleFromActorTableData(
       actor_table_data.task_spec().actor_creation_task_spec().extension_data());
   inner.set_max_task_retries(
       actor_table_data.task_spec().actor_creation_task_spec().max_task_retries());
+  inner.set_allow_out_of_order_execution(
+      actor_table_data.task_spec()
+          .actor_creation_task_spec()
+          .allow_out_of_order_execution());
+  const auto &actor_creation_task_spec =
+      actor_table_data.task_spec().actor_creation_task_spec();
+  inner.set_executes_tasks_concurrently(actor_creation_task_spec.max_concurrency() > 1 ||
+                                        actor_creation_task_spec.is_asyncio());
   return inner;
 }
 
@@ -72,10 +83,12 @@ ActorHandle::ActorHandle(
     const rpc::Address &owner_address, const class JobID &job_id,
     const ObjectID &initial_cursor, const Language actor_language,
     const ray::FunctionDescriptor &actor_creation_task_function_descriptor,
-    const std::string &extension_data, int64_t max_task_retries)
+    const std::string &extension_data, int64_t max_task_retries,
+    bool allow_out_of_order_execution, bool executes_tasks_concurrently)
     : ActorHandle(CreateInnerActorHandle(
           actor_id, owner_id, owner_address, job_id, initial_cursor, actor_language,
-          actor_creation_task_function_descriptor, extension_data, max_task_retries)) {}
+          actor_creation_task_function_descriptor, extension_data, max_task_retries,
+          allow_out_of_order_execution, executes_tasks_concurrently)) {}
 
 ActorHandle::ActorHandle(const std::string &serialized)
     : ActorHandle(CreateInnerActorHandleFromString(serialized)) {}
@@ -35,7 +35,9 @@ class ActorHandle {
               const rpc::Address &owner_address, const JobID &job_id,
               const ObjectID &initial_cursor, const Language actor_language,
               const ray::FunctionDescriptor &actor_creation_task_function_descriptor,
-              const std::string &extension_data, int64_t max_task_retries);
+              const std::string &extension_data, int64_t max_task_retries,
+              bool allow_out_of_order_execution = false,
+              bool executes_tasks_concurrently = false);
 
   /// Constructs an ActorHandle from a serialized string.
   ActorHandle(const std::string &serialized);
@@ -82,6 +84,13 @@ class ActorHandle {
 
   int64_t MaxTaskRetries() const { return inner_.max_task_retries(); }
 
+  /// Whether the actor may execute tasks out of submission order. Callers then send
+  /// the tasks as soon as their dependencies are resolved.
+  bool AllowOutOfOrderExecution() const { return inner_.allow_out_of_order_execution(); }
+
+  /// Whether the actor may run several tasks at once, i.e. it is threaded or async.
+  bool ExecutesTasksConcurrently() const { return inner_.executes_tasks_concurrently(); }
+
  private:
   // Protobuf-defined persistent state of the actor handle.
   const ray::rpc::ActorHandle inner_;
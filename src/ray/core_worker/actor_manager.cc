@@ -18,6 +18,84 @@
 
 namespace ray {
 
+Status DefaultActorCreator::RegisterActor(const TaskSpecification &task_spec) {
+  auto promise = std::make_shared<std::promise<void>>();
+  QueueRequest(registrations_, task_spec,
+               [promise](const Status &status) { promise->set_value(); },
+               [this](const std::vector<TaskSpecification> &task_specs,
+                      const gcs::MultiItemCallback<Status> &callback) {
+                 return gcs_client_->Actors().AsyncRegisterActors(task_specs, callback);
+               });
+  if (promise->get_future().wait_for(std::chrono::seconds(
+          RayConfig::instance().gcs_server_request_timeout_seconds())) !=
+      std::future_status::ready) {
+    std::ostringstream stream;
+    stream << "There was timeout in registering an actor. It is probably "
+              "because GCS server is dead or there's a high load there.";
+    return Status::TimedOut(stream.str());
+  }
+  return Status::OK();
+}
+
+Status DefaultActorCreator::AsyncCreateActor(const TaskSpecification &task_spec,
+                                             const gcs::StatusCallback &callback) {
+  QueueRequest(creations_, task_spec, callback,
+               [this](const std::vector<TaskSpecification> &task_specs,
+                      const gcs::MultiItemCallback<Status> &callback) {
+                 return gcs_client_->Actors().AsyncCreateActors(task_specs, callback);
+               });
+  return Status::OK();
+}
+
+void DefaultActorCreator::QueueRequest(RequestQueue &queue,
+                                       const TaskSpecification &task_spec,
+                                       const gcs::StatusCallback &callback,
+                                       const BatchFn &send_batch) {
+  absl::MutexLock lock(&mu_);
+  queue.task_specs.push_back(task_spec);
+  queue.callbacks.push_back(callback);
+  if (!queue.flush_posted) {
+    queue.flush_posted = true;
+    io_service_.post(
+        [this, &queue, send_batch]() { FlushRequests(queue, send_batch); });
+  }
+}
+
+void DefaultActorCreator::FlushRequests(RequestQueue &queue, const BatchFn &send_batch) {
+  std::vector<TaskSpecification> task_specs;
+  std::vector<gcs::StatusCallback> callbacks;
+  {
+    absl::MutexLock lock(&mu_);
+    task_specs.swap(queue.task_specs);
+    callbacks.swap(queue.callbacks);
+    queue.flush_posted = false;
+  }
+  for (size_t start = 0; start < task_specs.size(); start += max_actors_per_batch_) {
+    const size_t end = std::min<size_t>(start + max_actors_per_batch_, task_specs.size());
+    std::vector<TaskSpecification> batch(task_specs.begin() + start,
+                                         task_specs.begin() + end);
+    std::vector<gcs::StatusCallback> batch_callbacks(callbacks.begin() + start,
+                                                     callbacks.begin() + end);
+    auto on_reply = [batch_callbacks](const Status &status,
+                                      const std::vector<Status> &statuses) {
+      // Without a status per actor, every actor of the batch gets the batch's status.
+      const bool per_actor = statuses.size() == batch_callbacks.size();
+      const Status batch_status =
+          status.ok() ? Status::IOError("The GCS replied to a wrong number of actors")
+                      : status;
+      for (size_t i = 0; i < batch_callbacks.size(); i++) {
+        if (batch_callbacks[i]) {
+          batch_callbacks[i](per_actor ? statuses[i] : batch_status);
+        }
+      }
+    };
+    auto status = send_batch(batch, on_reply);
+    if (!status.ok()) {
+      on_reply(status, {});
+    }
+  }
+}
+
 ActorID ActorManager::RegisterActorHandle(std::unique_ptr<ActorHandle> actor_handle,
                                           const ObjectID &outer_object_id,
                                           const TaskID &caller_id,
@@ -76,7 +154,9 @@ bool ActorManager::AddActorHandle(std::unique_ptr<ActorHandle> actor_handle,
                                   const ActorID &actor_id,
                                   const ObjectID &actor_creation_return_id) {
   reference_counter_->AddLocalReference(actor_creation_return_id, call_site);
-  direct_actor_submitter_->AddActorQueueIfNotExists(actor_id);
+  direct_actor_submitter_->AddActorQueueIfNotExists(
+      actor_id, actor_handle->AllowOutOfOrderExecution(),
+      actor_handle->ExecutesTasksConcurrently());
   bool inserted;
   {
     absl::MutexLock lock(&mutex_);
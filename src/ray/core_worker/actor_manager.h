@@ -40,33 +40,55 @@ class ActorCreatorInterface {
                                   const gcs::StatusCallback &callback) = 0;
 };
 
+/// Registers and creates actors with the batch requests of the GCS. The requests made
+/// while a previous flush is still waiting to run on the io service are sent together,
+/// so starting many actors at once takes a few requests instead of two per actor. A
+/// request made while the io service is idle is sent right away.
 class DefaultActorCreator : public ActorCreatorInterface {
  public:
-  explicit DefaultActorCreator(std::shared_ptr<gcs::GcsClient> gcs_client)
-      : gcs_client_(std::move(gcs_client)) {}
-
-  Status RegisterActor(const TaskSpecification &task_spec) override {
-    auto promise = std::make_shared<std::promise<void>>();
-    auto status = gcs_client_->Actors().AsyncRegisterActor(
-        task_spec, [promise](const Status &status) { promise->set_value(); });
-    if (status.ok() && promise->get_future().wait_for(std::chrono::seconds(
-                           RayConfig::instance().gcs_server_request_timeout_seconds())) !=
-                           std::future_status::ready) {
-      std::ostringstream stream;
-      stream << "There was timeout in registering an actor. It is probably "
-                "because GCS server is dead or there's a high load there.";
-      return Status::TimedOut(stream.str());
-    }
-    return status;
-  }
-
+  DefaultActorCreator(
+      std::shared_ptr<gcs::GcsClient> gcs_client, boost::asio::io_service &io_service,
+      uint32_t max_actors_per_batch =
+          RayConfig::instance().max_actors_per_creation_batch())
+      : gcs_client_(std::move(gcs_client)),
+        io_service_(io_service),
+        max_actors_per_batch_(max_actors_per_batch) {}
+
+  Status RegisterActor(const TaskSpecification &task_spec) override;
+
+  /// Note that the GCS replies to a batch of creations once every actor of the batch
+  /// is created, so an actor that is slow to start delays the callbacks of the actors
+  /// created along with it.
   Status AsyncCreateActor(const TaskSpecification &task_spec,
-                          const gcs::StatusCallback &callback) override {
-    return gcs_client_->Actors().AsyncCreateActor(task_spec, callback);
-  }
+                          const gcs::StatusCallback &callback) override;
 
  private:
+  using BatchFn = std::function<Status(const std::vector<TaskSpecification> &,
+                                       const gcs::MultiItemCallback<Status> &)>;
+
+  /// The requests that wait for the next flush.
+  struct RequestQueue {
+    std::vector<TaskSpecification> task_specs;
+    std::vector<gcs::StatusCallback> callbacks;
+    /// Whether a flush of the queue is posted to the io service.
+    bool flush_posted = false;
+  };
+
+  /// Queue a request, and post a flush of the queue unless one is already posted.
+  void QueueRequest(RequestQueue &queue, const TaskSpecification &task_spec,
+                    const gcs::StatusCallback &callback, const BatchFn &send_batch)
+      LOCKS_EXCLUDED(mu_);
+
+  /// Send the queued requests in batches of at most `max_actors_per_batch_` actors.
+  void FlushRequests(RequestQueue &queue, const BatchFn &send_batch)
+      LOCKS_EXCLUDED(mu_);
+
   std::shared_ptr<gcs::GcsClient> gcs_client_;
+  boost::asio::io_service &io_service_;
+  const uint32_t max_actors_per_batch_;
+  absl::Mutex mu_;
+  RequestQueue registrations_ GUARDED_BY(mu_);
+  RequestQueue creations_ GUARDED_BY(mu_);
 };
 
 /// Class to manage lifetimes of actors that we create (actor children).
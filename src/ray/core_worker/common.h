@@ -86,7 +86,8 @@ struct ActorCreationOptions {
       BundleID placement_options = std::make_pair(PlacementGroupID::Nil(), -1),
       bool placement_group_capture_child_tasks = true,
       const std::unordered_map<std::string, std::string> &override_environment_variables =
-          {})
+          {},
+      bool allow_out_of_order_execution = false)
       : max_restarts(max_restarts),
         max_task_retries(max_task_retries),
         max_concurrency(max_concurrency),
@@ -98,7 +99,8 @@ struct ActorCreationOptions {
         is_asyncio(is_asyncio),
         placement_options(placement_options),
         placement_group_capture_child_tasks(placement_group_capture_child_tasks),
-        override_environment_variables(override_environment_variables){};
+        override_environment_variables(override_environment_variables),
+        allow_out_of_order_execution(allow_out_of_order_execution){};
 
   /// Maximum number of times that the actor should be restarted if it dies
   /// unexpectedly. A value of -1 indicates infinite restarts. If it's 0, the
@@ -137,6 +139,10 @@ struct ActorCreationOptions {
   /// value.  Can override existing environment variables and introduce new ones.
   /// Propagated to child actors and/or tasks.
   const std::unordered_map<std::string, std::string> override_environment_variables;
+  /// Whether the actor may execute tasks as soon as their dependencies are ready,
+  /// instead of in the order in which each caller submitted them. This is meant for
+  /// actors whose methods commute, such as stateless serving replicas.
+  const bool allow_out_of_order_execution = false;
 };
 
 using PlacementStrategy = rpc::PlacementStrategy;
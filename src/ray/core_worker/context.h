@@ -71,6 +71,9 @@ class WorkerContext {
 
   bool CurrentActorIsAsync() const;
 
+  /// Returns whether the current actor may execute tasks out of submission order.
+  bool CurrentActorAllowsOutOfOrderExecution() const;
+
   bool CurrentActorDetached() const;
 
   int GetNextTaskIndex();
@@ -82,6 +85,7 @@ class WorkerContext {
   // allow unit test to set.
   bool current_actor_is_direct_call_ = false;
   bool current_task_is_direct_call_ = false;
+  bool current_actor_allows_out_of_order_execution_ = false;
 
  private:
   const WorkerType worker_type_;
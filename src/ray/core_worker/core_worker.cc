@@ -30,6 +30,10 @@ namespace {
 // Duration between internal book-keeping heartbeats.
 const int kInternalHeartbeatMillis = 1000;
 
+// The maximum number of task spec templates kept by a worker. Applications that submit
+// many distinct functions or resource shapes start over from an empty set of templates.
+const size_t kMaxTaskSpecTemplates = 1000;
+
 void BuildCommonTaskSpec(
     ray::TaskSpecBuilder &builder, const JobID &job_id, const TaskID &task_id,
     const std::string name, const TaskID &current_task_id, const int task_index,
@@ -388,6 +392,19 @@ CoreWorker::CoreWorker(const CoreWorkerOptions &options, const WorkerID &worker_
         return std::shared_ptr<rpc::CoreWorkerClient>(
             new rpc::CoreWorkerClient(addr, *client_call_manager_));
       });
+  object_location_publisher_ = std::make_unique<ObjectLocationPublisher>(
+      io_service_,
+      [this](const ObjectID &object_id, int64_t *object_size) {
+        return reference_counter_->GetObjectLocations(object_id, object_size);
+      },
+      RayConfig::instance().max_object_location_updates_per_reply());
+  // Tell the subscribed nodes when an owned object goes out of scope. The reference
+  // counter calls this under its lock and on any thread, so post to the event loop.
+  reference_counter_->SetOwnedReferenceDeletedCallback([this](const ObjectID &object_id) {
+    io_service_.post([this, object_id]() {
+      object_location_publisher_->MarkLocationsChanged(object_id);
+    });
+  });
 
   if (options_.worker_type == ray::WorkerType::WORKER) {
     death_check_timer_.expires_from_now(boost::asio::chrono::milliseconds(
@@ -483,7 +500,7 @@ CoreWorker::CoreWorker(const CoreWorkerOptions &options, const WorkerID &worker_
   };
 
   std::shared_ptr<ActorCreatorInterface> actor_creator =
-      std::make_shared<DefaultActorCreator>(gcs_client_);
+      std::make_shared<DefaultActorCreator>(gcs_client_, io_service_);
 
   direct_actor_submitter_ = std::shared_ptr<CoreWorkerDirectActorTaskSubmitter>(
       new CoreWorkerDirectActorTaskSubmitter(core_worker_client_pool_, memory_store_,
@@ -513,6 +530,8 @@ CoreWorker::CoreWorker(const CoreWorkerOptions &options, const WorkerID &worker_
           local_raylet_id, RayConfig::instance().worker_lease_timeout_milliseconds(),
           std::move(actor_creator),
           RayConfig::instance().max_tasks_in_flight_per_worker(),
+          boost::asio::steady_timer(io_service_),
+          RayConfig::instance().max_tasks_per_push_batch(),
           boost::asio::steady_timer(io_service_)));
   future_resolver_.reset(
       new FutureResolver(memory_store_, core_worker_client_pool_, rpc_address_));
@@ -656,6 +675,8 @@ void CoreWorker::RunIOService() {
 void CoreWorker::OnNodeRemoved(const rpc::GcsNodeInfo &node_info) {
   const auto node_id = NodeID::FromBinary(node_info.node_id());
   RAY_LOG(INFO) << "Node failure " << node_id;
+  object_location_publisher_->RemoveSubscriber(node_id);
+  reference_counter_->DropOwnerChannelsOnRemovedNode(node_id);
   const auto lost_objects = reference_counter_->ResetObjectsOnRemovedNode(node_id);
   // Delete the objects from the in-memory store to indicate that they are not
   // available. The object recovery manager will guarantee that a new value
@@ -1328,7 +1349,6 @@ void CoreWorker::SubmitTask(const RayFunction &function,
                             BundleID placement_options,
                             bool placement_group_capture_child_tasks,
                             const std::string &debugger_breakpoint) {
-  TaskSpecBuilder builder;
   const int next_task_index = worker_context_.GetNextTaskIndex();
   const auto task_id =
       TaskID::ForNormalTask(worker_context_.GetCurrentJobID(),
@@ -1336,6 +1356,10 @@ void CoreWorker::SubmitTask(const RayFunction &function,
   auto constrained_resources = AddPlacementGroupConstraint(
       task_options.resources, placement_options.first, placement_options.second);
   const std::unordered_map<std::string, double> required_resources;
+  // The function descriptor, resources and caller address are copied from a template,
+  // and the resources and scheduling class are computed once per template.
+  TaskSpecBuilder builder(
+      GetTaskSpecTemplate(function, constrained_resources, required_resources));
   auto task_name = task_options.name.empty()
                        ? function.GetFunctionDescriptor()->DefaultTaskName()
                        : task_options.name;
@@ -1366,6 +1390,32 @@ void CoreWorker::SubmitTask(const RayFunction &function,
   }
 }
 
+std::shared_ptr<const TaskSpecTemplate> CoreWorker::GetTaskSpecTemplate(
+    const RayFunction &function,
+    const std::unordered_map<std::string, double> &required_resources,
+    const std::unordered_map<std::string, double> &required_placement_resources) {
+  const auto language = function.GetLanguage();
+  const auto &function_descriptor = function.GetFunctionDescriptor();
+  const size_t hash = TaskSpecTemplate::Hash(language, function_descriptor,
+                                             required_resources,
+                                             required_placement_resources);
+  absl::MutexLock lock(&task_spec_templates_mutex_);
+  auto it = task_spec_templates_.find(hash);
+  if (it != task_spec_templates_.end() &&
+      it->second->Matches(language, function_descriptor, required_resources,
+                          required_placement_resources)) {
+    return it->second;
+  }
+  if (task_spec_templates_.size() >= kMaxTaskSpecTemplates) {
+    task_spec_templates_.clear();
+  }
+  auto task_template = std::make_shared<const TaskSpecTemplate>(
+      language, function_descriptor, rpc_address_, required_resources,
+      required_placement_resources);
+  task_spec_templates_[hash] = task_template;
+  return task_template;
+}
+
 Status CoreWorker::CreateActor(const RayFunction &function,
                                const std::vector<std::unique_ptr<TaskArg>> &args,
                                const ActorCreationOptions &actor_creation_options,
@@ -1416,7 +1466,8 @@ Status CoreWorker::CreateActor(const RayFunction &function,
                                    actor_creation_options.dynamic_worker_options,
                                    actor_creation_options.max_concurrency,
                                    actor_creation_options.is_detached, actor_name,
-                                   actor_creation_options.is_asyncio, extension_data);
+                                   actor_creation_options.is_asyncio, extension_data,
+                                   actor_creation_options.allow_out_of_order_execution);
 
   // Add the actor handle before we submit the actor creation task, since the
   // actor handle must be in scope by the time the GCS sends the
@@ -1424,7 +1475,10 @@ Status CoreWorker::CreateActor(const RayFunction &function,
   std::unique_ptr<ActorHandle> actor_handle(new ActorHandle(
       actor_id, GetCallerId(), rpc_address_, job_id, /*actor_cursor=*/return_ids[0],
       function.GetLanguage(), function.GetFunctionDescriptor(), extension_data,
-      actor_creation_options.max_task_retries));
+      actor_creation_options.max_task_retries,
+      actor_creation_options.allow_out_of_order_execution,
+      /*executes_tasks_concurrently=*/actor_creation_options.max_concurrency > 1 ||
+          actor_creation_options.is_asyncio));
   RAY_CHECK(actor_manager_->AddNewActorHandle(std::move(actor_handle), GetCallerId(),
                                               CurrentCallSite(), rpc_address_,
                                               actor_creation_options.is_detached))
@@ -1962,23 +2016,12 @@ Status CoreWorker::GetAndPinArgsForExecutor(const TaskSpecification &task,
                                             task.ArgRef(i).owner_address());
       borrowed_ids->push_back(arg_id);
     } else {
-      // A pass-by-value argument.
-      std::shared_ptr<LocalMemoryBuffer> data = nullptr;
-      if (task.ArgDataSize(i)) {
-        data = std::make_shared<LocalMemoryBuffer>(const_cast<uint8_t *>(task.ArgData(i)),
-                                                   task.ArgDataSize(i));
-      }
-      std::shared_ptr<LocalMemoryBuffer> metadata = nullptr;
-      if (task.ArgMetadataSize(i)) {
-        metadata = std::make_shared<LocalMemoryBuffer>(
-            const_cast<uint8_t *>(task.ArgMetadata(i)), task.ArgMetadataSize(i));
-      }
-      // NOTE: this is a workaround to avoid an extra copy for Java workers.
-      // Python workers need this copy to pass test case
-      // test_inline_arg_memory_corruption.
-      bool copy_data = options_.language == Language::PYTHON;
-      args->at(i) =
-          std::make_shared<RayObject>(data, metadata, task.ArgInlinedIds(i), copy_data);
+      // A pass-by-value argument. Unless Python data must be copied for alignment,
+      // its read-only buffers point into the task spec and keep it alive, so the
+      // value stays valid even if the language frontend holds on to it after the
+      // task finishes.
+      args->at(i) = std::make_shared<RayObject>(
+          task.ArgDataBuffer(i), task.ArgMetadataBuffer(i), task.ArgInlinedIds(i));
       arg_reference_ids->at(i) = ObjectID::Nil();
       // The task borrows all ObjectIDs that were serialized in the inlined
       // arguments. The task will receive references to these IDs, so it is
@@ -2028,7 +2071,9 @@ void CoreWorker::HandlePushTask(const rpc::PushTaskRequest &request,
   // For actor tasks, we just need to post a HandleActorTask instance to the task
   // execution service.
   if (request.task_spec().type() == TaskType::ACTOR_TASK) {
-    task_execution_service_.post([=] {
+    // The request is only released once the reply is sent, so capture it by
+    // reference instead of copying it with all of its inlined arguments.
+    task_execution_service_.post([this, &request, reply, send_reply_callback] {
       // We have posted an exit task onto the main event loop,
       // so shouldn't bother executing any further work.
       if (exiting_) return;
@@ -2047,6 +2092,48 @@ void CoreWorker::HandlePushTask(const rpc::PushTaskRequest &request,
   }
 }
 
+void CoreWorker::HandlePushTasks(const rpc::PushTasksRequest &request,
+                                 rpc::PushTasksReply *reply,
+                                 rpc::SendReplyCallback send_reply_callback) {
+  if (HandleWrongRecipient(WorkerID::FromBinary(request.intended_worker_id()),
+                           send_reply_callback)) {
+    return;
+  }
+
+  task_queue_length_ += request.requests_size();
+  // The tasks of a rejected batch and the cancelled tasks of a batch never execute, so
+  // they leave the queue when the batch is replied to.
+  auto batch_reply_callback = [this, &request, reply, send_reply_callback](
+                                  Status status, std::function<void()> success,
+                                  std::function<void()> failure) {
+    if (!status.ok()) {
+      task_queue_length_ -= request.requests_size();
+    } else {
+      for (bool cancelled : reply->task_cancelled()) {
+        task_queue_length_ -= cancelled ? 1 : 0;
+      }
+    }
+    send_reply_callback(status, success, failure);
+  };
+  if (request.requests_size() > 0 &&
+      request.requests(0).task_spec().type() == TaskType::ACTOR_TASK) {
+    // A batch of actor tasks is handled on the task execution service, like a single
+    // actor task. The request stays alive until the reply is sent.
+    task_execution_service_.post([this, &request, reply, batch_reply_callback] {
+      if (exiting_) return;
+      direct_task_receiver_->HandleTasks(request, reply, batch_reply_callback);
+    });
+    return;
+  }
+  // A batch of normal tasks is enqueued here, and the tasks then run from the task
+  // execution service in order.
+  direct_task_receiver_->HandleTasks(request, reply, batch_reply_callback);
+  task_execution_service_.post([=] {
+    if (exiting_) return;
+    direct_task_receiver_->RunNormalTasksFromQueue();
+  });
+}
+
 void CoreWorker::HandleDirectActorCallArgWaitComplete(
     const rpc::DirectActorCallArgWaitCompleteRequest &request,
     rpc::DirectActorCallArgWaitCompleteReply *reply,
@@ -2168,6 +2255,9 @@ void CoreWorker::HandleAddObjectLocationOwner(
   auto object_id = ObjectID::FromBinary(request.object_id());
   auto reference_exists = reference_counter_->AddObjectLocation(
       object_id, NodeID::FromBinary(request.node_id()));
+  // Notify the subscribers even if the reference is gone, so that they stop waiting
+  // for the object.
+  object_location_publisher_->MarkLocationsChanged(object_id);
   Status status =
       reference_exists
           ? Status::OK()
@@ -2186,6 +2276,7 @@ void CoreWorker::HandleRemoveObjectLocationOwner(
   auto object_id = ObjectID::FromBinary(request.object_id());
   auto reference_exists = reference_counter_->RemoveObjectLocation(
       object_id, NodeID::FromBinary(request.node_id()));
+  object_location_publisher_->MarkLocationsChanged(object_id);
   Status status =
       reference_exists
           ? Status::OK()
@@ -2202,13 +2293,17 @@ void CoreWorker::HandleGetObjectLocationsOwner(
     return;
   }
   auto object_id = ObjectID::FromBinary(request.object_id());
+  int64_t object_size = -1;
   absl::optional<absl::flat_hash_set<NodeID>> node_ids =
-      reference_counter_->GetObjectLocations(object_id);
+      reference_counter_->GetObjectLocations(object_id, &object_size);
   Status status;
   if (node_ids.has_value()) {
     for (const auto &node_id : node_ids.value()) {
       reply->add_node_ids(node_id.Binary());
     }
+    if (object_size > 0) {
+      reply->set_object_size(object_size);
+    }
     status = Status::OK();
   } else {
     status = Status::ObjectNotFound("Object " + object_id.Hex() + " not found");
@@ -2216,23 +2311,28 @@ void CoreWorker::HandleGetObjectLocationsOwner(
   send_reply_callback(status, nullptr, nullptr);
 }
 
-void CoreWorker::HandleWaitForRefRemoved(const rpc::WaitForRefRemovedRequest &request,
-                                         rpc::WaitForRefRemovedReply *reply,
-                                         rpc::SendReplyCallback send_reply_callback) {
+void CoreWorker::HandleGetObjectLocationsUpdates(
+    const rpc::GetObjectLocationsUpdatesRequest &request,
+    rpc::GetObjectLocationsUpdatesReply *reply,
+    rpc::SendReplyCallback send_reply_callback) {
   if (HandleWrongRecipient(WorkerID::FromBinary(request.intended_worker_id()),
                            send_reply_callback)) {
     return;
   }
-  const ObjectID &object_id = ObjectID::FromBinary(request.reference().object_id());
-  ObjectID contained_in_id = ObjectID::FromBinary(request.contained_in_id());
-  const auto owner_address = request.reference().owner_address();
-  auto ref_removed_callback =
-      boost::bind(&ReferenceCounter::HandleRefRemoved, reference_counter_, object_id,
-                  reply, send_reply_callback);
-  // Set a callback to send the reply when the requested object ID's ref count
-  // goes to 0.
-  reference_counter_->SetRefRemovedCallback(object_id, contained_in_id, owner_address,
-                                            ref_removed_callback);
+  object_location_publisher_->HandleGetObjectLocationsUpdates(request, reply,
+                                                              send_reply_callback);
+}
+
+void CoreWorker::HandleWaitForRefsRemoved(const rpc::WaitForRefsRemovedRequest &request,
+                                          rpc::WaitForRefsRemovedReply *reply,
+                                          rpc::SendReplyCallback send_reply_callback) {
+  if (HandleWrongRecipient(WorkerID::FromBinary(request.intended_worker_id()),
+                           send_reply_callback)) {
+    return;
+  }
+  // Subscribe to the requested objects. The reply is sent once we stop
+  // borrowing any of the objects that the owner subscribed to.
+  reference_counter_->HandleWaitForRefsRemoved(request, reply, send_reply_callback);
 }
 
 void CoreWorker::HandleRemoteCancelTask(const rpc::RemoteCancelTaskRequest &request,
@@ -2330,7 +2430,13 @@ void CoreWorker::HandleGetCoreWorkerStats(const rpc::GetCoreWorkerStatsRequest &
   stats->set_num_pending_tasks(task_manager_->NumSubmissibleTasks());
   stats->set_task_queue_length(task_queue_length_);
   stats->set_num_executed_tasks(num_executed_tasks_);
-  stats->set_num_object_refs_in_scope(reference_counter_->NumObjectIDsInScope());
+  const size_t num_object_refs = reference_counter_->NumObjectIDsInScope();
+  const size_t object_refs_memory_bytes = reference_counter_->EstimateMemoryUsage();
+  stats->set_num_object_refs_in_scope(num_object_refs);
+  stats->set_object_refs_memory_bytes(object_refs_memory_bytes);
+  if (num_object_refs > 0) {
+    stats->set_memory_bytes_per_object_ref(object_refs_memory_bytes / num_object_refs);
+  }
   stats->set_current_task_name(current_task_.GetName());
   stats->set_current_task_func_desc(current_task_.FunctionDescriptor()->ToString());
   stats->set_ip_address(rpc_address_.ip_address());
@@ -2360,6 +2466,8 @@ void CoreWorker::HandleGetCoreWorkerStats(const rpc::GetCoreWorkerStatsRequest &
   stats->set_num_in_plasma(memory_store_stats.num_in_plasma);
   stats->set_num_local_objects(memory_store_stats.num_local_objects);
   stats->set_used_object_store_memory(memory_store_stats.used_object_store_memory);
+  stats->set_memory_store_max_bytes(memory_store_stats.max_memory);
+  stats->set_num_objects_evicted_to_plasma(memory_store_stats.num_evicted_to_plasma);
 
   if (request.include_memory_info()) {
     reference_counter_->AddObjectRefStats(plasma_store_provider_->UsedObjectsList(),
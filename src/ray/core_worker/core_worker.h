@@ -18,12 +18,14 @@
 #include "absl/container/flat_hash_map.h"
 #include "ray/common/buffer.h"
 #include "ray/common/placement_group.h"
+#include "ray/common/task/task_util.h"
 #include "ray/core_worker/actor_handle.h"
 #include "ray/core_worker/actor_manager.h"
 #include "ray/core_worker/common.h"
 #include "ray/core_worker/context.h"
 #include "ray/core_worker/future_resolver.h"
 #include "ray/core_worker/lease_policy.h"
+#include "ray/core_worker/object_location_publisher.h"
 #include "ray/core_worker/object_recovery_manager.h"
 #include "ray/core_worker/profiling.h"
 #include "ray/core_worker/reference_count.h"
@@ -819,6 +821,10 @@ class CoreWorker : public rpc::CoreWorkerServiceHandler {
   void HandlePushTask(const rpc::PushTaskRequest &request, rpc::PushTaskReply *reply,
                       rpc::SendReplyCallback send_reply_callback) override;
 
+  /// Implements gRPC server handler.
+  void HandlePushTasks(const rpc::PushTasksRequest &request, rpc::PushTasksReply *reply,
+                       rpc::SendReplyCallback send_reply_callback) override;
+
   /// Implements gRPC server handler.
   void HandleDirectActorCallArgWaitComplete(
       const rpc::DirectActorCallArgWaitCompleteRequest &request,
@@ -841,9 +847,9 @@ class CoreWorker : public rpc::CoreWorkerServiceHandler {
                                    rpc::SendReplyCallback send_reply_callback) override;
 
   /// Implements gRPC server handler.
-  void HandleWaitForRefRemoved(const rpc::WaitForRefRemovedRequest &request,
-                               rpc::WaitForRefRemovedReply *reply,
-                               rpc::SendReplyCallback send_reply_callback) override;
+  void HandleWaitForRefsRemoved(const rpc::WaitForRefsRemovedRequest &request,
+                                rpc::WaitForRefsRemovedReply *reply,
+                                rpc::SendReplyCallback send_reply_callback) override;
 
   /// Implements gRPC server handler.
   void HandleAddObjectLocationOwner(const rpc::AddObjectLocationOwnerRequest &request,
@@ -861,6 +867,12 @@ class CoreWorker : public rpc::CoreWorkerServiceHandler {
                                      rpc::GetObjectLocationsOwnerReply *reply,
                                      rpc::SendReplyCallback send_reply_callback) override;
 
+  /// Implements gRPC server handler.
+  void HandleGetObjectLocationsUpdates(
+      const rpc::GetObjectLocationsUpdatesRequest &request,
+      rpc::GetObjectLocationsUpdatesReply *reply,
+      rpc::SendReplyCallback send_reply_callback) override;
+
   /// Implements gRPC server handler.
   void HandleKillActor(const rpc::KillActorRequest &request, rpc::KillActorReply *reply,
                        rpc::SendReplyCallback send_reply_callback) override;
@@ -969,6 +981,19 @@ class CoreWorker : public rpc::CoreWorkerServiceHandler {
   /// \param[in] force_kill Whether to force kill a task by killing the worker.
   Status CancelChildren(const TaskID &task_id, bool force_kill);
 
+  /// Get the template of the task specs of a normal task, or create it if this is the
+  /// first submission of the function with these resources.
+  ///
+  /// \param[in] function The remote function.
+  /// \param[in] required_resources The resources required by the task.
+  /// \param[in] required_placement_resources The resources required to place the task.
+  /// \return The template.
+  std::shared_ptr<const TaskSpecTemplate> GetTaskSpecTemplate(
+      const RayFunction &function,
+      const std::unordered_map<std::string, double> &required_resources,
+      const std::unordered_map<std::string, double> &required_placement_resources)
+      LOCKS_EXCLUDED(task_spec_templates_mutex_);
+
   ///
   /// Private methods related to task execution. Should not be used by driver processes.
   ///
@@ -1134,6 +1159,9 @@ class CoreWorker : public rpc::CoreWorkerServiceHandler {
   // Keeps track of object ID reference counts.
   std::shared_ptr<ReferenceCounter> reference_counter_;
 
+  /// Pushes the location changes of owned objects to the subscribed nodes.
+  std::unique_ptr<ObjectLocationPublisher> object_location_publisher_;
+
   ///
   /// Fields related to storing and retrieving objects.
   ///
@@ -1223,6 +1251,14 @@ class CoreWorker : public rpc::CoreWorkerServiceHandler {
   // Queue of tasks to resubmit when the specified time passes.
   std::deque<std::pair<int64_t, TaskSpecification>> to_resubmit_ GUARDED_BY(mutex_);
 
+  // Guard for `task_spec_templates_` map.
+  absl::Mutex task_spec_templates_mutex_;
+
+  /// Templates of the task specs of the normal tasks submitted by this worker, keyed by
+  /// `TaskSpecTemplate::Hash`. A template is replaced by another one with the same hash.
+  absl::flat_hash_map<size_t, std::shared_ptr<const TaskSpecTemplate>>
+      task_spec_templates_ GUARDED_BY(task_spec_templates_mutex_);
+
   /// Map of named actor registry. It doesn't need to hold a lock because
   /// local mode is single-threaded.
   absl::flat_hash_map<std::string, ActorID> local_mode_named_actor_registry_;
@@ -17,7 +17,13 @@
 namespace ray {
 
 rpc::Address LocalityAwareLeasePolicy::GetBestNodeForTask(const TaskSpecification &spec) {
-  if (auto node_id = GetBestNodeIdForTask(spec)) {
+  ObjectBytesByNode local_object_bytes;
+  return GetBestNodeForTask(spec, &local_object_bytes);
+}
+
+rpc::Address LocalityAwareLeasePolicy::GetBestNodeForTask(
+    const TaskSpecification &spec, ObjectBytesByNode *local_object_bytes) {
+  if (auto node_id = GetBestNodeIdForTask(spec, local_object_bytes)) {
     if (auto addr = node_addr_factory_(node_id.value())) {
       return addr.value();
     }
@@ -27,10 +33,10 @@ rpc::Address LocalityAwareLeasePolicy::GetBestNodeForTask(const TaskSpecificatio
 
 /// Criteria for "best" node: The node with the most object bytes (from object_ids) local.
 absl::optional<NodeID> LocalityAwareLeasePolicy::GetBestNodeIdForTask(
-    const TaskSpecification &spec) {
+    const TaskSpecification &spec, ObjectBytesByNode *local_object_bytes) {
   const auto object_ids = spec.GetDependencyIds();
   // Number of object bytes (from object_ids) that a given node has local.
-  absl::flat_hash_map<NodeID, uint64_t> bytes_local_table;
+  auto &bytes_local_table = *local_object_bytes;
   uint64_t max_bytes = 0;
   absl::optional<NodeID> max_bytes_node;
   // Finds the node with the maximum number of object bytes local.
@@ -36,12 +36,27 @@ class LocalityDataProviderInterface {
   virtual ~LocalityDataProviderInterface() {}
 };
 
+/// The number of bytes of a task's arguments that each node has local.
+typedef absl::flat_hash_map<NodeID, uint64_t> ObjectBytesByNode;
+
 /// Interface for mocking the lease policy.
 class LeasePolicyInterface {
  public:
   /// Get the address of the best worker node for a lease request for the provided task.
   virtual rpc::Address GetBestNodeForTask(const TaskSpecification &spec) = 0;
 
+  /// Get the address of the best worker node for a lease request for the provided task,
+  /// along with the locality that the choice was based on. The locality is sent with
+  /// the lease request, so that the raylet can take it into account on spillback.
+  ///
+  /// \param spec The task.
+  /// \param[out] local_object_bytes The number of bytes of the task's arguments that
+  /// each node has local. Left empty if the policy does not use locality.
+  virtual rpc::Address GetBestNodeForTask(const TaskSpecification &spec,
+                                          ObjectBytesByNode *local_object_bytes) {
+    return GetBestNodeForTask(spec);
+  }
+
   virtual ~LeasePolicyInterface() {}
 };
 
@@ -64,9 +79,13 @@ class LocalityAwareLeasePolicy : public LeasePolicyInterface {
   /// Get the address of the best worker node for a lease request for the provided task.
   rpc::Address GetBestNodeForTask(const TaskSpecification &spec);
 
+  rpc::Address GetBestNodeForTask(const TaskSpecification &spec,
+                                  ObjectBytesByNode *local_object_bytes);
+
  private:
   /// Get the best worker node for a lease request for the provided task.
-  absl::optional<NodeID> GetBestNodeIdForTask(const TaskSpecification &spec);
+  absl::optional<NodeID> GetBestNodeIdForTask(const TaskSpecification &spec,
+                                              ObjectBytesByNode *local_object_bytes);
 
   /// Provider of locality data that will be used in choosing the best lessor.
   std::shared_ptr<LocalityDataProviderInterface> locality_data_provider_;
@@ -0,0 +1,162 @@
+// Copyright 2017 The Ray Authors.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//  http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "ray/core_worker/object_location_publisher.h"
+
+#include "ray/util/logging.h"
+
+namespace ray {
+
+ObjectLocationPublisher::ObjectLocationPublisher(boost::asio::io_service &io_service,
+                                                 ObjectLocationsGetter get_locations,
+                                                 int64_t max_updates_per_reply)
+    : io_service_(io_service),
+      get_locations_(std::move(get_locations)),
+      max_updates_per_reply_(max_updates_per_reply) {
+  RAY_CHECK(max_updates_per_reply_ > 0);
+}
+
+void ObjectLocationPublisher::HandleGetObjectLocationsUpdates(
+    const rpc::GetObjectLocationsUpdatesRequest &request,
+    rpc::GetObjectLocationsUpdatesReply *reply,
+    rpc::SendReplyCallback send_reply_callback) {
+  const auto node_id = NodeID::FromBinary(request.subscriber_node_id());
+  auto &subscriber = subscribers_[node_id];
+  if (subscriber.send_reply_callback) {
+    // The node sent a new poll to change its subscriptions. Release the old one
+    // without updates, so that the updates can't arrive out of order.
+    auto send_previous_reply = std::move(subscriber.send_reply_callback);
+    subscriber.send_reply_callback = nullptr;
+    subscriber.reply = nullptr;
+    send_previous_reply(Status::OK(), nullptr, nullptr);
+  }
+
+  for (const auto &object_id_binary : request.unsubscribe_object_ids()) {
+    Unsubscribe(node_id, &subscriber, ObjectID::FromBinary(object_id_binary));
+  }
+  for (const auto &object_id_binary : request.subscribe_object_ids()) {
+    const auto object_id = ObjectID::FromBinary(object_id_binary);
+    if (subscriber.object_ids.insert(object_id).second) {
+      object_subscribers_[object_id].insert(node_id);
+      // Send the current locations of new subscriptions.
+      subscriber.changed_object_ids.insert(object_id);
+    }
+  }
+
+  subscriber.reply = reply;
+  subscriber.send_reply_callback = std::move(send_reply_callback);
+  if (!subscriber.changed_object_ids.empty() || subscriber.object_ids.empty()) {
+    SendReply(node_id, &subscriber);
+  }
+}
+
+void ObjectLocationPublisher::MarkLocationsChanged(const ObjectID &object_id) {
+  auto it = object_subscribers_.find(object_id);
+  if (it == object_subscribers_.end()) {
+    return;
+  }
+  for (const auto &node_id : it->second) {
+    auto &subscriber = subscribers_[node_id];
+    subscriber.changed_object_ids.insert(object_id);
+    if (subscriber.send_reply_callback && !subscriber.flush_scheduled) {
+      subscriber.flush_scheduled = true;
+      io_service_.post([this, node_id]() { Flush(node_id); });
+    }
+  }
+}
+
+void ObjectLocationPublisher::RemoveSubscriber(const NodeID &node_id) {
+  auto it = subscribers_.find(node_id);
+  if (it == subscribers_.end()) {
+    return;
+  }
+  auto &subscriber = it->second;
+  for (const auto &object_id : subscriber.object_ids) {
+    auto object_it = object_subscribers_.find(object_id);
+    object_it->second.erase(node_id);
+    if (object_it->second.empty()) {
+      object_subscribers_.erase(object_it);
+    }
+  }
+  auto send_reply_callback = std::move(subscriber.send_reply_callback);
+  subscribers_.erase(it);
+  if (send_reply_callback) {
+    send_reply_callback(Status::OK(), nullptr, nullptr);
+  }
+}
+
+size_t ObjectLocationPublisher::NumSubscribers(const ObjectID &object_id) const {
+  auto it = object_subscribers_.find(object_id);
+  return it == object_subscribers_.end() ? 0 : it->second.size();
+}
+
+void ObjectLocationPublisher::Flush(const NodeID &node_id) {
+  auto it = subscribers_.find(node_id);
+  if (it == subscribers_.end()) {
+    return;
+  }
+  auto &subscriber = it->second;
+  subscriber.flush_scheduled = false;
+  if (subscriber.send_reply_callback && !subscriber.changed_object_ids.empty()) {
+    SendReply(node_id, &subscriber);
+  }
+}
+
+void ObjectLocationPublisher::SendReply(const NodeID &node_id, Subscriber *subscriber) {
+  auto &changed = subscriber->changed_object_ids;
+  for (int64_t i = 0; i < max_updates_per_reply_ && !changed.empty(); i++) {
+    const auto object_id = *changed.begin();
+    changed.erase(changed.begin());
+    auto update = subscriber->reply->add_updates();
+    update->set_object_id(object_id.Binary());
+    int64_t object_size = -1;
+    const auto node_ids = get_locations_(object_id, &object_size);
+    if (node_ids.has_value()) {
+      for (const auto &location : node_ids.value()) {
+        update->add_node_ids(location.Binary());
+      }
+      if (object_size > 0) {
+        update->set_object_size(object_size);
+      }
+    } else {
+      // The object is out of scope, so its locations won't change anymore.
+      update->set_object_not_found(true);
+      Unsubscribe(node_id, subscriber, object_id);
+    }
+  }
+
+  auto send_reply_callback = std::move(subscriber->send_reply_callback);
+  subscriber->send_reply_callback = nullptr;
+  subscriber->reply = nullptr;
+  if (subscriber->object_ids.empty()) {
+    // The node doesn't poll again until it subscribes to another object.
+    subscribers_.erase(node_id);
+  }
+  send_reply_callback(Status::OK(), nullptr, nullptr);
+}
+
+void ObjectLocationPublisher::Unsubscribe(const NodeID &node_id, Subscriber *subscriber,
+                                          const ObjectID &object_id) {
+  if (subscriber->object_ids.erase(object_id) == 0) {
+    return;
+  }
+  subscriber->changed_object_ids.erase(object_id);
+  auto it = object_subscribers_.find(object_id);
+  it->second.erase(node_id);
+  if (it->second.empty()) {
+    object_subscribers_.erase(it);
+  }
+}
+
+}  // namespace ray
@@ -0,0 +1,113 @@
+// Copyright 2017 The Ray Authors.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//  http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#pragma once
+
+#include <boost/asio.hpp>
+
+#include "absl/container/flat_hash_map.h"
+#include "absl/container/flat_hash_set.h"
+#include "absl/types/optional.h"
+#include "ray/common/id.h"
+#include "ray/rpc/server_call.h"
+#include "src/ray/protobuf/core_worker.pb.h"
+
+namespace ray {
+
+/// Get the locations of an object, or nullopt if the owner has no reference to it.
+/// Also sets the size of the object, or -1 if the size is unknown.
+using ObjectLocationsGetter = std::function<absl::optional<absl::flat_hash_set<NodeID>>(
+    const ObjectID &object_id, int64_t *object_size)>;
+
+/// \class ObjectLocationPublisher
+///
+/// Pushes the location changes of an owner's objects to the nodes that subscribed to
+/// them. Each node keeps a single GetObjectLocationsUpdates long poll to the owner,
+/// which carries the node's subscription changes. The owner holds the poll until the
+/// locations of a subscribed object change, and then replies with the current
+/// locations of all subscribed objects that changed since the last reply. Changes to
+/// the same object are coalesced, so the traffic is bounded by the rate of location
+/// changes rather than by the number of subscriptions.
+///
+/// This class is not thread-safe: all methods must be called on the event loop that
+/// was passed to the constructor.
+class ObjectLocationPublisher {
+ public:
+  /// Create a publisher.
+  ///
+  /// \param io_service The event loop that runs the RPC handlers.
+  /// \param get_locations Returns the current locations of an object.
+  /// \param max_updates_per_reply The maximum number of updates to send in one reply.
+  ObjectLocationPublisher(boost::asio::io_service &io_service,
+                          ObjectLocationsGetter get_locations,
+                          int64_t max_updates_per_reply);
+
+  /// Handle a long poll from a subscribed node. Any poll that the node had
+  /// outstanding is replied to right away with no updates.
+  void HandleGetObjectLocationsUpdates(
+      const rpc::GetObjectLocationsUpdatesRequest &request,
+      rpc::GetObjectLocationsUpdatesReply *reply,
+      rpc::SendReplyCallback send_reply_callback);
+
+  /// Record that the locations of an object changed, or that the owner's reference
+  /// to it went out of scope. Subscribers are replied to once the currently running
+  /// handler returns, so that several changes are sent together.
+  void MarkLocationsChanged(const ObjectID &object_id);
+
+  /// Drop all subscriptions of a node, e.g., because the node died.
+  void RemoveSubscriber(const NodeID &node_id);
+
+  /// The number of nodes that are subscribed to at least one object.
+  size_t NumSubscribers() const { return subscribers_.size(); }
+
+  /// The number of nodes that are subscribed to an object.
+  size_t NumSubscribers(const ObjectID &object_id) const;
+
+ private:
+  struct Subscriber {
+    /// The objects that the node is subscribed to.
+    absl::flat_hash_set<ObjectID> object_ids;
+    /// The subscribed objects whose locations haven't been sent since they changed.
+    absl::flat_hash_set<ObjectID> changed_object_ids;
+    /// The outstanding long poll, if any.
+    rpc::GetObjectLocationsUpdatesReply *reply = nullptr;
+    rpc::SendReplyCallback send_reply_callback;
+    /// Whether a call to Flush is queued on the event loop.
+    bool flush_scheduled = false;
+  };
+
+  /// Reply to the outstanding poll of a node if any of its objects changed.
+  void Flush(const NodeID &node_id);
+
+  /// Reply to the outstanding poll of a node with the changed locations.
+  void SendReply(const NodeID &node_id, Subscriber *subscriber);
+
+  /// Remove a subscription of a node, without replying to the node.
+  void Unsubscribe(const NodeID &node_id, Subscriber *subscriber,
+                   const ObjectID &object_id);
+
+  boost::asio::io_service &io_service_;
+
+  const ObjectLocationsGetter get_locations_;
+
+  const int64_t max_updates_per_reply_;
+
+  /// The subscribed nodes.
+  absl::flat_hash_map<NodeID, Subscriber> subscribers_;
+
+  /// The nodes subscribed to each object.
+  absl::flat_hash_map<ObjectID, absl::flat_hash_set<NodeID>> object_subscribers_;
+};
+
+}  // namespace ray
@@ -15,21 +15,29 @@
 #include "ray/core_worker/reference_count.h"
 
 #define PRINT_REF_COUNT(it)                                                              \
-  RAY_LOG(DEBUG) << "REF " << it->first << " borrowers: " << it->second.borrowers.size() \
+  RAY_LOG(DEBUG) << "REF " << it->first                                                 \
+                 << " borrowers: " << it->second.cold().borrowers.size()                 \
                  << " local_ref_count: " << it->second.local_ref_count                   \
                  << " submitted_count: " << it->second.submitted_task_ref_count          \
                  << " contained_in_owned: " << it->second.contained_in_owned.size()      \
                  << " contained_in_borrowed: "                                           \
-                 << (it->second.contained_in_borrowed_id.has_value()                     \
-                         ? *it->second.contained_in_borrowed_id                          \
-                         : ObjectID::Nil())                                              \
+                 << it->second.cold().contained_in_borrowed_id.value_or(ObjectID::Nil()) \
                  << " contains: " << it->second.contains.size()                          \
                  << " lineage_ref_count: " << it->second.lineage_ref_count;
 
-namespace {}  // namespace
+namespace {
+
+/// The bytes used by an interned owner address and its key.
+size_t OwnerAddressBytes(const std::string &worker_id, const ray::rpc::Address &address) {
+  return worker_id.capacity() + address.SpaceUsedLong();
+}
+
+}  // namespace
 
 namespace ray {
 
+const std::string ReferenceCounter::Reference::kUnknownCallSite = "<unknown>";
+
 void ReferenceCounter::DrainAndShutdown(std::function<void()> shutdown) {
   absl::MutexLock lock(&mutex_);
   if (object_id_refs_.empty()) {
@@ -91,16 +99,20 @@ bool ReferenceCounter::AddBorrowedObjectInternal(const ObjectID &object_id,
     return false;
   }
 
-  it->second.owner_address = owner_address;
+  it->second.owner_address = InternOwnerAddress(owner_address);
 
   if (!outer_id.IsNil()) {
     auto outer_it = object_id_refs_.find(outer_id);
     if (outer_it != object_id_refs_.end() && !outer_it->second.owned_by_us) {
       RAY_LOG(DEBUG) << "Setting borrowed inner ID " << object_id
                      << " contained_in_borrowed: " << outer_id;
-      RAY_CHECK(!it->second.contained_in_borrowed_id.has_value());
-      it->second.contained_in_borrowed_id = outer_id;
+      RAY_CHECK(!it->second.cold().contained_in_borrowed_id.has_value());
+      size_t heap_bytes = it->second.HeapBytes();
+      it->second.mutable_cold().contained_in_borrowed_id = outer_id;
+      UpdateHeapBytes(it->second, heap_bytes);
+      heap_bytes = outer_it->second.HeapBytes();
       outer_it->second.contains.insert(object_id);
+      UpdateHeapBytes(outer_it->second, heap_bytes);
     }
   }
   return true;
@@ -113,7 +125,7 @@ void ReferenceCounter::AddObjectRefStats(
   for (const auto &ref : object_id_refs_) {
     auto ref_proto = stats->add_object_refs();
     ref_proto->set_object_id(ref.first.Binary());
-    ref_proto->set_call_site(ref.second.call_site);
+    ref_proto->set_call_site(*ref.second.call_site);
     ref_proto->set_object_size(ref.second.object_size);
     ref_proto->set_local_ref_count(ref.second.local_ref_count);
     ref_proto->set_submitted_task_ref_count(ref.second.submitted_task_ref_count);
@@ -124,7 +136,7 @@ void ReferenceCounter::AddObjectRefStats(
       if (ref.second.object_size <= 0) {
         ref_proto->set_object_size(it->second.first);
       }
-      if (ref.second.call_site.empty()) {
+      if (ref.second.call_site->empty()) {
         ref_proto->set_call_site(it->second.second);
       }
     }
@@ -144,6 +156,55 @@ void ReferenceCounter::AddObjectRefStats(
   }
 }
 
+size_t ReferenceCounter::EstimateMemoryUsage() const {
+  absl::MutexLock lock(&mutex_);
+  return object_id_refs_.capacity() * (sizeof(ReferenceTable::value_type) + 1) +
+         references_heap_bytes_ + call_sites_bytes_ + owner_addresses_bytes_;
+}
+
+const std::string *ReferenceCounter::InternCallSite(const std::string &call_site) {
+  auto inserted = call_sites_.insert(call_site);
+  if (inserted.second) {
+    call_sites_bytes_ += sizeof(std::string) + inserted.first->capacity();
+  }
+  return &*inserted.first;
+}
+
+std::shared_ptr<const rpc::Address> ReferenceCounter::InternOwnerAddress(
+    const rpc::Address &address) {
+  auto it = owner_addresses_.find(address.worker_id());
+  if (it != owner_addresses_.end() && it->second->port() == address.port() &&
+      it->second->ip_address() == address.ip_address() &&
+      it->second->raylet_id() == address.raylet_id()) {
+    return it->second;
+  }
+  if (owner_addresses_.size() >= owner_addresses_gc_threshold_) {
+    // Drop the addresses that only the table still refers to.
+    for (auto entry = owner_addresses_.begin(); entry != owner_addresses_.end();) {
+      if (entry->second.use_count() == 1) {
+        owner_addresses_bytes_ -= OwnerAddressBytes(entry->first, *entry->second);
+        owner_addresses_.erase(entry++);
+      } else {
+        entry++;
+      }
+    }
+    owner_addresses_gc_threshold_ = std::max<size_t>(1024, 2 * owner_addresses_.size());
+  }
+  auto interned = std::make_shared<const rpc::Address>(address);
+  auto &entry = owner_addresses_[address.worker_id()];
+  if (entry) {
+    owner_addresses_bytes_ -= OwnerAddressBytes(address.worker_id(), *entry);
+  }
+  entry = interned;
+  owner_addresses_bytes_ += OwnerAddressBytes(address.worker_id(), *interned);
+  return interned;
+}
+
+void ReferenceCounter::UpdateHeapBytes(const Reference &ref, size_t heap_bytes_before) {
+  references_heap_bytes_ += ref.HeapBytes();
+  references_heap_bytes_ -= heap_bytes_before;
+}
+
 void ReferenceCounter::AddOwnedObject(const ObjectID &object_id,
                                       const std::vector<ObjectID> &inner_ids,
                                       const rpc::Address &owner_address,
@@ -157,8 +218,12 @@ void ReferenceCounter::AddOwnedObject(const ObjectID &object_id,
   // If the entry doesn't exist, we initialize the direct reference count to zero
   // because this corresponds to a submitted task whose return ObjectID will be created
   // in the frontend language, incrementing the reference count.
-  object_id_refs_.emplace(object_id, Reference(owner_address, call_site, object_size,
-                                               is_reconstructable, pinned_at_raylet_id));
+  auto it = object_id_refs_
+                .emplace(object_id, Reference(InternOwnerAddress(owner_address),
+                                              InternCallSite(call_site), object_size,
+                                              is_reconstructable, pinned_at_raylet_id))
+                .first;
+  UpdateHeapBytes(it->second, 0);
   if (!inner_ids.empty()) {
     // Mark that this object ID contains other inner IDs. Then, we will not GC
     // the inner objects until the outer object ID goes out of scope.
@@ -194,7 +259,8 @@ void ReferenceCounter::AddLocalReference(const ObjectID &object_id,
   auto it = object_id_refs_.find(object_id);
   if (it == object_id_refs_.end()) {
     // NOTE: ownership info for these objects must be added later via AddBorrowedObject.
-    it = object_id_refs_.emplace(object_id, Reference(call_site, -1)).first;
+    it = object_id_refs_.emplace(object_id, Reference(InternCallSite(call_site), -1))
+             .first;
   }
   it->second.local_ref_count++;
   RAY_LOG(DEBUG) << "Add local reference " << object_id;
@@ -275,6 +341,7 @@ void ReferenceCounter::UpdateFinishedTaskReferences(
   }
 
   RemoveSubmittedTaskReferences(argument_ids, release_lineage, deleted);
+  SendRefRemovedRequests();
 }
 
 void ReferenceCounter::ReleaseLineageReferences(
@@ -416,10 +483,11 @@ void ReferenceCounter::DeleteReferenceInternal(ReferenceTable::iterator it,
                                                std::vector<ObjectID> *deleted) {
   const ObjectID id = it->first;
   RAY_LOG(DEBUG) << "Attempting to delete object " << id;
-  if (it->second.RefCount() == 0 && it->second.on_ref_removed) {
+  if (it->second.RefCount() == 0 && it->second.cold().on_ref_removed) {
     RAY_LOG(DEBUG) << "Calling on_ref_removed for object " << id;
-    it->second.on_ref_removed(id);
-    it->second.on_ref_removed = nullptr;
+    auto &cold = it->second.mutable_cold();
+    cold.on_ref_removed(id);
+    cold.on_ref_removed = nullptr;
   }
   PRINT_REF_COUNT(it);
 
@@ -446,12 +514,14 @@ void ReferenceCounter::DeleteReferenceInternal(ReferenceTable::iterator it,
           // If this object ID was nested in an owned object, make sure that
           // the outer object counted towards the ref count for the inner
           // object.
+          const size_t heap_bytes = inner_it->second.HeapBytes();
           RAY_CHECK(inner_it->second.contained_in_owned.erase(id));
+          UpdateHeapBytes(inner_it->second, heap_bytes);
         } else {
           // If this object ID was nested in a borrowed object, make sure that
           // we have already returned this information through a previous
           // GetAndClearLocalBorrowers call.
-          RAY_CHECK(!inner_it->second.contained_in_borrowed_id.has_value())
+          RAY_CHECK(!inner_it->second.cold().contained_in_borrowed_id.has_value())
               << "Outer object " << id << ", inner object " << inner_id;
         }
         DeleteReferenceInternal(inner_it, deleted);
@@ -475,20 +545,28 @@ void ReferenceCounter::DeleteReferenceInternal(ReferenceTable::iterator it,
       on_lineage_released_(id, &ids_to_release);
       ReleaseLineageReferencesInternal(ids_to_release);
     }
+    if (on_owned_reference_deleted_ && it->second.owned_by_us) {
+      on_owned_reference_deleted_(id);
+    }
 
     freed_objects_.erase(id);
+    references_heap_bytes_ -= it->second.HeapBytes();
     object_id_refs_.erase(it);
     ShutdownIfNeeded();
   }
 }
 
 void ReferenceCounter::ReleasePlasmaObject(ReferenceTable::iterator it) {
-  if (it->second.on_delete) {
+  if (!it->second.cold_fields) {
+    return;
+  }
+  auto &cold = *it->second.cold_fields;
+  if (cold.on_delete) {
     RAY_LOG(DEBUG) << "Calling on_delete for object " << it->first;
-    it->second.on_delete(it->first);
-    it->second.on_delete = nullptr;
+    cold.on_delete(it->first);
+    cold.on_delete = nullptr;
   }
-  it->second.pinned_at_raylet_id.reset();
+  cold.pinned_at_raylet_id.reset();
 }
 
 bool ReferenceCounter::SetDeleteCallback(
@@ -517,7 +595,9 @@ bool ReferenceCounter::SetDeleteCallback(
   // will resend the registration request after GCS restarts.
   // 2.After GCS restarts, GCS will send `WaitForActorOutOfScope` request to owned actors
   // again.
-  it->second.on_delete = callback;
+  const size_t heap_bytes = it->second.HeapBytes();
+  it->second.mutable_cold().on_delete = callback;
+  UpdateHeapBytes(it->second, heap_bytes);
   return true;
 }
 
@@ -527,7 +607,7 @@ std::vector<ObjectID> ReferenceCounter::ResetObjectsOnRemovedNode(
   std::vector<ObjectID> lost_objects;
   for (auto it = object_id_refs_.begin(); it != object_id_refs_.end(); it++) {
     const auto &object_id = it->first;
-    if (it->second.pinned_at_raylet_id.value_or(NodeID::Nil()) == raylet_id) {
+    if (it->second.cold().pinned_at_raylet_id.value_or(NodeID::Nil()) == raylet_id) {
       lost_objects.push_back(object_id);
       ReleasePlasmaObject(it);
     }
@@ -547,11 +627,13 @@ void ReferenceCounter::UpdateObjectPinnedAtRaylet(const ObjectID &object_id,
 
     // The object is still in scope. Track the raylet location until the object
     // has gone out of scope or the raylet fails, whichever happens first.
-    RAY_CHECK(!it->second.pinned_at_raylet_id.has_value());
+    RAY_CHECK(!it->second.cold().pinned_at_raylet_id.has_value());
     // Only the owner tracks the location.
     RAY_CHECK(it->second.owned_by_us);
     if (!it->second.OutOfScope(lineage_pinning_enabled_)) {
-      it->second.pinned_at_raylet_id = raylet_id;
+      const size_t heap_bytes = it->second.HeapBytes();
+      it->second.mutable_cold().pinned_at_raylet_id = raylet_id;
+      UpdateHeapBytes(it->second, heap_bytes);
     }
   }
 }
@@ -565,7 +647,7 @@ bool ReferenceCounter::IsPlasmaObjectPinnedOrSpilled(const ObjectID &object_id,
     if (it->second.owned_by_us) {
       *owned_by_us = true;
       *spilled = it->second.spilled;
-      *pinned_at = it->second.pinned_at_raylet_id.value_or(NodeID::Nil());
+      *pinned_at = it->second.cold().pinned_at_raylet_id.value_or(NodeID::Nil());
     }
     return true;
   }
@@ -577,6 +659,12 @@ bool ReferenceCounter::HasReference(const ObjectID &object_id) const {
   return object_id_refs_.find(object_id) != object_id_refs_.end();
 }
 
+bool ReferenceCounter::OwnedByUs(const ObjectID &object_id) const {
+  absl::MutexLock lock(&mutex_);
+  auto it = object_id_refs_.find(object_id);
+  return it != object_id_refs_.end() && it->second.owned_by_us;
+}
+
 size_t ReferenceCounter::NumObjectIDsInScope() const {
   absl::MutexLock lock(&mutex_);
   return object_id_refs_.size();
@@ -586,7 +674,7 @@ std::unordered_set<ObjectID> ReferenceCounter::GetAllInScopeObjectIDs() const {
   absl::MutexLock lock(&mutex_);
   std::unordered_set<ObjectID> in_scope_object_ids;
   in_scope_object_ids.reserve(object_id_refs_.size());
-  for (auto it : object_id_refs_) {
+  for (const auto &it : object_id_refs_) {
     in_scope_object_ids.insert(it.first);
   }
   return in_scope_object_ids;
@@ -597,7 +685,7 @@ ReferenceCounter::GetAllReferenceCounts() const {
   absl::MutexLock lock(&mutex_);
   std::unordered_map<ObjectID, std::pair<size_t, size_t>> all_ref_counts;
   all_ref_counts.reserve(object_id_refs_.size());
-  for (auto it : object_id_refs_) {
+  for (const auto &it : object_id_refs_) {
     all_ref_counts.emplace(it.first,
                            std::pair<size_t, size_t>(it.second.local_ref_count,
                                                      it.second.submitted_task_ref_count));
@@ -647,17 +735,22 @@ bool ReferenceCounter::GetAndClearLocalBorrowersInternal(const ObjectID &object_
   // Clear the local list of borrowers that we have accumulated. The receiver
   // of the returned borrowed_refs must merge this list into their own list
   // until all active borrowers are merged into the owner.
-  it->second.borrowers.clear();
-  it->second.stored_in_objects.clear();
-
-  if (it->second.contained_in_borrowed_id.has_value()) {
-    /// This ID was nested in another ID that we (or a nested task) borrowed.
-    /// Make sure that we also returned the ID that contained it.
-    RAY_CHECK(borrowed_refs->count(it->second.contained_in_borrowed_id.value()) > 0);
-    /// Clear the fact that this ID was nested because we are including it in
-    /// the returned borrowed_refs. If the nested ID is not being borrowed by
-    /// us, then it will be deleted recursively when deleting the outer ID.
-    it->second.contained_in_borrowed_id.reset();
+  if (it->second.cold_fields) {
+    auto &cold = *it->second.cold_fields;
+    const size_t heap_bytes = it->second.HeapBytes();
+    cold.borrowers.clear();
+    cold.stored_in_objects.clear();
+    UpdateHeapBytes(it->second, heap_bytes);
+
+    if (cold.contained_in_borrowed_id.has_value()) {
+      /// This ID was nested in another ID that we (or a nested task) borrowed.
+      /// Make sure that we also returned the ID that contained it.
+      RAY_CHECK(borrowed_refs->count(cold.contained_in_borrowed_id.value()) > 0);
+      /// Clear the fact that this ID was nested because we are including it in
+      /// the returned borrowed_refs. If the nested ID is not being borrowed by
+      /// us, then it will be deleted recursively when deleting the outer ID.
+      cold.contained_in_borrowed_id.reset();
+    }
   }
 
   // Attempt to pop children.
@@ -678,7 +771,7 @@ void ReferenceCounter::MergeRemoteBorrowers(const ObjectID &object_id,
   }
   const auto &borrower_ref = borrower_it->second;
   RAY_LOG(DEBUG) << "Borrower ref " << object_id << " has "
-                 << borrower_ref.borrowers.size() << " borrowers "
+                 << borrower_ref.cold().borrowers.size() << " borrowers "
                  << ", has local: " << borrower_ref.local_ref_count
                  << " submitted: " << borrower_ref.submitted_task_ref_count
                  << " contained_in_owned " << borrower_ref.contained_in_owned.size();
@@ -687,19 +780,21 @@ void ReferenceCounter::MergeRemoteBorrowers(const ObjectID &object_id,
   if (it == object_id_refs_.end()) {
     it = object_id_refs_.emplace(object_id, Reference()).first;
   }
-  if (!it->second.owner_address && borrower_ref.contained_in_borrowed_id.has_value()) {
+  if (!it->second.owner_address &&
+      borrower_ref.cold().contained_in_borrowed_id.has_value()) {
     // We don't have owner information about this object ID yet and the worker
     // received it because it was nested in another ID that the worker was
     // borrowing. Copy this information to our local table.
     RAY_CHECK(borrower_ref.owner_address);
-    AddBorrowedObjectInternal(object_id, *borrower_it->second.contained_in_borrowed_id,
+    AddBorrowedObjectInternal(object_id, *borrower_ref.cold().contained_in_borrowed_id,
                               *borrower_ref.owner_address);
   }
   std::vector<rpc::WorkerAddress> new_borrowers;
+  const size_t heap_bytes = it->second.HeapBytes();
 
   // The worker is still using the reference, so it is still a borrower.
   if (borrower_ref.RefCount() > 0) {
-    auto inserted = it->second.borrowers.insert(worker_addr).second;
+    auto inserted = it->second.mutable_cold().borrowers.insert(worker_addr).second;
     // If we are the owner of id, then send WaitForRefRemoved to borrower.
     if (inserted) {
       RAY_LOG(DEBUG) << "Adding borrower " << worker_addr.ip_address << ":"
@@ -709,14 +804,15 @@ void ReferenceCounter::MergeRemoteBorrowers(const ObjectID &object_id,
   }
 
   // Add any other workers that this worker passed the ID to as new borrowers.
-  for (const auto &nested_borrower : borrower_ref.borrowers) {
-    auto inserted = it->second.borrowers.insert(nested_borrower).second;
+  for (const auto &nested_borrower : borrower_ref.cold().borrowers) {
+    auto inserted = it->second.mutable_cold().borrowers.insert(nested_borrower).second;
     if (inserted) {
       RAY_LOG(DEBUG) << "Adding borrower " << nested_borrower.ip_address << ":"
                      << nested_borrower.port << " to id " << object_id;
       new_borrowers.push_back(nested_borrower);
     }
   }
+  UpdateHeapBytes(it->second, heap_bytes);
 
   // If we own this ID, then wait for all new borrowers to reach a ref count
   // of 0 before GCing the object value.
@@ -728,7 +824,7 @@ void ReferenceCounter::MergeRemoteBorrowers(const ObjectID &object_id,
 
   // If the borrower stored this object ID inside another object ID that it did
   // not own, then mark that the object ID is nested inside another.
-  for (const auto &stored_in_object : borrower_ref.stored_in_objects) {
+  for (const auto &stored_in_object : borrower_ref.cold().stored_in_objects) {
     AddNestedObjectIdsInternal(stored_in_object.first, {object_id},
                                stored_in_object.second);
   }
@@ -744,46 +840,130 @@ void ReferenceCounter::WaitForRefRemoved(const ReferenceTable::iterator &ref_it,
                                          const rpc::WorkerAddress &addr,
                                          const ObjectID &contained_in_id) {
   const ObjectID &object_id = ref_it->first;
-  rpc::WaitForRefRemovedRequest request;
   // Only the owner should send requests to borrowers.
   RAY_CHECK(ref_it->second.owned_by_us);
-  request.mutable_reference()->set_object_id(object_id.Binary());
-  request.mutable_reference()->mutable_owner_address()->CopyFrom(
+  auto &channel = borrower_channels_[addr];
+  rpc::RefRemovedSubscription subscription;
+  subscription.mutable_reference()->set_object_id(object_id.Binary());
+  subscription.mutable_reference()->mutable_owner_address()->CopyFrom(
       *ref_it->second.owner_address);
-  request.set_contained_in_id(contained_in_id.Binary());
+  subscription.set_contained_in_id(contained_in_id.Binary());
+  channel.pending_subscriptions.push_back(std::move(subscription));
+  RAY_CHECK(channel.subscribed_ids.insert(object_id).second);
+  borrowers_to_notify_.insert(addr);
+  RAY_LOG(DEBUG) << "Waiting for borrower " << addr.ip_address << ":" << addr.port
+                 << " to stop borrowing object " << object_id;
+}
+
+void ReferenceCounter::SendRefRemovedRequests() {
+  for (const auto &addr : borrowers_to_notify_) {
+    auto it = borrower_channels_.find(addr);
+    if (it != borrower_channels_.end() && !it->second.pending_subscriptions.empty()) {
+      SendRefRemovedRequest(addr, &it->second);
+    }
+  }
+  borrowers_to_notify_.clear();
+}
+
+void ReferenceCounter::SendRefRemovedRequest(const rpc::WorkerAddress &addr,
+                                             BorrowerChannel *channel) {
+  rpc::WaitForRefsRemovedRequest request;
   request.set_intended_worker_id(addr.worker_id.Binary());
+  request.set_owner_worker_id(rpc_address_.worker_id.Binary());
+  for (auto &subscription : channel->pending_subscriptions) {
+    request.add_subscriptions()->Swap(&subscription);
+  }
+  channel->pending_subscriptions.clear();
+  channel->num_requests_in_flight++;
 
+  RAY_LOG(DEBUG) << "Sending WaitForRefsRemoved to borrower " << addr.ip_address << ":"
+                 << addr.port << " with " << request.subscriptions_size()
+                 << " new subscriptions";
   auto conn = borrower_pool_.GetOrConnect(addr.ToProto());
-
-  RAY_LOG(DEBUG) << "Sending WaitForRefRemoved to borrower " << addr.ip_address << ":"
-                 << addr.port << " for object " << object_id;
-  // Send the borrower a message about this object. The borrower responds once
-  // it is no longer using the object ID.
-  conn->WaitForRefRemoved(
-      request, [this, object_id, addr](const Status &status,
-                                       const rpc::WaitForRefRemovedReply &reply) {
-        RAY_LOG(DEBUG) << "Received reply from borrower " << addr.ip_address << ":"
-                       << addr.port << " of object " << object_id;
-        absl::MutexLock lock(&mutex_);
-
-        // Merge in any new borrowers that the previous borrower learned of.
-        const ReferenceTable new_borrower_refs =
-            ReferenceTableFromProto(reply.borrowed_refs());
-        MergeRemoteBorrowers(object_id, addr, new_borrower_refs);
-
-        // Erase the previous borrower.
-        auto it = object_id_refs_.find(object_id);
-        RAY_CHECK(it != object_id_refs_.end());
-        RAY_CHECK(it->second.borrowers.erase(addr));
-        DeleteReferenceInternal(it, nullptr);
+  // The borrower responds once it is no longer using some of the objects, or
+  // when we send it a newer request.
+  conn->WaitForRefsRemoved(
+      request,
+      [this, addr](const Status &status, const rpc::WaitForRefsRemovedReply &reply) {
+        HandleRefsRemovedReply(addr, status, reply);
       });
 }
 
+void ReferenceCounter::HandleRefsRemovedReply(const rpc::WorkerAddress &addr,
+                                              const Status &status,
+                                              const rpc::WaitForRefsRemovedReply &reply) {
+  RAY_LOG(DEBUG) << "Received reply from borrower " << addr.ip_address << ":"
+                 << addr.port << " with " << reply.notifications_size()
+                 << " removed references, status " << status;
+  absl::MutexLock lock(&mutex_);
+  auto channel_it = borrower_channels_.find(addr);
+  if (channel_it == borrower_channels_.end()) {
+    // We already gave up on the borrower after a failed request.
+    return;
+  }
+
+  if (!status.ok()) {
+    // The borrower is unreachable, so it is no longer using any of the
+    // objects.
+    RAY_LOG(DEBUG) << "Failed to wait for borrower " << addr.ip_address << ":"
+                   << addr.port << ": " << status;
+    const std::vector<ObjectID> removed_ids(channel_it->second.subscribed_ids.begin(),
+                                            channel_it->second.subscribed_ids.end());
+    borrower_channels_.erase(channel_it);
+    for (const auto &object_id : removed_ids) {
+      auto it = object_id_refs_.find(object_id);
+      RAY_CHECK(it != object_id_refs_.end());
+      RAY_CHECK(it->second.mutable_cold().borrowers.erase(addr));
+      DeleteReferenceInternal(it, nullptr);
+    }
+    SendRefRemovedRequests();
+    return;
+  }
+
+  channel_it->second.num_requests_in_flight--;
+  for (const auto &notification : reply.notifications()) {
+    const auto object_id = ObjectID::FromBinary(notification.object_id());
+    // Look up the channel again, since merging the borrowers of the previous
+    // object may have subscribed to new objects.
+    channel_it = borrower_channels_.find(addr);
+    if (channel_it == borrower_channels_.end() ||
+        !channel_it->second.subscribed_ids.erase(object_id)) {
+      continue;
+    }
+    // Merge in any new borrowers that the previous borrower learned of.
+    const ReferenceTable new_borrower_refs =
+        ReferenceTableFromProto(notification.borrowed_refs());
+    MergeRemoteBorrowers(object_id, addr, new_borrower_refs);
+
+    // Erase the previous borrower.
+    auto it = object_id_refs_.find(object_id);
+    RAY_CHECK(it != object_id_refs_.end());
+    RAY_CHECK(it->second.mutable_cold().borrowers.erase(addr));
+    DeleteReferenceInternal(it, nullptr);
+  }
+
+  // Keep waiting for the objects that the borrower is still using. Merging the
+  // borrowers above may also have queued new subscriptions on this channel.
+  channel_it = borrower_channels_.find(addr);
+  if (channel_it != borrower_channels_.end()) {
+    auto &channel = channel_it->second;
+    if (channel.num_requests_in_flight == 0) {
+      if (channel.subscribed_ids.empty()) {
+        borrower_channels_.erase(channel_it);
+      } else {
+        SendRefRemovedRequest(addr, &channel);
+      }
+    }
+  }
+  SendRefRemovedRequests();
+}
+
 void ReferenceCounter::AddNestedObjectIds(const ObjectID &object_id,
                                           const std::vector<ObjectID> &inner_ids,
                                           const rpc::WorkerAddress &owner_address) {
   absl::MutexLock lock(&mutex_);
   AddNestedObjectIdsInternal(object_id, inner_ids, owner_address);
+  SendRefRemovedRequests();
 }
 
 void ReferenceCounter::AddNestedObjectIdsInternal(
@@ -800,12 +980,16 @@ void ReferenceCounter::AddNestedObjectIdsInternal(
       // contained in the outer object ID so we do not GC the inner objects
       // until the outer object goes out of scope.
       for (const auto &inner_id : inner_ids) {
+        size_t heap_bytes = it->second.HeapBytes();
         it->second.contains.insert(inner_id);
+        UpdateHeapBytes(it->second, heap_bytes);
         auto inner_it = object_id_refs_.find(inner_id);
         RAY_CHECK(inner_it != object_id_refs_.end());
         RAY_LOG(DEBUG) << "Setting inner ID " << inner_id
                        << " contained_in_owned: " << object_id;
+        heap_bytes = inner_it->second.HeapBytes();
         inner_it->second.contained_in_owned.insert(object_id);
+        UpdateHeapBytes(inner_it->second, heap_bytes);
       }
     }
   } else {
@@ -818,15 +1002,20 @@ void ReferenceCounter::AddNestedObjectIdsInternal(
       auto inner_it = object_id_refs_.find(inner_id);
       RAY_CHECK(inner_it != object_id_refs_.end());
       // Add the task's caller as a borrower.
+      const size_t heap_bytes = inner_it->second.HeapBytes();
       if (inner_it->second.owned_by_us) {
-        auto inserted = inner_it->second.borrowers.insert(owner_address).second;
+        auto inserted =
+            inner_it->second.mutable_cold().borrowers.insert(owner_address).second;
+        UpdateHeapBytes(inner_it->second, heap_bytes);
         if (inserted) {
           // Wait for it to remove its reference.
           WaitForRefRemoved(inner_it, owner_address, object_id);
         }
       } else {
-        auto inserted =
-            inner_it->second.stored_in_objects.emplace(object_id, owner_address).second;
+        auto inserted = inner_it->second.mutable_cold()
+                            .stored_in_objects.emplace(object_id, owner_address)
+                            .second;
+        UpdateHeapBytes(inner_it->second, heap_bytes);
         // This should be the first time that we have stored this object ID
         // inside this return ID.
         RAY_CHECK(inserted);
@@ -835,13 +1024,47 @@ void ReferenceCounter::AddNestedObjectIdsInternal(
   }
 }
 
-void ReferenceCounter::HandleRefRemoved(const ObjectID &object_id,
-                                        rpc::WaitForRefRemovedReply *reply,
-                                        rpc::SendReplyCallback send_reply_callback) {
+void ReferenceCounter::HandleWaitForRefsRemoved(
+    const rpc::WaitForRefsRemovedRequest &request, rpc::WaitForRefsRemovedReply *reply,
+    rpc::SendReplyCallback send_reply_callback) {
+  absl::MutexLock lock(&mutex_);
+  const auto owner_id = WorkerID::FromBinary(request.owner_worker_id());
+  // The owner sent a newer request, so release the request that we are
+  // holding. Its reply may be empty.
+  if (owner_channels_[owner_id].send_reply_callback) {
+    ReplyRefsRemoved(owner_id);
+  }
+
+  // The objects that we already stopped borrowing are queued right away, so
+  // that they are sent together in the reply below.
+  for (const auto &subscription : request.subscriptions()) {
+    auto &channel = owner_channels_[owner_id];
+    channel.owner_node_id =
+        NodeID::FromBinary(subscription.reference().owner_address().raylet_id());
+    channel.num_subscribed++;
+    const auto object_id = ObjectID::FromBinary(subscription.reference().object_id());
+    const auto contained_in_id = ObjectID::FromBinary(subscription.contained_in_id());
+    SetRefRemovedCallback(object_id, contained_in_id,
+                          subscription.reference().owner_address(),
+                          [this, owner_id](const ObjectID &removed_id) {
+                            PublishRefRemoved(owner_id, removed_id);
+                          });
+  }
+
+  auto &channel = owner_channels_[owner_id];
+  channel.reply = reply;
+  channel.send_reply_callback = send_reply_callback;
+  if (!channel.pending_notifications.empty()) {
+    ReplyRefsRemoved(owner_id);
+  }
+}
+
+void ReferenceCounter::PublishRefRemoved(const WorkerID &owner_id,
+                                         const ObjectID &object_id) {
   ReferenceTable borrowed_refs;
   RAY_UNUSED(GetAndClearLocalBorrowersInternal(object_id, &borrowed_refs));
   for (const auto &pair : borrowed_refs) {
-    RAY_LOG(DEBUG) << pair.first << " has " << pair.second.borrowers.size()
+    RAY_LOG(DEBUG) << pair.first << " has " << pair.second.cold().borrowers.size()
                    << " borrowers";
   }
   auto it = object_id_refs_.find(object_id);
@@ -853,19 +1076,79 @@ void ReferenceCounter::HandleRefRemoved(const ObjectID &object_id,
     RAY_CHECK(it->second.OutOfScope(lineage_pinning_enabled_));
   }
   // Send the owner information about any new borrowers.
-  ReferenceTableToProto(borrowed_refs, reply->mutable_borrowed_refs());
+  auto channel_it = owner_channels_.find(owner_id);
+  if (channel_it == owner_channels_.end()) {
+    RAY_LOG(DEBUG) << "Dropping the ref removed notification for " << object_id
+                   << ", owner " << owner_id << " has failed";
+    return;
+  }
+  auto &channel = channel_it->second;
+  RAY_CHECK(channel.num_subscribed > 0);
+  channel.num_subscribed--;
+  auto notification = channel.pending_notifications.Add();
+  notification->set_object_id(object_id.Binary());
+  ReferenceTableToProto(borrowed_refs, notification->mutable_borrowed_refs());
+  if (channel.send_reply_callback) {
+    ReplyRefsRemoved(owner_id);
+  }
+}
 
-  RAY_LOG(DEBUG) << "Replying to WaitForRefRemoved, reply has "
-                 << reply->borrowed_refs().size();
-  send_reply_callback(Status::OK(), nullptr, nullptr);
+void ReferenceCounter::ReplyRefsRemoved(const WorkerID &owner_id) {
+  auto it = owner_channels_.find(owner_id);
+  RAY_CHECK(it != owner_channels_.end() && it->second.send_reply_callback);
+  auto reply = it->second.reply;
+  auto send_reply_callback = std::move(it->second.send_reply_callback);
+  it->second.reply = nullptr;
+  it->second.send_reply_callback = nullptr;
+  reply->mutable_notifications()->Swap(&it->second.pending_notifications);
+  // The owner sends a new request if it is still waiting for other objects. The
+  // notifications that are queued until then are kept in the channel.
+  if (it->second.num_subscribed == 0) {
+    owner_channels_.erase(it);
+  }
+  RAY_LOG(DEBUG) << "Replying to WaitForRefsRemoved from " << owner_id << ", reply has "
+                 << reply->notifications_size() << " removed references";
+  // A reply that can't be sent means that the owner failed. Its channel is dropped,
+  // since it won't send another request.
+  send_reply_callback(Status::OK(), nullptr, [this, owner_id]() {
+    absl::MutexLock lock(&mutex_);
+    DropOwnerChannel(owner_id);
+  });
+}
+
+void ReferenceCounter::DropOwnerChannel(const WorkerID &owner_id) {
+  auto it = owner_channels_.find(owner_id);
+  if (it == owner_channels_.end()) {
+    return;
+  }
+  RAY_LOG(DEBUG) << "Dropping the ref removed channel to failed owner " << owner_id
+                 << " with " << it->second.pending_notifications.size()
+                 << " queued notifications";
+  auto send_reply_callback = std::move(it->second.send_reply_callback);
+  owner_channels_.erase(it);
+  if (send_reply_callback) {
+    send_reply_callback(Status::OK(), nullptr, nullptr);
+  }
+}
+
+void ReferenceCounter::DropOwnerChannelsOnRemovedNode(const NodeID &node_id) {
+  absl::MutexLock lock(&mutex_);
+  std::vector<WorkerID> failed_owners;
+  for (const auto &entry : owner_channels_) {
+    if (entry.second.owner_node_id == node_id) {
+      failed_owners.push_back(entry.first);
+    }
+  }
+  for (const auto &owner_id : failed_owners) {
+    DropOwnerChannel(owner_id);
+  }
 }
 
 void ReferenceCounter::SetRefRemovedCallback(
     const ObjectID &object_id, const ObjectID &contained_in_id,
     const rpc::Address &owner_address,
     const ReferenceCounter::ReferenceRemovedCallback &ref_removed_callback) {
-  absl::MutexLock lock(&mutex_);
-  RAY_LOG(DEBUG) << "Received WaitForRefRemoved " << object_id << " contained in "
+  RAY_LOG(DEBUG) << "Received WaitForRefsRemoved " << object_id << " contained in "
                  << contained_in_id;
 
   auto it = object_id_refs_.find(object_id);
@@ -882,7 +1165,7 @@ void ReferenceCounter::SetRefRemovedCallback(
 
   if (it->second.RefCount() == 0) {
     RAY_LOG(DEBUG) << "Ref count for borrowed object " << object_id
-                   << " is already 0, responding to WaitForRefRemoved";
+                   << " is already 0, notifying the owner";
     // We already stopped borrowing the object ID. Respond to the owner
     // immediately.
     ref_removed_callback(object_id);
@@ -890,7 +1173,7 @@ void ReferenceCounter::SetRefRemovedCallback(
   } else {
     // We are still borrowing the object ID. Respond to the owner once we have
     // stopped borrowing it.
-    if (it->second.on_ref_removed != nullptr) {
+    if (it->second.cold().on_ref_removed != nullptr) {
       // TODO(swang): If the owner of an object dies and and is re-executed, it
       // is possible that we will receive a duplicate request to set
       // on_ref_removed. If messages are delayed and we overwrite the
@@ -900,7 +1183,9 @@ void ReferenceCounter::SetRefRemovedCallback(
       RAY_LOG(WARNING) << "on_ref_removed already set for " << object_id
                        << ". The owner task must have died and been re-executed.";
     }
-    it->second.on_ref_removed = ref_removed_callback;
+    const size_t heap_bytes = it->second.HeapBytes();
+    it->second.mutable_cold().on_ref_removed = ref_removed_callback;
+    UpdateHeapBytes(it->second, heap_bytes);
   }
 }
 
@@ -910,6 +1195,12 @@ void ReferenceCounter::SetReleaseLineageCallback(
   on_lineage_released_ = callback;
 }
 
+void ReferenceCounter::SetOwnedReferenceDeletedCallback(
+    const ReferenceRemovedCallback &callback) {
+  RAY_CHECK(on_owned_reference_deleted_ == nullptr);
+  on_owned_reference_deleted_ = callback;
+}
+
 bool ReferenceCounter::AddObjectLocation(const ObjectID &object_id,
                                          const NodeID &node_id) {
   absl::MutexLock lock(&mutex_);
@@ -919,7 +1210,9 @@ bool ReferenceCounter::AddObjectLocation(const ObjectID &object_id,
                      << " that doesn't exist in the reference table";
     return false;
   }
-  it->second.locations.insert(node_id);
+  const size_t heap_bytes = it->second.HeapBytes();
+  it->second.mutable_cold().locations.insert(node_id);
+  UpdateHeapBytes(it->second, heap_bytes);
   return true;
 }
 
@@ -932,12 +1225,14 @@ bool ReferenceCounter::RemoveObjectLocation(const ObjectID &object_id,
                      << " that doesn't exist in the reference table";
     return false;
   }
-  it->second.locations.erase(node_id);
+  if (it->second.cold_fields) {
+    it->second.cold_fields->locations.erase(node_id);
+  }
   return true;
 }
 
 absl::optional<absl::flat_hash_set<NodeID>> ReferenceCounter::GetObjectLocations(
-    const ObjectID &object_id) {
+    const ObjectID &object_id, int64_t *object_size) {
   absl::MutexLock lock(&mutex_);
   auto it = object_id_refs_.find(object_id);
   if (it == object_id_refs_.end()) {
@@ -945,7 +1240,10 @@ absl::optional<absl::flat_hash_set<NodeID>> ReferenceCounter::GetObjectLocations
                      << " that doesn't exist in the reference table";
     return absl::nullopt;
   }
-  return it->second.locations;
+  if (object_size != nullptr) {
+    *object_size = it->second.object_size;
+  }
+  return it->second.cold().locations;
 }
 
 void ReferenceCounter::HandleObjectSpilled(const ObjectID &object_id) {
@@ -972,10 +1270,10 @@ absl::optional<LocalityData> ReferenceCounter::GetLocalityData(
     return absl::nullopt;
   }
 
-  const auto &node_id = it->second.pinned_at_raylet_id;
+  const auto &node_id = it->second.cold().pinned_at_raylet_id;
   if (!node_id.has_value()) {
     RAY_LOG(DEBUG)
-        << "Reference " << it->second.call_site << " for object " << object_id
+        << "Reference " << *it->second.call_site << " for object " << object_id
         << " doesn't have a defined pinned raylet ID, locality data not available";
     return absl::nullopt;
   }
@@ -983,7 +1281,7 @@ absl::optional<LocalityData> ReferenceCounter::GetLocalityData(
 
   const auto object_size = it->second.object_size;
   if (object_size < 0) {
-    RAY_LOG(DEBUG) << "Reference " << it->second.call_site << " for object " << object_id
+    RAY_LOG(DEBUG) << "Reference " << *it->second.call_site << " for object " << object_id
                    << " has an unknown object size, locality data not available";
     return absl::nullopt;
   }
@@ -994,18 +1292,34 @@ absl::optional<LocalityData> ReferenceCounter::GetLocalityData(
   return locality_data;
 }
 
+ReferenceCounter::Reference::Reference(const Reference &other)
+    : call_site(other.call_site),
+      object_size(other.object_size),
+      owned_by_us(other.owned_by_us),
+      is_reconstructable(other.is_reconstructable),
+      spilled(other.spilled),
+      owner_address(other.owner_address),
+      local_ref_count(other.local_ref_count),
+      submitted_task_ref_count(other.submitted_task_ref_count),
+      lineage_ref_count(other.lineage_ref_count),
+      contained_in_owned(other.contained_in_owned),
+      contains(other.contains),
+      cold_fields(other.cold_fields ? new ColdFields(*other.cold_fields) : nullptr) {}
+
 ReferenceCounter::Reference ReferenceCounter::Reference::FromProto(
     const rpc::ObjectReferenceCount &ref_count) {
   Reference ref;
-  ref.owner_address = ref_count.reference().owner_address();
+  ref.owner_address =
+      std::make_shared<const rpc::Address>(ref_count.reference().owner_address());
   ref.local_ref_count = ref_count.has_local_ref() ? 1 : 0;
 
   for (const auto &borrower : ref_count.borrowers()) {
-    ref.borrowers.insert(rpc::WorkerAddress(borrower));
+    ref.mutable_cold().borrowers.insert(rpc::WorkerAddress(borrower));
   }
   for (const auto &object : ref_count.stored_in_objects()) {
     const auto &object_id = ObjectID::FromBinary(object.object_id());
-    ref.stored_in_objects.emplace(object_id, rpc::WorkerAddress(object.owner_address()));
+    ref.mutable_cold().stored_in_objects.emplace(
+        object_id, rpc::WorkerAddress(object.owner_address()));
   }
   for (const auto &id : ref_count.contains()) {
     ref.contains.insert(ObjectID::FromBinary(id));
@@ -1013,7 +1327,7 @@ ReferenceCounter::Reference ReferenceCounter::Reference::FromProto(
   const auto contained_in_borrowed_id =
       ObjectID::FromBinary(ref_count.contained_in_borrowed_id());
   if (!contained_in_borrowed_id.IsNil()) {
-    ref.contained_in_borrowed_id = contained_in_borrowed_id;
+    ref.mutable_cold().contained_in_borrowed_id = contained_in_borrowed_id;
   }
   return ref;
 }
@@ -1024,20 +1338,32 @@ void ReferenceCounter::Reference::ToProto(rpc::ObjectReferenceCount *ref) const
   }
   bool has_local_ref = RefCount() > 0;
   ref->set_has_local_ref(has_local_ref);
-  for (const auto &borrower : borrowers) {
+  for (const auto &borrower : cold().borrowers) {
     ref->add_borrowers()->CopyFrom(borrower.ToProto());
   }
-  for (const auto &object : stored_in_objects) {
+  for (const auto &object : cold().stored_in_objects) {
     auto ref_object = ref->add_stored_in_objects();
     ref_object->set_object_id(object.first.Binary());
     ref_object->mutable_owner_address()->CopyFrom(object.second.ToProto());
   }
-  if (contained_in_borrowed_id.has_value()) {
-    ref->set_contained_in_borrowed_id(contained_in_borrowed_id->Binary());
+  if (cold().contained_in_borrowed_id.has_value()) {
+    ref->set_contained_in_borrowed_id(cold().contained_in_borrowed_id->Binary());
   }
   for (const auto &contains_id : contains) {
     ref->add_contains(contains_id.Binary());
   }
 }
 
+size_t ReferenceCounter::Reference::ColdFields::HeapBytes() const {
+  return sizeof(ColdFields) + locations.capacity() * (sizeof(NodeID) + 1) +
+         borrowers.capacity() * (sizeof(rpc::WorkerAddress) + 1) +
+         stored_in_objects.capacity() *
+             (sizeof(std::pair<const ObjectID, rpc::WorkerAddress>) + 1);
+}
+
+size_t ReferenceCounter::Reference::HeapBytes() const {
+  return contained_in_owned.HeapBytes() + contains.HeapBytes() +
+         (cold_fields ? cold_fields->HeapBytes() : 0);
+}
+
 }  // namespace ray
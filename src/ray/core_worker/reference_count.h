@@ -19,6 +19,7 @@
 #include "absl/base/thread_annotations.h"
 #include "absl/container/flat_hash_map.h"
 #include "absl/container/flat_hash_set.h"
+#include "absl/container/node_hash_set.h"
 #include "absl/synchronization/mutex.h"
 #include "ray/common/id.h"
 #include "ray/core_worker/lease_policy.h"
@@ -26,6 +27,7 @@
 #include "ray/rpc/worker/core_worker_client.h"
 #include "ray/rpc/worker/core_worker_client_pool.h"
 #include "ray/util/logging.h"
+#include "ray/util/small_set.h"
 #include "src/ray/protobuf/common.pb.h"
 
 namespace ray {
@@ -238,22 +240,6 @@ class ReferenceCounter : public ReferenceCounterInterface,
   void ResetDeleteCallbacks(const std::vector<ObjectID> &object_ids)
       LOCKS_EXCLUDED(mutex_);
 
-  /// Set a callback for when we are no longer borrowing this object (when our
-  /// ref count goes to 0).
-  ///
-  /// \param[in] object_id The object ID to set the callback for.
-  /// \param[in] contained_in_id The object ID that contains object_id, if any.
-  /// This is used for cases when object_id was returned from a task that we
-  /// submitted. Then, as long as we have contained_in_id in scope, we are
-  /// borrowing object_id.
-  /// \param[in] owner_address The owner of object_id's address.
-  /// \param[in] ref_removed_callback The callback to call when we are no
-  /// longer borrowing the object.
-  void SetRefRemovedCallback(const ObjectID &object_id, const ObjectID &contained_in_id,
-                             const rpc::Address &owner_address,
-                             const ReferenceRemovedCallback &ref_removed_callback)
-      LOCKS_EXCLUDED(mutex_);
-
   /// Set a callback to call whenever a Reference that we own is deleted. A
   /// Reference can only be deleted if:
   /// 1. The ObjectID's ref count is 0 on all workers.
@@ -263,19 +249,31 @@ class ReferenceCounter : public ReferenceCounterInterface,
   /// \param[in] callback The callback to call.
   void SetReleaseLineageCallback(const LineageReleasedCallback &callback);
 
-  /// Respond to the object's owner once we are no longer borrowing it.  The
-  /// sender is the owner of the object ID. We will send the reply when our
-  /// RefCount() for the object ID goes to 0.
+  /// Set a callback to call whenever a Reference that we own is deleted, after the
+  /// lineage is released. The callback is called while holding the lock, so it must
+  /// not call back into the reference counter.
   ///
-  /// \param[in] object_id The object that we were borrowing.
-  /// \param[in] reply A reply sent to the owner when we are no longer
-  /// borrowing the object ID. This reply also includes any new borrowers and
-  /// any object IDs that were nested inside the object that we or others are
-  /// now borrowing.
+  /// \param[in] callback The callback to call.
+  void SetOwnedReferenceDeletedCallback(const ReferenceRemovedCallback &callback);
+
+  /// Handle a request from an object owner to wait until we are no longer
+  /// borrowing the given objects. We keep one channel per owner, so that the
+  /// notifications for all the objects that we borrow from the same owner
+  /// share one outstanding request. The reply is held until we stop borrowing
+  /// any object that the owner subscribed to, in this or an earlier request,
+  /// and then carries every object that we stopped borrowing since the
+  /// previous reply. A newer request from the same owner releases the held
+  /// reply, so that the owner can send new subscriptions at any time.
+  ///
+  /// \param[in] request The objects to wait for.
+  /// \param[out] reply For each object that we stopped borrowing, any new
+  /// borrowers and any object IDs that were nested inside the object that we
+  /// or others are now borrowing.
   /// \param[in] send_reply_callback The callback to send the reply.
-  void HandleRefRemoved(const ObjectID &object_id, rpc::WaitForRefRemovedReply *reply,
-                        rpc::SendReplyCallback send_reply_callback)
-      EXCLUSIVE_LOCKS_REQUIRED(mutex_);
+  void HandleWaitForRefsRemoved(const rpc::WaitForRefsRemovedRequest &request,
+                                rpc::WaitForRefsRemovedReply *reply,
+                                rpc::SendReplyCallback send_reply_callback)
+      LOCKS_EXCLUDED(mutex_);
 
   /// Returns the total number of ObjectIDs currently in scope.
   size_t NumObjectIDsInScope() const LOCKS_EXCLUDED(mutex_);
@@ -357,12 +355,25 @@ class ReferenceCounter : public ReferenceCounterInterface,
   /// \return The set of objects that were pinned on the given node.
   std::vector<ObjectID> ResetObjectsOnRemovedNode(const NodeID &raylet_id);
 
+  /// Drop the ref-removed channels to the owners on the given node. This should
+  /// be called upon a node failure, so that the notifications for the owners
+  /// that died with the node are not queued forever.
+  ///
+  /// \param[in] node_id The node that has been removed.
+  void DropOwnerChannelsOnRemovedNode(const NodeID &node_id) LOCKS_EXCLUDED(mutex_);
+
   /// Whether we have a reference to a particular ObjectID.
   ///
   /// \param[in] object_id The object ID to check for.
   /// \return Whether we have a reference to the object ID.
   bool HasReference(const ObjectID &object_id) const LOCKS_EXCLUDED(mutex_);
 
+  /// Whether we own a particular ObjectID.
+  ///
+  /// \param[in] object_id The object ID to check for.
+  /// \return Whether we have a reference to the object ID and own it.
+  bool OwnedByUs(const ObjectID &object_id) const LOCKS_EXCLUDED(mutex_);
+
   /// Write the current reference table to the given proto.
   ///
   /// \param[out] stats The proto to write references to.
@@ -370,6 +381,13 @@ class ReferenceCounter : public ReferenceCounterInterface,
       const absl::flat_hash_map<ObjectID, std::pair<int64_t, std::string>> pinned_objects,
       rpc::CoreWorkerStats *stats) const LOCKS_EXCLUDED(mutex_);
 
+  /// Estimate the memory used to track the references in scope. This includes
+  /// the reference table, the out-of-line fields of each reference and the
+  /// interned call sites and owner addresses.
+  ///
+  /// \return The estimated number of bytes.
+  size_t EstimateMemoryUsage() const LOCKS_EXCLUDED(mutex_);
+
   /// Add a new location for the given object. The owner must have the object ref in
   /// scope.
   ///
@@ -392,10 +410,12 @@ class ReferenceCounter : public ReferenceCounterInterface,
   /// scope.
   ///
   /// \param[in] object_id The object to get locations for.
+  /// \param[out] object_size If not null, set to the size of the object, or -1 if
+  ///         the size is unknown.
   /// \return The nodes that have the object if the reference exists, empty optional
   ///         otherwise.
   absl::optional<absl::flat_hash_set<NodeID>> GetObjectLocations(
-      const ObjectID &object_id) LOCKS_EXCLUDED(mutex_);
+      const ObjectID &object_id, int64_t *object_size = nullptr) LOCKS_EXCLUDED(mutex_);
 
   /// Handle an object has been spilled to external storage.
   ///
@@ -408,20 +428,84 @@ class ReferenceCounter : public ReferenceCounterInterface,
 
  private:
   struct Reference {
+    /// Fields that most references never set. They are kept out of line and
+    /// allocated on first write, so that the common Reference stays small.
+    struct ColdFields {
+      // If this object is owned by us and stored in plasma, and reference
+      // counting is enabled, then some raylet must be pinning the object value.
+      // This is the address of that raylet.
+      absl::optional<NodeID> pinned_at_raylet_id;
+      // If this object is owned by us and stored in plasma, this contains all
+      // object locations.
+      absl::flat_hash_set<NodeID> locations;
+      /// An Object ID that we (or one of our children) borrowed that contains
+      /// this object ID, which is also borrowed. This is used in cases where an
+      /// ObjectID is nested. We need to notify the owner of the outer ID of any
+      /// borrowers of this object, so we keep this field around until
+      /// GetAndClearLocalBorrowersInternal is called on the outer ID. This field
+      /// is updated in 2 cases:
+      ///  1. We deserialize an ID that we do not own and that was stored in
+      ///     another object that we do not own.
+      ///  2. Case (1) occurred for a task that we submitted and we also do not
+      ///     own the inner or outer object. Then, we need to notify our caller
+      ///     that the task we submitted is a borrower for the inner ID.
+      /// This field is reset to null once GetAndClearLocalBorrowersInternal is
+      /// called on contained_in_borrowed_id. For each borrower, this field is
+      /// set at most once during the reference's lifetime. If the object ID is
+      /// later found to be nested in a second object, we do not need to remember
+      /// the second ID because we will already have notified the owner of the
+      /// first outer object about our reference.
+      absl::optional<ObjectID> contained_in_borrowed_id;
+      /// A list of processes that are we gave a reference to that are still
+      /// borrowing the ID. This field is updated in 2 cases:
+      ///  1. If we are a borrower of the ID, then we add a process to this list
+      ///     if we passed that process a copy of the ID via task submission and
+      ///     the process is still using the ID by the time it finishes its task.
+      ///     Borrowers are removed from the list when we recursively merge our
+      ///     list into the owner.
+      ///  2. If we are the owner of the ID, then either the above case, or when
+      ///     we hear from a borrower that it has passed the ID to other
+      ///     borrowers. A borrower is removed from the list when it responds
+      ///     that it is no longer using the reference.
+      absl::flat_hash_set<rpc::WorkerAddress> borrowers;
+      /// When a process that is borrowing an object ID stores the ID inside the
+      /// return value of a task that it executes, the caller of the task is also
+      /// considered a borrower for as long as its reference to the task's return
+      /// ID stays in scope. Thus, the borrower must notify the owner that the
+      /// task's caller is also a borrower. The key is the task's return ID, and
+      /// the value is the task ID and address of the task's caller.
+      absl::flat_hash_map<ObjectID, rpc::WorkerAddress> stored_in_objects;
+      /// Callback that will be called when this ObjectID no longer has
+      /// references.
+      std::function<void(const ObjectID &)> on_delete;
+      /// Callback that is called when this process is no longer a borrower
+      /// (RefCount() == 0).
+      std::function<void(const ObjectID &)> on_ref_removed;
+
+      /// The number of bytes allocated on the heap by these fields.
+      size_t HeapBytes() const;
+    };
+
     /// Constructor for a reference whose origin is unknown.
     Reference() {}
-    Reference(std::string call_site, const int64_t object_size)
+    Reference(const std::string *call_site, const int64_t object_size)
         : call_site(call_site), object_size(object_size) {}
     /// Constructor for a reference that we created.
-    Reference(const rpc::Address &owner_address, std::string call_site,
-              const int64_t object_size, bool is_reconstructable,
-              const absl::optional<NodeID> &pinned_at_raylet_id)
+    Reference(std::shared_ptr<const rpc::Address> owner_address,
+              const std::string *call_site, const int64_t object_size,
+              bool is_reconstructable, const absl::optional<NodeID> &pinned_at_raylet_id)
         : call_site(call_site),
           object_size(object_size),
           owned_by_us(true),
-          owner_address(owner_address),
-          pinned_at_raylet_id(pinned_at_raylet_id),
-          is_reconstructable(is_reconstructable) {}
+          is_reconstructable(is_reconstructable),
+          owner_address(std::move(owner_address)) {
+      if (pinned_at_raylet_id.has_value()) {
+        mutable_cold().pinned_at_raylet_id = pinned_at_raylet_id;
+      }
+    }
+
+    Reference(const Reference &other);
+    Reference(Reference &&other) = default;
 
     /// Constructor from a protobuf. This is assumed to be a message from
     /// another process, so the object defaults to not being owned by us.
@@ -429,6 +513,25 @@ class ReferenceCounter : public ReferenceCounterInterface,
     /// Serialize to a protobuf.
     void ToProto(rpc::ObjectReferenceCount *ref) const;
 
+    /// The fields that are kept out of line. Returns empty fields if none were
+    /// set.
+    const ColdFields &cold() const {
+      static const ColdFields kEmptyColdFields;
+      return cold_fields ? *cold_fields : kEmptyColdFields;
+    }
+
+    /// The fields that are kept out of line, allocating them if needed.
+    ColdFields &mutable_cold() {
+      if (!cold_fields) {
+        cold_fields.reset(new ColdFields());
+      }
+      return *cold_fields;
+    }
+
+    /// The number of bytes allocated on the heap by this reference, not
+    /// counting the interned call site and owner address.
+    size_t HeapBytes() const;
+
     /// The reference count. This number includes:
     /// - Python references to the ObjectID.
     /// - Pending submitted tasks that depend on the object.
@@ -446,9 +549,9 @@ class ReferenceCounter : public ReferenceCounterInterface,
     /// - We gave the reference to at least one other process.
     bool OutOfScope(bool lineage_pinning_enabled) const {
       bool in_scope = RefCount() > 0;
-      bool was_contained_in_borrowed_id = contained_in_borrowed_id.has_value();
-      bool has_borrowers = borrowers.size() > 0;
-      bool was_stored_in_objects = stored_in_objects.size() > 0;
+      bool was_contained_in_borrowed_id = cold().contained_in_borrowed_id.has_value();
+      bool has_borrowers = cold().borrowers.size() > 0;
+      bool was_stored_in_objects = cold().stored_in_objects.size() > 0;
 
       bool has_lineage_references = false;
       if (lineage_pinning_enabled && owned_by_us && !is_reconstructable) {
@@ -472,8 +575,9 @@ class ReferenceCounter : public ReferenceCounterInterface,
       }
     }
 
-    /// Description of the call site where the reference was created.
-    std::string call_site = "<unknown>";
+    /// Description of the call site where the reference was created. Call
+    /// sites are interned by the ReferenceCounter, see InternCallSite.
+    const std::string *call_site = &kUnknownCallSite;
     /// Object size if known, otherwise -1;
     int64_t object_size = -1;
 
@@ -481,95 +585,100 @@ class ReferenceCounter : public ReferenceCounterInterface,
     /// responsible for tracking the state of the task that creates the object
     /// (see task_manager.h).
     bool owned_by_us = false;
-    /// The object's owner's address, if we know it. If this process is the
-    /// owner, then this is added during creation of the Reference. If this is
-    /// process is a borrower, the borrower must add the owner's address before
-    /// using the ObjectID.
-    absl::optional<rpc::Address> owner_address;
-    // If this object is owned by us and stored in plasma, and reference
-    // counting is enabled, then some raylet must be pinning the object value.
-    // This is the address of that raylet.
-    absl::optional<NodeID> pinned_at_raylet_id;
-    // If this object is owned by us and stored in plasma, this contains all
-    // object locations.
-    absl::flat_hash_set<NodeID> locations;
     // Whether this object can be reconstructed via lineage. If false, then the
     // object's value will be pinned as long as it is referenced by any other
     // object's lineage.
     const bool is_reconstructable = false;
+    /// Whether this object has been spilled to external storage.
+    bool spilled = false;
+    /// The object's owner's address, if we know it. If this process is the
+    /// owner, then this is added during creation of the Reference. If this is
+    /// process is a borrower, the borrower must add the owner's address before
+    /// using the ObjectID. Owner addresses are interned by the
+    /// ReferenceCounter, see InternOwnerAddress.
+    std::shared_ptr<const rpc::Address> owner_address;
 
     /// The local ref count for the ObjectID in the language frontend.
     size_t local_ref_count = 0;
     /// The ref count for submitted tasks that depend on the ObjectID.
     size_t submitted_task_ref_count = 0;
+    /// The number of tasks that depend on this object that may be retried in
+    /// the future (pending execution or finished but retryable). If the object
+    /// is inlined (not stored in plasma), then its lineage ref count is 0
+    /// because any dependent task will already have the value of the object.
+    size_t lineage_ref_count = 0;
     /// Object IDs that we own and that contain this object ID.
     /// ObjectIDs are added to this field when we discover that this object
     /// contains other IDs. This can happen in 2 cases:
     ///  1. We call ray.put() and store the inner ID(s) in the outer object.
     ///  2. A task that we submitted returned an ID(s).
     /// ObjectIDs are erased from this field when their Reference is deleted.
-    absl::flat_hash_set<ObjectID> contained_in_owned;
-    /// An Object ID that we (or one of our children) borrowed that contains
-    /// this object ID, which is also borrowed. This is used in cases where an
-    /// ObjectID is nested. We need to notify the owner of the outer ID of any
-    /// borrowers of this object, so we keep this field around until
-    /// GetAndClearLocalBorrowersInternal is called on the outer ID. This field
-    /// is updated in 2 cases:
-    ///  1. We deserialize an ID that we do not own and that was stored in
-    ///     another object that we do not own.
-    ///  2. Case (1) occurred for a task that we submitted and we also do not
-    ///     own the inner or outer object. Then, we need to notify our caller
-    ///     that the task we submitted is a borrower for the inner ID.
-    /// This field is reset to null once GetAndClearLocalBorrowersInternal is
-    /// called on contained_in_borrowed_id. For each borrower, this field is
-    /// set at most once during the reference's lifetime. If the object ID is
-    /// later found to be nested in a second object, we do not need to remember
-    /// the second ID because we will already have notified the owner of the
-    /// first outer object about our reference.
-    absl::optional<ObjectID> contained_in_borrowed_id;
+    SmallSet<ObjectID> contained_in_owned;
     /// The object IDs contained in this object. These could be objects that we
     /// own or are borrowing. This field is updated in 2 cases:
     ///  1. We call ray.put() on this ID and store the contained IDs.
     ///  2. We call ray.get() on an ID whose contents we do not know and we
     ///     discover that it contains these IDs.
-    absl::flat_hash_set<ObjectID> contains;
-    /// A list of processes that are we gave a reference to that are still
-    /// borrowing the ID. This field is updated in 2 cases:
-    ///  1. If we are a borrower of the ID, then we add a process to this list
-    ///     if we passed that process a copy of the ID via task submission and
-    ///     the process is still using the ID by the time it finishes its task.
-    ///     Borrowers are removed from the list when we recursively merge our
-    ///     list into the owner.
-    ///  2. If we are the owner of the ID, then either the above case, or when
-    ///     we hear from a borrower that it has passed the ID to other
-    ///     borrowers. A borrower is removed from the list when it responds
-    ///     that it is no longer using the reference.
-    absl::flat_hash_set<rpc::WorkerAddress> borrowers;
-    /// When a process that is borrowing an object ID stores the ID inside the
-    /// return value of a task that it executes, the caller of the task is also
-    /// considered a borrower for as long as its reference to the task's return
-    /// ID stays in scope. Thus, the borrower must notify the owner that the
-    /// task's caller is also a borrower. The key is the task's return ID, and
-    /// the value is the task ID and address of the task's caller.
-    absl::flat_hash_map<ObjectID, rpc::WorkerAddress> stored_in_objects;
-    /// The number of tasks that depend on this object that may be retried in
-    /// the future (pending execution or finished but retryable). If the object
-    /// is inlined (not stored in plasma), then its lineage ref count is 0
-    /// because any dependent task will already have the value of the object.
-    size_t lineage_ref_count = 0;
-    /// Whether this object has been spilled to external storage.
-    bool spilled = false;
+    SmallSet<ObjectID> contains;
+    /// The fields that are kept out of line, or null if none were set.
+    std::unique_ptr<ColdFields> cold_fields;
 
-    /// Callback that will be called when this ObjectID no longer has
-    /// references.
-    std::function<void(const ObjectID &)> on_delete;
-    /// Callback that is called when this process is no longer a borrower
-    /// (RefCount() == 0).
-    std::function<void(const ObjectID &)> on_ref_removed;
+    /// The call site of references whose origin is unknown.
+    static const std::string kUnknownCallSite;
   };
 
   using ReferenceTable = absl::flat_hash_map<ObjectID, Reference>;
 
+  /// The owner's end of the ref-removed channel to a borrower.
+  struct BorrowerChannel {
+    /// Subscriptions that have not been sent to the borrower yet.
+    std::vector<rpc::RefRemovedSubscription> pending_subscriptions;
+    /// The objects that we are waiting for the borrower to stop borrowing.
+    absl::flat_hash_set<ObjectID> subscribed_ids;
+    /// The number of requests sent to the borrower whose replies have not been
+    /// received yet. The borrower holds at most one of them, but it replies to
+    /// the held request when a newer one arrives, so the earlier replies may
+    /// still be on their way.
+    size_t num_requests_in_flight = 0;
+  };
+
+  /// The borrower's end of the ref-removed channel to an owner. The channel
+  /// lives until the owner has been told about all the objects it subscribed
+  /// to, or until the owner fails.
+  struct OwnerChannel {
+    /// Notifications that have not been sent to the owner yet.
+    ::google::protobuf::RepeatedPtrField<rpc::RefRemovedNotification>
+        pending_notifications;
+    /// The reply to the request that we are holding, if any.
+    rpc::WaitForRefsRemovedReply *reply = nullptr;
+    /// The callback to send the held reply.
+    rpc::SendReplyCallback send_reply_callback;
+    /// The node of the owner.
+    NodeID owner_node_id;
+    /// The number of subscribed objects that we have not queued a notification
+    /// for yet.
+    size_t num_subscribed = 0;
+  };
+
+  /// Return the interned copy of a call site. Interned call sites are never
+  /// freed, since a program only has a bounded number of call sites.
+  const std::string *InternCallSite(const std::string &call_site)
+      EXCLUSIVE_LOCKS_REQUIRED(mutex_);
+
+  /// Return the interned copy of an owner address, so that all the references
+  /// owned by the same worker share one address. Addresses that are no longer
+  /// used by any reference are dropped once the table has doubled in size.
+  std::shared_ptr<const rpc::Address> InternOwnerAddress(const rpc::Address &address)
+      EXCLUSIVE_LOCKS_REQUIRED(mutex_);
+
+  /// Update the heap bytes of the references after a reference in the table was
+  /// changed in a way that may have allocated or freed memory.
+  ///
+  /// \param[in] ref The changed reference.
+  /// \param[in] heap_bytes_before The heap bytes of the reference before the change.
+  void UpdateHeapBytes(const Reference &ref, size_t heap_bytes_before)
+      EXCLUSIVE_LOCKS_REQUIRED(mutex_);
+
   bool GetOwnerInternal(const ObjectID &object_id,
                         rpc::Address *owner_address = nullptr) const
       EXCLUSIVE_LOCKS_REQUIRED(mutex_);
@@ -653,7 +762,8 @@ class ReferenceCounter : public ReferenceCounterInterface,
       EXCLUSIVE_LOCKS_REQUIRED(mutex_);
 
   /// Wait for a borrower to stop using its reference. This should only be
-  /// called by the owner of the ID.
+  /// called by the owner of the ID. The subscription is queued on the channel
+  /// to the borrower and sent by the next call to SendRefRemovedRequests.
   /// \param[in] reference_it Iterator pointing to the reference that we own.
   /// \param[in] addr The address of the borrower.
   /// \param[in] contained_in_id Whether the owned ID was contained in another
@@ -665,6 +775,55 @@ class ReferenceCounter : public ReferenceCounterInterface,
                          const ObjectID &contained_in_id = ObjectID::Nil())
       EXCLUSIVE_LOCKS_REQUIRED(mutex_);
 
+  /// Send the queued subscriptions, one request per borrower. This must be
+  /// called before releasing the lock in any method that may have called
+  /// WaitForRefRemoved.
+  void SendRefRemovedRequests() EXCLUSIVE_LOCKS_REQUIRED(mutex_);
+
+  /// Send a request on the channel to a borrower, with any queued
+  /// subscriptions.
+  void SendRefRemovedRequest(const rpc::WorkerAddress &addr, BorrowerChannel *channel)
+      EXCLUSIVE_LOCKS_REQUIRED(mutex_);
+
+  /// Handle the borrower's reply on a ref-removed channel. If the request
+  /// failed, the borrower is assumed to have died and to no longer borrow any
+  /// of the objects that we subscribed to.
+  void HandleRefsRemovedReply(const rpc::WorkerAddress &addr, const Status &status,
+                              const rpc::WaitForRefsRemovedReply &reply)
+      LOCKS_EXCLUDED(mutex_);
+
+  /// Set a callback for when we are no longer borrowing this object (when our
+  /// ref count goes to 0).
+  ///
+  /// \param[in] object_id The object ID to set the callback for.
+  /// \param[in] contained_in_id The object ID that contains object_id, if any.
+  /// This is used for cases when object_id was returned from a task that we
+  /// submitted. Then, as long as we have contained_in_id in scope, we are
+  /// borrowing object_id.
+  /// \param[in] owner_address The owner of object_id's address.
+  /// \param[in] ref_removed_callback The callback to call when we are no
+  /// longer borrowing the object.
+  void SetRefRemovedCallback(const ObjectID &object_id, const ObjectID &contained_in_id,
+                             const rpc::Address &owner_address,
+                             const ReferenceRemovedCallback &ref_removed_callback)
+      EXCLUSIVE_LOCKS_REQUIRED(mutex_);
+
+  /// Queue a notification to the owner once we are no longer borrowing the
+  /// object, and send it if the owner's request is being held. The
+  /// notification also includes any new borrowers and any object IDs that were
+  /// nested inside the object that we or others are now borrowing.
+  void PublishRefRemoved(const WorkerID &owner_id, const ObjectID &object_id)
+      EXCLUSIVE_LOCKS_REQUIRED(mutex_);
+
+  /// Reply to the held request of an owner with the queued notifications. The
+  /// channel is dropped if the owner is not subscribed to any more objects, or
+  /// if the reply can't be sent because the owner failed.
+  void ReplyRefsRemoved(const WorkerID &owner_id) EXCLUSIVE_LOCKS_REQUIRED(mutex_);
+
+  /// Drop the channel to an owner that failed. The held request, if any, is
+  /// released with an empty reply.
+  void DropOwnerChannel(const WorkerID &owner_id) EXCLUSIVE_LOCKS_REQUIRED(mutex_);
+
   /// Helper method to add an object that we are borrowing. This is used when
   /// deserializing IDs from a task's arguments, or when deserializing an ID
   /// during ray.get().
@@ -713,6 +872,39 @@ class ReferenceCounter : public ReferenceCounterInterface,
   /// Holds all reference counts and dependency information for tracked ObjectIDs.
   ReferenceTable object_id_refs_ GUARDED_BY(mutex_);
 
+  /// The ref-removed channels to the borrowers of the objects that we own.
+  absl::flat_hash_map<rpc::WorkerAddress, BorrowerChannel> borrower_channels_
+      GUARDED_BY(mutex_);
+
+  /// The borrowers that have queued subscriptions.
+  absl::flat_hash_set<rpc::WorkerAddress> borrowers_to_notify_ GUARDED_BY(mutex_);
+
+  /// The ref-removed channels to the owners of the objects that we borrow,
+  /// keyed by the owner's worker ID.
+  absl::flat_hash_map<WorkerID, OwnerChannel> owner_channels_ GUARDED_BY(mutex_);
+
+  /// Interned call sites of the references.
+  absl::node_hash_set<std::string> call_sites_ GUARDED_BY(mutex_);
+
+  /// Interned owner addresses of the references, keyed by the owner's worker
+  /// ID.
+  absl::flat_hash_map<std::string, std::shared_ptr<const rpc::Address>> owner_addresses_
+      GUARDED_BY(mutex_);
+
+  /// The size of owner_addresses_ at which unused addresses are dropped.
+  size_t owner_addresses_gc_threshold_ GUARDED_BY(mutex_) = 1024;
+
+  /// The heap bytes of the references in the table, see Reference::HeapBytes. This
+  /// and the two below are kept up to date as the references change, so that
+  /// EstimateMemoryUsage doesn't scan the table.
+  size_t references_heap_bytes_ GUARDED_BY(mutex_) = 0;
+
+  /// The bytes used by the interned call sites.
+  size_t call_sites_bytes_ GUARDED_BY(mutex_) = 0;
+
+  /// The bytes used by the interned owner addresses.
+  size_t owner_addresses_bytes_ GUARDED_BY(mutex_) = 0;
+
   /// Objects whose values have been freed by the language frontend.
   /// The values in plasma will not be pinned. An object ID is
   /// removed from this set once its Reference has been deleted
@@ -723,6 +915,9 @@ class ReferenceCounter : public ReferenceCounterInterface,
   /// and it has no tasks that depend on it that may be retried in the future.
   /// The object's Reference will be erased after this callback.
   LineageReleasedCallback on_lineage_released_;
+  /// The callback to call once a Reference that we own is deleted, e.g., to tell the
+  /// nodes that subscribed to the object's locations that the object is gone.
+  ReferenceRemovedCallback on_owned_reference_deleted_;
   /// Optional shutdown hook to call when all references have gone
   /// out of scope.
   std::function<void()> shutdown_hook_ GUARDED_BY(mutex_) = nullptr;
@@ -67,28 +67,27 @@ class MockWorkerClient : public rpc::CoreWorkerClientInterface {
             /*distributed_ref_counting_enabled=*/true,
             /*lineage_pinning_enabled=*/false, client_factory) {}
 
-  void WaitForRefRemoved(
-      const rpc::WaitForRefRemovedRequest &request,
-      const rpc::ClientCallback<rpc::WaitForRefRemovedReply> &callback) override {
+  void WaitForRefsRemoved(
+      const rpc::WaitForRefsRemovedRequest &request,
+      const rpc::ClientCallback<rpc::WaitForRefsRemovedReply> &callback) override {
     auto r = num_requests_;
     requests_[r] = {
-        std::make_shared<rpc::WaitForRefRemovedReply>(),
+        std::make_shared<rpc::WaitForRefsRemovedReply>(),
         callback,
     };
+    num_subscriptions_ += request.subscriptions_size();
 
     auto send_reply_callback = [this, r](Status status, std::function<void()> success,
                                          std::function<void()> failure) {
-      requests_[r].second(status, *requests_[r].first);
+      auto it = requests_.find(r);
+      RAY_CHECK(it != requests_.end());
+      auto request = it->second;
+      requests_.erase(it);
+      request.second(status, *request.first);
     };
     auto borrower_callback = [=]() {
-      const ObjectID &object_id = ObjectID::FromBinary(request.reference().object_id());
-      ObjectID contained_in_id = ObjectID::FromBinary(request.contained_in_id());
-      const auto owner_address = request.reference().owner_address();
-      auto ref_removed_callback =
-          boost::bind(&ReferenceCounter::HandleRefRemoved, &rc_, _1,
-                      requests_[r].first.get(), send_reply_callback);
-      rc_.SetRefRemovedCallback(object_id, contained_in_id, owner_address,
-                                ref_removed_callback);
+      rc_.HandleWaitForRefsRemoved(request, requests_[r].first.get(),
+                                   send_reply_callback);
     };
     borrower_callbacks_[r] = borrower_callback;
 
@@ -99,16 +98,21 @@ class MockWorkerClient : public rpc::CoreWorkerClientInterface {
     if (borrower_callbacks_.empty()) {
       return false;
     } else {
-      for (auto &callback : borrower_callbacks_) {
+      // Replying to a request may cause the owner to send a new one.
+      auto callbacks = std::move(borrower_callbacks_);
+      borrower_callbacks_.clear();
+      for (auto &callback : callbacks) {
         callback.second();
       }
-      borrower_callbacks_.clear();
       return true;
     }
   }
 
   void FailAllWaitForRefRemovedRequests() {
-    for (const auto &request : requests_) {
+    borrower_callbacks_.clear();
+    auto requests = std::move(requests_);
+    requests_.clear();
+    for (const auto &request : requests) {
       request.second.second(Status::IOError("disconnected"), *request.second.first);
     }
   }
@@ -185,11 +189,12 @@ class MockWorkerClient : public rpc::CoreWorkerClientInterface {
   rpc::Address address_;
   // The ReferenceCounter at the "client".
   ReferenceCounter rc_;
-  std::unordered_map<int, std::function<void()>> borrower_callbacks_;
-  std::unordered_map<int, std::pair<std::shared_ptr<rpc::WaitForRefRemovedReply>,
-                                    rpc::ClientCallback<rpc::WaitForRefRemovedReply>>>
+  std::map<int, std::function<void()>> borrower_callbacks_;
+  std::unordered_map<int, std::pair<std::shared_ptr<rpc::WaitForRefsRemovedReply>,
+                                    rpc::ClientCallback<rpc::WaitForRefsRemovedReply>>>
       requests_;
   int num_requests_ = 0;
+  int num_subscriptions_ = 0;
 };
 
 // Tests basic incrementing/decrementing of direct/submitted task reference counts. An
@@ -261,6 +266,30 @@ TEST_F(ReferenceCountTest, TestBasic) {
   out.clear();
 }
 
+// Test that we call the deletion callback only for the references that we own.
+TEST_F(ReferenceCountTest, TestOwnedReferenceDeletedCallback) {
+  std::vector<ObjectID> deleted;
+  rc->SetOwnedReferenceDeletedCallback(
+      [&](const ObjectID &object_id) { deleted.push_back(object_id); });
+
+  // Borrowed objects.
+  ObjectID borrowed_id = ObjectID::FromRandom();
+  rc->AddLocalReference(borrowed_id, "");
+  rc->RemoveLocalReference(borrowed_id, nullptr);
+  ASSERT_TRUE(deleted.empty());
+
+  // Owned objects.
+  ObjectID owned_id = ObjectID::FromRandom();
+  rc->AddOwnedObject(owned_id, {}, rpc::Address(), "", 0, false);
+  rc->AddLocalReference(owned_id, "");
+  rc->AddLocalReference(owned_id, "");
+  rc->RemoveLocalReference(owned_id, nullptr);
+  ASSERT_TRUE(deleted.empty());
+  rc->RemoveLocalReference(owned_id, nullptr);
+  ASSERT_FALSE(rc->HasReference(owned_id));
+  ASSERT_EQ(deleted, std::vector<ObjectID>({owned_id}));
+}
+
 TEST_F(ReferenceCountTest, TestUnreconstructableObjectOutOfScope) {
   ObjectID id = ObjectID::FromRandom();
   rpc::Address address;
@@ -388,6 +417,43 @@ TEST_F(ReferenceCountTest, TestOwnerAddress) {
   ASSERT_FALSE(rc->GetOwner(object_id3, &added_address));
 }
 
+// Tests that call sites and owner addresses are shared between references and
+// that rarely used fields do not take space until they are set.
+TEST_F(ReferenceCountTest, TestCompactReferences) {
+  rpc::Address address;
+  address.set_ip_address("1234");
+  address.set_worker_id(WorkerID::FromRandom().Binary());
+  const std::string call_site(1000, 'x');
+  const size_t num_objects = 1000;
+  const size_t initial_bytes = rc->EstimateMemoryUsage();
+
+  std::vector<ObjectID> object_ids;
+  for (size_t i = 0; i < num_objects; i++) {
+    object_ids.push_back(ObjectID::FromRandom());
+    rc->AddOwnedObject(object_ids.back(), {}, address, call_site, 100, false);
+  }
+  const size_t bytes = rc->EstimateMemoryUsage() - initial_bytes;
+  // The call site is stored once, not once per reference.
+  ASSERT_LT(bytes, num_objects * call_site.size());
+
+  for (const auto &object_id : object_ids) {
+    ASSERT_TRUE(rc->AddObjectLocation(object_id, NodeID::FromRandom()));
+  }
+  ASSERT_GT(rc->EstimateMemoryUsage() - initial_bytes, bytes);
+
+  rpc::Address owner_address;
+  ASSERT_TRUE(rc->GetOwner(object_ids.back(), &owner_address));
+  ASSERT_EQ(owner_address.ip_address(), address.ip_address());
+  ASSERT_EQ(owner_address.worker_id(), address.worker_id());
+  for (const auto &object_id : object_ids) {
+    rc->RemoveOwnedObject(object_id);
+  }
+  ASSERT_EQ(rc->NumObjectIDsInScope(), 0);
+  // The locations are freed with the references. The table keeps its capacity, and
+  // the call site and owner address stay interned.
+  ASSERT_EQ(rc->EstimateMemoryUsage() - initial_bytes, bytes);
+}
+
 // Tests that the ref counts are properly integrated into the local
 // object memory store.
 TEST(MemoryStoreIntegrationTest, TestSimple) {
@@ -665,6 +731,114 @@ TEST(DistributedReferenceCountTest, TestSimpleBorrowerReferenceRemoved) {
   ASSERT_FALSE(owner->rc_.HasReference(inner_id));
 }
 
+// A borrower keeps a reference past the task's lifetime, and the owner's node
+// fails before the borrower stops using it. The borrower releases the owner's
+// request and does not keep the notification for the failed owner.
+TEST(DistributedReferenceCountTest, TestOwnerNodeFailure) {
+  auto borrower = std::make_shared<MockWorkerClient>("1");
+  auto owner = std::make_shared<MockWorkerClient>(
+      "2", [&](const rpc::Address &addr) { return borrower; });
+
+  auto inner_id = ObjectID::FromRandom();
+  auto outer_id = ObjectID::FromRandom();
+  owner->Put(inner_id);
+  owner->PutWrappedId(outer_id, inner_id);
+  owner->SubmitTaskWithArg(outer_id);
+  owner->rc_.RemoveLocalReference(outer_id, nullptr);
+  owner->rc_.RemoveLocalReference(inner_id, nullptr);
+
+  // The borrower task returns to the owner while still using inner_id, and the
+  // borrower holds the owner's request.
+  borrower->ExecuteTaskWithArg(outer_id, inner_id, owner->address_);
+  auto borrower_refs = borrower->FinishExecutingTask(outer_id, ObjectID::Nil());
+  owner->HandleSubmittedTaskFinished(outer_id, {}, borrower->address_, borrower_refs);
+  ASSERT_TRUE(borrower->FlushBorrowerCallbacks());
+  ASSERT_EQ(borrower->requests_.size(), 1);
+
+  // The owner's node fails. The held request is released with an empty reply.
+  borrower->rc_.DropOwnerChannelsOnRemovedNode(
+      NodeID::FromBinary(owner->address_.raylet_id()));
+  ASSERT_EQ(borrower->num_requests_, 2);
+  ASSERT_TRUE(owner->rc_.HasReference(inner_id));
+
+  // The borrower stops using the object. Nothing is queued for the failed
+  // owner, so even a late request from it is held rather than answered.
+  borrower->rc_.RemoveLocalReference(inner_id, nullptr);
+  ASSERT_FALSE(borrower->rc_.HasReference(inner_id));
+  ASSERT_TRUE(borrower->FlushBorrowerCallbacks());
+  ASSERT_EQ(borrower->requests_.size(), 1);
+  ASSERT_TRUE(owner->rc_.HasReference(inner_id));
+}
+
+// A borrower is given references to many object IDs by one task. The owner
+// should wait for all of them in a single request, and the borrower should
+// report all of them in a single reply.
+//
+// @ray.remote
+// def borrower(inner_ids):
+//     pass
+//
+// inner_ids = [ray.put(i) for i in range(10)]
+// outer_id = ray.put(inner_ids)
+// res = borrower.remote(outer_id)
+TEST(DistributedReferenceCountTest, TestBatchedBorrowerRequests) {
+  auto borrower = std::make_shared<MockWorkerClient>("1");
+  auto owner = std::make_shared<MockWorkerClient>(
+      "2", [&](const rpc::Address &addr) { return borrower; });
+
+  // The owner creates the inner objects and wraps them.
+  const int num_objects = 10;
+  std::vector<ObjectID> inner_ids;
+  for (int i = 0; i < num_objects; i++) {
+    inner_ids.push_back(ObjectID::FromRandom());
+    owner->Put(inner_ids.back());
+  }
+  auto outer_id = ObjectID::FromRandom();
+  owner->rc_.AddOwnedObject(outer_id, inner_ids, owner->address_, "", 0, false);
+  owner->rc_.AddLocalReference(outer_id, "");
+
+  // The owner submits a task that depends on the outer object, and its
+  // references go out of scope.
+  owner->SubmitTaskWithArg(outer_id);
+  owner->rc_.RemoveLocalReference(outer_id, nullptr);
+  for (const auto &inner_id : inner_ids) {
+    owner->rc_.RemoveLocalReference(inner_id, nullptr);
+  }
+
+  // The borrower is given references to the inner objects, and keeps them
+  // past the task's lifetime.
+  borrower->rc_.AddLocalReference(outer_id, "");
+  for (const auto &inner_id : inner_ids) {
+    borrower->GetSerializedObjectId(outer_id, inner_id, owner->address_);
+  }
+  auto borrower_refs = borrower->FinishExecutingTask(outer_id, ObjectID::Nil());
+
+  // The owner waits for all of the inner objects in one request.
+  owner->HandleSubmittedTaskFinished(outer_id, {}, borrower->address_, borrower_refs);
+  ASSERT_FALSE(owner->rc_.HasReference(outer_id));
+  ASSERT_EQ(borrower->num_requests_, 1);
+  ASSERT_EQ(borrower->num_subscriptions_, num_objects);
+
+  // The borrower stops using all of the objects before it receives the
+  // owner's request.
+  for (const auto &inner_id : inner_ids) {
+    borrower->rc_.RemoveLocalReference(inner_id, nullptr);
+  }
+  for (const auto &inner_id : inner_ids) {
+    ASSERT_TRUE(owner->rc_.HasReference(inner_id));
+  }
+
+  // The borrower replies to the request right away, with all of the objects
+  // in one reply. The owner stops waiting on the borrower.
+  ASSERT_TRUE(borrower->FlushBorrowerCallbacks());
+  ASSERT_TRUE(borrower->requests_.empty());
+  for (const auto &inner_id : inner_ids) {
+    ASSERT_FALSE(owner->rc_.HasReference(inner_id));
+  }
+  ASSERT_EQ(borrower->num_requests_, 1);
+  ASSERT_FALSE(borrower->FlushBorrowerCallbacks());
+}
+
 // A borrower is given a reference to an object ID, passes the reference to
 // another borrower by submitting a task, and does not wait for it to finish.
 //
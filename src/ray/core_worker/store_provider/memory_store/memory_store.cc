@@ -120,40 +120,45 @@ CoreWorkerMemoryStore::CoreWorkerMemoryStore(
     : store_in_plasma_(store_in_plasma),
       ref_counter_(counter),
       raylet_client_(raylet_client),
+      max_memory_(RayConfig::instance().memory_store_max_bytes()),
+      used_memory_(0),
+      num_evicted_to_plasma_(0),
       check_signals_(check_signals) {}
 
 void CoreWorkerMemoryStore::GetAsync(
     const ObjectID &object_id, std::function<void(std::shared_ptr<RayObject>)> callback) {
   std::shared_ptr<RayObject> ptr;
-  {
-    absl::MutexLock lock(&mu_);
-    auto iter = objects_.find(object_id);
-    if (iter != objects_.end()) {
-      ptr = iter->second;
-    } else {
-      object_async_get_requests_[object_id].push_back(callback);
+  // Fast path: the object is already present.
+  if (!objects_.Get(object_id, &ptr)) {
+    auto &shard = GetWaiterShard(object_id);
+    absl::MutexLock lock(&shard.mu);
+    // Check again under the lock, since the object may have been put since.
+    if (!objects_.Get(object_id, &ptr)) {
+      shard.object_async_get_requests[object_id].push_back(callback);
     }
   }
   // It's important for performance to run the callback outside the lock.
   if (ptr != nullptr) {
+    TouchObject(object_id);
     callback(ptr);
   }
 }
 
 std::shared_ptr<RayObject> CoreWorkerMemoryStore::GetOrPromoteToPlasma(
     const ObjectID &object_id) {
-  absl::MutexLock lock(&mu_);
-  auto iter = objects_.find(object_id);
-  if (iter != objects_.end()) {
-    auto obj = iter->second;
-    if (obj->IsInPlasmaError()) {
-      return nullptr;
-    }
-    return obj;
+  std::shared_ptr<RayObject> obj;
+  if (objects_.Get(object_id, &obj)) {
+    TouchObject(object_id);
+    return obj->IsInPlasmaError() ? nullptr : obj;
+  }
+  auto &shard = GetWaiterShard(object_id);
+  absl::MutexLock lock(&shard.mu);
+  if (objects_.Get(object_id, &obj)) {
+    return obj->IsInPlasmaError() ? nullptr : obj;
   }
   RAY_CHECK(store_in_plasma_ != nullptr)
       << "Cannot promote object without plasma provider callback.";
-  promoted_to_plasma_.insert(object_id);
+  shard.promoted_to_plasma.insert(object_id);
   return nullptr;
 }
 
@@ -167,32 +172,33 @@ bool CoreWorkerMemoryStore::Put(const RayObject &object, const ObjectID &object_
   // plasma.
   bool should_put_in_plasma = false;
   {
-    absl::MutexLock lock(&mu_);
+    // Only the requests for objects in the same shard contend with us.
+    auto &shard = GetWaiterShard(object_id);
+    absl::MutexLock lock(&shard.mu);
 
-    auto iter = objects_.find(object_id);
-    if (iter != objects_.end()) {
+    if (objects_.Contains(object_id)) {
       return true;  // Object already exists in the store, which is fine.
     }
 
-    auto async_callback_it = object_async_get_requests_.find(object_id);
-    if (async_callback_it != object_async_get_requests_.end()) {
+    auto async_callback_it = shard.object_async_get_requests.find(object_id);
+    if (async_callback_it != shard.object_async_get_requests.end()) {
       auto &callbacks = async_callback_it->second;
       async_callbacks = std::move(callbacks);
-      object_async_get_requests_.erase(async_callback_it);
+      shard.object_async_get_requests.erase(async_callback_it);
     }
 
-    auto promoted_it = promoted_to_plasma_.find(object_id);
-    if (promoted_it != promoted_to_plasma_.end()) {
+    auto promoted_it = shard.promoted_to_plasma.find(object_id);
+    if (promoted_it != shard.promoted_to_plasma.end()) {
       RAY_CHECK(store_in_plasma_ != nullptr);
       // Only need to promote to plasma if it wasn't already put into plasma
       // by the task that created the object.
       should_put_in_plasma = !object.IsInPlasmaError();
-      promoted_to_plasma_.erase(promoted_it);
+      shard.promoted_to_plasma.erase(promoted_it);
     }
 
     bool should_add_entry = true;
-    auto object_request_iter = object_get_requests_.find(object_id);
-    if (object_request_iter != object_get_requests_.end()) {
+    auto object_request_iter = shard.object_get_requests.find(object_id);
+    if (object_request_iter != shard.object_get_requests.end()) {
       auto &get_requests = object_request_iter->second;
       for (auto &get_request : get_requests) {
         get_request->Set(object_id, object_entry);
@@ -209,7 +215,17 @@ bool CoreWorkerMemoryStore::Put(const RayObject &object, const ObjectID &object_
 
     if (should_add_entry) {
       // If there is no existing get request, then add the `RayObject` to map.
-      objects_.emplace(object_id, object_entry);
+      objects_.Insert(object_id, object_entry);
+      if (!object_entry->IsInPlasmaError()) {
+        used_memory_ += object_entry->GetSize();
+      }
+      // Only objects that we own can be promoted to plasma on our behalf.
+      // Errors are never promoted.
+      if (max_memory_ > 0 && store_in_plasma_ != nullptr && ref_counter_ != nullptr &&
+          !object_entry->IsException() && ref_counter_->OwnedByUs(object_id)) {
+        absl::MutexLock lru_lock(&lru_mu_);
+        lru_objects_.push_back(object_id);
+      }
     }
   }
 
@@ -226,6 +242,10 @@ bool CoreWorkerMemoryStore::Put(const RayObject &object, const ObjectID &object_
     cb(object_entry);
   }
 
+  if (max_memory_ > 0 && used_memory_.load() > max_memory_) {
+    EvictToPlasma();
+  }
+
   return stored_in_direct_memory;
 }
 
@@ -251,13 +271,12 @@ Status CoreWorkerMemoryStore::GetImpl(const std::vector<ObjectID> &object_ids,
     absl::flat_hash_set<ObjectID> remaining_ids;
     absl::flat_hash_set<ObjectID> ids_to_remove;
 
-    absl::MutexLock lock(&mu_);
     // Check for existing objects and see if this get request can be fullfilled.
+    // This only takes the reader locks of the objects' shards.
     for (size_t i = 0; i < object_ids.size() && count < num_objects; i++) {
       const auto &object_id = object_ids[i];
-      auto iter = objects_.find(object_id);
-      if (iter != objects_.end()) {
-        (*results)[i] = iter->second;
+      if (objects_.Get(object_id, &(*results)[i])) {
+        TouchObject(object_id);
         if (remove_after_get) {
           // Note that we cannot remove the object_id from `objects_` now,
           // because `object_ids` might have duplicate ids.
@@ -270,15 +289,9 @@ Status CoreWorkerMemoryStore::GetImpl(const std::vector<ObjectID> &object_ids,
     }
     RAY_CHECK(count <= num_objects);
 
-    // Clean up the objects if ref counting is off.
-    if (ref_counter_ == nullptr) {
-      for (const auto &object_id : ids_to_remove) {
-        objects_.erase(object_id);
-      }
-    }
-
     // Return if all the objects are obtained.
     if (remaining_ids.empty() || count >= num_objects) {
+      RemoveAfterGet(ids_to_remove);
       return Status::OK();
     }
 
@@ -289,8 +302,20 @@ Status CoreWorkerMemoryStore::GetImpl(const std::vector<ObjectID> &object_ids,
         std::make_shared<GetRequest>(std::move(remaining_ids), required_objects,
                                      remove_after_get, abort_if_any_object_is_exception);
     for (const auto &object_id : get_request->ObjectIds()) {
-      object_get_requests_[object_id].push_back(get_request);
+      auto &shard = GetWaiterShard(object_id);
+      absl::MutexLock lock(&shard.mu);
+      // The object may have been put after we checked for it above.
+      std::shared_ptr<RayObject> object;
+      if (objects_.Get(object_id, &object)) {
+        get_request->Set(object_id, object);
+        if (remove_after_get) {
+          ids_to_remove.insert(object_id);
+        }
+      } else {
+        shard.object_get_requests[object_id].push_back(get_request);
+      }
     }
+    RemoveAfterGet(ids_to_remove);
   }
 
   // Only send block/unblock IPCs for non-actor tasks on the main thread.
@@ -333,31 +358,31 @@ Status CoreWorkerMemoryStore::GetImpl(const std::vector<ObjectID> &object_ids,
     RAY_CHECK_OK(raylet_client_->NotifyDirectCallTaskUnblocked());
   }
 
-  {
-    absl::MutexLock lock(&mu_);
-    // Populate results.
-    for (size_t i = 0; i < object_ids.size(); i++) {
-      const auto &object_id = object_ids[i];
-      if ((*results)[i] == nullptr) {
-        (*results)[i] = get_request->Get(object_id);
+  // Remove get request.
+  for (const auto &object_id : get_request->ObjectIds()) {
+    auto &shard = GetWaiterShard(object_id);
+    absl::MutexLock lock(&shard.mu);
+    auto object_request_iter = shard.object_get_requests.find(object_id);
+    if (object_request_iter != shard.object_get_requests.end()) {
+      auto &get_requests = object_request_iter->second;
+      // Erase get_request from the vector.
+      auto it = std::find(get_requests.begin(), get_requests.end(), get_request);
+      if (it != get_requests.end()) {
+        get_requests.erase(it);
+        // If the vector is empty, remove the object ID from the map.
+        if (get_requests.empty()) {
+          shard.object_get_requests.erase(object_request_iter);
+        }
       }
     }
+  }
 
-    // Remove get request.
-    for (const auto &object_id : get_request->ObjectIds()) {
-      auto object_request_iter = object_get_requests_.find(object_id);
-      if (object_request_iter != object_get_requests_.end()) {
-        auto &get_requests = object_request_iter->second;
-        // Erase get_request from the vector.
-        auto it = std::find(get_requests.begin(), get_requests.end(), get_request);
-        if (it != get_requests.end()) {
-          get_requests.erase(it);
-          // If the vector is empty, remove the object ID from the map.
-          if (get_requests.empty()) {
-            object_get_requests_.erase(object_request_iter);
-          }
-        }
-      }
+  // Populate results. This must be done after removing the get request, so that
+  // no object can be set on the request after we read it.
+  for (size_t i = 0; i < object_ids.size(); i++) {
+    const auto &object_id = object_ids[i];
+    if ((*results)[i] == nullptr) {
+      (*results)[i] = get_request->Get(object_id);
     }
   }
 
@@ -419,31 +444,115 @@ Status CoreWorkerMemoryStore::Wait(const absl::flat_hash_set<ObjectID> &object_i
 
 void CoreWorkerMemoryStore::Delete(const absl::flat_hash_set<ObjectID> &object_ids,
                                    absl::flat_hash_set<ObjectID> *plasma_ids_to_delete) {
-  absl::MutexLock lock(&mu_);
   for (const auto &object_id : object_ids) {
-    auto it = objects_.find(object_id);
-    if (it != objects_.end()) {
-      if (it->second->IsInPlasmaError()) {
+    absl::MutexLock lock(&GetWaiterShard(object_id).mu);
+    std::shared_ptr<RayObject> obj;
+    if (objects_.Get(object_id, &obj)) {
+      if (obj->IsInPlasmaError()) {
         plasma_ids_to_delete->insert(object_id);
       } else {
-        objects_.erase(it);
+        EraseObject(object_id);
       }
     }
   }
 }
 
 void CoreWorkerMemoryStore::Delete(const std::vector<ObjectID> &object_ids) {
-  absl::MutexLock lock(&mu_);
   for (const auto &object_id : object_ids) {
-    objects_.erase(object_id);
+    absl::MutexLock lock(&GetWaiterShard(object_id).mu);
+    EraseObject(object_id);
   }
 }
 
+void CoreWorkerMemoryStore::RemoveAfterGet(const absl::flat_hash_set<ObjectID> &object_ids) {
+  // Clean up the objects if ref counting is off.
+  if (ref_counter_ != nullptr) {
+    return;
+  }
+  for (const auto &object_id : object_ids) {
+    absl::MutexLock lock(&GetWaiterShard(object_id).mu);
+    EraseObject(object_id);
+  }
+}
+
+void CoreWorkerMemoryStore::EraseObject(const ObjectID &object_id) {
+  std::shared_ptr<RayObject> obj;
+  if (!objects_.Erase(object_id, &obj)) {
+    return;
+  }
+  if (!obj->IsInPlasmaError()) {
+    used_memory_ -= obj->GetSize();
+  }
+  if (max_memory_ > 0) {
+    absl::MutexLock lru_lock(&lru_mu_);
+    if (lru_objects_.count(object_id)) {
+      lru_objects_.erase(object_id);
+    }
+  }
+}
+
+void CoreWorkerMemoryStore::TouchObject(const ObjectID &object_id) {
+  if (max_memory_ <= 0 || !lru_mu_.TryLock()) {
+    return;
+  }
+  if (lru_objects_.count(object_id)) {
+    lru_objects_.erase(object_id);
+    lru_objects_.push_back(object_id);
+  }
+  lru_mu_.Unlock();
+}
+
+void CoreWorkerMemoryStore::EvictToPlasma() {
+  std::vector<std::pair<ObjectID, std::shared_ptr<RayObject>>> to_evict;
+  {
+    absl::MutexLock lru_lock(&lru_mu_);
+    if (evicting_) {
+      // Another thread is already promoting objects.
+      return;
+    }
+    int64_t bytes_to_evict = used_memory_.load() - max_memory_;
+    while (bytes_to_evict > 0 && lru_objects_.size() > 0) {
+      const ObjectID object_id = lru_objects_.front();
+      lru_objects_.pop_front();
+      std::shared_ptr<RayObject> obj;
+      if (objects_.Get(object_id, &obj) && !obj->IsInPlasmaError()) {
+        bytes_to_evict -= obj->GetSize();
+        to_evict.emplace_back(object_id, std::move(obj));
+      }
+    }
+    if (to_evict.empty()) {
+      return;
+    }
+    evicting_ = true;
+  }
+
+  // Must be called without holding the locks, see `Put`.
+  for (const auto &entry : to_evict) {
+    const auto &object_id = entry.first;
+    RAY_LOG(DEBUG) << "Promoting object " << object_id
+                   << " to plasma, memory store usage " << used_memory_.load() << "/"
+                   << max_memory_ << " bytes";
+    store_in_plasma_(*entry.second, object_id);
+    // Reads now go to plasma. If the object was deleted in the meantime, the
+    // plasma copy is unpinned once the raylet finds it out of scope.
+    absl::MutexLock lock(&GetWaiterShard(object_id).mu);
+    std::shared_ptr<RayObject> obj;
+    if (objects_.Get(object_id, &obj) && obj == entry.second) {
+      objects_.InsertOrAssign(
+          object_id, std::make_shared<RayObject>(rpc::ErrorType::OBJECT_IN_PLASMA));
+      used_memory_ -= obj->GetSize();
+      num_evicted_to_plasma_++;
+    }
+  }
+
+  absl::MutexLock lru_lock(&lru_mu_);
+  evicting_ = false;
+}
+
 bool CoreWorkerMemoryStore::Contains(const ObjectID &object_id, bool *in_plasma) {
-  absl::MutexLock lock(&mu_);
-  auto it = objects_.find(object_id);
-  if (it != objects_.end()) {
-    if (it->second->IsInPlasmaError()) {
+  std::shared_ptr<RayObject> obj;
+  if (objects_.Get(object_id, &obj)) {
+    if (obj->IsInPlasmaError()) {
       *in_plasma = true;
     }
     return true;
@@ -452,16 +561,18 @@ bool CoreWorkerMemoryStore::Contains(const ObjectID &object_id, bool *in_plasma)
 }
 
 MemoryStoreStats CoreWorkerMemoryStore::GetMemoryStoreStatisticalData() {
-  absl::MutexLock lock(&mu_);
   MemoryStoreStats item;
-  for (const auto &it : objects_) {
-    if (it.second->IsInPlasmaError()) {
-      item.num_in_plasma += 1;
-    } else {
-      item.num_local_objects += 1;
-      item.used_object_store_memory += it.second->GetSize();
-    }
-  }
+  objects_.ForEach(
+      [&item](const ObjectID &object_id, const std::shared_ptr<RayObject> &obj) {
+        if (obj->IsInPlasmaError()) {
+          item.num_in_plasma += 1;
+        } else {
+          item.num_local_objects += 1;
+          item.used_object_store_memory += obj->GetSize();
+        }
+      });
+  item.max_memory = max_memory_;
+  item.num_evicted_to_plasma = num_evicted_to_plasma_.load();
   return item;
 }
 
@@ -1,5 +1,8 @@
 #pragma once
 
+#include <array>
+#include <atomic>
+
 #include "absl/container/flat_hash_map.h"
 #include "absl/container/flat_hash_set.h"
 #include "absl/synchronization/mutex.h"
@@ -8,6 +11,8 @@
 #include "ray/core_worker/common.h"
 #include "ray/core_worker/context.h"
 #include "ray/core_worker/reference_count.h"
+#include "ray/util/ordered_set.h"
+#include "ray/util/sharded_map.h"
 
 namespace ray {
 
@@ -15,6 +20,10 @@ struct MemoryStoreStats {
   int32_t num_in_plasma = 0;
   int32_t num_local_objects = 0;
   int64_t used_object_store_memory = 0;
+  /// The byte budget of the store, or 0 if it is unbounded.
+  int64_t max_memory = 0;
+  /// The number of objects that were promoted to plasma to stay within the budget.
+  int64_t num_evicted_to_plasma = 0;
 };
 
 class GetRequest;
@@ -119,10 +128,7 @@ class CoreWorkerMemoryStore {
   /// Returns the number of objects in this store.
   ///
   /// \return Count of objects in the store.
-  int Size() {
-    absl::MutexLock lock(&mu_);
-    return objects_.size();
-  }
+  int Size() { return objects_.Size(); }
 
   /// Returns stats data of memory usage.
   ///
@@ -132,7 +138,7 @@ class CoreWorkerMemoryStore {
   /// Returns the memory usage of this store.
   ///
   /// \return Total size of objects in the store.
-  uint64_t UsedMemory();
+  uint64_t UsedMemory() const { return used_memory_.load(); }
 
  private:
   /// See the public version of `Get` for meaning of the other arguments.
@@ -143,6 +149,23 @@ class CoreWorkerMemoryStore {
                  std::vector<std::shared_ptr<RayObject>> *results,
                  bool abort_if_any_object_is_exception);
 
+  /// Remove objects that were returned by a `Get` with `remove_after_get` set.
+  /// This has no effect if ref counting is enabled.
+  void RemoveAfterGet(const absl::flat_hash_set<ObjectID> &object_ids);
+
+  /// Erase an object from `objects_`. The lock of the object's waiter shard
+  /// must be held.
+  void EraseObject(const ObjectID &object_id);
+
+  /// Mark an object as recently used. This is best-effort: the object is not
+  /// moved if another thread holds the LRU lock, so that reads never block on it.
+  void TouchObject(const ObjectID &object_id);
+
+  /// Promote the least recently used objects to plasma until the store is
+  /// within its byte budget. Each promoted object is replaced by an
+  /// OBJECT_IN_PLASMA entry, so later reads go to plasma instead.
+  void EvictToPlasma();
+
   /// Optional callback for putting objects into the plasma store.
   std::function<void(const RayObject &, const ObjectID &)> store_in_plasma_;
 
@@ -153,23 +176,62 @@ class CoreWorkerMemoryStore {
   // If set, this will be used to notify worker blocked / unblocked on get calls.
   std::shared_ptr<raylet::RayletClient> raylet_client_ = nullptr;
 
-  /// Protects the data structures below.
-  mutable absl::Mutex mu_;
+  /// The requests waiting for the objects of one shard of `objects_`.
+  struct WaiterShard {
+    /// Protects the data structures below. Insertions into and removals from
+    /// the shard's objects in `objects_` are also done while holding it, so
+    /// that a reader that misses there and then takes it to register a get
+    /// request cannot miss a concurrent `Put`.
+    absl::Mutex mu;
+
+    /// Set of objects that should be promoted to plasma once available.
+    absl::flat_hash_set<ObjectID> promoted_to_plasma GUARDED_BY(mu);
+
+    /// Map from object ID to its get requests.
+    absl::flat_hash_map<ObjectID, std::vector<std::shared_ptr<GetRequest>>>
+        object_get_requests GUARDED_BY(mu);
+
+    /// Map from object ID to its async get requests.
+    absl::flat_hash_map<ObjectID,
+                        std::vector<std::function<void(std::shared_ptr<RayObject>)>>>
+        object_async_get_requests GUARDED_BY(mu);
+  };
+
+  using ObjectMap = ShardedMap<ObjectID, std::shared_ptr<RayObject>>;
+
+  /// Return the waiter shard of an object.
+  WaiterShard &GetWaiterShard(const ObjectID &object_id) {
+    return waiter_shards_[ObjectMap::ShardIndex(object_id)];
+  }
+
+  /// Map from object ID to `RayObject`. The map is internally sharded and
+  /// locked, so lookups of present objects only take a shard's reader lock.
+  ObjectMap objects_;
+
+  /// The waiters of each shard of `objects_`. A `Put` only takes the lock of
+  /// the object's shard and only wakes up the requests for that object.
+  std::array<WaiterShard, ObjectMap::NumShards()> waiter_shards_;
+
+  /// The maximum number of bytes of object values to keep in the store before
+  /// promoting objects to plasma, or 0 if the store is unbounded.
+  const int64_t max_memory_;
+
+  /// The total size of the object values in `objects_`, not counting the
+  /// OBJECT_IN_PLASMA entries.
+  std::atomic<int64_t> used_memory_;
 
-  /// Set of objects that should be promoted to plasma once available.
-  absl::flat_hash_set<ObjectID> promoted_to_plasma_ GUARDED_BY(mu_);
+  /// Protects the LRU state below. Acquired after a waiter shard's lock.
+  absl::Mutex lru_mu_;
 
-  /// Map from object ID to `RayObject`.
-  absl::flat_hash_map<ObjectID, std::shared_ptr<RayObject>> objects_ GUARDED_BY(mu_);
+  /// The objects that may be promoted to plasma, least recently used first.
+  /// Only maintained if the store is bounded.
+  ordered_set<ObjectID> lru_objects_ GUARDED_BY(lru_mu_);
 
-  /// Map from object ID to its get requests.
-  absl::flat_hash_map<ObjectID, std::vector<std::shared_ptr<GetRequest>>>
-      object_get_requests_ GUARDED_BY(mu_);
+  /// Whether a thread is promoting objects to plasma.
+  bool evicting_ GUARDED_BY(lru_mu_) = false;
 
-  /// Map from object ID to its async get requests.
-  absl::flat_hash_map<ObjectID,
-                      std::vector<std::function<void(std::shared_ptr<RayObject>)>>>
-      object_async_get_requests_ GUARDED_BY(mu_);
+  /// The number of objects promoted to plasma to stay within the budget.
+  std::atomic<int64_t> num_evicted_to_plasma_;
 
   /// Function passed in to be called to check for signals (e.g., Ctrl-C).
   std::function<Status()> check_signals_;
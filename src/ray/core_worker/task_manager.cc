@@ -59,7 +59,7 @@ void TaskManager::AddPendingTask(const rpc::Address &caller_address,
     for (size_t i = 0; i < num_returns; i++) {
       // We pass an empty vector for inner IDs because we do not know the return
       // value of the task yet. If the task returns an ID(s), the worker will
-      // notify us via the WaitForRefRemoved RPC that we are now a borrower for
+      // notify us via the WaitForRefsRemoved RPC that we are now a borrower for
       // the inner IDs. Note that this RPC can be received *before* the
       // PushTaskReply.
       reference_counter_->AddOwnedObject(spec.ReturnId(i),
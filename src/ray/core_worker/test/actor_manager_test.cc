@@ -56,8 +56,25 @@ class MockActorInfoAccessor : public gcs::ServiceBasedActorInfoAccessor {
     return callback_map_.find(actor_id) != callback_map_.end();
   }
 
+  ray::Status AsyncRegisterActors(const std::vector<TaskSpecification> &task_specs,
+                                  const gcs::MultiItemCallback<Status> &callback) {
+    register_batch_sizes_.push_back(task_specs.size());
+    callback(Status::OK(), std::vector<Status>(task_specs.size()));
+    return Status::OK();
+  }
+
+  ray::Status AsyncCreateActors(const std::vector<TaskSpecification> &task_specs,
+                                const gcs::MultiItemCallback<Status> &callback) {
+    create_batch_sizes_.push_back(task_specs.size());
+    create_callbacks_.push_back(callback);
+    return Status::OK();
+  }
+
   absl::flat_hash_map<ActorID, gcs::SubscribeCallback<ActorID, rpc::ActorTableData>>
       callback_map_;
+  std::vector<size_t> register_batch_sizes_;
+  std::vector<size_t> create_batch_sizes_;
+  std::vector<gcs::MultiItemCallback<Status>> create_callbacks_;
 };
 
 class MockGcsClient : public gcs::ServiceBasedGcsClient {
@@ -73,7 +90,9 @@ class MockDirectActorSubmitter : public CoreWorkerDirectActorTaskSubmitterInterf
  public:
   MockDirectActorSubmitter() : CoreWorkerDirectActorTaskSubmitterInterface() {}
 
-  MOCK_METHOD1(AddActorQueueIfNotExists, void(const ActorID &actor_id));
+  MOCK_METHOD3(AddActorQueueIfNotExists,
+               void(const ActorID &actor_id, bool allow_out_of_order_execution,
+                    bool executes_tasks_concurrently));
   MOCK_METHOD3(ConnectActor, void(const ActorID &actor_id, const rpc::Address &address,
                                   int64_t num_restarts));
   MOCK_METHOD3(DisconnectActor,
@@ -284,6 +303,42 @@ TEST_F(ActorManagerTest, TestActorStateNotificationAlive) {
       actor_info_accessor_->ActorStateNotificationPublished(actor_id, actor_table_data));
 }
 
+TEST_F(ActorManagerTest, TestActorCreationsAreBatched) {
+  boost::asio::io_service io_service;
+  DefaultActorCreator actor_creator(gcs_client_mock_, io_service,
+                                    /*max_actors_per_batch=*/2);
+  std::vector<Status> statuses(3, Status::OK());
+  for (int i = 0; i < 3; i++) {
+    TaskSpecification task_spec(rpc::TaskSpec{});
+    auto callback = [&statuses, i](Status status) { statuses[i] = status; };
+    ASSERT_TRUE(actor_creator.AsyncCreateActor(task_spec, callback).ok());
+  }
+  // The creations are sent once the io service runs, in batches of at most two actors.
+  ASSERT_TRUE(actor_info_accessor_->create_batch_sizes_.empty());
+  io_service.run();
+  ASSERT_THAT(actor_info_accessor_->create_batch_sizes_, testing::ElementsAre(2, 1));
+
+  // Each actor gets its own status, or the status of the batch if the reply has none.
+  actor_info_accessor_->create_callbacks_[0](Status::Invalid(""),
+                                             {Status::OK(), Status::Invalid("")});
+  actor_info_accessor_->create_callbacks_[1](Status::IOError(""), {});
+  ASSERT_TRUE(statuses[0].ok());
+  ASSERT_TRUE(statuses[1].IsInvalid());
+  ASSERT_TRUE(statuses[2].IsIOError());
+}
+
+TEST_F(ActorManagerTest, TestRegisterActorWaitsForBatch) {
+  boost::asio::io_service io_service;
+  boost::asio::io_service::work work(io_service);
+  std::thread io_thread([&io_service]() { io_service.run(); });
+  DefaultActorCreator actor_creator(gcs_client_mock_, io_service);
+  ASSERT_TRUE(actor_creator.RegisterActor(TaskSpecification(rpc::TaskSpec())).ok());
+  ASSERT_TRUE(actor_creator.RegisterActor(TaskSpecification(rpc::TaskSpec())).ok());
+  io_service.stop();
+  io_thread.join();
+  ASSERT_THAT(actor_info_accessor_->register_batch_sizes_, testing::ElementsAre(1, 1));
+}
+
 }  // namespace ray
 
 int main(int argc, char **argv) {
@@ -26,6 +26,7 @@ namespace ray {
 using ::testing::_;
 using ::testing::ElementsAre;
 using ::testing::Return;
+using ::testing::SaveArg;
 
 TaskSpecification CreateActorTaskHelper(ActorID actor_id, WorkerID caller_worker_id,
                                         int64_t counter,
@@ -65,6 +66,15 @@ class MockWorkerClient : public rpc::CoreWorkerClientInterface {
     callbacks.push_back(callback);
   }
 
+  void PushActorTasks(std::unique_ptr<rpc::PushTasksRequest> request,
+                      const rpc::ClientCallback<rpc::PushTasksReply> &callback) override {
+    for (const auto &task_request : request->requests()) {
+      received_seq_nos.push_back(task_request.sequence_number());
+    }
+    batch_sizes.push_back(request->requests_size());
+    batch_callbacks.push_back(callback);
+  }
+
   bool ReplyPushTask(Status status = Status::OK(), size_t index = 0) {
     if (callbacks.size() == 0) {
       return false;
@@ -75,8 +85,29 @@ class MockWorkerClient : public rpc::CoreWorkerClientInterface {
     return true;
   }
 
+  bool ReplyPushTasks() {
+    if (batch_callbacks.size() == 0) {
+      return false;
+    }
+    rpc::PushTasksReply reply;
+    for (int i = 0; i < batch_sizes.front(); i++) {
+      reply.add_replies();
+      reply.add_task_failed(false);
+      reply.add_error_messages("");
+      reply.add_task_cancelled(false);
+    }
+    auto callback = batch_callbacks.front();
+    batch_callbacks.erase(batch_callbacks.begin());
+    batch_sizes.erase(batch_sizes.begin());
+    callback(Status::OK(), reply);
+    return true;
+  }
+
   rpc::Address addr;
   std::vector<rpc::ClientCallback<rpc::PushTaskReply>> callbacks;
+  std::vector<rpc::ClientCallback<rpc::PushTasksReply>> batch_callbacks;
+  /// The number of tasks in each batch that has not been replied to yet.
+  std::vector<int> batch_sizes;
   std::vector<uint64_t> received_seq_nos;
 };
 
@@ -459,6 +490,156 @@ TEST_F(DirectActorSubmitterTest, TestActorRestartOutOfOrderGcs) {
   ASSERT_TRUE(submitter_.SubmitTask(task).ok());
 }
 
+TEST_F(DirectActorSubmitterTest, TestOutOfOrderActor) {
+  rpc::Address addr;
+  auto worker_id = WorkerID::FromRandom();
+  addr.set_worker_id(worker_id.Binary());
+  ActorID actor_id = ActorID::Of(JobID::FromInt(0), TaskID::Nil(), 0);
+  submitter_.AddActorQueueIfNotExists(actor_id, /*allow_out_of_order_execution=*/true);
+  submitter_.ConnectActor(actor_id, addr, 0);
+
+  ObjectID obj1 = ObjectID::FromRandom();
+  auto task1 = CreateActorTaskHelper(actor_id, worker_id, 0);
+  task1.GetMutableMessage().add_args()->mutable_object_ref()->set_object_id(
+      obj1.Binary());
+  auto task2 = CreateActorTaskHelper(actor_id, worker_id, 1);
+  ASSERT_TRUE(submitter_.SubmitTask(task1).ok());
+  ASSERT_TRUE(submitter_.SubmitTask(task2).ok());
+  // The second task does not wait for the dependencies of the first one.
+  ASSERT_THAT(worker_client_->received_seq_nos, ElementsAre(1));
+
+  auto data = GenerateRandomObject();
+  ASSERT_TRUE(store_->Put(*data, obj1));
+  ASSERT_THAT(worker_client_->received_seq_nos, ElementsAre(1, 0));
+
+  EXPECT_CALL(*task_finisher_, CompletePendingTask(_, _, _)).Times(2);
+  EXPECT_CALL(*task_finisher_, PendingTaskFailed(_, _, _)).Times(0);
+  // The replies may come back in any order.
+  ASSERT_TRUE(worker_client_->ReplyPushTask(Status::OK(), /*index=*/1));
+  ASSERT_TRUE(worker_client_->ReplyPushTask(Status::OK(), /*index=*/0));
+}
+
+TEST_F(DirectActorSubmitterTest, TestBatchedPushes) {
+  CoreWorkerDirectActorTaskSubmitter submitter(
+      std::make_shared<rpc::CoreWorkerClientPool>(
+          [&](const rpc::Address &addr) { return worker_client_; }),
+      store_, task_finisher_, /*max_tasks_per_push_batch=*/3);
+  rpc::Address addr;
+  auto worker_id = WorkerID::FromRandom();
+  addr.set_worker_id(worker_id.Binary());
+  ActorID actor_id = ActorID::Of(JobID::FromInt(0), TaskID::Nil(), 0);
+  submitter.AddActorQueueIfNotExists(actor_id);
+  submitter.ConnectActor(actor_id, addr, 0);
+  EXPECT_CALL(*task_finisher_, CompletePendingTask(_, _, _)).Times(6);
+  EXPECT_CALL(*task_finisher_, PendingTaskFailed(_, _, _)).Times(0);
+
+  // Tasks are pushed one at a time until the duration of a push is known.
+  ASSERT_TRUE(submitter.SubmitTask(CreateActorTaskHelper(actor_id, worker_id, 0)).ok());
+  ASSERT_TRUE(submitter.SubmitTask(CreateActorTaskHelper(actor_id, worker_id, 1)).ok());
+  ASSERT_EQ(worker_client_->callbacks.size(), 2);
+  ASSERT_TRUE(worker_client_->ReplyPushTask());
+  ASSERT_TRUE(worker_client_->ReplyPushTask());
+
+  // A task is pushed right away if nothing is in flight. The tasks submitted while
+  // it is in flight are held back, and pushed together once it is done.
+  ASSERT_TRUE(submitter.SubmitTask(CreateActorTaskHelper(actor_id, worker_id, 2)).ok());
+  ASSERT_TRUE(submitter.SubmitTask(CreateActorTaskHelper(actor_id, worker_id, 3)).ok());
+  ASSERT_TRUE(submitter.SubmitTask(CreateActorTaskHelper(actor_id, worker_id, 4)).ok());
+  ASSERT_EQ(worker_client_->callbacks.size(), 1);
+  ASSERT_TRUE(worker_client_->batch_callbacks.empty());
+  ASSERT_TRUE(worker_client_->ReplyPushTask());
+  ASSERT_THAT(worker_client_->batch_sizes, ElementsAre(2));
+
+  // The next task waits for the batch in flight.
+  ASSERT_TRUE(submitter.SubmitTask(CreateActorTaskHelper(actor_id, worker_id, 5)).ok());
+  ASSERT_TRUE(worker_client_->callbacks.empty());
+  ASSERT_TRUE(worker_client_->ReplyPushTasks());
+  ASSERT_TRUE(worker_client_->ReplyPushTask());
+  ASSERT_TRUE(worker_client_->callbacks.empty());
+  ASSERT_TRUE(worker_client_->batch_callbacks.empty());
+  ASSERT_THAT(worker_client_->received_seq_nos, ElementsAre(0, 1, 2, 3, 4, 5));
+}
+
+TEST_F(DirectActorSubmitterTest, TestBatchedPushesToConcurrentActor) {
+  CoreWorkerDirectActorTaskSubmitter submitter(
+      std::make_shared<rpc::CoreWorkerClientPool>(
+          [&](const rpc::Address &addr) { return worker_client_; }),
+      store_, task_finisher_, /*max_tasks_per_push_batch=*/3);
+  rpc::Address addr;
+  auto worker_id = WorkerID::FromRandom();
+  addr.set_worker_id(worker_id.Binary());
+  ActorID actor_id = ActorID::Of(JobID::FromInt(0), TaskID::Nil(), 0);
+  submitter.AddActorQueueIfNotExists(actor_id, /*allow_out_of_order_execution=*/false,
+                                     /*executes_tasks_concurrently=*/true);
+  submitter.ConnectActor(actor_id, addr, 0);
+  EXPECT_CALL(*task_finisher_, CompletePendingTask(_, _, _)).Times(5);
+  EXPECT_CALL(*task_finisher_, PendingTaskFailed(_, _, _)).Times(0);
+
+  // Learn the duration of a push, so that the tasks would be batched.
+  ASSERT_TRUE(submitter.SubmitTask(CreateActorTaskHelper(actor_id, worker_id, 0)).ok());
+  ASSERT_TRUE(submitter.SubmitTask(CreateActorTaskHelper(actor_id, worker_id, 1)).ok());
+  ASSERT_TRUE(worker_client_->ReplyPushTask());
+  ASSERT_TRUE(worker_client_->ReplyPushTask());
+
+  // The next call blocks on the actor until a later call runs, e.g. it waits on an
+  // event that the later call sets. The later calls are pushed while it is in
+  // flight, instead of being held back for a batch.
+  ASSERT_TRUE(submitter.SubmitTask(CreateActorTaskHelper(actor_id, worker_id, 2)).ok());
+  ASSERT_TRUE(submitter.SubmitTask(CreateActorTaskHelper(actor_id, worker_id, 3)).ok());
+  ASSERT_TRUE(submitter.SubmitTask(CreateActorTaskHelper(actor_id, worker_id, 4)).ok());
+  ASSERT_EQ(worker_client_->callbacks.size(), 3);
+  ASSERT_TRUE(worker_client_->batch_callbacks.empty());
+
+  // The later calls finish first, and then the blocked call.
+  ASSERT_TRUE(worker_client_->ReplyPushTask(Status::OK(), 2));
+  ASSERT_TRUE(worker_client_->ReplyPushTask(Status::OK(), 1));
+  ASSERT_TRUE(worker_client_->ReplyPushTask(Status::OK(), 0));
+  ASSERT_TRUE(worker_client_->callbacks.empty());
+  ASSERT_TRUE(worker_client_->batch_callbacks.empty());
+  ASSERT_THAT(worker_client_->received_seq_nos, ElementsAre(0, 1, 2, 3, 4));
+}
+
+// Count the RPCs that it takes to push many short actor calls, with and without
+// batching. The actor replies to the pushes in flight after every few calls. Run it
+// with --gtest_also_run_disabled_tests.
+TEST_F(DirectActorSubmitterTest, DISABLED_BenchmarkActorCalls) {
+  const int num_tasks = 100 * 1000;
+  const int calls_per_reply = 8;
+  EXPECT_CALL(*task_finisher_, CompletePendingTask(_, _, _)).Times(2 * num_tasks);
+  for (uint32_t max_batch_size : {1, 16}) {
+    auto worker_client = std::make_shared<MockWorkerClient>();
+    CoreWorkerDirectActorTaskSubmitter submitter(
+        std::make_shared<rpc::CoreWorkerClientPool>(
+            [&](const rpc::Address &addr) { return worker_client; }),
+        store_, task_finisher_, max_batch_size);
+    rpc::Address addr;
+    auto worker_id = WorkerID::FromRandom();
+    addr.set_worker_id(worker_id.Binary());
+    ActorID actor_id = ActorID::Of(JobID::FromInt(0), TaskID::Nil(), 0);
+    submitter.AddActorQueueIfNotExists(actor_id);
+    submitter.ConnectActor(actor_id, addr, 0);
+
+    int num_rpcs = 0;
+    auto reply_all = [&]() {
+      while (worker_client->ReplyPushTask() || worker_client->ReplyPushTasks()) {
+        num_rpcs++;
+      }
+    };
+    int64_t start = current_time_ms();
+    for (int i = 0; i < num_tasks; i++) {
+      auto task = CreateActorTaskHelper(actor_id, worker_id, i);
+      ASSERT_TRUE(submitter.SubmitTask(task).ok());
+      if (i % calls_per_reply == calls_per_reply - 1) {
+        reply_all();
+      }
+    }
+    reply_all();
+    RAY_LOG(INFO) << "Max batch size " << max_batch_size << ": " << num_rpcs
+                  << " RPCs for " << num_tasks << " actor calls in "
+                  << current_time_ms() - start << "ms";
+  }
+}
+
 class MockDependencyWaiter : public DependencyWaiter {
  public:
   MOCK_METHOD2(Wait, void(const std::vector<rpc::ObjectReference> &dependencies,
@@ -473,6 +654,8 @@ class MockWorkerContext : public WorkerContext {
       : WorkerContext(worker_type, WorkerID::FromRandom(), job_id) {
     current_actor_is_direct_call_ = true;
   }
+
+  void AllowOutOfOrderExecution() { current_actor_allows_out_of_order_execution_ = true; }
 };
 
 class DirectActorReceiverTest : public ::testing::Test {
@@ -496,6 +679,9 @@ class DirectActorReceiverTest : public ::testing::Test {
                          const std::shared_ptr<ResourceMappingType> &resource_ids,
                          std::vector<std::shared_ptr<RayObject>> *return_objects,
                          ReferenceCounter::ReferenceTableProto *borrowed_refs) {
+    if (num_tasks_executed_++ == fail_task_index_) {
+      return Status::IOError("task failed");
+    }
     return Status::OK();
   }
 
@@ -508,14 +694,21 @@ class DirectActorReceiverTest : public ::testing::Test {
     main_io_service_.stop();
   }
 
+  void AllowOutOfOrderExecution() { worker_context_.AllowOutOfOrderExecution(); }
+
+  MockDependencyWaiter &dependency_waiter() { return *dependency_waiter_; }
+
   std::unique_ptr<CoreWorkerDirectTaskReceiver> receiver_;
+  int num_tasks_executed_ = 0;
+  /// The index of the executed task that should fail, or -1 if none.
+  int fail_task_index_ = -1;
 
  private:
   rpc::Address rpc_address_;
   MockWorkerContext worker_context_;
   boost::asio::io_service main_io_service_;
   std::shared_ptr<MockWorkerClient> worker_client_;
-  std::shared_ptr<DependencyWaiter> dependency_waiter_;
+  std::shared_ptr<MockDependencyWaiter> dependency_waiter_;
 };
 
 TEST_F(DirectActorReceiverTest, TestNewTaskFromDifferentWorker) {
@@ -602,6 +795,128 @@ TEST_F(DirectActorReceiverTest, TestNewTaskFromDifferentWorker) {
   StopIOService();
 }
 
+rpc::PushTasksRequest CreatePushTasksRequestHelper(int num_tasks) {
+  rpc::PushTasksRequest request;
+  for (int i = 0; i < num_tasks; i++) {
+    auto task_request = request.add_requests();
+    task_request->mutable_task_spec()->set_task_id(TaskID::ForFakeTask().Binary());
+    task_request->mutable_task_spec()->set_type(TaskType::NORMAL_TASK);
+    task_request->mutable_task_spec()->set_num_returns(0);
+    task_request->set_sequence_number(-1);
+    task_request->set_client_processed_up_to(-1);
+  }
+  return request;
+}
+
+TEST_F(DirectActorReceiverTest, TestHandleTasks) {
+  auto request = CreatePushTasksRequestHelper(3);
+  rpc::PushTasksReply reply;
+  int callback_count = 0;
+  receiver_->HandleTasks(request, &reply,
+                         [&callback_count](Status status, std::function<void()> success,
+                                           std::function<void()> failure) {
+                           ++callback_count;
+                           ASSERT_TRUE(status.ok());
+                         });
+  // The batch is replied to once all the tasks are done.
+  ASSERT_EQ(callback_count, 0);
+  receiver_->RunNormalTasksFromQueue();
+  ASSERT_EQ(callback_count, 1);
+  ASSERT_EQ(num_tasks_executed_, 3);
+  ASSERT_EQ(reply.replies_size(), 3);
+  ASSERT_THAT(reply.task_failed(), ElementsAre(false, false, false));
+  StopIOService();
+}
+
+TEST_F(DirectActorReceiverTest, TestHandleTasksFailure) {
+  fail_task_index_ = 1;
+  auto request = CreatePushTasksRequestHelper(3);
+  rpc::PushTasksReply reply;
+  int callback_count = 0;
+  receiver_->HandleTasks(request, &reply,
+                         [&callback_count](Status status, std::function<void()> success,
+                                           std::function<void()> failure) {
+                           ++callback_count;
+                           ASSERT_TRUE(status.ok());
+                         });
+  receiver_->RunNormalTasksFromQueue();
+  // The second task fails, so the third one is cancelled instead of running. The
+  // reply has a result for every task.
+  ASSERT_EQ(callback_count, 1);
+  ASSERT_EQ(num_tasks_executed_, 2);
+  ASSERT_EQ(reply.replies_size(), 3);
+  ASSERT_THAT(reply.task_failed(), ElementsAre(false, true, true));
+  ASSERT_THAT(reply.task_cancelled(), ElementsAre(false, false, true));
+  ASSERT_EQ(reply.error_messages(0), "");
+  ASSERT_NE(reply.error_messages(1), "");
+  StopIOService();
+}
+
+TEST_F(DirectActorReceiverTest, TestHandleActorTasks) {
+  ActorID actor_id = ActorID::Of(JobID::FromInt(0), TaskID::Nil(), 0);
+  WorkerID worker_id = WorkerID::FromRandom();
+  TaskID caller_id = TaskID::ForActorTask(JobID::FromInt(0), TaskID::Nil(), 0, actor_id);
+  rpc::PushTasksRequest request;
+  for (int i = 0; i < 3; i++) {
+    request.add_requests()->CopyFrom(CreatePushTaskRequestHelper(
+        actor_id, i, worker_id, caller_id, current_sys_time_ms()));
+  }
+  rpc::PushTasksReply reply;
+  int callback_count = 0;
+  receiver_->HandleTasks(request, &reply,
+                         [&callback_count](Status status, std::function<void()> success,
+                                           std::function<void()> failure) {
+                           ++callback_count;
+                           ASSERT_TRUE(status.ok());
+                         });
+  // A sequential actor runs the tasks as they arrive, and the batch is replied to
+  // once all of them are done.
+  ASSERT_EQ(callback_count, 1);
+  ASSERT_EQ(num_tasks_executed_, 3);
+  ASSERT_EQ(reply.replies_size(), 3);
+  ASSERT_THAT(reply.task_failed(), ElementsAre(false, false, false));
+  StopIOService();
+}
+
+TEST_F(DirectActorReceiverTest, TestHandleOutOfOrderActorTasksFailure) {
+  AllowOutOfOrderExecution();
+  fail_task_index_ = 1;
+  ActorID actor_id = ActorID::Of(JobID::FromInt(0), TaskID::Nil(), 0);
+  WorkerID worker_id = WorkerID::FromRandom();
+  TaskID caller_id = TaskID::ForActorTask(JobID::FromInt(0), TaskID::Nil(), 0, actor_id);
+  rpc::PushTasksRequest request;
+  for (int i = 0; i < 3; i++) {
+    request.add_requests()->CopyFrom(CreatePushTaskRequestHelper(
+        actor_id, i, worker_id, caller_id, current_sys_time_ms()));
+  }
+  // The first task waits for an argument, so the other two run before it.
+  auto arg = request.mutable_requests(0)->mutable_task_spec()->add_args();
+  arg->mutable_object_ref()->set_object_id(ObjectID::FromRandom().Binary());
+  std::function<void()> on_dependencies_available;
+  EXPECT_CALL(dependency_waiter(), Wait(_, _))
+      .WillOnce(SaveArg<1>(&on_dependencies_available));
+  rpc::PushTasksReply reply;
+  int callback_count = 0;
+  receiver_->HandleTasks(request, &reply,
+                         [&callback_count](Status status, std::function<void()> success,
+                                           std::function<void()> failure) {
+                           ++callback_count;
+                           ASSERT_TRUE(status.ok());
+                         });
+  // The third task fails after the second one finished. The first task has not
+  // started yet, so it is cancelled, and the reply has a result for each task rather
+  // than for the tasks before the failed one.
+  ASSERT_EQ(callback_count, 1);
+  ASSERT_EQ(num_tasks_executed_, 2);
+  ASSERT_THAT(reply.task_failed(), ElementsAre(true, false, true));
+  ASSERT_THAT(reply.task_cancelled(), ElementsAre(true, false, false));
+  // The cancelled task does not run once its argument is available.
+  on_dependencies_available();
+  ASSERT_EQ(num_tasks_executed_, 2);
+  ASSERT_EQ(callback_count, 1);
+  StopIOService();
+}
+
 }  // namespace ray
 
 int main(int argc, char **argv) {
@@ -14,6 +14,8 @@
 
 #include "ray/core_worker/transport/direct_task_transport.h"
 
+#include <thread>
+
 #include "gtest/gtest.h"
 #include "ray/common/task/task_spec.h"
 #include "ray/common/task/task_util.h"
@@ -50,12 +52,41 @@ class MockWorkerClient : public rpc::CoreWorkerClientInterface {
     return true;
   }
 
+  void PushNormalTasks(std::unique_ptr<rpc::PushTasksRequest> request,
+                       const rpc::ClientCallback<rpc::PushTasksReply> &callback) override {
+    batch_sizes.push_back(request->requests_size());
+    batch_callbacks.push_back(callback);
+  }
+
+  // Reply to the oldest batch. If failed_index is not negative, the task at that index
+  // fails and the worker cancels the tasks after it.
+  bool ReplyPushTasks(Status status = Status::OK(), int failed_index = -1) {
+    if (batch_callbacks.size() == 0) {
+      return false;
+    }
+    auto callback = batch_callbacks.front();
+    auto reply = rpc::PushTasksReply();
+    for (int i = 0; i < batch_sizes.front(); i++) {
+      reply.add_replies();
+      const bool failed = failed_index >= 0 && i >= failed_index;
+      reply.add_task_failed(failed);
+      reply.add_error_messages(failed ? "failed" : "");
+      reply.add_task_cancelled(failed && i > failed_index);
+    }
+    callback(status, reply);
+    batch_callbacks.pop_front();
+    batch_sizes.pop_front();
+    return true;
+  }
+
   void CancelTask(const rpc::CancelTaskRequest &request,
                   const rpc::ClientCallback<rpc::CancelTaskReply> &callback) override {
     kill_requests.push_front(request);
   }
 
   std::list<rpc::ClientCallback<rpc::PushTaskReply>> callbacks;
+  std::list<rpc::ClientCallback<rpc::PushTasksReply>> batch_callbacks;
+  std::list<int> batch_sizes;
   std::list<rpc::CancelTaskRequest> kill_requests;
 };
 
@@ -103,11 +134,19 @@ class MockRayletClient : public WorkerLeaseInterface {
   void RequestWorkerLease(
       const ray::TaskSpecification &resource_spec,
       const rpc::ClientCallback<rpc::RequestWorkerLeaseReply> &callback,
-      const int64_t backlog_size) override {
+      const int64_t backlog_size,
+      const absl::flat_hash_map<NodeID, uint64_t> &local_object_bytes) override {
+    // Leases of different scheduling classes may be requested concurrently.
+    absl::MutexLock lock(&mu);
     num_workers_requested += 1;
     callbacks.push_back(callback);
   }
 
+  void RequestWorkerLeases(
+      const std::vector<ray::TaskSpecification> &resource_specs,
+      const rpc::ClientCallback<rpc::RequestWorkerLeasesReply> &callback,
+      const int64_t backlog_size) override {}
+
   void ReleaseUnusedWorkers(
       const std::vector<WorkerID> &workers_in_use,
       const rpc::ClientCallback<rpc::ReleaseUnusedWorkersReply> &callback) override {}
@@ -115,6 +154,7 @@ class MockRayletClient : public WorkerLeaseInterface {
   void CancelWorkerLease(
       const TaskID &task_id,
       const rpc::ClientCallback<rpc::CancelWorkerLeaseReply> &callback) override {
+    absl::MutexLock lock(&mu);
     num_leases_canceled += 1;
     cancel_callbacks.push_back(callback);
   }
@@ -159,6 +199,7 @@ class MockRayletClient : public WorkerLeaseInterface {
 
   ~MockRayletClient() {}
 
+  absl::Mutex mu;
   int num_workers_requested = 0;
   int num_workers_returned = 0;
   int num_workers_disconnected = 0;
@@ -191,6 +232,7 @@ class MockLeasePolicy : public LeasePolicyInterface {
   }
 
   rpc::Address GetBestNodeForTask(const TaskSpecification &spec) {
+    absl::MutexLock lock(&mu);
     num_lease_policy_consults++;
     return fallback_rpc_address_;
   };
@@ -199,6 +241,7 @@ class MockLeasePolicy : public LeasePolicyInterface {
 
   rpc::Address fallback_rpc_address_;
 
+  absl::Mutex mu;
   int num_lease_policy_consults = 0;
 };
 
@@ -1028,6 +1071,105 @@ TEST(DirectTaskTransportTest, TestSchedulingKeys) {
   TestSchedulingKey(store, same_deps_1, same_deps_2, different_deps);
 }
 
+TEST(DirectTaskTransportTest, TestIdleWorkerReassignedToOtherSchedulingKey) {
+  rpc::Address address;
+  auto raylet_client = std::make_shared<MockRayletClient>();
+  auto worker_client = std::make_shared<MockWorkerClient>();
+  auto store = std::make_shared<CoreWorkerMemoryStore>();
+  auto client_pool = std::make_shared<rpc::CoreWorkerClientPool>(
+      [&](const rpc::Address &addr) { return worker_client; });
+  auto task_finisher = std::make_shared<MockTaskFinisher>();
+  auto actor_creator = std::make_shared<MockActorCreator>();
+  auto lease_policy = std::make_shared<MockLeasePolicy>();
+  CoreWorkerDirectTaskSubmitter submitter(address, raylet_client, client_pool, nullptr,
+                                          lease_policy, store, task_finisher,
+                                          NodeID::Nil(), kLongTimeout, actor_creator);
+
+  // Two tasks with the same resources but different plasma dependencies, so that they
+  // have different scheduling keys.
+  std::string meta = std::to_string(static_cast<int>(rpc::ErrorType::OBJECT_IN_PLASMA));
+  auto metadata = const_cast<uint8_t *>(reinterpret_cast<const uint8_t *>(meta.data()));
+  auto meta_buffer = std::make_shared<LocalMemoryBuffer>(metadata, meta.size());
+  auto plasma_data = RayObject(nullptr, meta_buffer, std::vector<ObjectID>());
+  std::unordered_map<std::string, double> resources({{"a", 1.0}});
+  ray::FunctionDescriptor descriptor =
+      ray::FunctionDescriptorBuilder::BuildPython("a", "", "", "");
+  std::vector<TaskSpecification> tasks;
+  for (int i = 0; i < 2; i++) {
+    ObjectID plasma_id = ObjectID::FromRandom();
+    ASSERT_TRUE(store->Put(plasma_data, plasma_id));
+    tasks.push_back(BuildTaskSpec(resources, descriptor));
+    tasks.back().GetMutableMessage().add_args()->mutable_object_ref()->set_object_id(
+        plasma_id.Binary());
+  }
+
+  ASSERT_TRUE(submitter.SubmitTask(tasks[0]).ok());
+  ASSERT_TRUE(submitter.SubmitTask(tasks[1]).ok());
+  ASSERT_EQ(raylet_client->num_workers_requested, 2);
+
+  // The first lease runs the first task, then the second one instead of being returned.
+  ASSERT_TRUE(raylet_client->GrantWorkerLease("localhost", 1000, NodeID::Nil()));
+  ASSERT_EQ(worker_client->callbacks.size(), 1);
+  ASSERT_TRUE(worker_client->ReplyPushTask());
+  ASSERT_EQ(worker_client->callbacks.size(), 1);
+  ASSERT_EQ(raylet_client->num_workers_returned, 0);
+  // The lease requested for the second task is no longer needed.
+  ASSERT_EQ(raylet_client->num_leases_canceled, 1);
+  ASSERT_TRUE(raylet_client->ReplyCancelWorkerLease());
+  ASSERT_TRUE(raylet_client->GrantWorkerLease("", 0, NodeID::Nil(), /*cancel=*/true));
+
+  // Without an idle lease timer, the worker is returned once there are no more tasks.
+  ASSERT_TRUE(worker_client->ReplyPushTask());
+  ASSERT_EQ(raylet_client->num_workers_requested, 2);
+  ASSERT_EQ(raylet_client->num_workers_returned, 1);
+  ASSERT_EQ(raylet_client->num_workers_disconnected, 0);
+  ASSERT_EQ(task_finisher->num_tasks_complete, 2);
+  ASSERT_TRUE(submitter.CheckNoSchedulingKeyEntriesPublic());
+}
+
+TEST(DirectTaskTransportTest, TestIdleWorkerPool) {
+  RayConfig::instance().initialize({{"worker_lease_idle_grace_period_ms", "50"}});
+  rpc::Address address;
+  auto raylet_client = std::make_shared<MockRayletClient>();
+  auto worker_client = std::make_shared<MockWorkerClient>();
+  auto store = std::make_shared<CoreWorkerMemoryStore>();
+  auto client_pool = std::make_shared<rpc::CoreWorkerClientPool>(
+      [&](const rpc::Address &addr) { return worker_client; });
+  auto task_finisher = std::make_shared<MockTaskFinisher>();
+  auto actor_creator = std::make_shared<MockActorCreator>();
+  auto lease_policy = std::make_shared<MockLeasePolicy>();
+  boost::asio::io_service io_service;
+  CoreWorkerDirectTaskSubmitter submitter(
+      address, raylet_client, client_pool, nullptr, lease_policy, store, task_finisher,
+      NodeID::Nil(), kLongTimeout, actor_creator, /*max_tasks_in_flight_per_worker=*/1,
+      absl::nullopt, /*max_tasks_per_push_batch=*/1,
+      boost::asio::steady_timer(io_service));
+  std::unordered_map<std::string, double> empty_resources;
+  ray::FunctionDescriptor empty_descriptor =
+      ray::FunctionDescriptorBuilder::BuildPython("", "", "", "");
+
+  // The worker is kept after its task finishes.
+  ASSERT_TRUE(submitter.SubmitTask(BuildTaskSpec(empty_resources, empty_descriptor)).ok());
+  ASSERT_TRUE(raylet_client->GrantWorkerLease("localhost", 1000, NodeID::Nil()));
+  ASSERT_TRUE(worker_client->ReplyPushTask());
+  ASSERT_EQ(raylet_client->num_workers_returned, 0);
+
+  // A task submitted during the grace period reuses the lease.
+  ASSERT_TRUE(submitter.SubmitTask(BuildTaskSpec(empty_resources, empty_descriptor)).ok());
+  ASSERT_EQ(raylet_client->num_workers_requested, 1);
+  ASSERT_EQ(worker_client->callbacks.size(), 1);
+  ASSERT_TRUE(worker_client->ReplyPushTask());
+  ASSERT_EQ(raylet_client->num_workers_returned, 0);
+
+  // The worker is returned at the end of the grace period.
+  io_service.run();
+  ASSERT_EQ(raylet_client->num_workers_requested, 1);
+  ASSERT_EQ(raylet_client->num_workers_returned, 1);
+  ASSERT_EQ(raylet_client->num_workers_disconnected, 0);
+  ASSERT_EQ(task_finisher->num_tasks_complete, 2);
+  ASSERT_TRUE(submitter.CheckNoSchedulingKeyEntriesPublic());
+}
+
 TEST(DirectTaskTransportTest, TestWorkerLeaseTimeout) {
   rpc::Address address;
   auto raylet_client = std::make_shared<MockRayletClient>();
@@ -1551,6 +1693,219 @@ TEST(DirectTaskTransportTest, TestPipeliningNumberOfWorkersRequested) {
   ASSERT_TRUE(submitter.CheckNoSchedulingKeyEntriesPublic());
 }
 
+TEST(DirectTaskTransportTest, TestBatchedPushGrowsWithShortTasks) {
+  // Any task that completes in the test is short compared to the target duration.
+  RayConfig::instance().initialize({{"task_push_batch_target_duration_us", "1000000000"}});
+  rpc::Address address;
+  auto raylet_client = std::make_shared<MockRayletClient>();
+  auto worker_client = std::make_shared<MockWorkerClient>();
+  auto store = std::make_shared<CoreWorkerMemoryStore>();
+  auto client_pool = std::make_shared<rpc::CoreWorkerClientPool>(
+      [&](const rpc::Address &addr) { return worker_client; });
+  auto task_finisher = std::make_shared<MockTaskFinisher>();
+  auto actor_creator = std::make_shared<MockActorCreator>();
+  auto lease_policy = std::make_shared<MockLeasePolicy>();
+  uint32_t max_tasks_per_push_batch = 4;
+  CoreWorkerDirectTaskSubmitter submitter(
+      address, raylet_client, client_pool, nullptr, lease_policy, store, task_finisher,
+      NodeID::Nil(), kLongTimeout, actor_creator, /*max_tasks_in_flight_per_worker=*/1,
+      absl::nullopt, max_tasks_per_push_batch);
+
+  std::unordered_map<std::string, double> empty_resources;
+  ray::FunctionDescriptor empty_descriptor =
+      ray::FunctionDescriptorBuilder::BuildPython("", "", "", "");
+  for (int i = 0; i < 10; i++) {
+    ASSERT_TRUE(
+        submitter.SubmitTask(BuildTaskSpec(empty_resources, empty_descriptor)).ok());
+  }
+  ASSERT_TRUE(raylet_client->GrantWorkerLease("localhost", 1000, NodeID::Nil()));
+
+  // The task duration is unknown, so the first task is pushed by itself.
+  ASSERT_EQ(worker_client->callbacks.size(), 1);
+  ASSERT_EQ(worker_client->batch_callbacks.size(), 0);
+  ASSERT_TRUE(worker_client->ReplyPushTask());
+  ASSERT_EQ(task_finisher->num_tasks_complete, 1);
+
+  // The tasks are short, so the next ones are pushed in full batches, one batch at a
+  // time.
+  ASSERT_EQ(worker_client->callbacks.size(), 0);
+  ASSERT_EQ(worker_client->batch_sizes, std::list<int>({4}));
+  ASSERT_TRUE(worker_client->ReplyPushTasks());
+  ASSERT_EQ(task_finisher->num_tasks_complete, 5);
+  ASSERT_EQ(worker_client->batch_sizes, std::list<int>({4}));
+  ASSERT_TRUE(worker_client->ReplyPushTasks());
+  ASSERT_EQ(task_finisher->num_tasks_complete, 9);
+  ASSERT_EQ(worker_client->batch_sizes, std::list<int>({1}));
+  ASSERT_TRUE(worker_client->ReplyPushTasks());
+
+  ASSERT_EQ(raylet_client->num_workers_returned, 1);
+  ASSERT_EQ(raylet_client->num_workers_disconnected, 0);
+  ASSERT_EQ(task_finisher->num_tasks_complete, 10);
+  ASSERT_EQ(task_finisher->num_tasks_failed, 0);
+
+  // The lease requested for the queued tasks is no longer needed.
+  ASSERT_EQ(raylet_client->num_workers_requested, 2);
+  ASSERT_EQ(raylet_client->num_leases_canceled, 1);
+  ASSERT_TRUE(raylet_client->ReplyCancelWorkerLease());
+  ASSERT_TRUE(raylet_client->GrantWorkerLease("", 0, NodeID::Nil(), /*cancel=*/true));
+  ASSERT_TRUE(submitter.CheckNoSchedulingKeyEntriesPublic());
+}
+
+TEST(DirectTaskTransportTest, TestBatchedPushFailure) {
+  RayConfig::instance().initialize({{"task_push_batch_target_duration_us", "1000000000"}});
+  rpc::Address address;
+  auto raylet_client = std::make_shared<MockRayletClient>();
+  auto worker_client = std::make_shared<MockWorkerClient>();
+  auto store = std::make_shared<CoreWorkerMemoryStore>();
+  auto client_pool = std::make_shared<rpc::CoreWorkerClientPool>(
+      [&](const rpc::Address &addr) { return worker_client; });
+  auto task_finisher = std::make_shared<MockTaskFinisher>();
+  auto actor_creator = std::make_shared<MockActorCreator>();
+  auto lease_policy = std::make_shared<MockLeasePolicy>();
+  CoreWorkerDirectTaskSubmitter submitter(
+      address, raylet_client, client_pool, nullptr, lease_policy, store, task_finisher,
+      NodeID::Nil(), kLongTimeout, actor_creator, /*max_tasks_in_flight_per_worker=*/1,
+      absl::nullopt, /*max_tasks_per_push_batch=*/4);
+
+  std::unordered_map<std::string, double> empty_resources;
+  ray::FunctionDescriptor empty_descriptor =
+      ray::FunctionDescriptorBuilder::BuildPython("", "", "", "");
+  for (int i = 0; i < 5; i++) {
+    ASSERT_TRUE(
+        submitter.SubmitTask(BuildTaskSpec(empty_resources, empty_descriptor)).ok());
+  }
+  ASSERT_TRUE(raylet_client->GrantWorkerLease("localhost", 1000, NodeID::Nil()));
+  ASSERT_TRUE(worker_client->ReplyPushTask());
+  ASSERT_EQ(worker_client->batch_sizes, std::list<int>({4}));
+
+  // The third task of the batch fails and the fourth one is cancelled. The first two
+  // tasks are complete, and the worker is not reused.
+  ASSERT_TRUE(worker_client->ReplyPushTasks(Status::OK(), /*failed_index=*/2));
+  ASSERT_EQ(task_finisher->num_tasks_complete, 3);
+  ASSERT_EQ(task_finisher->num_tasks_failed, 2);
+  ASSERT_EQ(raylet_client->num_workers_returned, 0);
+  ASSERT_EQ(raylet_client->num_workers_disconnected, 1);
+  ASSERT_EQ(worker_client->batch_callbacks.size(), 0);
+
+  ASSERT_TRUE(raylet_client->ReplyCancelWorkerLease());
+  ASSERT_TRUE(raylet_client->GrantWorkerLease("", 0, NodeID::Nil(), /*cancel=*/true));
+  ASSERT_TRUE(submitter.CheckNoSchedulingKeyEntriesPublic());
+}
+
+TEST(DirectTaskTransportTest, TestMultiThreadedSubmit) {
+  rpc::Address address;
+  auto raylet_client = std::make_shared<MockRayletClient>();
+  auto worker_client = std::make_shared<MockWorkerClient>();
+  auto store = std::make_shared<CoreWorkerMemoryStore>();
+  auto client_pool = std::make_shared<rpc::CoreWorkerClientPool>(
+      [&](const rpc::Address &addr) { return worker_client; });
+  auto task_finisher = std::make_shared<MockTaskFinisher>();
+  auto actor_creator = std::make_shared<MockActorCreator>();
+  auto lease_policy = std::make_shared<MockLeasePolicy>();
+  CoreWorkerDirectTaskSubmitter submitter(address, raylet_client, client_pool, nullptr,
+                                          lease_policy, store, task_finisher,
+                                          NodeID::Nil(), kLongTimeout, actor_creator);
+
+  // Each thread submits tasks of its own resource shape.
+  const int num_threads = 4;
+  const int num_tasks_per_thread = 100;
+  ray::FunctionDescriptor empty_descriptor =
+      ray::FunctionDescriptorBuilder::BuildPython("", "", "", "");
+  std::vector<std::vector<TaskSpecification>> tasks(num_threads);
+  for (int i = 0; i < num_threads; i++) {
+    std::unordered_map<std::string, double> resources = {
+        {"CPU", static_cast<double>(i + 1)}};
+    for (int j = 0; j < num_tasks_per_thread; j++) {
+      tasks[i].push_back(BuildTaskSpec(resources, empty_descriptor));
+    }
+  }
+  std::vector<std::thread> threads;
+  for (int i = 0; i < num_threads; i++) {
+    threads.emplace_back([&submitter, &tasks, i]() {
+      for (const auto &task : tasks[i]) {
+        RAY_CHECK_OK(submitter.SubmitTask(task));
+      }
+    });
+  }
+  for (auto &thread : threads) {
+    thread.join();
+  }
+  // One lease is requested per resource shape.
+  ASSERT_EQ(raylet_client->num_workers_requested, num_threads);
+
+  for (int i = 0; i < num_threads; i++) {
+    ASSERT_TRUE(raylet_client->GrantWorkerLease("localhost", 1000 + i, NodeID::Nil()));
+  }
+  while (worker_client->ReplyPushTask()) {
+  }
+  ASSERT_EQ(task_finisher->num_tasks_complete, num_threads * num_tasks_per_thread);
+  ASSERT_EQ(task_finisher->num_tasks_failed, 0);
+  ASSERT_EQ(raylet_client->num_workers_returned, num_threads);
+
+  // Cancel the leases that were requested while the queues were not empty.
+  while (raylet_client->ReplyCancelWorkerLease()) {
+  }
+  while (raylet_client->GrantWorkerLease("", 0, NodeID::Nil(), /*cancel=*/true)) {
+  }
+  ASSERT_TRUE(submitter.CheckNoSchedulingKeyEntriesPublic());
+}
+
+// Submit tasks from several threads, with one resource shape per thread, and measure
+// the submission throughput with a single shard and with the default number of
+// shards. Run it with --gtest_also_run_disabled_tests.
+TEST(DirectTaskTransportTest, DISABLED_BenchmarkMultiThreadedSubmit) {
+  const int num_tasks = 200 * 1000;
+  ray::FunctionDescriptor empty_descriptor =
+      ray::FunctionDescriptorBuilder::BuildPython("", "", "", "");
+  for (int num_shards : {1, 16}) {
+    for (int num_threads : {1, 4, 16}) {
+      RayConfig::instance().initialize(
+          {{"task_submitter_num_shards", std::to_string(num_shards)}});
+      rpc::Address address;
+      auto raylet_client = std::make_shared<MockRayletClient>();
+      auto worker_client = std::make_shared<MockWorkerClient>();
+      auto store = std::make_shared<CoreWorkerMemoryStore>();
+      auto client_pool = std::make_shared<rpc::CoreWorkerClientPool>(
+          [&](const rpc::Address &addr) { return worker_client; });
+      auto task_finisher = std::make_shared<MockTaskFinisher>();
+      auto actor_creator = std::make_shared<MockActorCreator>();
+      auto lease_policy = std::make_shared<MockLeasePolicy>();
+      CoreWorkerDirectTaskSubmitter submitter(
+          address, raylet_client, client_pool, nullptr, lease_policy, store,
+          task_finisher, NodeID::Nil(), kLongTimeout, actor_creator);
+
+      std::vector<std::vector<TaskSpecification>> tasks(num_threads);
+      for (int i = 0; i < num_threads; i++) {
+        std::unordered_map<std::string, double> resources = {
+            {"CPU", static_cast<double>(i + 1)}};
+        for (int j = 0; j < num_tasks / num_threads; j++) {
+          tasks[i].push_back(BuildTaskSpec(resources, empty_descriptor));
+        }
+      }
+
+      auto start = std::chrono::steady_clock::now();
+      std::vector<std::thread> threads;
+      for (int i = 0; i < num_threads; i++) {
+        threads.emplace_back([&submitter, &tasks, i]() {
+          for (const auto &task : tasks[i]) {
+            RAY_CHECK_OK(submitter.SubmitTask(task));
+          }
+        });
+      }
+      for (auto &thread : threads) {
+        thread.join();
+      }
+      auto elapsed_ms = std::chrono::duration_cast<std::chrono::milliseconds>(
+                            std::chrono::steady_clock::now() - start)
+                            .count();
+      RAY_LOG(INFO) << num_shards << " shard(s), " << num_threads << " thread(s): "
+                    << num_tasks << " tasks submitted in " << elapsed_ms << "ms";
+      ASSERT_EQ(raylet_client->num_workers_requested, num_threads);
+    }
+  }
+  RayConfig::instance().initialize({{"task_submitter_num_shards", "16"}});
+}
+
 }  // namespace ray
 
 int main(int argc, char **argv) {
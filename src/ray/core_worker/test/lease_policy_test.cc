@@ -146,6 +146,41 @@ TEST(LocalityAwareLeasePolicyTest, TestBestLocalityBetterNode) {
   ASSERT_EQ(NodeID::FromBinary(best_node_address.raylet_id()), best_node);
 }
 
+TEST(LocalityAwareLeasePolicyTest, TestReportLocalObjectBytes) {
+  absl::flat_hash_map<ObjectID, LocalityData> locality_data;
+  NodeID fallback_node = NodeID::FromRandom();
+  rpc::Address fallback_rpc_address = MockNodeAddrFactory(fallback_node).value();
+  NodeID best_node = NodeID::FromRandom();
+  NodeID bad_node = NodeID::FromRandom();
+  ObjectID obj1 = ObjectID::FromRandom();
+  ObjectID obj2 = ObjectID::FromRandom();
+  locality_data.emplace(obj1, LocalityData{8, {best_node, bad_node}});
+  locality_data.emplace(obj2, LocalityData{16, {best_node}});
+  auto mock_locality_data_provider =
+      std::make_shared<MockLocalityDataProvider>(locality_data);
+  LocalityAwareLeasePolicy locality_lease_policy(
+      mock_locality_data_provider, MockNodeAddrFactory, fallback_rpc_address);
+  std::vector<ObjectID> deps{obj1, obj2};
+  auto task_spec = CreateFakeTask(deps);
+  ObjectBytesByNode local_object_bytes;
+  rpc::Address best_node_address =
+      locality_lease_policy.GetBestNodeForTask(task_spec, &local_object_bytes);
+  ASSERT_EQ(NodeID::FromBinary(best_node_address.raylet_id()), best_node);
+  // The locality that the choice was based on is reported, so that the raylet can
+  // use it on spillback.
+  ASSERT_EQ(local_object_bytes.size(), 2);
+  ASSERT_EQ(local_object_bytes[best_node], 24);
+  ASSERT_EQ(local_object_bytes[bad_node], 8);
+
+  // The local lease policy does not use locality.
+  LocalLeasePolicy local_lease_policy(fallback_rpc_address);
+  LeasePolicyInterface &policy = local_lease_policy;
+  ObjectBytesByNode no_object_bytes;
+  best_node_address = policy.GetBestNodeForTask(task_spec, &no_object_bytes);
+  ASSERT_EQ(NodeID::FromBinary(best_node_address.raylet_id()), fallback_node);
+  ASSERT_TRUE(no_object_bytes.empty());
+}
+
 TEST(LocalityAwareLeasePolicyTest, TestBestLocalityFallbackNoLocations) {
   absl::flat_hash_map<ObjectID, LocalityData> locality_data;
   NodeID fallback_node = NodeID::FromRandom();
@@ -0,0 +1,201 @@
+// Copyright 2017 The Ray Authors.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//  http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "ray/core_worker/store_provider/memory_store/memory_store.h"
+
+#include <atomic>
+#include <thread>
+
+#include "gtest/gtest.h"
+#include "ray/common/ray_config.h"
+
+namespace ray {
+
+class MemoryStoreTest : public ::testing::Test {
+ protected:
+  MemoryStoreTest()
+      : ctx_(WorkerType::WORKER, WorkerID::FromRandom(), JobID::Nil()),
+        object_(std::make_shared<LocalMemoryBuffer>(data_, sizeof(data_)), nullptr,
+                std::vector<ObjectID>()) {}
+
+  uint8_t data_[8] = {1, 2, 3, 4, 5, 6, 7, 8};
+  WorkerContext ctx_;
+  RayObject object_;
+};
+
+TEST_F(MemoryStoreTest, TestGetAndWait) {
+  CoreWorkerMemoryStore store;
+  auto id1 = ObjectID::FromRandom();
+  auto id2 = ObjectID::FromRandom();
+  ASSERT_TRUE(store.Put(object_, id1));
+
+  // Objects that are already present are returned right away.
+  std::vector<std::shared_ptr<RayObject>> results;
+  RAY_CHECK_OK(store.Get({id1}, 1, -1, ctx_, /*remove_after_get=*/false, &results));
+  ASSERT_EQ(results.size(), 1);
+  ASSERT_NE(results[0], nullptr);
+
+  // Get times out on objects that are not present.
+  results.clear();
+  ASSERT_TRUE(
+      store.Get({id1, id2}, 2, 10, ctx_, /*remove_after_get=*/false, &results)
+          .IsTimedOut());
+  ASSERT_NE(results[0], nullptr);
+  ASSERT_EQ(results[1], nullptr);
+
+  // Wait returns once enough objects are ready.
+  absl::flat_hash_set<ObjectID> ready;
+  RAY_CHECK_OK(store.Wait({id1, id2}, 1, -1, ctx_, &ready));
+  ASSERT_EQ(ready, absl::flat_hash_set<ObjectID>({id1}));
+
+  // A blocked Get is woken up by the Put of its object.
+  std::thread putter([&]() {
+    std::this_thread::sleep_for(std::chrono::milliseconds(10));
+    ASSERT_TRUE(store.Put(object_, id2));
+  });
+  results.clear();
+  RAY_CHECK_OK(store.Get({id1, id2}, 2, -1, ctx_, /*remove_after_get=*/true, &results));
+  putter.join();
+  ASSERT_NE(results[0], nullptr);
+  ASSERT_NE(results[1], nullptr);
+  // Without ref counting, the objects are removed after the Get.
+  ASSERT_EQ(store.Size(), 0);
+}
+
+TEST_F(MemoryStoreTest, TestGetAsync) {
+  CoreWorkerMemoryStore store;
+  auto id = ObjectID::FromRandom();
+  int num_callbacks = 0;
+  store.GetAsync(id, [&](std::shared_ptr<RayObject> object) { num_callbacks++; });
+  ASSERT_EQ(num_callbacks, 0);
+  ASSERT_TRUE(store.Put(object_, id));
+  ASSERT_EQ(num_callbacks, 1);
+  // The object is already present, so the callback runs right away.
+  store.GetAsync(id, [&](std::shared_ptr<RayObject> object) { num_callbacks++; });
+  ASSERT_EQ(num_callbacks, 2);
+}
+
+// Many threads get objects while other threads put them. Every Get should
+// eventually see its objects, regardless of which shard they fall into.
+TEST_F(MemoryStoreTest, TestConcurrentPutAndGet) {
+  const int num_threads = 8;
+  const int num_objects_per_thread = 1000;
+  CoreWorkerMemoryStore store;
+  std::vector<std::vector<ObjectID>> ids(num_threads);
+  for (auto &thread_ids : ids) {
+    for (int i = 0; i < num_objects_per_thread; i++) {
+      thread_ids.push_back(ObjectID::FromRandom());
+    }
+  }
+
+  std::atomic<int> num_got(0);
+  std::atomic<int> num_async_got(0);
+  std::vector<std::thread> threads;
+  for (int t = 0; t < num_threads; t++) {
+    threads.emplace_back([&, t]() {
+      for (const auto &id : ids[t]) {
+        store.GetAsync(id, [&](std::shared_ptr<RayObject> object) { num_async_got++; });
+      }
+      for (size_t i = 0; i < ids[t].size(); i += 2) {
+        std::vector<std::shared_ptr<RayObject>> results;
+        RAY_CHECK_OK(store.Get({ids[t][i], ids[t][i + 1]}, 2, -1, ctx_,
+                               /*remove_after_get=*/false, &results));
+        ASSERT_NE(results[0], nullptr);
+        ASSERT_NE(results[1], nullptr);
+        num_got += 2;
+      }
+    });
+    threads.emplace_back([&, t]() {
+      for (const auto &id : ids[t]) {
+        store.Put(object_, id);
+      }
+    });
+  }
+  for (auto &thread : threads) {
+    thread.join();
+  }
+  ASSERT_EQ(num_got, num_threads * num_objects_per_thread);
+  ASSERT_EQ(num_async_got, num_threads * num_objects_per_thread);
+  ASSERT_EQ(store.Size(), num_threads * num_objects_per_thread);
+
+  std::vector<ObjectID> all_ids;
+  for (const auto &thread_ids : ids) {
+    all_ids.insert(all_ids.end(), thread_ids.begin(), thread_ids.end());
+  }
+  store.Delete(all_ids);
+  ASSERT_EQ(store.Size(), 0);
+}
+
+// Objects that we own are promoted to plasma, least recently used first, once
+// the store exceeds its byte budget.
+TEST_F(MemoryStoreTest, TestEvictToPlasma) {
+  const int64_t object_size = object_.GetSize();
+  RayConfig::instance().initialize(
+      {{"memory_store_max_bytes", std::to_string(3 * object_size)}});
+  auto rc = std::shared_ptr<ReferenceCounter>(
+      new ReferenceCounter(rpc::WorkerAddress(rpc::Address())));
+  std::vector<ObjectID> promoted_ids;
+  CoreWorkerMemoryStore store(
+      [&](const RayObject &object, const ObjectID &object_id) {
+        promoted_ids.push_back(object_id);
+      },
+      rc);
+
+  std::vector<ObjectID> ids;
+  for (int i = 0; i < 4; i++) {
+    ids.push_back(ObjectID::FromRandom());
+    rc->AddOwnedObject(ids.back(), {}, rpc::Address(), "", 0, false);
+  }
+  // A borrowed object is never promoted.
+  auto borrowed_id = ObjectID::FromRandom();
+  rc->AddLocalReference(borrowed_id, "");
+  ASSERT_TRUE(store.Put(object_, borrowed_id));
+  for (int i = 0; i < 3; i++) {
+    ASSERT_TRUE(store.Put(object_, ids[i]));
+  }
+  ASSERT_EQ(promoted_ids, std::vector<ObjectID>({ids[0]}));
+  ASSERT_EQ(store.UsedMemory(), 3 * object_size);
+
+  // Reading an object makes it the most recently used.
+  std::vector<std::shared_ptr<RayObject>> results;
+  RAY_CHECK_OK(store.Get({ids[1]}, 1, -1, ctx_, /*remove_after_get=*/false, &results));
+  ASSERT_TRUE(store.Put(object_, ids[3]));
+  ASSERT_EQ(promoted_ids, std::vector<ObjectID>({ids[0], ids[2]}));
+  ASSERT_EQ(store.UsedMemory(), 3 * object_size);
+
+  // Reads of the promoted objects go to plasma.
+  bool in_plasma = false;
+  ASSERT_TRUE(store.Contains(ids[0], &in_plasma));
+  ASSERT_TRUE(in_plasma);
+  in_plasma = false;
+  ASSERT_TRUE(store.Contains(ids[1], &in_plasma));
+  ASSERT_FALSE(in_plasma);
+  auto stats = store.GetMemoryStoreStatisticalData();
+  ASSERT_EQ(stats.num_in_plasma, 2);
+  ASSERT_EQ(stats.num_local_objects, 3);
+  ASSERT_EQ(stats.used_object_store_memory, 3 * object_size);
+  ASSERT_EQ(stats.num_evicted_to_plasma, 2);
+
+  // Deleting an object frees its memory.
+  store.Delete(std::vector<ObjectID>({ids[1]}));
+  ASSERT_EQ(store.UsedMemory(), 2 * object_size);
+  RayConfig::instance().initialize({{"memory_store_max_bytes", "0"}});
+}
+
+}  // namespace ray
+
+int main(int argc, char **argv) {
+  ::testing::InitGoogleTest(&argc, argv);
+  return RUN_ALL_TESTS();
+}
@@ -0,0 +1,234 @@
+// Copyright 2017 The Ray Authors.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//  http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "ray/core_worker/object_location_publisher.h"
+
+#include "gtest/gtest.h"
+
+namespace ray {
+
+class ObjectLocationPublisherTest : public ::testing::Test {
+ public:
+  ObjectLocationPublisherTest()
+      : publisher_(
+            io_service_,
+            [this](const ObjectID &object_id, int64_t *object_size)
+                -> absl::optional<absl::flat_hash_set<NodeID>> {
+              auto it = locations_.find(object_id);
+              if (it == locations_.end()) {
+                return absl::nullopt;
+              }
+              *object_size = 100;
+              return it->second;
+            },
+            /*max_updates_per_reply=*/2) {}
+
+  /// A long poll from a node. The reply is stored in the poll once it is sent.
+  struct Poll {
+    rpc::GetObjectLocationsUpdatesReply reply;
+    bool replied = false;
+  };
+
+  std::shared_ptr<Poll> SendPoll(const NodeID &node_id,
+                                 const std::vector<ObjectID> &subscribe_ids,
+                                 const std::vector<ObjectID> &unsubscribe_ids = {}) {
+    rpc::GetObjectLocationsUpdatesRequest request;
+    request.set_subscriber_node_id(node_id.Binary());
+    for (const auto &object_id : subscribe_ids) {
+      request.add_subscribe_object_ids(object_id.Binary());
+    }
+    for (const auto &object_id : unsubscribe_ids) {
+      request.add_unsubscribe_object_ids(object_id.Binary());
+    }
+    auto poll = std::make_shared<Poll>();
+    publisher_.HandleGetObjectLocationsUpdates(
+        request, &poll->reply,
+        [poll](Status status, std::function<void()> success,
+               std::function<void()> failure) {
+          ASSERT_TRUE(status.ok());
+          ASSERT_FALSE(poll->replied);
+          poll->replied = true;
+        });
+    return poll;
+  }
+
+  void ChangeLocations(const ObjectID &object_id,
+                       const absl::flat_hash_set<NodeID> &node_ids) {
+    locations_[object_id] = node_ids;
+    publisher_.MarkLocationsChanged(object_id);
+  }
+
+  /// Run the queued handlers, e.g., the replies to the held polls.
+  void RunEventLoop() {
+    io_service_.poll();
+    io_service_.restart();
+  }
+
+  static absl::flat_hash_map<ObjectID, std::vector<NodeID>> GetUpdates(
+      const Poll &poll) {
+    absl::flat_hash_map<ObjectID, std::vector<NodeID>> updates;
+    for (const auto &update : poll.reply.updates()) {
+      auto &node_ids = updates[ObjectID::FromBinary(update.object_id())];
+      for (const auto &node_id : update.node_ids()) {
+        node_ids.push_back(NodeID::FromBinary(node_id));
+      }
+    }
+    return updates;
+  }
+
+ protected:
+  boost::asio::io_service io_service_;
+  absl::flat_hash_map<ObjectID, absl::flat_hash_set<NodeID>> locations_;
+  ObjectLocationPublisher publisher_;
+};
+
+TEST_F(ObjectLocationPublisherTest, TestSubscribeAndPush) {
+  const auto subscriber = NodeID::FromRandom();
+  const auto location = NodeID::FromRandom();
+  const auto object_id = ObjectID::FromRandom();
+  locations_[object_id] = {};
+
+  // New subscriptions get the current locations right away.
+  auto poll = SendPoll(subscriber, {object_id});
+  ASSERT_TRUE(poll->replied);
+  ASSERT_EQ(GetUpdates(*poll)[object_id], std::vector<NodeID>());
+  ASSERT_EQ(poll->reply.updates(0).object_size(), 100);
+
+  // The next poll is held until the locations change.
+  poll = SendPoll(subscriber, {});
+  RunEventLoop();
+  ASSERT_FALSE(poll->replied);
+  ChangeLocations(object_id, {location});
+  ASSERT_FALSE(poll->replied);
+  RunEventLoop();
+  ASSERT_TRUE(poll->replied);
+  ASSERT_EQ(GetUpdates(*poll)[object_id], std::vector<NodeID>({location}));
+}
+
+TEST_F(ObjectLocationPublisherTest, TestCoalesceChanges) {
+  const auto subscriber = NodeID::FromRandom();
+  std::vector<ObjectID> object_ids;
+  for (int i = 0; i < 3; i++) {
+    object_ids.push_back(ObjectID::FromRandom());
+    locations_[object_ids.back()] = {};
+  }
+  auto poll = SendPoll(subscriber, {object_ids[0], object_ids[1]});
+  ASSERT_TRUE(poll->replied);
+  poll = SendPoll(subscriber, {});
+
+  // Several changes to the same object are sent once, with the latest locations.
+  const auto location = NodeID::FromRandom();
+  ChangeLocations(object_ids[0], {NodeID::FromRandom()});
+  ChangeLocations(object_ids[0], {location});
+  // Objects that the node didn't subscribe to aren't sent.
+  ChangeLocations(object_ids[2], {location});
+  RunEventLoop();
+  ASSERT_TRUE(poll->replied);
+  auto updates = GetUpdates(*poll);
+  ASSERT_EQ(updates.size(), 1);
+  ASSERT_EQ(updates[object_ids[0]], std::vector<NodeID>({location}));
+
+  // Changes made while no poll is outstanding are sent with the next poll.
+  ChangeLocations(object_ids[1], {location});
+  RunEventLoop();
+  poll = SendPoll(subscriber, {});
+  ASSERT_TRUE(poll->replied);
+  ASSERT_EQ(GetUpdates(*poll).size(), 1);
+}
+
+TEST_F(ObjectLocationPublisherTest, TestMaxUpdatesPerReply) {
+  const auto subscriber = NodeID::FromRandom();
+  std::vector<ObjectID> object_ids;
+  for (int i = 0; i < 3; i++) {
+    object_ids.push_back(ObjectID::FromRandom());
+    locations_[object_ids.back()] = {};
+  }
+  auto poll = SendPoll(subscriber, object_ids);
+  ASSERT_TRUE(poll->replied);
+  ASSERT_EQ(poll->reply.updates_size(), 2);
+  // The rest of the updates are sent with the next poll.
+  poll = SendPoll(subscriber, {});
+  ASSERT_TRUE(poll->replied);
+  ASSERT_EQ(poll->reply.updates_size(), 1);
+}
+
+TEST_F(ObjectLocationPublisherTest, TestUnsubscribe) {
+  const auto subscriber = NodeID::FromRandom();
+  const auto object_id1 = ObjectID::FromRandom();
+  const auto object_id2 = ObjectID::FromRandom();
+  locations_[object_id1] = {};
+  locations_[object_id2] = {};
+  auto poll = SendPoll(subscriber, {object_id1, object_id2});
+  ASSERT_EQ(publisher_.NumSubscribers(object_id1), 1);
+
+  // A new poll releases the outstanding one without updates.
+  auto held_poll = SendPoll(subscriber, {});
+  poll = SendPoll(subscriber, {}, {object_id1});
+  ASSERT_TRUE(held_poll->replied);
+  ASSERT_EQ(held_poll->reply.updates_size(), 0);
+  ASSERT_FALSE(poll->replied);
+  ASSERT_EQ(publisher_.NumSubscribers(object_id1), 0);
+  ChangeLocations(object_id1, {NodeID::FromRandom()});
+  RunEventLoop();
+  ASSERT_FALSE(poll->replied);
+
+  // The subscriber is dropped once it has no subscriptions.
+  auto last_poll = SendPoll(subscriber, {}, {object_id2});
+  ASSERT_TRUE(poll->replied);
+  ASSERT_TRUE(last_poll->replied);
+  ASSERT_EQ(publisher_.NumSubscribers(), 0);
+}
+
+TEST_F(ObjectLocationPublisherTest, TestObjectOutOfScope) {
+  const auto subscriber = NodeID::FromRandom();
+  const auto object_id = ObjectID::FromRandom();
+  locations_[object_id] = {};
+  auto poll = SendPoll(subscriber, {object_id});
+  poll = SendPoll(subscriber, {});
+
+  locations_.erase(object_id);
+  publisher_.MarkLocationsChanged(object_id);
+  RunEventLoop();
+  ASSERT_TRUE(poll->replied);
+  ASSERT_EQ(poll->reply.updates_size(), 1);
+  ASSERT_TRUE(poll->reply.updates(0).object_not_found());
+  ASSERT_EQ(publisher_.NumSubscribers(), 0);
+}
+
+TEST_F(ObjectLocationPublisherTest, TestRemoveSubscriber) {
+  const auto subscriber1 = NodeID::FromRandom();
+  const auto subscriber2 = NodeID::FromRandom();
+  const auto object_id = ObjectID::FromRandom();
+  locations_[object_id] = {};
+  SendPoll(subscriber1, {object_id});
+  SendPoll(subscriber2, {object_id});
+  auto poll1 = SendPoll(subscriber1, {});
+  auto poll2 = SendPoll(subscriber2, {});
+  ASSERT_EQ(publisher_.NumSubscribers(object_id), 2);
+
+  publisher_.RemoveSubscriber(subscriber1);
+  ASSERT_TRUE(poll1->replied);
+  ASSERT_EQ(publisher_.NumSubscribers(object_id), 1);
+  ChangeLocations(object_id, {NodeID::FromRandom()});
+  RunEventLoop();
+  ASSERT_TRUE(poll2->replied);
+  ASSERT_EQ(poll2->reply.updates_size(), 1);
+}
+
+}  // namespace ray
+
+int main(int argc, char **argv) {
+  ::testing::InitGoogleTest(&argc, argv);
+  return RUN_ALL_TESTS();
+}
@@ -118,6 +118,32 @@ TEST(SchedulingQueueTest, TestOutOfOrder) {
   ASSERT_EQ(n_rej, 0);
 }
 
+TEST(SchedulingQueueTest, TestOutOfOrderActorQueue) {
+  ObjectID obj1 = ObjectID::FromRandom();
+  ObjectID obj2 = ObjectID::FromRandom();
+  MockWaiter waiter;
+  WorkerContext context(WorkerType::WORKER, WorkerID::FromRandom(), JobID::Nil());
+  OutOfOrderActorSchedulingQueue queue(waiter, context);
+  std::vector<int> executed;
+  auto fn_rej = []() { FAIL(); };
+  // Tasks run as soon as their dependencies are available, regardless of their
+  // sequence numbers.
+  queue.Add(3, -1, [&executed]() { executed.push_back(3); }, fn_rej);
+  queue.Add(0, -1, [&executed]() { executed.push_back(0); }, fn_rej,
+            ObjectIdsToRefs({obj1}));
+  queue.Add(1, -1, [&executed]() { executed.push_back(1); }, fn_rej,
+            ObjectIdsToRefs({obj2}));
+  queue.Add(2, -1, [&executed]() { executed.push_back(2); }, fn_rej);
+  ASSERT_EQ(executed, std::vector<int>({3, 2}));
+  ASSERT_FALSE(queue.TaskQueueEmpty());
+
+  waiter.Complete(1);
+  ASSERT_EQ(executed, std::vector<int>({3, 2, 1}));
+  waiter.Complete(0);
+  ASSERT_EQ(executed, std::vector<int>({3, 2, 1, 0}));
+  ASSERT_TRUE(queue.TaskQueueEmpty());
+}
+
 TEST(SchedulingQueueTest, TestSeqWaitTimeout) {
   boost::asio::io_service io_service;
   MockWaiter waiter;
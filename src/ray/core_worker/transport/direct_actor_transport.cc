@@ -23,11 +23,16 @@ using ray::rpc::ActorTableData;
 namespace ray {
 
 void CoreWorkerDirectActorTaskSubmitter::AddActorQueueIfNotExists(
-    const ActorID &actor_id) {
+    const ActorID &actor_id, bool allow_out_of_order_execution,
+    bool executes_tasks_concurrently) {
   absl::MutexLock lock(&mu_);
   // No need to check whether the insert was successful, since it is possible
   // for this worker to have multiple references to the same actor.
-  client_queues_.emplace(actor_id, ClientQueue());
+  auto inserted = client_queues_.emplace(actor_id, ClientQueue());
+  if (inserted.second) {
+    inserted.first->second.allow_out_of_order_execution = allow_out_of_order_execution;
+    inserted.first->second.executes_tasks_concurrently = executes_tasks_concurrently;
+  }
 }
 
 void CoreWorkerDirectActorTaskSubmitter::KillActor(const ActorID &actor_id,
@@ -236,22 +241,73 @@ void CoreWorkerDirectActorTaskSubmitter::SendPendingTasks(const ActorID &actor_i
     client_queue.pending_force_kill.reset();
   }
 
-  // Submit all pending requests.
+  // Find the pending requests that can be sent. In order, these are the requests
+  // whose dependencies are resolved, up to the first one that is not, or the first
+  // gap in the send positions. Out of order, these are all resolved requests.
+  const bool in_order = !client_queue.allow_out_of_order_execution;
   auto &requests = client_queue.requests;
-  auto head = requests.begin();
-  while (head != requests.end() &&
-         (/*seqno*/ head->first <= client_queue.next_send_position) &&
-         (/*dependencies_resolved*/ head->second.second)) {
-    // If the task has been sent before, skip the other tasks in the send
-    // queue.
-    bool skip_queue = head->first < client_queue.next_send_position;
-    auto task_spec = std::move(head->second.first);
-    head = requests.erase(head);
-
-    RAY_CHECK(!client_queue.worker_id.empty());
-    PushActorTask(client_queue, task_spec, skip_queue);
-    client_queue.next_send_position++;
+  std::vector<decltype(requests.begin())> ready;
+  uint64_t send_position = client_queue.next_send_position;
+  size_t num_resent = 0;
+  for (auto it = requests.begin(); it != requests.end(); it++) {
+    if (/*dependencies_resolved*/ !it->second.second) {
+      if (in_order) {
+        break;
+      }
+      continue;
+    }
+    if (in_order) {
+      if (/*seqno*/ it->first < client_queue.next_send_position) {
+        // The task has been sent before. These tasks come first, since their task
+        // numbers are behind the send position.
+        num_resent++;
+      } else if (it->first == send_position) {
+        send_position++;
+      } else {
+        break;
+      }
+    }
+    ready.push_back(it);
+  }
+
+  RAY_CHECK(ready.empty() || !client_queue.worker_id.empty());
+  size_t num_sent = 0;
+  // A task that has been sent before skips the other tasks in the send queue.
+  for (; num_sent < num_resent; num_sent++) {
+    PushActorTask(client_queue, ready[num_sent]->second.first, /*skip_queue=*/true);
+  }
+
+  // Push the other tasks. When batching, the tasks are held back while a push to the
+  // actor is in flight, until there are enough of them for a full batch. They are
+  // sent once the push in flight is done. Tasks for an actor that runs several tasks
+  // at once are never held back, since the push in flight may wait on them.
+  const uint32_t batch_size = client_queue.push_batch_sizer.BatchSize(
+      max_tasks_per_push_batch_, push_batch_target_duration_us_);
+  const bool may_hold_back =
+      max_tasks_per_push_batch_ > 1 && !client_queue.executes_tasks_concurrently;
+  while (num_sent < ready.size()) {
+    const size_t num_ready = ready.size() - num_sent;
+    if (may_hold_back && client_queue.num_pushes_in_flight > 0 &&
+        num_ready < batch_size) {
+      break;
+    }
+    if (batch_size == 1 || num_ready == 1) {
+      PushActorTask(client_queue, ready[num_sent]->second.first, /*skip_queue=*/false);
+      num_sent++;
+    } else {
+      std::vector<TaskSpecification> batch;
+      const size_t end = num_sent + std::min<size_t>(batch_size, num_ready);
+      for (; num_sent < end; num_sent++) {
+        batch.push_back(ready[num_sent]->second.first);
+      }
+      PushActorTasks(client_queue, batch);
+    }
+  }
+
+  for (size_t i = 0; i < num_sent; i++) {
+    requests.erase(ready[i]);
   }
+  client_queue.next_send_position += num_sent - num_resent;
 }
 
 void CoreWorkerDirectActorTaskSubmitter::ResendOutOfOrderTasks(const ActorID &actor_id) {
@@ -262,6 +318,11 @@ void CoreWorkerDirectActorTaskSubmitter::ResendOutOfOrderTasks(const ActorID &ac
   }
   auto &client_queue = it->second;
   RAY_CHECK(!client_queue.worker_id.empty());
+  // The actor does not use the sequence numbers if it executes tasks out of order,
+  // so there is nothing to resend.
+  if (client_queue.allow_out_of_order_execution) {
+    return;
+  }
 
   for (const auto &completed_task : client_queue.out_of_order_completed_tasks) {
     // Making a copy here because we are flipping a flag and the original value is
@@ -273,7 +334,7 @@ void CoreWorkerDirectActorTaskSubmitter::ResendOutOfOrderTasks(const ActorID &ac
   client_queue.out_of_order_completed_tasks.clear();
 }
 
-void CoreWorkerDirectActorTaskSubmitter::PushActorTask(const ClientQueue &queue,
+void CoreWorkerDirectActorTaskSubmitter::PushActorTask(ClientQueue &queue,
                                                        const TaskSpecification &task_spec,
                                                        bool skip_queue) {
   auto request = std::unique_ptr<rpc::PushTaskRequest>(new rpc::PushTaskRequest());
@@ -287,67 +348,147 @@ void CoreWorkerDirectActorTaskSubmitter::PushActorTask(const ClientQueue &queue,
       << "actor counter " << task_spec.ActorCounter() << " " << queue.caller_starts_at;
   request->set_sequence_number(task_spec.ActorCounter() - queue.caller_starts_at);
 
-  const auto task_id = task_spec.TaskId();
   const auto actor_id = task_spec.ActorId();
-  const auto actor_counter = task_spec.ActorCounter();
-  const auto task_skipped = task_spec.GetMessage().skip_execution();
-  RAY_LOG(DEBUG) << "Pushing task " << task_id << " to actor " << actor_id
-                 << " actor counter " << actor_counter << " seq no "
+  RAY_LOG(DEBUG) << "Pushing task " << task_spec.TaskId() << " to actor " << actor_id
+                 << " actor counter " << task_spec.ActorCounter() << " seq no "
                  << request->sequence_number();
   rpc::Address addr(queue.rpc_client->Addr());
+  queue.num_pushes_in_flight++;
+  int64_t start_time_us = current_sys_time_us();
   queue.rpc_client->PushActorTask(
       std::move(request), skip_queue,
-      [this, addr, task_id, actor_id, actor_counter, task_spec, task_skipped](
-          Status status, const rpc::PushTaskReply &reply) {
-        bool increment_completed_tasks = true;
-
-        if (task_skipped) {
-          // NOTE(simon):Increment the task counter regardless of the status because the
-          // reply for a previously completed task. We are not calling CompletePendingTask
-          // because the tasks are pushed directly to the actor, not placed on any queues
-          // in task_finisher_.
-        } else if (status.ok()) {
-          task_finisher_->CompletePendingTask(task_id, reply, addr);
-        } else {
-          bool will_retry = task_finisher_->PendingTaskFailed(
-              task_id, rpc::ErrorType::ACTOR_DIED, &status);
-          if (will_retry) {
-            increment_completed_tasks = false;
-          }
-        }
+      [this, addr, actor_id, task_spec, start_time_us](Status status,
+                                                      const rpc::PushTaskReply &reply) {
+        HandlePushTaskReply(status, reply, addr, task_spec);
+        OnPushDone(actor_id, status, start_time_us, 1);
+      });
+}
 
-        if (increment_completed_tasks) {
-          absl::MutexLock lock(&mu_);
-          auto queue_pair = client_queues_.find(actor_id);
-          RAY_CHECK(queue_pair != client_queues_.end());
-          auto &queue = queue_pair->second;
-
-          // Try to increment queue.next_task_reply_position consecutively until we
-          // cannot. In the case of tasks not received in order, the following block
-          // ensure queue.next_task_reply_position are incremented to the max possible
-          // value.
-          queue.out_of_order_completed_tasks.insert({actor_counter, task_spec});
-          auto min_completed_task = queue.out_of_order_completed_tasks.begin();
-          while (min_completed_task != queue.out_of_order_completed_tasks.end()) {
-            if (min_completed_task->first == queue.next_task_reply_position) {
-              queue.next_task_reply_position++;
-              // increment the iterator and erase the old value
-              queue.out_of_order_completed_tasks.erase(min_completed_task++);
-            } else {
-              break;
-            }
-          }
+void CoreWorkerDirectActorTaskSubmitter::PushActorTasks(
+    ClientQueue &queue, const std::vector<TaskSpecification> &task_specs) {
+  auto request = std::unique_ptr<rpc::PushTasksRequest>(new rpc::PushTasksRequest());
+  for (const auto &task_spec : task_specs) {
+    auto task_request = request->add_requests();
+    // NOTE: CopyFrom is needed for the same reason as in PushActorTask.
+    task_request->mutable_task_spec()->CopyFrom(task_spec.GetMessage());
+    task_request->set_intended_worker_id(queue.worker_id);
+    RAY_CHECK(task_spec.ActorCounter() >= queue.caller_starts_at);
+    task_request->set_sequence_number(task_spec.ActorCounter() - queue.caller_starts_at);
+  }
+  request->set_intended_worker_id(queue.worker_id);
 
-          RAY_LOG(DEBUG) << "Got PushTaskReply for actor " << actor_id
-                         << " with actor_counter " << actor_counter
-                         << " new queue.next_task_reply_position is "
-                         << queue.next_task_reply_position
-                         << " and size of out_of_order_tasks set is "
-                         << queue.out_of_order_completed_tasks.size();
+  const auto actor_id = task_specs.front().ActorId();
+  RAY_LOG(DEBUG) << "Pushing " << task_specs.size() << " tasks to actor " << actor_id
+                 << " starting at actor counter " << task_specs.front().ActorCounter();
+  rpc::Address addr(queue.rpc_client->Addr());
+  queue.num_pushes_in_flight++;
+  int64_t start_time_us = current_sys_time_us();
+  queue.rpc_client->PushActorTasks(
+      std::move(request), [this, addr, actor_id, task_specs, start_time_us](
+                              Status status, const rpc::PushTasksReply &reply) {
+        // The actor replies once every task of the batch has a result, so a reply
+        // that doesn't cover the batch can only come with a failed RPC.
+        if (status.ok() && reply.replies_size() != static_cast<int>(task_specs.size())) {
+          status = Status::IOError("The actor replied to a batch with the wrong size");
+        }
+        // The failed tasks, including the ones the actor cancelled before they
+        // started, are handled like tasks whose push failed.
+        Status push_status = status;
+        for (size_t i = 0; i < task_specs.size(); i++) {
+          if (status.ok() && !reply.task_failed(i)) {
+            HandlePushTaskReply(Status::OK(), reply.replies(i), addr, task_specs[i]);
+          } else {
+            Status task_status =
+                status.ok() ? Status::IOError(reply.error_messages(i)) : status;
+            HandlePushTaskReply(task_status, rpc::PushTaskReply(), addr, task_specs[i]);
+            push_status = task_status;
+          }
         }
+        // A push with a failed task is not used to size the batches.
+        OnPushDone(actor_id, push_status, start_time_us, task_specs.size());
       });
 }
 
+void CoreWorkerDirectActorTaskSubmitter::HandlePushTaskReply(
+    Status status, const rpc::PushTaskReply &reply, const rpc::Address &addr,
+    const TaskSpecification &task_spec) {
+  const auto task_id = task_spec.TaskId();
+  const auto actor_id = task_spec.ActorId();
+  const auto actor_counter = task_spec.ActorCounter();
+  const auto task_skipped = task_spec.GetMessage().skip_execution();
+  bool increment_completed_tasks = true;
+
+  if (task_skipped) {
+    // NOTE(simon):Increment the task counter regardless of the status because the
+    // reply for a previously completed task. We are not calling CompletePendingTask
+    // because the tasks are pushed directly to the actor, not placed on any queues
+    // in task_finisher_.
+  } else if (status.ok()) {
+    task_finisher_->CompletePendingTask(task_id, reply, addr);
+  } else {
+    bool will_retry =
+        task_finisher_->PendingTaskFailed(task_id, rpc::ErrorType::ACTOR_DIED, &status);
+    if (will_retry) {
+      increment_completed_tasks = false;
+    }
+  }
+
+  if (increment_completed_tasks) {
+    absl::MutexLock lock(&mu_);
+    auto queue_pair = client_queues_.find(actor_id);
+    RAY_CHECK(queue_pair != client_queues_.end());
+    auto &queue = queue_pair->second;
+    if (queue.allow_out_of_order_execution) {
+      // The replies are not tracked by position, since the actor does not use the
+      // sequence numbers.
+      return;
+    }
+
+    // Try to increment queue.next_task_reply_position consecutively until we
+    // cannot. In the case of tasks not received in order, the following block
+    // ensure queue.next_task_reply_position are incremented to the max possible
+    // value.
+    queue.out_of_order_completed_tasks.insert({actor_counter, task_spec});
+    auto min_completed_task = queue.out_of_order_completed_tasks.begin();
+    while (min_completed_task != queue.out_of_order_completed_tasks.end()) {
+      if (min_completed_task->first == queue.next_task_reply_position) {
+        queue.next_task_reply_position++;
+        // increment the iterator and erase the old value
+        queue.out_of_order_completed_tasks.erase(min_completed_task++);
+      } else {
+        break;
+      }
+    }
+
+    RAY_LOG(DEBUG) << "Got PushTaskReply for actor " << actor_id
+                   << " with actor_counter " << actor_counter
+                   << " new queue.next_task_reply_position is "
+                   << queue.next_task_reply_position
+                   << " and size of out_of_order_tasks set is "
+                   << queue.out_of_order_completed_tasks.size();
+  }
+}
+
+void CoreWorkerDirectActorTaskSubmitter::OnPushDone(const ActorID &actor_id,
+                                                    const Status &status,
+                                                    int64_t start_time_us,
+                                                    size_t num_tasks) {
+  absl::MutexLock lock(&mu_);
+  auto it = client_queues_.find(actor_id);
+  RAY_CHECK(it != client_queues_.end());
+  auto &queue = it->second;
+  RAY_CHECK(queue.num_pushes_in_flight > 0);
+  queue.num_pushes_in_flight--;
+  if (max_tasks_per_push_batch_ > 1) {
+    if (status.ok()) {
+      queue.push_batch_sizer.RecordPushDuration(current_sys_time_us() - start_time_us,
+                                                num_tasks);
+    }
+    // Send the tasks that were held back while the push was in flight.
+    SendPendingTasks(actor_id);
+  }
+}
+
 bool CoreWorkerDirectActorTaskSubmitter::IsActorAlive(const ActorID &actor_id) const {
   absl::MutexLock lock(&mu_);
 
@@ -366,6 +507,12 @@ void CoreWorkerDirectTaskReceiver::Init(
 void CoreWorkerDirectTaskReceiver::HandleTask(
     const rpc::PushTaskRequest &request, rpc::PushTaskReply *reply,
     rpc::SendReplyCallback send_reply_callback) {
+  HandleTask(request, reply, send_reply_callback, /*start_task=*/nullptr);
+}
+
+void CoreWorkerDirectTaskReceiver::HandleTask(
+    const rpc::PushTaskRequest &request, rpc::PushTaskReply *reply,
+    rpc::SendReplyCallback send_reply_callback, std::function<bool()> start_task) {
   RAY_CHECK(waiter_ != nullptr) << "Must call init() prior to use";
   const TaskSpecification task_spec(request.task_spec());
 
@@ -395,7 +542,11 @@ void CoreWorkerDirectTaskReceiver::HandleTask(
     }
   }
 
-  auto accept_callback = [this, reply, send_reply_callback, task_spec, resource_ids]() {
+  auto accept_callback = [this, reply, send_reply_callback, task_spec, resource_ids,
+                          start_task]() {
+    if (start_task && !start_task()) {
+      return;
+    }
     if (task_spec.GetMessage().skip_execution()) {
       send_reply_callback(Status::OK(), nullptr, nullptr);
       return;
@@ -471,11 +622,15 @@ void CoreWorkerDirectTaskReceiver::HandleTask(
   if (task_spec.IsActorTask()) {
     auto it = actor_scheduling_queues_.find(task_spec.CallerWorkerId());
     if (it == actor_scheduling_queues_.end()) {
-      auto result = actor_scheduling_queues_.emplace(
-          task_spec.CallerWorkerId(),
-          std::unique_ptr<SchedulingQueue>(new ActorSchedulingQueue(
-              task_main_io_service_, *waiter_, worker_context_)));
-      it = result.first;
+      std::unique_ptr<SchedulingQueue> queue;
+      if (worker_context_.CurrentActorAllowsOutOfOrderExecution()) {
+        queue.reset(new OutOfOrderActorSchedulingQueue(*waiter_, worker_context_));
+      } else {
+        queue.reset(new ActorSchedulingQueue(task_main_io_service_, *waiter_,
+                                             worker_context_));
+      }
+      it = actor_scheduling_queues_.emplace(task_spec.CallerWorkerId(), std::move(queue))
+               .first;
     }
 
     // Pop the dummy actor dependency.
@@ -491,6 +646,115 @@ void CoreWorkerDirectTaskReceiver::HandleTask(
   }
 }
 
+void CoreWorkerDirectTaskReceiver::HandleTasks(
+    const rpc::PushTasksRequest &request, rpc::PushTasksReply *reply,
+    rpc::SendReplyCallback send_reply_callback) {
+  for (const auto &task_request : request.requests()) {
+    const auto type = task_request.task_spec().type();
+    if ((type != TaskType::NORMAL_TASK && type != TaskType::ACTOR_TASK) ||
+        type != request.requests(0).task_spec().type()) {
+      send_reply_callback(
+          Status::Invalid("Only normal tasks or actor tasks can be pushed in a batch"),
+          nullptr, nullptr);
+      return;
+    }
+  }
+  if (request.requests_size() == 0) {
+    send_reply_callback(Status::OK(), nullptr, nullptr);
+    return;
+  }
+
+  // The replies are kept here until the whole batch is replied to, because the
+  // cancelled tasks are only dequeued after `reply` is gone.
+  enum class TaskState { QUEUED, RUNNING, FINISHED, CANCELLED };
+  struct BatchState {
+    explicit BatchState(size_t num_tasks)
+        : replies(num_tasks), states(num_tasks, TaskState::QUEUED), statuses(num_tasks) {}
+    absl::Mutex mu;
+    std::vector<rpc::PushTaskReply> replies;
+    std::vector<TaskState> states GUARDED_BY(mu);
+    std::vector<Status> statuses GUARDED_BY(mu);
+    /// The number of tasks that finished or were cancelled.
+    size_t num_done GUARDED_BY(mu) = 0;
+    bool replied GUARDED_BY(mu) = false;
+    /// Whether the tasks are still being enqueued. Actor tasks may run while this is
+    /// going on, and the reply is held back until it is done, since sending it
+    /// releases the request.
+    bool enqueuing GUARDED_BY(mu) = true;
+  };
+  const size_t num_tasks = request.requests_size();
+  auto batch = std::make_shared<BatchState>(num_tasks);
+  for (size_t i = 0; i < num_tasks; i++) {
+    auto start_task = [batch, i]() {
+      absl::MutexLock lock(&batch->mu);
+      if (batch->states[i] == TaskState::CANCELLED) {
+        return false;
+      }
+      batch->states[i] = TaskState::RUNNING;
+      return true;
+    };
+    auto task_reply_callback = [batch, i, num_tasks, reply, send_reply_callback](
+                                   Status status, std::function<void()> success,
+                                   std::function<void()> failure) {
+      {
+        absl::MutexLock lock(&batch->mu);
+        // A cancelled task may still be rejected by its scheduling queue.
+        if (batch->states[i] == TaskState::CANCELLED) {
+          return;
+        }
+        batch->states[i] = TaskState::FINISHED;
+        batch->statuses[i] = status;
+        batch->num_done++;
+        if (!status.ok() || batch->replies[i].worker_exiting()) {
+          // The tasks that already started can't be stopped, so the reply waits for
+          // them, but the others must not run once the batch has failed.
+          for (size_t j = 0; j < num_tasks; j++) {
+            if (batch->states[j] == TaskState::QUEUED) {
+              batch->states[j] = TaskState::CANCELLED;
+              batch->num_done++;
+            }
+          }
+        }
+        if (batch->num_done < num_tasks) {
+          return;
+        }
+        batch->replied = true;
+        // The failures are part of the reply rather than the RPC status, because gRPC
+        // drops the reply of a failed RPC.
+        for (size_t j = 0; j < num_tasks; j++) {
+          auto task_reply = reply->add_replies();
+          const bool cancelled = batch->states[j] == TaskState::CANCELLED;
+          const Status &task_status = batch->statuses[j];
+          if (!cancelled && task_status.ok()) {
+            task_reply->Swap(&batch->replies[j]);
+          }
+          reply->add_task_failed(cancelled || !task_status.ok());
+          reply->add_error_messages(
+              cancelled ? "The task was cancelled because another task in its batch "
+                          "failed"
+                        : (task_status.ok() ? "" : task_status.ToString()));
+          reply->add_task_cancelled(cancelled);
+        }
+        if (batch->enqueuing) {
+          return;
+        }
+      }
+      send_reply_callback(Status::OK(), nullptr, nullptr);
+    };
+    HandleTask(request.requests(i), &batch->replies[i], task_reply_callback, start_task);
+  }
+
+  bool replied;
+  {
+    absl::MutexLock lock(&batch->mu);
+    batch->enqueuing = false;
+    replied = batch->replied;
+  }
+  if (replied) {
+    send_reply_callback(Status::OK(), nullptr, nullptr);
+  }
+}
+
 void CoreWorkerDirectTaskReceiver::RunNormalTasksFromQueue() {
   // If the scheduling queue is empty, return.
   if (normal_scheduling_queue_->TaskQueueEmpty()) {
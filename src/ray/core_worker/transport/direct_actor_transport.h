@@ -32,6 +32,7 @@
 #include "ray/core_worker/store_provider/memory_store/memory_store.h"
 #include "ray/core_worker/task_manager.h"
 #include "ray/core_worker/transport/dependency_resolver.h"
+#include "ray/core_worker/transport/push_batch_sizer.h"
 #include "ray/rpc/grpc_server.h"
 #include "ray/rpc/worker/core_worker_client.h"
 
@@ -48,7 +49,9 @@ const int kMaxReorderWaitSeconds = 30;
 // Interface for testing.
 class CoreWorkerDirectActorTaskSubmitterInterface {
  public:
-  virtual void AddActorQueueIfNotExists(const ActorID &actor_id) = 0;
+  virtual void AddActorQueueIfNotExists(const ActorID &actor_id,
+                                        bool allow_out_of_order_execution = false,
+                                        bool executes_tasks_concurrently = false) = 0;
   virtual void ConnectActor(const ActorID &actor_id, const rpc::Address &address,
                             int64_t num_restarts) = 0;
   virtual void DisconnectActor(const ActorID &actor_id, int64_t num_restarts,
@@ -65,10 +68,15 @@ class CoreWorkerDirectActorTaskSubmitter
   CoreWorkerDirectActorTaskSubmitter(
       std::shared_ptr<rpc::CoreWorkerClientPool> core_worker_client_pool,
       std::shared_ptr<CoreWorkerMemoryStore> store,
-      std::shared_ptr<TaskFinisherInterface> task_finisher)
+      std::shared_ptr<TaskFinisherInterface> task_finisher,
+      uint32_t max_tasks_per_push_batch =
+          RayConfig::instance().max_actor_tasks_per_push_batch())
       : core_worker_client_pool_(core_worker_client_pool),
         resolver_(store, task_finisher),
-        task_finisher_(task_finisher) {}
+        task_finisher_(task_finisher),
+        max_tasks_per_push_batch_(max_tasks_per_push_batch),
+        push_batch_target_duration_us_(
+            RayConfig::instance().task_push_batch_target_duration_us()) {}
 
   /// Add an actor queue. This should be called whenever a reference to an
   /// actor is created in the language frontend.
@@ -76,7 +84,15 @@ class CoreWorkerDirectActorTaskSubmitter
   /// not receive another reference to the same actor.
   ///
   /// \param[in] actor_id The actor for whom to add a queue.
-  void AddActorQueueIfNotExists(const ActorID &actor_id);
+  /// \param[in] allow_out_of_order_execution Whether the actor may execute tasks out
+  /// of submission order. If so, tasks are sent as soon as their dependencies are
+  /// resolved.
+  /// \param[in] executes_tasks_concurrently Whether the actor may run several tasks at
+  /// once. If so, ready tasks are never held back while a push is in flight, since
+  /// the push may wait on them.
+  void AddActorQueueIfNotExists(const ActorID &actor_id,
+                                bool allow_out_of_order_execution = false,
+                                bool executes_tasks_concurrently = false);
 
   /// Submit a task to an actor for execution.
   ///
@@ -196,6 +212,19 @@ class CoreWorkerDirectActorTaskSubmitter
     /// A force-kill request that should be sent to the actor once an RPC
     /// client to the actor is available.
     absl::optional<rpc::KillActorRequest> pending_force_kill;
+
+    /// Whether the actor executes tasks out of submission order. If so, a task is
+    /// sent as soon as its dependencies are resolved, and the replies are not tracked
+    /// by position, since the actor does not use the sequence numbers.
+    bool allow_out_of_order_execution = false;
+    /// Whether the actor may run several tasks at once. An in-flight push can then
+    /// wait on a task that is still ready to send, so tasks are not held back.
+    bool executes_tasks_concurrently = false;
+    /// The number of pushes to the actor that have not been replied to yet, over all
+    /// incarnations of the actor.
+    int64_t num_pushes_in_flight = 0;
+    /// Sizes the batches of tasks pushed to the actor.
+    PushBatchSizer push_batch_sizer;
   };
 
   /// Push a task to a remote actor via the given client.
@@ -207,9 +236,38 @@ class CoreWorkerDirectActorTaskSubmitter
   /// \param[in] skip_queue Whether to skip the task queue. This will send the
   /// task for execution immediately.
   /// \return Void.
-  void PushActorTask(const ClientQueue &queue, const TaskSpecification &task_spec,
+  void PushActorTask(ClientQueue &queue, const TaskSpecification &task_spec,
                      bool skip_queue) EXCLUSIVE_LOCKS_REQUIRED(mu_);
 
+  /// Push a batch of tasks to a remote actor in a single RPC. The tasks are queued at
+  /// the actor in order, like tasks pushed one by one without skipping the queue.
+  ///
+  /// \param[in] queue The actor queue. Contains the RPC client state.
+  /// \param[in] task_specs The tasks to send, in sequence number order.
+  void PushActorTasks(ClientQueue &queue,
+                      const std::vector<TaskSpecification> &task_specs)
+      EXCLUSIVE_LOCKS_REQUIRED(mu_);
+
+  /// Handle the reply to a task pushed to an actor, on its own or in a batch.
+  ///
+  /// \param[in] status The status of the push.
+  /// \param[in] reply The reply of the task.
+  /// \param[in] addr The address of the actor.
+  /// \param[in] task_spec The task that was pushed.
+  void HandlePushTaskReply(Status status, const rpc::PushTaskReply &reply,
+                           const rpc::Address &addr, const TaskSpecification &task_spec)
+      LOCKS_EXCLUDED(mu_);
+
+  /// Record that a push to an actor is done, and send the tasks that were held back
+  /// while it was in flight.
+  ///
+  /// \param[in] actor_id The actor that the push was sent to.
+  /// \param[in] status The status of the push.
+  /// \param[in] start_time_us When the push was sent.
+  /// \param[in] num_tasks The number of tasks in the push.
+  void OnPushDone(const ActorID &actor_id, const Status &status, int64_t start_time_us,
+                  size_t num_tasks) LOCKS_EXCLUDED(mu_);
+
   /// Send all pending tasks for an actor.
   ///
   /// \param[in] actor_id Actor ID.
@@ -246,6 +304,13 @@ class CoreWorkerDirectActorTaskSubmitter
   /// Used to complete tasks.
   std::shared_ptr<TaskFinisherInterface> task_finisher_;
 
+  /// The maximum number of tasks to push to an actor in a single RPC. If this is 1,
+  /// tasks are pushed one by one, as soon as they can be sent.
+  const uint32_t max_tasks_per_push_batch_;
+
+  /// The target execution time of a batch of tasks pushed to an actor.
+  const uint64_t push_batch_target_duration_us_;
+
   friend class CoreWorkerTest;
 };
 
@@ -340,6 +405,58 @@ class BoundedExecutor {
   boost::asio::thread_pool pool_;
 };
 
+/// Runs the actor tasks accepted by a scheduling queue: on a fiber for async actors, on
+/// a thread pool for threaded actors, and otherwise on the calling thread.
+class ActorTaskExecutor {
+ public:
+  explicit ActorTaskExecutor(WorkerContext &worker_context)
+      : worker_context_(worker_context) {}
+
+  /// Run an accepted request.
+  void Execute(InboundRequest request) {
+    // Only call SetMaxActorConcurrency to configure threadpool size when the
+    // actor is not async actor. Async actor is single threaded.
+    int max_concurrency = worker_context_.CurrentActorMaxConcurrency();
+    if (worker_context_.CurrentActorIsAsync()) {
+      // If this is an async actor, initialize the fiber state once.
+      if (!is_asyncio_) {
+        RAY_LOG(DEBUG) << "Setting direct actor as async, creating new fiber thread.";
+        fiber_state_.reset(new FiberState(max_concurrency));
+        is_asyncio_ = true;
+      }
+    } else {
+      // If this is a concurrency actor (not async), initialize the thread pool once.
+      if (max_concurrency != 1 && !pool_) {
+        RAY_LOG(INFO) << "Creating new thread pool of size " << max_concurrency;
+        pool_.reset(new BoundedExecutor(max_concurrency));
+      }
+    }
+
+    if (is_asyncio_) {
+      // Process async actor task.
+      fiber_state_->EnqueueFiber([request]() mutable { request.Accept(); });
+    } else if (pool_) {
+      // Process concurrent actor task.
+      pool_->PostBlocking([request]() mutable { request.Accept(); });
+    } else {
+      // Process normal actor task.
+      request.Accept();
+    }
+  }
+
+ private:
+  // Worker context.
+  WorkerContext &worker_context_;
+  /// If concurrent calls are allowed, holds the pool for executing these tasks.
+  std::unique_ptr<BoundedExecutor> pool_;
+  /// Whether we should enqueue requests into asyncio pool. Setting this to true
+  /// will instantiate all tasks as fibers that can be yielded.
+  bool is_asyncio_ = false;
+  /// If use_asyncio_ is true, fiber_state_ contains the running state required
+  /// to enable continuation and work together with python asyncio.
+  std::unique_ptr<FiberState> fiber_state_;
+};
+
 /// Used to implement task queueing at the worker. Abstraction to provide a common
 /// interface for actor tasks as well as normal ones.
 class SchedulingQueue {
@@ -360,11 +477,11 @@ class ActorSchedulingQueue : public SchedulingQueue {
   ActorSchedulingQueue(boost::asio::io_service &main_io_service, DependencyWaiter &waiter,
                        WorkerContext &worker_context,
                        int64_t reorder_wait_seconds = kMaxReorderWaitSeconds)
-      : worker_context_(worker_context),
-        reorder_wait_seconds_(reorder_wait_seconds),
+      : reorder_wait_seconds_(reorder_wait_seconds),
         wait_timer_(main_io_service),
         main_thread_id_(boost::this_thread::get_id()),
-        waiter_(waiter) {}
+        waiter_(waiter),
+        executor_(worker_context) {}
 
   bool TaskQueueEmpty() const { return pending_actor_tasks_.empty(); }
 
@@ -399,24 +516,6 @@ class ActorSchedulingQueue : public SchedulingQueue {
 
   /// Schedules as many requests as possible in sequence.
   void ScheduleRequests() {
-    // Only call SetMaxActorConcurrency to configure threadpool size when the
-    // actor is not async actor. Async actor is single threaded.
-    int max_concurrency = worker_context_.CurrentActorMaxConcurrency();
-    if (worker_context_.CurrentActorIsAsync()) {
-      // If this is an async actor, initialize the fiber state once.
-      if (!is_asyncio_) {
-        RAY_LOG(DEBUG) << "Setting direct actor as async, creating new fiber thread.";
-        fiber_state_.reset(new FiberState(max_concurrency));
-        is_asyncio_ = true;
-      }
-    } else {
-      // If this is a concurrency actor (not async), initialize the thread pool once.
-      if (max_concurrency != 1 && !pool_) {
-        RAY_LOG(INFO) << "Creating new thread pool of size " << max_concurrency;
-        pool_.reset(new BoundedExecutor(max_concurrency));
-      }
-    }
-
     // Cancel any stale requests that the client doesn't need any longer.
     while (!pending_actor_tasks_.empty() &&
            pending_actor_tasks_.begin()->first < next_seq_no_) {
@@ -433,19 +532,9 @@ class ActorSchedulingQueue : public SchedulingQueue {
            pending_actor_tasks_.begin()->second.CanExecute()) {
       auto head = pending_actor_tasks_.begin();
       auto request = head->second;
-
-      if (is_asyncio_) {
-        // Process async actor task.
-        fiber_state_->EnqueueFiber([request]() mutable { request.Accept(); });
-      } else if (pool_) {
-        // Process concurrent actor task.
-        pool_->PostBlocking([request]() mutable { request.Accept(); });
-      } else {
-        // Process normal actor task.
-        request.Accept();
-      }
       pending_actor_tasks_.erase(head);
       next_seq_no_++;
+      executor_.Execute(request);
     }
 
     if (pending_actor_tasks_.empty() ||
@@ -480,8 +569,6 @@ class ActorSchedulingQueue : public SchedulingQueue {
     }
   }
 
-  // Worker context.
-  WorkerContext &worker_context_;
   /// Max time in seconds to wait for dependencies to show up.
   const int64_t reorder_wait_seconds_ = 0;
   /// Sorted map of (accept, rej) task callbacks keyed by their sequence number.
@@ -495,17 +582,75 @@ class ActorSchedulingQueue : public SchedulingQueue {
   boost::thread::id main_thread_id_;
   /// Reference to the waiter owned by the task receiver.
   DependencyWaiter &waiter_;
-  /// If concurrent calls are allowed, holds the pool for executing these tasks.
-  std::unique_ptr<BoundedExecutor> pool_;
-  /// Whether we should enqueue requests into asyncio pool. Setting this to true
-  /// will instantiate all tasks as fibers that can be yielded.
-  bool is_asyncio_ = false;
-  /// If use_asyncio_ is true, fiber_state_ contains the running state required
-  /// to enable continuation and work together with python asyncio.
-  std::unique_ptr<FiberState> fiber_state_;
+  /// Runs the tasks once they are accepted.
+  ActorTaskExecutor executor_;
   friend class SchedulingQueueTest;
 };
 
+/// Used to execute the tasks of an actor that allows out-of-order execution. The tasks
+/// run as soon as their dependencies are available, regardless of their sequence
+/// numbers, so there is no waiting for earlier tasks and no reordering timeout.
+class OutOfOrderActorSchedulingQueue : public SchedulingQueue {
+ public:
+  OutOfOrderActorSchedulingQueue(DependencyWaiter &waiter, WorkerContext &worker_context)
+      : main_thread_id_(boost::this_thread::get_id()),
+        waiter_(waiter),
+        executor_(worker_context) {}
+
+  bool TaskQueueEmpty() const { return pending_actor_tasks_.empty(); }
+
+  /// Add a new actor task's callbacks to the worker queue.
+  void Add(int64_t seq_no, int64_t client_processed_up_to,
+           std::function<void()> accept_request, std::function<void()> reject_request,
+           const std::vector<rpc::ObjectReference> &dependencies = {}) {
+    RAY_CHECK(boost::this_thread::get_id() == main_thread_id_);
+    if (dependencies.empty()) {
+      executor_.Execute(InboundRequest(accept_request, reject_request, false));
+      return;
+    }
+    const int64_t request_id = next_request_id_++;
+    pending_actor_tasks_[request_id] =
+        InboundRequest(accept_request, reject_request, /*has_dependencies=*/true);
+    waiter_.Wait(dependencies, [request_id, this]() {
+      RAY_CHECK(boost::this_thread::get_id() == main_thread_id_);
+      auto it = pending_actor_tasks_.find(request_id);
+      if (it != pending_actor_tasks_.end()) {
+        it->second.MarkDependenciesSatisfied();
+        ScheduleRequests();
+      }
+    });
+  }
+
+  /// Executes all the requests whose dependencies are available.
+  void ScheduleRequests() {
+    std::vector<InboundRequest> ready;
+    for (auto it = pending_actor_tasks_.begin(); it != pending_actor_tasks_.end();) {
+      if (it->second.CanExecute()) {
+        ready.push_back(it->second);
+        pending_actor_tasks_.erase(it++);
+      } else {
+        it++;
+      }
+    }
+    for (auto &request : ready) {
+      executor_.Execute(request);
+    }
+  }
+
+ private:
+  /// The id of the thread that constructed this scheduling queue.
+  boost::thread::id main_thread_id_;
+  /// Reference to the waiter owned by the task receiver.
+  DependencyWaiter &waiter_;
+  /// The tasks that are waiting for their dependencies, keyed by the order in which
+  /// they were added.
+  std::map<int64_t, InboundRequest> pending_actor_tasks_;
+  /// The key of the next task added to the queue.
+  int64_t next_request_id_ = 0;
+  /// Runs the tasks once they are accepted.
+  ActorTaskExecutor executor_;
+};
+
 /// Used to implement the non-actor task queue. These tasks do not have ordering
 /// constraints.
 class NormalSchedulingQueue : public SchedulingQueue {
@@ -580,10 +725,28 @@ class CoreWorkerDirectTaskReceiver {
   void HandleTask(const rpc::PushTaskRequest &request, rpc::PushTaskReply *reply,
                   rpc::SendReplyCallback send_reply_callback);
 
+  /// Handle a `PushTasks` request. This enqueues each of the tasks in the batch like
+  /// `HandleTask`. The tasks are either all normal tasks or all actor tasks. Once one
+  /// of them fails or makes the worker exit, the tasks of the batch that have not
+  /// started yet are cancelled. The reply is sent once every task has finished or was
+  /// cancelled.
+  ///
+  /// \param[in] request The request message.
+  /// \param[out] reply The reply message.
+  /// \param[in] send_reply_callback The callback to be called when the request is done.
+  void HandleTasks(const rpc::PushTasksRequest &request, rpc::PushTasksReply *reply,
+                   rpc::SendReplyCallback send_reply_callback);
+
   /// Pop tasks from the queue and execute them sequentially
   void RunNormalTasksFromQueue();
 
  private:
+  /// Handle a task like the public `HandleTask`, but call `start_task` right before
+  /// the task runs. The task is skipped without a reply if it returns false.
+  void HandleTask(const rpc::PushTaskRequest &request, rpc::PushTaskReply *reply,
+                  rpc::SendReplyCallback send_reply_callback,
+                  std::function<bool()> start_task);
+
   // Worker context.
   WorkerContext &worker_context_;
   /// The callback function to process a task.
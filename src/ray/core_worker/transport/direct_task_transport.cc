@@ -61,82 +61,113 @@ Status CoreWorkerDirectTaskSubmitter::SubmitTask(TaskSpecification task_spec) {
       return;
     }
 
-    bool keep_executing = true;
+    auto &shard = GetShard(task_spec.GetSchedulingClass());
     {
-      absl::MutexLock lock(&mu_);
-      if (cancelled_tasks_.find(task_spec.TaskId()) != cancelled_tasks_.end()) {
-        cancelled_tasks_.erase(task_spec.TaskId());
-        keep_executing = false;
+      absl::MutexLock lock(&shard.inbox_mu);
+      shard.inbox.push_back(task_spec);
+      if (shard.draining) {
+        // The thread that is draining the inbox will queue the task.
+        return;
       }
-      if (keep_executing) {
-        // Note that the dependencies in the task spec are mutated to only contain
-        // plasma dependencies after ResolveDependencies finishes.
-        const SchedulingKey scheduling_key(
-            task_spec.GetSchedulingClass(), task_spec.GetDependencyIds(),
-            task_spec.IsActorCreationTask() ? task_spec.ActorCreationId()
-                                            : ActorID::Nil());
-        auto &scheduling_key_entry = scheduling_key_entries_[scheduling_key];
-        scheduling_key_entry.task_queue.push_back(task_spec);
-        if (!scheduling_key_entry.AllPipelinesToWorkersFull(
-                max_tasks_in_flight_per_worker_)) {
-          // The pipelines to the current workers are not full yet, so we don't need more
-          // workers.
-
-          // Find a worker with a number of tasks in flight that is less than the maximum
-          // value (max_tasks_in_flight_per_worker_) and call OnWorkerIdle to send tasks
-          // to that worker
-          for (auto active_worker_addr : scheduling_key_entry.active_workers) {
-            RAY_CHECK(worker_to_lease_entry_.find(active_worker_addr) !=
-                      worker_to_lease_entry_.end());
-            auto &lease_entry = worker_to_lease_entry_[active_worker_addr];
-            if (!lease_entry.PipelineToWorkerFull(max_tasks_in_flight_per_worker_)) {
-              OnWorkerIdle(active_worker_addr, scheduling_key, false,
-                           lease_entry.assigned_resources);
-              // If we find a worker with a non-full pipeline, all we need to do is to
-              // submit the new task to the worker in question by calling OnWorkerIdle
-              // once. We don't need to worry about other tasks in the queue because the
-              // queue cannot have other tasks in it if there are active workers with
-              // non-full pipelines.
-              break;
-            }
-          }
+      shard.draining = true;
+    }
+    DrainInbox(shard);
+  });
+  return Status::OK();
+}
+
+void CoreWorkerDirectTaskSubmitter::DrainInbox(Shard &shard) {
+  std::vector<TaskID> cancelled_task_ids;
+  {
+    absl::MutexLock lock(&shard.mu);
+    std::vector<TaskSpecification> task_specs;
+    while (true) {
+      {
+        absl::MutexLock inbox_lock(&shard.inbox_mu);
+        if (shard.inbox.empty()) {
+          shard.draining = false;
+          break;
+        }
+        task_specs.swap(shard.inbox);
+      }
+      for (const auto &task_spec : task_specs) {
+        if (shard.cancelled_tasks.erase(task_spec.TaskId()) > 0) {
+          cancelled_task_ids.push_back(task_spec.TaskId());
+        } else {
+          EnqueueTask(shard, task_spec);
         }
-        RequestNewWorkerIfNeeded(scheduling_key);
       }
+      task_specs.clear();
     }
-    if (!keep_executing) {
-      RAY_UNUSED(task_finisher_->PendingTaskFailed(
-          task_spec.TaskId(), rpc::ErrorType::TASK_CANCELLED, nullptr));
+  }
+  for (const auto &task_id : cancelled_task_ids) {
+    RAY_UNUSED(task_finisher_->PendingTaskFailed(task_id, rpc::ErrorType::TASK_CANCELLED,
+                                                 nullptr));
+  }
+}
+
+void CoreWorkerDirectTaskSubmitter::EnqueueTask(Shard &shard,
+                                                const TaskSpecification &task_spec) {
+  // Note that the dependencies in the task spec are mutated to only contain
+  // plasma dependencies after ResolveDependencies finishes.
+  const SchedulingKey scheduling_key(
+      task_spec.GetSchedulingClass(), task_spec.GetDependencyIds(),
+      task_spec.IsActorCreationTask() ? task_spec.ActorCreationId() : ActorID::Nil());
+  auto &scheduling_key_entry = shard.scheduling_key_entries[scheduling_key];
+  scheduling_key_entry.task_queue.push_back(task_spec);
+  if (!scheduling_key_entry.AllPipelinesToWorkersFull(max_tasks_in_flight_per_worker_)) {
+    // The pipelines to the current workers are not full yet, so we don't need more
+    // workers.
+
+    // Find a worker with a number of tasks in flight that is less than the maximum
+    // value (max_tasks_in_flight_per_worker_) and call OnWorkerIdle to send tasks
+    // to that worker
+    for (auto active_worker_addr : scheduling_key_entry.active_workers) {
+      RAY_CHECK(shard.worker_to_lease_entry.find(active_worker_addr) !=
+                shard.worker_to_lease_entry.end());
+      auto &lease_entry = shard.worker_to_lease_entry[active_worker_addr];
+      if (!lease_entry.PipelineToWorkerFull(max_tasks_in_flight_per_worker_)) {
+        OnWorkerIdle(shard, active_worker_addr, scheduling_key, false,
+                     lease_entry.assigned_resources);
+        // If we find a worker with a non-full pipeline, all we need to do is to
+        // submit the new task to the worker in question by calling OnWorkerIdle
+        // once. We don't need to worry about other tasks in the queue because the
+        // queue cannot have other tasks in it if there are active workers with
+        // non-full pipelines.
+        break;
+      }
     }
-  });
-  return Status::OK();
+  }
+  RequestNewWorkerIfNeeded(shard, scheduling_key);
 }
 
 void CoreWorkerDirectTaskSubmitter::AddWorkerLeaseClient(
-    const rpc::WorkerAddress &addr, std::shared_ptr<WorkerLeaseInterface> lease_client,
+    Shard &shard, const rpc::WorkerAddress &addr,
+    std::shared_ptr<WorkerLeaseInterface> lease_client,
     const google::protobuf::RepeatedPtrField<rpc::ResourceMapEntry> &assigned_resources,
     const SchedulingKey &scheduling_key) {
   client_cache_->GetOrConnect(addr.ToProto());
   int64_t expiration = current_time_ms() + lease_timeout_ms_;
   LeaseEntry new_lease_entry = LeaseEntry(std::move(lease_client), expiration, 0,
                                           assigned_resources, scheduling_key);
-  worker_to_lease_entry_.emplace(addr, new_lease_entry);
+  shard.worker_to_lease_entry.emplace(addr, new_lease_entry);
 
-  auto &scheduling_key_entry = scheduling_key_entries_[scheduling_key];
+  auto &scheduling_key_entry = shard.scheduling_key_entries[scheduling_key];
   RAY_CHECK(scheduling_key_entry.active_workers.emplace(addr).second);
   RAY_CHECK(scheduling_key_entry.active_workers.size() >= 1);
 }
 
 void CoreWorkerDirectTaskSubmitter::OnWorkerIdle(
-    const rpc::WorkerAddress &addr, const SchedulingKey &scheduling_key, bool was_error,
+    Shard &shard, const rpc::WorkerAddress &addr, const SchedulingKey &scheduling_key,
+    bool was_error,
     const google::protobuf::RepeatedPtrField<rpc::ResourceMapEntry> &assigned_resources) {
-  auto &lease_entry = worker_to_lease_entry_[addr];
+  auto &lease_entry = shard.worker_to_lease_entry[addr];
   if (!lease_entry.lease_client) {
     return;
   }
   RAY_CHECK(lease_entry.lease_client);
 
-  auto &scheduling_key_entry = scheduling_key_entries_[scheduling_key];
+  auto &scheduling_key_entry = shard.scheduling_key_entries[scheduling_key];
   auto &current_queue = scheduling_key_entry.task_queue;
   // Return the worker if there was an error executing the previous task,
   // the previous task is an actor creation task,
@@ -147,56 +178,193 @@ void CoreWorkerDirectTaskSubmitter::OnWorkerIdle(
 
     // Return the worker only if there are no tasks in flight
     if (lease_entry.tasks_in_flight == 0) {
+      bool lease_usable =
+          !was_error && current_time_ms() <= lease_entry.lease_expiration_time;
       // Decrement the number of active workers consuming tasks from the queue associated
       // with the current scheduling_key
       scheduling_key_entry.active_workers.erase(addr);
       if (scheduling_key_entry.CanDelete()) {
         // We can safely remove the entry keyed by scheduling_key from the
-        // scheduling_key_entries_ hashmap.
-        scheduling_key_entries_.erase(scheduling_key);
+        // scheduling_key_entries hashmap.
+        shard.scheduling_key_entries.erase(scheduling_key);
       }
 
-      auto status =
-          lease_entry.lease_client->ReturnWorker(addr.port, addr.worker_id, was_error);
-      if (!status.ok()) {
-        RAY_LOG(ERROR) << "Error returning worker to raylet: " << status.ToString();
+      if (!lease_usable || !KeepIdleWorker(shard, addr, scheduling_key)) {
+        auto status =
+            lease_entry.lease_client->ReturnWorker(addr.port, addr.worker_id, was_error);
+        if (!status.ok()) {
+          RAY_LOG(ERROR) << "Error returning worker to raylet: " << status.ToString();
+        }
+        shard.worker_to_lease_entry.erase(addr);
       }
-      worker_to_lease_entry_.erase(addr);
     }
 
   } else {
     auto &client = *client_cache_->GetOrConnect(addr.ToProto());
 
+    // Actor creation tasks always get a worker of their own.
+    const uint32_t batch_size =
+        std::get<2>(scheduling_key).IsNil()
+            ? scheduling_key_entry.push_batch_sizer.BatchSize(
+                  max_tasks_per_push_batch_, push_batch_target_duration_us_)
+            : 1;
     while (!current_queue.empty() &&
            !lease_entry.PipelineToWorkerFull(max_tasks_in_flight_per_worker_)) {
-      auto task_spec = current_queue.front();
       lease_entry
-          .tasks_in_flight++;  // Increment the number of tasks in flight to the worker
+          .tasks_in_flight++;  // Increment the number of pushes in flight to the worker
 
-      // Increment the total number of tasks in flight to any worker associated with the
+      // Increment the total number of pushes in flight to any worker associated with the
       // current scheduling_key
 
       RAY_CHECK(scheduling_key_entry.active_workers.size() >= 1);
       scheduling_key_entry.total_tasks_in_flight++;
 
-      executing_tasks_.emplace(task_spec.TaskId(), addr);
-      PushNormalTask(addr, client, scheduling_key, task_spec, assigned_resources);
-      current_queue.pop_front();
+      if (batch_size == 1) {
+        auto task_spec = current_queue.front();
+        shard.executing_tasks.emplace(task_spec.TaskId(), addr);
+        PushNormalTask(addr, client, scheduling_key, task_spec, assigned_resources);
+        current_queue.pop_front();
+      } else {
+        std::vector<TaskSpecification> task_specs;
+        while (!current_queue.empty() && task_specs.size() < batch_size) {
+          task_specs.push_back(std::move(current_queue.front()));
+          current_queue.pop_front();
+          shard.executing_tasks.emplace(task_specs.back().TaskId(), addr);
+        }
+        PushNormalTasks(addr, client, scheduling_key, task_specs, assigned_resources);
+      }
     }
 
     // Delete the queue if it's now empty. Note that the queue cannot already be empty
     // because this is the only place tasks are removed from it.
     if (current_queue.empty()) {
       RAY_LOG(INFO) << "Task queue empty, canceling lease request";
-      CancelWorkerLeaseIfNeeded(scheduling_key);
+      CancelWorkerLeaseIfNeeded(shard, scheduling_key);
     }
   }
-  RequestNewWorkerIfNeeded(scheduling_key);
+  RequestNewWorkerIfNeeded(shard, scheduling_key);
+}
+
+bool CoreWorkerDirectTaskSubmitter::KeepIdleWorker(Shard &shard,
+                                                   const rpc::WorkerAddress &addr,
+                                                   const SchedulingKey &scheduling_key) {
+  // Actor creation tasks need a lease of their own, see SchedulingKey.
+  if (!std::get<2>(scheduling_key).IsNil()) {
+    return false;
+  }
+  const SchedulingClass scheduling_class = std::get<0>(scheduling_key);
+
+  // Tasks with other plasma dependencies but the same resource shape can run on the
+  // worker right away. Their queue is only non-empty if their workers are all busy.
+  // They are in the same shard, since the shards are split by scheduling class.
+  for (const auto &entry : shard.scheduling_key_entries) {
+    if (std::get<0>(entry.first) == scheduling_class &&
+        std::get<2>(entry.first).IsNil() && !entry.second.task_queue.empty()) {
+      const SchedulingKey other_key = entry.first;
+      AssignIdleWorker(shard, addr, other_key);
+      return true;
+    }
+  }
+
+  if (!idle_lease_timer_.has_value() || idle_lease_grace_period_ms_ <= 0) {
+    return false;
+  }
+  const int64_t return_time_ms = current_time_ms() + idle_lease_grace_period_ms_;
+  shard.idle_workers[scheduling_class].push_back({addr, return_time_ms});
+  ScheduleIdleWorkerReturn(return_time_ms);
+  return true;
+}
+
+void CoreWorkerDirectTaskSubmitter::AssignIdleWorker(
+    Shard &shard, const rpc::WorkerAddress &addr, const SchedulingKey &scheduling_key) {
+  auto &lease_entry = shard.worker_to_lease_entry[addr];
+  RAY_CHECK(lease_entry.tasks_in_flight == 0);
+  RAY_CHECK(std::get<0>(lease_entry.scheduling_key) == std::get<0>(scheduling_key));
+  RAY_LOG(DEBUG) << "Reusing the lease of worker " << addr.worker_id
+                 << " for another scheduling key";
+  lease_entry.scheduling_key = scheduling_key;
+  RAY_CHECK(
+      shard.scheduling_key_entries[scheduling_key].active_workers.emplace(addr).second);
+  // Copy, since OnWorkerIdle may erase the lease entry.
+  const auto assigned_resources = lease_entry.assigned_resources;
+  OnWorkerIdle(shard, addr, scheduling_key, /*was_error=*/false, assigned_resources);
+}
+
+bool CoreWorkerDirectTaskSubmitter::ReuseIdleWorker(Shard &shard,
+                                                    const SchedulingKey &scheduling_key) {
+  if (!std::get<2>(scheduling_key).IsNil()) {
+    return false;
+  }
+  auto it = shard.idle_workers.find(std::get<0>(scheduling_key));
+  if (it == shard.idle_workers.end()) {
+    return false;
+  }
+  // Take the most recently used worker, which is the least likely to be returned soon.
+  const auto addr = it->second.back().addr;
+  it->second.pop_back();
+  if (it->second.empty()) {
+    shard.idle_workers.erase(it);
+  }
+  AssignIdleWorker(shard, addr, scheduling_key);
+  return true;
+}
+
+void CoreWorkerDirectTaskSubmitter::ScheduleIdleWorkerReturn(int64_t return_time_ms) {
+  absl::MutexLock lock(&timer_mu_);
+  if (idle_lease_timer_armed_ && idle_lease_timer_expiry_ms_ <= return_time_ms) {
+    return;
+  }
+  idle_lease_timer_armed_ = true;
+  idle_lease_timer_expiry_ms_ = return_time_ms;
+  idle_lease_timer_->expires_after(boost::asio::chrono::milliseconds(
+      std::max<int64_t>(return_time_ms - current_time_ms(), 0)));
+  idle_lease_timer_->async_wait([this](const boost::system::error_code &error) {
+    if (error != boost::asio::error::operation_aborted) {
+      ReturnExpiredIdleWorkers();
+    }
+  });
+}
+
+void CoreWorkerDirectTaskSubmitter::ReturnExpiredIdleWorkers() {
+  {
+    absl::MutexLock lock(&timer_mu_);
+    idle_lease_timer_armed_ = false;
+  }
+  const int64_t now_ms = current_time_ms();
+  int64_t next_return_time_ms = std::numeric_limits<int64_t>::max();
+  for (auto &shard : shards_) {
+    absl::MutexLock lock(&shard->mu);
+    for (auto it = shard->idle_workers.begin(); it != shard->idle_workers.end();) {
+      auto &queue = it->second;
+      while (!queue.empty() && queue.front().return_time_ms <= now_ms) {
+        const auto &addr = queue.front().addr;
+        auto lease_it = shard->worker_to_lease_entry.find(addr);
+        RAY_CHECK(lease_it != shard->worker_to_lease_entry.end());
+        auto status = lease_it->second.lease_client->ReturnWorker(
+            addr.port, addr.worker_id, /*disconnect_worker=*/false);
+        if (!status.ok()) {
+          RAY_LOG(ERROR) << "Error returning worker to raylet: " << status.ToString();
+        }
+        shard->worker_to_lease_entry.erase(lease_it);
+        queue.pop_front();
+      }
+      if (queue.empty()) {
+        shard->idle_workers.erase(it++);
+      } else {
+        next_return_time_ms =
+            std::min(next_return_time_ms, queue.front().return_time_ms);
+        ++it;
+      }
+    }
+  }
+  if (next_return_time_ms != std::numeric_limits<int64_t>::max()) {
+    ScheduleIdleWorkerReturn(next_return_time_ms);
+  }
 }
 
 void CoreWorkerDirectTaskSubmitter::CancelWorkerLeaseIfNeeded(
-    const SchedulingKey &scheduling_key) {
-  auto &scheduling_key_entry = scheduling_key_entries_[scheduling_key];
+    Shard &shard, const SchedulingKey &scheduling_key) {
+  auto &scheduling_key_entry = shard.scheduling_key_entries[scheduling_key];
   auto &task_queue = scheduling_key_entry.task_queue;
   if (!task_queue.empty()) {
     // There are still pending tasks, so let the worker lease request succeed.
@@ -210,9 +378,9 @@ void CoreWorkerDirectTaskSubmitter::CancelWorkerLeaseIfNeeded(
     auto &lease_id = pending_lease_request.second;
     RAY_LOG(DEBUG) << "Canceling lease request " << lease_id;
     lease_client->CancelWorkerLease(
-        lease_id, [this, scheduling_key](const Status &status,
-                                         const rpc::CancelWorkerLeaseReply &reply) {
-          absl::MutexLock lock(&mu_);
+        lease_id, [this, &shard, scheduling_key](
+                      const Status &status, const rpc::CancelWorkerLeaseReply &reply) {
+          absl::MutexLock lock(&shard.mu);
           if (status.ok() && !reply.success()) {
             // The cancellation request can fail if the raylet does not have
             // the request queued. This can happen if: a) due to message
@@ -222,7 +390,7 @@ void CoreWorkerDirectTaskSubmitter::CancelWorkerLeaseIfNeeded(
             // request again. In the latter case, the in-flight lease request
             // should already have been removed from our local state, so we no
             // longer need to cancel.
-            CancelWorkerLeaseIfNeeded(scheduling_key);
+            CancelWorkerLeaseIfNeeded(shard, scheduling_key);
           }
         });
   }
@@ -236,6 +404,7 @@ CoreWorkerDirectTaskSubmitter::GetOrConnectLeaseClient(
   if (NodeID::FromBinary(raylet_address->raylet_id()) != local_raylet_id_) {
     // A remote raylet was specified. Connect to the raylet if needed.
     NodeID raylet_id = NodeID::FromBinary(raylet_address->raylet_id());
+    absl::MutexLock lock(&lease_clients_mu_);
     auto it = remote_lease_clients_.find(raylet_id);
     if (it == remote_lease_clients_.end()) {
       RAY_LOG(DEBUG) << "Connecting to raylet " << raylet_id;
@@ -253,8 +422,9 @@ CoreWorkerDirectTaskSubmitter::GetOrConnectLeaseClient(
 }
 
 void CoreWorkerDirectTaskSubmitter::RequestNewWorkerIfNeeded(
-    const SchedulingKey &scheduling_key, const rpc::Address *raylet_address) {
-  auto &scheduling_key_entry = scheduling_key_entries_[scheduling_key];
+    Shard &shard, const SchedulingKey &scheduling_key,
+    const rpc::Address *raylet_address) {
+  auto &scheduling_key_entry = shard.scheduling_key_entries[scheduling_key];
   auto &pending_lease_request = scheduling_key_entry.pending_lease_request;
 
   if (pending_lease_request.first) {
@@ -267,8 +437,8 @@ void CoreWorkerDirectTaskSubmitter::RequestNewWorkerIfNeeded(
     // We don't have any of this type of task to run.
     if (scheduling_key_entry.CanDelete()) {
       // We can safely remove the entry keyed by scheduling_key from the
-      // scheduling_key_entries_ hashmap.
-      scheduling_key_entries_.erase(scheduling_key);
+      // scheduling_key_entries hashmap.
+      shard.scheduling_key_entries.erase(scheduling_key);
     }
     return;
   }
@@ -281,11 +451,22 @@ void CoreWorkerDirectTaskSubmitter::RequestNewWorkerIfNeeded(
     return;
   }
 
+  // A lease that is already held is cheaper than any new one, but don't override the
+  // raylet that the task was spilled back to.
+  if (raylet_address == nullptr && ReuseIdleWorker(shard, scheduling_key)) {
+    return;
+  }
+
   TaskSpecification &resource_spec = task_queue.front();
   rpc::Address best_node_address;
+  // The locality of the task's arguments, so that the raylet can prefer the nodes that
+  // have them if it spills the task back. A raylet that the task was spilled back to
+  // was already chosen with it.
+  ObjectBytesByNode local_object_bytes;
   if (raylet_address == nullptr) {
     // If no raylet address is given, find the best worker for our next lease request.
-    best_node_address = lease_policy_->GetBestNodeForTask(resource_spec);
+    best_node_address =
+        lease_policy_->GetBestNodeForTask(resource_spec, &local_object_bytes);
     raylet_address = &best_node_address;
   }
   auto lease_client = GetOrConnectLeaseClient(raylet_address);
@@ -294,11 +475,11 @@ void CoreWorkerDirectTaskSubmitter::RequestNewWorkerIfNeeded(
   int64_t queue_size = task_queue.size() - 1;
   lease_client->RequestWorkerLease(
       resource_spec,
-      [this, scheduling_key](const Status &status,
-                             const rpc::RequestWorkerLeaseReply &reply) {
-        absl::MutexLock lock(&mu_);
+      [this, &shard, scheduling_key](const Status &status,
+                                     const rpc::RequestWorkerLeaseReply &reply) {
+        absl::MutexLock lock(&shard.mu);
 
-        auto &scheduling_key_entry = scheduling_key_entries_[scheduling_key];
+        auto &scheduling_key_entry = shard.scheduling_key_entries[scheduling_key];
         auto &pending_lease_request = scheduling_key_entry.pending_lease_request;
         RAY_CHECK(pending_lease_request.first);
         auto lease_client = std::move(pending_lease_request.first);
@@ -308,7 +489,7 @@ void CoreWorkerDirectTaskSubmitter::RequestNewWorkerIfNeeded(
         if (status.ok()) {
           if (reply.canceled()) {
             RAY_LOG(DEBUG) << "Lease canceled " << task_id;
-            RequestNewWorkerIfNeeded(scheduling_key);
+            RequestNewWorkerIfNeeded(shard, scheduling_key);
           } else if (!reply.worker_address().raylet_id().empty()) {
             // We got a lease for a worker. Add the lease client state and try to
             // assign work to the worker.
@@ -316,14 +497,15 @@ void CoreWorkerDirectTaskSubmitter::RequestNewWorkerIfNeeded(
             rpc::WorkerAddress addr(reply.worker_address());
             auto resources_copy = reply.resource_mapping();
 
-            AddWorkerLeaseClient(addr, std::move(lease_client), resources_copy,
+            AddWorkerLeaseClient(shard, addr, std::move(lease_client), resources_copy,
                                  scheduling_key);
             RAY_CHECK(scheduling_key_entry.active_workers.size() >= 1);
-            OnWorkerIdle(addr, scheduling_key,
+            OnWorkerIdle(shard, addr, scheduling_key,
                          /*error=*/false, resources_copy);
           } else {
             // The raylet redirected us to a different raylet to retry at.
-            RequestNewWorkerIfNeeded(scheduling_key, &reply.retry_at_raylet_address());
+            RequestNewWorkerIfNeeded(shard, scheduling_key,
+                                     &reply.retry_at_raylet_address());
           }
         } else if (lease_client != local_lease_client_) {
           // A lease request to a remote raylet failed. Retry locally if the lease is
@@ -331,7 +513,7 @@ void CoreWorkerDirectTaskSubmitter::RequestNewWorkerIfNeeded(
           // TODO(swang): Fail after some number of retries?
           RAY_LOG(ERROR) << "Retrying attempt to schedule task at remote node. Error: "
                          << status.ToString();
-          RequestNewWorkerIfNeeded(scheduling_key);
+          RequestNewWorkerIfNeeded(shard, scheduling_key);
         } else {
           // A local request failed. This shouldn't happen if the raylet is still alive
           // and we don't currently handle raylet failures, so treat it as a fatal
@@ -342,7 +524,7 @@ void CoreWorkerDirectTaskSubmitter::RequestNewWorkerIfNeeded(
           RAY_LOG(FATAL) << status.ToString();
         }
       },
-      queue_size);
+      queue_size, local_object_bytes);
   pending_lease_request = std::make_pair(lease_client, task_id);
 }
 
@@ -361,44 +543,14 @@ void CoreWorkerDirectTaskSubmitter::PushNormalTask(
   request->mutable_task_spec()->CopyFrom(task_spec.GetMessage());
   request->mutable_resource_mapping()->CopyFrom(assigned_resources);
   request->set_intended_worker_id(addr.worker_id.Binary());
+  int64_t start_time_us = current_sys_time_us();
   client.PushNormalTask(std::move(request), [this, task_id, is_actor, is_actor_creation,
-                                             scheduling_key, addr, assigned_resources](
+                                             scheduling_key, addr, assigned_resources,
+                                             start_time_us](
                                                 Status status,
                                                 const rpc::PushTaskReply &reply) {
-    {
-      absl::MutexLock lock(&mu_);
-      executing_tasks_.erase(task_id);
-
-      // Decrement the number of tasks in flight to the worker
-      auto &lease_entry = worker_to_lease_entry_[addr];
-      RAY_CHECK(lease_entry.tasks_in_flight > 0);
-      lease_entry.tasks_in_flight--;
-
-      // Decrement the total number of tasks in flight to any worker with the current
-      // scheduling_key.
-      auto &scheduling_key_entry = scheduling_key_entries_[scheduling_key];
-      RAY_CHECK(scheduling_key_entry.active_workers.size() >= 1);
-      RAY_CHECK(scheduling_key_entry.total_tasks_in_flight >= 1);
-      scheduling_key_entry.total_tasks_in_flight--;
-    }
-    if (reply.worker_exiting()) {
-      // The worker is draining and will shutdown after it is done. Don't return
-      // it to the Raylet since that will kill it early.
-      absl::MutexLock lock(&mu_);
-      worker_to_lease_entry_.erase(addr);
-      auto &scheduling_key_entry = scheduling_key_entries_[scheduling_key];
-      scheduling_key_entry.active_workers.erase(addr);
-      if (scheduling_key_entry.CanDelete()) {
-        // We can safely remove the entry keyed by scheduling_key from the
-        // scheduling_key_entries_ hashmap.
-        scheduling_key_entries_.erase(scheduling_key);
-      }
-    } else if (!status.ok() || !is_actor_creation) {
-      // Successful actor creation leases the worker indefinitely from the raylet.
-      absl::MutexLock lock(&mu_);
-      OnWorkerIdle(addr, scheduling_key,
-                   /*error=*/!status.ok(), assigned_resources);
-    }
+    OnPushDone(addr, scheduling_key, {task_id}, status, reply.worker_exiting(),
+               is_actor_creation, start_time_us, assigned_resources);
     if (!status.ok()) {
       // TODO: It'd be nice to differentiate here between process vs node
       // failure (e.g., by contacting the raylet). If it was a process
@@ -413,21 +565,122 @@ void CoreWorkerDirectTaskSubmitter::PushNormalTask(
   });
 }
 
+void CoreWorkerDirectTaskSubmitter::PushNormalTasks(
+    const rpc::WorkerAddress &addr, rpc::CoreWorkerClientInterface &client,
+    const SchedulingKey &scheduling_key, const std::vector<TaskSpecification> &task_specs,
+    const google::protobuf::RepeatedPtrField<rpc::ResourceMapEntry> &assigned_resources) {
+  auto request = std::unique_ptr<rpc::PushTasksRequest>(new rpc::PushTasksRequest);
+  std::vector<TaskID> task_ids;
+  task_ids.reserve(task_specs.size());
+  for (const auto &task_spec : task_specs) {
+    task_ids.push_back(task_spec.TaskId());
+    auto task_request = request->add_requests();
+    // NOTE: CopyFrom is needed for the same reason as in PushNormalTask.
+    task_request->mutable_task_spec()->CopyFrom(task_spec.GetMessage());
+    task_request->mutable_resource_mapping()->CopyFrom(assigned_resources);
+    task_request->set_intended_worker_id(addr.worker_id.Binary());
+  }
+  request->set_intended_worker_id(addr.worker_id.Binary());
+  int64_t start_time_us = current_sys_time_us();
+  client.PushNormalTasks(std::move(request), [this, task_ids, scheduling_key, addr,
+                                              assigned_resources, start_time_us](
+                                                 Status status,
+                                                 const rpc::PushTasksReply &reply) {
+    // The worker replies once every task of the batch has a result, so a reply that
+    // doesn't cover the batch can only come with a failed RPC.
+    if (status.ok() && reply.replies_size() != static_cast<int>(task_ids.size())) {
+      status = Status::IOError("The worker replied to a batch with the wrong size");
+    }
+    bool worker_exiting = false;
+    bool task_failed = false;
+    if (status.ok()) {
+      for (size_t i = 0; i < task_ids.size(); i++) {
+        worker_exiting |= reply.replies(i).worker_exiting();
+        task_failed |= reply.task_failed(i);
+      }
+    }
+    // A failed task makes the push count as failed, so that the worker is returned
+    // with an error and the push is not used to size the batches.
+    OnPushDone(addr, scheduling_key, task_ids,
+               task_failed ? Status::IOError("A task of the batch failed") : status,
+               worker_exiting, /*is_actor_creation=*/false, start_time_us,
+               assigned_resources);
+    // The failed tasks, including the ones the worker cancelled before they started,
+    // are handled like the tasks in flight to a worker that dies.
+    for (size_t i = 0; i < task_ids.size(); i++) {
+      if (status.ok() && !reply.task_failed(i)) {
+        task_finisher_->CompletePendingTask(task_ids[i], reply.replies(i),
+                                            addr.ToProto());
+      } else {
+        Status task_status =
+            status.ok() ? Status::IOError(reply.error_messages(i)) : status;
+        RAY_UNUSED(task_finisher_->PendingTaskFailed(
+            task_ids[i], rpc::ErrorType::WORKER_DIED, &task_status));
+      }
+    }
+  });
+}
+
+void CoreWorkerDirectTaskSubmitter::OnPushDone(
+    const rpc::WorkerAddress &addr, const SchedulingKey &scheduling_key,
+    const std::vector<TaskID> &task_ids, const Status &status, bool worker_exiting,
+    bool is_actor_creation, int64_t start_time_us,
+    const google::protobuf::RepeatedPtrField<rpc::ResourceMapEntry> &assigned_resources) {
+  auto &shard = GetShard(std::get<0>(scheduling_key));
+  absl::MutexLock lock(&shard.mu);
+  for (const auto &task_id : task_ids) {
+    shard.executing_tasks.erase(task_id);
+  }
+
+  // Decrement the number of pushes in flight to the worker
+  auto &lease_entry = shard.worker_to_lease_entry[addr];
+  RAY_CHECK(lease_entry.tasks_in_flight > 0);
+  lease_entry.tasks_in_flight--;
+
+  // Decrement the total number of pushes in flight to any worker with the current
+  // scheduling_key.
+  auto &scheduling_key_entry = shard.scheduling_key_entries[scheduling_key];
+  RAY_CHECK(scheduling_key_entry.active_workers.size() >= 1);
+  RAY_CHECK(scheduling_key_entry.total_tasks_in_flight >= 1);
+  scheduling_key_entry.total_tasks_in_flight--;
+  if (status.ok() && max_tasks_per_push_batch_ > 1) {
+    scheduling_key_entry.push_batch_sizer.RecordPushDuration(
+        current_sys_time_us() - start_time_us, task_ids.size());
+  }
+
+  if (worker_exiting) {
+    // The worker is draining and will shutdown after it is done. Don't return
+    // it to the Raylet since that will kill it early.
+    shard.worker_to_lease_entry.erase(addr);
+    scheduling_key_entry.active_workers.erase(addr);
+    if (scheduling_key_entry.CanDelete()) {
+      // We can safely remove the entry keyed by scheduling_key from the
+      // scheduling_key_entries hashmap.
+      shard.scheduling_key_entries.erase(scheduling_key);
+    }
+  } else if (!status.ok() || !is_actor_creation) {
+    // Successful actor creation leases the worker indefinitely from the raylet.
+    OnWorkerIdle(shard, addr, scheduling_key,
+                 /*error=*/!status.ok(), assigned_resources);
+  }
+}
+
 Status CoreWorkerDirectTaskSubmitter::CancelTask(TaskSpecification task_spec,
                                                  bool force_kill, bool recursive) {
   RAY_LOG(INFO) << "Killing task: " << task_spec.TaskId();
   const SchedulingKey scheduling_key(
       task_spec.GetSchedulingClass(), task_spec.GetDependencyIds(),
       task_spec.IsActorCreationTask() ? task_spec.ActorCreationId() : ActorID::Nil());
+  auto &shard = GetShard(std::get<0>(scheduling_key));
   std::shared_ptr<rpc::CoreWorkerClientInterface> client = nullptr;
   {
-    absl::MutexLock lock(&mu_);
-    if (cancelled_tasks_.find(task_spec.TaskId()) != cancelled_tasks_.end() ||
+    absl::MutexLock lock(&shard.mu);
+    if (shard.cancelled_tasks.find(task_spec.TaskId()) != shard.cancelled_tasks.end() ||
         !task_finisher_->MarkTaskCanceled(task_spec.TaskId())) {
       return Status::OK();
     }
 
-    auto &scheduling_key_entry = scheduling_key_entries_[scheduling_key];
+    auto &scheduling_key_entry = shard.scheduling_key_entries[scheduling_key];
     auto &scheduled_tasks = scheduling_key_entry.task_queue;
     // This cancels tasks that have completed dependencies and are awaiting
     // a worker lease.
@@ -437,7 +690,7 @@ Status CoreWorkerDirectTaskSubmitter::CancelTask(TaskSpecification task_spec,
           scheduled_tasks.erase(spec);
 
           if (scheduled_tasks.empty()) {
-            CancelWorkerLeaseIfNeeded(scheduling_key);
+            CancelWorkerLeaseIfNeeded(shard, scheduling_key);
           }
           RAY_UNUSED(task_finisher_->PendingTaskFailed(task_spec.TaskId(),
                                                        rpc::ErrorType::TASK_CANCELLED));
@@ -448,16 +701,17 @@ Status CoreWorkerDirectTaskSubmitter::CancelTask(TaskSpecification task_spec,
 
     // This will get removed either when the RPC call to cancel is returned
     // or when all dependencies are resolved.
-    RAY_CHECK(cancelled_tasks_.emplace(task_spec.TaskId()).second);
-    auto rpc_client = executing_tasks_.find(task_spec.TaskId());
+    RAY_CHECK(shard.cancelled_tasks.emplace(task_spec.TaskId()).second);
+    auto rpc_client = shard.executing_tasks.find(task_spec.TaskId());
 
-    if (rpc_client == executing_tasks_.end()) {
-      // This case is reached for tasks that have unresolved dependencies.
+    if (rpc_client == shard.executing_tasks.end()) {
+      // This case is reached for tasks that have unresolved dependencies, or that
+      // are still in the inbox of the shard.
       // No executing tasks, so cancelling is a noop.
       if (scheduling_key_entry.CanDelete()) {
         // We can safely remove the entry keyed by scheduling_key from the
-        // scheduling_key_entries_ hashmap.
-        scheduling_key_entries_.erase(scheduling_key);
+        // scheduling_key_entries hashmap.
+        shard.scheduling_key_entries.erase(scheduling_key);
       }
       return Status::OK();
     }
@@ -478,10 +732,10 @@ Status CoreWorkerDirectTaskSubmitter::CancelTask(TaskSpecification task_spec,
   request.set_force_kill(force_kill);
   request.set_recursive(recursive);
   client->CancelTask(
-      request, [this, task_spec, scheduling_key, force_kill, recursive](
+      request, [this, &shard, task_spec, scheduling_key, force_kill, recursive](
                    const Status &status, const rpc::CancelTaskReply &reply) {
-        absl::MutexLock lock(&mu_);
-        cancelled_tasks_.erase(task_spec.TaskId());
+        absl::MutexLock lock(&shard.mu);
+        shard.cancelled_tasks.erase(task_spec.TaskId());
 
         if (status.ok() && !reply.attempt_succeeded()) {
           if (cancel_retry_timer_.has_value()) {
@@ -16,6 +16,9 @@
 
 #include <google/protobuf/repeated_field.h>
 
+#include <memory>
+#include <vector>
+
 #include "absl/base/thread_annotations.h"
 #include "absl/synchronization/mutex.h"
 #include "ray/common/id.h"
@@ -27,6 +30,7 @@
 #include "ray/core_worker/task_manager.h"
 #include "ray/core_worker/transport/dependency_resolver.h"
 #include "ray/core_worker/transport/direct_actor_transport.h"
+#include "ray/core_worker/transport/push_batch_sizer.h"
 #include "ray/raylet_client/raylet_client.h"
 #include "ray/rpc/worker/core_worker_client.h"
 #include "ray/rpc/worker/core_worker_client_pool.h"
@@ -61,7 +65,9 @@ class CoreWorkerDirectTaskSubmitter {
       int64_t lease_timeout_ms, std::shared_ptr<ActorCreatorInterface> actor_creator,
       uint32_t max_tasks_in_flight_per_worker =
           RayConfig::instance().max_tasks_in_flight_per_worker(),
-      absl::optional<boost::asio::steady_timer> cancel_timer = absl::nullopt)
+      absl::optional<boost::asio::steady_timer> cancel_timer = absl::nullopt,
+      uint32_t max_tasks_per_push_batch = RayConfig::instance().max_tasks_per_push_batch(),
+      absl::optional<boost::asio::steady_timer> idle_lease_timer = absl::nullopt)
       : rpc_address_(rpc_address),
         local_lease_client_(lease_client),
         lease_client_factory_(lease_client_factory),
@@ -73,7 +79,19 @@ class CoreWorkerDirectTaskSubmitter {
         actor_creator_(std::move(actor_creator)),
         client_cache_(core_worker_client_pool),
         max_tasks_in_flight_per_worker_(max_tasks_in_flight_per_worker),
-        cancel_retry_timer_(std::move(cancel_timer)) {}
+        max_tasks_per_push_batch_(max_tasks_per_push_batch),
+        push_batch_target_duration_us_(
+            RayConfig::instance().task_push_batch_target_duration_us()),
+        cancel_retry_timer_(std::move(cancel_timer)),
+        idle_lease_grace_period_ms_(
+            RayConfig::instance().worker_lease_idle_grace_period_ms()),
+        idle_lease_timer_(std::move(idle_lease_timer)) {
+    const uint32_t num_shards =
+        std::max<uint32_t>(RayConfig::instance().task_submitter_num_shards(), 1);
+    for (uint32_t i = 0; i < num_shards; i++) {
+      shards_.emplace_back(new Shard());
+    }
+  }
 
   /// Schedule a task for direct submission to a worker.
   ///
@@ -88,14 +106,34 @@ class CoreWorkerDirectTaskSubmitter {
 
   Status CancelRemoteTask(const ObjectID &object_id, const rpc::Address &worker_addr,
                           bool force_kill, bool recursive);
-  /// Check that the scheduling_key_entries_ hashmap is empty by calling the private
-  /// CheckNoSchedulingKeyEntries function after acquiring the lock.
+  /// Check that the scheduling_key_entries hashmaps of all the shards are empty.
   bool CheckNoSchedulingKeyEntriesPublic() {
-    absl::MutexLock lock(&mu_);
-    return scheduling_key_entries_.empty();
+    for (auto &shard : shards_) {
+      absl::MutexLock lock(&shard->mu);
+      if (!shard->scheduling_key_entries.empty()) {
+        return false;
+      }
+    }
+    return true;
   }
 
  private:
+  struct Shard;
+
+  /// Get the shard that holds the state of the given scheduling class.
+  Shard &GetShard(SchedulingClass scheduling_class) {
+    return *shards_[static_cast<size_t>(scheduling_class) % shards_.size()];
+  }
+
+  /// Schedule the tasks in the inbox of the shard until it is empty. Only one thread
+  /// drains the inbox of a shard at a time.
+  void DrainInbox(Shard &shard) LOCKS_EXCLUDED(shard.mu, shard.inbox_mu);
+
+  /// Queue a task whose dependencies are resolved, and push it to a worker or request
+  /// a new worker for it.
+  void EnqueueTask(Shard &shard, const TaskSpecification &task_spec)
+      EXCLUSIVE_LOCKS_REQUIRED(shard.mu);
+
   /// Schedule more work onto an idle worker or return it back to the raylet if
   /// no more tasks are queued for submission. If an error was encountered
   /// processing the worker, we don't attempt to re-use the worker.
@@ -105,36 +143,75 @@ class CoreWorkerDirectTaskSubmitter {
   /// \param[in] was_error Whether the task failed to be submitted.
   /// \param[in] assigned_resources Resource ids previously assigned to the worker.
   void OnWorkerIdle(
-      const rpc::WorkerAddress &addr, const SchedulingKey &task_queue_key, bool was_error,
+      Shard &shard, const rpc::WorkerAddress &addr, const SchedulingKey &task_queue_key,
+      bool was_error,
       const google::protobuf::RepeatedPtrField<rpc::ResourceMapEntry> &assigned_resources)
-      EXCLUSIVE_LOCKS_REQUIRED(mu_);
+      EXCLUSIVE_LOCKS_REQUIRED(shard.mu);
 
   /// Get an existing lease client or connect a new one. If a raylet_address is
   /// provided, this connects to a remote raylet. Else, this connects to the
   /// local raylet.
   std::shared_ptr<WorkerLeaseInterface> GetOrConnectLeaseClient(
-      const rpc::Address *raylet_address) EXCLUSIVE_LOCKS_REQUIRED(mu_);
+      const rpc::Address *raylet_address) LOCKS_EXCLUDED(lease_clients_mu_);
 
   /// Request a new worker from the raylet if no such requests are currently in
   /// flight and there are tasks queued. If a raylet address is provided, then
   /// the worker should be requested from the raylet at that address. Else, the
   /// worker should be requested from the local raylet.
-  void RequestNewWorkerIfNeeded(const SchedulingKey &task_queue_key,
+  void RequestNewWorkerIfNeeded(Shard &shard, const SchedulingKey &task_queue_key,
                                 const rpc::Address *raylet_address = nullptr)
-      EXCLUSIVE_LOCKS_REQUIRED(mu_);
+      EXCLUSIVE_LOCKS_REQUIRED(shard.mu);
 
   /// Cancel a pending worker lease and retry until the cancellation succeeds
   /// (i.e., the raylet drops the request). This should be called when there
   /// are no more tasks queued with the given scheduling key and there is an
   /// in-flight lease request for that key.
-  void CancelWorkerLeaseIfNeeded(const SchedulingKey &scheduling_key)
-      EXCLUSIVE_LOCKS_REQUIRED(mu_);
+  void CancelWorkerLeaseIfNeeded(Shard &shard, const SchedulingKey &scheduling_key)
+      EXCLUSIVE_LOCKS_REQUIRED(shard.mu);
+
+  /// Move a leased worker that has no more tasks of its scheduling key to the given
+  /// scheduling key, and push tasks of that key to it. The keys must have the same
+  /// scheduling class, which is the resource shape of the lease.
+  ///
+  /// \param[in] addr The address of the worker.
+  /// \param[in] scheduling_key The new scheduling key of the worker.
+  void AssignIdleWorker(Shard &shard, const rpc::WorkerAddress &addr,
+                        const SchedulingKey &scheduling_key)
+      EXCLUSIVE_LOCKS_REQUIRED(shard.mu);
+
+  /// Hand a leased worker whose queue is empty to another scheduling key with queued
+  /// tasks of the same resource shape, or keep it in the idle lease pool for the grace
+  /// period.
+  ///
+  /// \param[in] addr The address of the worker.
+  /// \param[in] scheduling_key The scheduling key the worker was running tasks of.
+  /// \return Whether the worker was kept. If false, it should be returned.
+  bool KeepIdleWorker(Shard &shard, const rpc::WorkerAddress &addr,
+                      const SchedulingKey &scheduling_key)
+      EXCLUSIVE_LOCKS_REQUIRED(shard.mu);
+
+  /// Push the tasks of the given scheduling key to a worker from the idle lease pool,
+  /// if there is one with the same resource shape.
+  ///
+  /// \return Whether a worker was taken from the pool.
+  bool ReuseIdleWorker(Shard &shard, const SchedulingKey &scheduling_key)
+      EXCLUSIVE_LOCKS_REQUIRED(shard.mu);
+
+  /// Return the workers whose grace period in the idle lease pool is over, and wait
+  /// for the next one.
+  void ReturnExpiredIdleWorkers() LOCKS_EXCLUDED(timer_mu_);
+
+  /// Arm the timer to return the idle workers at the given time, unless it is already
+  /// waiting for an earlier time.
+  void ScheduleIdleWorkerReturn(int64_t return_time_ms) LOCKS_EXCLUDED(timer_mu_);
 
   /// Set up client state for newly granted worker lease.
   void AddWorkerLeaseClient(
-      const rpc::WorkerAddress &addr, std::shared_ptr<WorkerLeaseInterface> lease_client,
+      Shard &shard, const rpc::WorkerAddress &addr,
+      std::shared_ptr<WorkerLeaseInterface> lease_client,
       const google::protobuf::RepeatedPtrField<rpc::ResourceMapEntry> &assigned_resources,
-      const SchedulingKey &scheduling_key) EXCLUSIVE_LOCKS_REQUIRED(mu_);
+      const SchedulingKey &scheduling_key)
+      EXCLUSIVE_LOCKS_REQUIRED(shard.mu);
 
   /// Push a task to a specific worker.
   void PushNormalTask(const rpc::WorkerAddress &addr,
@@ -144,10 +221,31 @@ class CoreWorkerDirectTaskSubmitter {
                       const google::protobuf::RepeatedPtrField<rpc::ResourceMapEntry>
                           &assigned_resources);
 
-  /// Check that the scheduling_key_entries_ hashmap is empty.
-  bool CheckNoSchedulingKeyEntries() const EXCLUSIVE_LOCKS_REQUIRED(mu_) {
-    return scheduling_key_entries_.empty();
-  }
+  /// Push a batch of tasks to a specific worker in a single RPC. The tasks are
+  /// completed or failed one by one as in `PushNormalTask`.
+  void PushNormalTasks(const rpc::WorkerAddress &addr,
+                       rpc::CoreWorkerClientInterface &client,
+                       const SchedulingKey &task_queue_key,
+                       const std::vector<TaskSpecification> &task_specs,
+                       const google::protobuf::RepeatedPtrField<rpc::ResourceMapEntry>
+                           &assigned_resources);
+
+  /// Handle the reply to a task push. This returns the worker or pushes more tasks to
+  /// it, and records how long the push took.
+  ///
+  /// \param[in] addr The address of the worker.
+  /// \param[in] scheduling_key The scheduling key of the pushed tasks.
+  /// \param[in] task_ids The IDs of the pushed tasks.
+  /// \param[in] status The status of the push.
+  /// \param[in] worker_exiting Whether the worker will exit after the push.
+  /// \param[in] is_actor_creation Whether the push was an actor creation task.
+  /// \param[in] start_time_us When the push was sent.
+  /// \param[in] assigned_resources Resource ids assigned to the worker.
+  void OnPushDone(const rpc::WorkerAddress &addr, const SchedulingKey &scheduling_key,
+                  const std::vector<TaskID> &task_ids, const Status &status,
+                  bool worker_exiting, bool is_actor_creation, int64_t start_time_us,
+                  const google::protobuf::RepeatedPtrField<rpc::ResourceMapEntry>
+                      &assigned_resources);
 
   /// Address of our RPC server.
   rpc::Address rpc_address_;
@@ -155,9 +253,12 @@ class CoreWorkerDirectTaskSubmitter {
   // Client that can be used to lease and return workers from the local raylet.
   std::shared_ptr<WorkerLeaseInterface> local_lease_client_;
 
+  /// Protects remote_lease_clients_.
+  absl::Mutex lease_clients_mu_;
+
   /// Cache of gRPC clients to remote raylets.
   absl::flat_hash_map<NodeID, std::shared_ptr<WorkerLeaseInterface>> remote_lease_clients_
-      GUARDED_BY(mu_);
+      GUARDED_BY(lease_clients_mu_);
 
   /// Factory for producing new clients to request leases from remote nodes.
   LeaseClientFactoryFn lease_client_factory_;
@@ -183,9 +284,6 @@ class CoreWorkerDirectTaskSubmitter {
   /// Interface for actor creation.
   std::shared_ptr<ActorCreatorInterface> actor_creator_;
 
-  // Protects task submission state below.
-  absl::Mutex mu_;
-
   /// Cache of gRPC clients to other workers.
   std::shared_ptr<rpc::CoreWorkerClientPool> client_cache_;
 
@@ -193,10 +291,17 @@ class CoreWorkerDirectTaskSubmitter {
   // worker using a single lease.
   const uint32_t max_tasks_in_flight_per_worker_;
 
+  // max_tasks_per_push_batch_ limits the number of tasks that can be pushed to a worker
+  // in one RPC. The batches are sized adaptively up to this limit, so that a batch takes
+  // about push_batch_target_duration_us_ to execute.
+  const uint32_t max_tasks_per_push_batch_;
+  const uint64_t push_batch_target_duration_us_;
+
   /// A LeaseEntry struct is used to condense the metadata about a single executor:
   /// (1) The lease client through which the worker should be returned
   /// (2) The expiration time of a worker's lease.
-  /// (3) The number of tasks that are currently in flight to the worker
+  /// (3) The number of task pushes that are currently in flight to the worker. A batch
+  ///     of tasks pushed in one RPC counts as one.
   /// (4) The resources assigned to the worker
   /// (5) The SchedulingKey assigned to tasks that will be sent to the worker
   struct LeaseEntry {
@@ -225,10 +330,6 @@ class CoreWorkerDirectTaskSubmitter {
     }
   };
 
-  // Map from worker address to a LeaseEntry struct containing the lease's metadata.
-  absl::flat_hash_map<rpc::WorkerAddress, LeaseEntry> worker_to_lease_entry_
-      GUARDED_BY(mu_);
-
   struct SchedulingKeyEntry {
     // Keep track of pending worker lease requests to the raylet.
     std::pair<std::shared_ptr<WorkerLeaseInterface>, TaskID> pending_lease_request =
@@ -240,11 +341,13 @@ class CoreWorkerDirectTaskSubmitter {
     // room for more tasks in flight
     absl::flat_hash_set<rpc::WorkerAddress> active_workers =
         absl::flat_hash_set<rpc::WorkerAddress>();
-    // Keep track of how many tasks with this SchedulingKey are in flight, in total
+    // Keep track of how many task pushes with this SchedulingKey are in flight, in total
     uint32_t total_tasks_in_flight = 0;
+    // Sizes the batches of tasks pushed to the workers with this SchedulingKey.
+    PushBatchSizer push_batch_sizer;
 
     // Check whether it's safe to delete this SchedulingKeyEntry from the
-    // scheduling_key_entries_ hashmap.
+    // scheduling_key_entries hashmap.
     bool CanDelete() const {
       if (!pending_lease_request.first && task_queue.empty() &&
           active_workers.size() == 0 && total_tasks_in_flight == 0) {
@@ -262,20 +365,81 @@ class CoreWorkerDirectTaskSubmitter {
     }
   };
 
-  // For each Scheduling Key, scheduling_key_entries_ contains a SchedulingKeyEntry struct
-  // with the queue of tasks belonging to that SchedulingKey, together with the other
-  // fields that are needed to orchestrate the execution of those tasks by the workers.
-  absl::flat_hash_map<SchedulingKey, SchedulingKeyEntry> scheduling_key_entries_
-      GUARDED_BY(mu_);
+  // Retries cancelation requests if they were not successful.
+  absl::optional<boost::asio::steady_timer> cancel_retry_timer_;
+
+  /// A leased worker that has no tasks to run. It is kept for a grace period, so that
+  /// tasks of the same resource shape submitted soon after can reuse the lease instead
+  /// of requesting a new one from the raylet.
+  struct IdleWorker {
+    rpc::WorkerAddress addr;
+    /// When the worker should be returned to the raylet.
+    int64_t return_time_ms;
+  };
+
+  /// The task submission state is sharded by scheduling class, so that threads that
+  /// submit tasks of different resource shapes don't contend on a lock. A leased worker
+  /// only ever runs tasks of one scheduling class, so its lease stays in one shard.
+  /// Submitted tasks are first appended to the inbox of the shard, which only takes a
+  /// short lock. One submitting thread at a time then moves them to the task queues
+  /// under the shard lock, while the others return right away.
+  ///
+  /// Lock order: Shard::mu, then Shard::inbox_mu, lease_clients_mu_ or timer_mu_.
+  struct Shard {
+    /// Protects the task submission state of the shard.
+    absl::Mutex mu;
+
+    // Map from worker address to a LeaseEntry struct containing the lease's metadata.
+    absl::flat_hash_map<rpc::WorkerAddress, LeaseEntry> worker_to_lease_entry
+        GUARDED_BY(mu);
+
+    // For each Scheduling Key, scheduling_key_entries contains a SchedulingKeyEntry
+    // struct with the queue of tasks belonging to that SchedulingKey, together with the
+    // other fields that are needed to orchestrate the execution of those tasks by the
+    // workers.
+    absl::flat_hash_map<SchedulingKey, SchedulingKeyEntry> scheduling_key_entries
+        GUARDED_BY(mu);
+
+    // Tasks that were cancelled while being resolved.
+    absl::flat_hash_set<TaskID> cancelled_tasks GUARDED_BY(mu);
+
+    // Keeps track of where currently executing tasks are being run.
+    absl::flat_hash_map<TaskID, rpc::WorkerAddress> executing_tasks GUARDED_BY(mu);
+
+    /// The idle lease pool, keyed by the resource shape of the lease. Each queue is
+    /// ordered by return time. The workers stay in worker_to_lease_entry.
+    absl::flat_hash_map<SchedulingClass, std::deque<IdleWorker>> idle_workers
+        GUARDED_BY(mu);
+
+    /// Protects the inbox.
+    absl::Mutex inbox_mu ACQUIRED_AFTER(mu);
+
+    /// Tasks whose dependencies are resolved, in submission order, that are not queued
+    /// yet.
+    std::vector<TaskSpecification> inbox GUARDED_BY(inbox_mu);
+
+    /// Whether a thread is draining the inbox.
+    bool draining GUARDED_BY(inbox_mu) = false;
+  };
 
-  // Tasks that were cancelled while being resolved.
-  absl::flat_hash_set<TaskID> cancelled_tasks_ GUARDED_BY(mu_);
+  /// The shards of the task submission state.
+  std::vector<std::unique_ptr<Shard>> shards_;
 
-  // Keeps track of where currently executing tasks are being run.
-  absl::flat_hash_map<TaskID, rpc::WorkerAddress> executing_tasks_ GUARDED_BY(mu_);
+  /// How long an idle leased worker is kept before it is returned to the raylet.
+  const int64_t idle_lease_grace_period_ms_;
 
-  // Retries cancelation requests if they were not successful.
-  absl::optional<boost::asio::steady_timer> cancel_retry_timer_;
+  /// Returns the idle workers at the end of their grace period. If not set, idle
+  /// workers are returned right away.
+  absl::optional<boost::asio::steady_timer> idle_lease_timer_;
+
+  /// Protects idle_lease_timer_ and its state below.
+  absl::Mutex timer_mu_;
+
+  /// Whether idle_lease_timer_ is waiting.
+  bool idle_lease_timer_armed_ GUARDED_BY(timer_mu_) = false;
+
+  /// When idle_lease_timer_ expires, if it is waiting.
+  int64_t idle_lease_timer_expiry_ms_ GUARDED_BY(timer_mu_) = 0;
 };
 
 };  // namespace ray
@@ -0,0 +1,57 @@
+// Copyright 2017 The Ray Authors.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//  http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#pragma once
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+
+namespace ray {
+
+/// Sizes the batches of tasks that a caller pushes to a worker in a single RPC, so that
+/// a batch takes about a target duration to execute. The duration of a task is a moving
+/// average over the pushes that the caller has seen so far.
+class PushBatchSizer {
+ public:
+  /// Record how long a push of num_tasks tasks took, from sending it to the reply.
+  void RecordPushDuration(int64_t duration_us, size_t num_tasks) {
+    double task_duration_us =
+        static_cast<double>(std::max<int64_t>(duration_us, 0)) / num_tasks;
+    if (avg_task_duration_us_ < 0) {
+      avg_task_duration_us_ = task_duration_us;
+    } else {
+      avg_task_duration_us_ = 0.8 * avg_task_duration_us_ + 0.2 * task_duration_us;
+    }
+  }
+
+  /// The number of queued tasks to push in the next RPC. Tasks are pushed one at a time
+  /// until their duration is known.
+  uint32_t BatchSize(uint32_t max_batch_size, uint64_t target_duration_us) const {
+    if (max_batch_size <= 1 || avg_task_duration_us_ < 0) {
+      return 1;
+    }
+    if (avg_task_duration_us_ * max_batch_size <= target_duration_us) {
+      return max_batch_size;
+    }
+    return std::max<uint32_t>(1, target_duration_us / avg_task_duration_us_);
+  }
+
+ private:
+  /// Moving average of the time it takes to push and execute one task, in
+  /// microseconds. Negative until the first push is done.
+  double avg_task_duration_us_ = -1;
+};
+
+}  // namespace ray
@@ -77,6 +77,31 @@ class ActorInfoAccessor {
   virtual Status AsyncCreateActor(const TaskSpecification &task_spec,
                                   const StatusCallback &callback) = 0;
 
+  /// Register a batch of actors to GCS asynchronously with a single request.
+  ///
+  /// \param task_specs The specifications for the actor creation tasks.
+  /// \param callback Callback that will be called after all the actors are registered,
+  /// with the first failure if any, and the status of each actor in the order of
+  /// `task_specs`.
+  /// \return Status
+  virtual Status AsyncRegisterActors(const std::vector<TaskSpecification> &task_specs,
+                                     const MultiItemCallback<Status> &callback) = 0;
+
+  /// Asynchronously request GCS to create a batch of actors with a single request.
+  /// GCS schedules the actors together, which is much cheaper than creating them one
+  /// by one when starting a large pool of actors.
+  ///
+  /// This should be called after the worker has resolved the dependencies of all the
+  /// actors.
+  ///
+  /// \param task_specs The specifications for the actor creation tasks.
+  /// \param callback Callback that will be called once every actor is created or has
+  /// failed, with the first failure if any, and the status of each actor in the order
+  /// of `task_specs`.
+  /// \return Status
+  virtual Status AsyncCreateActors(const std::vector<TaskSpecification> &task_specs,
+                                   const MultiItemCallback<Status> &callback) = 0;
+
   /// Subscribe to any register or update operations of actors.
   ///
   /// \param subscribe Callback that will be called each time when an actor is registered
@@ -216,6 +216,64 @@ Status ServiceBasedActorInfoAccessor::AsyncCreateActor(
   return Status::OK();
 }
 
+namespace {
+
+/// Convert the per-actor statuses of a batch actor reply.
+std::vector<Status> ToActorStatuses(
+    const google::protobuf::RepeatedPtrField<rpc::GcsStatus> &actor_statuses) {
+  std::vector<Status> statuses;
+  statuses.reserve(actor_statuses.size());
+  for (const auto &actor_status : actor_statuses) {
+    statuses.emplace_back(
+        actor_status.code() == (int)StatusCode::OK
+            ? Status()
+            : Status(StatusCode(actor_status.code()), actor_status.message()));
+  }
+  return statuses;
+}
+
+}  // namespace
+
+Status ServiceBasedActorInfoAccessor::AsyncRegisterActors(
+    const std::vector<TaskSpecification> &task_specs,
+    const MultiItemCallback<Status> &callback) {
+  RAY_CHECK(callback);
+  rpc::RegisterActorsRequest request;
+  for (const auto &task_spec : task_specs) {
+    RAY_CHECK(task_spec.IsActorCreationTask());
+    request.add_task_specs()->CopyFrom(task_spec.GetMessage());
+  }
+  client_impl_->GetGcsRpcClient().RegisterActors(
+      request, [callback](const Status &, const rpc::RegisterActorsReply &reply) {
+        auto status =
+            reply.status().code() == (int)StatusCode::OK
+                ? Status()
+                : Status(StatusCode(reply.status().code()), reply.status().message());
+        callback(status, ToActorStatuses(reply.actor_statuses()));
+      });
+  return Status::OK();
+}
+
+Status ServiceBasedActorInfoAccessor::AsyncCreateActors(
+    const std::vector<TaskSpecification> &task_specs,
+    const MultiItemCallback<Status> &callback) {
+  RAY_CHECK(callback);
+  rpc::CreateActorsRequest request;
+  for (const auto &task_spec : task_specs) {
+    RAY_CHECK(task_spec.IsActorCreationTask());
+    request.add_task_specs()->CopyFrom(task_spec.GetMessage());
+  }
+  client_impl_->GetGcsRpcClient().CreateActors(
+      request, [callback](const Status &, const rpc::CreateActorsReply &reply) {
+        auto status =
+            reply.status().code() == (int)StatusCode::OK
+                ? Status()
+                : Status(StatusCode(reply.status().code()), reply.status().message());
+        callback(status, ToActorStatuses(reply.actor_statuses()));
+      });
+  return Status::OK();
+}
+
 Status ServiceBasedActorInfoAccessor::AsyncSubscribeAll(
     const SubscribeCallback<ActorID, rpc::ActorTableData> &subscribe,
     const StatusCallback &done) {
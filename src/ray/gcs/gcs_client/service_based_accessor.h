@@ -85,6 +85,12 @@ class ServiceBasedActorInfoAccessor : public ActorInfoAccessor {
   Status AsyncCreateActor(const TaskSpecification &task_spec,
                           const StatusCallback &callback) override;
 
+  Status AsyncRegisterActors(const std::vector<TaskSpecification> &task_specs,
+                             const MultiItemCallback<Status> &callback) override;
+
+  Status AsyncCreateActors(const std::vector<TaskSpecification> &task_specs,
+                           const MultiItemCallback<Status> &callback) override;
+
   Status AsyncSubscribeAll(
       const SubscribeCallback<ActorID, rpc::ActorTableData> &subscribe,
       const StatusCallback &done) override;
@@ -0,0 +1,368 @@
+// Copyright 2017 The Ray Authors.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//  http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "ray/gcs/gcs_server/bundle_bin_packer.h"
+
+#include <algorithm>
+#include <cmath>
+#include <numeric>
+
+namespace ray {
+namespace gcs {
+
+namespace {
+
+/// Same fixed point unit as `FractionalResourceQuantity`, so that the packer agrees
+/// with the resource manager on whether a bundle fits.
+constexpr int64_t kResourceUnit = 10000;
+
+int64_t ToQuantity(double value) {
+  return static_cast<int64_t>(std::llround(value * kResourceUnit));
+}
+
+}  // namespace
+
+BundleBinPacker::BundleBinPacker(
+    const std::vector<std::pair<NodeID, ResourceMap>> &nodes) {
+  node_ids_.reserve(nodes.size());
+  node_resources_.reserve(nodes.size());
+  for (const auto &node : nodes) {
+    node_ids_.push_back(node.first);
+    node_resources_.push_back(node.second);
+  }
+}
+
+bool BundleBinPacker::Init(const std::vector<ResourceMap> &bundles) {
+  resource_names_.clear();
+  std::unordered_map<std::string, size_t> resource_index;
+  for (const auto &bundle : bundles) {
+    for (const auto &resource : bundle) {
+      if (resource.second > 0 && !resource_index.count(resource.first)) {
+        resource_index.emplace(resource.first, resource_names_.size());
+        resource_names_.push_back(resource.first);
+      }
+    }
+  }
+
+  demands_.assign(bundles.size(), Quantities(resource_names_.size(), 0));
+  for (size_t i = 0; i < bundles.size(); i++) {
+    for (const auto &resource : bundles[i]) {
+      auto it = resource_index.find(resource.first);
+      if (it != resource_index.end()) {
+        demands_[i][it->second] = ToQuantity(resource.second);
+      }
+    }
+  }
+
+  available_.assign(node_ids_.size(), Quantities(resource_names_.size(), 0));
+  cluster_total_.assign(resource_names_.size(), 0);
+  for (size_t n = 0; n < node_ids_.size(); n++) {
+    for (size_t r = 0; r < resource_names_.size(); r++) {
+      auto it = node_resources_[n].find(resource_names_[r]);
+      if (it != node_resources_[n].end()) {
+        available_[n][r] = ToQuantity(it->second);
+        cluster_total_[r] += available_[n][r];
+      }
+    }
+  }
+  for (auto total : cluster_total_) {
+    if (total <= 0) {
+      return false;
+    }
+  }
+  return true;
+}
+
+bool BundleBinPacker::Fits(const Quantities &demand, const Quantities &available) {
+  for (size_t r = 0; r < demand.size(); r++) {
+    if (demand[r] > available[r]) {
+      return false;
+    }
+  }
+  return true;
+}
+
+double BundleBinPacker::NormalizedAvailable(const Quantities &available) const {
+  double result = 0;
+  for (size_t r = 0; r < available.size(); r++) {
+    result += static_cast<double>(available[r]) / cluster_total_[r];
+  }
+  return result;
+}
+
+std::vector<size_t> BundleBinPacker::PlacementOrder() const {
+  std::vector<double> dominant_share(demands_.size(), 0);
+  std::vector<double> total_share(demands_.size(), 0);
+  for (size_t i = 0; i < demands_.size(); i++) {
+    for (size_t r = 0; r < resource_names_.size(); r++) {
+      double share = static_cast<double>(demands_[i][r]) / cluster_total_[r];
+      dominant_share[i] = std::max(dominant_share[i], share);
+      total_share[i] += share;
+    }
+  }
+  std::vector<size_t> order(demands_.size());
+  std::iota(order.begin(), order.end(), 0);
+  std::stable_sort(order.begin(), order.end(), [&](size_t a, size_t b) {
+    if (dominant_share[a] != dominant_share[b]) {
+      return dominant_share[a] > dominant_share[b];
+    }
+    return total_share[a] > total_share[b];
+  });
+  return order;
+}
+
+std::vector<NodeID> BundleBinPacker::ToNodeIDs(const std::vector<int> &assignment) const {
+  std::vector<NodeID> result;
+  result.reserve(assignment.size());
+  for (int node : assignment) {
+    result.push_back(node_ids_[node]);
+  }
+  return result;
+}
+
+std::vector<NodeID> BundleBinPacker::Pack(const std::vector<ResourceMap> &bundles) {
+  if (bundles.empty() || !Init(bundles)) {
+    return {};
+  }
+
+  // Best-fit decreasing: put each bundle on the node of the group where it leaves the
+  // least room, and only open a new node (the roomiest one) if it fits nowhere.
+  std::vector<int> assignment(bundles.size(), -1);
+  std::vector<size_t> load(node_ids_.size(), 0);
+  for (size_t bundle : PlacementOrder()) {
+    int best_node = -1;
+    double best_score = 0;
+    for (size_t n = 0; n < node_ids_.size(); n++) {
+      if (load[n] == 0 || !Fits(demands_[bundle], available_[n])) {
+        continue;
+      }
+      double left = NormalizedAvailable(available_[n]);
+      if (best_node == -1 || left < best_score) {
+        best_node = n;
+        best_score = left;
+      }
+    }
+    if (best_node == -1) {
+      for (size_t n = 0; n < node_ids_.size(); n++) {
+        if (load[n] != 0 || !Fits(demands_[bundle], available_[n])) {
+          continue;
+        }
+        double left = NormalizedAvailable(available_[n]);
+        if (best_node == -1 || left > best_score) {
+          best_node = n;
+          best_score = left;
+        }
+      }
+    }
+    if (best_node == -1) {
+      return {};
+    }
+    assignment[bundle] = best_node;
+    load[best_node]++;
+    for (size_t r = 0; r < resource_names_.size(); r++) {
+      available_[best_node][r] -= demands_[bundle][r];
+    }
+  }
+
+  CompactPacking(&assignment, &available_);
+  return ToNodeIDs(assignment);
+}
+
+void BundleBinPacker::CompactPacking(std::vector<int> *assignment,
+                                     std::vector<Quantities> *available) const {
+  bool improved = true;
+  while (improved) {
+    improved = false;
+    std::unordered_map<int, std::vector<size_t>> bundles_on_node;
+    for (size_t i = 0; i < assignment->size(); i++) {
+      bundles_on_node[(*assignment)[i]].push_back(i);
+    }
+    if (bundles_on_node.size() <= 1) {
+      return;
+    }
+    // Try to empty the nodes with the fewest bundles first.
+    std::vector<int> used_nodes;
+    for (const auto &entry : bundles_on_node) {
+      used_nodes.push_back(entry.first);
+    }
+    std::sort(used_nodes.begin(), used_nodes.end(), [&](int a, int b) {
+      if (bundles_on_node[a].size() != bundles_on_node[b].size()) {
+        return bundles_on_node[a].size() < bundles_on_node[b].size();
+      }
+      return a < b;
+    });
+
+    for (int victim : used_nodes) {
+      auto trial_available = *available;
+      auto trial_assignment = *assignment;
+      bool moved_all = true;
+      for (size_t bundle : bundles_on_node[victim]) {
+        int best_node = -1;
+        double best_score = 0;
+        for (int n : used_nodes) {
+          if (n == victim || !Fits(demands_[bundle], trial_available[n])) {
+            continue;
+          }
+          double left = NormalizedAvailable(trial_available[n]);
+          if (best_node == -1 || left < best_score) {
+            best_node = n;
+            best_score = left;
+          }
+        }
+        if (best_node == -1) {
+          moved_all = false;
+          break;
+        }
+        trial_assignment[bundle] = best_node;
+        for (size_t r = 0; r < resource_names_.size(); r++) {
+          trial_available[best_node][r] -= demands_[bundle][r];
+          trial_available[victim][r] += demands_[bundle][r];
+        }
+      }
+      if (moved_all) {
+        *available = std::move(trial_available);
+        *assignment = std::move(trial_assignment);
+        improved = true;
+        break;
+      }
+    }
+  }
+}
+
+std::vector<NodeID> BundleBinPacker::Spread(const std::vector<ResourceMap> &bundles) {
+  if (bundles.empty() || !Init(bundles)) {
+    return {};
+  }
+
+  std::vector<int> assignment(bundles.size(), -1);
+  std::vector<size_t> load(node_ids_.size(), 0);
+  for (size_t bundle : PlacementOrder()) {
+    int best_node = -1;
+    double best_score = 0;
+    for (size_t n = 0; n < node_ids_.size(); n++) {
+      if (!Fits(demands_[bundle], available_[n])) {
+        continue;
+      }
+      double left = NormalizedAvailable(available_[n]);
+      if (best_node == -1 || load[n] < load[best_node] ||
+          (load[n] == load[best_node] && left > best_score)) {
+        best_node = n;
+        best_score = left;
+      }
+    }
+    if (best_node == -1) {
+      return {};
+    }
+    assignment[bundle] = best_node;
+    load[best_node]++;
+    for (size_t r = 0; r < resource_names_.size(); r++) {
+      available_[best_node][r] -= demands_[bundle][r];
+    }
+  }
+  return ToNodeIDs(assignment);
+}
+
+bool BundleBinPacker::Augment(size_t bundle,
+                              const std::vector<std::vector<size_t>> &candidates,
+                              std::vector<int> *node_to_bundle,
+                              std::vector<bool> *visited) const {
+  for (size_t node : candidates[bundle]) {
+    if ((*visited)[node]) {
+      continue;
+    }
+    (*visited)[node] = true;
+    int matched = (*node_to_bundle)[node];
+    if (matched == -1 || Augment(matched, candidates, node_to_bundle, visited)) {
+      (*node_to_bundle)[node] = bundle;
+      return true;
+    }
+  }
+  return false;
+}
+
+std::vector<NodeID> BundleBinPacker::StrictSpread(
+    const std::vector<ResourceMap> &bundles) {
+  if (bundles.empty() || bundles.size() > node_ids_.size() || !Init(bundles)) {
+    return {};
+  }
+
+  // Each bundle may go to any node it fits on by itself. Prefer the roomiest nodes, so
+  // that the matching leaves the tight nodes to the bundles that need them.
+  std::vector<size_t> nodes_by_room(node_ids_.size());
+  std::iota(nodes_by_room.begin(), nodes_by_room.end(), 0);
+  std::vector<double> room(node_ids_.size());
+  for (size_t n = 0; n < node_ids_.size(); n++) {
+    room[n] = NormalizedAvailable(available_[n]);
+  }
+  std::stable_sort(nodes_by_room.begin(), nodes_by_room.end(),
+                   [&room](size_t a, size_t b) { return room[a] > room[b]; });
+  std::vector<std::vector<size_t>> candidates(bundles.size());
+  for (size_t i = 0; i < bundles.size(); i++) {
+    for (size_t n : nodes_by_room) {
+      if (Fits(demands_[i], available_[n])) {
+        candidates[i].push_back(n);
+      }
+    }
+  }
+
+  std::vector<int> node_to_bundle(node_ids_.size(), -1);
+  std::vector<bool> visited(node_ids_.size());
+  for (size_t bundle : PlacementOrder()) {
+    std::fill(visited.begin(), visited.end(), false);
+    if (!Augment(bundle, candidates, &node_to_bundle, &visited)) {
+      return {};
+    }
+  }
+
+  std::vector<int> assignment(bundles.size(), -1);
+  for (size_t n = 0; n < node_ids_.size(); n++) {
+    if (node_to_bundle[n] != -1) {
+      assignment[node_to_bundle[n]] = n;
+    }
+  }
+  return ToNodeIDs(assignment);
+}
+
+std::vector<NodeID> BundleBinPacker::StrictPack(const std::vector<ResourceMap> &bundles) {
+  if (bundles.empty() || !Init(bundles)) {
+    return {};
+  }
+
+  Quantities total_demand(resource_names_.size(), 0);
+  for (const auto &demand : demands_) {
+    for (size_t r = 0; r < resource_names_.size(); r++) {
+      total_demand[r] += demand[r];
+    }
+  }
+  // The group takes a whole node anyway, so balance the groups across the nodes.
+  int best_node = -1;
+  double best_score = 0;
+  for (size_t n = 0; n < node_ids_.size(); n++) {
+    if (!Fits(total_demand, available_[n])) {
+      continue;
+    }
+    double left = NormalizedAvailable(available_[n]);
+    if (best_node == -1 || left > best_score) {
+      best_node = n;
+      best_score = left;
+    }
+  }
+  if (best_node == -1) {
+    return {};
+  }
+  return std::vector<NodeID>(bundles.size(), node_ids_[best_node]);
+}
+
+}  // namespace gcs
+}  // namespace ray
@@ -0,0 +1,129 @@
+// Copyright 2017 The Ray Authors.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//  http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#pragma once
+
+#include <string>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+#include "ray/common/id.h"
+
+namespace ray {
+namespace gcs {
+
+/// \class BundleBinPacker
+///
+/// Places all the bundles of a placement group over a snapshot of the available
+/// resources of the cluster in one pass. Unlike scoring the nodes for each bundle
+/// independently, the packer sees the whole group:
+/// - Bundles are placed in the order of their dominant resource share, so that bundles
+///   that need scarce resources (such as GPUs) or a large share of the cluster are
+///   placed first, while there is still room for them.
+/// - PACK uses best-fit decreasing, then a local search that tries to empty the least
+///   loaded node by moving its bundles onto the other nodes of the group.
+/// - SPREAD places each bundle on the node with the fewest bundles of the group, and
+///   among those the one with the most resources left.
+/// - STRICT_SPREAD is solved as a bipartite matching between bundles and nodes, so it
+///   finds a placement whenever one exists.
+/// - STRICT_PACK picks the node with the most resources left that fits the whole group,
+///   which balances the groups across the nodes.
+///
+/// The packer works on its own copy of the resources, so a failed placement never
+/// needs to be rolled back. This class is not thread-safe.
+class BundleBinPacker {
+ public:
+  using ResourceMap = std::unordered_map<std::string, double>;
+
+  /// Create a packer over the given nodes.
+  ///
+  /// \param nodes The candidate nodes and their available resources.
+  explicit BundleBinPacker(const std::vector<std::pair<NodeID, ResourceMap>> &nodes);
+
+  /// Place the bundles on as few nodes as possible.
+  ///
+  /// \param bundles The resources required by each bundle.
+  /// \return The selected node of each bundle, corresponding to `bundles` one by one.
+  /// If the bundles cannot be placed, an empty vector is returned.
+  std::vector<NodeID> Pack(const std::vector<ResourceMap> &bundles);
+
+  /// Place the bundles across distinct nodes as evenly as possible.
+  ///
+  /// \param bundles The resources required by each bundle.
+  /// \return The selected node of each bundle, or an empty vector on failure.
+  std::vector<NodeID> Spread(const std::vector<ResourceMap> &bundles);
+
+  /// Place each bundle on a different node.
+  ///
+  /// \param bundles The resources required by each bundle.
+  /// \return The selected node of each bundle, or an empty vector on failure.
+  std::vector<NodeID> StrictSpread(const std::vector<ResourceMap> &bundles);
+
+  /// Place all the bundles on one node.
+  ///
+  /// \param bundles The resources required by each bundle.
+  /// \return The selected node of each bundle, or an empty vector on failure.
+  std::vector<NodeID> StrictPack(const std::vector<ResourceMap> &bundles);
+
+ private:
+  /// Resource quantities in fixed point, in the same unit as the resource scheduler.
+  using Quantities = std::vector<int64_t>;
+
+  /// Index the resources required by the bundles and snapshot the available
+  /// resources of every node. Returns false if some bundle requires a resource that
+  /// no node has.
+  bool Init(const std::vector<ResourceMap> &bundles);
+
+  /// Whether the demand fits in the available resources.
+  static bool Fits(const Quantities &demand, const Quantities &available);
+
+  /// The resources left on a node, normalized by the cluster total of each resource.
+  double NormalizedAvailable(const Quantities &available) const;
+
+  /// The bundle indices, with the largest dominant resource share first.
+  std::vector<size_t> PlacementOrder() const;
+
+  /// Move the bundles off the least loaded nodes of the group where possible.
+  ///
+  /// \param assignment The node index of each bundle, updated in place.
+  /// \param available The available resources of each node, updated in place.
+  void CompactPacking(std::vector<int> *assignment,
+                      std::vector<Quantities> *available) const;
+
+  /// Find an augmenting path for the bundle in the bundle-node matching.
+  bool Augment(size_t bundle, const std::vector<std::vector<size_t>> &candidates,
+               std::vector<int> *node_to_bundle, std::vector<bool> *visited) const;
+
+  /// Convert the node index of each bundle to node IDs.
+  std::vector<NodeID> ToNodeIDs(const std::vector<int> &assignment) const;
+
+  /// The candidate nodes.
+  std::vector<NodeID> node_ids_;
+  /// The available resources of each candidate node, as given.
+  std::vector<ResourceMap> node_resources_;
+
+  /// The state of the current placement, built by `Init`.
+  /// The names of the resources required by the bundles.
+  std::vector<std::string> resource_names_;
+  /// The resources required by each bundle.
+  std::vector<Quantities> demands_;
+  /// The available resources of each node.
+  std::vector<Quantities> available_;
+  /// The total available amount of each resource over all nodes.
+  Quantities cluster_total_;
+};
+
+}  // namespace gcs
+}  // namespace ray
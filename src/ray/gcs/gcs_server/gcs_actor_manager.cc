@@ -132,12 +132,13 @@ void GcsActorManager::HandleCreateActor(const rpc::CreateActorRequest &request,
 
   RAY_LOG(INFO) << "Creating actor, job id = " << actor_id.JobId()
                 << ", actor id = " << actor_id;
-  Status status = CreateActor(request, [reply, send_reply_callback, actor_id](
-                                           const std::shared_ptr<gcs::GcsActor> &actor) {
-    RAY_LOG(INFO) << "Finished creating actor, job id = " << actor_id.JobId()
-                  << ", actor id = " << actor_id;
-    GCS_RPC_SEND_REPLY(send_reply_callback, reply, Status::OK());
-  });
+  Status status = CreateActor(
+      request, [reply, send_reply_callback, actor_id](
+                   const std::shared_ptr<gcs::GcsActor> &actor, const Status &status) {
+        RAY_LOG(INFO) << "Finished creating actor, job id = " << actor_id.JobId()
+                      << ", actor id = " << actor_id << ", status = " << status;
+        GCS_RPC_SEND_REPLY(send_reply_callback, reply, status);
+      });
   if (!status.ok()) {
     RAY_LOG(ERROR) << "Failed to create actor, job id = " << actor_id.JobId()
                    << ", actor id = " << actor_id << ", status: " << status.ToString();
@@ -146,6 +147,96 @@ void GcsActorManager::HandleCreateActor(const rpc::CreateActorRequest &request,
   ++counts_[CountType::CREATE_ACTOR_REQUEST];
 }
 
+namespace {
+
+/// Collects the per-actor results of a batch request into a single reply. The
+/// reply is sent once every actor has a result, i.e., has either failed
+/// synchronously or invoked its callback.
+template <typename Reply>
+class BatchReplier {
+ public:
+  BatchReplier(size_t num_actors, Reply *reply,
+               rpc::SendReplyCallback send_reply_callback)
+      : statuses_(num_actors),
+        num_pending_(num_actors + 1),
+        reply_(reply),
+        send_reply_callback_(std::move(send_reply_callback)) {}
+
+  /// Record the synchronous results of the batch. This must be called once,
+  /// after all the per-actor operations were issued.
+  void OnIssued(const std::vector<Status> &statuses) {
+    RAY_CHECK(statuses.size() == statuses_.size());
+    for (size_t i = 0; i < statuses.size(); i++) {
+      if (!statuses[i].ok()) {
+        OnActorDone(i, statuses[i]);
+      }
+    }
+    OnDone();
+  }
+
+  /// Record the result of the actor at the given index of the batch.
+  void OnActorDone(size_t index, const Status &status) {
+    statuses_[index] = status;
+    OnDone();
+  }
+
+ private:
+  void OnDone() {
+    RAY_CHECK(num_pending_ > 0);
+    if (--num_pending_ > 0) {
+      return;
+    }
+    Status status;
+    for (const auto &actor_status : statuses_) {
+      auto *reply_status = reply_->add_actor_statuses();
+      reply_status->set_code((int)actor_status.code());
+      reply_status->set_message(actor_status.message());
+      if (status.ok()) {
+        status = actor_status;
+      }
+    }
+    RAY_LOG(INFO) << "Finished a batch of " << statuses_.size()
+                  << " actors, status = " << status;
+    GCS_RPC_SEND_REPLY(send_reply_callback_, reply_, status);
+  }
+
+  /// The result of each actor, in the order of the request.
+  std::vector<Status> statuses_;
+  /// The number of actors that have no result yet, plus one until the batch
+  /// has been fully issued.
+  size_t num_pending_;
+  Reply *reply_;
+  rpc::SendReplyCallback send_reply_callback_;
+};
+
+}  // namespace
+
+void GcsActorManager::HandleRegisterActors(const rpc::RegisterActorsRequest &request,
+                                           rpc::RegisterActorsReply *reply,
+                                           rpc::SendReplyCallback send_reply_callback) {
+  RAY_LOG(INFO) << "Registering " << request.task_specs_size() << " actors.";
+  auto replier = std::make_shared<BatchReplier<rpc::RegisterActorsReply>>(
+      request.task_specs_size(), reply, send_reply_callback);
+  auto statuses = RegisterActors(
+      request, [replier](size_t index, const std::shared_ptr<gcs::GcsActor> &,
+                         const Status &status) { replier->OnActorDone(index, status); });
+  replier->OnIssued(statuses);
+  ++counts_[CountType::REGISTER_ACTORS_REQUEST];
+}
+
+void GcsActorManager::HandleCreateActors(const rpc::CreateActorsRequest &request,
+                                         rpc::CreateActorsReply *reply,
+                                         rpc::SendReplyCallback send_reply_callback) {
+  RAY_LOG(INFO) << "Creating " << request.task_specs_size() << " actors.";
+  auto replier = std::make_shared<BatchReplier<rpc::CreateActorsReply>>(
+      request.task_specs_size(), reply, send_reply_callback);
+  auto statuses = CreateActors(
+      request, [replier](size_t index, const std::shared_ptr<gcs::GcsActor> &,
+                         const Status &status) { replier->OnActorDone(index, status); });
+  replier->OnIssued(statuses);
+  ++counts_[CountType::CREATE_ACTORS_REQUEST];
+}
+
 void GcsActorManager::HandleGetActorInfo(const rpc::GetActorInfoRequest &request,
                                          rpc::GetActorInfoReply *reply,
                                          rpc::SendReplyCallback send_reply_callback) {
@@ -216,11 +307,29 @@ void GcsActorManager::HandleGetNamedActorInfo(
 
 Status GcsActorManager::RegisterActor(const ray::rpc::RegisterActorRequest &request,
                                       RegisterActorCallback success_callback) {
+  return DoRegisterActor(request.task_spec(), std::move(success_callback));
+}
+
+std::vector<Status> GcsActorManager::RegisterActors(
+    const rpc::RegisterActorsRequest &request, const BatchActorCallback &callback) {
+  std::vector<Status> statuses;
+  statuses.reserve(request.task_specs_size());
+  for (size_t i = 0; i < static_cast<size_t>(request.task_specs_size()); i++) {
+    statuses.emplace_back(DoRegisterActor(
+        request.task_specs(i), [callback, i](std::shared_ptr<GcsActor> actor) {
+          callback(i, std::move(actor), Status::OK());
+        }));
+  }
+  return statuses;
+}
+
+Status GcsActorManager::DoRegisterActor(const rpc::TaskSpec &task_spec,
+                                        RegisterActorCallback success_callback) {
   // NOTE: After the abnormal recovery of the network between GCS client and GCS server or
   // the GCS server is restarted, it is required to continue to register actor
   // successfully.
   RAY_CHECK(success_callback);
-  const auto &actor_creation_task_spec = request.task_spec().actor_creation_task_spec();
+  const auto &actor_creation_task_spec = task_spec.actor_creation_task_spec();
   auto actor_id = ActorID::FromBinary(actor_creation_task_spec.actor_id());
 
   auto iter = registered_actors_.find(actor_id);
@@ -241,7 +350,7 @@ Status GcsActorManager::RegisterActor(const ray::rpc::RegisterActorRequest &requ
     return Status::OK();
   }
 
-  auto actor = std::make_shared<GcsActor>(request.task_spec());
+  auto actor = std::make_shared<GcsActor>(task_spec);
   if (!actor->GetName().empty()) {
     auto it = named_actors_.find(actor->GetName());
     if (it == named_actors_.end()) {
@@ -304,11 +413,48 @@ Status GcsActorManager::RegisterActor(const ray::rpc::RegisterActorRequest &requ
 
 Status GcsActorManager::CreateActor(const ray::rpc::CreateActorRequest &request,
                                     CreateActorCallback callback) {
+  std::shared_ptr<GcsActor> actor_to_schedule;
+  RAY_RETURN_NOT_OK(
+      DoCreateActor(request.task_spec(), std::move(callback), &actor_to_schedule));
+  if (actor_to_schedule) {
+    gcs_actor_scheduler_->Schedule(std::move(actor_to_schedule));
+  }
+  return Status::OK();
+}
+
+std::vector<Status> GcsActorManager::CreateActors(const rpc::CreateActorsRequest &request,
+                                                  const BatchActorCallback &callback) {
+  std::vector<Status> statuses;
+  statuses.reserve(request.task_specs_size());
+  std::vector<std::shared_ptr<GcsActor>> actors_to_schedule;
+  for (size_t i = 0; i < static_cast<size_t>(request.task_specs_size()); i++) {
+    std::shared_ptr<GcsActor> actor_to_schedule;
+    statuses.emplace_back(DoCreateActor(
+        request.task_specs(i),
+        [callback, i](std::shared_ptr<GcsActor> actor, const Status &status) {
+          callback(i, std::move(actor), status);
+        },
+        &actor_to_schedule));
+    if (actor_to_schedule) {
+      actors_to_schedule.emplace_back(std::move(actor_to_schedule));
+    }
+  }
+  // Schedule all the actors in one pass, so that the scheduler can spread them across
+  // the cluster instead of placing them one by one.
+  if (!actors_to_schedule.empty()) {
+    gcs_actor_scheduler_->ScheduleBatch(actors_to_schedule);
+  }
+  return statuses;
+}
+
+Status GcsActorManager::DoCreateActor(const rpc::TaskSpec &task_spec,
+                                      CreateActorCallback callback,
+                                      std::shared_ptr<GcsActor> *actor_to_schedule) {
   // NOTE: After the abnormal recovery of the network between GCS client and GCS server or
   // the GCS server is restarted, it is required to continue to create actor
   // successfully.
   RAY_CHECK(callback);
-  const auto &actor_creation_task_spec = request.task_spec().actor_creation_task_spec();
+  const auto &actor_creation_task_spec = task_spec.actor_creation_task_spec();
   auto actor_id = ActorID::FromBinary(actor_creation_task_spec.actor_id());
 
   auto iter = registered_actors_.find(actor_id);
@@ -322,7 +468,7 @@ Status GcsActorManager::CreateActor(const ray::rpc::CreateActorRequest &request,
     // In case of temporary network failures, workers will re-send multiple duplicate
     // requests to GCS server.
     // In this case, we can just reply.
-    callback(iter->second);
+    callback(iter->second, Status::OK());
     return Status::OK();
   }
 
@@ -348,7 +494,7 @@ Status GcsActorManager::CreateActor(const ray::rpc::CreateActorRequest &request,
   }
 
   // Remove the actor from the unresolved actor map.
-  auto actor = std::make_shared<GcsActor>(request.task_spec());
+  auto actor = std::make_shared<GcsActor>(task_spec);
   actor->GetMutableActorTableData()->set_state(rpc::ActorTableData::PENDING_CREATION);
   RemoveUnresolvedActor(actor);
 
@@ -356,8 +502,8 @@ Status GcsActorManager::CreateActor(const ray::rpc::CreateActorRequest &request,
   // to resolved dependencies.
   registered_actors_[actor_id] = actor;
 
-  // Schedule the actor.
-  gcs_actor_scheduler_->Schedule(actor);
+  // The caller schedules the actor.
+  *actor_to_schedule = std::move(actor);
   return Status::OK();
 }
 
@@ -415,10 +561,18 @@ void GcsActorManager::DestroyActor(const ActorID &actor_id) {
   RAY_LOG(INFO) << "Destroying actor, actor id = " << actor_id
                 << ", job id = " << actor_id.JobId();
   actor_to_register_callbacks_.erase(actor_id);
-  actor_to_create_callbacks_.erase(actor_id);
   auto it = registered_actors_.find(actor_id);
   RAY_CHECK(it != registered_actors_.end())
       << "Tried to destroy actor that does not exist " << actor_id;
+  // Fail the pending creation requests of the actor, since it will never be created.
+  auto create_callbacks_it = actor_to_create_callbacks_.find(actor_id);
+  if (create_callbacks_it != actor_to_create_callbacks_.end()) {
+    auto callbacks = std::move(create_callbacks_it->second);
+    actor_to_create_callbacks_.erase(create_callbacks_it);
+    for (auto &callback : callbacks) {
+      callback(it->second, Status::Invalid("Actor was destroyed before it was created."));
+    }
+  }
   it->second->GetMutableActorTableData()->mutable_task_spec()->Clear();
   it->second->GetMutableActorTableData()->set_timestamp(current_sys_time_ms());
   AddDestroyedActorToCache(it->second);
@@ -762,7 +916,7 @@ void GcsActorManager::OnActorCreationSuccess(const std::shared_ptr<GcsActor> &ac
         auto iter = actor_to_create_callbacks_.find(actor_id);
         if (iter != actor_to_create_callbacks_.end()) {
           for (auto &callback : iter->second) {
-            callback(actor);
+            callback(actor, Status::OK());
           }
           actor_to_create_callbacks_.erase(iter);
         }
@@ -958,6 +1112,9 @@ std::string GcsActorManager::DebugString() const {
   stream << "GcsActorManager: {RegisterActor request count: "
          << counts_[CountType::REGISTER_ACTOR_REQUEST]
          << ", CreateActor request count: " << counts_[CountType::CREATE_ACTOR_REQUEST]
+         << ", RegisterActors request count: "
+         << counts_[CountType::REGISTER_ACTORS_REQUEST]
+         << ", CreateActors request count: " << counts_[CountType::CREATE_ACTORS_REQUEST]
          << ", GetActorInfo request count: " << counts_[CountType::GET_ACTOR_INFO_REQUEST]
          << ", GetNamedActorInfo request count: "
          << counts_[CountType::GET_NAMED_ACTOR_INFO_REQUEST]
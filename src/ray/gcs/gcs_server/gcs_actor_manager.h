@@ -109,7 +109,13 @@ class GcsActor {
 };
 
 using RegisterActorCallback = std::function<void(std::shared_ptr<GcsActor>)>;
-using CreateActorCallback = std::function<void(std::shared_ptr<GcsActor>)>;
+/// Invoked with OK once the actor is created, or with an error if the actor is
+/// destroyed before it could be created.
+using CreateActorCallback =
+    std::function<void(std::shared_ptr<GcsActor>, const Status &status)>;
+/// Invoked with the result of the actor at the given index of a batch request.
+using BatchActorCallback = std::function<void(
+    size_t index, std::shared_ptr<GcsActor> actor, const Status &status)>;
 
 /// GcsActorManager is responsible for managing the lifecycle of all actors.
 /// This class is not thread-safe.
@@ -178,6 +184,14 @@ class GcsActorManager : public rpc::ActorInfoHandler {
                          rpc::CreateActorReply *reply,
                          rpc::SendReplyCallback send_reply_callback) override;
 
+  void HandleRegisterActors(const rpc::RegisterActorsRequest &request,
+                            rpc::RegisterActorsReply *reply,
+                            rpc::SendReplyCallback send_reply_callback) override;
+
+  void HandleCreateActors(const rpc::CreateActorsRequest &request,
+                          rpc::CreateActorsReply *reply,
+                          rpc::SendReplyCallback send_reply_callback) override;
+
   void HandleGetActorInfo(const rpc::GetActorInfoRequest &request,
                           rpc::GetActorInfoReply *reply,
                           rpc::SendReplyCallback send_reply_callback) override;
@@ -207,12 +221,36 @@ class GcsActorManager : public rpc::ActorInfoHandler {
   /// \param request Contains the meta info to create the actor.
   /// \param callback Will be invoked after the actor is created successfully or be
   /// invoked immediately if the actor is already registered to `registered_actors_` and
-  /// its state is `ALIVE`.
+  /// its state is `ALIVE`. If the actor is destroyed before it is created, the callback
+  /// is invoked with an error.
   /// \return Status::Invalid if this is a named actor and an actor with the specified
   /// name already exists. The callback will not be called in this case.
   Status CreateActor(const rpc::CreateActorRequest &request,
                      CreateActorCallback callback);
 
+  /// Register a batch of actors asynchronously. This is equivalent to registering
+  /// each of the actors with `RegisterActor`.
+  ///
+  /// \param request Contains the meta info to create the actors.
+  /// \param callback Will be invoked with OK once for each actor that is registered
+  /// successfully.
+  /// \return The status of registering each actor, in the order of the request. The
+  /// callback will not be called for the actors whose status is not OK.
+  std::vector<Status> RegisterActors(const rpc::RegisterActorsRequest &request,
+                                     const BatchActorCallback &callback);
+
+  /// Create a batch of actors asynchronously. This is equivalent to creating each of
+  /// the actors with `CreateActor`, except that the actors are handed to the
+  /// scheduler together so that they can be placed in one scheduling pass.
+  ///
+  /// \param request Contains the meta info to create the actors.
+  /// \param callback Will be invoked once for each actor, as `CreateActor` would invoke
+  /// it, i.e., with an error if the actor is destroyed before it is created.
+  /// \return The status of creating each actor, in the order of the request. The
+  /// callback will not be called for the actors whose status is not OK.
+  std::vector<Status> CreateActors(const rpc::CreateActorsRequest &request,
+                                   const BatchActorCallback &callback);
+
   /// Get the actor ID for the named actor. Returns nil if the actor was not found.
   /// \param name The name of the detached actor to look up.
   /// \returns ActorID The ID of the actor. Nil if the actor was not found.
@@ -295,6 +333,21 @@ class GcsActorManager : public rpc::ActorInfoHandler {
     absl::flat_hash_set<ActorID> children_actor_ids;
   };
 
+  /// Register the actor of the given creation task. See `RegisterActor`.
+  Status DoRegisterActor(const rpc::TaskSpec &task_spec,
+                         RegisterActorCallback success_callback);
+
+  /// Handle a request to create the actor of the given creation task. See
+  /// `CreateActor`.
+  ///
+  /// \param task_spec The creation task of the actor, with resolved dependencies.
+  /// \param callback Will be invoked after the actor is created successfully.
+  /// \param[out] actor_to_schedule Set to the actor if the caller must schedule it,
+  /// left unchanged if the actor is already alive or being created.
+  /// \return Status::Invalid if the actor is not registered.
+  Status DoCreateActor(const rpc::TaskSpec &task_spec, CreateActorCallback callback,
+                       std::shared_ptr<GcsActor> *actor_to_schedule);
+
   /// Poll an actor's owner so that we will receive a notification when the
   /// actor has gone out of scope, or the owner has died. This should not be
   /// called for detached actors.
@@ -403,6 +456,8 @@ class GcsActorManager : public rpc::ActorInfoHandler {
     GET_ACTOR_INFO_REQUEST = 2,
     GET_NAMED_ACTOR_INFO_REQUEST = 3,
     GET_ALL_ACTOR_INFO_REQUEST = 4,
+    REGISTER_ACTORS_REQUEST = 5,
+    CREATE_ACTORS_REQUEST = 6,
     CountType_MAX = 10,
   };
   uint64_t counts_[CountType::CountType_MAX] = {0};
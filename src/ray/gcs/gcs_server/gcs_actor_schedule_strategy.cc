@@ -36,6 +36,61 @@ std::shared_ptr<rpc::GcsNodeInfo> GcsRandomActorScheduleStrategy::Schedule(
   return node;
 }
 
+std::vector<std::shared_ptr<rpc::GcsNodeInfo>>
+GcsRandomActorScheduleStrategy::ScheduleBatch(
+    const std::vector<std::shared_ptr<GcsActor>> &actors) {
+  std::vector<std::shared_ptr<rpc::GcsNodeInfo>> nodes(actors.size());
+  const auto &alive_nodes = gcs_node_manager_->GetAllAliveNodes();
+  if (alive_nodes.empty()) {
+    return nodes;
+  }
+
+  // The candidate nodes, along with the resources that are still available on them
+  // after placing the earlier actors of the batch.
+  std::vector<std::pair<std::shared_ptr<rpc::GcsNodeInfo>, ResourceSet>> candidates;
+  candidates.reserve(alive_nodes.size());
+  for (const auto &entry : alive_nodes) {
+    ResourceSet available;
+    if (gcs_resource_manager_) {
+      const auto &cluster_resources = gcs_resource_manager_->GetClusterResources();
+      auto it = cluster_resources.find(entry.first);
+      if (it != cluster_resources.end()) {
+        available = it->second.GetAvailableResources();
+      }
+    }
+    candidates.emplace_back(entry.second, std::move(available));
+  }
+  static std::mt19937_64 gen_(
+      std::chrono::high_resolution_clock::now().time_since_epoch().count());
+  std::uniform_int_distribution<size_t> distribution(0, candidates.size() - 1);
+  size_t next = distribution(gen_);
+  for (size_t i = 0; i < actors.size(); i++) {
+    const auto &task_spec = actors[i]->GetCreationTaskSpecification();
+    const auto &required_resources = task_spec.GetRequiredResources();
+    if (required_resources.IsEmpty()) {
+      nodes[i] = candidates[next++ % candidates.size()].first;
+      continue;
+    }
+    if (gcs_resource_manager_) {
+      for (size_t j = 0; j < candidates.size(); j++) {
+        auto &candidate = candidates[(next + j) % candidates.size()];
+        if (required_resources.IsSubset(candidate.second)) {
+          candidate.second.SubtractResources(required_resources);
+          nodes[i] = candidate.first;
+          next += j + 1;
+          break;
+        }
+      }
+    }
+    if (nodes[i] == nullptr) {
+      // No node is known to have room for the actor, so fall back to the placement
+      // of a single actor and let the raylet queue or spill it back.
+      nodes[i] = Schedule(actors[i]);
+    }
+  }
+  return nodes;
+}
+
 std::shared_ptr<rpc::GcsNodeInfo> GcsRandomActorScheduleStrategy::SelectNodeRandomly()
     const {
   auto &alive_nodes = gcs_node_manager_->GetAllAliveNodes();
@@ -16,6 +16,7 @@
 
 #include "ray/common/id.h"
 #include "ray/gcs/gcs_server/gcs_node_manager.h"
+#include "ray/gcs/gcs_server/gcs_resource_manager.h"
 
 namespace ray {
 namespace gcs {
@@ -34,6 +35,22 @@ class GcsActorScheduleStrategyInterface {
   /// \param actor The actor to be scheduled.
   /// \return The selected node. If the scheduling fails, nullptr is returned.
   virtual std::shared_ptr<rpc::GcsNodeInfo> Schedule(std::shared_ptr<GcsActor> actor) = 0;
+
+  /// Select the nodes to schedule a batch of actors. By default, each actor is
+  /// scheduled independently.
+  ///
+  /// \param actors The actors to be scheduled.
+  /// \return The selected nodes, corresponding to `actors` one by one. The node of an
+  /// actor that cannot be scheduled is nullptr.
+  virtual std::vector<std::shared_ptr<rpc::GcsNodeInfo>> ScheduleBatch(
+      const std::vector<std::shared_ptr<GcsActor>> &actors) {
+    std::vector<std::shared_ptr<rpc::GcsNodeInfo>> nodes;
+    nodes.reserve(actors.size());
+    for (const auto &actor : actors) {
+      nodes.emplace_back(Schedule(actor));
+    }
+    return nodes;
+  }
 };
 
 /// \class GcsRandomActorScheduleStrategy
@@ -45,9 +62,14 @@ class GcsRandomActorScheduleStrategy : public GcsActorScheduleStrategyInterface
   ///
   /// \param gcs_node_manager Node management of the cluster, which provides interfaces
   /// to access the node information.
+  /// \param gcs_resource_manager Provides the available resources of each node, which
+  /// are used to place batches of actors. If null, actors with resource requirements
+  /// are placed one by one as in `Schedule`.
   explicit GcsRandomActorScheduleStrategy(
-      std::shared_ptr<GcsNodeManager> gcs_node_manager)
-      : gcs_node_manager_(std::move(gcs_node_manager)) {}
+      std::shared_ptr<GcsNodeManager> gcs_node_manager,
+      std::shared_ptr<GcsResourceManager> gcs_resource_manager = nullptr)
+      : gcs_node_manager_(std::move(gcs_node_manager)),
+        gcs_resource_manager_(std::move(gcs_resource_manager)) {}
 
   virtual ~GcsRandomActorScheduleStrategy() = default;
 
@@ -57,6 +79,20 @@ class GcsRandomActorScheduleStrategy : public GcsActorScheduleStrategyInterface
   /// \return The selected node. If the scheduling fails, nullptr is returned.
   std::shared_ptr<rpc::GcsNodeInfo> Schedule(std::shared_ptr<GcsActor> actor) override;
 
+  /// Select the nodes to schedule a batch of actors. Instead of placing each actor
+  /// on its owner's node or on a random node, the batch is spread round-robin over
+  /// all the alive nodes, starting from a random one. An actor with resource
+  /// requirements is only placed on a node whose available resources, minus those
+  /// taken by the earlier actors of the batch, can hold it. This keeps a large pool
+  /// of identical actors from piling up on one raylet and then being spilled back
+  /// one by one. An actor that fits on no node is placed as in `Schedule`.
+  ///
+  /// \param actors The actors to be scheduled.
+  /// \return The selected nodes, corresponding to `actors` one by one. If there are no
+  /// alive nodes, all of them are nullptr.
+  std::vector<std::shared_ptr<rpc::GcsNodeInfo>> ScheduleBatch(
+      const std::vector<std::shared_ptr<GcsActor>> &actors) override;
+
  private:
   /// Select a node from alive nodes randomly.
   ///
@@ -65,6 +101,8 @@ class GcsRandomActorScheduleStrategy : public GcsActorScheduleStrategyInterface
 
   /// The node manager.
   std::shared_ptr<GcsNodeManager> gcs_node_manager_;
+  /// The resource manager, which may be null.
+  std::shared_ptr<GcsResourceManager> gcs_resource_manager_;
 };
 
 }  // namespace gcs
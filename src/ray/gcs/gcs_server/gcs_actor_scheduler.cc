@@ -48,8 +48,47 @@ void GcsActorScheduler::Schedule(std::shared_ptr<GcsActor> actor) {
   RAY_CHECK(actor->GetNodeID().IsNil() && actor->GetWorkerID().IsNil());
 
   // Select a node to lease worker for the actor.
-  const auto &node = actor_schedule_strategy_->Schedule(actor);
+  auto node = actor_schedule_strategy_->Schedule(actor);
+  ScheduleOnNode(std::move(actor), std::move(node));
+}
+
+void GcsActorScheduler::ScheduleBatch(
+    const std::vector<std::shared_ptr<GcsActor>> &actors) {
+  for (const auto &actor : actors) {
+    RAY_CHECK(actor->GetNodeID().IsNil() && actor->GetWorkerID().IsNil());
+  }
 
+  // Select the nodes of all the actors at once.
+  auto nodes = actor_schedule_strategy_->ScheduleBatch(actors);
+  RAY_CHECK(nodes.size() == actors.size());
+
+  // Group the actors by node so that the leases from the same raylet are requested
+  // with a single request.
+  absl::flat_hash_map<std::shared_ptr<rpc::GcsNodeInfo>,
+                      std::vector<std::shared_ptr<GcsActor>>>
+      node_to_actors;
+  for (size_t i = 0; i < actors.size(); i++) {
+    node_to_actors[nodes[i]].emplace_back(actors[i]);
+  }
+  RAY_LOG(INFO) << "Scheduling " << actors.size() << " actors on "
+                << node_to_actors.size() << " nodes.";
+  for (auto &entry : node_to_actors) {
+    const auto &node = entry.first;
+    if (node == nullptr) {
+      for (auto &actor : entry.second) {
+        schedule_failure_handler_(std::move(actor));
+      }
+      continue;
+    }
+    for (const auto &actor : entry.second) {
+      SetLeasingNode(actor, node);
+    }
+    LeaseWorkersFromNode(entry.second, node);
+  }
+}
+
+void GcsActorScheduler::ScheduleOnNode(std::shared_ptr<GcsActor> actor,
+                                       std::shared_ptr<rpc::GcsNodeInfo> node) {
   if (node == nullptr) {
     // There are no available nodes to schedule the actor, so just trigger the failed
     // handler.
@@ -57,6 +96,14 @@ void GcsActorScheduler::Schedule(std::shared_ptr<GcsActor> actor) {
     return;
   }
 
+  SetLeasingNode(actor, node);
+
+  // Lease worker directly from the node.
+  LeaseWorkerFromNode(actor, node);
+}
+
+void GcsActorScheduler::SetLeasingNode(const std::shared_ptr<GcsActor> &actor,
+                                       const std::shared_ptr<rpc::GcsNodeInfo> &node) {
   // Update the address of the actor as it is tied to a node.
   rpc::Address address;
   address.set_raylet_id(node->node_id());
@@ -65,9 +112,6 @@ void GcsActorScheduler::Schedule(std::shared_ptr<GcsActor> actor) {
   RAY_CHECK(node_to_actors_when_leasing_[actor->GetNodeID()]
                 .emplace(actor->GetActorID())
                 .second);
-
-  // Lease worker directly from the node.
-  LeaseWorkerFromNode(actor, node);
 }
 
 void GcsActorScheduler::Reschedule(std::shared_ptr<GcsActor> actor) {
@@ -215,47 +259,99 @@ void GcsActorScheduler::LeaseWorkerFromNode(std::shared_ptr<GcsActor> actor,
   int backlog_size = report_worker_backlog_ ? 0 : -1;
   lease_client->RequestWorkerLease(
       actor->GetCreationTaskSpecification(),
-      [this, node_id, actor, node](const Status &status,
-                                   const rpc::RequestWorkerLeaseReply &reply) {
-        // If the actor is still in the leasing map and the status is ok, remove the actor
-        // from the leasing map and handle the reply. Otherwise, lease again, because it
-        // may be a network exception.
-        // If the actor is not in the leasing map, it means that the actor has been
-        // cancelled as the node is dead, just do nothing in this case because the
-        // gcs_actor_manager will reconstruct it again.
-        auto iter = node_to_actors_when_leasing_.find(node_id);
-        if (iter != node_to_actors_when_leasing_.end()) {
-          auto actor_iter = iter->second.find(actor->GetActorID());
-          if (actor_iter == iter->second.end()) {
-            // if actor is not in leasing state, it means it is cancelled.
-            RAY_LOG(INFO)
-                << "Raylet granted a lease request, but the outstanding lease "
-                   "request for "
-                << actor->GetActorID()
-                << " has been already cancelled. The response will be ignored. Job id = "
-                << actor->GetActorID().JobId();
-            return;
-          }
+      [this, actor, node](const Status &status,
+                          const rpc::RequestWorkerLeaseReply &reply) {
+        OnWorkerLeaseReply(actor, node, status, reply);
+      },
+      backlog_size);
+}
 
-          if (status.ok()) {
-            // Remove the actor from the leasing map as the reply is returned from the
-            // remote node.
-            iter->second.erase(actor_iter);
-            if (iter->second.empty()) {
-              node_to_actors_when_leasing_.erase(iter);
-            }
-            RAY_LOG(INFO) << "Finished leasing worker from " << node_id << " for actor "
-                          << actor->GetActorID()
-                          << ", job id = " << actor->GetActorID().JobId();
-            HandleWorkerLeasedReply(actor, reply);
-          } else {
-            RetryLeasingWorkerFromNode(actor, node);
-          }
+void GcsActorScheduler::LeaseWorkersFromNode(
+    const std::vector<std::shared_ptr<GcsActor>> &actors,
+    std::shared_ptr<rpc::GcsNodeInfo> node) {
+  auto node_id = NodeID::FromBinary(node->node_id());
+  // A single lease, or leases that must wait for ReleaseUnusedWorkers, go through the
+  // per-actor path.
+  if (actors.size() == 1 || nodes_of_releasing_unused_workers_.contains(node_id)) {
+    for (const auto &actor : actors) {
+      LeaseWorkerFromNode(actor, node);
+    }
+    return;
+  }
+  RAY_LOG(INFO) << "Start leasing " << actors.size() << " workers from node " << node_id;
+
+  rpc::Address remote_address;
+  remote_address.set_raylet_id(node->node_id());
+  remote_address.set_ip_address(node->node_manager_address());
+  remote_address.set_port(node->node_manager_port());
+  auto lease_client = GetOrConnectLeaseClient(remote_address);
+  std::vector<TaskSpecification> resource_specs;
+  resource_specs.reserve(actors.size());
+  for (const auto &actor : actors) {
+    resource_specs.emplace_back(actor->GetCreationTaskSpecification());
+  }
+  int backlog_size = report_worker_backlog_ ? 0 : -1;
+  lease_client->RequestWorkerLeases(
+      resource_specs,
+      [this, actors, node](const Status &status,
+                           const rpc::RequestWorkerLeasesReply &reply) {
+        // If the request failed, the leases are retried one actor at a time.
+        Status lease_status = status;
+        const int num_leases = static_cast<int>(actors.size());
+        if (lease_status.ok() && reply.replies_size() != num_leases) {
+          lease_status = Status::IOError("Wrong number of replies to the leases");
+        }
+        for (size_t i = 0; i < actors.size(); i++) {
+          OnWorkerLeaseReply(
+              actors[i], node, lease_status,
+              lease_status.ok() ? reply.replies(i) : rpc::RequestWorkerLeaseReply());
         }
       },
       backlog_size);
 }
 
+void GcsActorScheduler::OnWorkerLeaseReply(std::shared_ptr<GcsActor> actor,
+                                           std::shared_ptr<rpc::GcsNodeInfo> node,
+                                           const Status &status,
+                                           const rpc::RequestWorkerLeaseReply &reply) {
+  // If the actor is still in the leasing map and the status is ok, remove the actor
+  // from the leasing map and handle the reply. Otherwise, lease again, because it
+  // may be a network exception.
+  // If the actor is not in the leasing map, it means that the actor has been
+  // cancelled as the node is dead, just do nothing in this case because the
+  // gcs_actor_manager will reconstruct it again.
+  auto node_id = NodeID::FromBinary(node->node_id());
+  auto iter = node_to_actors_when_leasing_.find(node_id);
+  if (iter != node_to_actors_when_leasing_.end()) {
+    auto actor_iter = iter->second.find(actor->GetActorID());
+    if (actor_iter == iter->second.end()) {
+      // if actor is not in leasing state, it means it is cancelled.
+      RAY_LOG(INFO) << "Raylet granted a lease request, but the outstanding lease "
+                       "request for "
+                    << actor->GetActorID()
+                    << " has been already cancelled. The response will be ignored. "
+                       "Job id = "
+                    << actor->GetActorID().JobId();
+      return;
+    }
+
+    if (status.ok()) {
+      // Remove the actor from the leasing map as the reply is returned from the
+      // remote node.
+      iter->second.erase(actor_iter);
+      if (iter->second.empty()) {
+        node_to_actors_when_leasing_.erase(iter);
+      }
+      RAY_LOG(INFO) << "Finished leasing worker from " << node_id << " for actor "
+                    << actor->GetActorID()
+                    << ", job id = " << actor->GetActorID().JobId();
+      HandleWorkerLeasedReply(actor, reply);
+    } else {
+      RetryLeasingWorkerFromNode(actor, node);
+    }
+  }
+}
+
 void GcsActorScheduler::RetryLeasingWorkerFromNode(
     std::shared_ptr<GcsActor> actor, std::shared_ptr<rpc::GcsNodeInfo> node) {
   RAY_UNUSED(execute_after(
@@ -44,6 +44,16 @@ class GcsActorSchedulerInterface {
   /// \param actor to be scheduled.
   virtual void Schedule(std::shared_ptr<GcsActor> actor) = 0;
 
+  /// Schedule a batch of actors in one pass. By default, the actors are
+  /// scheduled one by one.
+  ///
+  /// \param actors The actors to be scheduled.
+  virtual void ScheduleBatch(const std::vector<std::shared_ptr<GcsActor>> &actors) {
+    for (const auto &actor : actors) {
+      Schedule(actor);
+    }
+  }
+
   /// Reschedule the specified actor after gcs server restarts.
   ///
   /// \param actor to be scheduled.
@@ -111,6 +121,14 @@ class GcsActorScheduler : public GcsActorSchedulerInterface {
   /// \param actor to be scheduled.
   void Schedule(std::shared_ptr<GcsActor> actor) override;
 
+  /// Schedule a batch of actors in one pass. The schedule strategy selects the
+  /// nodes of all the actors at once, and the lease requests are then sent to
+  /// each raylet back to back. Actors for which no node is available are
+  /// handed to the `schedule_failed_handler_`.
+  ///
+  /// \param actors The actors to be scheduled.
+  void ScheduleBatch(const std::vector<std::shared_ptr<GcsActor>> &actors) override;
+
   /// Reschedule the specified actor after gcs server restarts.
   ///
   /// \param actor to be scheduled.
@@ -197,6 +215,20 @@ class GcsActorScheduler : public GcsActorSchedulerInterface {
     ActorID assigned_actor_id_;
   };
 
+  /// Start leasing a worker for the actor from the node selected for it.
+  ///
+  /// \param actor The actor to be scheduled.
+  /// \param node The node selected for the actor, or nullptr if there is none.
+  void ScheduleOnNode(std::shared_ptr<GcsActor> actor,
+                      std::shared_ptr<rpc::GcsNodeInfo> node);
+
+  /// Tie the actor to the node and mark it as leasing from the node.
+  ///
+  /// \param actor The actor to be scheduled.
+  /// \param node The node selected for the actor.
+  void SetLeasingNode(const std::shared_ptr<GcsActor> &actor,
+                      const std::shared_ptr<rpc::GcsNodeInfo> &node);
+
   /// Lease a worker from the specified node for the specified actor.
   ///
   /// \param actor A description of the actor to create. This object has the resource
@@ -205,6 +237,24 @@ class GcsActorScheduler : public GcsActorSchedulerInterface {
   void LeaseWorkerFromNode(std::shared_ptr<GcsActor> actor,
                            std::shared_ptr<rpc::GcsNodeInfo> node);
 
+  /// Lease a worker from the specified node for each of the actors, with a single
+  /// request to the node.
+  ///
+  /// \param actors The actors to create, all tied to the node.
+  /// \param node The node that the workers will be leased from.
+  void LeaseWorkersFromNode(const std::vector<std::shared_ptr<GcsActor>> &actors,
+                            std::shared_ptr<rpc::GcsNodeInfo> node);
+
+  /// Handle the reply to a lease for the actor, unless the lease was cancelled.
+  ///
+  /// \param actor The actor that the worker is leased for.
+  /// \param node The node that the worker is leased from.
+  /// \param status The status of the lease request.
+  /// \param reply The reply of the raylet to the lease.
+  void OnWorkerLeaseReply(std::shared_ptr<GcsActor> actor,
+                          std::shared_ptr<rpc::GcsNodeInfo> node, const Status &status,
+                          const rpc::RequestWorkerLeaseReply &reply);
+
   /// Retry leasing a worker from the specified node for the specified actor.
   /// Make it a virtual method so that the io_context_ could be mocked out.
   ///
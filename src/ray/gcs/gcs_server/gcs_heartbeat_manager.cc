@@ -26,7 +26,9 @@ GcsHeartbeatManager::GcsHeartbeatManager(
     : io_service_(io_service),
       on_node_death_callback_(std::move(on_node_death_callback)),
       num_heartbeats_timeout_(RayConfig::instance().num_heartbeats_timeout()),
-      detect_timer_(io_service) {
+      detect_timer_(io_service),
+      timer_wheel_(num_heartbeats_timeout_ + 1) {
+  RAY_CHECK(num_heartbeats_timeout_ > 0);
   io_service_thread_.reset(new std::thread([this] {
     /// The asio work to keep io_service_ alive.
     boost::asio::io_service::work io_service_work_(io_service_);
@@ -37,7 +39,7 @@ GcsHeartbeatManager::GcsHeartbeatManager(
 void GcsHeartbeatManager::Initialize(const GcsInitData &gcs_init_data) {
   for (const auto &item : gcs_init_data.Nodes()) {
     if (item.second.state() == rpc::GcsNodeInfo::ALIVE) {
-      heartbeats_.emplace(item.first, num_heartbeats_timeout_);
+      RefreshNode(item.first);
     }
   }
 }
@@ -59,8 +61,32 @@ void GcsHeartbeatManager::Stop() {
 }
 
 void GcsHeartbeatManager::AddNode(const NodeID &node_id) {
-  io_service_.post(
-      [this, node_id] { heartbeats_.emplace(node_id, num_heartbeats_timeout_); });
+  io_service_.post([this, node_id] { RefreshNode(node_id); });
+}
+
+void GcsHeartbeatManager::ReportLiveness(const NodeID &node_id) {
+  io_service_.post([this, node_id] {
+    auto iter = heartbeats_.find(node_id);
+    // Ignore nodes that have not registered yet or have already been marked dead.
+    if (iter != heartbeats_.end()) {
+      iter->second = current_tick_;
+    }
+  });
+}
+
+void GcsHeartbeatManager::RefreshNode(const NodeID &node_id) {
+  auto result = heartbeats_.emplace(node_id, current_tick_);
+  if (result.second) {
+    ScheduleDeadline(node_id, current_tick_);
+  } else {
+    result.first->second = current_tick_;
+  }
+}
+
+void GcsHeartbeatManager::ScheduleDeadline(const NodeID &node_id,
+                                           uint64_t last_seen_tick) {
+  uint64_t deadline = last_seen_tick + num_heartbeats_timeout_;
+  timer_wheel_[deadline % timer_wheel_.size()].push_back(node_id);
 }
 
 void GcsHeartbeatManager::HandleReportHeartbeat(
@@ -75,7 +101,7 @@ void GcsHeartbeatManager::HandleReportHeartbeat(
     return;
   }
 
-  iter->second = num_heartbeats_timeout_;
+  iter->second = current_tick_;
   GCS_RPC_SEND_REPLY(send_reply_callback, reply, Status::OK());
 }
 
@@ -86,16 +112,24 @@ void GcsHeartbeatManager::Tick() {
 }
 
 void GcsHeartbeatManager::DetectDeadNodes() {
-  for (auto it = heartbeats_.begin(); it != heartbeats_.end();) {
-    auto current = it++;
-    current->second = current->second - 1;
-    if (current->second == 0) {
-      auto node_id = current->first;
-      RAY_LOG(WARNING) << "Node timed out: " << node_id;
-      heartbeats_.erase(current);
-      if (on_node_death_callback_) {
-        on_node_death_callback_(node_id);
-      }
+  current_tick_++;
+  std::vector<NodeID> expiring;
+  expiring.swap(timer_wheel_[current_tick_ % timer_wheel_.size()]);
+  for (const auto &node_id : expiring) {
+    auto iter = heartbeats_.find(node_id);
+    if (iter == heartbeats_.end()) {
+      continue;
+    }
+    uint64_t last_seen_tick = iter->second;
+    if (last_seen_tick + num_heartbeats_timeout_ > current_tick_) {
+      // We heard from the node since its deadline was scheduled.
+      ScheduleDeadline(node_id, last_seen_tick);
+      continue;
+    }
+    RAY_LOG(WARNING) << "Node timed out: " << node_id;
+    heartbeats_.erase(iter);
+    if (on_node_death_callback_) {
+      on_node_death_callback_(node_id);
     }
   }
 }
@@ -15,6 +15,8 @@
 
 #pragma once
 
+#include <vector>
+
 #include "absl/container/flat_hash_map.h"
 #include "ray/common/id.h"
 #include "ray/gcs/accessor.h"
@@ -61,6 +63,14 @@ class GcsHeartbeatManager : public rpc::HeartbeatInfoHandler {
   /// \param node_id ID of the node to be registered.
   void AddNode(const NodeID &node_id);
 
+  /// Record that a node is alive without a heartbeat RPC, e.g., because it
+  /// reported its resource usage. This is thread-safe. Reports from nodes that
+  /// are not registered or were marked dead are ignored. Such nodes find out
+  /// from the reply to their next heartbeat.
+  ///
+  /// \param node_id ID of the node that is alive.
+  void ReportLiveness(const NodeID &node_id);
+
  protected:
   /// A periodic timer that fires on every heartbeat period. Raylets that have
   /// not sent a heartbeat within the last num_heartbeats_timeout ticks will be
@@ -68,9 +78,18 @@ class GcsHeartbeatManager : public rpc::HeartbeatInfoHandler {
   void Tick();
 
   /// Check that if any raylet is inactive due to no heartbeat for a period of time.
-  /// If found any, mark it as dead.
+  /// If found any, mark it as dead. Only the nodes whose deadline falls on the
+  /// current tick are visited, so the cost per tick does not grow with the
+  /// total number of nodes.
   void DetectDeadNodes();
 
+  /// Mark a node as alive at the current tick.
+  void RefreshNode(const NodeID &node_id);
+
+  /// Put a node into the timer wheel slot of the tick at which it will time
+  /// out if no further heartbeat arrives.
+  void ScheduleDeadline(const NodeID &node_id, uint64_t last_seen_tick);
+
   /// Schedule another tick after a short time.
   void ScheduleTick();
 
@@ -84,9 +103,17 @@ class GcsHeartbeatManager : public rpc::HeartbeatInfoHandler {
   int64_t num_heartbeats_timeout_;
   /// A timer that ticks every heartbeat_timeout_ms_ milliseconds.
   boost::asio::deadline_timer detect_timer_;
-  /// For each Raylet that we receive a heartbeat from, the number of ticks
-  /// that may pass before the Raylet will be declared dead.
-  absl::flat_hash_map<NodeID, int64_t> heartbeats_;
+  /// The number of ticks processed so far.
+  uint64_t current_tick_ = 0;
+  /// For each Raylet that we receive a heartbeat from, the last tick at which
+  /// it was known to be alive. Heartbeats only update this value, so handling
+  /// one is O(1) and never touches the timer wheel.
+  absl::flat_hash_map<NodeID, uint64_t> heartbeats_;
+  /// A timer wheel with one slot per tick in the timeout window. Each node is
+  /// in exactly one slot: the one of the tick at which its deadline was last
+  /// computed. When that slot is reached, the node either has timed out or is
+  /// moved to the slot of its refreshed deadline.
+  std::vector<std::vector<NodeID>> timer_wheel_;
   /// Is the detect started.
   bool is_started_ = false;
 };
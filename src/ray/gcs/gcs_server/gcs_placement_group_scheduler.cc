@@ -161,17 +161,28 @@ void GcsPlacementGroupScheduler::ScheduleUnplacedBundles(
                 .second);
 
   /// TODO(AlisaWu): Change the strategy when reserve resource failed.
+  // All the bundles placed on the same node are prepared with one request.
+  absl::flat_hash_map<NodeID, std::vector<std::shared_ptr<BundleSpecification>>>
+      node_to_bundles;
   for (const auto &bundle : bundles) {
     const auto &bundle_id = bundle->BundleId();
     const auto &node_id = selected_nodes[bundle_id];
     lease_status_tracker->MarkPreparePhaseStarted(node_id, bundle);
+    node_to_bundles[node_id].push_back(bundle);
+  }
+
+  for (const auto &entry : node_to_bundles) {
+    const auto &node_id = entry.first;
+    const auto &node_bundles = entry.second;
     // TODO(sang): The callback might not be called at all if nodes are dead. We should
     // handle this case properly.
-    PrepareResources(bundle, gcs_node_manager_.GetAliveNode(node_id),
-                     [this, bundle, node_id, lease_status_tracker, failure_callback,
-                      success_callback](const Status &status) {
-                       lease_status_tracker->MarkPrepareRequestReturned(node_id, bundle,
-                                                                        status);
+    PrepareResources(node_bundles, gcs_node_manager_.GetAliveNode(node_id),
+                     [this, node_bundles, node_id, lease_status_tracker,
+                      failure_callback, success_callback](const Status &status) {
+                       for (const auto &bundle : node_bundles) {
+                         lease_status_tracker->MarkPrepareRequestReturned(node_id, bundle,
+                                                                          status);
+                       }
                        if (lease_status_tracker->AllPrepareRequestsReturned()) {
                          OnAllBundlePrepareRequestReturned(
                              lease_status_tracker, failure_callback, success_callback);
@@ -204,7 +215,7 @@ void GcsPlacementGroupScheduler::MarkScheduleCancelled(
 }
 
 void GcsPlacementGroupScheduler::PrepareResources(
-    const std::shared_ptr<BundleSpecification> &bundle,
+    const std::vector<std::shared_ptr<BundleSpecification>> &bundles,
     const absl::optional<std::shared_ptr<ray::rpc::GcsNodeInfo>> &node,
     const StatusCallback &callback) {
   if (!node.has_value()) {
@@ -214,43 +225,45 @@ void GcsPlacementGroupScheduler::PrepareResources(
 
   const auto lease_client = GetLeaseClientFromNode(node.value());
   const auto node_id = NodeID::FromBinary(node.value()->node_id());
-  RAY_LOG(DEBUG) << "Preparing resource from node " << node_id
-                 << " for a bundle: " << bundle->DebugString();
+  RAY_LOG(DEBUG) << "Preparing resource from node " << node_id << " for "
+                 << bundles.size() << " bundles of placement group "
+                 << bundles.front()->PlacementGroupId();
   lease_client->PrepareBundleResources(
-      *bundle, [node_id, bundle, callback](
-                   const Status &status, const rpc::PrepareBundleResourcesReply &reply) {
+      bundles, [node_id, bundles, callback](const Status &status,
+                                            const rpc::PrepareBundleResourcesReply &reply) {
         auto result = reply.success() ? Status::OK()
                                       : Status::IOError("Failed to reserve resource");
         if (result.ok()) {
-          RAY_LOG(DEBUG) << "Finished leasing resource from " << node_id
-                         << " for bundle: " << bundle->DebugString();
+          RAY_LOG(DEBUG) << "Finished leasing resource from " << node_id << " for "
+                         << bundles.size() << " bundles.";
         } else {
-          RAY_LOG(DEBUG) << "Failed to lease resource from " << node_id
-                         << " for bundle: " << bundle->DebugString();
+          RAY_LOG(DEBUG) << "Failed to lease resource from " << node_id << " for "
+                         << bundles.size() << " bundles.";
         }
         callback(result);
       });
 }
 
 void GcsPlacementGroupScheduler::CommitResources(
-    const std::shared_ptr<BundleSpecification> &bundle,
+    const std::vector<std::shared_ptr<BundleSpecification>> &bundles,
     const absl::optional<std::shared_ptr<ray::rpc::GcsNodeInfo>> &node,
     const StatusCallback callback) {
   RAY_CHECK(node.has_value());
   const auto lease_client = GetLeaseClientFromNode(node.value());
   const auto node_id = NodeID::FromBinary(node.value()->node_id());
 
-  RAY_LOG(DEBUG) << "Committing resource to a node " << node_id
-                 << " for a bundle: " << bundle->DebugString();
+  RAY_LOG(DEBUG) << "Committing resource to a node " << node_id << " for "
+                 << bundles.size() << " bundles of placement group "
+                 << bundles.front()->PlacementGroupId();
   lease_client->CommitBundleResources(
-      *bundle, [bundle, node_id, callback](const Status &status,
-                                           const rpc::CommitBundleResourcesReply &reply) {
+      bundles, [bundles, node_id, callback](const Status &status,
+                                            const rpc::CommitBundleResourcesReply &reply) {
         if (status.ok()) {
-          RAY_LOG(DEBUG) << "Finished committing resource to " << node_id
-                         << " for bundle: " << bundle->DebugString();
+          RAY_LOG(DEBUG) << "Finished committing resource to " << node_id << " for "
+                         << bundles.size() << " bundles.";
         } else {
-          RAY_LOG(DEBUG) << "Failed to commit resource to " << node_id
-                         << " for bundle: " << bundle->DebugString();
+          RAY_LOG(DEBUG) << "Failed to commit resource to " << node_id << " for "
+                         << bundles.size() << " bundles.";
         }
         RAY_CHECK(callback);
         callback(status);
@@ -303,15 +316,25 @@ void GcsPlacementGroupScheduler::CommitAllBundles(
   const std::shared_ptr<BundleLocations> &prepared_bundle_locations =
       lease_status_tracker->GetPreparedBundleLocations();
   lease_status_tracker->MarkCommitPhaseStarted();
+  // All the bundles prepared on the same node are committed with one request.
+  absl::flat_hash_map<NodeID, std::vector<std::shared_ptr<BundleSpecification>>>
+      node_to_bundles;
   for (const auto &bundle_to_commit : *prepared_bundle_locations) {
-    const auto &node_id = bundle_to_commit.second.first;
+    node_to_bundles[bundle_to_commit.second.first].push_back(
+        bundle_to_commit.second.second);
+  }
+
+  for (const auto &entry : node_to_bundles) {
+    const auto &node_id = entry.first;
     const auto &node = gcs_node_manager_.GetAliveNode(node_id);
-    const auto &bundle = bundle_to_commit.second.second;
+    const auto &node_bundles = entry.second;
 
-    auto commit_resources_callback = [this, lease_status_tracker, bundle, node_id,
+    auto commit_resources_callback = [this, lease_status_tracker, node_bundles, node_id,
                                       schedule_failure_handler,
                                       schedule_success_handler](const Status &status) {
-      lease_status_tracker->MarkCommitRequestReturned(node_id, bundle, status);
+      for (const auto &bundle : node_bundles) {
+        lease_status_tracker->MarkCommitRequestReturned(node_id, bundle, status);
+      }
       if (lease_status_tracker->AllCommitRequestReturned()) {
         OnAllBundleCommitRequestReturned(lease_status_tracker, schedule_failure_handler,
                                          schedule_success_handler);
@@ -319,7 +342,7 @@ void GcsPlacementGroupScheduler::CommitAllBundles(
     };
 
     if (node.has_value()) {
-      CommitResources(bundle, node, commit_resources_callback);
+      CommitResources(node_bundles, node, commit_resources_callback);
     } else {
       RAY_LOG(INFO) << "Failed to commit resources because the node is dead, node id = "
                     << node_id;
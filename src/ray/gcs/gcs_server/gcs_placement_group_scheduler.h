@@ -442,24 +442,25 @@ class GcsPlacementGroupScheduler : public GcsPlacementGroupSchedulerInterface {
                                 &node_to_bundles) override;
 
  protected:
-  /// Send a bundle PREPARE request to a node. The PREPARE request will lock resources
-  /// on a node until COMMIT or CANCEL requests are sent to a node.
+  /// Send a PREPARE request for bundles to a node. The PREPARE request will lock
+  /// resources on a node until COMMIT or CANCEL requests are sent to a node. The
+  /// bundles are prepared atomically by the node.
   ///
-  /// \param bundle A bundle to schedule on a node.
-  /// \param node A node to prepare resources for a given bundle.
+  /// \param bundles The bundles to schedule on a node.
+  /// \param node A node to prepare resources for the given bundles.
   /// \param callback
   void PrepareResources(
-      const std::shared_ptr<BundleSpecification> &bundle,
+      const std::vector<std::shared_ptr<BundleSpecification>> &bundles,
       const absl::optional<std::shared_ptr<ray::rpc::GcsNodeInfo>> &node,
       const StatusCallback &callback);
 
-  /// Send a bundle COMMIT request to a node. This means the placement group creation
-  /// is ready and GCS will commit resources on a given node.
+  /// Send a COMMIT request for bundles to a node. This means the placement group
+  /// creation is ready and GCS will commit resources on a given node.
   ///
-  /// \param bundle A bundle to schedule on a node.
-  /// \param node A node to commit resources for a given bundle.
+  /// \param bundles The bundles to schedule on a node.
+  /// \param node A node to commit resources for the given bundles.
   /// \param callback
-  void CommitResources(const std::shared_ptr<BundleSpecification> &bundle,
+  void CommitResources(const std::vector<std::shared_ptr<BundleSpecification>> &bundles,
                        const absl::optional<std::shared_ptr<ray::rpc::GcsNodeInfo>> &node,
                        const StatusCallback callback);
 
@@ -183,6 +183,10 @@ void GcsResourceManager::HandleReportResourceUsage(
     resources_buffer_[node_id] = *resources_data;
   }
 
+  for (auto &listener : resource_report_listeners_) {
+    listener(node_id);
+  }
+
   GCS_RPC_SEND_REPLY(send_reply_callback, reply, Status::OK());
   ++counts_[CountType::REPORT_RESOURCE_USAGE_REQUEST];
 }
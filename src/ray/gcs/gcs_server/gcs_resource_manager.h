@@ -144,6 +144,14 @@ class GcsResourceManager : public rpc::NodeResourceInfoHandler {
   void UpdatePlacementGroupLoad(
       const std::shared_ptr<rpc::PlacementGroupLoad> placement_group_load);
 
+  /// Add listener to monitor the resource usage reports of nodes.
+  ///
+  /// \param listener The handler which is called with the ID of the reporting node.
+  void AddResourceReportListener(std::function<void(const NodeID &)> listener) {
+    RAY_CHECK(listener);
+    resource_report_listeners_.emplace_back(std::move(listener));
+  }
+
  private:
   /// Delete the scheduling resources of the specified node.
   ///
@@ -170,6 +178,8 @@ class GcsResourceManager : public rpc::NodeResourceInfoHandler {
   absl::flat_hash_map<NodeID, SchedulingResources> cluster_scheduling_resources_;
   /// Placement group load information that is used for autoscaler.
   absl::optional<std::shared_ptr<rpc::PlacementGroupLoad>> placement_group_load_;
+  /// Listeners which monitor the resource usage reports of nodes.
+  std::vector<std::function<void(const NodeID &)>> resource_report_listeners_;
 
   /// Debug info.
   enum CountType {
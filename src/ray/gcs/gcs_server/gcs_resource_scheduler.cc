@@ -14,6 +14,8 @@
 
 #include "ray/gcs/gcs_server/gcs_resource_scheduler.h"
 
+#include "ray/common/ray_config.h"
+
 namespace ray {
 namespace gcs {
 
@@ -68,6 +70,10 @@ std::vector<NodeID> GcsResourceScheduler::Schedule(
     return {};
   }
 
+  if (RayConfig::instance().gcs_placement_group_bin_packing_solver_enabled()) {
+    return SolverSchedule(required_resources_list, scheduling_type, candidate_nodes);
+  }
+
   // First schedule scarce resources (such as GPU) and large capacity resources to improve
   // the scheduling success rate.
   const auto &to_schedule_resources = SortRequiredResources(required_resources_list);
@@ -115,6 +121,47 @@ const std::vector<ResourceSet> &GcsResourceScheduler::SortRequiredResources(
   return required_resources;
 }
 
+std::vector<NodeID> GcsResourceScheduler::SolverSchedule(
+    const std::vector<ResourceSet> &required_resources_list,
+    const SchedulingType &scheduling_type,
+    const absl::flat_hash_set<NodeID> &candidate_nodes) {
+  const auto &cluster_resources = gcs_resource_manager_.GetClusterResources();
+  std::vector<std::pair<NodeID, BundleBinPacker::ResourceMap>> nodes;
+  nodes.reserve(candidate_nodes.size());
+  for (const auto &node_id : candidate_nodes) {
+    const auto &iter = cluster_resources.find(node_id);
+    RAY_CHECK(iter != cluster_resources.end());
+    nodes.emplace_back(node_id, iter->second.GetAvailableResources().GetResourceMap());
+  }
+
+  std::vector<BundleBinPacker::ResourceMap> bundles;
+  bundles.reserve(required_resources_list.size());
+  for (const auto &required_resources : required_resources_list) {
+    bundles.push_back(required_resources.GetResourceMap());
+  }
+
+  BundleBinPacker packer(nodes);
+  std::vector<NodeID> result;
+  switch (scheduling_type) {
+  case SPREAD:
+    result = packer.Spread(bundles);
+    break;
+  case STRICT_SPREAD:
+    result = packer.StrictSpread(bundles);
+    break;
+  case PACK:
+    result = packer.Pack(bundles);
+    break;
+  case STRICT_PACK:
+    result = packer.StrictPack(bundles);
+    break;
+  default:
+    RAY_LOG(FATAL) << "Unsupported scheduling type: " << scheduling_type;
+    break;
+  }
+  return result;
+}
+
 std::vector<NodeID> GcsResourceScheduler::StrictSpreadSchedule(
     const std::vector<ResourceSet> &required_resources_list,
     const absl::flat_hash_set<NodeID> &candidate_nodes) {
@@ -16,6 +16,7 @@
 
 #include "absl/container/flat_hash_set.h"
 #include "ray/common/task/scheduling_resources.h"
+#include "ray/gcs/gcs_server/bundle_bin_packer.h"
 #include "ray/gcs/gcs_server/gcs_resource_manager.h"
 
 namespace ray {
@@ -115,6 +116,19 @@ class GcsResourceScheduler {
   const std::vector<ResourceSet> &SortRequiredResources(
       const std::vector<ResourceSet> &required_resources);
 
+  /// Schedule resources with the bin packing solver, which places all the required
+  /// resources at once over a snapshot of the candidate nodes.
+  ///
+  /// \param required_resources_list The resources to be scheduled.
+  /// \param scheduling_type This scheduling strategy.
+  /// \param candidate_nodes The nodes can be used for scheduling.
+  /// \return Scheduling selected nodes, it corresponds to `required_resources_list` one
+  /// by one. If the scheduling fails, an empty vector is returned.
+  std::vector<NodeID> SolverSchedule(
+      const std::vector<ResourceSet> &required_resources_list,
+      const SchedulingType &scheduling_type,
+      const absl::flat_hash_set<NodeID> &candidate_nodes);
+
   /// Schedule resources according to `STRICT_SPREAD` strategy.
   ///
   /// \param required_resources_list The resources to be scheduled.
@@ -25,6 +25,7 @@
 #include "ray/gcs/gcs_server/stats_handler_impl.h"
 #include "ray/gcs/gcs_server/task_info_handler_impl.h"
 #include "ray/util/asio_util.h"
+#include "ray/util/util.h"
 
 namespace ray {
 namespace gcs {
@@ -60,9 +61,30 @@ void GcsServer::Start() {
   // Init gcs table storage.
   gcs_table_storage_ = std::make_shared<gcs::RedisGcsTableStorage>(redis_client_);
 
-  // Load gcs tables data asynchronously.
-  auto gcs_init_data = std::make_shared<GcsInitData>(gcs_table_storage_);
-  gcs_init_data->AsyncLoad([this, gcs_init_data] { DoStart(*gcs_init_data); });
+  // Load gcs tables data asynchronously. A server taking over from a primary
+  // it was a standby of loads the tables from its in-memory replica instead of
+  // reading them back from redis.
+  auto init_data_storage = warm_start_storage_ ? warm_start_storage_ : gcs_table_storage_;
+  auto gcs_init_data = std::make_shared<GcsInitData>(init_data_storage);
+  auto load_start_ms = current_time_ms();
+  gcs_init_data->AsyncLoad([this, gcs_init_data, load_start_ms] {
+    RAY_LOG(INFO) << "Finished loading gcs tables data from "
+                  << (warm_start_storage_ ? "the standby replica" : "redis") << " in "
+                  << current_time_ms() - load_start_ms << "ms.";
+    warm_start_storage_.reset();
+    DoStart(*gcs_init_data);
+  });
+}
+
+void GcsServer::SetWarmStartStorage(std::shared_ptr<GcsTableStorage> storage) {
+  RAY_CHECK(!gcs_table_storage_) << "The warm start storage must be set before Start.";
+  warm_start_storage_ = std::move(storage);
+}
+
+void GcsServer::AddStandby(const std::shared_ptr<GcsTableStorage> &standby,
+                           const StatusCallback &callback) {
+  RAY_CHECK(gcs_table_storage_) << "Standbys can only be added after Start.";
+  gcs_table_storage_->AddStandby(standby, callback);
 }
 
 void GcsServer::DoStart(const GcsInitData &gcs_init_data) {
@@ -114,6 +136,12 @@ void GcsServer::DoStart(const GcsInitData &gcs_init_data) {
   // detector is already run.
   gcs_heartbeat_manager_->Start();
 
+  // Stream all writes to the standby gcs server, if any.
+  if (!config_.standby_address.empty()) {
+    AttachStandby();
+    HeartbeatStandby();
+  }
+
   // Print debug info periodically.
   PrintDebugInfo();
 
@@ -189,9 +217,10 @@ void GcsServer::InitGcsJobManager() {
 }
 
 void GcsServer::InitGcsActorManager(const GcsInitData &gcs_init_data) {
-  RAY_CHECK(gcs_table_storage_ && gcs_pub_sub_ && gcs_node_manager_);
-  auto actor_schedule_strategy =
-      std::make_shared<GcsRandomActorScheduleStrategy>(gcs_node_manager_);
+  RAY_CHECK(gcs_table_storage_ && gcs_pub_sub_ && gcs_node_manager_ &&
+            gcs_resource_manager_);
+  auto actor_schedule_strategy = std::make_shared<GcsRandomActorScheduleStrategy>(
+      gcs_node_manager_, gcs_resource_manager_);
   auto scheduler = std::make_shared<GcsActorScheduler>(
       main_service_, gcs_table_storage_->ActorTable(), *gcs_node_manager_, gcs_pub_sub_,
       /*schedule_failure_handler=*/
@@ -319,6 +348,14 @@ void GcsServer::InstallEventListeners() {
         raylet_client_pool_->Disconnect(NodeID::FromBinary(node->node_id()));
       });
 
+  // Install resource report listener. A resource report proves that the node is
+  // alive, so the raylet does not need to send a separate heartbeat for it.
+  if (RayConfig::instance().raylet_liveness_from_resource_reports()) {
+    gcs_resource_manager_->AddResourceReportListener([this](const NodeID &node_id) {
+      gcs_heartbeat_manager_->ReportLiveness(node_id);
+    });
+  }
+
   // Install worker event listener.
   gcs_worker_manager_->AddWorkerDeadListener(
       [this](std::shared_ptr<rpc::WorkerTableData> worker_failure_data) {
@@ -344,6 +381,39 @@ void GcsServer::CollectStats() {
       (RayConfig::instance().metrics_report_interval_ms() / 2) /* milliseconds */);
 }
 
+void GcsServer::AttachStandby() {
+  if (standby_storage_) {
+    gcs_table_storage_->RemoveStandby(standby_storage_);
+  }
+  RAY_LOG(INFO) << "Attaching to the standby gcs server at " << config_.standby_address
+                << ":" << config_.standby_port;
+  standby_store_client_ = std::make_shared<StandbyStoreClient>(
+      config_.standby_address, config_.standby_port, client_call_manager_);
+  standby_storage_ = std::make_shared<StandbyGcsTableStorage>(standby_store_client_);
+  auto standby_store_client = standby_store_client_;
+  AddStandby(standby_storage_, [standby_store_client](const Status &status) {
+    // If seeding failed, the client is disconnected and the next heartbeat
+    // attaches again.
+    if (status.ok()) {
+      RAY_LOG(INFO) << "The standby gcs server holds a snapshot of the tables.";
+      standby_store_client->MarkSeeded();
+    }
+  });
+}
+
+void GcsServer::HeartbeatStandby() {
+  if (is_stopped_) {
+    return;
+  }
+  if (standby_store_client_->IsDisconnected()) {
+    AttachStandby();
+  } else {
+    standby_store_client_->Heartbeat();
+  }
+  execute_after(main_service_, [this] { HeartbeatStandby(); },
+                RayConfig::instance().gcs_standby_heartbeat_interval_milliseconds());
+}
+
 void GcsServer::PrintDebugInfo() {
   std::ostringstream stream;
   stream << gcs_node_manager_->DebugString() << "\n"
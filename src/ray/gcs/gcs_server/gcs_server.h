@@ -40,6 +40,9 @@ struct GcsServerConfig {
   bool retry_redis = true;
   bool is_test = false;
   std::string node_ip_address;
+  /// The address of a standby gcs server to stream all writes to, if any.
+  std::string standby_address;
+  uint16_t standby_port = 0;
 };
 
 class GcsNodeManager;
@@ -66,6 +69,25 @@ class GcsServer {
   /// Stop gcs server.
   void Stop();
 
+  /// Load the initial gcs tables data from the given storage instead of redis.
+  /// The storage must be a replica of the data in redis, e.g., the replica of a
+  /// `GcsStandbyServer` that takes over. Writes still go to redis. Must be called
+  /// before `Start`.
+  ///
+  /// \param storage The standby replica to load the initial data from.
+  void SetWarmStartStorage(std::shared_ptr<GcsTableStorage> storage);
+
+  /// Replicate the tables of this server to the given storage, so that another
+  /// server can start from it with `SetWarmStartStorage`. The standby is seeded
+  /// with a snapshot of the tables and then receives every write. Must be called
+  /// after `Start`. A standby in another process is attached through
+  /// `GcsServerConfig::standby_address` instead.
+  ///
+  /// \param standby The storage that holds the standby replica.
+  /// \param callback Called once the standby holds the snapshot.
+  void AddStandby(const std::shared_ptr<GcsTableStorage> &standby,
+                  const StatusCallback &callback);
+
   /// Get the port of this gcs server.
   int GetPort() const { return rpc_server_.GetPort(); }
 
@@ -128,6 +150,14 @@ class GcsServer {
   /// Print debug info periodically.
   void PrintDebugInfo();
 
+  /// Attach to the standby gcs server in `config_`, replacing the previous
+  /// attachment, if any. The standby is seeded with a new snapshot.
+  void AttachStandby();
+
+  /// Tell the standby that this server is alive, and attach to it again if the
+  /// attachment failed. Runs every gcs_standby_heartbeat_interval_milliseconds.
+  void HeartbeatStandby();
+
   /// Gcs server configuration.
   GcsServerConfig config_;
   /// The main io service to drive event posted from grpc threads.
@@ -187,6 +217,12 @@ class GcsServer {
   std::shared_ptr<gcs::GcsPubSub> gcs_pub_sub_;
   /// The gcs table storage.
   std::shared_ptr<gcs::GcsTableStorage> gcs_table_storage_;
+  /// The standby replica to load the initial data from, if any.
+  std::shared_ptr<gcs::GcsTableStorage> warm_start_storage_;
+  /// The client that streams writes to the standby gcs server in another
+  /// process, and the storage that wraps it, if a standby is configured.
+  std::shared_ptr<gcs::StandbyStoreClient> standby_store_client_;
+  std::shared_ptr<gcs::GcsTableStorage> standby_storage_;
   /// Gcs service state flag, which is used for ut.
   bool is_started_ = false;
   bool is_stopped_ = false;
@@ -17,6 +17,7 @@
 #include "gflags/gflags.h"
 #include "ray/common/ray_config.h"
 #include "ray/gcs/gcs_server/gcs_server.h"
+#include "ray/gcs/gcs_server/gcs_standby_server.h"
 #include "ray/stats/stats.h"
 #include "ray/util/util.h"
 
@@ -28,6 +29,12 @@ DEFINE_string(config_list, "", "The config list of raylet.");
 DEFINE_string(redis_password, "", "The password of redis.");
 DEFINE_bool(retry_redis, false, "Whether we retry to connect to the redis.");
 DEFINE_string(node_ip_address, "", "The ip address of the node.");
+DEFINE_string(standby_address, "",
+              "The ip:port of a standby gcs server to stream all writes to.");
+DEFINE_int32(standby_port, -1,
+             "If set, run as a standby gcs server that receives the writes of a "
+             "primary on this port, and takes over on gcs_server_port once the "
+             "primary stops streaming.");
 
 int main(int argc, char *argv[]) {
   InitShutdownRAII ray_log_shutdown_raii(ray::RayLog::StartRayLog,
@@ -44,6 +51,8 @@ int main(int argc, char *argv[]) {
   const std::string redis_password = FLAGS_redis_password;
   const bool retry_redis = FLAGS_retry_redis;
   const std::string node_ip_address = FLAGS_node_ip_address;
+  const std::string standby_address = FLAGS_standby_address;
+  const int standby_port = static_cast<int>(FLAGS_standby_port);
   gflags::ShutDownCommandLineFlags();
 
   std::unordered_map<std::string, std::string> config_map;
@@ -81,15 +90,33 @@ int main(int argc, char *argv[]) {
   gcs_server_config.redis_password = redis_password;
   gcs_server_config.retry_redis = retry_redis;
   gcs_server_config.node_ip_address = node_ip_address;
-  ray::gcs::GcsServer gcs_server(gcs_server_config, main_service);
+  if (!standby_address.empty()) {
+    auto pos = standby_address.rfind(':');
+    RAY_CHECK(pos != std::string::npos)
+        << "Invalid standby address " << standby_address << ", expected ip:port.";
+    gcs_server_config.standby_address = standby_address.substr(0, pos);
+    gcs_server_config.standby_port = std::stoi(standby_address.substr(pos + 1));
+  }
+  std::unique_ptr<ray::gcs::GcsServer> gcs_server;
+  std::unique_ptr<ray::gcs::GcsStandbyServer> gcs_standby_server;
+  if (standby_port >= 0) {
+    gcs_standby_server.reset(
+        new ray::gcs::GcsStandbyServer(gcs_server_config, standby_port, main_service));
+  } else {
+    gcs_server.reset(new ray::gcs::GcsServer(gcs_server_config, main_service));
+  }
 
   // Destroy the GCS server on a SIGTERM. The pointer to main_service is
   // guaranteed to be valid since this function will run the event loop
   // instead of returning immediately.
-  auto handler = [&main_service, &gcs_server](const boost::system::error_code &error,
-                                              int signal_number) {
+  auto handler = [&main_service, &gcs_server, &gcs_standby_server](
+                     const boost::system::error_code &error, int signal_number) {
     RAY_LOG(INFO) << "GCS server received SIGTERM, shutting down...";
-    gcs_server.Stop();
+    if (gcs_standby_server) {
+      gcs_standby_server->Stop();
+    } else {
+      gcs_server->Stop();
+    }
     ray::stats::Shutdown();
     main_service.stop();
   };
@@ -101,7 +128,11 @@ int main(int argc, char *argv[]) {
 #endif
   signals.async_wait(handler);
 
-  gcs_server.Start();
+  if (gcs_standby_server) {
+    gcs_standby_server->Start();
+  } else {
+    gcs_server->Start();
+  }
 
   main_service.run();
 }
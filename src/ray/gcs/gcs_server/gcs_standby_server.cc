@@ -0,0 +1,158 @@
+// Copyright 2017 The Ray Authors.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//  http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "ray/gcs/gcs_server/gcs_standby_server.h"
+
+#include "ray/common/ray_config.h"
+#include "ray/util/util.h"
+
+namespace ray {
+namespace gcs {
+
+GcsStandbyServer::GcsStandbyServer(const GcsServerConfig &config,
+                                   uint16_t standby_port,
+                                   boost::asio::io_service &main_service)
+    : config_(config),
+      main_service_(main_service),
+      rpc_server_("GcsStandbyServer", standby_port),
+      standby_service_(main_service, *this),
+      replica_store_client_(std::make_shared<InMemoryStoreClient>(main_service)),
+      replica_(std::make_shared<InMemoryGcsTableStorage>(replica_store_client_)),
+      check_primary_timer_(main_service) {}
+
+GcsStandbyServer::~GcsStandbyServer() { Stop(); }
+
+void GcsStandbyServer::Start() {
+  rpc_server_.RegisterService(standby_service_);
+  rpc_server_.Run();
+  RAY_LOG(INFO) << "Standby gcs server is waiting for the writes of the primary on port "
+                << GetPort() << ".";
+  CheckPrimary();
+}
+
+void GcsStandbyServer::Stop() {
+  if (!is_stopped_) {
+    rpc_server_.Shutdown();
+    check_primary_timer_.cancel();
+    if (gcs_server_) {
+      gcs_server_->Stop();
+    }
+    is_stopped_ = true;
+  }
+}
+
+void GcsStandbyServer::TakeOver() {
+  RAY_CHECK(!gcs_server_) << "The standby has already taken over.";
+  RAY_LOG(INFO) << "Standby gcs server is taking over, "
+                << current_time_ms() - last_primary_contact_ms_
+                << "ms after it last heard from the primary.";
+  rpc_server_.Shutdown();
+  check_primary_timer_.cancel();
+  gcs_server_.reset(new GcsServer(config_, main_service_));
+  gcs_server_->SetWarmStartStorage(replica_);
+  gcs_server_->Start();
+  replica_.reset();
+  replica_store_client_.reset();
+}
+
+void GcsStandbyServer::HandleReplicateWrites(
+    const rpc::ReplicateWritesRequest &request, rpc::ReplicateWritesReply *reply,
+    rpc::SendReplyCallback send_reply_callback) {
+  if (gcs_server_) {
+    // A primary that was only cut off may still be streaming.
+    GCS_RPC_SEND_REPLY(send_reply_callback, reply,
+                       Status::Invalid("The standby has already taken over."));
+    return;
+  }
+  last_primary_contact_ms_ = current_time_ms();
+  if (request.primary_id() != primary_id_) {
+    // A primary that attaches again sends a new snapshot, so start from an
+    // empty replica.
+    RAY_LOG(INFO) << "A primary gcs server attached to the standby.";
+    primary_id_ = request.primary_id();
+    seeded_ = false;
+    replica_store_client_ = std::make_shared<InMemoryStoreClient>(main_service_);
+    replica_ = std::make_shared<InMemoryGcsTableStorage>(replica_store_client_);
+  }
+  Status status;
+  for (const auto &write : request.writes()) {
+    status = Apply(write);
+    if (!status.ok()) {
+      break;
+    }
+  }
+  if (status.ok() && request.seeded() && !seeded_) {
+    RAY_LOG(INFO) << "Standby gcs server holds a snapshot of the primary.";
+    seeded_ = true;
+  }
+  GCS_RPC_SEND_REPLY(send_reply_callback, reply, status);
+}
+
+/// The replica acknowledges writes through their callbacks, which we ignore
+/// since the in-memory store applies them before returning.
+static void IgnoreReplicaStatus(const Status &status) {}
+
+Status GcsStandbyServer::Apply(const rpc::StoreWrite &write) {
+  const auto &table_name = write.table_name();
+  switch (write.type()) {
+  case rpc::StoreWrite::PUT:
+    RAY_CHECK(write.keys_size() == 1);
+    if (write.index_keys_size() > 0) {
+      return replica_store_client_->AsyncPutWithIndex(table_name, write.keys(0),
+                                                      write.index_keys(0), write.data(),
+                                                      IgnoreReplicaStatus);
+    }
+    return replica_store_client_->AsyncPut(table_name, write.keys(0), write.data(),
+                                           IgnoreReplicaStatus);
+  case rpc::StoreWrite::DELETE: {
+    std::vector<std::string> keys(write.keys().begin(), write.keys().end());
+    if (write.index_keys_size() > 0) {
+      std::vector<std::string> index_keys(write.index_keys().begin(),
+                                          write.index_keys().end());
+      return replica_store_client_->AsyncBatchDeleteWithIndex(table_name, keys,
+                                                              index_keys,
+                                                              IgnoreReplicaStatus);
+    }
+    return replica_store_client_->AsyncBatchDelete(table_name, keys,
+                                                   IgnoreReplicaStatus);
+  }
+  case rpc::StoreWrite::DELETE_BY_INDEX:
+    RAY_CHECK(write.index_keys_size() == 1);
+    return replica_store_client_->AsyncDeleteByIndex(table_name, write.index_keys(0),
+                                                     IgnoreReplicaStatus);
+  default:
+    return Status::Invalid("Unknown write type " + std::to_string(write.type()));
+  }
+}
+
+void GcsStandbyServer::CheckPrimary() {
+  if (seeded_ && current_time_ms() - last_primary_contact_ms_ >
+                     RayConfig::instance().gcs_standby_failover_timeout_milliseconds()) {
+    TakeOver();
+    return;
+  }
+  check_primary_timer_.expires_from_now(boost::posix_time::milliseconds(
+      RayConfig::instance().gcs_standby_heartbeat_interval_milliseconds()));
+  check_primary_timer_.async_wait([this](const boost::system::error_code &error) {
+    if (error == boost::asio::error::operation_aborted) {
+      return;
+    }
+    RAY_CHECK(!error) << "Checking the primary gcs server failed with error: "
+                      << error.message();
+    CheckPrimary();
+  });
+}
+
+}  // namespace gcs
+}  // namespace ray
@@ -0,0 +1,105 @@
+// Copyright 2017 The Ray Authors.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//  http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#pragma once
+
+#include "ray/gcs/gcs_server/gcs_server.h"
+#include "ray/gcs/gcs_server/gcs_table_storage.h"
+#include "ray/rpc/gcs_server/gcs_rpc_server.h"
+
+namespace ray {
+namespace gcs {
+
+/// \class GcsStandbyServer
+/// A standby gcs server runs in its own process, next to a primary gcs server
+/// that was started with its address. The primary streams every write to it,
+/// starting with a snapshot of all tables, and the standby applies them to an
+/// in-memory replica.
+///
+/// Once the standby holds the snapshot, it takes over if it does not hear from
+/// the primary for gcs_standby_failover_timeout_milliseconds: it starts a
+/// `GcsServer` that loads its initial data from the replica instead of reading
+/// it back from redis. That server stores its address in redis, so clients
+/// reconnect to it as they would to a restarted gcs server.
+///
+/// The standby cannot tell a dead primary from an unreachable one, so a primary
+/// that is only cut off from the standby keeps running after the takeover.
+class GcsStandbyServer : public rpc::GcsStandbyServiceHandler {
+ public:
+  /// Create a standby gcs server.
+  ///
+  /// \param config The config of the gcs server that takes over.
+  /// \param standby_port The port to receive the writes of the primary on.
+  /// \param main_service The event loop to run the standby and the server that
+  /// takes over on.
+  GcsStandbyServer(const GcsServerConfig &config, uint16_t standby_port,
+                   boost::asio::io_service &main_service);
+
+  ~GcsStandbyServer();
+
+  /// Start receiving the writes of the primary.
+  void Start();
+
+  /// Stop the standby, or the gcs server that took over.
+  void Stop();
+
+  /// Start a gcs server from the replica. This is done automatically once the
+  /// primary is silent for too long.
+  void TakeOver();
+
+  /// Get the port that the writes of the primary are received on.
+  int GetPort() const { return rpc_server_.GetPort(); }
+
+  /// Whether the replica holds the snapshot of the primary.
+  bool IsSeeded() const { return seeded_; }
+
+  /// The gcs server that took over, or null if the standby has not taken over.
+  GcsServer *GetGcsServer() const { return gcs_server_.get(); }
+
+  void HandleReplicateWrites(const rpc::ReplicateWritesRequest &request,
+                             rpc::ReplicateWritesReply *reply,
+                             rpc::SendReplyCallback send_reply_callback) override;
+
+ private:
+  /// Apply one write of the primary to the replica.
+  Status Apply(const rpc::StoreWrite &write);
+
+  /// Take over if the primary has been silent for too long.
+  void CheckPrimary();
+
+  /// The config of the gcs server that takes over.
+  GcsServerConfig config_;
+  /// The event loop that the standby runs on.
+  boost::asio::io_service &main_service_;
+  /// The grpc server that receives the writes of the primary.
+  rpc::GrpcServer rpc_server_;
+  rpc::GcsStandbyGrpcService standby_service_;
+  /// The in-memory replica of the tables of the primary.
+  std::shared_ptr<InMemoryStoreClient> replica_store_client_;
+  std::shared_ptr<GcsTableStorage> replica_;
+  /// The id of the attachment of the primary that the replica comes from.
+  std::string primary_id_;
+  /// Whether the replica holds the snapshot of that attachment.
+  bool seeded_ = false;
+  /// When the standby last heard from the primary.
+  int64_t last_primary_contact_ms_ = 0;
+  /// The timer that checks that the primary is alive.
+  boost::asio::deadline_timer check_primary_timer_;
+  /// The gcs server that took over, if any.
+  std::unique_ptr<GcsServer> gcs_server_;
+  bool is_stopped_ = false;
+};
+
+}  // namespace gcs
+}  // namespace ray
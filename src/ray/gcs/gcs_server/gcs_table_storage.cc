@@ -14,6 +14,7 @@
 
 #include "ray/gcs/gcs_server/gcs_table_storage.h"
 
+#include "absl/synchronization/mutex.h"
 #include "ray/common/id.h"
 #include "ray/common/status.h"
 #include "ray/gcs/callback.h"
@@ -130,6 +131,103 @@ Status GcsTableWithJobId<Key, Data>::BatchDelete(const std::vector<Key> &keys,
                                                         indexs_to_delete, callback);
 }
 
+namespace {
+
+/// Counts the outstanding reads and writes of a snapshot copy, and reports the
+/// first failure, if any, once all of them have finished.
+class SnapshotCopy {
+ public:
+  SnapshotCopy(std::shared_ptr<GcsTableStorage> standby, StatusCallback callback)
+      : standby_(std::move(standby)), callback_(std::move(callback)) {}
+
+  void Add(size_t num_operations) {
+    absl::MutexLock lock(&mutex_);
+    num_pending_ += num_operations;
+  }
+
+  void Finish(const Status &status) {
+    Status result;
+    {
+      absl::MutexLock lock(&mutex_);
+      if (!status.ok() && status_.ok()) {
+        status_ = status;
+      }
+      if (--num_pending_ > 0) {
+        return;
+      }
+      result = status_;
+    }
+    callback_(result);
+  }
+
+  GcsTableStorage &Standby() { return *standby_; }
+
+ private:
+  std::shared_ptr<GcsTableStorage> standby_;
+  StatusCallback callback_;
+  absl::Mutex mutex_;
+  /// Starts at one for the caller, which finishes it once all tables have
+  /// been scheduled for copying.
+  size_t num_pending_ GUARDED_BY(mutex_) = 1;
+  Status status_ GUARDED_BY(mutex_);
+};
+
+template <typename Table>
+void CopyTable(Table &from, Table &(GcsTableStorage::*to)(),
+               const std::shared_ptr<SnapshotCopy> &copy) {
+  copy->Add(1);
+  auto status = from.GetAll([to, copy](const auto &values) {
+    copy->Add(values.size());
+    auto on_done = [copy](const Status &status) { copy->Finish(status); };
+    auto &table = (copy->Standby().*to)();
+    for (const auto &entry : values) {
+      auto status = table.Put(entry.first, entry.second, on_done);
+      if (!status.ok()) {
+        copy->Finish(status);
+      }
+    }
+    copy->Finish(Status::OK());
+  });
+  if (!status.ok()) {
+    copy->Finish(status);
+  }
+}
+
+}  // namespace
+
+void GcsTableStorage::AddStandby(const std::shared_ptr<GcsTableStorage> &standby,
+                                 const StatusCallback &callback) {
+  RAY_CHECK(standby != nullptr && standby.get() != this);
+  replicated_store_client_->AddReplica(
+      standby->store_client_,
+      [this, standby](const StatusCallback &done) { CopyTablesTo(standby, done); },
+      callback);
+}
+
+void GcsTableStorage::CopyTablesTo(const std::shared_ptr<GcsTableStorage> &standby,
+                                   const StatusCallback &callback) {
+  auto copy = std::make_shared<SnapshotCopy>(standby, callback);
+  // Each entry is put through the standby's table, so that tables indexed by
+  // job id rebuild the index there.
+  CopyTable(JobTable(), &GcsTableStorage::JobTable, copy);
+  CopyTable(ActorTable(), &GcsTableStorage::ActorTable, copy);
+  CopyTable(PlacementGroupTable(), &GcsTableStorage::PlacementGroupTable, copy);
+  CopyTable(TaskTable(), &GcsTableStorage::TaskTable, copy);
+  CopyTable(TaskLeaseTable(), &GcsTableStorage::TaskLeaseTable, copy);
+  CopyTable(TaskReconstructionTable(), &GcsTableStorage::TaskReconstructionTable, copy);
+  CopyTable(ObjectTable(), &GcsTableStorage::ObjectTable, copy);
+  CopyTable(NodeTable(), &GcsTableStorage::NodeTable, copy);
+  CopyTable(NodeResourceTable(), &GcsTableStorage::NodeResourceTable, copy);
+  CopyTable(PlacementGroupScheduleTable(), &GcsTableStorage::PlacementGroupScheduleTable,
+            copy);
+  CopyTable(HeartbeatTable(), &GcsTableStorage::HeartbeatTable, copy);
+  CopyTable(HeartbeatBatchTable(), &GcsTableStorage::HeartbeatBatchTable, copy);
+  CopyTable(ProfileTable(), &GcsTableStorage::ProfileTable, copy);
+  CopyTable(WorkerTable(), &GcsTableStorage::WorkerTable, copy);
+  CopyTable(InternalConfigTable(), &GcsTableStorage::InternalConfigTable, copy);
+  copy->Finish(Status::OK());
+}
+
 template class GcsTable<JobID, JobTableData>;
 template class GcsTable<NodeID, GcsNodeInfo>;
 template class GcsTable<NodeID, ResourceMap>;
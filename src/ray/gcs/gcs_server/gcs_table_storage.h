@@ -18,6 +18,8 @@
 
 #include "ray/gcs/store_client/in_memory_store_client.h"
 #include "ray/gcs/store_client/redis_store_client.h"
+#include "ray/gcs/store_client/replicated_store_client.h"
+#include "ray/gcs/store_client/standby_store_client.h"
 #include "src/ray/protobuf/gcs.pb.h"
 
 namespace ray {
@@ -290,9 +292,26 @@ class GcsInternalConfigTable : public GcsTable<UniqueID, StoredConfig> {
 /// \class GcsTableStorage
 ///
 /// This class is not meant to be used directly. All gcs table storage classes should
-/// derive from this class and override class member variables.
+/// derive from this class and initialize the tables with a backend store client.
 class GcsTableStorage {
  public:
+  /// Replicate this storage to another storage, e.g., the in-memory storage of
+  /// a standby GCS. The standby is first seeded with a snapshot of all tables,
+  /// and then applies every write once this storage has acknowledged it.
+  /// Reads are not affected.
+  ///
+  /// \param standby The storage that this storage is replicated to.
+  /// \param callback Called once the standby holds the snapshot.
+  void AddStandby(const std::shared_ptr<GcsTableStorage> &standby,
+                  const StatusCallback &callback);
+
+  /// Stop streaming writes to a standby storage.
+  ///
+  /// \param standby The storage that was passed to `AddStandby`.
+  void RemoveStandby(const std::shared_ptr<GcsTableStorage> &standby) {
+    replicated_store_client_->RemoveReplica(standby->store_client_);
+  }
+
   GcsJobTable &JobTable() {
     RAY_CHECK(job_table_ != nullptr);
     return *job_table_;
@@ -369,7 +388,40 @@ class GcsTableStorage {
   }
 
  protected:
+  /// Copy the current contents of all tables to the given storage.
+  ///
+  /// \param standby The storage to copy the tables to.
+  /// \param callback Called once every entry has been written to the standby.
+  void CopyTablesTo(const std::shared_ptr<GcsTableStorage> &standby,
+                    const StatusCallback &callback);
+
+  /// Create all tables on top of the given backend store client.
+  void InitTables(std::shared_ptr<StoreClient> backend_store_client) {
+    replicated_store_client_ =
+        std::make_shared<ReplicatedStoreClient>(std::move(backend_store_client));
+    store_client_ = replicated_store_client_;
+    job_table_.reset(new GcsJobTable(store_client_));
+    actor_table_.reset(new GcsActorTable(store_client_));
+    placement_group_table_.reset(new GcsPlacementGroupTable(store_client_));
+    task_table_.reset(new GcsTaskTable(store_client_));
+    task_lease_table_.reset(new GcsTaskLeaseTable(store_client_));
+    task_reconstruction_table_.reset(new GcsTaskReconstructionTable(store_client_));
+    object_table_.reset(new GcsObjectTable(store_client_));
+    node_table_.reset(new GcsNodeTable(store_client_));
+    node_resource_table_.reset(new GcsNodeResourceTable(store_client_));
+    placement_group_schedule_table_.reset(
+        new GcsPlacementGroupScheduleTable(store_client_));
+    heartbeat_table_.reset(new GcsHeartbeatTable(store_client_));
+    resource_usage_batch_table_.reset(new GcsResourceUsageBatchTable(store_client_));
+    profile_table_.reset(new GcsProfileTable(store_client_));
+    worker_table_.reset(new GcsWorkerTable(store_client_));
+    system_config_table_.reset(new GcsInternalConfigTable(store_client_));
+  }
+
+  /// The store client used by all tables. Writes made through it are streamed
+  /// to the standby storages, if any.
   std::shared_ptr<StoreClient> store_client_;
+  std::shared_ptr<ReplicatedStoreClient> replicated_store_client_;
   std::unique_ptr<GcsJobTable> job_table_;
   std::unique_ptr<GcsActorTable> actor_table_;
   std::unique_ptr<GcsPlacementGroupTable> placement_group_table_;
@@ -393,25 +445,7 @@ class GcsTableStorage {
 class RedisGcsTableStorage : public GcsTableStorage {
  public:
   explicit RedisGcsTableStorage(std::shared_ptr<RedisClient> redis_client) {
-    store_client_ = std::make_shared<RedisStoreClient>(redis_client);
-    job_table_.reset(new GcsJobTable(store_client_));
-    actor_table_.reset(new GcsActorTable(store_client_));
-    placement_group_table_.reset(new GcsPlacementGroupTable(store_client_));
-    task_table_.reset(new GcsTaskTable(store_client_));
-    task_lease_table_.reset(new GcsTaskLeaseTable(store_client_));
-    task_reconstruction_table_.reset(new GcsTaskReconstructionTable(store_client_));
-    object_table_.reset(new GcsObjectTable(store_client_));
-    node_table_.reset(new GcsNodeTable(store_client_));
-    node_resource_table_.reset(new GcsNodeResourceTable(store_client_));
-    placement_group_schedule_table_.reset(
-        new GcsPlacementGroupScheduleTable(store_client_));
-    heartbeat_table_.reset(new GcsHeartbeatTable(store_client_));
-    placement_group_schedule_table_.reset(
-        new GcsPlacementGroupScheduleTable(store_client_));
-    resource_usage_batch_table_.reset(new GcsResourceUsageBatchTable(store_client_));
-    profile_table_.reset(new GcsProfileTable(store_client_));
-    worker_table_.reset(new GcsWorkerTable(store_client_));
-    system_config_table_.reset(new GcsInternalConfigTable(store_client_));
+    InitTables(std::make_shared<RedisStoreClient>(redis_client));
   }
 };
 
@@ -421,23 +455,22 @@ class RedisGcsTableStorage : public GcsTableStorage {
 class InMemoryGcsTableStorage : public GcsTableStorage {
  public:
   explicit InMemoryGcsTableStorage(boost::asio::io_service &main_io_service) {
-    store_client_ = std::make_shared<InMemoryStoreClient>(main_io_service);
-    job_table_.reset(new GcsJobTable(store_client_));
-    actor_table_.reset(new GcsActorTable(store_client_));
-    placement_group_table_.reset(new GcsPlacementGroupTable(store_client_));
-    task_table_.reset(new GcsTaskTable(store_client_));
-    task_lease_table_.reset(new GcsTaskLeaseTable(store_client_));
-    task_reconstruction_table_.reset(new GcsTaskReconstructionTable(store_client_));
-    object_table_.reset(new GcsObjectTable(store_client_));
-    node_table_.reset(new GcsNodeTable(store_client_));
-    node_resource_table_.reset(new GcsNodeResourceTable(store_client_));
-    placement_group_schedule_table_.reset(
-        new GcsPlacementGroupScheduleTable(store_client_));
-    heartbeat_table_.reset(new GcsHeartbeatTable(store_client_));
-    resource_usage_batch_table_.reset(new GcsResourceUsageBatchTable(store_client_));
-    profile_table_.reset(new GcsProfileTable(store_client_));
-    worker_table_.reset(new GcsWorkerTable(store_client_));
-    system_config_table_.reset(new GcsInternalConfigTable(store_client_));
+    InitTables(std::make_shared<InMemoryStoreClient>(main_io_service));
+  }
+
+  explicit InMemoryGcsTableStorage(std::shared_ptr<InMemoryStoreClient> store_client) {
+    InitTables(std::move(store_client));
+  }
+};
+
+/// \class StandbyGcsTableStorage
+/// StandbyGcsTableStorage is an implementation of `GcsTableStorage`
+/// that streams writes to a standby GCS server in another process. It only
+/// supports writes, and is meant to be passed to `AddStandby`.
+class StandbyGcsTableStorage : public GcsTableStorage {
+ public:
+  explicit StandbyGcsTableStorage(std::shared_ptr<StandbyStoreClient> store_client) {
+    InitTables(std::move(store_client));
   }
 };
 
@@ -0,0 +1,160 @@
+// Copyright 2017 The Ray Authors.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//  http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "ray/gcs/gcs_server/bundle_bin_packer.h"
+
+#include <unordered_set>
+
+#include "gtest/gtest.h"
+
+namespace ray {
+
+namespace gcs {
+
+class BundleBinPackerTest : public ::testing::Test {
+ protected:
+  void AddNode(const BundleBinPacker::ResourceMap &resources) {
+    nodes_.emplace_back(NodeID::FromRandom(), resources);
+  }
+
+  static size_t CountDistinctNodes(const std::vector<NodeID> &result) {
+    return std::unordered_set<NodeID>(result.begin(), result.end()).size();
+  }
+
+  /// Check that the placement does not oversubscribe any node.
+  void CheckFits(const std::vector<BundleBinPacker::ResourceMap> &bundles,
+                 const std::vector<NodeID> &result) {
+    ASSERT_EQ(result.size(), bundles.size());
+    std::unordered_map<NodeID, BundleBinPacker::ResourceMap> used;
+    for (size_t i = 0; i < bundles.size(); i++) {
+      for (const auto &resource : bundles[i]) {
+        used[result[i]][resource.first] += resource.second;
+      }
+    }
+    for (const auto &node : nodes_) {
+      for (const auto &resource : used[node.first]) {
+        auto it = node.second.find(resource.first);
+        ASSERT_TRUE(it != node.second.end());
+        ASSERT_LE(resource.second, it->second);
+      }
+    }
+  }
+
+  std::vector<std::pair<NodeID, BundleBinPacker::ResourceMap>> nodes_;
+};
+
+TEST_F(BundleBinPackerTest, TestPackUsesFewestNodes) {
+  for (int i = 0; i < 4; i++) {
+    AddNode({{"CPU", 4}});
+  }
+  std::vector<BundleBinPacker::ResourceMap> bundles = {
+      {{"CPU", 1}}, {{"CPU", 3}}, {{"CPU", 2}}, {{"CPU", 2}}};
+  BundleBinPacker packer(nodes_);
+  auto result = packer.Pack(bundles);
+  CheckFits(bundles, result);
+  ASSERT_EQ(CountDistinctNodes(result), 2);
+}
+
+TEST_F(BundleBinPackerTest, TestPackPlacesScarceResourcesFirst) {
+  // Only one node has a GPU. If the CPU bundles were placed first, they could take the
+  // CPUs of the GPU node and leave no room for the GPU bundle.
+  AddNode({{"CPU", 2}, {"GPU", 1}});
+  AddNode({{"CPU", 4}});
+  std::vector<BundleBinPacker::ResourceMap> bundles = {
+      {{"CPU", 2}}, {{"CPU", 2}}, {{"CPU", 1}, {"GPU", 1}}};
+  BundleBinPacker packer(nodes_);
+  auto result = packer.Pack(bundles);
+  CheckFits(bundles, result);
+  ASSERT_EQ(result[2], nodes_[0].first);
+}
+
+TEST_F(BundleBinPackerTest, TestPackFillsRoomiestNodeFirst) {
+  AddNode({{"CPU", 6}});
+  AddNode({{"CPU", 4}});
+  std::vector<BundleBinPacker::ResourceMap> bundles = {
+      {{"CPU", 3}}, {{"CPU", 2}}, {{"CPU", 1}}};
+  BundleBinPacker packer(nodes_);
+  auto result = packer.Pack(bundles);
+  CheckFits(bundles, result);
+  ASSERT_EQ(CountDistinctNodes(result), 1);
+}
+
+TEST_F(BundleBinPackerTest, TestSpreadBalancesBundles) {
+  for (int i = 0; i < 3; i++) {
+    AddNode({{"CPU", 8}});
+  }
+  std::vector<BundleBinPacker::ResourceMap> bundles(6, {{"CPU", 1}});
+  BundleBinPacker packer(nodes_);
+  auto result = packer.Spread(bundles);
+  CheckFits(bundles, result);
+  std::unordered_map<NodeID, int> bundles_per_node;
+  for (const auto &node_id : result) {
+    bundles_per_node[node_id]++;
+  }
+  ASSERT_EQ(bundles_per_node.size(), 3);
+  for (const auto &entry : bundles_per_node) {
+    ASSERT_EQ(entry.second, 2);
+  }
+}
+
+TEST_F(BundleBinPackerTest, TestStrictSpreadFindsMatching) {
+  // Placing the small bundle on the big node first would leave no node for the big
+  // bundle. The matching must move it away.
+  AddNode({{"CPU", 4}});
+  AddNode({{"CPU", 1}});
+  std::vector<BundleBinPacker::ResourceMap> bundles = {{{"CPU", 1}}, {{"CPU", 4}}};
+  BundleBinPacker packer(nodes_);
+  auto result = packer.StrictSpread(bundles);
+  CheckFits(bundles, result);
+  ASSERT_EQ(result[0], nodes_[1].first);
+  ASSERT_EQ(result[1], nodes_[0].first);
+
+  // More bundles than nodes.
+  bundles.push_back({{"CPU", 1}});
+  ASSERT_TRUE(packer.StrictSpread(bundles).empty());
+}
+
+TEST_F(BundleBinPackerTest, TestStrictPackPicksOneNode) {
+  AddNode({{"CPU", 2}});
+  AddNode({{"CPU", 16}, {"GPU", 1}});
+  AddNode({{"CPU", 4}, {"GPU", 1}});
+  std::vector<BundleBinPacker::ResourceMap> bundles = {{{"CPU", 2}, {"GPU", 1}},
+                                                       {{"CPU", 1}}};
+  BundleBinPacker packer(nodes_);
+  auto result = packer.StrictPack(bundles);
+  ASSERT_EQ(result.size(), 2);
+  ASSERT_EQ(result[0], nodes_[1].first);
+  ASSERT_EQ(result[1], nodes_[1].first);
+}
+
+TEST_F(BundleBinPackerTest, TestInfeasible) {
+  AddNode({{"CPU", 2}});
+  AddNode({{"CPU", 2}});
+  BundleBinPacker packer(nodes_);
+  ASSERT_TRUE(packer.Pack({{{"CPU", 3}}}).empty());
+  ASSERT_TRUE(packer.Spread({{{"CPU", 3}}}).empty());
+  ASSERT_TRUE(packer.StrictPack({{{"CPU", 2}}, {{"CPU", 1}}}).empty());
+  ASSERT_TRUE(packer.Pack({{{"GPU", 1}}}).empty());
+  // A failed placement leaves the packer usable.
+  ASSERT_EQ(packer.Pack({{{"CPU", 2}}, {{"CPU", 2}}}).size(), 2);
+}
+
+}  // namespace gcs
+
+}  // namespace ray
+
+int main(int argc, char **argv) {
+  ::testing::InitGoogleTest(&argc, argv);
+  return RUN_ALL_TESTS();
+}
@@ -197,7 +197,8 @@ TEST_F(GcsActorManagerTest, TestBasic) {
   std::vector<std::shared_ptr<gcs::GcsActor>> finished_actors;
   Status status = gcs_actor_manager_->CreateActor(
       create_actor_request,
-      [&finished_actors](const std::shared_ptr<gcs::GcsActor> &actor) {
+      [&finished_actors](const std::shared_ptr<gcs::GcsActor> &actor,
+                         const Status &status) {
         finished_actors.emplace_back(actor);
       });
   RAY_CHECK_OK(status);
@@ -217,6 +218,97 @@ TEST_F(GcsActorManagerTest, TestBasic) {
   ASSERT_EQ(actor->GetState(), rpc::ActorTableData::DEAD);
 }
 
+TEST_F(GcsActorManagerTest, TestRegisterAndCreateActorsInBatch) {
+  auto job_id = JobID::FromInt(1);
+  rpc::RegisterActorsRequest register_request;
+  for (int i = 0; i < 3; i++) {
+    register_request.add_task_specs()->CopyFrom(
+        Mocker::GenRegisterActorRequest(job_id).task_spec());
+  }
+
+  // Register the actors in one batch.
+  std::promise<std::vector<Status>> statuses_promise;
+  std::atomic<int> num_registered(0);
+  io_service_.post([this, &register_request, &statuses_promise, &num_registered]() {
+    statuses_promise.set_value(gcs_actor_manager_->RegisterActors(
+        register_request,
+        [&num_registered](size_t index, std::shared_ptr<gcs::GcsActor> actor,
+                          const Status &status) { num_registered++; }));
+  });
+  auto statuses = statuses_promise.get_future().get();
+  ASSERT_EQ(statuses.size(), 3);
+  for (const auto &status : statuses) {
+    ASSERT_TRUE(status.ok());
+  }
+  auto condition = [&num_registered]() { return num_registered == 3; };
+  ASSERT_TRUE(WaitForCondition(condition, timeout_ms_.count()));
+
+  // Create the actors in one batch, along with an actor that was never registered.
+  rpc::CreateActorsRequest create_request;
+  for (const auto &task_spec : register_request.task_specs()) {
+    create_request.add_task_specs()->CopyFrom(task_spec);
+  }
+  create_request.add_task_specs()->CopyFrom(
+      Mocker::GenCreateActorRequest(job_id).task_spec());
+  std::vector<std::shared_ptr<gcs::GcsActor>> finished_actors;
+  statuses = gcs_actor_manager_->CreateActors(
+      create_request,
+      [&finished_actors](size_t index, std::shared_ptr<gcs::GcsActor> actor,
+                         const Status &status) {
+        RAY_CHECK_OK(status);
+        finished_actors.emplace_back(actor);
+      });
+  ASSERT_EQ(statuses.size(), 4);
+  ASSERT_TRUE(statuses[0].ok() && statuses[1].ok() && statuses[2].ok());
+  ASSERT_TRUE(statuses[3].IsInvalid());
+  ASSERT_EQ(finished_actors.size(), 0);
+  ASSERT_EQ(mock_actor_scheduler_->actors.size(), 3);
+
+  for (auto &actor : mock_actor_scheduler_->actors) {
+    actor->UpdateAddress(RandomAddress());
+    gcs_actor_manager_->OnActorCreationSuccess(actor);
+    WaitActorCreated(actor->GetActorID());
+  }
+  ASSERT_EQ(finished_actors.size(), 3);
+}
+
+TEST_F(GcsActorManagerTest, TestCreateActorsRepliesPerActor) {
+  auto job_id = JobID::FromInt(1);
+  rpc::CreateActorsRequest create_request;
+  for (int i = 0; i < 2; i++) {
+    create_request.add_task_specs()->CopyFrom(
+        RegisterActor(job_id)->GetActorTableData().task_spec());
+  }
+  create_request.add_task_specs()->CopyFrom(
+      Mocker::GenCreateActorRequest(job_id).task_spec());
+
+  rpc::CreateActorsReply reply;
+  std::atomic<bool> replied(false);
+  gcs_actor_manager_->HandleCreateActors(
+      create_request, &reply,
+      [&replied](Status status, std::function<void()> success,
+                 std::function<void()> failure) { replied = true; });
+  ASSERT_EQ(mock_actor_scheduler_->actors.size(), 2);
+  ASSERT_FALSE(replied);
+
+  // The owner of the first actor dies before the actor is created. The batch must
+  // not wait for its creation.
+  ASSERT_TRUE(worker_client_->Reply());
+  ASSERT_FALSE(replied);
+
+  auto actor = mock_actor_scheduler_->actors[1];
+  actor->UpdateAddress(RandomAddress());
+  gcs_actor_manager_->OnActorCreationSuccess(actor);
+  ASSERT_TRUE(WaitForCondition([&replied]() { return replied.load(); },
+                               timeout_ms_.count()));
+
+  ASSERT_EQ(reply.status().code(), (int)StatusCode::Invalid);
+  ASSERT_EQ(reply.actor_statuses_size(), 3);
+  ASSERT_EQ(reply.actor_statuses(0).code(), (int)StatusCode::Invalid);
+  ASSERT_EQ(reply.actor_statuses(1).code(), (int)StatusCode::OK);
+  ASSERT_EQ(reply.actor_statuses(2).code(), (int)StatusCode::Invalid);
+}
+
 TEST_F(GcsActorManagerTest, TestSchedulingFailed) {
   auto job_id = JobID::FromInt(1);
   auto registered_actor = RegisterActor(job_id);
@@ -226,7 +318,8 @@ TEST_F(GcsActorManagerTest, TestSchedulingFailed) {
 
   std::vector<std::shared_ptr<gcs::GcsActor>> finished_actors;
   RAY_CHECK_OK(gcs_actor_manager_->CreateActor(
-      create_actor_request, [&finished_actors](std::shared_ptr<gcs::GcsActor> actor) {
+      create_actor_request,
+      [&finished_actors](std::shared_ptr<gcs::GcsActor> actor, const Status &status) {
         finished_actors.emplace_back(actor);
       }));
 
@@ -257,7 +350,8 @@ TEST_F(GcsActorManagerTest, TestWorkerFailure) {
 
   std::vector<std::shared_ptr<gcs::GcsActor>> finished_actors;
   RAY_CHECK_OK(gcs_actor_manager_->CreateActor(
-      create_actor_request, [&finished_actors](std::shared_ptr<gcs::GcsActor> actor) {
+      create_actor_request,
+      [&finished_actors](std::shared_ptr<gcs::GcsActor> actor, const Status &status) {
         finished_actors.emplace_back(actor);
       }));
 
@@ -299,7 +393,8 @@ TEST_F(GcsActorManagerTest, TestNodeFailure) {
 
   std::vector<std::shared_ptr<gcs::GcsActor>> finished_actors;
   Status status = gcs_actor_manager_->CreateActor(
-      create_actor_request, [&finished_actors](std::shared_ptr<gcs::GcsActor> actor) {
+      create_actor_request,
+      [&finished_actors](std::shared_ptr<gcs::GcsActor> actor, const Status &status) {
         finished_actors.emplace_back(actor);
       });
   RAY_CHECK_OK(status);
@@ -344,7 +439,8 @@ TEST_F(GcsActorManagerTest, TestActorReconstruction) {
 
   std::vector<std::shared_ptr<gcs::GcsActor>> finished_actors;
   Status status = gcs_actor_manager_->CreateActor(
-      create_actor_request, [&finished_actors](std::shared_ptr<gcs::GcsActor> actor) {
+      create_actor_request,
+      [&finished_actors](std::shared_ptr<gcs::GcsActor> actor, const Status &status) {
         finished_actors.emplace_back(actor);
       });
   RAY_CHECK_OK(status);
@@ -407,7 +503,8 @@ TEST_F(GcsActorManagerTest, TestActorRestartWhenOwnerDead) {
 
   std::vector<std::shared_ptr<gcs::GcsActor>> finished_actors;
   RAY_CHECK_OK(gcs_actor_manager_->CreateActor(
-      create_actor_request, [&finished_actors](std::shared_ptr<gcs::GcsActor> actor) {
+      create_actor_request,
+      [&finished_actors](std::shared_ptr<gcs::GcsActor> actor, const Status &status) {
         finished_actors.emplace_back(actor);
       }));
 
@@ -452,7 +549,8 @@ TEST_F(GcsActorManagerTest, TestDetachedActorRestartWhenCreatorDead) {
 
   std::vector<std::shared_ptr<gcs::GcsActor>> finished_actors;
   RAY_CHECK_OK(gcs_actor_manager_->CreateActor(
-      create_actor_request, [&finished_actors](std::shared_ptr<gcs::GcsActor> actor) {
+      create_actor_request,
+      [&finished_actors](std::shared_ptr<gcs::GcsActor> actor, const Status &status) {
         finished_actors.emplace_back(actor);
       }));
 
@@ -553,7 +651,7 @@ TEST_F(GcsActorManagerTest, TestNamedActorDeletionWorkerFailure) {
       registered_actor_1->GetActorTableData().task_spec());
 
   Status status = gcs_actor_manager_->CreateActor(
-      request1, [](std::shared_ptr<gcs::GcsActor> actor) {});
+      request1, [](std::shared_ptr<gcs::GcsActor> actor, const Status &status) {});
   ASSERT_TRUE(status.ok());
   ASSERT_EQ(gcs_actor_manager_->GetActorIDByName(actor_name).Binary(),
             request1.task_spec().actor_creation_task_spec().actor_id());
@@ -582,8 +680,8 @@ TEST_F(GcsActorManagerTest, TestNamedActorDeletionWorkerFailure) {
   request2.mutable_task_spec()->CopyFrom(
       registered_actor_2->GetActorTableData().task_spec());
 
-  status = gcs_actor_manager_->CreateActor(request2,
-                                           [](std::shared_ptr<gcs::GcsActor> actor) {});
+  status = gcs_actor_manager_->CreateActor(
+      request2, [](std::shared_ptr<gcs::GcsActor> actor, const Status &status) {});
   ASSERT_TRUE(status.ok());
   ASSERT_EQ(gcs_actor_manager_->GetActorIDByName(actor_name).Binary(),
             request2.task_spec().actor_creation_task_spec().actor_id());
@@ -599,7 +697,7 @@ TEST_F(GcsActorManagerTest, TestNamedActorDeletionNodeFailure) {
       registered_actor_1->GetActorTableData().task_spec());
 
   Status status = gcs_actor_manager_->CreateActor(
-      request1, [](std::shared_ptr<gcs::GcsActor> actor) {});
+      request1, [](std::shared_ptr<gcs::GcsActor> actor, const Status &status) {});
   ASSERT_TRUE(status.ok());
   ASSERT_EQ(gcs_actor_manager_->GetActorIDByName("actor").Binary(),
             request1.task_spec().actor_creation_task_spec().actor_id());
@@ -627,8 +725,8 @@ TEST_F(GcsActorManagerTest, TestNamedActorDeletionNodeFailure) {
   request2.mutable_task_spec()->CopyFrom(
       registered_actor_2->GetActorTableData().task_spec());
 
-  status = gcs_actor_manager_->CreateActor(request2,
-                                           [](std::shared_ptr<gcs::GcsActor> actor) {});
+  status = gcs_actor_manager_->CreateActor(
+      request2, [](std::shared_ptr<gcs::GcsActor> actor, const Status &status) {});
   ASSERT_TRUE(status.ok());
   ASSERT_EQ(gcs_actor_manager_->GetActorIDByName("actor").Binary(),
             request2.task_spec().actor_creation_task_spec().actor_id());
@@ -645,7 +743,7 @@ TEST_F(GcsActorManagerTest, TestNamedActorDeletionNotHappendWhenReconstructed) {
       registered_actor_1->GetActorTableData().task_spec());
 
   Status status = gcs_actor_manager_->CreateActor(
-      request1, [](std::shared_ptr<gcs::GcsActor> actor) {});
+      request1, [](std::shared_ptr<gcs::GcsActor> actor, const Status &status) {});
   ASSERT_TRUE(status.ok());
   ASSERT_EQ(gcs_actor_manager_->GetActorIDByName("actor").Binary(),
             request1.task_spec().actor_creation_task_spec().actor_id());
@@ -688,7 +786,8 @@ TEST_F(GcsActorManagerTest, TestDestroyActorBeforeActorCreationCompletes) {
 
   std::vector<std::shared_ptr<gcs::GcsActor>> finished_actors;
   RAY_CHECK_OK(gcs_actor_manager_->CreateActor(
-      create_actor_request, [&finished_actors](std::shared_ptr<gcs::GcsActor> actor) {
+      create_actor_request,
+      [&finished_actors](std::shared_ptr<gcs::GcsActor> actor, const Status &status) {
         finished_actors.emplace_back(actor);
       }));
 
@@ -717,7 +816,8 @@ TEST_F(GcsActorManagerTest, TestRaceConditionCancelLease) {
 
   std::vector<std::shared_ptr<gcs::GcsActor>> finished_actors;
   RAY_CHECK_OK(gcs_actor_manager_->CreateActor(
-      create_actor_request, [&finished_actors](std::shared_ptr<gcs::GcsActor> actor) {
+      create_actor_request,
+      [&finished_actors](std::shared_ptr<gcs::GcsActor> actor, const Status &status) {
         finished_actors.emplace_back(actor);
       }));
 
@@ -753,7 +853,8 @@ TEST_F(GcsActorManagerTest, TestRegisterActor) {
   request.mutable_task_spec()->CopyFrom(
       registered_actor->GetActorTableData().task_spec());
   RAY_CHECK_OK(gcs_actor_manager_->CreateActor(
-      request, [&finished_actors](std::shared_ptr<gcs::GcsActor> actor) {
+      request,
+      [&finished_actors](std::shared_ptr<gcs::GcsActor> actor, const Status &status) {
         finished_actors.emplace_back(std::move(actor));
       }));
   // Make sure the actor is scheduling.
@@ -842,7 +943,8 @@ TEST_F(GcsActorManagerTest, TestOwnerAndChildDiedAtTheSameTimeRaceCondition) {
 
   std::vector<std::shared_ptr<gcs::GcsActor>> finished_actors;
   RAY_CHECK_OK(gcs_actor_manager_->CreateActor(
-      create_actor_request, [&finished_actors](std::shared_ptr<gcs::GcsActor> actor) {
+      create_actor_request,
+      [&finished_actors](std::shared_ptr<gcs::GcsActor> actor, const Status &status) {
         finished_actors.emplace_back(actor);
       }));
   auto actor = mock_actor_scheduler_->actors.back();
@@ -13,6 +13,7 @@
 // limitations under the License.
 
 #include <memory>
+#include <unordered_set>
 
 #include "gtest/gtest.h"
 #include "ray/gcs/gcs_server/test/gcs_server_test_util.h"
@@ -28,8 +29,10 @@ class GcsActorSchedulerTest : public ::testing::Test {
     gcs_table_storage_ = std::make_shared<gcs::RedisGcsTableStorage>(redis_client_);
     gcs_node_manager_ =
         std::make_shared<gcs::GcsNodeManager>(gcs_pub_sub_, gcs_table_storage_);
-    gcs_actor_schedule_strategy_ =
-        std::make_shared<gcs::GcsRandomActorScheduleStrategy>(gcs_node_manager_);
+    gcs_resource_manager_ =
+        std::make_shared<gcs::GcsResourceManager>(io_service_, nullptr, nullptr);
+    gcs_actor_schedule_strategy_ = std::make_shared<gcs::GcsRandomActorScheduleStrategy>(
+        gcs_node_manager_, gcs_resource_manager_);
     store_client_ = std::make_shared<gcs::InMemoryStoreClient>(io_service_);
     gcs_actor_table_ =
         std::make_shared<GcsServerMocker::MockedGcsActorTable>(store_client_);
@@ -57,6 +60,7 @@ class GcsActorSchedulerTest : public ::testing::Test {
   std::shared_ptr<GcsServerMocker::MockRayletClient> raylet_client_;
   std::shared_ptr<GcsServerMocker::MockWorkerClient> worker_client_;
   std::shared_ptr<gcs::GcsNodeManager> gcs_node_manager_;
+  std::shared_ptr<gcs::GcsResourceManager> gcs_resource_manager_;
   std::shared_ptr<gcs::GcsActorScheduleStrategyInterface> gcs_actor_schedule_strategy_;
   std::shared_ptr<GcsServerMocker::MockedGcsActorScheduler> gcs_actor_scheduler_;
   std::vector<std::shared_ptr<gcs::GcsActor>> success_actors_;
@@ -121,6 +125,161 @@ TEST_F(GcsActorSchedulerTest, TestScheduleActorSuccess) {
   ASSERT_EQ(actor->GetWorkerID(), worker_id);
 }
 
+TEST_F(GcsActorSchedulerTest, TestScheduleBatchSpreadsActors) {
+  std::vector<std::shared_ptr<rpc::GcsNodeInfo>> nodes;
+  for (int i = 0; i < 3; i++) {
+    nodes.emplace_back(Mocker::GenNodeInfo());
+    gcs_node_manager_->AddNode(nodes.back());
+  }
+
+  auto job_id = JobID::FromInt(1);
+  std::vector<std::shared_ptr<gcs::GcsActor>> actors;
+  for (int i = 0; i < 6; i++) {
+    auto create_actor_request = Mocker::GenCreateActorRequest(job_id);
+    actors.emplace_back(
+        std::make_shared<gcs::GcsActor>(create_actor_request.task_spec()));
+  }
+
+  // Schedule all the actors in one pass. They should be spread evenly over the nodes
+  // and the leases from each node should be requested with a single request.
+  gcs_actor_scheduler_->ScheduleBatch(actors);
+  ASSERT_EQ(6, raylet_client_->num_workers_requested);
+  ASSERT_EQ(3, raylet_client_->num_lease_rpcs);
+  ASSERT_EQ(6, raylet_client_->callbacks.size());
+  absl::flat_hash_map<NodeID, int> actors_per_node;
+  for (const auto &actor : actors) {
+    actors_per_node[actor->GetNodeID()]++;
+  }
+  ASSERT_EQ(3, actors_per_node.size());
+  for (const auto &node : nodes) {
+    ASSERT_EQ(2, actors_per_node[NodeID::FromBinary(node->node_id())]);
+  }
+
+  ASSERT_EQ(0, failure_actors_.size());
+}
+
+TEST_F(GcsActorSchedulerTest, TestScheduleBatchRespectsAvailableResources) {
+  // The first node has room for two actors, the second for none and the third for
+  // one.
+  std::vector<NodeID> node_ids;
+  for (double cpu_num : {2, 0, 1}) {
+    auto node = Mocker::GenNodeInfo();
+    gcs_node_manager_->AddNode(node);
+    gcs_resource_manager_->OnNodeAdd(*node);
+    node_ids.emplace_back(NodeID::FromBinary(node->node_id()));
+    std::unordered_map<std::string, double> resource_map;
+    if (cpu_num > 0) {
+      resource_map["CPU"] = cpu_num;
+    }
+    gcs_resource_manager_->SetAvailableResources(node_ids.back(),
+                                                 ResourceSet(resource_map));
+  }
+
+  auto job_id = JobID::FromInt(1);
+  std::vector<std::shared_ptr<gcs::GcsActor>> actors;
+  for (int i = 0; i < 3; i++) {
+    auto create_actor_request = Mocker::GenCreateActorRequest(job_id);
+    (*create_actor_request.mutable_task_spec()->mutable_required_resources())["CPU"] =
+        1;
+    actors.emplace_back(
+        std::make_shared<gcs::GcsActor>(create_actor_request.task_spec()));
+  }
+
+  gcs_actor_scheduler_->ScheduleBatch(actors);
+  ASSERT_EQ(3, raylet_client_->num_workers_requested);
+  absl::flat_hash_map<NodeID, int> actors_per_node;
+  for (const auto &actor : actors) {
+    actors_per_node[actor->GetNodeID()]++;
+  }
+  ASSERT_EQ(2, actors_per_node[node_ids[0]]);
+  ASSERT_EQ(0, actors_per_node[node_ids[1]]);
+  ASSERT_EQ(1, actors_per_node[node_ids[2]]);
+}
+
+TEST_F(GcsActorSchedulerTest, TestScheduleBatchLeasesWorkersTogether) {
+  auto node = Mocker::GenNodeInfo();
+  auto node_id = NodeID::FromBinary(node->node_id());
+  gcs_node_manager_->AddNode(node);
+
+  auto job_id = JobID::FromInt(1);
+  std::vector<std::shared_ptr<gcs::GcsActor>> actors;
+  for (int i = 0; i < 3; i++) {
+    auto create_actor_request = Mocker::GenCreateActorRequest(job_id);
+    actors.emplace_back(
+        std::make_shared<gcs::GcsActor>(create_actor_request.task_spec()));
+  }
+
+  // The three leases are requested from the raylet with one request, which is replied
+  // to once all of them are granted.
+  gcs_actor_scheduler_->ScheduleBatch(actors);
+  ASSERT_EQ(3, raylet_client_->num_workers_requested);
+  ASSERT_EQ(1, raylet_client_->num_lease_rpcs);
+  for (int i = 0; i < 3; i++) {
+    ASSERT_EQ(0, worker_client_->callbacks.size());
+    ASSERT_TRUE(raylet_client_->GrantWorkerLease(
+        node->node_manager_address(), node->node_manager_port(), WorkerID::FromRandom(),
+        node_id, NodeID::Nil()));
+  }
+  ASSERT_EQ(3, worker_client_->callbacks.size());
+
+  // Each actor is then created on its own worker.
+  for (int i = 0; i < 3; i++) {
+    ASSERT_TRUE(worker_client_->ReplyPushTask());
+  }
+  ASSERT_EQ(0, failure_actors_.size());
+  ASSERT_EQ(3, success_actors_.size());
+  std::unordered_set<WorkerID> worker_ids;
+  for (const auto &actor : actors) {
+    ASSERT_EQ(actor->GetNodeID(), node_id);
+    worker_ids.insert(actor->GetWorkerID());
+  }
+  ASSERT_EQ(3, worker_ids.size());
+}
+
+TEST_F(GcsActorSchedulerTest, TestScheduleBatchRetriesFailedLeases) {
+  auto node = Mocker::GenNodeInfo();
+  auto node_id = NodeID::FromBinary(node->node_id());
+  gcs_node_manager_->AddNode(node);
+
+  auto job_id = JobID::FromInt(1);
+  std::vector<std::shared_ptr<gcs::GcsActor>> actors;
+  for (int i = 0; i < 2; i++) {
+    auto create_actor_request = Mocker::GenCreateActorRequest(job_id);
+    actors.emplace_back(
+        std::make_shared<gcs::GcsActor>(create_actor_request.task_spec()));
+  }
+  gcs_actor_scheduler_->ScheduleBatch(actors);
+  ASSERT_EQ(1, raylet_client_->num_lease_rpcs);
+
+  // The request fails, so every lease of the batch is retried on its own. The mocked
+  // scheduler only sends the first retry.
+  ASSERT_TRUE(raylet_client_->GrantWorkerLease(
+      node->node_manager_address(), node->node_manager_port(), WorkerID::FromRandom(),
+      node_id, NodeID::Nil(), Status::IOError("")));
+  ASSERT_TRUE(raylet_client_->GrantWorkerLease(node->node_manager_address(),
+                                               node->node_manager_port(),
+                                               WorkerID::FromRandom(), node_id,
+                                               NodeID::Nil()));
+  ASSERT_EQ(2, gcs_actor_scheduler_->num_retry_leasing_count_);
+  ASSERT_EQ(3, raylet_client_->num_workers_requested);
+  ASSERT_EQ(1, raylet_client_->num_lease_rpcs);
+  ASSERT_EQ(1, raylet_client_->callbacks.size());
+  ASSERT_EQ(0, worker_client_->callbacks.size());
+}
+
+TEST_F(GcsActorSchedulerTest, TestScheduleBatchFailedWithZeroNode) {
+  auto job_id = JobID::FromInt(1);
+  std::vector<std::shared_ptr<gcs::GcsActor>> actors;
+  for (int i = 0; i < 2; i++) {
+    auto create_actor_request = Mocker::GenCreateActorRequest(job_id);
+    actors.emplace_back(
+        std::make_shared<gcs::GcsActor>(create_actor_request.task_spec()));
+  }
+  gcs_actor_scheduler_->ScheduleBatch(actors);
+  ASSERT_EQ(0, raylet_client_->num_workers_requested);
+  ASSERT_EQ(2, failure_actors_.size());
+}
+
 TEST_F(GcsActorSchedulerTest, TestScheduleRetryWhenLeasing) {
   auto node = Mocker::GenNodeInfo();
   auto node_id = NodeID::FromBinary(node->node_id());
@@ -0,0 +1,137 @@
+// Copyright 2017 The Ray Authors.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//  http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "ray/gcs/gcs_server/gcs_heartbeat_manager.h"
+
+#include <future>
+#include <memory>
+
+#include "gtest/gtest.h"
+#include "ray/common/ray_config.h"
+
+namespace ray {
+
+/// Exposes the ticks of the failure detector, so that the tests control the time
+/// instead of sleeping.
+class MockGcsHeartbeatManager : public gcs::GcsHeartbeatManager {
+ public:
+  using gcs::GcsHeartbeatManager::DetectDeadNodes;
+  using gcs::GcsHeartbeatManager::GcsHeartbeatManager;
+};
+
+class GcsHeartbeatManagerTest : public ::testing::Test {
+ public:
+  GcsHeartbeatManagerTest() {
+    RayConfig::instance().initialize({{"num_heartbeats_timeout", "5"}});
+    heartbeat_manager_ = std::make_shared<MockGcsHeartbeatManager>(
+        io_service_,
+        [this](const NodeID &node_id) { dead_nodes_.push_back(node_id); });
+  }
+
+  ~GcsHeartbeatManagerTest() { heartbeat_manager_->Stop(); }
+
+  /// Run a function on the event loop of the heartbeat manager, and wait for it. The
+  /// work that was posted before it has run by then.
+  void RunOnEventLoop(const std::function<void()> &function) {
+    std::promise<void> done;
+    io_service_.post([&function, &done]() {
+      function();
+      done.set_value();
+    });
+    done.get_future().wait();
+  }
+
+  void Tick(int num_ticks = 1) {
+    RunOnEventLoop([this, num_ticks]() {
+      for (int i = 0; i < num_ticks; i++) {
+        heartbeat_manager_->DetectDeadNodes();
+      }
+    });
+  }
+
+  std::vector<NodeID> DeadNodes() {
+    std::vector<NodeID> dead_nodes;
+    RunOnEventLoop([this, &dead_nodes]() { dead_nodes = dead_nodes_; });
+    return dead_nodes;
+  }
+
+  Status SendHeartbeat(const NodeID &node_id) {
+    rpc::ReportHeartbeatRequest request;
+    request.mutable_heartbeat()->set_node_id(node_id.Binary());
+    rpc::ReportHeartbeatReply reply;
+    Status reply_status;
+    RunOnEventLoop([&]() {
+      heartbeat_manager_->HandleReportHeartbeat(
+          request, &reply,
+          [&reply_status](Status status, std::function<void()> success,
+                          std::function<void()> failure) { reply_status = status; });
+    });
+    return reply_status;
+  }
+
+ protected:
+  boost::asio::io_service io_service_;
+  std::shared_ptr<MockGcsHeartbeatManager> heartbeat_manager_;
+  /// The nodes marked as dead. This is only accessed on the event loop.
+  std::vector<NodeID> dead_nodes_;
+};
+
+TEST_F(GcsHeartbeatManagerTest, TestSilentNodeTimesOut) {
+  auto node_id = NodeID::FromRandom();
+  heartbeat_manager_->AddNode(node_id);
+  Tick(4);
+  ASSERT_TRUE(DeadNodes().empty());
+  Tick();
+  ASSERT_EQ(DeadNodes(), std::vector<NodeID>{node_id});
+}
+
+TEST_F(GcsHeartbeatManagerTest, TestLivenessReportKeepsNodeAlive) {
+  auto live_node_id = NodeID::FromRandom();
+  auto silent_node_id = NodeID::FromRandom();
+  heartbeat_manager_->AddNode(live_node_id);
+  heartbeat_manager_->AddNode(silent_node_id);
+
+  // Report liveness for one node only, well past the timeout of the other.
+  for (int i = 0; i < 20; i++) {
+    heartbeat_manager_->ReportLiveness(live_node_id);
+    Tick();
+  }
+  ASSERT_EQ(DeadNodes(), std::vector<NodeID>{silent_node_id});
+
+  // Once the reports stop, the node times out too.
+  Tick(5);
+  ASSERT_EQ(DeadNodes(), (std::vector<NodeID>{silent_node_id, live_node_id}));
+}
+
+TEST_F(GcsHeartbeatManagerTest, TestDeadNodeIsToldOnHeartbeat) {
+  auto node_id = NodeID::FromRandom();
+  heartbeat_manager_->AddNode(node_id);
+  RAY_CHECK_OK(SendHeartbeat(node_id));
+  Tick(5);
+  ASSERT_EQ(DeadNodes(), std::vector<NodeID>{node_id});
+
+  // Liveness reports don't revive a dead node, and its next heartbeat tells it that
+  // it was marked dead.
+  heartbeat_manager_->ReportLiveness(node_id);
+  ASSERT_TRUE(SendHeartbeat(node_id).IsDisconnected());
+  Tick(10);
+  ASSERT_EQ(DeadNodes(), std::vector<NodeID>{node_id});
+}
+
+}  // namespace ray
+
+int main(int argc, char **argv) {
+  ::testing::InitGoogleTest(&argc, argv);
+  return RUN_ALL_TESTS();
+}
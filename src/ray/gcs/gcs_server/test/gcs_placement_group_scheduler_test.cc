@@ -332,10 +332,11 @@ TEST_F(GcsPlacementGroupSchedulerTest, TestSchedulePlacementGroupReturnResource)
 
   ASSERT_EQ(2, raylet_clients_[0]->num_lease_requested);
   ASSERT_EQ(2, raylet_clients_[0]->lease_callbacks.size());
-  // One bundle success and the other failed.
+  // One bundle success and the other failed. Both bundles are prepared by the same
+  // request, which the node rolls back as a whole, so there is nothing to return.
   ASSERT_TRUE(raylet_clients_[0]->GrantPrepareBundleResources());
   ASSERT_TRUE(raylet_clients_[0]->GrantPrepareBundleResources(false));
-  ASSERT_EQ(1, raylet_clients_[0]->num_return_requested);
+  ASSERT_EQ(0, raylet_clients_[0]->num_return_requested);
   // Reply the placement_group creation request, then the placement_group should be
   // scheduled successfully.
   WaitPlacementGroupPendingDone(1, GcsPlacementGroupStatus::FAILURE);
@@ -343,6 +344,36 @@ TEST_F(GcsPlacementGroupSchedulerTest, TestSchedulePlacementGroupReturnResource)
   CheckEqWithPlacementGroupFront(placement_group, GcsPlacementGroupStatus::FAILURE);
 }
 
+TEST_F(GcsPlacementGroupSchedulerTest, TestBundlesOnSameNodeAreBatched) {
+  AddNode(Mocker::GenNodeInfo(0));
+  auto failure_handler = [this](std::shared_ptr<gcs::GcsPlacementGroup> placement_group) {
+    absl::MutexLock lock(&placement_group_requests_mutex_);
+    failure_placement_groups_.emplace_back(std::move(placement_group));
+  };
+  auto success_handler = [this](std::shared_ptr<gcs::GcsPlacementGroup> placement_group) {
+    absl::MutexLock lock(&placement_group_requests_mutex_);
+    success_placement_groups_.emplace_back(std::move(placement_group));
+  };
+
+  // All the bundles fit on one node, so they are prepared and committed with a single
+  // request each.
+  auto request =
+      Mocker::GenCreatePlacementGroupRequest("", rpc::PlacementStrategy::PACK, 4);
+  auto placement_group = std::make_shared<gcs::GcsPlacementGroup>(request);
+  scheduler_->ScheduleUnplacedBundles(placement_group, failure_handler, success_handler);
+  ASSERT_EQ(4, raylet_clients_[0]->num_lease_requested);
+  ASSERT_EQ(1, raylet_clients_[0]->num_prepare_rpcs);
+  for (int index = 0; index < 4; ++index) {
+    ASSERT_TRUE(raylet_clients_[0]->GrantPrepareBundleResources());
+  }
+  WaitPendingDone(raylet_clients_[0]->commit_callbacks, 4);
+  ASSERT_EQ(1, raylet_clients_[0]->num_commit_rpcs);
+  for (int index = 0; index < 4; ++index) {
+    ASSERT_TRUE(raylet_clients_[0]->GrantCommitBundleResources());
+  }
+  WaitPlacementGroupPendingDone(1, GcsPlacementGroupStatus::SUCCESS);
+}
+
 TEST_F(GcsPlacementGroupSchedulerTest, TestStrictPackStrategyBalancedScheduling) {
   AddNode(Mocker::GenNodeInfo(0));
   AddNode(Mocker::GenNodeInfo(1));
@@ -13,8 +13,12 @@
 // limitations under the License.
 
 #include <memory>
+#include <random>
+#include <unordered_set>
 
+#include "absl/time/clock.h"
 #include "gtest/gtest.h"
+#include "ray/common/ray_config.h"
 #include "ray/gcs/gcs_server/gcs_resource_scheduler.h"
 #include "ray/gcs/test/gcs_test_util.h"
 
@@ -85,6 +89,70 @@ class GcsResourceSchedulerTest : public ::testing::Test {
     CheckClusterAvailableResources(node_id, cpu_resource, node_cpu_num);
   }
 
+  void SetSolverEnabled(bool enabled) {
+    RayConfig::instance().initialize(
+        {{"gcs_placement_group_bin_packing_solver_enabled", enabled ? "true" : "false"}});
+  }
+
+  /// Schedule the same stream of placement groups onto a fresh cluster until the first
+  /// one fails, committing the resources of each placed group, and report how many
+  /// groups fit and how long each scheduling decision took.
+  void BenchmarkScheduling(const gcs::SchedulingType &scheduling_type) {
+    const int node_count = 100;
+    std::vector<NodeID> node_ids;
+    for (int i = 0; i < node_count; i++) {
+      node_ids.push_back(NodeID::FromRandom());
+      std::unordered_map<std::string, double> resource_map = {{"CPU", 16}};
+      if (i % 4 == 0) {
+        resource_map["GPU"] = 4;
+      }
+      gcs_resource_manager_->UpdateResourceCapacity(node_ids.back(), resource_map);
+    }
+
+    std::mt19937 gen(42);
+    std::uniform_int_distribution<int> bundle_count(2, 8);
+    std::uniform_int_distribution<int> bundle_cpus(1, 6);
+    std::bernoulli_distribution needs_gpu(0.1);
+    int placed_groups = 0;
+    std::unordered_set<NodeID> used_nodes;
+    absl::Duration total_time;
+    while (true) {
+      std::vector<ResourceSet> required_resources_list;
+      int num_bundles = bundle_count(gen);
+      for (int i = 0; i < num_bundles; i++) {
+        std::unordered_map<std::string, double> resource_map = {{"CPU", bundle_cpus(gen)}};
+        if (needs_gpu(gen)) {
+          resource_map["GPU"] = 1;
+        }
+        required_resources_list.emplace_back(resource_map);
+      }
+      auto start = absl::Now();
+      auto result =
+          gcs_resource_scheduler_->Schedule(required_resources_list, scheduling_type);
+      total_time += absl::Now() - start;
+      if (result.empty()) {
+        break;
+      }
+      placed_groups++;
+      for (size_t i = 0; i < result.size(); i++) {
+        RAY_CHECK(gcs_resource_manager_->AcquireResources(result[i],
+                                                          required_resources_list[i]));
+        used_nodes.insert(result[i]);
+      }
+    }
+    RAY_LOG(INFO) << "Scheduling type " << scheduling_type << ", solver "
+                  << RayConfig::instance()
+                         .gcs_placement_group_bin_packing_solver_enabled()
+                  << ": placed " << placed_groups << " placement groups on "
+                  << used_nodes.size() << " nodes, "
+                  << absl::ToDoubleMicroseconds(total_time) / (placed_groups + 1)
+                  << "us per scheduling decision.";
+
+    for (const auto &node_id : node_ids) {
+      gcs_resource_manager_->OnNodeDead(node_id);
+    }
+  }
+
   std::shared_ptr<gcs::GcsResourceManager> gcs_resource_manager_;
   std::shared_ptr<gcs::GcsResourceScheduler> gcs_resource_scheduler_;
 
@@ -124,6 +192,43 @@ TEST_F(GcsResourceSchedulerTest, TestNodeFilter) {
   ASSERT_EQ(result2.size(), 1);
 }
 
+TEST_F(GcsResourceSchedulerTest, TestStrictSpreadFindsPlacementWhenGreedyFails) {
+  const auto &big_node_id = NodeID::FromRandom();
+  const auto &small_node_id = NodeID::FromRandom();
+  AddClusterResources(big_node_id, "CPU", 4);
+  AddClusterResources(small_node_id, "CPU", 1);
+
+  // Scoring the bundles one by one puts the small bundle on the big node, which leaves
+  // no node for the big bundle.
+  std::vector<ResourceSet> required_resources_list;
+  required_resources_list.emplace_back(std::unordered_map<std::string, double>{{"CPU", 1}});
+  required_resources_list.emplace_back(std::unordered_map<std::string, double>{{"CPU", 4}});
+  SetSolverEnabled(false);
+  ASSERT_TRUE(gcs_resource_scheduler_
+                  ->Schedule(required_resources_list, gcs::SchedulingType::STRICT_SPREAD)
+                  .empty());
+
+  SetSolverEnabled(true);
+  const auto &result = gcs_resource_scheduler_->Schedule(
+      required_resources_list, gcs::SchedulingType::STRICT_SPREAD);
+  ASSERT_EQ(result.size(), 2);
+  ASSERT_EQ(result[0], small_node_id);
+  ASSERT_EQ(result[1], big_node_id);
+  CheckClusterAvailableResources(big_node_id, "CPU", 4);
+  CheckClusterAvailableResources(small_node_id, "CPU", 1);
+}
+
+TEST_F(GcsResourceSchedulerTest, DISABLED_BenchmarkFragmentation) {
+  for (auto scheduling_type : {gcs::SchedulingType::PACK, gcs::SchedulingType::SPREAD,
+                               gcs::SchedulingType::STRICT_SPREAD}) {
+    for (bool solver_enabled : {false, true}) {
+      SetSolverEnabled(solver_enabled);
+      BenchmarkScheduling(scheduling_type);
+    }
+  }
+  SetSolverEnabled(true);
+}
+
 }  // namespace ray
 
 int main(int argc, char **argv) {
@@ -74,11 +74,42 @@ struct GcsServerMocker {
     void RequestWorkerLease(
         const ray::TaskSpecification &resource_spec,
         const rpc::ClientCallback<rpc::RequestWorkerLeaseReply> &callback,
-        const int64_t backlog_size = -1) override {
+        const int64_t backlog_size = -1,
+        const absl::flat_hash_map<NodeID, uint64_t> &local_object_bytes = {}) override {
       num_workers_requested += 1;
       callbacks.push_back(callback);
     }
 
+    /// WorkerLeaseInterface
+    void RequestWorkerLeases(
+        const std::vector<ray::TaskSpecification> &resource_specs,
+        const rpc::ClientCallback<rpc::RequestWorkerLeasesReply> &callback,
+        const int64_t backlog_size = -1) override {
+      num_workers_requested += resource_specs.size();
+      num_lease_rpcs += 1;
+      // Tests grant the leases of a request one by one. The request replies once all
+      // of its leases are granted.
+      auto remaining = std::make_shared<size_t>(resource_specs.size());
+      auto merged_status = std::make_shared<Status>();
+      auto merged_reply = std::make_shared<rpc::RequestWorkerLeasesReply>();
+      for (size_t i = 0; i < resource_specs.size(); i++) {
+        merged_reply->add_replies();
+      }
+      for (size_t i = 0; i < resource_specs.size(); i++) {
+        callbacks.push_back([i, remaining, merged_status, merged_reply, callback](
+                                const Status &status,
+                                const rpc::RequestWorkerLeaseReply &reply) {
+          if (merged_status->ok()) {
+            *merged_status = status;
+          }
+          merged_reply->mutable_replies(i)->CopyFrom(reply);
+          if (--(*remaining) == 0) {
+            callback(*merged_status, *merged_reply);
+          }
+        });
+      }
+    }
+
     /// WorkerLeaseInterface
     void ReleaseUnusedWorkers(
         const std::vector<WorkerID> &workers_in_use,
@@ -152,20 +183,51 @@ struct GcsServerMocker {
 
     /// ResourceReserveInterface
     void PrepareBundleResources(
-        const BundleSpecification &bundle_spec,
+        const std::vector<std::shared_ptr<BundleSpecification>> &bundle_specs,
         const ray::rpc::ClientCallback<ray::rpc::PrepareBundleResourcesReply> &callback)
         override {
-      num_lease_requested += 1;
-      lease_callbacks.push_back(callback);
+      num_lease_requested += bundle_specs.size();
+      num_prepare_rpcs += 1;
+      // Tests grant the bundles of a request one by one. The request replies once all
+      // of its bundles are granted, and only succeeds if all of them succeeded.
+      auto remaining = std::make_shared<size_t>(bundle_specs.size());
+      auto success = std::make_shared<bool>(true);
+      for (size_t i = 0; i < bundle_specs.size(); i++) {
+        lease_callbacks.push_back([remaining, success, callback](
+                                      const Status &status,
+                                      const rpc::PrepareBundleResourcesReply &reply) {
+          *success = *success && status.ok() && reply.success();
+          if (--(*remaining) == 0) {
+            rpc::PrepareBundleResourcesReply merged_reply;
+            merged_reply.set_success(*success);
+            callback(Status::OK(), merged_reply);
+          }
+        });
+      }
     }
 
     /// ResourceReserveInterface
     void CommitBundleResources(
-        const BundleSpecification &bundle_spec,
+        const std::vector<std::shared_ptr<BundleSpecification>> &bundle_specs,
         const ray::rpc::ClientCallback<ray::rpc::CommitBundleResourcesReply> &callback)
         override {
-      num_commit_requested += 1;
-      commit_callbacks.push_back(callback);
+      num_commit_requested += bundle_specs.size();
+      num_commit_rpcs += 1;
+      // Same as above, the request replies once all of its bundles are granted.
+      auto remaining = std::make_shared<size_t>(bundle_specs.size());
+      auto merged_status = std::make_shared<Status>();
+      for (size_t i = 0; i < bundle_specs.size(); i++) {
+        commit_callbacks.push_back([remaining, merged_status, callback](
+                                       const Status &status,
+                                       const rpc::CommitBundleResourcesReply &reply) {
+          if (merged_status->ok()) {
+            *merged_status = status;
+          }
+          if (--(*remaining) == 0) {
+            callback(*merged_status, reply);
+          }
+        });
+      }
     }
 
     /// ResourceReserveInterface
@@ -240,6 +302,7 @@ struct GcsServerMocker {
     ~MockRayletClient() {}
 
     int num_workers_requested = 0;
+    int num_lease_rpcs = 0;
     int num_workers_returned = 0;
     int num_workers_disconnected = 0;
     int num_leases_canceled = 0;
@@ -251,6 +314,8 @@ struct GcsServerMocker {
     int num_lease_requested = 0;
     int num_return_requested = 0;
     int num_commit_requested = 0;
+    int num_prepare_rpcs = 0;
+    int num_commit_rpcs = 0;
 
     int num_release_unused_bundles_requested = 0;
     std::list<rpc::ClientCallback<rpc::PrepareBundleResourcesReply>> lease_callbacks = {};
@@ -98,6 +98,49 @@ class GcsTableStorageTestBase : public ::testing::Test {
     ASSERT_EQ(GetByJobId(table, job_id3, actor_id3, values), 0);
   }
 
+  void TestStandbyReplication() {
+    JobID job_id = JobID::FromInt(1);
+    std::vector<ActorID> actor_ids;
+    auto put_actor = [this, &actor_ids, job_id]() {
+      auto actor_table_data = Mocker::GenActorTableData(job_id);
+      actor_ids.push_back(ActorID::FromBinary(actor_table_data->actor_id()));
+      Put(gcs_table_storage_->ActorTable(), actor_ids.back(), *actor_table_data);
+    };
+    // Data written before the standby is added reaches it through the snapshot.
+    for (int i = 0; i < 10; i++) {
+      put_actor();
+    }
+    auto standby =
+        std::make_shared<gcs::InMemoryGcsTableStorage>(*(io_service_pool_->Get()));
+    ++pending_count_;
+    gcs_table_storage_->AddStandby(standby, [this](const Status &status) {
+      RAY_CHECK_OK(status);
+      --pending_count_;
+    });
+    WaitPendingDone();
+    ASSERT_EQ(GetAll(standby->ActorTable()), actor_ids.size());
+
+    // Later writes are streamed.
+    for (int i = 0; i < 10; i++) {
+      put_actor();
+    }
+    ASSERT_EQ(GetAll(standby->ActorTable()), actor_ids.size());
+
+    std::vector<rpc::ActorTableData> values;
+    ASSERT_EQ(GetByJobId(standby->ActorTable(), job_id, actor_ids[0], values),
+              actor_ids.size());
+
+    // Deletes are streamed too.
+    BatchDelete(gcs_table_storage_->ActorTable(), actor_ids);
+    ASSERT_EQ(GetAll(standby->ActorTable()), 0);
+
+    // Once removed, the standby no longer receives writes.
+    gcs_table_storage_->RemoveStandby(standby);
+    Put(gcs_table_storage_->ActorTable(), actor_ids[0],
+        *Mocker::GenActorTableData(job_id));
+    ASSERT_EQ(Get(standby->ActorTable(), actor_ids[0], values), 0);
+  }
+
   template <typename TABLE, typename KEY, typename VALUE>
   void Put(TABLE &table, const KEY &key, const VALUE &value) {
     auto on_done = [this](const Status &status) { --pending_count_; };
@@ -147,6 +190,19 @@ class GcsTableStorageTestBase : public ::testing::Test {
     return values.size();
   }
 
+  template <typename TABLE>
+  size_t GetAll(TABLE &table) {
+    size_t count = 0;
+    auto on_done = [this, &count](const auto &result) {
+      count = result.size();
+      --pending_count_;
+    };
+    ++pending_count_;
+    RAY_CHECK_OK(table.GetAll(on_done));
+    WaitPendingDone();
+    return count;
+  }
+
   template <typename TABLE, typename KEY>
   void Delete(TABLE &table, const KEY &key) {
     auto on_done = [this](const Status &status) {
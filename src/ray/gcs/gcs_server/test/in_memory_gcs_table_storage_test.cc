@@ -34,6 +34,10 @@ TEST_F(InMemoryGcsTableStorageTest, TestGcsTableWithJobIdApi) {
   TestGcsTableWithJobIdApi();
 }
 
+TEST_F(InMemoryGcsTableStorageTest, TestStandbyReplication) {
+  TestStandbyReplication();
+}
+
 }  // namespace ray
 
 int main(int argc, char **argv) {
@@ -45,6 +45,8 @@ TEST_F(RedisGcsTableStorageTest, TestGcsTableApi) { TestGcsTableApi(); }
 
 TEST_F(RedisGcsTableStorageTest, TestGcsTableWithJobIdApi) { TestGcsTableWithJobIdApi(); }
 
+TEST_F(RedisGcsTableStorageTest, TestStandbyReplication) { TestStandbyReplication(); }
+
 }  // namespace ray
 
 int main(int argc, char **argv) {
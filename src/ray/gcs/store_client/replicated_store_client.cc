@@ -0,0 +1,196 @@
+// Copyright 2017 The Ray Authors.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//  http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "ray/gcs/store_client/replicated_store_client.h"
+
+#include <algorithm>
+
+namespace ray {
+
+namespace gcs {
+
+void ReplicatedStoreClient::AddReplica(std::shared_ptr<StoreClient> replica,
+                                       const SnapshotCopier &copy_snapshot,
+                                       const StatusCallback &callback) {
+  RAY_CHECK(replica);
+  {
+    absl::MutexLock lock(&mutex_);
+    replicas_.emplace_back(replica);
+  }
+  // Writes acknowledged from here on are buffered, so any write that the
+  // snapshot misses is applied once it has been copied.
+  copy_snapshot([this, replica, callback](const Status &status) {
+    {
+      absl::MutexLock lock(&mutex_);
+      auto it =
+          std::find_if(replicas_.begin(), replicas_.end(),
+                       [&replica](const Replica &r) { return r.client == replica; });
+      if (it != replicas_.end()) {
+        if (status.ok()) {
+          for (const auto &operation : it->pending_operations) {
+            Apply(operation, *replica);
+          }
+          it->pending_operations.clear();
+          it->seeded = true;
+        } else {
+          RAY_LOG(WARNING) << "Failed to copy a snapshot to a GCS replica, status = "
+                           << status;
+          replicas_.erase(it);
+        }
+      }
+    }
+    if (callback) {
+      callback(status);
+    }
+  });
+}
+
+void ReplicatedStoreClient::RemoveReplica(const std::shared_ptr<StoreClient> &replica) {
+  absl::MutexLock lock(&mutex_);
+  replicas_.erase(
+      std::remove_if(replicas_.begin(), replicas_.end(),
+                     [&replica](const Replica &r) { return r.client == replica; }),
+      replicas_.end());
+}
+
+void ReplicatedStoreClient::Apply(const ReplicaOperation &operation,
+                                  StoreClient &replica) {
+  auto status = operation(replica);
+  if (!status.ok()) {
+    RAY_LOG(WARNING) << "Failed to stream a write to a GCS replica, status = " << status;
+  }
+}
+
+StatusCallback ReplicatedStoreClient::ReplicateOnSuccess(const StatusCallback &callback,
+                                                         ReplicaOperation operation) {
+  // Replicas are looked up when the write is acknowledged rather than when it
+  // is issued, so that a write in flight while a replica is added is not lost.
+  return [this, callback, operation](const Status &status) {
+    if (status.ok()) {
+      absl::MutexLock lock(&mutex_);
+      for (auto &replica : replicas_) {
+        if (replica.seeded) {
+          Apply(operation, *replica.client);
+        } else {
+          replica.pending_operations.push_back(operation);
+        }
+      }
+    }
+    if (callback) {
+      callback(status);
+    }
+  };
+}
+
+/// Replicas acknowledge writes through their own callbacks, which we ignore.
+static void IgnoreReplicaStatus(const Status &status) {}
+
+Status ReplicatedStoreClient::AsyncPut(const std::string &table_name,
+                                       const std::string &key, const std::string &data,
+                                       const StatusCallback &callback) {
+  return primary_->AsyncPut(
+      table_name, key, data,
+      ReplicateOnSuccess(callback, [table_name, key, data](StoreClient &replica) {
+        return replica.AsyncPut(table_name, key, data, IgnoreReplicaStatus);
+      }));
+}
+
+Status ReplicatedStoreClient::AsyncPutWithIndex(const std::string &table_name,
+                                                const std::string &key,
+                                                const std::string &index_key,
+                                                const std::string &data,
+                                                const StatusCallback &callback) {
+  return primary_->AsyncPutWithIndex(
+      table_name, key, index_key, data,
+      ReplicateOnSuccess(callback,
+                         [table_name, key, index_key, data](StoreClient &replica) {
+                           return replica.AsyncPutWithIndex(table_name, key, index_key,
+                                                            data, IgnoreReplicaStatus);
+                         }));
+}
+
+Status ReplicatedStoreClient::AsyncGet(const std::string &table_name,
+                                       const std::string &key,
+                                       const OptionalItemCallback<std::string> &callback) {
+  return primary_->AsyncGet(table_name, key, callback);
+}
+
+Status ReplicatedStoreClient::AsyncGetByIndex(
+    const std::string &table_name, const std::string &index_key,
+    const MapCallback<std::string, std::string> &callback) {
+  return primary_->AsyncGetByIndex(table_name, index_key, callback);
+}
+
+Status ReplicatedStoreClient::AsyncGetAll(
+    const std::string &table_name,
+    const MapCallback<std::string, std::string> &callback) {
+  return primary_->AsyncGetAll(table_name, callback);
+}
+
+Status ReplicatedStoreClient::AsyncDelete(const std::string &table_name,
+                                          const std::string &key,
+                                          const StatusCallback &callback) {
+  return primary_->AsyncDelete(
+      table_name, key,
+      ReplicateOnSuccess(callback, [table_name, key](StoreClient &replica) {
+        return replica.AsyncDelete(table_name, key, IgnoreReplicaStatus);
+      }));
+}
+
+Status ReplicatedStoreClient::AsyncDeleteWithIndex(const std::string &table_name,
+                                                   const std::string &key,
+                                                   const std::string &index_key,
+                                                   const StatusCallback &callback) {
+  return primary_->AsyncDeleteWithIndex(
+      table_name, key, index_key,
+      ReplicateOnSuccess(callback, [table_name, key, index_key](StoreClient &replica) {
+        return replica.AsyncDeleteWithIndex(table_name, key, index_key,
+                                            IgnoreReplicaStatus);
+      }));
+}
+
+Status ReplicatedStoreClient::AsyncBatchDelete(const std::string &table_name,
+                                               const std::vector<std::string> &keys,
+                                               const StatusCallback &callback) {
+  return primary_->AsyncBatchDelete(
+      table_name, keys,
+      ReplicateOnSuccess(callback, [table_name, keys](StoreClient &replica) {
+        return replica.AsyncBatchDelete(table_name, keys, IgnoreReplicaStatus);
+      }));
+}
+
+Status ReplicatedStoreClient::AsyncBatchDeleteWithIndex(
+    const std::string &table_name, const std::vector<std::string> &keys,
+    const std::vector<std::string> &index_keys, const StatusCallback &callback) {
+  return primary_->AsyncBatchDeleteWithIndex(
+      table_name, keys, index_keys,
+      ReplicateOnSuccess(callback, [table_name, keys, index_keys](StoreClient &replica) {
+        return replica.AsyncBatchDeleteWithIndex(table_name, keys, index_keys,
+                                                 IgnoreReplicaStatus);
+      }));
+}
+
+Status ReplicatedStoreClient::AsyncDeleteByIndex(const std::string &table_name,
+                                                 const std::string &index_key,
+                                                 const StatusCallback &callback) {
+  return primary_->AsyncDeleteByIndex(
+      table_name, index_key,
+      ReplicateOnSuccess(callback, [table_name, index_key](StoreClient &replica) {
+        return replica.AsyncDeleteByIndex(table_name, index_key, IgnoreReplicaStatus);
+      }));
+}
+
+}  // namespace gcs
+
+}  // namespace ray
@@ -0,0 +1,136 @@
+// Copyright 2017 The Ray Authors.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//  http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#pragma once
+
+#include "absl/synchronization/mutex.h"
+#include "ray/gcs/store_client/store_client.h"
+
+namespace ray {
+
+namespace gcs {
+
+/// \class ReplicatedStoreClient
+/// A store client that forwards all operations to a primary store client and
+/// streams every successful write to a set of replica store clients. Reads
+/// are only served by the primary. A write is applied to the replicas once
+/// the primary has acknowledged it, so a replica never holds data that the
+/// primary did not persist.
+///
+/// A replica that is added while the primary already holds data is first
+/// seeded with a snapshot of the primary. Writes acknowledged while the
+/// snapshot is copied are buffered and applied to the replica, in order, once
+/// the snapshot is complete.
+class ReplicatedStoreClient : public StoreClient {
+ public:
+  /// Copies a snapshot of the primary's data to a new replica, then calls the
+  /// given callback.
+  using SnapshotCopier = std::function<void(const StatusCallback &done)>;
+
+  explicit ReplicatedStoreClient(std::shared_ptr<StoreClient> primary)
+      : primary_(std::move(primary)) {
+    RAY_CHECK(primary_);
+  }
+
+  /// Add a replica. Writes acknowledged from now on are streamed to it, after
+  /// the snapshot made by `copy_snapshot` has been copied.
+  ///
+  /// \param replica The store client that writes will be streamed to.
+  /// \param copy_snapshot Copies the current data of the primary to the
+  /// replica. Since the store client does not know the index of each key, the
+  /// caller copies the data.
+  /// \param callback Called once the replica holds the snapshot and all the
+  /// writes buffered while it was copied.
+  void AddReplica(std::shared_ptr<StoreClient> replica,
+                  const SnapshotCopier &copy_snapshot, const StatusCallback &callback)
+      LOCKS_EXCLUDED(mutex_);
+
+  /// Stop streaming writes to a replica.
+  ///
+  /// \param replica The replica to remove.
+  void RemoveReplica(const std::shared_ptr<StoreClient> &replica)
+      LOCKS_EXCLUDED(mutex_);
+
+  Status AsyncPut(const std::string &table_name, const std::string &key,
+                  const std::string &data, const StatusCallback &callback) override;
+
+  Status AsyncPutWithIndex(const std::string &table_name, const std::string &key,
+                           const std::string &index_key, const std::string &data,
+                           const StatusCallback &callback) override;
+
+  Status AsyncGet(const std::string &table_name, const std::string &key,
+                  const OptionalItemCallback<std::string> &callback) override;
+
+  Status AsyncGetByIndex(const std::string &table_name, const std::string &index_key,
+                         const MapCallback<std::string, std::string> &callback) override;
+
+  Status AsyncGetAll(const std::string &table_name,
+                     const MapCallback<std::string, std::string> &callback) override;
+
+  Status AsyncDelete(const std::string &table_name, const std::string &key,
+                     const StatusCallback &callback) override;
+
+  Status AsyncDeleteWithIndex(const std::string &table_name, const std::string &key,
+                              const std::string &index_key,
+                              const StatusCallback &callback) override;
+
+  Status AsyncBatchDelete(const std::string &table_name,
+                          const std::vector<std::string> &keys,
+                          const StatusCallback &callback) override;
+
+  Status AsyncBatchDeleteWithIndex(const std::string &table_name,
+                                   const std::vector<std::string> &keys,
+                                   const std::vector<std::string> &index_keys,
+                                   const StatusCallback &callback) override;
+
+  Status AsyncDeleteByIndex(const std::string &table_name, const std::string &index_key,
+                            const StatusCallback &callback) override;
+
+ private:
+  using ReplicaOperation = std::function<Status(StoreClient &replica)>;
+
+  struct Replica {
+    explicit Replica(std::shared_ptr<StoreClient> client) : client(std::move(client)) {}
+
+    std::shared_ptr<StoreClient> client;
+    /// Whether the snapshot has been copied to this replica. Until then,
+    /// writes are buffered in `pending_operations`.
+    bool seeded = false;
+    std::vector<ReplicaOperation> pending_operations;
+  };
+
+  /// Wrap the callback of a write to the primary so that the write is applied
+  /// to all replicas once the primary succeeds.
+  StatusCallback ReplicateOnSuccess(const StatusCallback &callback,
+                                    ReplicaOperation operation) LOCKS_EXCLUDED(mutex_);
+
+  /// Apply a write to a replica, logging any failure.
+  static void Apply(const ReplicaOperation &operation, StoreClient &replica);
+
+  /// The store client that serves reads and acknowledges writes.
+  std::shared_ptr<StoreClient> primary_;
+
+  /// Protects the replica list, since writes may be issued and acknowledged
+  /// from different threads. Writes are applied to the replicas while holding
+  /// it, so that each replica sees them in the order the primary acknowledged
+  /// them.
+  absl::Mutex mutex_;
+
+  /// The replicas that successful writes are streamed to.
+  std::vector<Replica> replicas_ GUARDED_BY(mutex_);
+};
+
+}  // namespace gcs
+
+}  // namespace ray
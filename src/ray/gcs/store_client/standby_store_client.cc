@@ -0,0 +1,208 @@
+// Copyright 2017 The Ray Authors.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//  http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "ray/gcs/store_client/standby_store_client.h"
+
+#include "ray/common/ray_config.h"
+
+namespace ray {
+
+namespace gcs {
+
+StandbyStoreClient::StandbyStoreClient(const std::string &address, int port,
+                                       rpc::ClientCallManager &client_call_manager)
+    : primary_id_(UniqueID::FromRandom().Binary()),
+      rpc_client_(address, port, client_call_manager) {}
+
+void StandbyStoreClient::MarkSeeded() {
+  absl::MutexLock lock(&mutex_);
+  seeded_ = true;
+}
+
+void StandbyStoreClient::Heartbeat() {
+  absl::MutexLock lock(&mutex_);
+  if (!request_in_flight_ && !disconnected_) {
+    SendQueuedWrites();
+  }
+}
+
+bool StandbyStoreClient::IsDisconnected() {
+  absl::MutexLock lock(&mutex_);
+  return disconnected_;
+}
+
+Status StandbyStoreClient::Write(rpc::StoreWrite write, const StatusCallback &callback) {
+  {
+    absl::MutexLock lock(&mutex_);
+    if (!disconnected_) {
+      queued_writes_.emplace_back(std::move(write), callback);
+      if (!request_in_flight_) {
+        SendQueuedWrites();
+      }
+      return Status::OK();
+    }
+  }
+  return Status::IOError("The standby GCS server is disconnected.");
+}
+
+void StandbyStoreClient::SendQueuedWrites() {
+  rpc::ReplicateWritesRequest request;
+  request.set_primary_id(primary_id_);
+  request.set_seeded(seeded_);
+  std::vector<StatusCallback> callbacks;
+  const size_t max_request_bytes = RayConfig::instance().max_grpc_message_size() / 2;
+  size_t request_bytes = 0;
+  while (!queued_writes_.empty() &&
+         (callbacks.empty() || request_bytes < max_request_bytes)) {
+    auto &write = queued_writes_.front();
+    request_bytes += write.first.ByteSizeLong();
+    request.add_writes()->Swap(&write.first);
+    callbacks.push_back(std::move(write.second));
+    queued_writes_.pop_front();
+  }
+
+  request_in_flight_ = true;
+  auto self = shared_from_this();
+  rpc_client_.ReplicateWrites(
+      request, [self, callbacks](const Status &status,
+                                 const rpc::ReplicateWritesReply &reply) {
+        auto result = status;
+        if (result.ok() && reply.status().code() != static_cast<int>(StatusCode::OK)) {
+          result = Status(StatusCode(reply.status().code()), reply.status().message());
+        }
+        std::vector<std::pair<rpc::StoreWrite, StatusCallback>> dropped_writes;
+        {
+          absl::MutexLock lock(&self->mutex_);
+          self->request_in_flight_ = false;
+          if (!result.ok()) {
+            RAY_LOG(WARNING) << "Failed to stream writes to the standby GCS server, "
+                                "status = "
+                             << result;
+            self->disconnected_ = true;
+            dropped_writes.assign(self->queued_writes_.begin(),
+                                  self->queued_writes_.end());
+            self->queued_writes_.clear();
+          } else if (!self->queued_writes_.empty()) {
+            self->SendQueuedWrites();
+          }
+        }
+        // Callbacks run without the lock, since they may issue more writes.
+        for (const auto &callback : callbacks) {
+          if (callback) {
+            callback(result);
+          }
+        }
+        for (const auto &write : dropped_writes) {
+          if (write.second) {
+            write.second(result);
+          }
+        }
+      });
+}
+
+Status StandbyStoreClient::AsyncPut(const std::string &table_name,
+                                    const std::string &key, const std::string &data,
+                                    const StatusCallback &callback) {
+  rpc::StoreWrite write;
+  write.set_type(rpc::StoreWrite::PUT);
+  write.set_table_name(table_name);
+  write.add_keys(key);
+  write.set_data(data);
+  return Write(std::move(write), callback);
+}
+
+Status StandbyStoreClient::AsyncPutWithIndex(const std::string &table_name,
+                                             const std::string &key,
+                                             const std::string &index_key,
+                                             const std::string &data,
+                                             const StatusCallback &callback) {
+  rpc::StoreWrite write;
+  write.set_type(rpc::StoreWrite::PUT);
+  write.set_table_name(table_name);
+  write.add_keys(key);
+  write.add_index_keys(index_key);
+  write.set_data(data);
+  return Write(std::move(write), callback);
+}
+
+Status StandbyStoreClient::AsyncGet(const std::string &table_name,
+                                    const std::string &key,
+                                    const OptionalItemCallback<std::string> &callback) {
+  return Status::NotImplemented("The standby store client only supports writes.");
+}
+
+Status StandbyStoreClient::AsyncGetByIndex(
+    const std::string &table_name, const std::string &index_key,
+    const MapCallback<std::string, std::string> &callback) {
+  return Status::NotImplemented("The standby store client only supports writes.");
+}
+
+Status StandbyStoreClient::AsyncGetAll(
+    const std::string &table_name,
+    const MapCallback<std::string, std::string> &callback) {
+  return Status::NotImplemented("The standby store client only supports writes.");
+}
+
+Status StandbyStoreClient::AsyncDelete(const std::string &table_name,
+                                       const std::string &key,
+                                       const StatusCallback &callback) {
+  return AsyncBatchDelete(table_name, {key}, callback);
+}
+
+Status StandbyStoreClient::AsyncDeleteWithIndex(const std::string &table_name,
+                                                const std::string &key,
+                                                const std::string &index_key,
+                                                const StatusCallback &callback) {
+  return AsyncBatchDeleteWithIndex(table_name, {key}, {index_key}, callback);
+}
+
+Status StandbyStoreClient::AsyncBatchDelete(const std::string &table_name,
+                                            const std::vector<std::string> &keys,
+                                            const StatusCallback &callback) {
+  rpc::StoreWrite write;
+  write.set_type(rpc::StoreWrite::DELETE);
+  write.set_table_name(table_name);
+  for (const auto &key : keys) {
+    write.add_keys(key);
+  }
+  return Write(std::move(write), callback);
+}
+
+Status StandbyStoreClient::AsyncBatchDeleteWithIndex(
+    const std::string &table_name, const std::vector<std::string> &keys,
+    const std::vector<std::string> &index_keys, const StatusCallback &callback) {
+  RAY_CHECK(keys.size() == index_keys.size());
+  rpc::StoreWrite write;
+  write.set_type(rpc::StoreWrite::DELETE);
+  write.set_table_name(table_name);
+  for (size_t i = 0; i < keys.size(); ++i) {
+    write.add_keys(keys[i]);
+    write.add_index_keys(index_keys[i]);
+  }
+  return Write(std::move(write), callback);
+}
+
+Status StandbyStoreClient::AsyncDeleteByIndex(const std::string &table_name,
+                                              const std::string &index_key,
+                                              const StatusCallback &callback) {
+  rpc::StoreWrite write;
+  write.set_type(rpc::StoreWrite::DELETE_BY_INDEX);
+  write.set_table_name(table_name);
+  write.add_index_keys(index_key);
+  return Write(std::move(write), callback);
+}
+
+}  // namespace gcs
+
+}  // namespace ray
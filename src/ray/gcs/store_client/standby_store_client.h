@@ -0,0 +1,128 @@
+// Copyright 2017 The Ray Authors.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//  http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#pragma once
+
+#include <deque>
+
+#include "absl/synchronization/mutex.h"
+#include "ray/gcs/store_client/store_client.h"
+#include "ray/rpc/gcs_server/gcs_rpc_client.h"
+
+namespace ray {
+
+namespace gcs {
+
+/// \class StandbyStoreClient
+/// A store client that streams writes to a standby GCS server running in another
+/// process, which applies them to its in-memory replica. It is meant to be added as a
+/// replica of the primary's storage, so it only supports writes.
+///
+/// Writes are sent in the order they are issued. While a request is in flight, new
+/// writes are queued and sent together in the next one. Once a request fails, the
+/// client is disconnected: all later writes fail without being sent, and the owner is
+/// expected to attach to the standby again with a new client and a new snapshot.
+///
+/// This class is thread safe.
+class StandbyStoreClient : public StoreClient,
+                           public std::enable_shared_from_this<StandbyStoreClient> {
+ public:
+  /// Create a client of the standby at the given address.
+  ///
+  /// \param address The address of the standby.
+  /// \param port The port of the standby.
+  /// \param client_call_manager The `ClientCallManager` used for managing requests.
+  StandbyStoreClient(const std::string &address, int port,
+                     rpc::ClientCallManager &client_call_manager);
+
+  /// Tell the standby that it now holds the snapshot of the primary, so it may take
+  /// over once the primary stops streaming.
+  void MarkSeeded() LOCKS_EXCLUDED(mutex_);
+
+  /// Send an empty request if nothing is in flight, so that the standby knows that
+  /// the primary is alive.
+  void Heartbeat() LOCKS_EXCLUDED(mutex_);
+
+  /// Whether a request to the standby has failed.
+  bool IsDisconnected() LOCKS_EXCLUDED(mutex_);
+
+  Status AsyncPut(const std::string &table_name, const std::string &key,
+                  const std::string &data, const StatusCallback &callback) override;
+
+  Status AsyncPutWithIndex(const std::string &table_name, const std::string &key,
+                           const std::string &index_key, const std::string &data,
+                           const StatusCallback &callback) override;
+
+  Status AsyncGet(const std::string &table_name, const std::string &key,
+                  const OptionalItemCallback<std::string> &callback) override;
+
+  Status AsyncGetByIndex(const std::string &table_name, const std::string &index_key,
+                         const MapCallback<std::string, std::string> &callback) override;
+
+  Status AsyncGetAll(const std::string &table_name,
+                     const MapCallback<std::string, std::string> &callback) override;
+
+  Status AsyncDelete(const std::string &table_name, const std::string &key,
+                     const StatusCallback &callback) override;
+
+  Status AsyncDeleteWithIndex(const std::string &table_name, const std::string &key,
+                              const std::string &index_key,
+                              const StatusCallback &callback) override;
+
+  Status AsyncBatchDelete(const std::string &table_name,
+                          const std::vector<std::string> &keys,
+                          const StatusCallback &callback) override;
+
+  Status AsyncBatchDeleteWithIndex(const std::string &table_name,
+                                   const std::vector<std::string> &keys,
+                                   const std::vector<std::string> &index_keys,
+                                   const StatusCallback &callback) override;
+
+  Status AsyncDeleteByIndex(const std::string &table_name, const std::string &index_key,
+                            const StatusCallback &callback) override;
+
+ private:
+  /// Queue a write and send it unless a request is already in flight.
+  Status Write(rpc::StoreWrite write, const StatusCallback &callback)
+      LOCKS_EXCLUDED(mutex_);
+
+  /// Send the queued writes in one request, up to half the maximum gRPC message
+  /// size.
+  void SendQueuedWrites() EXCLUSIVE_LOCKS_REQUIRED(mutex_);
+
+  /// Identifies this attachment to the standby.
+  const std::string primary_id_;
+
+  /// The RPC client of the standby.
+  rpc::GcsStandbyRpcClient rpc_client_;
+
+  absl::Mutex mutex_;
+
+  /// Whether the standby holds the snapshot.
+  bool seeded_ GUARDED_BY(mutex_) = false;
+
+  /// Whether a request is in flight.
+  bool request_in_flight_ GUARDED_BY(mutex_) = false;
+
+  /// Whether a request has failed.
+  bool disconnected_ GUARDED_BY(mutex_) = false;
+
+  /// The writes that have not been sent yet, with their callbacks.
+  std::deque<std::pair<rpc::StoreWrite, StatusCallback>> queued_writes_
+      GUARDED_BY(mutex_);
+};
+
+}  // namespace gcs
+
+}  // namespace ray
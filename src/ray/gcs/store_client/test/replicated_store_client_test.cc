@@ -0,0 +1,115 @@
+// Copyright 2017 The Ray Authors.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//  http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "ray/gcs/store_client/replicated_store_client.h"
+
+#include "ray/gcs/store_client/in_memory_store_client.h"
+#include "ray/gcs/store_client/test/store_client_test_base.h"
+
+namespace ray {
+
+namespace gcs {
+
+class ReplicatedStoreClientTest : public StoreClientTestBase {
+ public:
+  void InitStoreClient() override {
+    auto primary = std::make_shared<InMemoryStoreClient>(*(io_service_pool_->Get()));
+    replicated_store_client_ = std::make_shared<ReplicatedStoreClient>(primary);
+    replica_ = std::make_shared<InMemoryStoreClient>(*(io_service_pool_->Get()));
+    replicated_store_client_->AddReplica(
+        replica_, [](const StatusCallback &done) { done(Status::OK()); }, nullptr);
+    store_client_ = replicated_store_client_;
+  }
+
+  void DisconnectStoreClient() override {}
+
+ protected:
+  /// Run the given checks against the replica instead of the primary.
+  void OnReplica(const std::function<void()> &checks) {
+    store_client_ = replica_;
+    checks();
+    store_client_ = replicated_store_client_;
+  }
+
+  std::shared_ptr<ReplicatedStoreClient> replicated_store_client_;
+  std::shared_ptr<StoreClient> replica_;
+};
+
+TEST_F(ReplicatedStoreClientTest, AsyncPutAndAsyncGetTest) { TestAsyncPutAndAsyncGet(); }
+
+TEST_F(ReplicatedStoreClientTest, AsyncPutAndDeleteWithIndexTest) {
+  TestAsyncPutAndDeleteWithIndex();
+}
+
+TEST_F(ReplicatedStoreClientTest, AsyncGetAllAndBatchDeleteTest) {
+  TestAsyncGetAllAndBatchDelete();
+}
+
+TEST_F(ReplicatedStoreClientTest, TestAsyncDeleteWithIndex) {
+  TestAsyncDeleteWithIndex();
+}
+
+TEST_F(ReplicatedStoreClientTest, TestAsyncBatchDeleteWithIndex) {
+  TestAsyncBatchDeleteWithIndex();
+}
+
+TEST_F(ReplicatedStoreClientTest, TestWritesAreStreamedToReplica) {
+  Put();
+  OnReplica([this] { Get(); });
+  BatchDelete();
+  OnReplica([this] { GetEmpty(); });
+
+  PutWithIndex();
+  OnReplica([this] { GetByIndex(); });
+  DeleteByIndex();
+  OnReplica([this] { GetEmpty(); });
+}
+
+TEST_F(ReplicatedStoreClientTest, TestRemovedReplicaStopsReceivingWrites) {
+  replicated_store_client_->RemoveReplica(replica_);
+  Put();
+  OnReplica([this] { GetEmpty(); });
+}
+
+TEST_F(ReplicatedStoreClientTest, TestWritesDuringSnapshotAreBuffered) {
+  replicated_store_client_->RemoveReplica(replica_);
+  replica_ = std::make_shared<InMemoryStoreClient>(*(io_service_pool_->Get()));
+  StatusCallback snapshot_done;
+  bool seeded = false;
+  replicated_store_client_->AddReplica(
+      replica_, [&snapshot_done](const StatusCallback &done) { snapshot_done = done; },
+      [&seeded](const Status &status) {
+        RAY_CHECK_OK(status);
+        seeded = true;
+      });
+
+  // Writes acknowledged while the snapshot is copied are held back.
+  Put();
+  OnReplica([this] { GetEmpty(); });
+  ASSERT_FALSE(seeded);
+
+  // And applied once it has been copied.
+  snapshot_done(Status::OK());
+  ASSERT_TRUE(seeded);
+  OnReplica([this] { Get(); });
+}
+
+}  // namespace gcs
+
+}  // namespace ray
+
+int main(int argc, char **argv) {
+  ::testing::InitGoogleTest(&argc, argv);
+  return RUN_ALL_TESTS();
+}
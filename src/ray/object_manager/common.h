@@ -16,6 +16,17 @@ using SpillObjectsCallback = std::function<bool()>;
 /// A callback to call when space has been released.
 using SpaceReleasedCallback = std::function<void()>;
 
+/// The priority of a bundle of objects to pull. When there isn't enough memory to pull
+/// all bundles at once, the bundles with a smaller priority value are pulled first.
+enum class BundlePriority {
+  /// A worker is blocked in ray.get on the objects.
+  GET_REQUEST = 0,
+  /// The arguments of a queued task.
+  TASK_ARGS = 1,
+  /// A worker called ray.wait on the objects.
+  WAIT_REQUEST = 2,
+};
+
 /// A callback to call when a spilled object needs to be returned to the object store.
 using RestoreSpilledObjectCallback = std::function<void(
     const ObjectID &, const std::string &, std::function<void(const ray::Status &)>)>;
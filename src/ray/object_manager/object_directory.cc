@@ -126,7 +126,7 @@ void ObjectDirectory::HandleNodeRemoved(const NodeID &node_id) {
         // It is safe to call the callback directly since this is already running
         // in the subscription callback stack.
         callback_pair.second(object_id, listener.second.current_object_locations,
-                             listener.second.spilled_url);
+                             listener.second.spilled_url, listener.second.object_size);
       }
     }
   }
@@ -171,7 +171,7 @@ ray::Status ObjectDirectory::SubscribeObjectLocations(const UniqueID &callback_i
             // It is safe to call the callback directly since this is already running
             // in the subscription callback stack.
             callback_pair.second(object_id, it->second.current_object_locations,
-                                 it->second.spilled_url);
+                                 it->second.spilled_url, it->second.object_size);
           }
         };
     status = gcs_client_->Objects().AsyncSubscribeToLocations(
@@ -189,8 +189,9 @@ ray::Status ObjectDirectory::SubscribeObjectLocations(const UniqueID &callback_i
   if (listener_state.subscribed) {
     auto &locations = listener_state.current_object_locations;
     auto &spilled_url = listener_state.spilled_url;
-    io_service_.post([callback, locations, spilled_url, object_id]() {
-      callback(object_id, locations, spilled_url);
+    auto object_size = listener_state.object_size;
+    io_service_.post([callback, locations, spilled_url, object_size, object_id]() {
+      callback(object_id, locations, spilled_url, object_size);
     });
   }
   return status;
@@ -223,8 +224,9 @@ ray::Status ObjectDirectory::LookupLocations(const ObjectID &object_id,
     // cached locations.
     auto &locations = it->second.current_object_locations;
     auto &spilled_url = it->second.spilled_url;
-    io_service_.post([callback, object_id, spilled_url, locations]() {
-      callback(object_id, locations, spilled_url);
+    auto object_size = it->second.object_size;
+    io_service_.post([callback, object_id, spilled_url, locations, object_size]() {
+      callback(object_id, locations, spilled_url, object_size);
     });
   } else {
     // We do not have any locations cached due to a concurrent
@@ -255,7 +257,7 @@ ray::Status ObjectDirectory::LookupLocations(const ObjectID &object_id,
           UpdateObjectLocations(notification, gcs_client_, &node_ids, &spilled_url);
           // It is safe to call the callback directly since this is already running
           // in the GCS client's lookup callback stack.
-          callback(object_id, node_ids, spilled_url);
+          callback(object_id, node_ids, spilled_url, /*object_size=*/0);
         });
   }
   return status;
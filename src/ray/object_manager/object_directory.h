@@ -40,10 +40,10 @@ struct RemoteConnectionInfo {
   uint16_t port;
 };
 
-/// Callback for object location notifications.
-using OnLocationsFound =
-    std::function<void(const ray::ObjectID &object_id,
-                       const std::unordered_set<ray::NodeID> &, const std::string &)>;
+/// Callback for object location notifications. The object size is 0 if unknown.
+using OnLocationsFound = std::function<void(
+    const ray::ObjectID &object_id, const std::unordered_set<ray::NodeID> &,
+    const std::string &spilled_url, size_t object_size)>;
 
 class ObjectDirectoryInterface {
  public:
@@ -185,6 +185,8 @@ class ObjectDirectory : public ObjectDirectoryInterface {
     std::unordered_set<NodeID> current_object_locations;
     /// The location where this object has been spilled, if any.
     std::string spilled_url = "";
+    /// The size of the object, or 0 if unknown.
+    size_t object_size = 0;
     /// This flag will get set to true if received any notification of the object.
     /// It means current_object_locations is up-to-date with GCS. It
     /// should never go back to false once set to true. If this is true, and
@@ -157,6 +157,8 @@ void ObjectManager::HandleObjectAdded(
   used_memory_ += object_info.data_size + object_info.metadata_size;
   ray::Status status =
       object_directory_->ReportObjectAdded(object_id, self_node_id_, object_info);
+  pull_manager_->OnLocalObjectChange(object_id);
+  UpdatePullsBasedOnAvailableMemory();
 
   // Handle the unfulfilled_push_requests_ which contains the push request that is not
   // completed due to unsatisfied local objects.
@@ -183,6 +185,20 @@ void ObjectManager::NotifyDirectoryObjectDeleted(const ObjectID &object_id) {
   RAY_CHECK(!local_objects_.empty() || used_memory_ == 0);
   ray::Status status =
       object_directory_->ReportObjectRemoved(object_id, self_node_id_, object_info);
+  pull_manager_->OnLocalObjectChange(object_id);
+  UpdatePullsBasedOnAvailableMemory();
+}
+
+void ObjectManager::UpdatePullsBasedOnAvailableMemory() {
+  if (plasma::plasma_store_runner == nullptr) {
+    // The object store doesn't run in this process, so its free memory is unknown
+    // and the pulls aren't bounded.
+    return;
+  }
+  // Ask the store rather than use used_memory_, which also counts the secondary
+  // copies that the store would evict to make room.
+  pull_manager_->UpdatePullsBasedOnAvailableMemory(
+      plasma::plasma_store_runner->GetAvailableMemory());
 }
 
 ray::Status ObjectManager::SubscribeObjAdded(
@@ -197,14 +213,15 @@ ray::Status ObjectManager::SubscribeObjDeleted(
   return ray::Status::OK();
 }
 
-uint64_t ObjectManager::Pull(const std::vector<rpc::ObjectReference> &object_refs) {
+uint64_t ObjectManager::Pull(const std::vector<rpc::ObjectReference> &object_refs,
+                             BundlePriority priority) {
   std::vector<rpc::ObjectReference> objects_to_locate;
-  auto request_id = pull_manager_->Pull(object_refs, &objects_to_locate);
+  auto request_id = pull_manager_->Pull(object_refs, priority, &objects_to_locate);
 
   const auto &callback = [this](const ObjectID &object_id,
                                 const std::unordered_set<NodeID> &client_ids,
-                                const std::string &spilled_url) {
-    pull_manager_->OnLocationChange(object_id, client_ids, spilled_url);
+                                const std::string &spilled_url, size_t object_size) {
+    pull_manager_->OnLocationChange(object_id, client_ids, spilled_url, object_size);
   };
 
   for (const auto &ref : objects_to_locate) {
@@ -496,7 +513,7 @@ ray::Status ObjectManager::LookupRemainingWaitObjects(const UniqueID &wait_id) {
           object_id, wait_state.owner_addresses[object_id],
           [this, wait_id](const ObjectID &lookup_object_id,
                           const std::unordered_set<NodeID> &node_ids,
-                          const std::string &spilled_url) {
+                          const std::string &spilled_url, size_t object_size) {
             auto &wait_state = active_wait_requests_.find(wait_id)->second;
             // Note that the object is guaranteed to be added to local_objects_ before
             // the notification is triggered.
@@ -537,7 +554,7 @@ void ObjectManager::SubscribeRemainingWaitObjects(const UniqueID &wait_id) {
           wait_id, object_id, wait_state.owner_addresses[object_id],
           [this, wait_id](const ObjectID &subscribe_object_id,
                           const std::unordered_set<NodeID> &node_ids,
-                          const std::string &spilled_url) {
+                          const std::string &spilled_url, size_t object_size) {
             auto object_id_wait_state = active_wait_requests_.find(wait_id);
             if (object_id_wait_state == active_wait_requests_.end()) {
               // Depending on the timing of calls to the object directory, we
@@ -636,6 +653,15 @@ void ObjectManager::HandlePush(const rpc::PushRequest &request, rpc::PushReply *
   const rpc::Address &owner_address = request.owner_address();
   const std::string &data = request.data();
 
+  if (chunk_index == 0) {
+    // The object directory may not know the size of the object, so tell the pull
+    // manager from the object info of the first chunk.
+    const size_t object_size = data_size + metadata_size;
+    main_service_->post([this, object_id, object_size]() {
+      pull_manager_->OnObjectSizeKnown(object_id, object_size);
+    });
+  }
+
   double start_time = absl::GetCurrentTimeNanos() / 1e9;
   auto status = ReceiveObjectChunk(node_id, object_id, owner_address, data_size,
                                    metadata_size, chunk_index, data);
@@ -793,6 +819,7 @@ std::string ObjectManager::DebugString() const {
   result << "\n- num buffered profile events: " << profile_events_.size();
   result << "\n- num chunks received total: " << num_chunks_received_total_;
   result << "\n- num chunks received failed: " << num_chunks_received_failed_;
+  result << "\n" << pull_manager_->DebugString();
   result << "\n" << push_manager_->DebugString();
   result << "\n" << object_directory_->DebugString();
   result << "\n" << store_notification_->DebugString();
@@ -820,6 +847,9 @@ void ObjectManager::Tick(const boost::system::error_code &e) {
                    "https://github.com/ray-project/ray/issues";
 
   pull_manager_->Tick();
+  // Objects become evictable without notifications when their clients release them,
+  // so refresh the free memory periodically too.
+  UpdatePullsBasedOnAvailableMemory();
 
   auto interval = boost::posix_time::milliseconds(config_.timer_freq_ms);
   pull_retry_timer_.expires_from_now(interval);
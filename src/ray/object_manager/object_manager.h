@@ -97,7 +97,8 @@ class ObjectStoreRunner {
 
 class ObjectManagerInterface {
  public:
-  virtual uint64_t Pull(const std::vector<rpc::ObjectReference> &object_refs) = 0;
+  virtual uint64_t Pull(const std::vector<rpc::ObjectReference> &object_refs,
+                        BundlePriority priority) = 0;
   virtual void CancelPull(uint64_t request_id) = 0;
   virtual ~ObjectManagerInterface(){};
 };
@@ -243,8 +244,11 @@ class ObjectManager : public ObjectManagerInterface,
   /// bundle local until the request is canceled with the returned ID.
   ///
   /// \param object_refs The bundle of objects that must be made local.
+  /// \param priority The priority of the bundle. Bundles of higher priority are
+  /// pulled first when the object store can't fit all of them.
   /// \return A request ID that can be used to cancel the request.
-  uint64_t Pull(const std::vector<rpc::ObjectReference> &object_refs) override;
+  uint64_t Pull(const std::vector<rpc::ObjectReference> &object_refs,
+                BundlePriority priority) override;
 
   /// Cancels the pull request with the given ID. This cancels any fetches for
   /// objects that were passed to the original pull request, if no other pull
@@ -366,6 +370,9 @@ class ObjectManager : public ObjectManagerInterface,
   /// Register object remove with directory.
   void NotifyDirectoryObjectDeleted(const ObjectID &object_id);
 
+  /// Bound the bytes being pulled by the free memory of the object store.
+  void UpdatePullsBasedOnAvailableMemory();
+
   /// This is used to notify the main thread that the sending of a chunk has
   /// completed.
   ///
@@ -14,11 +14,23 @@
 
 #include "ray/object_manager/ownership_based_object_directory.h"
 
+#include <tuple>
+
 namespace ray {
 
 OwnershipBasedObjectDirectory::OwnershipBasedObjectDirectory(
-    boost::asio::io_service &io_service, std::shared_ptr<gcs::GcsClient> &gcs_client)
-    : ObjectDirectory(io_service, gcs_client), client_call_manager_(io_service) {}
+    boost::asio::io_service &io_service, std::shared_ptr<gcs::GcsClient> &gcs_client,
+    const NodeID &self_node_id, rpc::ClientFactoryFn client_factory)
+    : ObjectDirectory(io_service, gcs_client),
+      client_call_manager_(io_service),
+      client_factory_(client_factory),
+      self_node_id_(self_node_id) {
+  if (client_factory_ == nullptr) {
+    client_factory_ = [this](const rpc::Address &address) {
+      return std::make_shared<rpc::CoreWorkerClient>(address, client_call_manager_);
+    };
+  }
+}
 
 namespace {
 
@@ -46,8 +58,8 @@ rpc::Address GetOwnerAddressFromObjectInfo(
 
 }  // namespace
 
-std::shared_ptr<rpc::CoreWorkerClient> OwnershipBasedObjectDirectory::GetClient(
-    const rpc::Address &owner_address) {
+std::shared_ptr<rpc::CoreWorkerClientInterface>
+OwnershipBasedObjectDirectory::GetClient(const rpc::Address &owner_address) {
   WorkerID worker_id = WorkerID::FromBinary(owner_address.worker_id());
   if (worker_id.IsNil()) {
     // If an object does not have owner, return nullptr.
@@ -55,10 +67,7 @@ std::shared_ptr<rpc::CoreWorkerClient> OwnershipBasedObjectDirectory::GetClient(
   }
   auto it = worker_rpc_clients_.find(worker_id);
   if (it == worker_rpc_clients_.end()) {
-    it = worker_rpc_clients_
-             .emplace(worker_id, std::make_shared<rpc::CoreWorkerClient>(
-                                     owner_address, client_call_manager_))
-             .first;
+    it = worker_rpc_clients_.emplace(worker_id, client_factory_(owner_address)).first;
   }
   return it->second;
 }
@@ -68,7 +77,7 @@ ray::Status OwnershipBasedObjectDirectory::ReportObjectAdded(
     const object_manager::protocol::ObjectInfoT &object_info) {
   WorkerID worker_id = WorkerID::FromBinary(object_info.owner_worker_id);
   rpc::Address owner_address = GetOwnerAddressFromObjectInfo(object_info);
-  std::shared_ptr<rpc::CoreWorkerClient> rpc_client = GetClient(owner_address);
+  auto rpc_client = GetClient(owner_address);
   if (rpc_client == nullptr) {
     RAY_LOG(WARNING) << "Object " << object_id << " does not have owner. "
                      << "ReportObjectAdded becomes a no-op.";
@@ -95,7 +104,7 @@ ray::Status OwnershipBasedObjectDirectory::ReportObjectRemoved(
     const object_manager::protocol::ObjectInfoT &object_info) {
   WorkerID worker_id = WorkerID::FromBinary(object_info.owner_worker_id);
   rpc::Address owner_address = GetOwnerAddressFromObjectInfo(object_info);
-  std::shared_ptr<rpc::CoreWorkerClient> rpc_client = GetClient(owner_address);
+  auto rpc_client = GetClient(owner_address);
   if (rpc_client == nullptr) {
     RAY_LOG(WARNING) << "Object " << object_id << " does not have owner. "
                      << "ReportObjectRemoved becomes a no-op.";
@@ -118,42 +127,133 @@ ray::Status OwnershipBasedObjectDirectory::ReportObjectRemoved(
   return Status::OK();
 };
 
-void OwnershipBasedObjectDirectory::SubscriptionCallback(
-    ObjectID object_id, WorkerID worker_id, Status status,
-    const rpc::GetObjectLocationsOwnerReply &reply) {
-  auto it = listeners_.find(object_id);
-  if (it == listeners_.end()) {
+void OwnershipBasedObjectDirectory::SchedulePoll(const WorkerID &worker_id,
+                                                 OwnerSubscriptions *subscriptions) {
+  if (!subscriptions->poll_scheduled) {
+    subscriptions->poll_scheduled = true;
+    io_service_.post([this, worker_id]() { SendPoll(worker_id); });
+  }
+}
+
+void OwnershipBasedObjectDirectory::SendPoll(const WorkerID &worker_id) {
+  auto it = owner_subscriptions_.find(worker_id);
+  if (it == owner_subscriptions_.end()) {
+    return;
+  }
+  auto &subscriptions = it->second;
+  subscriptions.poll_scheduled = false;
+  if (subscriptions.object_ids.empty() && subscriptions.pending_unsubscribe_ids.empty()) {
+    // The objects were unsubscribed before the owner was told about them.
+    owner_subscriptions_.erase(it);
     return;
   }
+  rpc::GetObjectLocationsUpdatesRequest request;
+  request.set_intended_worker_id(worker_id.Binary());
+  request.set_subscriber_node_id(self_node_id_.Binary());
+  for (const auto &object_id : subscriptions.pending_subscribe_ids) {
+    request.add_subscribe_object_ids(object_id.Binary());
+  }
+  for (const auto &object_id : subscriptions.pending_unsubscribe_ids) {
+    request.add_unsubscribe_object_ids(object_id.Binary());
+  }
+  subscriptions.pending_subscribe_ids.clear();
+  subscriptions.pending_unsubscribe_ids.clear();
+  const int64_t poll_id = ++last_poll_id_;
+  subscriptions.poll_id = poll_id;
+  auto rpc_client = GetClient(subscriptions.owner_address);
+  if (subscriptions.object_ids.empty()) {
+    // The owner replies right away once all objects are unsubscribed.
+    owner_subscriptions_.erase(it);
+  }
+  rpc_client->GetObjectLocationsUpdates(
+      request, [this, worker_id, poll_id](
+                   Status status, const rpc::GetObjectLocationsUpdatesReply &reply) {
+        HandleLocationsUpdates(worker_id, poll_id, status, reply);
+      });
+}
 
-  std::unordered_set<NodeID> node_ids;
-  for (auto const &node_id : reply.node_ids()) {
-    node_ids.emplace(NodeID::FromBinary(node_id));
-  }
-  FilterRemovedNodes(gcs_client_, &node_ids);
-  if (node_ids != it->second.current_object_locations) {
-    it->second.current_object_locations = std::move(node_ids);
-    auto callbacks = it->second.callbacks;
-    // Call all callbacks associated with the object id locations we have
-    // received.  This notifies the client even if the list of locations is
-    // empty, since this may indicate that the objects have been evicted from
-    // all nodes.
-    for (const auto &callback_pair : callbacks) {
-      // It is safe to call the callback directly since this is already running
-      // in the subscription callback stack.
-      callback_pair.second(object_id, it->second.current_object_locations, "");
+void OwnershipBasedObjectDirectory::HandleLocationsUpdates(
+    const WorkerID &worker_id, int64_t poll_id, const Status &status,
+    const rpc::GetObjectLocationsUpdatesReply &reply) {
+  auto it = owner_subscriptions_.find(worker_id);
+  if (it == owner_subscriptions_.end()) {
+    return;
+  }
+  auto &subscriptions = it->second;
+  std::vector<std::tuple<ObjectID, std::unordered_set<NodeID>, size_t>> updates;
+  if (!status.ok()) {
+    if (poll_id != subscriptions.poll_id) {
+      return;
+    }
+    // The owner is unreachable, so the objects are treated as lost.
+    RAY_LOG(WARNING) << "Worker " << worker_id
+                     << " failed to send object location updates: " << status;
+    for (const auto &object_id : subscriptions.object_ids) {
+      updates.emplace_back(object_id, std::unordered_set<NodeID>(), 0);
+    }
+    owner_subscriptions_.erase(it);
+  } else {
+    for (const auto &update : reply.updates()) {
+      const auto object_id = ObjectID::FromBinary(update.object_id());
+      if (!subscriptions.object_ids.contains(object_id)) {
+        // The update raced with an unsubscription.
+        continue;
+      }
+      if (update.object_not_found() &&
+          !subscriptions.pending_subscribe_ids.contains(object_id)) {
+        // The owner dropped the subscription.
+        subscriptions.object_ids.erase(object_id);
+      }
+      std::unordered_set<NodeID> node_ids;
+      for (const auto &node_id : update.node_ids()) {
+        node_ids.emplace(NodeID::FromBinary(node_id));
+      }
+      FilterRemovedNodes(gcs_client_, &node_ids);
+      updates.emplace_back(object_id, std::move(node_ids), update.object_size());
+    }
+    if (poll_id == subscriptions.poll_id && !subscriptions.poll_scheduled) {
+      // Poll for the next updates. Replies to older polls carry updates, but don't
+      // restart the poll, so that only one poll is outstanding.
+      if (subscriptions.object_ids.empty()) {
+        owner_subscriptions_.erase(it);
+      } else {
+        SendPoll(worker_id);
+      }
     }
   }
 
-  auto worker_it = worker_rpc_clients_.find(worker_id);
-  rpc::GetObjectLocationsOwnerRequest request;
-  request.set_intended_worker_id(worker_id.Binary());
-  request.set_object_id(object_id.Binary());
-  // TODO(zhuohan): Fix this infinite loop.
-  worker_it->second->GetObjectLocationsOwner(
-      request,
-      std::bind(&OwnershipBasedObjectDirectory::SubscriptionCallback, this, object_id,
-                worker_id, std::placeholders::_1, std::placeholders::_2));
+  // Notify the listeners last, since they may change the subscriptions.
+  for (auto &update : updates) {
+    UpdateObjectLocations(std::get<0>(update), std::move(std::get<1>(update)),
+                          std::get<2>(update));
+  }
+}
+
+void OwnershipBasedObjectDirectory::UpdateObjectLocations(
+    const ObjectID &object_id, std::unordered_set<NodeID> node_ids, size_t object_size) {
+  auto it = listeners_.find(object_id);
+  if (it == listeners_.end()) {
+    return;
+  }
+  if (object_size > 0 && object_size != it->second.object_size) {
+    it->second.object_size = object_size;
+  } else if (it->second.subscribed &&
+             node_ids == it->second.current_object_locations) {
+    return;
+  }
+  it->second.subscribed = true;
+  it->second.current_object_locations = std::move(node_ids);
+  auto callbacks = it->second.callbacks;
+  // Call all callbacks associated with the object id locations we have
+  // received.  This notifies the client even if the list of locations is
+  // empty, since this may indicate that the objects have been evicted from
+  // all nodes.
+  for (const auto &callback_pair : callbacks) {
+    // It is safe to call the callback directly since this is already running
+    // in the subscription callback stack.
+    callback_pair.second(object_id, it->second.current_object_locations, "",
+                         it->second.object_size);
+  }
 }
 
 ray::Status OwnershipBasedObjectDirectory::SubscribeObjectLocations(
@@ -162,19 +262,20 @@ ray::Status OwnershipBasedObjectDirectory::SubscribeObjectLocations(
   auto it = listeners_.find(object_id);
   if (it == listeners_.end()) {
     WorkerID worker_id = WorkerID::FromBinary(owner_address.worker_id());
-    std::shared_ptr<rpc::CoreWorkerClient> rpc_client = GetClient(owner_address);
+    auto rpc_client = GetClient(owner_address);
     if (rpc_client == nullptr) {
       RAY_LOG(WARNING) << "Object " << object_id << " does not have owner. "
                        << "SubscribeObjectLocations becomes a no-op.";
       return Status::OK();
     }
-    rpc::GetObjectLocationsOwnerRequest request;
-    request.set_intended_worker_id(owner_address.worker_id());
-    request.set_object_id(object_id.Binary());
-    rpc_client->GetObjectLocationsOwner(
-        request,
-        std::bind(&OwnershipBasedObjectDirectory::SubscriptionCallback, this, object_id,
-                  worker_id, std::placeholders::_1, std::placeholders::_2));
+    auto &subscriptions = owner_subscriptions_[worker_id];
+    subscriptions.owner_address = owner_address;
+    subscriptions.object_ids.insert(object_id);
+    // If an unsubscription is still pending, it is sent first, so that the owner
+    // sends the current locations again.
+    subscriptions.pending_subscribe_ids.insert(object_id);
+    SchedulePoll(worker_id, &subscriptions);
+    listener_owners_[object_id] = worker_id;
     it = listeners_.emplace(object_id, LocationListenerState()).first;
   }
   auto &listener_state = it->second;
@@ -195,6 +296,17 @@ ray::Status OwnershipBasedObjectDirectory::UnsubscribeObjectLocations(
   entry->second.callbacks.erase(callback_id);
   if (entry->second.callbacks.empty()) {
     listeners_.erase(entry);
+    auto owner_it = listener_owners_.find(object_id);
+    const auto worker_id = owner_it->second;
+    listener_owners_.erase(owner_it);
+    auto it = owner_subscriptions_.find(worker_id);
+    if (it != owner_subscriptions_.end() && it->second.object_ids.erase(object_id)) {
+      auto &subscriptions = it->second;
+      if (!subscriptions.pending_subscribe_ids.erase(object_id)) {
+        subscriptions.pending_unsubscribe_ids.insert(object_id);
+      }
+      SchedulePoll(worker_id, &subscriptions);
+    }
   }
   return Status::OK();
 }
@@ -203,12 +315,12 @@ ray::Status OwnershipBasedObjectDirectory::LookupLocations(
     const ObjectID &object_id, const rpc::Address &owner_address,
     const OnLocationsFound &callback) {
   WorkerID worker_id = WorkerID::FromBinary(owner_address.worker_id());
-  std::shared_ptr<rpc::CoreWorkerClient> rpc_client = GetClient(owner_address);
+  auto rpc_client = GetClient(owner_address);
   if (rpc_client == nullptr) {
     RAY_LOG(WARNING) << "Object " << object_id << " does not have owner. "
                      << "LookupLocations returns an empty list of locations.";
     io_service_.post([callback, object_id]() {
-      callback(object_id, std::unordered_set<NodeID>(), "");
+      callback(object_id, std::unordered_set<NodeID>(), "", 0);
     });
     return Status::OK();
   }
@@ -229,15 +341,31 @@ ray::Status OwnershipBasedObjectDirectory::LookupLocations(
           node_ids.emplace(NodeID::FromBinary(node_id));
         }
         FilterRemovedNodes(gcs_client_, &node_ids);
-        callback(object_id, node_ids, "");
+        callback(object_id, node_ids, "", reply.object_size());
       });
   return Status::OK();
 }
 
+void OwnershipBasedObjectDirectory::HandleNodeRemoved(const NodeID &node_id) {
+  std::vector<std::pair<ObjectID, std::unordered_set<NodeID>>> updates;
+  for (const auto &listener : listeners_) {
+    if (listener.second.current_object_locations.count(node_id) > 0) {
+      auto node_ids = listener.second.current_object_locations;
+      node_ids.erase(node_id);
+      updates.emplace_back(listener.first, std::move(node_ids));
+    }
+  }
+  // Notify the listeners after iterating, since they may change the subscriptions.
+  for (auto &update : updates) {
+    UpdateObjectLocations(update.first, std::move(update.second), 0);
+  }
+}
+
 std::string OwnershipBasedObjectDirectory::DebugString() const {
   std::stringstream result;
   result << "OwnershipBasedObjectDirectory:";
   result << "\n- num listeners: " << listeners_.size();
+  result << "\n- num owners subscribed to: " << owner_subscriptions_.size();
   return result.str();
 }
 
@@ -21,6 +21,7 @@
 #include <vector>
 
 #include "absl/container/flat_hash_map.h"
+#include "absl/container/flat_hash_set.h"
 #include "ray/common/id.h"
 #include "ray/common/status.h"
 #include "ray/gcs/gcs_client.h"
@@ -39,8 +40,14 @@ class OwnershipBasedObjectDirectory : public ObjectDirectory {
   /// usually be the same event loop that the given gcs_client runs on.
   /// \param gcs_client A Ray GCS client to request object and node
   /// information from.
+  /// \param self_node_id The ID of this node, which identifies its subscriptions
+  /// to the owners.
+  /// \param client_factory Creates the RPC clients to the owners. If null, the
+  /// clients are created with the directory's own client call manager.
   OwnershipBasedObjectDirectory(boost::asio::io_service &io_service,
-                                std::shared_ptr<gcs::GcsClient> &gcs_client);
+                                std::shared_ptr<gcs::GcsClient> &gcs_client,
+                                const NodeID &self_node_id,
+                                rpc::ClientFactoryFn client_factory = nullptr);
 
   virtual ~OwnershipBasedObjectDirectory() {}
 
@@ -62,6 +69,11 @@ class OwnershipBasedObjectDirectory : public ObjectDirectory {
       const ObjectID &object_id, const NodeID &node_id,
       const object_manager::protocol::ObjectInfoT &object_info) override;
 
+  /// Remove a node from the locations of the subscribed objects and notify their
+  /// listeners. The owners keep the locations on a removed node until they learn
+  /// that it was removed themselves, so the locations are filtered here too.
+  void HandleNodeRemoved(const NodeID &node_id) override;
+
   std::string DebugString() const override;
 
   /// OwnershipBasedObjectDirectory should not be copied.
@@ -70,19 +82,59 @@ class OwnershipBasedObjectDirectory : public ObjectDirectory {
  private:
   /// The client call manager used to create the RPC clients.
   rpc::ClientCallManager client_call_manager_;
+  /// Creates the RPC clients to the owners.
+  rpc::ClientFactoryFn client_factory_;
   /// Cache of gRPC clients to workers (not necessarily running on this node).
   /// Also includes the number of inflight requests to each worker - when this
   /// reaches zero, the client will be deleted and a new one will need to be created
   /// for any subsequent requests.
-  absl::flat_hash_map<WorkerID, std::shared_ptr<rpc::CoreWorkerClient>>
+  absl::flat_hash_map<WorkerID, std::shared_ptr<rpc::CoreWorkerClientInterface>>
       worker_rpc_clients_;
 
   /// Get or create the rpc client in the worker_rpc_clients.
-  std::shared_ptr<rpc::CoreWorkerClient> GetClient(const rpc::Address &owner_address);
+  std::shared_ptr<rpc::CoreWorkerClientInterface> GetClient(
+      const rpc::Address &owner_address);
+
+  /// The location subscriptions to the objects of one owner. All subscriptions to
+  /// an owner share a single GetObjectLocationsUpdates long poll, which also carries
+  /// the subscription changes.
+  struct OwnerSubscriptions {
+    rpc::Address owner_address;
+    /// The objects that the owner sends location updates for.
+    absl::flat_hash_set<ObjectID> object_ids;
+    /// The subscription changes that haven't been sent to the owner yet.
+    absl::flat_hash_set<ObjectID> pending_subscribe_ids;
+    absl::flat_hash_set<ObjectID> pending_unsubscribe_ids;
+    /// The ID of the latest poll. Only its reply starts the next poll.
+    int64_t poll_id = 0;
+    /// Whether a call to SendPoll is queued on the event loop.
+    bool poll_scheduled = false;
+  };
+
+  /// Queue a poll to send the subscription changes of an owner. The changes made
+  /// while the current handler runs are sent together.
+  void SchedulePoll(const WorkerID &worker_id, OwnerSubscriptions *subscriptions);
+
+  /// Send a long poll with the pending subscription changes to an owner.
+  void SendPoll(const WorkerID &worker_id);
+
+  /// Handle the reply to a long poll, i.e., location updates from an owner.
+  void HandleLocationsUpdates(const WorkerID &worker_id, int64_t poll_id,
+                              const Status &status,
+                              const rpc::GetObjectLocationsUpdatesReply &reply);
+
+  /// Record the locations of an object and notify its listeners if they changed.
+  void UpdateObjectLocations(const ObjectID &object_id,
+                             std::unordered_set<NodeID> node_ids, size_t object_size);
 
-  /// Internal callback function used by SubscribeObjectLocations.
-  void SubscriptionCallback(ObjectID object_id, WorkerID worker_id, Status status,
-                            const rpc::GetObjectLocationsOwnerReply &reply);
+  /// The ID of this node.
+  const NodeID self_node_id_;
+  /// The location subscriptions, by owner.
+  absl::flat_hash_map<WorkerID, OwnerSubscriptions> owner_subscriptions_;
+  /// The owner of each object in listeners_.
+  absl::flat_hash_map<ObjectID, WorkerID> listener_owners_;
+  /// The ID of the last poll sent to any owner.
+  int64_t last_poll_id_ = 0;
 };
 
 }  // namespace ray
@@ -58,6 +58,8 @@ int64_t LRUCache::OriginalCapacity() const { return original_capacity_; }
 
 int64_t LRUCache::RemainingCapacity() const { return capacity_ - used_capacity_; }
 
+int64_t LRUCache::UsedCapacity() const { return used_capacity_; }
+
 void LRUCache::Foreach(std::function<void(const ObjectID &)> f) {
   for (auto &pair : item_list_) {
     f(pair.first);
@@ -171,6 +173,8 @@ int64_t EvictionPolicy::GetObjectSize(const ObjectID &object_id) const {
   return entry->data_size + entry->metadata_size;
 }
 
+int64_t EvictionPolicy::GetEvictableBytes() const { return cache_.UsedCapacity(); }
+
 std::string EvictionPolicy::DebugString() const { return cache_.DebugString(); }
 
 }  // namespace plasma
@@ -62,6 +62,8 @@ class LRUCache {
 
   int64_t RemainingCapacity() const;
 
+  int64_t UsedCapacity() const;
+
   void AdjustCapacity(int64_t delta);
 
   void Foreach(std::function<void(const ObjectID &)>);
@@ -193,6 +195,9 @@ class EvictionPolicy {
 
   virtual void RefreshObjects(const std::vector<ObjectID> &object_ids);
 
+  /// Returns the number of bytes of the objects that can be evicted.
+  int64_t GetEvictableBytes() const;
+
   /// Returns debugging information for this eviction policy.
   virtual std::string DebugString() const;
 
@@ -1024,4 +1024,10 @@ bool PlasmaStore::IsObjectSpillable(const ObjectID &object_id) {
   return entry->ref_count == 1;
 }
 
+int64_t PlasmaStore::GetAvailableMemory() {
+  std::lock_guard<std::recursive_mutex> guard(mutex_);
+  return PlasmaAllocator::GetFootprintLimit() - PlasmaAllocator::Allocated() +
+         eviction_policy_.GetEvictableBytes();
+}
+
 }  // namespace plasma
@@ -189,6 +189,11 @@ class PlasmaStore {
   /// before the object is pinned by raylet for the first time.
   bool IsObjectSpillable(const ObjectID &object_id);
 
+  /// Return the number of bytes that objects can be created in without spilling,
+  /// i.e., the unallocated memory plus the memory of the objects that no client is
+  /// using and that can be evicted.
+  int64_t GetAvailableMemory();
+
   void SetNotificationListener(
       const std::shared_ptr<ray::ObjectStoreNotificationManager> &notification_listener) {
     notification_listener_ = notification_listener;
@@ -122,6 +122,15 @@ bool PlasmaStoreRunner::IsPlasmaObjectSpillable(const ObjectID &object_id) {
   return store_->IsObjectSpillable(object_id);
 }
 
+int64_t PlasmaStoreRunner::GetAvailableMemory() {
+  absl::MutexLock lock(&store_runner_mutex_);
+  if (store_ == nullptr) {
+    // The store hasn't started yet, so all of its memory is free.
+    return system_memory_;
+  }
+  return store_->GetAvailableMemory();
+}
+
 std::unique_ptr<PlasmaStoreRunner> plasma_store_runner;
 
 }  // namespace plasma
@@ -22,6 +22,7 @@ class PlasmaStoreRunner {
     store_->SetNotificationListener(notification_listener);
   }
   bool IsPlasmaObjectSpillable(const ObjectID &object_id);
+  int64_t GetAvailableMemory();
 
  private:
   void Shutdown();
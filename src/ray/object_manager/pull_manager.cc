@@ -15,12 +15,18 @@ PullManager::PullManager(
       restore_spilled_object_(restore_spilled_object),
       get_time_(get_time),
       pull_timeout_ms_(pull_timeout_ms),
+      bundle_queues_(static_cast<size_t>(BundlePriority::WAIT_REQUEST) + 1),
       gen_(std::chrono::high_resolution_clock::now().time_since_epoch().count()) {}
 
 uint64_t PullManager::Pull(const std::vector<rpc::ObjectReference> &object_ref_bundle,
+                           BundlePriority priority,
                            std::vector<rpc::ObjectReference> *objects_to_locate) {
-  auto bundle_it = pull_request_bundles_.emplace(next_req_id_++, object_ref_bundle).first;
-  RAY_LOG(DEBUG) << "Start pull request " << bundle_it->first;
+  auto bundle_it = pull_request_bundles_.emplace(next_req_id_++, BundlePullRequest())
+                       .first;
+  auto &bundle = bundle_it->second;
+  bundle.priority = priority;
+  RAY_LOG(DEBUG) << "Start pull request " << bundle_it->first << " with priority "
+                 << static_cast<int>(priority);
 
   for (const auto &ref : object_ref_bundle) {
     auto obj_id = ObjectRefToId(ref);
@@ -36,9 +42,13 @@ uint64_t PullManager::Pull(const std::vector<rpc::ObjectReference> &object_ref_b
                .emplace(obj_id, ObjectPullRequest(/*next_pull_time=*/get_time_()))
                .first;
     }
-    it->second.bundle_request_ids.insert(bundle_it->first);
+    if (it->second.bundle_request_ids.insert(bundle_it->first).second) {
+      bundle.object_ids.push_back(obj_id);
+    }
   }
 
+  bundle_queues_[static_cast<size_t>(priority)].request_ids.insert(bundle_it->first);
+  UpdatePulls();
   return bundle_it->first;
 }
 
@@ -47,9 +57,13 @@ std::vector<ObjectID> PullManager::CancelPull(uint64_t request_id) {
   RAY_LOG(DEBUG) << "Cancel pull request " << request_id;
   auto bundle_it = pull_request_bundles_.find(request_id);
   RAY_CHECK(bundle_it != pull_request_bundles_.end());
+  if (IsBundleActive(request_id)) {
+    DeactivateBundle(request_id);
+  }
+  bundle_queues_[static_cast<size_t>(bundle_it->second.priority)].request_ids.erase(
+      request_id);
 
-  for (const auto &ref : bundle_it->second) {
-    auto obj_id = ObjectRefToId(ref);
+  for (const auto &obj_id : bundle_it->second.object_ids) {
     auto it = object_pull_requests_.find(obj_id);
     RAY_CHECK(it != object_pull_requests_.end());
     RAY_CHECK(it->second.bundle_request_ids.erase(request_id));
@@ -60,12 +74,14 @@ std::vector<ObjectID> PullManager::CancelPull(uint64_t request_id) {
   }
 
   pull_request_bundles_.erase(bundle_it);
+  // The memory of the canceled bundle may fit other bundles.
+  UpdatePulls();
   return objects_to_cancel;
 }
 
 void PullManager::OnLocationChange(const ObjectID &object_id,
                                    const std::unordered_set<NodeID> &client_ids,
-                                   const std::string &spilled_url) {
+                                   const std::string &spilled_url, size_t object_size) {
   // Exit if the Pull request has already been fulfilled or canceled.
   auto it = object_pull_requests_.find(object_id);
   if (it == object_pull_requests_.end()) {
@@ -78,11 +94,136 @@ void PullManager::OnLocationChange(const ObjectID &object_id,
   it->second.client_locations = std::vector<NodeID>(client_ids.begin(), client_ids.end());
   it->second.spilled_url = spilled_url;
   RAY_LOG(DEBUG) << "OnLocationChange " << spilled_url << " num clients "
-                 << client_ids.size();
+                 << client_ids.size() << " object size " << object_size;
 
+  UpdateObjectSize(object_id, &it->second, object_size);
   TryToMakeObjectLocal(object_id);
 }
 
+void PullManager::OnObjectSizeKnown(const ObjectID &object_id, size_t object_size) {
+  auto it = object_pull_requests_.find(object_id);
+  if (it == object_pull_requests_.end()) {
+    return;
+  }
+  UpdateObjectSize(object_id, &it->second, object_size);
+}
+
+void PullManager::UpdateObjectSize(const ObjectID &object_id,
+                                   ObjectPullRequest *request, size_t object_size) {
+  if (object_size > 0 && object_size != request->object_size) {
+    request->object_size = object_size;
+    UpdateNumBytesBeingPulled(object_id, request);
+    // The object may not fit in the memory that its bundles were activated with.
+    UpdatePulls();
+  }
+}
+
+void PullManager::OnLocalObjectChange(const ObjectID &object_id) {
+  auto it = object_pull_requests_.find(object_id);
+  if (it != object_pull_requests_.end()) {
+    UpdateNumBytesBeingPulled(object_id, &it->second);
+  }
+}
+
+void PullManager::UpdatePullsBasedOnAvailableMemory(int64_t num_bytes_available) {
+  num_bytes_available_ = num_bytes_available;
+  UpdatePulls();
+}
+
+void PullManager::UpdatePulls() {
+  for (size_t priority = 0; priority < bundle_queues_.size(); priority++) {
+    auto &queue = bundle_queues_[priority];
+    auto it = queue.request_ids.upper_bound(queue.last_active_request_id);
+    while (it != queue.request_ids.end()) {
+      if (num_active_bundles_ > 0 &&
+          num_bytes_being_pulled_ + NumBytesToActivate(*it) > num_bytes_available_) {
+        if (DeactivateLowestPriorityBundle(static_cast<BundlePriority>(priority + 1))) {
+          continue;
+        }
+        // Bundles of lower priority wait until this one fits.
+        priority = bundle_queues_.size();
+        break;
+      }
+      ActivateBundle(*it);
+      queue.last_active_request_id = *it;
+      it++;
+    }
+  }
+
+  // The available memory shrank, e.g., because objects were created locally.
+  while (num_bytes_being_pulled_ > num_bytes_available_ && num_active_bundles_ > 1) {
+    RAY_CHECK(DeactivateLowestPriorityBundle(BundlePriority::GET_REQUEST));
+  }
+}
+
+void PullManager::ActivateBundle(uint64_t request_id) {
+  RAY_LOG(DEBUG) << "Activate pull request " << request_id;
+  num_active_bundles_++;
+  for (const auto &object_id : pull_request_bundles_.at(request_id).object_ids) {
+    auto &request = object_pull_requests_.at(object_id);
+    if (request.num_active_bundles++ == 0) {
+      UpdateNumBytesBeingPulled(object_id, &request);
+      TryToMakeObjectLocal(object_id);
+    }
+  }
+}
+
+void PullManager::DeactivateBundle(uint64_t request_id) {
+  RAY_LOG(DEBUG) << "Deactivate pull request " << request_id;
+  num_active_bundles_--;
+  for (const auto &object_id : pull_request_bundles_.at(request_id).object_ids) {
+    auto &request = object_pull_requests_.at(object_id);
+    if (--request.num_active_bundles == 0) {
+      UpdateNumBytesBeingPulled(object_id, &request);
+    }
+  }
+}
+
+bool PullManager::DeactivateLowestPriorityBundle(BundlePriority highest_priority) {
+  for (size_t priority = bundle_queues_.size();
+       priority-- > static_cast<size_t>(highest_priority);) {
+    auto &queue = bundle_queues_[priority];
+    auto it = queue.request_ids.upper_bound(queue.last_active_request_id);
+    if (it == queue.request_ids.begin()) {
+      continue;
+    }
+    const uint64_t request_id = *--it;
+    DeactivateBundle(request_id);
+    queue.last_active_request_id = it == queue.request_ids.begin() ? 0 : *--it;
+    return true;
+  }
+  return false;
+}
+
+int64_t PullManager::NumBytesToActivate(uint64_t request_id) const {
+  int64_t num_bytes = 0;
+  for (const auto &object_id : pull_request_bundles_.at(request_id).object_ids) {
+    const auto &request = object_pull_requests_.at(object_id);
+    if (request.num_active_bundles == 0 && !object_is_local_(object_id)) {
+      num_bytes += request.object_size;
+    }
+  }
+  return num_bytes;
+}
+
+void PullManager::UpdateNumBytesBeingPulled(const ObjectID &object_id,
+                                            ObjectPullRequest *request) {
+  const bool is_pulled =
+      request->num_active_bundles > 0 && !object_is_local_(object_id);
+  const int64_t num_bytes = is_pulled ? request->object_size : 0;
+  num_bytes_being_pulled_ += num_bytes - request->num_bytes_being_pulled;
+  request->num_bytes_being_pulled = num_bytes;
+}
+
+bool PullManager::IsBundleActive(uint64_t request_id) const {
+  auto it = pull_request_bundles_.find(request_id);
+  if (it == pull_request_bundles_.end()) {
+    return false;
+  }
+  return request_id <=
+         bundle_queues_[static_cast<size_t>(it->second.priority)].last_active_request_id;
+}
+
 void PullManager::TryToMakeObjectLocal(const ObjectID &object_id) {
   if (object_is_local_(object_id)) {
     return;
@@ -92,6 +233,10 @@ void PullManager::TryToMakeObjectLocal(const ObjectID &object_id) {
     return;
   }
   auto &request = it->second;
+  if (request.num_active_bundles == 0) {
+    // The object is pulled once there is memory for one of its bundles.
+    return;
+  }
   if (request.next_pull_time > get_time_()) {
     return;
   }
@@ -192,4 +337,15 @@ void PullManager::Tick() {
 
 int PullManager::NumActiveRequests() const { return object_pull_requests_.size(); }
 
+std::string PullManager::DebugString() const {
+  std::stringstream result;
+  result << "PullManager:";
+  result << "\n- num bundle requests: " << pull_request_bundles_.size();
+  result << "\n- num active bundle requests: " << num_active_bundles_;
+  result << "\n- num object pull requests: " << object_pull_requests_.size();
+  result << "\n- num bytes being pulled: " << num_bytes_being_pulled_;
+  result << "\n- num bytes available: " << num_bytes_available_;
+  return result.str();
+}
+
 }  // namespace ray
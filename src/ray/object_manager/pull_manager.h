@@ -4,7 +4,9 @@
 #include <boost/asio.hpp>
 #include <boost/asio/error.hpp>
 #include <boost/bind.hpp>
+#include <limits>
 #include <map>
+#include <set>
 
 #include "absl/container/flat_hash_map.h"
 #include "absl/container/flat_hash_set.h"
@@ -30,6 +32,12 @@ class PullManager {
   /// and to whom. Notably, it is _not_ responsible for controlling the object directory
   /// or any pubsub communications.
   ///
+  /// Only the objects of active bundles are pulled. Bundles are activated in priority
+  /// order, and in the order they were requested within a priority, as long as the
+  /// objects being pulled fit in the available memory. A bundle is activated or
+  /// deactivated as a whole, so that a task doesn't hold part of its arguments while
+  /// it waits for memory to pull the rest.
+  ///
   /// \param self_node_id the current node
   /// \param object_is_local A callback which should return true if a given object is
   /// already on the local node. \param send_pull_request A callback which should send a
@@ -45,10 +53,12 @@ class PullManager {
   /// Begin a new pull request for a bundle of objects.
   ///
   /// \param object_refs The bundle of objects that must be made local.
+  /// \param priority The priority of the bundle.
   /// \param objects_to_locate The objects whose new locations the caller
   /// should subscribe to, and call OnLocationChange for.
   /// \return A request ID that can be used to cancel the request.
   uint64_t Pull(const std::vector<rpc::ObjectReference> &object_ref_bundle,
+                BundlePriority priority,
                 std::vector<rpc::ObjectReference> *objects_to_locate);
 
   /// Called when the available locations for a given object change.
@@ -58,9 +68,28 @@ class PullManager {
   /// necessarily a super or subset of the previously available nodes.
   /// \param spilled_url The location of the object if it was spilled. If
   /// non-empty, the object may no longer be on any node.
+  /// \param object_size The size of the object, or 0 if unknown.
   void OnLocationChange(const ObjectID &object_id,
                         const std::unordered_set<NodeID> &client_ids,
-                        const std::string &spilled_url);
+                        const std::string &spilled_url, size_t object_size);
+
+  /// Called when the size of an object is learned other than from its locations,
+  /// e.g., from the first chunk of the object that is pushed to this node.
+  ///
+  /// \param object_id The ID of the object.
+  /// \param object_size The size of the object.
+  void OnObjectSizeKnown(const ObjectID &object_id, size_t object_size);
+
+  /// Called when an object is added to or deleted from the local object store.
+  /// Local objects don't count against the memory available for pulls.
+  void OnLocalObjectChange(const ObjectID &object_id);
+
+  /// Activate or deactivate bundles so that the objects being pulled fit in the
+  /// available memory. At least one bundle is kept active, so that pulls make
+  /// progress even if the memory is full.
+  ///
+  /// \param num_bytes_available The free memory in the local object store.
+  void UpdatePullsBasedOnAvailableMemory(int64_t num_bytes_available);
 
   /// Cancel an existing pull request.
   ///
@@ -76,6 +105,14 @@ class PullManager {
   /// The number of ongoing object pulls.
   int NumActiveRequests() const;
 
+  /// Whether the objects of a bundle are being pulled.
+  bool IsBundleActive(uint64_t request_id) const;
+
+  /// The total size of the objects of active bundles that aren't local yet.
+  int64_t NumBytesBeingPulled() const { return num_bytes_being_pulled_; }
+
+  std::string DebugString() const;
+
  private:
   /// A helper structure for tracking information about each ongoing object pull.
   struct ObjectPullRequest {
@@ -90,8 +127,57 @@ class PullManager {
     double next_pull_time;
     uint8_t num_retries;
     absl::flat_hash_set<uint64_t> bundle_request_ids;
+    /// The size of the object, or 0 if unknown.
+    size_t object_size = 0;
+    /// The number of active bundles that contain the object.
+    int num_active_bundles = 0;
+    /// The bytes that the object contributes to num_bytes_being_pulled_.
+    int64_t num_bytes_being_pulled = 0;
+  };
+
+  /// A bundle pull request.
+  struct BundlePullRequest {
+    /// The distinct objects of the bundle.
+    std::vector<ObjectID> object_ids;
+    BundlePriority priority;
+  };
+
+  /// The bundles of one priority, by request ID. The active bundles are always
+  /// the ones with the smallest request IDs.
+  struct BundleQueue {
+    std::set<uint64_t> request_ids;
+    /// The request ID of the last active bundle, or 0 if none are active. The
+    /// bundle may have been canceled since.
+    uint64_t last_active_request_id = 0;
   };
 
+  /// Activate bundles in priority order while they fit in the available memory,
+  /// deactivating lower priority bundles to make room. Then deactivate the lowest
+  /// priority bundles if the active bundles don't fit anymore.
+  void UpdatePulls();
+
+  /// Start pulling the objects of a bundle.
+  void ActivateBundle(uint64_t request_id);
+
+  /// Stop pulling the objects of a bundle, unless other active bundles need them.
+  void DeactivateBundle(uint64_t request_id);
+
+  /// Deactivate the last active bundle of the lowest priority, among the priorities
+  /// that are no higher than the given one.
+  ///
+  /// \return Whether a bundle was deactivated.
+  bool DeactivateLowestPriorityBundle(BundlePriority highest_priority);
+
+  /// The bytes that activating a bundle would add to num_bytes_being_pulled_.
+  int64_t NumBytesToActivate(uint64_t request_id) const;
+
+  /// Record the size of an object, and update the active bundles if it changed.
+  void UpdateObjectSize(const ObjectID &object_id, ObjectPullRequest *request,
+                        size_t object_size);
+
+  /// Recompute the bytes that an object contributes to num_bytes_being_pulled_.
+  void UpdateNumBytesBeingPulled(const ObjectID &object_id, ObjectPullRequest *request);
+
   /// Try to make an object local, by restoring the object from external
   /// storage or by fetching the object from one of its expected client
   /// locations. This does nothing if the object is not needed by any pull
@@ -124,7 +210,20 @@ class PullManager {
   /// cancel. Start at 1 because 0 means null.
   uint64_t next_req_id_ = 1;
 
-  std::unordered_map<uint64_t, std::vector<rpc::ObjectReference>> pull_request_bundles_;
+  std::unordered_map<uint64_t, BundlePullRequest> pull_request_bundles_;
+
+  /// The bundles of each priority.
+  std::vector<BundleQueue> bundle_queues_;
+
+  /// The number of active bundles.
+  size_t num_active_bundles_ = 0;
+
+  /// The total size of the objects of active bundles that aren't local yet.
+  int64_t num_bytes_being_pulled_ = 0;
+
+  /// The free memory in the local object store, from the last call to
+  /// UpdatePullsBasedOnAvailableMemory. Unbounded until the first call.
+  int64_t num_bytes_available_ = std::numeric_limits<int64_t>::max();
 
   /// The objects that this object manager is currently trying to fetch from
   /// remote object managers.
@@ -374,24 +374,28 @@ class StressTestObjectManager : public TestObjectManagerBase {
       for (int i = -1; ++i < num_trials;) {
         ObjectID oid1 = WriteDataToClient(client1, data_size);
         static_cast<void>(
-            server2->object_manager_.Pull({ObjectIdToRef(oid1, rpc::Address())}));
+            server2->object_manager_.Pull({ObjectIdToRef(oid1, rpc::Address())},
+                                          BundlePriority::GET_REQUEST));
       }
     } break;
     case TransferPattern::PULL_B_A: {
       for (int i = -1; ++i < num_trials;) {
         ObjectID oid2 = WriteDataToClient(client2, data_size);
         static_cast<void>(
-            server1->object_manager_.Pull({ObjectIdToRef(oid2, rpc::Address())}));
+            server1->object_manager_.Pull({ObjectIdToRef(oid2, rpc::Address())},
+                                          BundlePriority::GET_REQUEST));
       }
     } break;
     case TransferPattern::BIDIRECTIONAL_PULL: {
       for (int i = -1; ++i < num_trials;) {
         ObjectID oid1 = WriteDataToClient(client1, data_size);
         static_cast<void>(
-            server2->object_manager_.Pull({ObjectIdToRef(oid1, rpc::Address())}));
+            server2->object_manager_.Pull({ObjectIdToRef(oid1, rpc::Address())},
+                                          BundlePriority::GET_REQUEST));
         ObjectID oid2 = WriteDataToClient(client2, data_size);
         static_cast<void>(
-            server1->object_manager_.Pull({ObjectIdToRef(oid2, rpc::Address())}));
+            server1->object_manager_.Pull({ObjectIdToRef(oid2, rpc::Address())},
+                                          BundlePriority::GET_REQUEST));
       }
     } break;
     case TransferPattern::BIDIRECTIONAL_PULL_VARIABLE_DATA_SIZE: {
@@ -401,10 +405,12 @@ class StressTestObjectManager : public TestObjectManagerBase {
       for (int i = -1; ++i < num_trials;) {
         ObjectID oid1 = WriteDataToClient(client1, data_size + dis(gen));
         static_cast<void>(
-            server2->object_manager_.Pull({ObjectIdToRef(oid1, rpc::Address())}));
+            server2->object_manager_.Pull({ObjectIdToRef(oid1, rpc::Address())},
+                                          BundlePriority::GET_REQUEST));
         ObjectID oid2 = WriteDataToClient(client2, data_size + dis(gen));
         static_cast<void>(
-            server1->object_manager_.Pull({ObjectIdToRef(oid2, rpc::Address())}));
+            server1->object_manager_.Pull({ObjectIdToRef(oid2, rpc::Address())},
+                                          BundlePriority::GET_REQUEST));
       }
     } break;
     default: {
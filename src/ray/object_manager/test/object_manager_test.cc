@@ -296,7 +296,8 @@ class TestObjectManager : public TestObjectManagerBase {
         sub_id, object_1, rpc::Address(),
         [this, sub_id, object_1, object_2](const ray::ObjectID &object_id,
                                            const std::unordered_set<ray::NodeID> &clients,
-                                           const std::string &spilled_url) {
+                                           const std::string &spilled_url,
+                                           size_t object_size) {
           if (!clients.empty()) {
             TestWaitWhileSubscribed(sub_id, object_1, object_2);
           }
@@ -0,0 +1,392 @@
+// Copyright 2017 The Ray Authors.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//  http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "ray/object_manager/ownership_based_object_directory.h"
+
+#include <list>
+
+#include "gtest/gtest.h"
+#include "ray/gcs/gcs_client/service_based_accessor.h"
+#include "ray/gcs/gcs_client/service_based_gcs_client.h"
+
+namespace ray {
+
+class MockWorkerClient : public rpc::CoreWorkerClientInterface {
+ public:
+  void GetObjectLocationsUpdates(
+      const rpc::GetObjectLocationsUpdatesRequest &request,
+      const rpc::ClientCallback<rpc::GetObjectLocationsUpdatesReply> &callback)
+      override {
+    requests.push_back(request);
+    callbacks.push_back(callback);
+  }
+
+  /// Reply to the oldest outstanding poll.
+  void Reply(const rpc::GetObjectLocationsUpdatesReply &reply,
+             const Status &status = Status::OK()) {
+    ASSERT_FALSE(callbacks.empty());
+    auto callback = callbacks.front();
+    callbacks.pop_front();
+    callback(status, reply);
+  }
+
+  std::vector<rpc::GetObjectLocationsUpdatesRequest> requests;
+  std::list<rpc::ClientCallback<rpc::GetObjectLocationsUpdatesReply>> callbacks;
+};
+
+class MockNodeInfoAccessor : public gcs::ServiceBasedNodeInfoAccessor {
+ public:
+  MockNodeInfoAccessor(gcs::ServiceBasedGcsClient *client)
+      : gcs::ServiceBasedNodeInfoAccessor(client) {}
+
+  bool IsRemoved(const NodeID &node_id) const override {
+    return removed_nodes.count(node_id) > 0;
+  }
+
+  std::unordered_set<NodeID> removed_nodes;
+};
+
+class MockGcs : public gcs::ServiceBasedGcsClient {
+ public:
+  MockGcs() : gcs::ServiceBasedGcsClient(gcs::GcsClientOptions("", 0, "")){};
+
+  void Init(gcs::NodeInfoAccessor *node_accessor) { node_accessor_.reset(node_accessor); }
+};
+
+class OwnershipBasedObjectDirectoryTest : public ::testing::Test {
+ public:
+  OwnershipBasedObjectDirectoryTest()
+      : mock_gcs_(new MockGcs()),
+        node_accessor_(new MockNodeInfoAccessor(mock_gcs_.get())),
+        gcs_client_(mock_gcs_),
+        self_node_id_(NodeID::FromRandom()),
+        directory_(io_service_, gcs_client_, self_node_id_,
+                   [this](const rpc::Address &address) {
+                     auto &client = clients_[WorkerID::FromBinary(address.worker_id())];
+                     if (client == nullptr) {
+                       client = std::make_shared<MockWorkerClient>();
+                     }
+                     return client;
+                   }) {
+    mock_gcs_->Init(node_accessor_);
+  }
+
+  /// Run the handlers queued on the event loop, e.g., to send the polls.
+  void RunEventLoop() {
+    io_service_.restart();
+    io_service_.poll();
+  }
+
+  rpc::Address OwnerAddress(const WorkerID &worker_id) {
+    rpc::Address address;
+    address.set_worker_id(worker_id.Binary());
+    return address;
+  }
+
+  /// Subscribe to an object and record the locations that its listener is called with.
+  void Subscribe(const ObjectID &object_id, const WorkerID &owner_id,
+                 const UniqueID &callback_id = UniqueID::FromRandom()) {
+    RAY_CHECK_OK(directory_.SubscribeObjectLocations(
+        callback_id, object_id, OwnerAddress(owner_id),
+        [this](const ObjectID &object_id, const std::unordered_set<NodeID> &node_ids,
+               const std::string &spilled_url, size_t object_size) {
+          notifications_.emplace_back(object_id, node_ids);
+          object_sizes_[object_id] = object_size;
+        }));
+  }
+
+  static void AddUpdate(rpc::GetObjectLocationsUpdatesReply *reply,
+                        const ObjectID &object_id,
+                        const std::unordered_set<NodeID> &node_ids,
+                        size_t object_size = 0, bool object_not_found = false) {
+    auto update = reply->add_updates();
+    update->set_object_id(object_id.Binary());
+    for (const auto &node_id : node_ids) {
+      update->add_node_ids(node_id.Binary());
+    }
+    update->set_object_size(object_size);
+    update->set_object_not_found(object_not_found);
+  }
+
+  static std::vector<ObjectID> ToIds(
+      const google::protobuf::RepeatedPtrField<std::string> &binaries) {
+    std::vector<ObjectID> object_ids;
+    for (const auto &binary : binaries) {
+      object_ids.push_back(ObjectID::FromBinary(binary));
+    }
+    return object_ids;
+  }
+
+  boost::asio::io_service io_service_;
+  std::shared_ptr<MockGcs> mock_gcs_;
+  MockNodeInfoAccessor *node_accessor_;
+  std::shared_ptr<gcs::GcsClient> gcs_client_;
+  NodeID self_node_id_;
+  absl::flat_hash_map<WorkerID, std::shared_ptr<MockWorkerClient>> clients_;
+  OwnershipBasedObjectDirectory directory_;
+  std::vector<std::pair<ObjectID, std::unordered_set<NodeID>>> notifications_;
+  absl::flat_hash_map<ObjectID, size_t> object_sizes_;
+};
+
+TEST_F(OwnershipBasedObjectDirectoryTest, TestSubscriptionsBatchedPerOwner) {
+  const auto owner_1 = WorkerID::FromRandom();
+  const auto owner_2 = WorkerID::FromRandom();
+  const auto obj_1 = ObjectID::FromRandom();
+  const auto obj_2 = ObjectID::FromRandom();
+  const auto obj_3 = ObjectID::FromRandom();
+  Subscribe(obj_1, owner_1);
+  Subscribe(obj_1, owner_1);
+  Subscribe(obj_2, owner_1);
+  Subscribe(obj_3, owner_2);
+  // The polls are sent once the current handler returns.
+  ASSERT_TRUE(clients_[owner_1]->requests.empty());
+  RunEventLoop();
+
+  // One poll per owner, with all of its objects.
+  ASSERT_EQ(clients_[owner_1]->requests.size(), 1);
+  const auto &request = clients_[owner_1]->requests[0];
+  ASSERT_EQ(request.intended_worker_id(), owner_1.Binary());
+  ASSERT_EQ(request.subscriber_node_id(), self_node_id_.Binary());
+  auto subscribe_ids = ToIds(request.subscribe_object_ids());
+  ASSERT_EQ(std::unordered_set<ObjectID>(subscribe_ids.begin(), subscribe_ids.end()),
+            std::unordered_set<ObjectID>({obj_1, obj_2}));
+  ASSERT_TRUE(request.unsubscribe_object_ids().empty());
+  ASSERT_EQ(clients_[owner_2]->requests.size(), 1);
+  ASSERT_EQ(ToIds(clients_[owner_2]->requests[0].subscribe_object_ids()),
+            std::vector<ObjectID>({obj_3}));
+
+  // Subscribing to an object again doesn't send a poll.
+  Subscribe(obj_1, owner_1);
+  RunEventLoop();
+  ASSERT_EQ(clients_[owner_1]->requests.size(), 1);
+}
+
+TEST_F(OwnershipBasedObjectDirectoryTest, TestLocationsUpdates) {
+  const auto owner = WorkerID::FromRandom();
+  const auto obj_1 = ObjectID::FromRandom();
+  const auto obj_2 = ObjectID::FromRandom();
+  const auto node_1 = NodeID::FromRandom();
+  const auto node_2 = NodeID::FromRandom();
+  Subscribe(obj_1, owner);
+  Subscribe(obj_2, owner);
+  RunEventLoop();
+  auto client = clients_[owner];
+  ASSERT_EQ(client->requests.size(), 1);
+
+  // The reply notifies the listeners and starts the next poll right away, with no
+  // subscription changes.
+  rpc::GetObjectLocationsUpdatesReply reply;
+  AddUpdate(&reply, obj_1, {node_1, node_2}, 100);
+  AddUpdate(&reply, obj_2, {});
+  client->Reply(reply);
+  ASSERT_EQ(notifications_.size(), 2);
+  ASSERT_EQ(notifications_[0].first, obj_1);
+  ASSERT_EQ(notifications_[0].second, std::unordered_set<NodeID>({node_1, node_2}));
+  ASSERT_EQ(object_sizes_[obj_1], 100);
+  ASSERT_EQ(notifications_[1].first, obj_2);
+  ASSERT_TRUE(notifications_[1].second.empty());
+  ASSERT_EQ(client->requests.size(), 2);
+  ASSERT_TRUE(client->requests[1].subscribe_object_ids().empty());
+  ASSERT_TRUE(client->requests[1].unsubscribe_object_ids().empty());
+
+  // Updates that don't change the locations don't notify the listeners.
+  reply.Clear();
+  AddUpdate(&reply, obj_1, {node_1, node_2});
+  client->Reply(reply);
+  ASSERT_EQ(notifications_.size(), 2);
+  ASSERT_EQ(client->requests.size(), 3);
+
+  // Removed nodes are filtered out of the locations.
+  node_accessor_->removed_nodes.insert(node_2);
+  reply.Clear();
+  AddUpdate(&reply, obj_1, {node_1, node_2});
+  client->Reply(reply);
+  ASSERT_EQ(notifications_.size(), 3);
+  ASSERT_EQ(notifications_[2].second, std::unordered_set<NodeID>({node_1}));
+  ASSERT_EQ(object_sizes_[obj_1], 100);
+  ASSERT_EQ(client->requests.size(), 4);
+}
+
+TEST_F(OwnershipBasedObjectDirectoryTest, TestUnsubscribe) {
+  const auto owner = WorkerID::FromRandom();
+  const auto obj_1 = ObjectID::FromRandom();
+  const auto obj_2 = ObjectID::FromRandom();
+  const auto callback_id = UniqueID::FromRandom();
+  Subscribe(obj_1, owner, callback_id);
+  Subscribe(obj_2, owner);
+  RunEventLoop();
+  auto client = clients_[owner];
+  ASSERT_EQ(client->requests.size(), 1);
+
+  // The unsubscription is sent in a new poll, while the first poll is outstanding.
+  RAY_CHECK_OK(directory_.UnsubscribeObjectLocations(callback_id, obj_1));
+  RunEventLoop();
+  ASSERT_EQ(client->requests.size(), 2);
+  ASSERT_TRUE(client->requests[1].subscribe_object_ids().empty());
+  ASSERT_EQ(ToIds(client->requests[1].unsubscribe_object_ids()),
+            std::vector<ObjectID>({obj_1}));
+
+  // The reply to the old poll carries updates, but updates to the unsubscribed object
+  // are dropped, and it doesn't start another poll.
+  rpc::GetObjectLocationsUpdatesReply reply;
+  AddUpdate(&reply, obj_1, {NodeID::FromRandom()});
+  AddUpdate(&reply, obj_2, {NodeID::FromRandom()});
+  client->Reply(reply);
+  ASSERT_EQ(notifications_.size(), 1);
+  ASSERT_EQ(notifications_[0].first, obj_2);
+  ASSERT_EQ(client->requests.size(), 2);
+
+  // The reply to the latest poll starts the next one.
+  client->Reply(rpc::GetObjectLocationsUpdatesReply());
+  ASSERT_EQ(client->requests.size(), 3);
+}
+
+TEST_F(OwnershipBasedObjectDirectoryTest, TestUnsubscribeLastObject) {
+  const auto owner = WorkerID::FromRandom();
+  const auto obj = ObjectID::FromRandom();
+  const auto callback_id = UniqueID::FromRandom();
+  Subscribe(obj, owner, callback_id);
+  RunEventLoop();
+  auto client = clients_[owner];
+  ASSERT_EQ(client->requests.size(), 1);
+
+  RAY_CHECK_OK(directory_.UnsubscribeObjectLocations(callback_id, obj));
+  RunEventLoop();
+  ASSERT_EQ(client->requests.size(), 2);
+  ASSERT_EQ(ToIds(client->requests[1].unsubscribe_object_ids()),
+            std::vector<ObjectID>({obj}));
+
+  // The owner replies to both polls, which doesn't start another one.
+  rpc::GetObjectLocationsUpdatesReply reply;
+  AddUpdate(&reply, obj, {NodeID::FromRandom()});
+  client->Reply(reply);
+  client->Reply(rpc::GetObjectLocationsUpdatesReply());
+  ASSERT_TRUE(notifications_.empty());
+  ASSERT_EQ(client->requests.size(), 2);
+
+  // An object that is subscribed to and unsubscribed from before the poll is sent is
+  // never sent to the owner.
+  Subscribe(obj, owner, callback_id);
+  RAY_CHECK_OK(directory_.UnsubscribeObjectLocations(callback_id, obj));
+  RunEventLoop();
+  ASSERT_EQ(client->requests.size(), 2);
+}
+
+TEST_F(OwnershipBasedObjectDirectoryTest, TestObjectNotFound) {
+  const auto owner = WorkerID::FromRandom();
+  const auto obj_1 = ObjectID::FromRandom();
+  const auto obj_2 = ObjectID::FromRandom();
+  Subscribe(obj_1, owner);
+  Subscribe(obj_2, owner);
+  RunEventLoop();
+  auto client = clients_[owner];
+
+  rpc::GetObjectLocationsUpdatesReply reply;
+  AddUpdate(&reply, obj_1, {NodeID::FromRandom()});
+  AddUpdate(&reply, obj_2, {NodeID::FromRandom()});
+  client->Reply(reply);
+  ASSERT_EQ(notifications_.size(), 2);
+  ASSERT_EQ(client->requests.size(), 2);
+
+  // The owner dropped its reference to the first object. The listener is told that
+  // the object has no locations, and the owner keeps polling for the other object.
+  reply.Clear();
+  AddUpdate(&reply, obj_1, {}, 0, /*object_not_found=*/true);
+  client->Reply(reply);
+  ASSERT_EQ(notifications_.size(), 3);
+  ASSERT_EQ(notifications_[2].first, obj_1);
+  ASSERT_TRUE(notifications_[2].second.empty());
+  ASSERT_EQ(client->requests.size(), 3);
+
+  // Once the owner dropped all subscriptions, no more polls are sent.
+  reply.Clear();
+  AddUpdate(&reply, obj_2, {}, 0, /*object_not_found=*/true);
+  client->Reply(reply);
+  ASSERT_EQ(notifications_.size(), 4);
+  ASSERT_EQ(notifications_[3].first, obj_2);
+  ASSERT_TRUE(notifications_[3].second.empty());
+  ASSERT_EQ(client->requests.size(), 3);
+}
+
+TEST_F(OwnershipBasedObjectDirectoryTest, TestOwnerFailure) {
+  const auto owner = WorkerID::FromRandom();
+  const auto obj_1 = ObjectID::FromRandom();
+  const auto obj_2 = ObjectID::FromRandom();
+  Subscribe(obj_1, owner);
+  Subscribe(obj_2, owner);
+  RunEventLoop();
+  auto client = clients_[owner];
+
+  rpc::GetObjectLocationsUpdatesReply reply;
+  AddUpdate(&reply, obj_1, {NodeID::FromRandom()});
+  client->Reply(reply);
+  ASSERT_EQ(notifications_.size(), 1);
+  ASSERT_EQ(client->requests.size(), 2);
+
+  // The objects of an unreachable owner are treated as lost, and no more polls are
+  // sent to it.
+  client->Reply(rpc::GetObjectLocationsUpdatesReply(), Status::IOError("disconnected"));
+  ASSERT_EQ(notifications_.size(), 3);
+  std::unordered_set<ObjectID> lost_ids;
+  for (size_t i = 1; i < notifications_.size(); i++) {
+    ASSERT_TRUE(notifications_[i].second.empty());
+    lost_ids.insert(notifications_[i].first);
+  }
+  ASSERT_EQ(lost_ids, std::unordered_set<ObjectID>({obj_1, obj_2}));
+  RunEventLoop();
+  ASSERT_EQ(client->requests.size(), 2);
+}
+
+TEST_F(OwnershipBasedObjectDirectoryTest, TestNodeRemoved) {
+  const auto owner = WorkerID::FromRandom();
+  const auto obj_1 = ObjectID::FromRandom();
+  const auto obj_2 = ObjectID::FromRandom();
+  const auto node_1 = NodeID::FromRandom();
+  const auto node_2 = NodeID::FromRandom();
+  Subscribe(obj_1, owner);
+  Subscribe(obj_2, owner);
+  RunEventLoop();
+
+  rpc::GetObjectLocationsUpdatesReply reply;
+  AddUpdate(&reply, obj_1, {node_1, node_2}, 100);
+  AddUpdate(&reply, obj_2, {node_2});
+  clients_[owner]->Reply(reply);
+  ASSERT_EQ(notifications_.size(), 2);
+
+  // The removed node is dropped from the locations without waiting for the owner.
+  directory_.HandleNodeRemoved(node_1);
+  ASSERT_EQ(notifications_.size(), 3);
+  ASSERT_EQ(notifications_[2].first, obj_1);
+  ASSERT_EQ(notifications_[2].second, std::unordered_set<NodeID>({node_2}));
+  ASSERT_EQ(object_sizes_[obj_1], 100);
+
+  // Nodes that don't have any subscribed object don't notify the listeners.
+  directory_.HandleNodeRemoved(NodeID::FromRandom());
+  ASSERT_EQ(notifications_.size(), 3);
+
+  // A later update from the owner that still has the removed node doesn't add it
+  // back.
+  node_accessor_->removed_nodes.insert(node_1);
+  reply.Clear();
+  AddUpdate(&reply, obj_1, {node_1, node_2});
+  clients_[owner]->Reply(reply);
+  ASSERT_EQ(notifications_.size(), 3);
+}
+
+}  // namespace ray
+
+int main(int argc, char **argv) {
+  ::testing::InitGoogleTest(&argc, argv);
+  return RUN_ALL_TESTS();
+}
@@ -55,12 +55,12 @@ TEST_F(PullManagerTest, TestStaleSubscription) {
   auto oid = ObjectRefsToIds(refs)[0];
   ASSERT_EQ(pull_manager_.NumActiveRequests(), 0);
   std::vector<rpc::ObjectReference> objects_to_locate;
-  auto req_id = pull_manager_.Pull(refs, &objects_to_locate);
+  auto req_id = pull_manager_.Pull(refs, BundlePriority::TASK_ARGS, &objects_to_locate);
   ASSERT_EQ(ObjectRefsToIds(objects_to_locate), ObjectRefsToIds(refs));
   ASSERT_EQ(pull_manager_.NumActiveRequests(), 1);
 
   std::unordered_set<NodeID> client_ids;
-  pull_manager_.OnLocationChange(oid, client_ids, "");
+  pull_manager_.OnLocationChange(oid, client_ids, "", 0);
 
   // There are no client ids to pull from.
   ASSERT_EQ(num_send_pull_request_calls_, 0);
@@ -74,7 +74,7 @@ TEST_F(PullManagerTest, TestStaleSubscription) {
   ASSERT_EQ(pull_manager_.NumActiveRequests(), 0);
 
   client_ids.insert(NodeID::FromRandom());
-  pull_manager_.OnLocationChange(oid, client_ids, "");
+  pull_manager_.OnLocationChange(oid, client_ids, "", 0);
 
   // Now we're getting a notification about an object that was already cancelled.
   ASSERT_EQ(num_send_pull_request_calls_, 0);
@@ -88,12 +88,12 @@ TEST_F(PullManagerTest, TestRestoreSpilledObject) {
   rpc::Address addr1;
   ASSERT_EQ(pull_manager_.NumActiveRequests(), 0);
   std::vector<rpc::ObjectReference> objects_to_locate;
-  auto req_id = pull_manager_.Pull(refs, &objects_to_locate);
+  auto req_id = pull_manager_.Pull(refs, BundlePriority::TASK_ARGS, &objects_to_locate);
   ASSERT_EQ(ObjectRefsToIds(objects_to_locate), ObjectRefsToIds(refs));
   ASSERT_EQ(pull_manager_.NumActiveRequests(), 1);
 
   std::unordered_set<NodeID> client_ids;
-  pull_manager_.OnLocationChange(obj1, client_ids, "remote_url/foo/bar");
+  pull_manager_.OnLocationChange(obj1, client_ids, "remote_url/foo/bar", 0);
 
   // client_ids is empty here, so there's nowhere to pull from.
   ASSERT_EQ(num_send_pull_request_calls_, 0);
@@ -101,7 +101,7 @@ TEST_F(PullManagerTest, TestRestoreSpilledObject) {
 
   client_ids.insert(NodeID::FromRandom());
   fake_time_ += 10.;
-  pull_manager_.OnLocationChange(obj1, client_ids, "remote_url/foo/bar");
+  pull_manager_.OnLocationChange(obj1, client_ids, "remote_url/foo/bar", 0);
 
   // The behavior is supposed to be to always restore the spilled object if possible (even
   // if it exists elsewhere in the cluster).
@@ -111,7 +111,7 @@ TEST_F(PullManagerTest, TestRestoreSpilledObject) {
   // Don't restore an object if it's local.
   object_is_local_ = true;
   num_restore_spilled_object_calls_ = 0;
-  pull_manager_.OnLocationChange(obj1, client_ids, "remote_url/foo/bar");
+  pull_manager_.OnLocationChange(obj1, client_ids, "remote_url/foo/bar", 0);
   ASSERT_EQ(num_restore_spilled_object_calls_, 0);
 
   auto objects_to_cancel = pull_manager_.CancelPull(req_id);
@@ -125,12 +125,12 @@ TEST_F(PullManagerTest, TestRestoreObjectFailed) {
   rpc::Address addr1;
   ASSERT_EQ(pull_manager_.NumActiveRequests(), 0);
   std::vector<rpc::ObjectReference> objects_to_locate;
-  pull_manager_.Pull(refs, &objects_to_locate);
+  pull_manager_.Pull(refs, BundlePriority::TASK_ARGS, &objects_to_locate);
   ASSERT_EQ(ObjectRefsToIds(objects_to_locate), ObjectRefsToIds(refs));
   ASSERT_EQ(pull_manager_.NumActiveRequests(), 1);
 
   std::unordered_set<NodeID> client_ids;
-  pull_manager_.OnLocationChange(obj1, client_ids, "remote_url/foo/bar");
+  pull_manager_.OnLocationChange(obj1, client_ids, "remote_url/foo/bar", 0);
 
   // client_ids is empty here, so there's nowhere to pull from.
   ASSERT_EQ(num_send_pull_request_calls_, 0);
@@ -143,14 +143,14 @@ TEST_F(PullManagerTest, TestRestoreObjectFailed) {
   ASSERT_EQ(num_restore_spilled_object_calls_, 1);
 
   client_ids.insert(NodeID::FromRandom());
-  pull_manager_.OnLocationChange(obj1, client_ids, "remote_url/foo/bar");
+  pull_manager_.OnLocationChange(obj1, client_ids, "remote_url/foo/bar", 0);
 
   // We always assume the restore succeeded so there's only 1 restore call still.
   ASSERT_EQ(num_send_pull_request_calls_, 0);
   ASSERT_EQ(num_restore_spilled_object_calls_, 1);
 
   fake_time_ += 10.0;
-  pull_manager_.OnLocationChange(obj1, client_ids, "remote_url/foo/bar");
+  pull_manager_.OnLocationChange(obj1, client_ids, "remote_url/foo/bar", 0);
 
   ASSERT_EQ(num_send_pull_request_calls_, 0);
   ASSERT_EQ(num_restore_spilled_object_calls_, 2);
@@ -161,7 +161,7 @@ TEST_F(PullManagerTest, TestRestoreObjectFailed) {
   ASSERT_EQ(num_send_pull_request_calls_, 1);
   ASSERT_EQ(num_restore_spilled_object_calls_, 2);
 
-  pull_manager_.OnLocationChange(obj1, client_ids, "remote_url/foo/bar");
+  pull_manager_.OnLocationChange(obj1, client_ids, "remote_url/foo/bar", 0);
 
   // Now that we've successfully sent a pull request, we need to wait for the retry period
   // before sending another one.
@@ -175,7 +175,7 @@ TEST_F(PullManagerTest, TestManyUpdates) {
   rpc::Address addr1;
   ASSERT_EQ(pull_manager_.NumActiveRequests(), 0);
   std::vector<rpc::ObjectReference> objects_to_locate;
-  auto req_id = pull_manager_.Pull(refs, &objects_to_locate);
+  auto req_id = pull_manager_.Pull(refs, BundlePriority::TASK_ARGS, &objects_to_locate);
   ASSERT_EQ(ObjectRefsToIds(objects_to_locate), ObjectRefsToIds(refs));
   ASSERT_EQ(pull_manager_.NumActiveRequests(), 1);
 
@@ -183,7 +183,7 @@ TEST_F(PullManagerTest, TestManyUpdates) {
   client_ids.insert(NodeID::FromRandom());
 
   for (int i = 0; i < 100; i++) {
-    pull_manager_.OnLocationChange(obj1, client_ids, "");
+    pull_manager_.OnLocationChange(obj1, client_ids, "", 0);
   }
 
   // Since no time has passed, only send a single pull request.
@@ -201,7 +201,7 @@ TEST_F(PullManagerTest, TestRetryTimer) {
   rpc::Address addr1;
   ASSERT_EQ(pull_manager_.NumActiveRequests(), 0);
   std::vector<rpc::ObjectReference> objects_to_locate;
-  auto req_id = pull_manager_.Pull(refs, &objects_to_locate);
+  auto req_id = pull_manager_.Pull(refs, BundlePriority::TASK_ARGS, &objects_to_locate);
   ASSERT_EQ(ObjectRefsToIds(objects_to_locate), ObjectRefsToIds(refs));
   ASSERT_EQ(pull_manager_.NumActiveRequests(), 1);
 
@@ -210,7 +210,7 @@ TEST_F(PullManagerTest, TestRetryTimer) {
 
   // We need to call OnLocationChange at least once, to population the list of nodes with
   // the object.
-  pull_manager_.OnLocationChange(obj1, client_ids, "");
+  pull_manager_.OnLocationChange(obj1, client_ids, "", 0);
   ASSERT_EQ(num_send_pull_request_calls_, 1);
   ASSERT_EQ(num_restore_spilled_object_calls_, 0);
 
@@ -220,7 +220,7 @@ TEST_F(PullManagerTest, TestRetryTimer) {
 
   // Location changes can trigger reset timer.
   for (; fake_time_ <= 120 * 10; fake_time_ += 1.) {
-    pull_manager_.OnLocationChange(obj1, client_ids, "");
+    pull_manager_.OnLocationChange(obj1, client_ids, "", 0);
   }
 
   // We should make a pull request every tick (even if it's a duplicate to a node we're
@@ -246,14 +246,14 @@ TEST_F(PullManagerTest, TestBasic) {
   auto oids = ObjectRefsToIds(refs);
   ASSERT_EQ(pull_manager_.NumActiveRequests(), 0);
   std::vector<rpc::ObjectReference> objects_to_locate;
-  auto req_id = pull_manager_.Pull(refs, &objects_to_locate);
+  auto req_id = pull_manager_.Pull(refs, BundlePriority::TASK_ARGS, &objects_to_locate);
   ASSERT_EQ(ObjectRefsToIds(objects_to_locate), oids);
   ASSERT_EQ(pull_manager_.NumActiveRequests(), oids.size());
 
   std::unordered_set<NodeID> client_ids;
   client_ids.insert(NodeID::FromRandom());
   for (size_t i = 0; i < oids.size(); i++) {
-    pull_manager_.OnLocationChange(oids[i], client_ids, "");
+    pull_manager_.OnLocationChange(oids[i], client_ids, "", 0);
     ASSERT_EQ(num_send_pull_request_calls_, i + 1);
     ASSERT_EQ(num_restore_spilled_object_calls_, 0);
   }
@@ -262,7 +262,7 @@ TEST_F(PullManagerTest, TestBasic) {
   object_is_local_ = true;
   num_send_pull_request_calls_ = 0;
   for (size_t i = 0; i < oids.size(); i++) {
-    pull_manager_.OnLocationChange(oids[i], client_ids, "");
+    pull_manager_.OnLocationChange(oids[i], client_ids, "", 0);
   }
   ASSERT_EQ(num_send_pull_request_calls_, 0);
 
@@ -274,7 +274,7 @@ TEST_F(PullManagerTest, TestBasic) {
   object_is_local_ = false;
   num_send_pull_request_calls_ = 0;
   for (size_t i = 0; i < oids.size(); i++) {
-    pull_manager_.OnLocationChange(oids[i], client_ids, "");
+    pull_manager_.OnLocationChange(oids[i], client_ids, "", 0);
   }
   ASSERT_EQ(num_send_pull_request_calls_, 0);
 }
@@ -284,18 +284,18 @@ TEST_F(PullManagerTest, TestDeduplicateBundles) {
   auto oids = ObjectRefsToIds(refs);
   ASSERT_EQ(pull_manager_.NumActiveRequests(), 0);
   std::vector<rpc::ObjectReference> objects_to_locate;
-  auto req_id1 = pull_manager_.Pull(refs, &objects_to_locate);
+  auto req_id1 = pull_manager_.Pull(refs, BundlePriority::TASK_ARGS, &objects_to_locate);
   ASSERT_EQ(ObjectRefsToIds(objects_to_locate), oids);
   ASSERT_EQ(pull_manager_.NumActiveRequests(), oids.size());
 
   objects_to_locate.clear();
-  auto req_id2 = pull_manager_.Pull(refs, &objects_to_locate);
+  auto req_id2 = pull_manager_.Pull(refs, BundlePriority::TASK_ARGS, &objects_to_locate);
   ASSERT_TRUE(objects_to_locate.empty());
 
   std::unordered_set<NodeID> client_ids;
   client_ids.insert(NodeID::FromRandom());
   for (size_t i = 0; i < oids.size(); i++) {
-    pull_manager_.OnLocationChange(oids[i], client_ids, "");
+    pull_manager_.OnLocationChange(oids[i], client_ids, "", 0);
     ASSERT_EQ(num_send_pull_request_calls_, i + 1);
     ASSERT_EQ(num_restore_spilled_object_calls_, 0);
   }
@@ -308,7 +308,7 @@ TEST_F(PullManagerTest, TestDeduplicateBundles) {
   fake_time_ += 10;
   num_send_pull_request_calls_ = 0;
   for (size_t i = 0; i < oids.size(); i++) {
-    pull_manager_.OnLocationChange(oids[i], client_ids, "");
+    pull_manager_.OnLocationChange(oids[i], client_ids, "", 0);
     ASSERT_EQ(num_send_pull_request_calls_, i + 1);
     ASSERT_EQ(num_restore_spilled_object_calls_, 0);
   }
@@ -322,11 +322,185 @@ TEST_F(PullManagerTest, TestDeduplicateBundles) {
   object_is_local_ = false;
   num_send_pull_request_calls_ = 0;
   for (size_t i = 0; i < oids.size(); i++) {
-    pull_manager_.OnLocationChange(oids[i], client_ids, "");
+    pull_manager_.OnLocationChange(oids[i], client_ids, "", 0);
   }
   ASSERT_EQ(num_send_pull_request_calls_, 0);
 }
 
+TEST_F(PullManagerTest, TestPullsBoundedByAvailableMemory) {
+  std::vector<uint64_t> req_ids;
+  std::vector<ObjectID> oids;
+  std::vector<rpc::ObjectReference> objects_to_locate;
+  for (int i = 0; i < 3; i++) {
+    auto refs = CreateObjectRefs(1);
+    req_ids.push_back(
+        pull_manager_.Pull(refs, BundlePriority::TASK_ARGS, &objects_to_locate));
+    oids.push_back(ObjectRefsToIds(refs)[0]);
+  }
+  std::unordered_set<NodeID> client_ids;
+  client_ids.insert(NodeID::FromRandom());
+  for (const auto &oid : oids) {
+    pull_manager_.OnLocationChange(oid, client_ids, "", 100);
+  }
+  // The memory is unbounded by default.
+  ASSERT_EQ(num_send_pull_request_calls_, 3);
+  ASSERT_EQ(pull_manager_.NumBytesBeingPulled(), 300);
+
+  // The latest bundles are deactivated first.
+  pull_manager_.UpdatePullsBasedOnAvailableMemory(250);
+  ASSERT_TRUE(pull_manager_.IsBundleActive(req_ids[0]));
+  ASSERT_TRUE(pull_manager_.IsBundleActive(req_ids[1]));
+  ASSERT_FALSE(pull_manager_.IsBundleActive(req_ids[2]));
+  ASSERT_EQ(pull_manager_.NumBytesBeingPulled(), 200);
+
+  // At least one bundle is pulled, even if it doesn't fit.
+  pull_manager_.UpdatePullsBasedOnAvailableMemory(50);
+  ASSERT_TRUE(pull_manager_.IsBundleActive(req_ids[0]));
+  ASSERT_FALSE(pull_manager_.IsBundleActive(req_ids[1]));
+  ASSERT_EQ(pull_manager_.NumBytesBeingPulled(), 100);
+
+  // Inactive bundles aren't pulled.
+  fake_time_ += 10;
+  num_send_pull_request_calls_ = 0;
+  pull_manager_.Tick();
+  ASSERT_EQ(num_send_pull_request_calls_, 1);
+
+  // The next bundle is activated once there is memory for it.
+  pull_manager_.UpdatePullsBasedOnAvailableMemory(200);
+  ASSERT_TRUE(pull_manager_.IsBundleActive(req_ids[1]));
+  ASSERT_FALSE(pull_manager_.IsBundleActive(req_ids[2]));
+  ASSERT_EQ(num_send_pull_request_calls_, 2);
+  pull_manager_.CancelPull(req_ids[0]);
+  ASSERT_TRUE(pull_manager_.IsBundleActive(req_ids[2]));
+  ASSERT_EQ(num_send_pull_request_calls_, 3);
+  ASSERT_EQ(pull_manager_.NumBytesBeingPulled(), 200);
+
+  pull_manager_.CancelPull(req_ids[1]);
+  pull_manager_.CancelPull(req_ids[2]);
+  ASSERT_EQ(pull_manager_.NumBytesBeingPulled(), 0);
+}
+
+TEST_F(PullManagerTest, TestObjectSizeKnownFromPushedChunk) {
+  pull_manager_.UpdatePullsBasedOnAvailableMemory(150);
+  std::unordered_set<NodeID> client_ids;
+  client_ids.insert(NodeID::FromRandom());
+  std::vector<rpc::ObjectReference> objects_to_locate;
+  std::vector<uint64_t> req_ids;
+  std::vector<ObjectID> oids;
+  for (int i = 0; i < 2; i++) {
+    auto refs = CreateObjectRefs(1);
+    req_ids.push_back(
+        pull_manager_.Pull(refs, BundlePriority::TASK_ARGS, &objects_to_locate));
+    oids.push_back(ObjectRefsToIds(refs)[0]);
+    // The object directory doesn't know the size.
+    pull_manager_.OnLocationChange(oids.back(), client_ids, "", 0);
+  }
+  ASSERT_TRUE(pull_manager_.IsBundleActive(req_ids[0]));
+  ASSERT_TRUE(pull_manager_.IsBundleActive(req_ids[1]));
+  ASSERT_EQ(pull_manager_.NumBytesBeingPulled(), 0);
+
+  // The sizes from the pushed chunks bound the pulls.
+  pull_manager_.OnObjectSizeKnown(oids[0], 100);
+  ASSERT_TRUE(pull_manager_.IsBundleActive(req_ids[1]));
+  ASSERT_EQ(pull_manager_.NumBytesBeingPulled(), 100);
+  pull_manager_.OnObjectSizeKnown(oids[1], 100);
+  ASSERT_TRUE(pull_manager_.IsBundleActive(req_ids[0]));
+  ASSERT_FALSE(pull_manager_.IsBundleActive(req_ids[1]));
+  ASSERT_EQ(pull_manager_.NumBytesBeingPulled(), 100);
+
+  // Later location updates without a size keep the known size.
+  pull_manager_.OnLocationChange(oids[0], client_ids, "", 0);
+  ASSERT_EQ(pull_manager_.NumBytesBeingPulled(), 100);
+
+  // Sizes of objects that aren't being pulled are ignored.
+  pull_manager_.OnObjectSizeKnown(ObjectID::FromRandom(), 100);
+  ASSERT_EQ(pull_manager_.NumBytesBeingPulled(), 100);
+
+  pull_manager_.CancelPull(req_ids[0]);
+  ASSERT_TRUE(pull_manager_.IsBundleActive(req_ids[1]));
+  pull_manager_.CancelPull(req_ids[1]);
+  ASSERT_EQ(pull_manager_.NumBytesBeingPulled(), 0);
+}
+
+TEST_F(PullManagerTest, TestPrioritizeBundles) {
+  pull_manager_.UpdatePullsBasedOnAvailableMemory(100);
+  std::unordered_set<NodeID> client_ids;
+  client_ids.insert(NodeID::FromRandom());
+  std::vector<rpc::ObjectReference> objects_to_locate;
+  auto pull = [&](BundlePriority priority) {
+    auto refs = CreateObjectRefs(1);
+    auto req_id = pull_manager_.Pull(refs, priority, &objects_to_locate);
+    pull_manager_.OnLocationChange(ObjectRefsToIds(refs)[0], client_ids, "", 100);
+    return req_id;
+  };
+
+  auto wait_req_id = pull(BundlePriority::WAIT_REQUEST);
+  ASSERT_TRUE(pull_manager_.IsBundleActive(wait_req_id));
+  // Task arguments are pulled before ray.wait requests.
+  auto task_req_id = pull(BundlePriority::TASK_ARGS);
+  ASSERT_TRUE(pull_manager_.IsBundleActive(task_req_id));
+  ASSERT_FALSE(pull_manager_.IsBundleActive(wait_req_id));
+  // ray.get requests are pulled before task arguments.
+  auto get_req_id = pull(BundlePriority::GET_REQUEST);
+  ASSERT_TRUE(pull_manager_.IsBundleActive(get_req_id));
+  ASSERT_FALSE(pull_manager_.IsBundleActive(task_req_id));
+  ASSERT_FALSE(pull_manager_.IsBundleActive(wait_req_id));
+  ASSERT_EQ(pull_manager_.NumBytesBeingPulled(), 100);
+
+  // Lower priority bundles are activated once the higher priority ones are done.
+  pull_manager_.CancelPull(get_req_id);
+  ASSERT_TRUE(pull_manager_.IsBundleActive(task_req_id));
+  ASSERT_FALSE(pull_manager_.IsBundleActive(wait_req_id));
+  pull_manager_.CancelPull(task_req_id);
+  ASSERT_TRUE(pull_manager_.IsBundleActive(wait_req_id));
+  pull_manager_.CancelPull(wait_req_id);
+  ASSERT_EQ(pull_manager_.NumBytesBeingPulled(), 0);
+}
+
+TEST_F(PullManagerTest, TestActivateBundlesAtomically) {
+  pull_manager_.UpdatePullsBasedOnAvailableMemory(250);
+  std::unordered_set<NodeID> client_ids;
+  client_ids.insert(NodeID::FromRandom());
+  std::vector<rpc::ObjectReference> objects_to_locate;
+  auto refs1 = CreateObjectRefs(2);
+  auto req_id1 = pull_manager_.Pull(refs1, BundlePriority::TASK_ARGS, &objects_to_locate);
+  auto refs2 = CreateObjectRefs(2);
+  auto req_id2 = pull_manager_.Pull(refs2, BundlePriority::TASK_ARGS, &objects_to_locate);
+  for (const auto &oid : ObjectRefsToIds(refs1)) {
+    pull_manager_.OnLocationChange(oid, client_ids, "", 100);
+  }
+  ASSERT_EQ(num_send_pull_request_calls_, 2);
+
+  // Only one of the objects of the second bundle would fit, so none of them is pulled.
+  for (const auto &oid : ObjectRefsToIds(refs2)) {
+    pull_manager_.OnLocationChange(oid, client_ids, "", 100);
+  }
+  ASSERT_TRUE(pull_manager_.IsBundleActive(req_id1));
+  ASSERT_FALSE(pull_manager_.IsBundleActive(req_id2));
+  ASSERT_EQ(num_send_pull_request_calls_, 2);
+  ASSERT_EQ(pull_manager_.NumBytesBeingPulled(), 200);
+
+  // Later bundles wait behind the second bundle, even if they would fit.
+  std::vector<rpc::ObjectReference> refs3 = {refs1[0]};
+  auto req_id3 = pull_manager_.Pull(refs3, BundlePriority::TASK_ARGS, &objects_to_locate);
+  ASSERT_FALSE(pull_manager_.IsBundleActive(req_id3));
+
+  // The objects shared with an active bundle don't need more memory.
+  pull_manager_.UpdatePullsBasedOnAvailableMemory(400);
+  ASSERT_TRUE(pull_manager_.IsBundleActive(req_id2));
+  ASSERT_TRUE(pull_manager_.IsBundleActive(req_id3));
+  ASSERT_EQ(num_send_pull_request_calls_, 4);
+  ASSERT_EQ(pull_manager_.NumBytesBeingPulled(), 400);
+
+  // The memory of the canceled bundle is released once no active bundle needs it.
+  pull_manager_.CancelPull(req_id1);
+  ASSERT_EQ(pull_manager_.NumBytesBeingPulled(), 300);
+  pull_manager_.CancelPull(req_id3);
+  ASSERT_EQ(pull_manager_.NumBytesBeingPulled(), 200);
+  pull_manager_.CancelPull(req_id2);
+  ASSERT_EQ(pull_manager_.NumBytesBeingPulled(), 0);
+}
+
 }  // namespace ray
 
 int main(int argc, char **argv) {
@@ -68,7 +68,8 @@ void DependencyManager::StartOrUpdateWaitRequest(
       auto it = GetOrInsertRequiredObject(obj_id, ref);
       it->second.dependent_wait_requests.insert(worker_id);
       if (it->second.wait_request_id == 0) {
-        it->second.wait_request_id = object_manager_.Pull({ref});
+        it->second.wait_request_id =
+            object_manager_.Pull({ref}, BundlePriority::WAIT_REQUEST);
         RAY_LOG(DEBUG) << "Started pull for wait request for object " << obj_id
                        << " request: " << it->second.wait_request_id;
       }
@@ -123,7 +124,7 @@ void DependencyManager::StartOrUpdateGetRequest(
     }
     // Pull the new dependencies before canceling the old request, in case some
     // of the old dependencies are still being fetched.
-    uint64_t new_request_id = object_manager_.Pull(refs);
+    uint64_t new_request_id = object_manager_.Pull(refs, BundlePriority::GET_REQUEST);
     if (get_request.second != 0) {
       RAY_LOG(DEBUG) << "Canceling pull for get request from worker " << worker_id
                      << " request: " << get_request.second;
@@ -169,7 +170,10 @@ bool DependencyManager::RequestTaskDependencies(
     RAY_LOG(DEBUG) << "Task " << task_id << " blocked on object " << obj_id;
 
     auto it = GetOrInsertRequiredObject(obj_id, ref);
-    it->second.dependent_tasks.insert(task_id);
+    if (!it->second.dependent_tasks.insert(task_id).second) {
+      // The object was already passed as another argument.
+      continue;
+    }
 
     if (local_objects_.count(obj_id)) {
       task_entry.num_missing_dependencies--;
@@ -177,7 +181,8 @@ bool DependencyManager::RequestTaskDependencies(
   }
 
   if (!required_objects.empty()) {
-    task_entry.pull_request_id = object_manager_.Pull(required_objects);
+    task_entry.pull_request_id =
+        object_manager_.Pull(required_objects, BundlePriority::TASK_ARGS);
     RAY_LOG(DEBUG) << "Started pull for dependencies of task " << task_id
                    << " request: " << task_entry.pull_request_id;
   }
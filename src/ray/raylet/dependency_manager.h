@@ -200,10 +200,11 @@ class DependencyManager : public TaskDependencyManagerInterface {
 
   /// A struct to represent the object dependencies of a task.
   struct TaskDependencies {
-    TaskDependencies(const std::vector<rpc::ObjectReference> &deps)
-        : num_missing_dependencies(deps.size()) {
+    TaskDependencies(const std::vector<rpc::ObjectReference> &deps) {
       const auto dep_ids = ObjectRefsToIds(deps);
       dependencies.insert(dep_ids.begin(), dep_ids.end());
+      // An object may be passed several times, but it only arrives once.
+      num_missing_dependencies = dependencies.size();
     }
     /// The objects that the task depends on. These are the arguments to the
     /// task. These must all be simultaneously local before the task is ready
@@ -31,7 +31,8 @@ using ::testing::Return;
 
 class MockObjectManager : public ObjectManagerInterface {
  public:
-  uint64_t Pull(const std::vector<rpc::ObjectReference> &object_refs) {
+  uint64_t Pull(const std::vector<rpc::ObjectReference> &object_refs,
+                BundlePriority priority) {
     active_requests.insert(req_id);
     return req_id++;
   }
@@ -113,6 +114,37 @@ TEST_F(DependencyManagerTest, TestSimpleTask) {
   AssertNoLeaks();
 }
 
+/// Test a task that passes the same object as several arguments. The task should
+/// be ready once the object is local.
+TEST_F(DependencyManagerTest, TestDuplicateArguments) {
+  ObjectID argument_id = ObjectID::FromRandom();
+  ObjectID other_argument_id = ObjectID::FromRandom();
+  TaskID task_id = RandomTaskId();
+  EXPECT_CALL(reconstruction_policy_mock_, ListenAndMaybeReconstruct(argument_id, _));
+  EXPECT_CALL(reconstruction_policy_mock_,
+              ListenAndMaybeReconstruct(other_argument_id, _));
+  bool ready = dependency_manager_.RequestTaskDependencies(
+      task_id, ObjectIdsToRefs({argument_id, other_argument_id, argument_id}));
+  ASSERT_FALSE(ready);
+
+  EXPECT_CALL(reconstruction_policy_mock_, Cancel(argument_id));
+  EXPECT_CALL(reconstruction_policy_mock_, Cancel(other_argument_id));
+  ASSERT_TRUE(dependency_manager_.HandleObjectLocal(other_argument_id).empty());
+  auto ready_task_ids = dependency_manager_.HandleObjectLocal(argument_id);
+  ASSERT_EQ(ready_task_ids, std::vector<TaskID>({task_id}));
+  ASSERT_TRUE(dependency_manager_.IsTaskReady(task_id));
+
+  // The task waits for the object again once it is evicted.
+  EXPECT_CALL(reconstruction_policy_mock_, ListenAndMaybeReconstruct(argument_id, _));
+  auto waiting_task_ids = dependency_manager_.HandleObjectMissing(argument_id);
+  ASSERT_EQ(waiting_task_ids, std::vector<TaskID>({task_id}));
+  ASSERT_FALSE(dependency_manager_.IsTaskReady(task_id));
+
+  EXPECT_CALL(reconstruction_policy_mock_, Cancel(argument_id));
+  dependency_manager_.RemoveTaskDependencies(task_id);
+  AssertNoLeaks();
+}
+
 /// Test multiple tasks that depend on the same object. The dependency manager
 /// should return all task IDs as ready once the object is local.
 TEST_F(DependencyManagerTest, TestMultipleTasks) {
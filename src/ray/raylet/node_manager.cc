@@ -14,6 +14,7 @@
 
 #include "ray/raylet/node_manager.h"
 
+#include <algorithm>
 #include <cctype>
 #include <fstream>
 #include <memory>
@@ -203,6 +204,8 @@ NodeManager::NodeManager(boost::asio::io_service &io_service, const NodeID &self
         std::shared_ptr<ClusterResourceScheduler>(new ClusterResourceScheduler(
             self_node_id_.Binary(),
             local_resources.GetTotalResources().GetResourceMap()));
+    new_resource_scheduler_->SetNodeTopology(
+        NodeTopology::Load(RayConfig::instance().node_topology_file()));
 
     auto get_node_info_func = [this](const NodeID &node_id) {
       return gcs_client_->Nodes().Get(node_id);
@@ -242,6 +245,18 @@ NodeManager::NodeManager(boost::asio::io_service &io_service, const NodeID &self
                        }));
 
   RAY_CHECK_OK(SetupPlasmaSubscription());
+
+  if (RayConfig::instance().raylet_shared_memory_ipc_enabled()) {
+    auto doorbell = SharedMemoryDoorbell::Create("/ray_doorbell_" + self_node_id_.Hex());
+    if (doorbell) {
+      message_ring_poller_.reset(new MessageRingPoller(
+          io_service_, std::move(doorbell),
+          RayConfig::instance().raylet_shared_memory_ipc_batch_size()));
+    } else {
+      RAY_LOG(WARNING) << "Shared memory is not available, so workers will send "
+                          "messages to the raylet through sockets only.";
+    }
+  }
 }
 
 ray::Status NodeManager::RegisterGcs() {
@@ -331,18 +346,19 @@ void NodeManager::KillWorker(std::shared_ptr<WorkerInterface> worker) {
   // If we're just cleaning up a single worker, allow it some time to clean
   // up its state before force killing. The client socket will be closed
   // and the worker struct will be freed after the timeout.
-  kill(worker->GetProcess().GetId(), SIGTERM);
+  worker_pool_.KillWorkerProcess(worker->GetProcess(), /*graceful=*/true);
 #endif
 
   auto retry_timer = std::make_shared<boost::asio::deadline_timer>(io_service_);
   auto retry_duration = boost::posix_time::milliseconds(
       RayConfig::instance().kill_worker_timeout_milliseconds());
   retry_timer->expires_from_now(retry_duration);
-  retry_timer->async_wait([retry_timer, worker](const boost::system::error_code &error) {
-    RAY_LOG(DEBUG) << "Send SIGKILL to worker, pid=" << worker->GetProcess().GetId();
-    // Force kill worker
-    worker->GetProcess().Kill();
-  });
+  retry_timer->async_wait(
+      [this, retry_timer, worker](const boost::system::error_code &error) {
+        RAY_LOG(DEBUG) << "Send SIGKILL to worker, pid=" << worker->GetProcess().GetId();
+        // Force kill worker
+        worker_pool_.KillWorkerProcess(worker->GetProcess());
+      });
 }
 
 void NodeManager::DestroyWorker(std::shared_ptr<WorkerInterface> worker) {
@@ -403,14 +419,25 @@ void NodeManager::Heartbeat() {
   last_heartbeat_at_ms_ = now_ms;
   stats::HeartbeatReportMs.Record(interval);
 
-  auto heartbeat_data = std::make_shared<HeartbeatTableData>();
-  heartbeat_data->set_node_id(self_node_id_.Binary());
-  RAY_CHECK_OK(
-      gcs_client_->Nodes().AsyncReportHeartbeat(heartbeat_data, [](Status status) {
-        if (status.IsDisconnected()) {
-          RAY_LOG(FATAL) << "This node has beem marked as dead.";
-        }
-      }));
+  bool skip_heartbeat =
+      RayConfig::instance().raylet_liveness_from_resource_reports() &&
+      now_ms - last_resource_report_at_ms_ <
+          static_cast<uint64_t>(heartbeat_period_.count()) &&
+      num_heartbeats_skipped_ <
+          RayConfig::instance().raylet_liveness_max_skipped_heartbeats();
+  if (skip_heartbeat) {
+    num_heartbeats_skipped_++;
+  } else {
+    num_heartbeats_skipped_ = 0;
+    auto heartbeat_data = std::make_shared<HeartbeatTableData>();
+    heartbeat_data->set_node_id(self_node_id_.Binary());
+    RAY_CHECK_OK(
+        gcs_client_->Nodes().AsyncReportHeartbeat(heartbeat_data, [](Status status) {
+          if (status.IsDisconnected()) {
+            RAY_LOG(FATAL) << "This node has beem marked as dead.";
+          }
+        }));
+  }
 
   if (debug_dump_period_ > 0 &&
       static_cast<int64_t>(now_ms - last_debug_dump_at_ms_) > debug_dump_period_) {
@@ -520,6 +547,7 @@ void NodeManager::ReportResourceUsage() {
       resources_data->resource_load_changed() || resources_data->should_global_gc()) {
     RAY_CHECK_OK(gcs_client_->NodeResources().AsyncReportResourceUsage(resources_data,
                                                                        /*done*/ nullptr));
+    last_resource_report_at_ms_ = current_time_ms();
   }
 
   // Reset the timer.
@@ -1199,7 +1227,8 @@ void NodeManager::ProcessRegisterClientRequestMessage(
       std::make_shared<Worker>(job_id, worker_id, language, worker_type,
                                worker_ip_address, client, client_call_manager_));
 
-  auto send_reply_callback = [this, client](Status status, int assigned_port) {
+  auto send_reply_callback = [this, client, worker_id](Status status,
+                                                       int assigned_port) {
     flatbuffers::FlatBufferBuilder fbb;
     std::vector<std::string> system_config_keys;
     std::vector<std::string> system_config_values;
@@ -1207,11 +1236,28 @@ void NodeManager::ProcessRegisterClientRequestMessage(
       system_config_keys.push_back(kv.first);
       system_config_values.push_back(kv.second);
     }
+    // Attach the message ring before the reply is sent, since the client may write
+    // to the ring as soon as it receives the reply.
+    std::string message_ring_name;
+    std::string message_ring_doorbell_name;
+    if (status.ok() && message_ring_poller_) {
+      std::shared_ptr<SharedMemoryRing> ring = SharedMemoryRing::Create(
+          "/ray_ipc_" + worker_id.Hex(),
+          RayConfig::instance().raylet_shared_memory_ipc_ring_bytes());
+      if (ring) {
+        message_ring_name = ring->Name();
+        message_ring_doorbell_name = message_ring_poller_->DoorbellName();
+        client->AttachMessageRing(std::move(ring));
+        message_ring_poller_->AddClient(client);
+      }
+    }
     auto reply = ray::protocol::CreateRegisterClientReply(
         fbb, status.ok(), fbb.CreateString(status.ToString()),
         to_flatbuf(fbb, self_node_id_), assigned_port,
         string_vec_to_flatbuf(fbb, system_config_keys),
-        string_vec_to_flatbuf(fbb, system_config_values));
+        string_vec_to_flatbuf(fbb, system_config_values),
+        fbb.CreateString(message_ring_name),
+        fbb.CreateString(message_ring_doorbell_name));
     fbb.Finish(reply);
     client->WriteMessageAsync(
         static_cast<int64_t>(protocol::MessageType::RegisterClientReply), fbb.GetSize(),
@@ -1612,6 +1658,13 @@ void NodeManager::HandleRequestWorkerLease(const rpc::RequestWorkerLeaseRequest
     backlog_size = request.backlog_size();
   }
   Task task(task_message, backlog_size);
+  if (request.local_object_bytes_size() > 0) {
+    std::unordered_map<std::string, int64_t> local_object_bytes;
+    for (const auto &entry : request.local_object_bytes()) {
+      local_object_bytes[entry.node_id()] = entry.object_bytes();
+    }
+    task.SetLocalObjectBytes(std::move(local_object_bytes));
+  }
   bool is_actor_creation_task = task.GetTaskSpecification().IsActorCreationTask();
   ActorID actor_id = ActorID::Nil();
   metrics_num_task_scheduled_ += 1;
@@ -1705,14 +1758,55 @@ void NodeManager::HandleRequestWorkerLease(const rpc::RequestWorkerLeaseRequest
   SubmitTask(task);
 }
 
+void NodeManager::HandleRequestWorkerLeases(
+    const rpc::RequestWorkerLeasesRequest &request, rpc::RequestWorkerLeasesReply *reply,
+    rpc::SendReplyCallback send_reply_callback) {
+  const int num_leases = request.requests_size();
+  if (num_leases == 0) {
+    send_reply_callback(Status::OK(), nullptr, nullptr);
+    return;
+  }
+  // Add all the replies first, so that their addresses stay the same while the leases
+  // are handled.
+  for (int i = 0; i < num_leases; i++) {
+    reply->add_replies();
+  }
+  // The failure handlers release the workers that were granted if the reply to the
+  // whole batch can't be sent.
+  auto num_pending = std::make_shared<int>(num_leases);
+  auto failure_handlers = std::make_shared<std::vector<std::function<void()>>>();
+  for (int i = 0; i < num_leases; i++) {
+    HandleRequestWorkerLease(
+        request.requests(i), reply->mutable_replies(i),
+        [num_pending, failure_handlers, send_reply_callback](
+            Status status, std::function<void()> success,
+            std::function<void()> failure) {
+          if (failure) {
+            failure_handlers->push_back(std::move(failure));
+          }
+          if (--*num_pending > 0) {
+            return;
+          }
+          send_reply_callback(Status::OK(), nullptr, [failure_handlers]() {
+            for (const auto &failure : *failure_handlers) {
+              failure();
+            }
+          });
+        });
+  }
+}
+
 void NodeManager::HandlePrepareBundleResources(
     const rpc::PrepareBundleResourcesRequest &request,
     rpc::PrepareBundleResourcesReply *reply, rpc::SendReplyCallback send_reply_callback) {
-  auto bundle_spec = BundleSpecification(request.bundle_spec());
-  RAY_LOG(DEBUG) << "Request to prepare bundle resources is received, "
-                 << bundle_spec.DebugString();
+  std::vector<BundleSpecification> bundle_specs;
+  for (const auto &bundle : request.bundle_specs()) {
+    bundle_specs.emplace_back(bundle);
+    RAY_LOG(DEBUG) << "Request to prepare bundle resources is received, "
+                   << bundle_specs.back().DebugString();
+  }
 
-  auto prepared = placement_group_resource_manager_->PrepareBundle(bundle_spec);
+  auto prepared = placement_group_resource_manager_->PrepareBundles(bundle_specs);
   reply->set_success(prepared);
   send_reply_callback(Status::OK(), nullptr, nullptr);
 
@@ -1726,10 +1820,13 @@ void NodeManager::HandlePrepareBundleResources(
 void NodeManager::HandleCommitBundleResources(
     const rpc::CommitBundleResourcesRequest &request,
     rpc::CommitBundleResourcesReply *reply, rpc::SendReplyCallback send_reply_callback) {
-  auto bundle_spec = BundleSpecification(request.bundle_spec());
-  RAY_LOG(DEBUG) << "Request to commit bundle resources is received, "
-                 << bundle_spec.DebugString();
-  placement_group_resource_manager_->CommitBundle(bundle_spec);
+  std::vector<BundleSpecification> bundle_specs;
+  for (const auto &bundle : request.bundle_specs()) {
+    bundle_specs.emplace_back(bundle);
+    RAY_LOG(DEBUG) << "Request to commit bundle resources is received, "
+                   << bundle_specs.back().DebugString();
+  }
+  placement_group_resource_manager_->CommitBundles(bundle_specs);
   send_reply_callback(Status::OK(), nullptr, nullptr);
 
   if (new_scheduler_enabled_) {
@@ -2479,6 +2576,21 @@ void NodeManager::HandleObjectLocal(const ObjectID &object_id) {
   RAY_LOG(DEBUG) << "Object local " << object_id << ", "
                  << " on " << self_node_id_ << ", " << ready_task_ids.size()
                  << " tasks ready";
+  if (ready_task_ids.empty()) {
+    return;
+  }
+  unblocked_task_ids_.insert(unblocked_task_ids_.end(), ready_task_ids.begin(),
+                             ready_task_ids.end());
+  if (!dispatch_unblocked_tasks_posted_) {
+    dispatch_unblocked_tasks_posted_ = true;
+    io_service_.post([this]() { DispatchUnblockedTasks(); });
+  }
+}
+
+void NodeManager::DispatchUnblockedTasks() {
+  dispatch_unblocked_tasks_posted_ = false;
+  std::vector<TaskID> ready_task_ids;
+  ready_task_ids.swap(unblocked_task_ids_);
   // Transition the tasks whose dependencies are now fulfilled to the ready state.
   if (new_scheduler_enabled_) {
     cluster_task_manager_->TasksUnblocked(ready_task_ids);
@@ -2523,7 +2635,20 @@ bool NodeManager::IsActorCreationTask(const TaskID &task_id) {
 
 void NodeManager::HandleObjectMissing(const ObjectID &object_id) {
   // Notify the task dependency manager that this object is no longer local.
-  const auto waiting_task_ids = dependency_manager_.HandleObjectMissing(object_id);
+  auto waiting_task_ids = dependency_manager_.HandleObjectMissing(object_id);
+  if (!unblocked_task_ids_.empty() && !waiting_task_ids.empty()) {
+    // The tasks that were unblocked but not dispatched yet are still waiting, so
+    // they just stay that way.
+    absl::flat_hash_set<TaskID> waiting_task_id_set(waiting_task_ids.begin(),
+                                                    waiting_task_ids.end());
+    unblocked_task_ids_.erase(
+        std::remove_if(unblocked_task_ids_.begin(), unblocked_task_ids_.end(),
+                       [&waiting_task_id_set](const TaskID &task_id) {
+                         return waiting_task_id_set.erase(task_id) > 0;
+                       }),
+        unblocked_task_ids_.end());
+    waiting_task_ids.assign(waiting_task_id_set.begin(), waiting_task_id_set.end());
+  }
   std::stringstream result;
   result << "Object missing " << object_id << ", "
          << " on " << self_node_id_ << ", " << waiting_task_ids.size()
@@ -405,6 +405,10 @@ class NodeManager : public rpc::NodeManagerServiceHandler {
   /// \param object_id The object that is locally available.
   /// \return Void.
   void HandleObjectLocal(const ObjectID &object_id);
+  /// Dispatch the tasks that were unblocked by objects becoming local since the
+  /// last call. Objects often become local in bursts, so this is posted to the
+  /// event loop once per burst rather than run once per object.
+  void DispatchUnblockedTasks();
   /// Handle an object that is no longer local. This updates any local
   /// accounting, but does not write to any global accounting in the GCS.
   ///
@@ -559,6 +563,11 @@ class NodeManager : public rpc::NodeManagerServiceHandler {
                                 rpc::RequestWorkerLeaseReply *reply,
                                 rpc::SendReplyCallback send_reply_callback) override;
 
+  /// Handle a `RequestWorkerLeases` request.
+  void HandleRequestWorkerLeases(const rpc::RequestWorkerLeasesRequest &request,
+                                 rpc::RequestWorkerLeasesReply *reply,
+                                 rpc::SendReplyCallback send_reply_callback) override;
+
   /// Handle a `ReturnWorker` request.
   void HandleReturnWorker(const rpc::ReturnWorkerRequest &request,
                           rpc::ReturnWorkerReply *reply,
@@ -674,6 +683,12 @@ class NodeManager : public rpc::NodeManagerServiceHandler {
   /// The time that the last heartbeat was sent at. Used to make sure we are
   /// keeping up with heartbeats.
   uint64_t last_heartbeat_at_ms_;
+  /// The time that the last resource usage report was sent at. The GCS counts
+  /// a resource report as a heartbeat, so a heartbeat RPC is not needed if a
+  /// report was sent recently.
+  uint64_t last_resource_report_at_ms_ = 0;
+  /// The number of heartbeat RPCs skipped in a row because of resource reports.
+  int64_t num_heartbeats_skipped_ = 0;
   /// The time that the last debug string was logged to the console.
   uint64_t last_debug_dump_at_ms_;
   /// The number of heartbeats that we should wait before sending the
@@ -688,6 +703,9 @@ class NodeManager : public rpc::NodeManagerServiceHandler {
 
   /// A pool of workers.
   WorkerPool worker_pool_;
+  /// Delivers the messages that workers write to their shared-memory message rings.
+  /// This is null unless shared-memory IPC is enabled.
+  std::unique_ptr<MessageRingPoller> message_ring_poller_;
   /// A set of queues to maintain tasks.
   SchedulingQueue local_queues_;
   /// The scheduling policy in effect for this raylet.
@@ -697,6 +715,10 @@ class NodeManager : public rpc::NodeManagerServiceHandler {
   /// A manager to resolve objects needed by queued tasks and workers that
   /// called `ray.get` or `ray.wait`.
   DependencyManager dependency_manager_;
+  /// The tasks whose dependencies became local, and that were not dispatched yet.
+  std::vector<TaskID> unblocked_task_ids_;
+  /// Whether DispatchUnblockedTasks is posted to the event loop.
+  bool dispatch_unblocked_tasks_posted_ = false;
 
   std::unique_ptr<AgentManager> agent_manager_;
 
@@ -34,6 +34,34 @@ void PlacementGroupResourceManager::ReturnUnusedBundle(
   }
 }
 
+bool PlacementGroupResourceManager::PrepareBundles(
+    const std::vector<BundleSpecification> &bundle_specs) {
+  std::vector<const BundleSpecification *> prepared_bundles;
+  for (const auto &bundle_spec : bundle_specs) {
+    bool committed = IsBundleCommitted(bundle_spec.BundleId());
+    if (!PrepareBundle(bundle_spec)) {
+      // Roll back the bundles prepared by this batch, so that a failed batch doesn't
+      // lock resources until the GCS cancels it.
+      for (const auto *prepared_bundle : prepared_bundles) {
+        ReturnBundle(*prepared_bundle);
+        bundle_spec_map_.erase(prepared_bundle->BundleId());
+      }
+      return false;
+    }
+    if (!committed) {
+      prepared_bundles.push_back(&bundle_spec);
+    }
+  }
+  return true;
+}
+
+void PlacementGroupResourceManager::CommitBundles(
+    const std::vector<BundleSpecification> &bundle_specs) {
+  for (const auto &bundle_spec : bundle_specs) {
+    CommitBundle(bundle_spec);
+  }
+}
+
 OldPlacementGroupResourceManager::OldPlacementGroupResourceManager(
     ResourceIdSet &local_available_resources_,
     std::unordered_map<NodeID, SchedulingResources> &cluster_resource_map_,
@@ -148,6 +176,12 @@ void OldPlacementGroupResourceManager::ReturnBundle(
       ResourceSet(placement_group_resource_labels));
 }
 
+bool OldPlacementGroupResourceManager::IsBundleCommitted(
+    const BundleID &bundle_id) const {
+  auto it = bundle_state_map_.find(bundle_id);
+  return it != bundle_state_map_.end() && it->second->state == CommitState::COMMITTED;
+}
+
 NewPlacementGroupResourceManager::NewPlacementGroupResourceManager(
     std::shared_ptr<ClusterResourceScheduler> cluster_resource_scheduler_)
     : cluster_resource_scheduler_(cluster_resource_scheduler_) {}
@@ -250,5 +284,11 @@ void NewPlacementGroupResourceManager::ReturnBundle(
   pg_bundles_.erase(it);
 }
 
+bool NewPlacementGroupResourceManager::IsBundleCommitted(
+    const BundleID &bundle_id) const {
+  auto it = pg_bundles_.find(bundle_id);
+  return it != pg_bundles_.end() && it->second->state_ == CommitState::COMMITTED;
+}
+
 }  // namespace raylet
 }  // namespace ray
@@ -74,6 +74,19 @@ class PlacementGroupResourceManager {
   /// \param bundle_spec: Specification of bundle whose resources will be returned.
   virtual void ReturnBundle(const BundleSpecification &bundle_spec) = 0;
 
+  /// Prepare a batch of bundles atomically. If any bundle cannot be prepared, the
+  /// bundles prepared by this call are returned and the call fails. Bundles that were
+  /// already committed are left untouched.
+  ///
+  /// \param bundle_specs: Specifications of bundles whose resources will be prepared.
+  /// \return True if all the bundles are prepared.
+  bool PrepareBundles(const std::vector<BundleSpecification> &bundle_specs);
+
+  /// Commit a batch of bundles.
+  ///
+  /// \param bundle_specs: Specifications of bundles whose resources will be commited.
+  void CommitBundles(const std::vector<BundleSpecification> &bundle_specs);
+
   /// Return back all the bundle(which is unused) resource.
   ///
   /// \param bundle_spec: A set of bundles which in use.
@@ -82,6 +95,11 @@ class PlacementGroupResourceManager {
   virtual ~PlacementGroupResourceManager() {}
 
  protected:
+  /// Whether the bundle is in the committed state.
+  ///
+  /// \param bundle_id: ID of the bundle.
+  virtual bool IsBundleCommitted(const BundleID &bundle_id) const = 0;
+
   /// Save `BundleSpecification` for cleaning leaked bundles after GCS restart.
   absl::flat_hash_map<BundleID, std::shared_ptr<BundleSpecification>, pair_hash>
       bundle_spec_map_;
@@ -120,6 +138,8 @@ class OldPlacementGroupResourceManager : public PlacementGroupResourceManager {
   }
 
  private:
+  bool IsBundleCommitted(const BundleID &bundle_id) const;
+
   /// The resources (and specific resource IDs) that are currently available.
   /// These two resource container is shared with `NodeManager`.
   ResourceIdSet &local_available_resources_;
@@ -156,6 +176,8 @@ class NewPlacementGroupResourceManager : public PlacementGroupResourceManager {
   }
 
  private:
+  bool IsBundleCommitted(const BundleID &bundle_id) const;
+
   std::shared_ptr<ClusterResourceScheduler> cluster_resource_scheduler_;
 
   /// Tracking placement group bundles and their states. This mapping is the source of
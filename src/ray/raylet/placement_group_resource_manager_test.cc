@@ -262,6 +262,34 @@ TEST_F(OldPlacementGroupResourceManagerTest, TestIdempotencyWithRandomOrder) {
   CheckRemainingResourceCorrect(result_resource);
 }
 
+TEST_F(OldPlacementGroupResourceManagerTest, TestPrepareBundlesIsAtomic) {
+  // 1. create bundle specs.
+  auto group_id = PlacementGroupID::FromRandom();
+  std::unordered_map<std::string, double> first_unit_resource = {{"CPU", 1.0}};
+  std::unordered_map<std::string, double> second_unit_resource = {{"CPU", 2.0}};
+  auto first_bundle_spec = Mocker::GenBundleCreation(group_id, 1, first_unit_resource);
+  auto second_bundle_spec = Mocker::GenBundleCreation(group_id, 2, second_unit_resource);
+  /// 2. init local available resource.
+  std::unordered_map<std::string, double> available_resource = {
+      std::make_pair("CPU", 2.0)};
+  InitLocalAvailableResource(available_resource);
+  /// 3. the second bundle doesn't fit, so the first one is rolled back.
+  ASSERT_FALSE(old_placement_group_resource_manager_->PrepareBundles(
+      {first_bundle_spec, second_bundle_spec}));
+  ResourceSet result_resource(available_resource);
+  CheckRemainingResourceCorrect(result_resource);
+  /// 4. a failed batch doesn't return the bundles that were already committed.
+  ASSERT_TRUE(old_placement_group_resource_manager_->PrepareBundles({first_bundle_spec}));
+  old_placement_group_resource_manager_->CommitBundles({first_bundle_spec});
+  ASSERT_FALSE(old_placement_group_resource_manager_->PrepareBundles(
+      {first_bundle_spec, second_bundle_spec}));
+  std::vector<std::string> resource_labels = {"CPU", "CPU_group_" + group_id.Hex(),
+                                              "CPU_group_1_" + group_id.Hex()};
+  std::vector<double> resource_capacity = {1.0, 1.0, 1.0};
+  result_resource = ResourceSet(resource_labels, resource_capacity);
+  CheckRemainingResourceCorrect(result_resource);
+}
+
 class NewPlacementGroupResourceManagerTest : public ::testing::Test {
  public:
   std::unique_ptr<raylet::NewPlacementGroupResourceManager>
@@ -318,6 +346,25 @@ TEST_F(NewPlacementGroupResourceManagerTest,
   ASSERT_FALSE(new_placement_group_resource_manager_->PrepareBundle(bundle_spec));
 }
 
+TEST_F(NewPlacementGroupResourceManagerTest, TestNewPrepareBundlesIsAtomic) {
+  // 1. create bundle specs.
+  auto group_id = PlacementGroupID::FromRandom();
+  std::unordered_map<std::string, double> first_unit_resource = {{"CPU", 1.0}};
+  std::unordered_map<std::string, double> second_unit_resource = {{"CPU", 2.0}};
+  auto first_bundle_spec = Mocker::GenBundleCreation(group_id, 1, first_unit_resource);
+  auto second_bundle_spec = Mocker::GenBundleCreation(group_id, 2, second_unit_resource);
+  /// 2. init local available resource.
+  std::unordered_map<std::string, double> init_unit_resource;
+  init_unit_resource.insert({"CPU", 2.0});
+  InitLocalAvailableResource(init_unit_resource);
+  /// 3. the second bundle doesn't fit, so the first one is rolled back.
+  ASSERT_FALSE(new_placement_group_resource_manager_->PrepareBundles(
+      {first_bundle_spec, second_bundle_spec}));
+  /// 4. all the resources are available again.
+  ASSERT_TRUE(new_placement_group_resource_manager_->PrepareBundles({second_bundle_spec}));
+  CheckAvailableResoueceEmpty("CPU");
+}
+
 TEST_F(NewPlacementGroupResourceManagerTest, TestNewCommitBundleResource) {
   // 1. create bundle spec.
   auto group_id = PlacementGroupID::FromRandom();
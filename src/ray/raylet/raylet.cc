@@ -66,8 +66,8 @@ Raylet::Raylet(boost::asio::io_service &main_service, const std::string &socket_
       object_directory_(
           RayConfig::instance().ownership_based_object_directory_enabled()
               ? std::dynamic_pointer_cast<ObjectDirectoryInterface>(
-                    std::make_shared<OwnershipBasedObjectDirectory>(main_service,
-                                                                    gcs_client_))
+                    std::make_shared<OwnershipBasedObjectDirectory>(
+                        main_service, gcs_client_, self_node_id_))
               : std::dynamic_pointer_cast<ObjectDirectoryInterface>(
                     std::make_shared<ObjectDirectory>(main_service, gcs_client_))),
       object_manager_(
@@ -58,6 +58,43 @@ std::vector<double> VectorFixedPointToVectorDouble(
   return vector;
 }
 
+int64_t PredefinedResourceIndex(const std::string &resource_name) {
+  if (resource_name == ray::kCPU_ResourceLabel) {
+    return CPU;
+  } else if (resource_name == ray::kGPU_ResourceLabel) {
+    return GPU;
+  } else if (resource_name == ray::kTPU_ResourceLabel) {
+    return TPU;
+  } else if (resource_name == ray::kMemory_ResourceLabel) {
+    return MEM;
+  }
+  return -1;
+}
+
+bool ParseBundleResource(StringIdMap &string_to_int_map, const std::string &resource_name,
+                         ray::BundleID *bundle_id, int64_t *resource_id) {
+  std::string original_resource_name;
+  if (!ray::ParsePlacementGroupResource(resource_name, &original_resource_name,
+                                        bundle_id)) {
+    return false;
+  }
+  *resource_id = PredefinedResourceIndex(original_resource_name);
+  if (*resource_id == -1) {
+    *resource_id = string_to_int_map.Insert(original_resource_name);
+  }
+  return true;
+}
+
+std::string BundleResourceName(const StringIdMap &string_to_int_map,
+                               const ray::BundleID &bundle_id, int64_t resource_id) {
+  const std::string original_resource_name =
+      resource_id >= 0 && resource_id < PredefinedResources_MAX
+          ? ResourceEnumToString(static_cast<PredefinedResources>(resource_id))
+          : string_to_int_map.Get(static_cast<uint64_t>(resource_id));
+  return ray::FormatPlacementGroupResource(original_resource_name, bundle_id.first,
+                                           bundle_id.second);
+}
+
 /// Convert a map of resources to a TaskRequest data structure.
 TaskRequest ResourceMapToTaskRequest(
     StringIdMap &string_to_int_map,
@@ -74,6 +111,7 @@ TaskRequest ResourceMapToTaskRequest(
   }
 
   for (auto const &resource : resource_map) {
+    BundleResourceRequest bundle_request;
     if (resource.first == ray::kCPU_ResourceLabel) {
       task_request.predefined_resources[CPU].demand = resource.second;
     } else if (resource.first == ray::kGPU_ResourceLabel) {
@@ -82,6 +120,11 @@ TaskRequest ResourceMapToTaskRequest(
       task_request.predefined_resources[TPU].demand = resource.second;
     } else if (resource.first == ray::kMemory_ResourceLabel) {
       task_request.predefined_resources[MEM].demand = resource.second;
+    } else if (ParseBundleResource(string_to_int_map, resource.first,
+                                   &bundle_request.bundle_id, &bundle_request.id)) {
+      bundle_request.demand = resource.second;
+      bundle_request.soft = false;
+      task_request.bundle_resources.push_back(bundle_request);
     } else {
       string_to_int_map.Insert(resource.first);
       task_request.custom_resources[i].id = string_to_int_map.Get(resource.first);
@@ -118,6 +161,20 @@ TaskRequest TaskResourceInstances::ToTaskRequest() const {
     }
     i++;
   }
+
+  for (const auto &bundle : this->bundle_resources) {
+    for (const auto &resource : bundle.second) {
+      BundleResourceRequest bundle_request;
+      bundle_request.bundle_id = bundle.first;
+      bundle_request.id = resource.first;
+      bundle_request.soft = false;
+      bundle_request.demand = 0;
+      for (const auto &instance : resource.second) {
+        bundle_request.demand += instance;
+      }
+      task_req.bundle_resources.push_back(bundle_request);
+    }
+  }
   return task_req;
 }
 
@@ -148,6 +205,8 @@ NodeResources ResourceMapToNodeResources(
     } else {
       resource_capacity.available = it->second;
     }
+    ray::BundleID bundle_id;
+    int64_t resource_id;
     if (resource.first == ray::kCPU_ResourceLabel) {
       node_resources.predefined_resources[CPU] = resource_capacity;
     } else if (resource.first == ray::kGPU_ResourceLabel) {
@@ -156,6 +215,9 @@ NodeResources ResourceMapToNodeResources(
       node_resources.predefined_resources[TPU] = resource_capacity;
     } else if (resource.first == ray::kMemory_ResourceLabel) {
       node_resources.predefined_resources[MEM] = resource_capacity;
+    } else if (ParseBundleResource(string_to_int_map, resource.first, &bundle_id,
+                                   &resource_id)) {
+      node_resources.bundle_resources[bundle_id][resource_id] = resource_capacity;
     } else {
       // This is a custom resource.
       node_resources.custom_resources.emplace(string_to_int_map.Insert(resource.first),
@@ -165,7 +227,7 @@ NodeResources ResourceMapToNodeResources(
   return node_resources;
 }
 
-bool NodeResources::operator==(const NodeResources &other) {
+bool NodeResources::operator==(const NodeResources &other) const {
   for (size_t i = 0; i < PredefinedResources_MAX; i++) {
     if (this->predefined_resources[i].total != other.predefined_resources[i].total) {
       return false;
@@ -193,10 +255,31 @@ bool NodeResources::operator==(const NodeResources &other) {
       return false;
     }
   }
+
+  if (this->bundle_resources.size() != other.bundle_resources.size()) {
+    return false;
+  }
+
+  for (const auto &bundle : this->bundle_resources) {
+    auto it = other.bundle_resources.find(bundle.first);
+    if (it == other.bundle_resources.end() || it->second.size() != bundle.second.size()) {
+      return false;
+    }
+    for (const auto &resource : bundle.second) {
+      auto resource_it = it->second.find(resource.first);
+      if (resource_it == it->second.end() ||
+          resource.second.total != resource_it->second.total ||
+          resource.second.available != resource_it->second.available) {
+        return false;
+      }
+    }
+  }
   return true;
 }
 
-bool NodeResources::operator!=(const NodeResources &other) { return !(*this == other); }
+bool NodeResources::operator!=(const NodeResources &other) const {
+  return !(*this == other);
+}
 
 std::string NodeResources::DebugString(StringIdMap string_to_in_map) const {
   std::stringstream buffer;
@@ -228,6 +311,13 @@ std::string NodeResources::DebugString(StringIdMap string_to_in_map) const {
     buffer << "\t" << string_to_in_map.Get(it->first) << ":(" << it->second.total << ":"
            << it->second.available << ")\n";
   }
+  for (const auto &bundle : this->bundle_resources) {
+    for (const auto &resource : bundle.second) {
+      buffer << "\t" << BundleResourceName(string_to_in_map, bundle.first, resource.first)
+             << ":(" << resource.second.total << ":" << resource.second.available
+             << ")\n";
+    }
+  }
   buffer << "}" << std::endl;
   return buffer.str();
 }
@@ -283,6 +373,14 @@ std::string NodeResources::DictString(StringIdMap string_to_in_map) const {
            << format_resource(name, it->second.total.Double());
     buffer << " " << name;
   }
+  for (const auto &bundle : this->bundle_resources) {
+    for (const auto &resource : bundle.second) {
+      auto name = BundleResourceName(string_to_in_map, bundle.first, resource.first);
+      buffer << ", " << format_resource(name, resource.second.available.Double()) << "/"
+             << format_resource(name, resource.second.total.Double());
+      buffer << " " << name;
+    }
+  }
   buffer << "}" << std::endl;
   return buffer.str();
 }
@@ -316,6 +414,25 @@ bool NodeResourceInstances::operator==(const NodeResourceInstances &other) {
       return false;
     }
   }
+
+  if (this->bundle_resources.size() != other.bundle_resources.size()) {
+    return false;
+  }
+
+  for (const auto &bundle : this->bundle_resources) {
+    auto it = other.bundle_resources.find(bundle.first);
+    if (it == other.bundle_resources.end() || it->second.size() != bundle.second.size()) {
+      return false;
+    }
+    for (const auto &resource : bundle.second) {
+      auto resource_it = it->second.find(resource.first);
+      if (resource_it == it->second.end() ||
+          !EqualVectors(resource.second.total, resource_it->second.total) ||
+          !EqualVectors(resource.second.available, resource_it->second.available)) {
+        return false;
+      }
+    }
+  }
   return true;
 }
 
@@ -349,6 +466,14 @@ std::string NodeResourceInstances::DebugString(StringIdMap string_to_int_map) co
     buffer << "\t" << it->first << ":(" << VectorToString(it->second.total) << ":"
            << VectorToString(it->second.available) << ")\n";
   }
+  for (const auto &bundle : this->bundle_resources) {
+    for (const auto &resource : bundle.second) {
+      buffer << "\t"
+             << BundleResourceName(string_to_int_map, bundle.first, resource.first)
+             << ":(" << VectorToString(resource.second.total) << ":"
+             << VectorToString(resource.second.available) << ")\n";
+    }
+  }
   buffer << "}" << std::endl;
   return buffer.str();
 };
@@ -365,6 +490,13 @@ TaskResourceInstances NodeResourceInstances::GetAvailableResourceInstances() {
     task_resources.custom_resources.emplace(it.first, it.second.available);
   }
 
+  for (const auto &bundle : this->bundle_resources) {
+    auto &bundle_resources = task_resources.bundle_resources[bundle.first];
+    for (const auto &resource : bundle.second) {
+      bundle_resources.emplace(resource.first, resource.second.available);
+    }
+  }
+
   return task_resources;
 };
 
@@ -379,6 +511,11 @@ bool TaskRequest::IsEmpty() const {
       return false;
     }
   }
+  for (const auto &bundle_resource : this->bundle_resources) {
+    if (bundle_resource.demand != 0) {
+      return false;
+    }
+  }
   return true;
 }
 
@@ -397,6 +534,11 @@ std::string TaskRequest::DebugString() const {
            << "(" << this->custom_resources[i].demand << ":"
            << this->custom_resources[i].soft << ") ";
   }
+  for (const auto &bundle_resource : this->bundle_resources) {
+    buffer << bundle_resource.id << "_group_" << bundle_resource.bundle_id.second << "_"
+           << bundle_resource.bundle_id.first << ":"
+           << "(" << bundle_resource.demand << ":" << bundle_resource.soft << ") ";
+  }
   buffer << "]" << std::endl;
   return buffer.str();
 }
@@ -418,6 +560,16 @@ bool TaskResourceInstances::IsEmpty() const {
       }
     }
   }
+
+  for (const auto &bundle : bundle_resources) {
+    for (const auto &bundle_resource : bundle.second) {
+      for (const auto &bundle_resource_instance : bundle_resource.second) {
+        if (bundle_resource_instance != 0) {
+          return false;
+        }
+      }
+    }
+  }
   return true;
 }
 
@@ -434,6 +586,12 @@ std::string TaskResourceInstances::DebugString() const {
        ++it) {
     buffer << it->first << ":" << VectorToString(it->second) << ", ";
   }
+  for (const auto &bundle : this->bundle_resources) {
+    for (const auto &resource : bundle.second) {
+      buffer << resource.first << "_group_" << bundle.first.second << "_"
+             << bundle.first.first << ":" << VectorToString(resource.second) << ", ";
+    }
+  }
 
   buffer << "]" << std::endl;
   return buffer.str();
@@ -464,5 +622,23 @@ bool TaskResourceInstances::operator==(const TaskResourceInstances &other) {
       return false;
     }
   }
+
+  if (this->bundle_resources.size() != other.bundle_resources.size()) {
+    return false;
+  }
+
+  for (const auto &bundle : this->bundle_resources) {
+    auto it = other.bundle_resources.find(bundle.first);
+    if (it == other.bundle_resources.end() || it->second.size() != bundle.second.size()) {
+      return false;
+    }
+    for (const auto &resource : bundle.second) {
+      auto resource_it = it->second.find(resource.first);
+      if (resource_it == it->second.end() ||
+          !EqualVectors(resource.second, resource_it->second)) {
+        return false;
+      }
+    }
+  }
   return true;
 }
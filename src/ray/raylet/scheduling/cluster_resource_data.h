@@ -20,6 +20,7 @@
 
 #include "absl/container/flat_hash_map.h"
 #include "absl/container/flat_hash_set.h"
+#include "ray/common/bundle_spec.h"
 #include "ray/common/task/scheduling_resources.h"
 #include "ray/raylet/scheduling/fixed_point.h"
 #include "ray/raylet/scheduling/scheduling_ids.h"
@@ -30,6 +31,29 @@ enum PredefinedResources { CPU, MEM, GPU, TPU, PredefinedResources_MAX };
 
 const std::string ResourceEnumToString(PredefinedResources resource);
 
+/// Get the index of a predefined resource.
+///
+/// \param resource_name: The name of the resource, e.g., "CPU".
+/// \return The PredefinedResources index, or -1 if the resource is not predefined.
+int64_t PredefinedResourceIndex(const std::string &resource_name);
+
+/// Parse the name of a placement group bundle resource, e.g.,
+/// `CPU_group_<bundle_index>_<pg_id>`.
+///
+/// \param string_to_int_map: Map between names and IDs of custom resources. The
+/// original resource is added to it, if it is a custom resource.
+/// \param resource_name: The name of the resource.
+/// \param[out] bundle_id: The bundle that reserved the resource.
+/// \param[out] resource_id: The ID of the original resource.
+/// \return Whether the resource is a placement group bundle resource.
+bool ParseBundleResource(StringIdMap &string_to_int_map, const std::string &resource_name,
+                         ray::BundleID *bundle_id, int64_t *resource_id);
+
+/// Get the name of a placement group bundle resource, e.g.,
+/// `CPU_group_<bundle_index>_<pg_id>`.
+std::string BundleResourceName(const StringIdMap &string_to_int_map,
+                               const ray::BundleID &bundle_id, int64_t resource_id);
+
 /// Helper function to compare two vectors with FixedPoint values.
 bool EqualVectors(const std::vector<FixedPoint> &v1, const std::vector<FixedPoint> &v2);
 
@@ -67,6 +91,19 @@ struct ResourceRequestWithId : ResourceRequest {
   int64_t id;
 };
 
+/// Request for a resource that a placement group bundle reserved, e.g.,
+/// `CPU_group_<bundle_index>_<pg_id>`. The ID is the one of the original resource: a
+/// predefined resource index or a custom resource ID.
+struct BundleResourceRequest : ResourceRequestWithId {
+  /// The placement group and the bundle index, or -1 for the resources of the whole
+  /// placement group (e.g., `CPU_group_<pg_id>`).
+  ray::BundleID bundle_id;
+};
+
+/// Capacities of the resources that a placement group bundle reserved on a node, by
+/// original resource ID.
+typedef absl::flat_hash_map<int64_t, ResourceCapacity> BundleResourceCapacities;
+
 // Data structure specifying the capacity of each resource requested by a task.
 class TaskRequest {
  public:
@@ -79,6 +116,12 @@ class TaskRequest {
   /// the task will run on a different node in the cluster, if none of the
   /// nodes in this list can schedule this task.
   absl::flat_hash_set<int64_t> placement_hints;
+  /// List of placement group bundle resources required by the task.
+  std::vector<BundleResourceRequest> bundle_resources;
+  /// The number of bytes of the task's arguments that each node already has local.
+  /// Like placement hints, this is a soft preference: it is traded off against the
+  /// load of the nodes that can run the task.
+  absl::flat_hash_map<int64_t, int64_t> local_object_bytes;
   /// Check whether the request contains no resources.
   bool IsEmpty() const;
   /// Returns human-readable string for this task request.
@@ -93,6 +136,11 @@ class TaskResourceInstances {
   std::vector<std::vector<FixedPoint>> predefined_resources;
   /// The list of instances of each custom resource allocated to a task.
   absl::flat_hash_map<int64_t, std::vector<FixedPoint>> custom_resources;
+  /// The list of instances of each placement group bundle resource allocated to a
+  /// task, by bundle and original resource ID.
+  absl::flat_hash_map<ray::BundleID,
+                      absl::flat_hash_map<int64_t, std::vector<FixedPoint>>>
+      bundle_resources;
   bool operator==(const TaskResourceInstances &other);
   /// For each resource of this request aggregate its instances.
   TaskRequest ToTaskRequest() const;
@@ -153,15 +201,21 @@ class NodeResources {
   NodeResources() {}
   NodeResources(const NodeResources &other)
       : predefined_resources(other.predefined_resources),
-        custom_resources(other.custom_resources) {}
+        custom_resources(other.custom_resources),
+        bundle_resources(other.bundle_resources) {}
   /// Available and total capacities for predefined resources.
   std::vector<ResourceCapacity> predefined_resources;
   /// Map containing custom resources. The key of each entry represents the
   /// custom resource ID.
   absl::flat_hash_map<int64_t, ResourceCapacity> custom_resources;
+  /// Map containing the resources reserved by placement group bundles, which are
+  /// reported as custom resources like `CPU_group_<bundle_index>_<pg_id>`. They are
+  /// indexed by bundle instead, so that each placement group doesn't add custom
+  /// resources that every scheduling decision has to go through.
+  absl::flat_hash_map<ray::BundleID, BundleResourceCapacities> bundle_resources;
   /// Returns if this equals another node resources.
-  bool operator==(const NodeResources &other);
-  bool operator!=(const NodeResources &other);
+  bool operator==(const NodeResources &other) const;
+  bool operator!=(const NodeResources &other) const;
   /// Returns human-readable string for these resources.
   std::string DebugString(StringIdMap string_to_int_map) const;
   /// Returns compact dict-like string.
@@ -177,6 +231,11 @@ class NodeResourceInstances {
   /// Map containing custom resources. The key of each entry represents the
   /// custom resource ID.
   absl::flat_hash_map<int64_t, ResourceInstanceCapacities> custom_resources;
+  /// Map containing the resources reserved by placement group bundles, by bundle and
+  /// original resource ID.
+  absl::flat_hash_map<ray::BundleID,
+                      absl::flat_hash_map<int64_t, ResourceInstanceCapacities>>
+      bundle_resources;
   /// Extract available resource instances.
   TaskResourceInstances GetAvailableResourceInstances();
   /// Returns if this equals another node resources.
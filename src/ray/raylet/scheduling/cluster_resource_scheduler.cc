@@ -14,6 +14,95 @@
 
 #include "ray/raylet/scheduling/cluster_resource_scheduler.h"
 
+#include <algorithm>
+#include <map>
+
+#include "ray/common/ray_config.h"
+
+namespace {
+
+/// Find the capacity of a resource that a placement group bundle reserved on a node.
+///
+/// \return nullptr, if the bundle did not reserve the resource on the node.
+const ResourceCapacity *FindBundleResource(const NodeResources &resources,
+                                           const BundleResourceRequest &request) {
+  auto bundle_it = resources.bundle_resources.find(request.bundle_id);
+  if (bundle_it == resources.bundle_resources.end()) {
+    return nullptr;
+  }
+  auto it = bundle_it->second.find(request.id);
+  if (it == bundle_it->second.end()) {
+    return nullptr;
+  }
+  return &it->second;
+}
+
+/// Choose fully available unit instances of a resource that are close to each other:
+/// on as few sockets as possible and, within a socket, spanning as few instance
+/// indexes as possible (e.g., GPUs that are linked to their neighbors).
+///
+/// \param available: The available capacity of each instance.
+/// \param instance_sockets: The socket of each instance.
+/// \param num_instances: The number of instances to choose.
+/// \return The indexes of the chosen instances. There are fewer than num_instances if
+/// not enough instances are fully available.
+std::vector<size_t> SelectUnitInstances(const std::vector<FixedPoint> &available,
+                                        const std::vector<int64_t> &instance_sockets,
+                                        size_t num_instances) {
+  std::map<int64_t, std::vector<size_t>> free_instances;
+  for (size_t i = 0; i < available.size(); i++) {
+    if (available[i] == 1.) {
+      free_instances[instance_sockets[i]].push_back(i);
+    }
+  }
+
+  // Among the sockets that have enough free instances, prefer the most compact set,
+  // then the socket with the fewest free instances, so that the larger free sets stay
+  // available for larger requests.
+  const std::vector<size_t> *best_socket = nullptr;
+  size_t best_start = 0;
+  size_t best_span = 0;
+  for (const auto &socket : free_instances) {
+    const auto &free = socket.second;
+    for (size_t start = 0; start + num_instances <= free.size(); start++) {
+      const size_t span = free[start + num_instances - 1] - free[start];
+      if (best_socket == nullptr || span < best_span ||
+          (span == best_span && free.size() < best_socket->size())) {
+        best_socket = &free;
+        best_start = start;
+        best_span = span;
+      }
+    }
+  }
+  if (best_socket != nullptr) {
+    return std::vector<size_t>(best_socket->begin() + best_start,
+                               best_socket->begin() + best_start + num_instances);
+  }
+
+  // No socket has enough free instances, so spread the request over as few sockets
+  // as possible.
+  std::vector<const std::vector<size_t> *> sockets;
+  for (const auto &socket : free_instances) {
+    sockets.push_back(&socket.second);
+  }
+  std::stable_sort(sockets.begin(), sockets.end(),
+                   [](const std::vector<size_t> *a, const std::vector<size_t> *b) {
+                     return a->size() > b->size();
+                   });
+  std::vector<size_t> selected;
+  for (const auto *free : sockets) {
+    for (size_t i : *free) {
+      if (selected.size() == num_instances) {
+        return selected;
+      }
+      selected.push_back(i);
+    }
+  }
+  return selected;
+}
+
+}  // namespace
+
 namespace ray {
 
 ClusterResourceScheduler::ClusterResourceScheduler(
@@ -107,6 +196,14 @@ bool ClusterResourceScheduler::IsFeasible(const TaskRequest &task_req,
     }
   }
 
+  // Finally, check the resources reserved by placement group bundles.
+  for (const auto &task_req_bundle_resource : task_req.bundle_resources) {
+    const auto *capacity = FindBundleResource(resources, task_req_bundle_resource);
+    if (capacity == nullptr || task_req_bundle_resource.demand > capacity->total) {
+      return false;
+    }
+  }
+
   return true;
 }
 
@@ -158,6 +255,15 @@ int64_t ClusterResourceScheduler::IsSchedulable(const TaskRequest &task_req,
     }
   }
 
+  // Bundle resources are only available on the nodes the bundles were placed on, so
+  // they are always hard constraints.
+  for (const auto &task_req_bundle_resource : task_req.bundle_resources) {
+    const auto *capacity = FindBundleResource(resources, task_req_bundle_resource);
+    if (capacity == nullptr || task_req_bundle_resource.demand > capacity->available) {
+      return -1;
+    }
+  }
+
   if (task_req.placement_hints.size() > 0) {
     auto it_p = task_req.placement_hints.find(node_id);
     if (it_p == task_req.placement_hints.end()) {
@@ -204,6 +310,13 @@ int64_t ClusterResourceScheduler::GetBestSchedulableNode(const TaskRequest &task
     return best_node;
   }
 
+  // Prefer the nodes that already have the task's arguments local, so that they
+  // don't have to be pulled over the network.
+  best_node = GetBestLocalityNode(task_req);
+  if (best_node != -1) {
+    return best_node;
+  }
+
   // Check whether local node is schedulable. We return immediately
   // the local node only if there are zero violations.
   const auto local_node_it = nodes_.find(local_node_id_);
@@ -264,10 +377,82 @@ int64_t ClusterResourceScheduler::GetBestSchedulableNode(const TaskRequest &task
   return best_node;
 }
 
+double ClusterResourceScheduler::GetNodeUtilization(
+    const NodeResources &resources) const {
+  double utilization = 0;
+  for (const auto &capacity : resources.predefined_resources) {
+    const double total = capacity.total.Double();
+    if (total > 0) {
+      utilization = std::max(utilization, (total - capacity.available.Double()) / total);
+    }
+  }
+  return std::min(std::max(utilization, 0.), 1.);
+}
+
+int64_t ClusterResourceScheduler::GetBestLocalityNode(const TaskRequest &task_req) const {
+  const int64_t locality_weight_percent =
+      RayConfig::instance().scheduler_locality_weight_percent();
+  if (locality_weight_percent <= 0 || task_req.local_object_bytes.empty()) {
+    return -1;
+  }
+  int64_t max_local_bytes = 0;
+  for (const auto &entry : task_req.local_object_bytes) {
+    max_local_bytes = std::max(max_local_bytes, entry.second);
+  }
+  if (max_local_bytes < RayConfig::instance().scheduler_locality_min_bytes()) {
+    // The arguments are cheap to transfer, so only the load matters.
+    return -1;
+  }
+
+  const double locality_weight = locality_weight_percent / 100.;
+  int64_t best_node = -1;
+  double best_score = 0;
+  double best_local_fraction = 0;
+  for (const auto &node : nodes_) {
+    if (IsSchedulable(task_req, node.first, node.second.GetLocalView()) != 0) {
+      continue;
+    }
+    double local_fraction = 0;
+    auto it = task_req.local_object_bytes.find(node.first);
+    if (it != task_req.local_object_bytes.end()) {
+      local_fraction = static_cast<double>(it->second) / max_local_bytes;
+    }
+    const double score = locality_weight * local_fraction -
+                         GetNodeUtilization(node.second.GetLocalView());
+    // Break ties in favor of the local node, which saves a spillback.
+    if (best_node == -1 || score > best_score ||
+        (score == best_score && node.first == local_node_id_)) {
+      best_node = node.first;
+      best_score = score;
+      best_local_fraction = local_fraction;
+    }
+  }
+  if (best_local_fraction == 0) {
+    // None of the nodes that have the arguments can run the task right away, so
+    // fall back to the default policy.
+    return -1;
+  }
+  return best_node;
+}
+
 std::string ClusterResourceScheduler::GetBestSchedulableNode(
     const std::unordered_map<std::string, double> &task_resources, bool actor_creation,
     int64_t *total_violations, bool *is_infeasible) {
+  return GetBestSchedulableNode(task_resources, {}, actor_creation, total_violations,
+                                is_infeasible);
+}
+
+std::string ClusterResourceScheduler::GetBestSchedulableNode(
+    const std::unordered_map<std::string, double> &task_resources,
+    const std::unordered_map<std::string, int64_t> &local_object_bytes,
+    bool actor_creation, int64_t *total_violations, bool *is_infeasible) {
   TaskRequest task_request = ResourceMapToTaskRequest(string_to_int_map_, task_resources);
+  for (const auto &entry : local_object_bytes) {
+    const int64_t node_id = string_to_int_map_.Get(entry.first);
+    if (node_id != -1) {
+      task_request.local_object_bytes[node_id] = entry.second;
+    }
+  }
   int64_t node_id = GetBestSchedulableNode(task_request, actor_creation, total_violations,
                                            is_infeasible);
 
@@ -310,6 +495,13 @@ bool ClusterResourceScheduler::SubtractRemoteNodeAvailableResources(
           std::max(FixedPoint(0), it->second.available - task_req_custom_resource.demand);
     }
   }
+
+  for (const auto &task_req_bundle_resource : task_req.bundle_resources) {
+    auto &capacity = resources->bundle_resources[task_req_bundle_resource.bundle_id]
+                                                [task_req_bundle_resource.id];
+    capacity.available =
+        std::max(FixedPoint(0), capacity.available - task_req_bundle_resource.demand);
+  }
   return true;
 }
 
@@ -328,6 +520,22 @@ int64_t ClusterResourceScheduler::NumNodes() { return nodes_.size(); }
 
 void ClusterResourceScheduler::AddLocalResource(const std::string &resource_name,
                                                 double resource_total) {
+  BundleID bundle_id;
+  int64_t bundle_resource_id;
+  if (ParseBundleResource(string_to_int_map_, resource_name, &bundle_id,
+                          &bundle_resource_id)) {
+    auto &instances = local_resources_.bundle_resources[bundle_id][bundle_resource_id];
+    FixedPoint total(resource_total);
+    if (instances.total.empty()) {
+      InitResourceInstances(total, false, &instances);
+    } else {
+      instances.total[0] += total;
+      instances.available[0] += total;
+    }
+    UpdateLocalBundleResources(bundle_id);
+    return;
+  }
+
   string_to_int_map_.Insert(resource_name);
   int64_t resource_id = string_to_int_map_.Get(resource_name);
 
@@ -380,6 +588,12 @@ bool ClusterResourceScheduler::IsAvailableResourceEmpty(
   if (idx != -1) {
     return local_view->predefined_resources[idx].available <= 0;
   }
+  BundleResourceRequest bundle_resource;
+  if (ParseBundleResource(string_to_int_map_, resource_name, &bundle_resource.bundle_id,
+                          &bundle_resource.id)) {
+    const auto *capacity = FindBundleResource(*local_view, bundle_resource);
+    return capacity == nullptr || capacity->available <= 0;
+  }
   string_to_int_map_.Insert(resource_name);
   int64_t resource_id = string_to_int_map_.Get(resource_name);
   auto itr = local_view->custom_resources.find(resource_id);
@@ -416,7 +630,15 @@ void ClusterResourceScheduler::UpdateResourceCapacity(const std::string &node_id
 
   auto local_view = it->second.GetMutableLocalView();
   FixedPoint resource_total_fp(resource_total);
-  if (idx != -1) {
+  BundleID bundle_id;
+  int64_t bundle_resource_id;
+  if (idx == -1 && ParseBundleResource(string_to_int_map_, resource_name, &bundle_id,
+                                       &bundle_resource_id)) {
+    auto &capacity = local_view->bundle_resources[bundle_id][bundle_resource_id];
+    auto diff_capacity = resource_total_fp - capacity.total;
+    capacity.total = std::max(FixedPoint(0), capacity.total + diff_capacity);
+    capacity.available = std::max(FixedPoint(0), capacity.available + diff_capacity);
+  } else if (idx != -1) {
     auto diff_capacity = resource_total_fp - local_view->predefined_resources[idx].total;
     local_view->predefined_resources[idx].total += diff_capacity;
     local_view->predefined_resources[idx].available += diff_capacity;
@@ -471,7 +693,27 @@ void ClusterResourceScheduler::DeleteResource(const std::string &node_id_string,
     idx = (int)MEM;
   };
   auto local_view = it->second.GetMutableLocalView();
-  if (idx != -1) {
+  BundleID bundle_id;
+  int64_t bundle_resource_id;
+  if (idx == -1 && ParseBundleResource(string_to_int_map_, resource_name, &bundle_id,
+                                       &bundle_resource_id)) {
+    // The original resource may still be used by other bundles, so its ID is kept.
+    auto bundle_it = local_view->bundle_resources.find(bundle_id);
+    if (bundle_it != local_view->bundle_resources.end()) {
+      bundle_it->second.erase(bundle_resource_id);
+      if (bundle_it->second.empty()) {
+        local_view->bundle_resources.erase(bundle_it);
+      }
+    }
+
+    auto b_itr = local_resources_.bundle_resources.find(bundle_id);
+    if (node_id == local_node_id_ && b_itr != local_resources_.bundle_resources.end()) {
+      b_itr->second.erase(bundle_resource_id);
+      if (b_itr->second.empty()) {
+        local_resources_.bundle_resources.erase(b_itr);
+      }
+    }
+  } else if (idx != -1) {
     local_view->predefined_resources[idx].total = 0;
 
     if (node_id == local_node_id_) {
@@ -506,6 +748,37 @@ std::string ClusterResourceScheduler::DebugString(void) const {
   return buffer.str();
 }
 
+void ClusterResourceScheduler::SetNodeTopology(const NodeTopology &topology) {
+  instance_sockets_.clear();
+  if (RayConfig::instance().topology_aware_instance_allocation()) {
+    for (const auto &resource : {CPU, GPU}) {
+      auto instance_sockets = topology.GetInstanceSockets(ResourceEnumToString(resource));
+      if (!instance_sockets.empty()) {
+        instance_sockets_.emplace(resource, std::move(instance_sockets));
+      }
+    }
+  }
+  cpu_ids_ = topology.GetInstanceDeviceIds(kCPU_ResourceLabel);
+}
+
+std::vector<int64_t> ClusterResourceScheduler::GetCpuAffinity(
+    const TaskResourceInstances &task_allocation) const {
+  std::vector<int64_t> cpu_ids;
+  if (task_allocation.predefined_resources.size() > CPU) {
+    const auto &cpu_instances = task_allocation.predefined_resources[CPU];
+    for (size_t i = 0; i < cpu_instances.size() && i < cpu_ids_.size(); i++) {
+      if (cpu_instances[i] == 1.) {
+        cpu_ids.push_back(cpu_ids_[i]);
+      }
+    }
+  }
+  if (cpu_ids.empty()) {
+    // The task doesn't own any CPU, so it can run on all of them.
+    return cpu_ids_;
+  }
+  return cpu_ids;
+}
+
 void ClusterResourceScheduler::InitResourceInstances(
     FixedPoint total, bool unit_instances, ResourceInstanceCapacities *instance_list) {
   if (unit_instances) {
@@ -540,10 +813,6 @@ void ClusterResourceScheduler::InitLocalResources(const NodeResources &node_reso
     }
   }
 
-  if (node_resources.custom_resources.size() == 0) {
-    return;
-  }
-
   for (auto it = node_resources.custom_resources.begin();
        it != node_resources.custom_resources.end(); ++it) {
     if (it->second.total > 0) {
@@ -552,6 +821,16 @@ void ClusterResourceScheduler::InitLocalResources(const NodeResources &node_reso
       local_resources_.custom_resources.emplace(it->first, instance_list);
     }
   }
+
+  for (const auto &bundle : node_resources.bundle_resources) {
+    for (const auto &resource : bundle.second) {
+      if (resource.second.total > 0) {
+        InitResourceInstances(resource.second.total, false,
+                              &local_resources_.bundle_resources[bundle.first]
+                                                                [resource.first]);
+      }
+    }
+  }
 }
 
 std::vector<FixedPoint> ClusterResourceScheduler::AddAvailableResourceInstances(
@@ -595,7 +874,7 @@ std::vector<FixedPoint> ClusterResourceScheduler::SubtractAvailableResourceInsta
 
 bool ClusterResourceScheduler::AllocateResourceInstances(
     FixedPoint demand, bool soft, std::vector<FixedPoint> &available,
-    std::vector<FixedPoint> *allocation) {
+    std::vector<FixedPoint> *allocation, const std::vector<int64_t> *instance_sockets) {
   allocation->resize(available.size());
   FixedPoint remaining_demand = demand;
 
@@ -626,7 +905,15 @@ bool ClusterResourceScheduler::AllocateResourceInstances(
   // If resource constraint is soft, allocate as many full unit-capacity resources and
   // then distribute remaining_demand across remaining instances. Note that in case we can
   // overallocate this resource.
-  if (remaining_demand >= 1.) {
+  if (remaining_demand >= 1. && instance_sockets != nullptr && !soft) {
+    RAY_CHECK(instance_sockets->size() >= available.size());
+    const auto num_instances = static_cast<size_t>(remaining_demand.Double());
+    for (size_t i : SelectUnitInstances(available, *instance_sockets, num_instances)) {
+      (*allocation)[i] = 1.;
+      available[i] = 0;
+      remaining_demand -= 1.;
+    }
+  } else if (remaining_demand >= 1.) {
     for (size_t i = 0; i < available.size(); i++) {
       if (available[i] == 1.) {
         // Allocate a full unit-capacity instance.
@@ -694,10 +981,18 @@ bool ClusterResourceScheduler::AllocateTaskResourceInstances(
   task_allocation->predefined_resources.resize(PredefinedResources_MAX);
   for (size_t i = 0; i < PredefinedResources_MAX; i++) {
     if (task_req.predefined_resources[i].demand > 0) {
+      auto &available = local_resources_.predefined_resources[i].available;
+      // Only use the topology if it knows about all the instances.
+      const std::vector<int64_t> *instance_sockets = nullptr;
+      auto sockets_it = instance_sockets_.find(i);
+      if (sockets_it != instance_sockets_.end() &&
+          sockets_it->second.size() >= available.size()) {
+        instance_sockets = &sockets_it->second;
+      }
       if (!AllocateResourceInstances(task_req.predefined_resources[i].demand,
-                                     task_req.predefined_resources[i].soft,
-                                     local_resources_.predefined_resources[i].available,
-                                     &task_allocation->predefined_resources[i])) {
+                                     task_req.predefined_resources[i].soft, available,
+                                     &task_allocation->predefined_resources[i],
+                                     instance_sockets)) {
         // Allocation failed. Restore node's local resources by freeing the resources
         // of the failed allocation.
         FreeTaskResourceInstances(task_allocation);
@@ -728,9 +1023,59 @@ bool ClusterResourceScheduler::AllocateTaskResourceInstances(
       return false;
     }
   }
+
+  for (const auto &task_req_bundle_resource : task_req.bundle_resources) {
+    if (task_req_bundle_resource.demand == 0) {
+      continue;
+    }
+    auto bundle_it = local_resources_.bundle_resources.find(
+        task_req_bundle_resource.bundle_id);
+    if (bundle_it == local_resources_.bundle_resources.end()) {
+      FreeTaskResourceInstances(task_allocation);
+      return false;
+    }
+    auto it = bundle_it->second.find(task_req_bundle_resource.id);
+    if (it == bundle_it->second.end()) {
+      FreeTaskResourceInstances(task_allocation);
+      return false;
+    }
+    std::vector<FixedPoint> allocation;
+    bool success = AllocateResourceInstances(task_req_bundle_resource.demand,
+                                             task_req_bundle_resource.soft,
+                                             it->second.available, &allocation);
+    task_allocation->bundle_resources[bundle_it->first].emplace(it->first, allocation);
+    if (!success) {
+      FreeTaskResourceInstances(task_allocation);
+      return false;
+    }
+  }
   return true;
 }
 
+void ClusterResourceScheduler::UpdateLocalBundleResources(const BundleID &bundle_id) {
+  auto it_local_node = nodes_.find(local_node_id_);
+  RAY_CHECK(it_local_node != nodes_.end());
+  auto local_view = it_local_node->second.GetMutableLocalView();
+
+  auto it = local_resources_.bundle_resources.find(bundle_id);
+  if (it == local_resources_.bundle_resources.end()) {
+    local_view->bundle_resources.erase(bundle_id);
+    return;
+  }
+  auto &bundle_view = local_view->bundle_resources[bundle_id];
+  for (const auto &resource : it->second) {
+    auto &capacity = bundle_view[resource.first];
+    capacity.total = 0;
+    for (const auto &total : resource.second.total) {
+      capacity.total += total;
+    }
+    capacity.available = 0;
+    for (const auto &available : resource.second.available) {
+      capacity.available += available;
+    }
+  }
+}
+
 void ClusterResourceScheduler::UpdateLocalAvailableResourcesFromResourceInstances() {
   auto it_local_node = nodes_.find(local_node_id_);
   RAY_CHECK(it_local_node != nodes_.end());
@@ -771,6 +1116,21 @@ void ClusterResourceScheduler::FreeTaskResourceInstances(
       AddAvailableResourceInstances(task_allocation_custom_resource.second, &it->second);
     }
   }
+
+  for (const auto &task_allocation_bundle : task_allocation->bundle_resources) {
+    auto bundle_it =
+        local_resources_.bundle_resources.find(task_allocation_bundle.first);
+    if (bundle_it == local_resources_.bundle_resources.end()) {
+      continue;
+    }
+    for (const auto &task_allocation_bundle_resource : task_allocation_bundle.second) {
+      auto it = bundle_it->second.find(task_allocation_bundle_resource.first);
+      if (it != bundle_it->second.end()) {
+        AddAvailableResourceInstances(task_allocation_bundle_resource.second,
+                                      &it->second);
+      }
+    }
+  }
 }
 
 std::vector<double> ClusterResourceScheduler::AddCPUResourceInstances(
@@ -847,6 +1207,9 @@ bool ClusterResourceScheduler::AllocateLocalTaskResources(
     std::shared_ptr<TaskResourceInstances> task_allocation) {
   if (AllocateTaskResourceInstances(task_request, task_allocation)) {
     UpdateLocalAvailableResourcesFromResourceInstances();
+    for (const auto &bundle : task_allocation->bundle_resources) {
+      UpdateLocalBundleResources(bundle.first);
+    }
     return true;
   }
   return false;
@@ -874,6 +1237,11 @@ std::string ClusterResourceScheduler::GetResourceNameFromIndex(int64_t res_idx)
   }
 }
 
+std::string ClusterResourceScheduler::GetResourceNameFromIndex(const BundleID &bundle_id,
+                                                               int64_t res_idx) {
+  return BundleResourceName(string_to_int_map_, bundle_id, res_idx);
+}
+
 bool ClusterResourceScheduler::AllocateRemoteTaskResources(
     const std::string &node_string,
     const std::unordered_map<std::string, double> &task_resources) {
@@ -890,6 +1258,9 @@ void ClusterResourceScheduler::FreeLocalTaskResources(
   }
   FreeTaskResourceInstances(task_allocation);
   UpdateLocalAvailableResourcesFromResourceInstances();
+  for (const auto &bundle : task_allocation->bundle_resources) {
+    UpdateLocalBundleResources(bundle.first);
+  }
 }
 
 void ClusterResourceScheduler::UpdateLastResourceUsage(
@@ -902,11 +1273,12 @@ void ClusterResourceScheduler::UpdateLastResourceUsage(
 
 void ClusterResourceScheduler::FillResourceUsage(
     std::shared_ptr<rpc::ResourcesData> resources_data) {
-  NodeResources resources;
-
-  RAY_CHECK(GetNodeResources(local_node_id_, &resources))
+  const auto local_node_it = nodes_.find(local_node_id_);
+  RAY_CHECK(local_node_it != nodes_.end())
       << "Error: Populating heartbeat failed. Please file a bug report: "
          "https://github.com/ray-project/ray/issues/new.";
+  // Avoid copying the local view, which may hold the bundles of many placement groups.
+  const NodeResources &resources = local_node_it->second.GetLocalView();
 
   // Initialize if last report resources is empty.
   if (!last_report_resources_) {
@@ -954,6 +1326,27 @@ void ClusterResourceScheduler::FillResourceUsage(
       (*resources_data->mutable_resources_total())[label] = capacity.total.Double();
     }
   }
+  for (const auto &bundle : resources.bundle_resources) {
+    auto &last_bundle = last_report_resources_->bundle_resources[bundle.first];
+    for (const auto &it : bundle.second) {
+      const auto &capacity = it.second;
+      const auto &last_capacity = last_bundle[it.first];
+      if (capacity.available == last_capacity.available &&
+          capacity.total == last_capacity.total) {
+        continue;
+      }
+      const auto &label = BundleResourceName(string_to_int_map_, bundle.first, it.first);
+      // Note: available may be negative, but only report positive to GCS.
+      if (capacity.available != last_capacity.available && capacity.available > 0) {
+        resources_data->set_resources_available_changed(true);
+        (*resources_data->mutable_resources_available())[label] =
+            capacity.available.Double();
+      }
+      if (capacity.total != last_capacity.total) {
+        (*resources_data->mutable_resources_total())[label] = capacity.total.Double();
+      }
+    }
+  }
   if (resources != *last_report_resources_.get()) {
     last_report_resources_.reset(new NodeResources(resources));
   }
@@ -23,6 +23,7 @@
 #include "ray/common/task/scheduling_resources.h"
 #include "ray/raylet/scheduling/cluster_resource_data.h"
 #include "ray/raylet/scheduling/fixed_point.h"
+#include "ray/raylet/scheduling/node_topology.h"
 #include "ray/raylet/scheduling/scheduling_ids.h"
 #include "ray/util/logging.h"
 
@@ -56,6 +57,10 @@ class ClusterResourceScheduler {
   // Mapping from predefined resource indexes to resource strings
   std::string GetResourceNameFromIndex(int64_t res_idx);
 
+  // Mapping from placement group bundle resource indexes to resource strings, e.g.,
+  // `CPU_group_<bundle_index>_<pg_id>`.
+  std::string GetResourceNameFromIndex(const BundleID &bundle_id, int64_t res_idx);
+
   /// Add a new node or overwrite the resources of an existing node.
   ///
   /// \param node_id: Node ID.
@@ -151,6 +156,16 @@ class ClusterResourceScheduler {
       const std::unordered_map<std::string, double> &task_request, bool actor_creation,
       int64_t *violations, bool *is_infeasible);
 
+  /// Similar to the above, but prefers the nodes that already have the task's
+  /// arguments local, among the nodes that can run the task right away.
+  ///
+  ///  \param local_object_bytes: The number of bytes of the task's arguments that
+  ///  each node has local, by node ID in string format.
+  std::string GetBestSchedulableNode(
+      const std::unordered_map<std::string, double> &task_request,
+      const std::unordered_map<std::string, int64_t> &local_object_bytes,
+      bool actor_creation, int64_t *violations, bool *is_infeasible);
+
   /// Return resources associated to the given node_id in ret_resources.
   /// If node_id not found, return false; otherwise return true.
   bool GetNodeResources(int64_t node_id, NodeResources *ret_resources) const;
@@ -200,6 +215,21 @@ class ClusterResourceScheduler {
   /// \param local_resources: Total resources of the node.
   void InitLocalResources(const NodeResources &local_resources);
 
+  /// Set the topology of the local node, so that the CPU and GPU instances allocated
+  /// to a task are close to each other, and so that workers can be pinned to the
+  /// CPUs of their tasks.
+  ///
+  /// \param topology: The topology of the local node.
+  void SetNodeTopology(const NodeTopology &topology);
+
+  /// Get the logical CPUs that a task may run on.
+  ///
+  /// \param task_allocation: The resources allocated to the task.
+  /// \return The logical CPUs of the whole CPU instances allocated to the task, or all
+  /// the node's CPUs if the task has no whole CPU. Empty if the topology of the node is
+  /// unknown.
+  std::vector<int64_t> GetCpuAffinity(const TaskResourceInstances &task_allocation) const;
+
   /// Initialize the instances of a given resource given the resource's total capacity.
   /// If unit_instances is true we split the resources in unit-size instances. For
   /// example, if total = 10, then we create 10 instances, each with caoacity 1.
@@ -235,17 +265,23 @@ class ClusterResourceScheduler {
   /// than the demand, 3.5. In this case, the remaining available resource is
   /// (0., 0., 0., 0.)
   ///
+  /// If the socket of each instance is known and the constraint is hard, the full
+  /// instances are chosen on as few sockets as possible and, within a socket, with
+  /// indexes as close as possible.
+  ///
   /// \param demand: The resource amount to be allocated.
   /// \param soft: Specifies whether this demand has soft or hard constraints.
   /// \param available: List of available capacities of the instances of the resource.
   /// \param allocation: List of instance capacities allocated to satisfy the demand.
   /// This is a return parameter.
+  /// \param instance_sockets: The socket of each instance, or nullptr if unknown.
   ///
   /// \return true, if allocation successful. In this case, the sum of the elements in
   /// "allocation" is equal to "demand".
   bool AllocateResourceInstances(FixedPoint demand, bool soft,
                                  std::vector<FixedPoint> &available,
-                                 std::vector<FixedPoint> *allocation);
+                                 std::vector<FixedPoint> *allocation,
+                                 const std::vector<int64_t> *instance_sockets = nullptr);
 
   /// Allocate local resources to satisfy a given request (task_req).
   ///
@@ -362,6 +398,14 @@ class ClusterResourceScheduler {
   // resources availabile at that node is 0.2 + 0.3 + 0.1 + 1. = 1.6
   void UpdateLocalAvailableResourcesFromResourceInstances();
 
+  /// Update the total and available resources of a placement group bundle on the
+  /// local node, given the instances of the bundle's resources. Unlike
+  /// UpdateLocalAvailableResourcesFromResourceInstances, this only goes through the
+  /// given bundle, so that its cost doesn't depend on the number of placement groups.
+  ///
+  /// \param bundle_id: The bundle whose resources changed.
+  void UpdateLocalBundleResources(const BundleID &bundle_id);
+
   /// Populate the relevant parts of the heartbeat table. This is intended for
   /// sending resource usage of raylet to gcs. In particular, this should fill in
   /// resources_available and resources_total.
@@ -417,6 +461,21 @@ class ClusterResourceScheduler {
   bool SubtractRemoteNodeAvailableResources(int64_t node_id,
                                             const TaskRequest &task_request);
 
+  /// Get the utilization of the most utilized predefined resource of a node.
+  ///
+  /// \param resources: The resources of the node.
+  /// \return The utilization, between 0 (idle) and 1 (fully used).
+  double GetNodeUtilization(const NodeResources &resources) const;
+
+  /// Among the nodes that can run the request without violating any constraint,
+  /// find the one with the best score, where a node scores higher the more of the
+  /// task's argument bytes it has local and the less loaded it is.
+  ///
+  /// \param task_req: Task request to be scheduled.
+  /// \return -1, if the request has no locality preference or no node can run it
+  /// right away; otherwise, the ID of the best node.
+  int64_t GetBestLocalityNode(const TaskRequest &task_req) const;
+
   /// List of nodes in the clusters and their resources organized as a map.
   /// The key of the map is the node ID.
   absl::flat_hash_map<int64_t, Node> nodes_;
@@ -429,6 +488,11 @@ class ClusterResourceScheduler {
   StringIdMap string_to_int_map_;
   /// Cached resources, used to compare with newest one in light heartbeat mode.
   std::unique_ptr<NodeResources> last_report_resources_;
+  /// The socket of each instance of the local predefined resources whose topology is
+  /// known, by resource index.
+  absl::flat_hash_map<int64_t, std::vector<int64_t>> instance_sockets_;
+  /// The logical CPU ID of each CPU instance of the local node.
+  std::vector<int64_t> cpu_ids_;
 };
 
 }  // end namespace ray
@@ -14,10 +14,14 @@
 
 #include "ray/raylet/scheduling/cluster_resource_scheduler.h"
 
+#include <algorithm>
+#include <chrono>
+#include <random>
 #include <string>
 
 #include "gmock/gmock.h"
 #include "gtest/gtest.h"
+#include "ray/common/bundle_spec.h"
 #include "ray/common/task/scheduling_resources.h"
 #include "ray/raylet/scheduling/scheduling_ids.h"
 
@@ -1036,6 +1040,141 @@ TEST_F(ClusterResourceSchedulerTest, TestAlwaysSpillInfeasibleTask) {
             "remote_available");
 }
 
+TEST_F(ClusterResourceSchedulerTest, LocalityAwareSchedulingTest) {
+  const int64_t mb = 1024 * 1024;
+  std::unordered_map<std::string, double> resource_spec({{"CPU", 1}});
+  ClusterResourceScheduler resource_scheduler("local", {{"CPU", 4}});
+  resource_scheduler.AddOrUpdateNode("remote", {{"CPU", 4}}, {{"CPU", 4}});
+  int64_t total_violations;
+  bool is_infeasible;
+
+  // Without locality, the local node is preferred.
+  ASSERT_EQ(resource_scheduler.GetBestSchedulableNode(resource_spec, false,
+                                                      &total_violations, &is_infeasible),
+            "local");
+  // The node that has the arguments local is preferred.
+  ASSERT_EQ(resource_scheduler.GetBestSchedulableNode(resource_spec,
+                                                      {{"remote", 100 * mb}}, false,
+                                                      &total_violations, &is_infeasible),
+            "remote");
+  // Unless the arguments are too small to matter.
+  ASSERT_EQ(resource_scheduler.GetBestSchedulableNode(
+                resource_spec, {{"remote", 1024}}, false, &total_violations,
+                &is_infeasible),
+            "local");
+
+  // Locality is traded off against load: a node that has half of the bytes and is idle
+  // beats a node that has all of them and is 75% utilized.
+  resource_scheduler.AddOrUpdateNode("remote", {{"CPU", 4}}, {{"CPU", 1}});
+  ASSERT_EQ(resource_scheduler.GetBestSchedulableNode(
+                resource_spec, {{"local", 50 * mb}, {"remote", 100 * mb}}, false,
+                &total_violations, &is_infeasible),
+            "local");
+  // But a node that has none of the bytes does not.
+  ASSERT_EQ(resource_scheduler.GetBestSchedulableNode(resource_spec,
+                                                      {{"remote", 100 * mb}}, false,
+                                                      &total_violations, &is_infeasible),
+            "remote");
+
+  // If the node that has the arguments can't run the task, fall back to the default
+  // policy.
+  resource_scheduler.AddOrUpdateNode("remote", {{"CPU", 4}}, {{"CPU", 0}});
+  ASSERT_EQ(resource_scheduler.GetBestSchedulableNode(resource_spec,
+                                                      {{"remote", 100 * mb}}, false,
+                                                      &total_violations, &is_infeasible),
+            "local");
+}
+
+/// Schedule waves of tasks whose arguments are spread over the cluster from the view
+/// of one raylet, and report how many argument bytes had to be pulled to the chosen
+/// nodes with and without locality-aware scheduling. Run it with
+/// --gtest_also_run_disabled_tests.
+TEST_F(ClusterResourceSchedulerTest, DISABLED_BenchmarkLocalityBytesPulled) {
+  const int num_nodes = 50;
+  const int num_cpus_per_node = 8;
+  const int num_objects = 5000;
+  const int num_args = 2;
+  const int num_waves = 50;
+  const int64_t mb = 1024 * 1024;
+  std::unordered_map<std::string, double> node_resources(
+      {{"CPU", num_cpus_per_node}});
+  std::unordered_map<std::string, double> resource_spec({{"CPU", 1}});
+
+  for (bool locality_aware : {false, true}) {
+    std::mt19937 gen(0);
+    std::uniform_int_distribution<int> node_dist(0, num_nodes - 1);
+    std::uniform_int_distribution<int> object_dist(0, num_objects - 1);
+    std::uniform_int_distribution<int64_t> size_dist(1 * mb, 100 * mb);
+    // The size of each object and the nodes that have a copy of it.
+    std::vector<std::pair<int64_t, std::vector<int>>> objects;
+    for (int i = 0; i < num_objects; i++) {
+      std::vector<int> locations({node_dist(gen)});
+      if (i % 4 == 0) {
+        locations.push_back(node_dist(gen));
+      }
+      objects.emplace_back(size_dist(gen), locations);
+    }
+
+    ClusterResourceScheduler resource_scheduler("0", node_resources);
+    int64_t bytes_total = 0;
+    int64_t bytes_pulled = 0;
+    int64_t num_spilled = 0;
+    for (int wave = 0; wave < num_waves; wave++) {
+      for (int i = 1; i < num_nodes; i++) {
+        resource_scheduler.AddOrUpdateNode(std::to_string(i), node_resources,
+                                           node_resources);
+      }
+      std::vector<std::shared_ptr<TaskResourceInstances>> local_allocations;
+      // Fill the cluster.
+      for (int task = 0; task < num_nodes * num_cpus_per_node; task++) {
+        std::vector<int> args;
+        std::unordered_map<std::string, int64_t> local_object_bytes;
+        for (int j = 0; j < num_args; j++) {
+          const int object = object_dist(gen);
+          args.push_back(object);
+          for (int node : objects[object].second) {
+            local_object_bytes[std::to_string(node)] += objects[object].first;
+          }
+        }
+        int64_t violations;
+        bool is_infeasible;
+        const std::string node_id = resource_scheduler.GetBestSchedulableNode(
+            resource_spec,
+            locality_aware ? local_object_bytes
+                           : std::unordered_map<std::string, int64_t>(),
+            false, &violations, &is_infeasible);
+        ASSERT_FALSE(node_id.empty());
+        if (node_id == "0") {
+          auto allocation = std::make_shared<TaskResourceInstances>();
+          ASSERT_TRUE(
+              resource_scheduler.AllocateLocalTaskResources(resource_spec, allocation));
+          local_allocations.push_back(allocation);
+        } else {
+          ASSERT_TRUE(resource_scheduler.AllocateRemoteTaskResources(node_id,
+                                                                     resource_spec));
+          num_spilled++;
+        }
+        for (int object : args) {
+          const auto &locations = objects[object].second;
+          bytes_total += objects[object].first;
+          if (std::find(locations.begin(), locations.end(), std::stoi(node_id)) ==
+              locations.end()) {
+            bytes_pulled += objects[object].first;
+          }
+        }
+      }
+      for (auto &allocation : local_allocations) {
+        resource_scheduler.FreeLocalTaskResources(allocation);
+      }
+    }
+    RAY_LOG(INFO) << (locality_aware ? "locality-aware" : "load-only")
+                  << " scheduling: pulled " << bytes_pulled / mb << " of "
+                  << bytes_total / mb << " MB of arguments ("
+                  << 100. * bytes_pulled / bytes_total << "%), spilled "
+                  << num_spilled << " tasks";
+  }
+}
+
 TEST_F(ClusterResourceSchedulerTest, ResourceUsageReportTest) {
   vector<int64_t> cust_ids{1, 2, 3, 4, 5};
 
@@ -1204,6 +1343,182 @@ TEST_F(ClusterResourceSchedulerTest, AvailableResourceEmptyTest) {
   ASSERT_TRUE(resource_scheduler.IsAvailableResourceEmpty("custom123"));
 }
 
+TEST_F(ClusterResourceSchedulerTest, TopologyAwareAllocationTest) {
+  ClusterResourceScheduler resource_scheduler("local", {{"CPU", 8}, {"GPU", 8}});
+  NodeTopology topology;
+  RAY_CHECK_OK(NodeTopology::Parse("CPU 0 0-3\nCPU 1 4-7\nGPU 0 0-3\nGPU 1 4-7\n",
+                                   &topology));
+  resource_scheduler.SetNodeTopology(topology);
+
+  auto allocation1 = std::make_shared<TaskResourceInstances>();
+  ASSERT_TRUE(resource_scheduler.AllocateLocalTaskResources({{"GPU", 2}}, allocation1));
+  auto allocation2 = std::make_shared<TaskResourceInstances>();
+  ASSERT_TRUE(resource_scheduler.AllocateLocalTaskResources({{"GPU", 2}}, allocation2));
+  // The second task fills the socket of the first one.
+  ASSERT_EQ(allocation2->predefined_resources[GPU],
+            VectorDoubleToVectorFixedPoint({0, 0, 1, 1, 0, 0, 0, 0}));
+  resource_scheduler.FreeLocalTaskResources(allocation1);
+
+  // GPUs 0 and 1 are free, but a task with 4 GPUs gets all the GPUs of the other socket.
+  auto allocation3 = std::make_shared<TaskResourceInstances>();
+  ASSERT_TRUE(resource_scheduler.AllocateLocalTaskResources({{"GPU", 4}}, allocation3));
+  ASSERT_EQ(allocation3->predefined_resources[GPU],
+            VectorDoubleToVectorFixedPoint({0, 0, 0, 0, 1, 1, 1, 1}));
+
+  // If no socket has enough free instances, use as few sockets as possible.
+  resource_scheduler.FreeLocalTaskResources(allocation2);
+  auto allocation4 = std::make_shared<TaskResourceInstances>();
+  ASSERT_TRUE(resource_scheduler.AllocateLocalTaskResources({{"GPU", 1}}, allocation4));
+  resource_scheduler.FreeLocalTaskResources(allocation3);
+  auto allocation5 = std::make_shared<TaskResourceInstances>();
+  ASSERT_TRUE(resource_scheduler.AllocateLocalTaskResources({{"GPU", 5}}, allocation5));
+  ASSERT_EQ(allocation4->predefined_resources[GPU],
+            VectorDoubleToVectorFixedPoint({1, 0, 0, 0, 0, 0, 0, 0}));
+  ASSERT_EQ(allocation5->predefined_resources[GPU],
+            VectorDoubleToVectorFixedPoint({0, 1, 0, 0, 1, 1, 1, 1}));
+
+  // Workers are pinned to the CPUs of their tasks, and tasks without a whole CPU may
+  // run on any CPU.
+  auto cpu_allocation = std::make_shared<TaskResourceInstances>();
+  ASSERT_TRUE(
+      resource_scheduler.AllocateLocalTaskResources({{"CPU", 2}}, cpu_allocation));
+  ASSERT_EQ(resource_scheduler.GetCpuAffinity(*cpu_allocation),
+            std::vector<int64_t>({0, 1}));
+  auto fractional_allocation = std::make_shared<TaskResourceInstances>();
+  ASSERT_TRUE(resource_scheduler.AllocateLocalTaskResources({{"CPU", 0.5}},
+                                                            fractional_allocation));
+  ASSERT_EQ(resource_scheduler.GetCpuAffinity(*fractional_allocation).size(), 8);
+}
+
+TEST_F(ClusterResourceSchedulerTest, PlacementGroupResourceTest) {
+  ClusterResourceScheduler resource_scheduler("local", {{"CPU", 4}, {"custom", 2}});
+  resource_scheduler.AddOrUpdateNode("remote", {{"CPU", 4}}, {{"CPU", 4}});
+  const auto pg_id = PlacementGroupID::FromRandom();
+  const std::string cpu_bundle_0 = FormatPlacementGroupResource("CPU", pg_id, 0);
+  const std::string cpu_bundle_1 = FormatPlacementGroupResource("CPU", pg_id, 1);
+  const std::string cpu_wildcard = FormatPlacementGroupResource("CPU", pg_id, -1);
+  const std::string custom_bundle_0 = FormatPlacementGroupResource("custom", pg_id, 0);
+  int64_t t;
+  bool is_infeasible;
+
+  // Reserve two bundles on the local node, like the placement group resource manager.
+  for (const auto &resource : std::unordered_map<std::string, double>(
+           {{cpu_bundle_0, 2}, {cpu_bundle_1, 1}, {custom_bundle_0, 1}})) {
+    resource_scheduler.AddLocalResource(resource.first, resource.second);
+  }
+  resource_scheduler.AddLocalResource(cpu_wildcard, 2);
+  resource_scheduler.AddLocalResource(cpu_wildcard, 1);
+  // The original custom resource is not affected by the bundles.
+  ASSERT_EQ(resource_scheduler.GetLocalResources().custom_resources.size(), 1);
+  ASSERT_EQ(resource_scheduler.GetLocalResources().bundle_resources.size(), 3);
+
+  const std::unordered_map<std::string, double> task_spec(
+      {{cpu_bundle_0, 1}, {custom_bundle_0, 0.5}});
+  ASSERT_EQ(
+      resource_scheduler.GetBestSchedulableNode(task_spec, false, &t, &is_infeasible),
+      "local");
+  auto allocation = std::make_shared<TaskResourceInstances>();
+  ASSERT_TRUE(resource_scheduler.AllocateLocalTaskResources(task_spec, allocation));
+  ASSERT_EQ(resource_scheduler.GetResourceNameFromIndex(
+                allocation->bundle_resources.begin()->first, CPU),
+            cpu_bundle_0);
+  ASSERT_FALSE(resource_scheduler.IsAvailableResourceEmpty(cpu_bundle_1));
+
+  // The bundle is only on the local node, so the task is not spilled back when the
+  // bundle is fully used.
+  auto allocation2 = std::make_shared<TaskResourceInstances>();
+  ASSERT_TRUE(resource_scheduler.AllocateLocalTaskResources(task_spec, allocation2));
+  ASSERT_EQ(
+      resource_scheduler.GetBestSchedulableNode(task_spec, false, &t, &is_infeasible),
+      "");
+  ASSERT_FALSE(is_infeasible);
+  ASSERT_TRUE(resource_scheduler.IsAvailableResourceEmpty(cpu_bundle_0));
+
+  // The bundle resources are reported with their formatted names.
+  auto data = std::make_shared<rpc::ResourcesData>();
+  resource_scheduler.FillResourceUsage(data);
+  ASSERT_EQ(data->resources_total().at(cpu_bundle_0), 2);
+  ASSERT_EQ(data->resources_total().at(cpu_wildcard), 3);
+  ASSERT_EQ(data->resources_available().at(cpu_bundle_1), 1);
+  ASSERT_EQ(data->resources_available().count(cpu_bundle_0), 0);
+
+  resource_scheduler.FreeLocalTaskResources(allocation);
+  resource_scheduler.FreeLocalTaskResources(allocation2);
+  ASSERT_FALSE(resource_scheduler.IsAvailableResourceEmpty(cpu_bundle_0));
+  data = std::make_shared<rpc::ResourcesData>();
+  resource_scheduler.FillResourceUsage(data);
+  ASSERT_EQ(data->resources_available().at(cpu_bundle_0), 2);
+  ASSERT_EQ(data->resources_total().count(cpu_bundle_0), 0);
+
+  // A remote node that reports the bundle can run the task.
+  resource_scheduler.AddOrUpdateNode("remote", {{"CPU", 4}, {cpu_bundle_0, 1}},
+                                     {{"CPU", 4}, {cpu_bundle_0, 1}});
+  resource_scheduler.DeleteLocalResource(cpu_bundle_0);
+  ASSERT_TRUE(resource_scheduler.IsAvailableResourceEmpty(cpu_bundle_0));
+  const std::unordered_map<std::string, double> remote_task_spec({{cpu_bundle_0, 1}});
+  ASSERT_EQ(resource_scheduler.GetBestSchedulableNode(remote_task_spec, false, &t,
+                                                      &is_infeasible),
+            "remote");
+  ASSERT_TRUE(
+      resource_scheduler.AllocateRemoteTaskResources("remote", remote_task_spec));
+  ASSERT_FALSE(
+      resource_scheduler.AllocateRemoteTaskResources("remote", remote_task_spec));
+}
+
+// Measure the cost of scheduling a task in a placement group as the number of
+// placement groups on the node grows. Run it with --gtest_also_run_disabled_tests.
+TEST_F(ClusterResourceSchedulerTest, DISABLED_BenchmarkPlacementGroupScheduling) {
+  const int num_tasks = 10000;
+  for (int num_pgs : {10, 1000, 10000}) {
+    // Each placement group reserves one unit of a custom resource, so that the cost of
+    // the node's CPU instances doesn't grow with the number of placement groups.
+    ClusterResourceScheduler resource_scheduler("local",
+                                                {{"CPU", 16}, {"custom", num_pgs}});
+    resource_scheduler.AddOrUpdateNode("remote", {{"CPU", 16}}, {{"CPU", 16}});
+    std::vector<std::unordered_map<std::string, double>> task_specs;
+    for (int i = 0; i < num_pgs; i++) {
+      const auto pg_id = PlacementGroupID::FromRandom();
+      auto allocation = std::make_shared<TaskResourceInstances>();
+      ASSERT_TRUE(
+          resource_scheduler.AllocateLocalTaskResources({{"custom", 1}}, allocation));
+      resource_scheduler.AddLocalResource(
+          FormatPlacementGroupResource("custom", pg_id, 0), 1);
+      resource_scheduler.AddLocalResource(
+          FormatPlacementGroupResource("custom", pg_id, -1), 1);
+      task_specs.push_back({{FormatPlacementGroupResource("custom", pg_id, 0), 1}});
+    }
+
+    int64_t t;
+    bool is_infeasible;
+    auto start = std::chrono::steady_clock::now();
+    for (int i = 0; i < num_tasks; i++) {
+      const auto &task_spec = task_specs[i % num_pgs];
+      ASSERT_EQ(
+          resource_scheduler.GetBestSchedulableNode(task_spec, false, &t, &is_infeasible),
+          "local");
+      auto allocation = std::make_shared<TaskResourceInstances>();
+      ASSERT_TRUE(resource_scheduler.AllocateLocalTaskResources(task_spec, allocation));
+      resource_scheduler.FreeLocalTaskResources(allocation);
+    }
+    auto schedule_us = std::chrono::duration_cast<std::chrono::microseconds>(
+                           std::chrono::steady_clock::now() - start)
+                           .count();
+
+    start = std::chrono::steady_clock::now();
+    for (int i = 0; i < 100; i++) {
+      resource_scheduler.FillResourceUsage(std::make_shared<rpc::ResourcesData>());
+    }
+    auto report_us = std::chrono::duration_cast<std::chrono::microseconds>(
+                         std::chrono::steady_clock::now() - start)
+                         .count();
+    RAY_LOG(INFO) << num_pgs << " placement groups: "
+                  << static_cast<double>(schedule_us) / num_tasks
+                  << " us to schedule, allocate and free a task, "
+                  << static_cast<double>(report_us) / 100
+                  << " us to fill a resource usage report";
+  }
+}
+
 }  // namespace ray
 
 int main(int argc, char **argv) {
@@ -52,8 +52,8 @@ bool ClusterTaskManager::SchedulePendingTasks() {
       // This argument is used to set violation, which is an unsupported feature now.
       int64_t _unused;
       std::string node_id_string = cluster_resource_scheduler_->GetBestSchedulableNode(
-          placement_resources, task.GetTaskSpecification().IsActorCreationTask(),
-          &_unused, &is_infeasible);
+          placement_resources, task.LocalObjectBytes(),
+          task.GetTaskSpecification().IsActorCreationTask(), &_unused, &is_infeasible);
 
       // There is no node that has available resources to run the request.
       // Move on to the next shape.
@@ -216,6 +216,9 @@ bool ClusterTaskManager::AttemptDispatchWork(const Work &work,
     int64_t _unused;
     bool is_infeasible;
     auto placement_resources = spec.GetRequiredPlacementResources().GetResourceMap();
+    // Locality is not considered here. The task's argument bytes by node are the
+    // owner's view from when it requested the lease, and this node may have pulled the
+    // arguments since then.
     std::string node_id_string = cluster_resource_scheduler_->GetBestSchedulableNode(
         placement_resources, spec.IsActorCreationTask(), &_unused, &is_infeasible);
     RAY_CHECK(!is_infeasible)
@@ -257,7 +260,7 @@ void ClusterTaskManager::QueueTask(const Task &task, rpc::RequestWorkerLeaseRepl
   AddToBacklogTracker(task);
 }
 
-void ClusterTaskManager::TasksUnblocked(const std::vector<TaskID> ready_ids) {
+void ClusterTaskManager::TasksUnblocked(const std::vector<TaskID> &ready_ids) {
   for (const auto &task_id : ready_ids) {
     auto it = waiting_tasks_.find(task_id);
     if (it != waiting_tasks_.end()) {
@@ -702,6 +705,38 @@ void ClusterTaskManager::Dispatch(
       }
     }
   }
+  for (const auto &bundle : allocated_resources->bundle_resources) {
+    for (const auto &bundle_resource : bundle.second) {
+      bool first = true;  // Set resource name only if at least one of its
+                          // instances has available capacity.
+      for (size_t inst_idx = 0; inst_idx < bundle_resource.second.size(); inst_idx++) {
+        if (bundle_resource.second[inst_idx] > 0.) {
+          if (first) {
+            resource = reply->add_resource_mapping();
+            resource->set_name(cluster_resource_scheduler_->GetResourceNameFromIndex(
+                bundle.first, bundle_resource.first));
+            first = false;
+          }
+          auto rid = resource->add_resource_ids();
+          rid->set_index(inst_idx);
+          rid->set_quantity(bundle_resource.second[inst_idx].Double());
+        }
+      }
+    }
+  }
+  if (RayConfig::instance().worker_cpu_affinity()) {
+    // Pin the worker to the CPUs of its task, or unpin it if the task doesn't own any
+    // CPU, since the worker may have been pinned for a previous task.
+    const auto cpu_ids =
+        cluster_resource_scheduler_->GetCpuAffinity(*allocated_resources);
+    if (!cpu_ids.empty()) {
+      auto status = SetCpuAffinity(worker->GetProcess().GetId(), cpu_ids);
+      if (!status.ok()) {
+        RAY_LOG(WARNING) << "Failed to set the CPU affinity of worker "
+                         << worker->WorkerId() << ": " << status.ToString();
+      }
+    }
+  }
   // Send the result back.
   send_reply_callback();
 }
@@ -86,11 +86,11 @@ class ClusterTaskManager {
   void QueueTask(const Task &task, rpc::RequestWorkerLeaseReply *reply,
                  std::function<void(void)>);
 
-  /// Move tasks from waiting to ready for dispatch. Called when a task's
-  /// dependencies are resolved.
+  /// Move tasks from waiting to ready for dispatch. Called with a batch of tasks
+  /// whose dependencies were resolved.
   ///
   /// \param readyIds: The tasks which are now ready to be dispatched.
-  void TasksUnblocked(const std::vector<TaskID> ready_ids);
+  void TasksUnblocked(const std::vector<TaskID> &ready_ids);
 
   /// (Step 5) Call once a task finishes (i.e. a worker is returned).
   ///
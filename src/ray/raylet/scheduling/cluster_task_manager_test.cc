@@ -350,6 +350,67 @@ TEST_F(ClusterTaskManagerTest, TestSpillAfterAssigned) {
   AssertNoLeaks();
 }
 
+TEST_F(ClusterTaskManagerTest, TestSpillAfterAssignedIgnoresLocality) {
+  /*
+    A task that is assigned to the local node, but cannot run because a different task
+    gets its resources first, is spilled back by load alone. The node that held its
+    arguments when the lease was requested is not preferred, since the arguments may
+    have been pulled to the local node since.
+  */
+  std::shared_ptr<MockWorker> worker =
+      std::make_shared<MockWorker>(WorkerID::FromRandom(), 1234);
+  auto remote_node_id = NodeID::FromRandom();
+  auto other_remote_node_id = NodeID::FromRandom();
+  AddNode(remote_node_id, 5);
+  AddNode(other_remote_node_id, 5);
+
+  // Find the node that a task is spilled back to by load alone, once the local node
+  // is busy, and let the other remote node hold the task's arguments.
+  std::unordered_map<std::string, double> task_resources = {
+      {ray::kCPU_ResourceLabel, 5}};
+  std::unordered_map<std::string, double> local_resources = {
+      {ray::kCPU_ResourceLabel, 8}};
+  auto local_allocation = std::make_shared<TaskResourceInstances>();
+  ASSERT_TRUE(scheduler_->AllocateLocalTaskResources(local_resources, local_allocation));
+  int64_t _unused;
+  bool is_infeasible;
+  std::string spillback_node_id = scheduler_->GetBestSchedulableNode(
+      task_resources, /*actor_creation=*/false, &_unused, &is_infeasible);
+  scheduler_->FreeLocalTaskResources(local_allocation);
+  ASSERT_FALSE(spillback_node_id.empty());
+  std::string holder_node_id = spillback_node_id == remote_node_id.Binary()
+                                   ? other_remote_node_id.Binary()
+                                   : remote_node_id.Binary();
+  // The node that holds the arguments is busy while the tasks are scheduled, so they
+  // are both assigned to the local node.
+  std::unordered_map<std::string, double> holder_resources = {
+      {ray::kCPU_ResourceLabel, 5}};
+  scheduler_->AddOrUpdateNode(holder_node_id, holder_resources, {});
+
+  int num_callbacks = 0;
+  auto callback = [&]() { num_callbacks++; };
+  auto task = CreateTask(task_resources);
+  rpc::RequestWorkerLeaseReply local_reply;
+  task_manager_.QueueTask(task, &local_reply, callback);
+  auto task2 = CreateTask(task_resources, 1);
+  task2.SetLocalObjectBytes({{holder_node_id, 100 * 1024 * 1024}});
+  rpc::RequestWorkerLeaseReply spillback_reply;
+  task_manager_.QueueTask(task2, &spillback_reply, callback);
+  task_manager_.SchedulePendingTasks();
+  task_manager_.DispatchScheduledTasksToWorkers(pool_, leased_workers_);
+  ASSERT_EQ(num_callbacks, 0);
+
+  // Once the tasks are dispatched, the second task is spilled back by load alone.
+  scheduler_->AddOrUpdateNode(holder_node_id, holder_resources, holder_resources);
+  pool_.PushWorker(std::dynamic_pointer_cast<WorkerInterface>(worker));
+  pool_.PushWorker(std::dynamic_pointer_cast<WorkerInterface>(worker));
+  task_manager_.DispatchScheduledTasksToWorkers(pool_, leased_workers_);
+  ASSERT_EQ(num_callbacks, 2);
+  ASSERT_EQ(leased_workers_.size(), 1);
+  ASSERT_EQ(spillback_reply.retry_at_raylet_address().raylet_id(), spillback_node_id);
+  AssertNoLeaks();
+}
+
 TEST_F(ClusterTaskManagerTest, TaskCancellationTest) {
   std::shared_ptr<MockWorker> worker =
       std::make_shared<MockWorker>(WorkerID::FromRandom(), 1234);
@@ -0,0 +1,256 @@
+// Copyright 2017 The Ray Authors.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//  http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "ray/raylet/scheduling/node_topology.h"
+
+#ifdef __linux__
+#include <dirent.h>
+#include <sched.h>
+#endif
+
+#include <algorithm>
+#include <cctype>
+#include <cstring>
+#include <fstream>
+#include <sstream>
+
+#include "ray/common/task/scheduling_resources.h"
+#include "ray/util/logging.h"
+
+namespace {
+
+/// The largest device ID, which bounds the size of an ID range.
+const int64_t kMaxDeviceId = 1 << 20;
+
+/// Parse a device ID that makes up a whole string.
+bool ParseId(const std::string &str, int64_t *id) {
+  if (str.empty() || str.size() > 7 ||
+      !std::all_of(str.begin(), str.end(), [](char c) { return std::isdigit(c); })) {
+    return false;
+  }
+  *id = std::stoll(str);
+  return *id <= kMaxDeviceId;
+}
+
+#ifdef __linux__
+/// Read the first line of a file, e.g., a sysfs attribute.
+bool ReadLine(const std::string &path, std::string *line) {
+  std::ifstream file(path);
+  return file && std::getline(file, *line);
+}
+
+/// List the entries of a directory whose names start with a prefix.
+std::vector<std::string> ListDirectory(const std::string &path,
+                                       const std::string &prefix) {
+  std::vector<std::string> entries;
+  DIR *dir = opendir(path.c_str());
+  if (dir == nullptr) {
+    return entries;
+  }
+  while (struct dirent *entry = readdir(dir)) {
+    std::string name(entry->d_name);
+    if (name.compare(0, prefix.size(), prefix) == 0) {
+      entries.push_back(name);
+    }
+  }
+  closedir(dir);
+  std::sort(entries.begin(), entries.end());
+  return entries;
+}
+#endif
+
+}  // namespace
+
+namespace ray {
+
+Status NodeTopology::Parse(const std::string &description, NodeTopology *topology) {
+  std::istringstream lines(description);
+  std::string line;
+  while (std::getline(lines, line)) {
+    std::istringstream fields(line);
+    std::string resource_name;
+    if (!(fields >> resource_name) || resource_name[0] == '#') {
+      continue;
+    }
+    int64_t socket;
+    std::string list;
+    std::vector<int64_t> device_ids;
+    if (!(fields >> socket >> list) || socket < 0 || !ParseIdList(list, &device_ids)) {
+      return Status::Invalid("Malformed node topology line: " + line);
+    }
+    topology->AddDevices(resource_name, socket, device_ids);
+  }
+  return Status::OK();
+}
+
+NodeTopology NodeTopology::Load(const std::string &path, const std::string &sysfs_root) {
+  if (path.empty()) {
+    return FromSysfs(sysfs_root);
+  }
+  NodeTopology topology;
+  std::ifstream file(path);
+  if (!file) {
+    RAY_LOG(WARNING) << "Failed to open the node topology file " << path
+                     << ", instances will be allocated without topology information.";
+    return topology;
+  }
+  std::stringstream description;
+  description << file.rdbuf();
+  auto status = Parse(description.str(), &topology);
+  if (!status.ok()) {
+    RAY_LOG(WARNING) << status.ToString()
+                     << ", instances will be allocated without topology information.";
+    return NodeTopology();
+  }
+  return topology;
+}
+
+NodeTopology NodeTopology::FromSysfs(const std::string &sysfs_root) {
+  NodeTopology topology;
+#ifdef __linux__
+  // CPUs, by NUMA node.
+  const std::string node_dir = sysfs_root + "/devices/system/node";
+  for (const auto &node : ListDirectory(node_dir, "node")) {
+    int64_t socket;
+    std::string list;
+    std::vector<int64_t> cpu_ids;
+    if (ParseId(node.substr(4), &socket) &&
+        ReadLine(node_dir + "/" + node + "/cpulist", &list) &&
+        ParseIdList(list, &cpu_ids)) {
+      topology.AddDevices(kCPU_ResourceLabel, socket, cpu_ids);
+    }
+  }
+  if (topology.Empty()) {
+    // Kernels without NUMA support only report the physical package of each CPU.
+    const std::string cpu_dir = sysfs_root + "/devices/system/cpu";
+    for (const auto &cpu : ListDirectory(cpu_dir, "cpu")) {
+      int64_t cpu_id;
+      std::string package;
+      int64_t socket;
+      if (ParseId(cpu.substr(3), &cpu_id) &&
+          ReadLine(cpu_dir + "/" + cpu + "/topology/physical_package_id", &package) &&
+          ParseId(package, &socket)) {
+        topology.AddDevices(kCPU_ResourceLabel, socket, {cpu_id});
+      }
+    }
+  }
+
+  // NVIDIA GPUs, in PCI bus order. This is the order that CUDA uses when
+  // CUDA_DEVICE_ORDER=PCI_BUS_ID.
+  const std::string pci_dir = sysfs_root + "/bus/pci/devices";
+  int64_t gpu_id = 0;
+  for (const auto &device : ListDirectory(pci_dir, "")) {
+    std::string vendor, device_class, numa_node;
+    if (!ReadLine(pci_dir + "/" + device + "/vendor", &vendor) || vendor != "0x10de" ||
+        !ReadLine(pci_dir + "/" + device + "/class", &device_class) ||
+        // VGA and 3D controllers.
+        (device_class.compare(0, 6, "0x0300") != 0 &&
+         device_class.compare(0, 6, "0x0302") != 0)) {
+      continue;
+    }
+    int64_t socket = 0;
+    // The NUMA node is -1 on machines with a single node.
+    if (ReadLine(pci_dir + "/" + device + "/numa_node", &numa_node)) {
+      ParseId(numa_node, &socket);
+    }
+    topology.AddDevices(kGPU_ResourceLabel, socket, {gpu_id++});
+  }
+#endif
+  return topology;
+}
+
+bool NodeTopology::ParseIdList(const std::string &list, std::vector<int64_t> *ids) {
+  std::istringstream ranges(list);
+  std::string range;
+  while (std::getline(ranges, range, ',')) {
+    const auto dash = range.find('-');
+    int64_t first, last;
+    if (!ParseId(range.substr(0, dash), &first)) {
+      return false;
+    }
+    if (dash == std::string::npos) {
+      last = first;
+    } else if (!ParseId(range.substr(dash + 1), &last) || last < first) {
+      return false;
+    }
+    for (int64_t id = first; id <= last; id++) {
+      ids->push_back(id);
+    }
+  }
+  return !ids->empty();
+}
+
+void NodeTopology::AddDevices(const std::string &resource_name, int64_t socket,
+                              const std::vector<int64_t> &device_ids) {
+  auto &sockets = sockets_[resource_name];
+  for (int64_t device_id : device_ids) {
+    sockets[device_id] = socket;
+  }
+}
+
+std::vector<int64_t> NodeTopology::GetInstanceSockets(
+    const std::string &resource_name) const {
+  std::vector<int64_t> instance_sockets;
+  auto it = sockets_.find(resource_name);
+  if (it != sockets_.end()) {
+    for (const auto &device : it->second) {
+      instance_sockets.push_back(device.second);
+    }
+  }
+  return instance_sockets;
+}
+
+std::vector<int64_t> NodeTopology::GetInstanceDeviceIds(
+    const std::string &resource_name) const {
+  std::vector<int64_t> device_ids;
+  auto it = sockets_.find(resource_name);
+  if (it != sockets_.end()) {
+    for (const auto &device : it->second) {
+      device_ids.push_back(device.first);
+    }
+  }
+  return device_ids;
+}
+
+std::string NodeTopology::DebugString() const {
+  std::stringstream buffer;
+  for (const auto &resource : sockets_) {
+    buffer << resource.first << ":";
+    for (const auto &device : resource.second) {
+      buffer << " " << device.first << "@" << device.second;
+    }
+    buffer << "\n";
+  }
+  return buffer.str();
+}
+
+Status SetCpuAffinity(pid_t pid, const std::vector<int64_t> &cpu_ids) {
+#ifdef __linux__
+  cpu_set_t mask;
+  CPU_ZERO(&mask);
+  for (int64_t cpu_id : cpu_ids) {
+    if (cpu_id >= 0 && cpu_id < CPU_SETSIZE) {
+      CPU_SET(cpu_id, &mask);
+    }
+  }
+  if (sched_setaffinity(pid, sizeof(mask), &mask) != 0) {
+    return Status::IOError("sched_setaffinity failed: " + std::string(strerror(errno)));
+  }
+  return Status::OK();
+#else
+  return Status::NotImplemented("CPU affinity is only supported on Linux.");
+#endif
+}
+
+}  // namespace ray
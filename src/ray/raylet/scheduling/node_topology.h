@@ -0,0 +1,98 @@
+// Copyright 2017 The Ray Authors.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//  http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#pragma once
+
+#include <map>
+#include <string>
+#include <vector>
+
+#include "ray/common/status.h"
+#include "ray/util/process.h"
+
+namespace ray {
+
+/// \class NodeTopology
+///
+/// The socket (NUMA node) that each CPU and GPU of a node is attached to. The i-th
+/// instance of a resource is the device with the i-th smallest ID, e.g., the i-th
+/// logical CPU, or the i-th GPU in PCI bus order.
+///
+/// A topology is described by lines of the form `<resource> <socket> <device IDs>`,
+/// where the device IDs use the Linux cpulist format, e.g.:
+///
+///   CPU 0 0-7,16-23
+///   CPU 1 8-15,24-31
+///   GPU 0 0-1
+///   GPU 1 2-3
+///
+/// Empty lines and lines starting with '#' are ignored.
+class NodeTopology {
+ public:
+  /// Parse a topology description.
+  ///
+  /// \param description The description, as described above.
+  /// \param[out] topology The parsed topology.
+  /// \return Status::Invalid if the description is malformed.
+  static Status Parse(const std::string &description, NodeTopology *topology);
+
+  /// Load a topology from a description file, or from sysfs if the path is empty.
+  /// If the topology cannot be loaded, the result is empty.
+  ///
+  /// \param path The path of the description file.
+  /// \param sysfs_root The directory that sysfs is mounted on.
+  static NodeTopology Load(const std::string &path,
+                           const std::string &sysfs_root = "/sys");
+
+  /// Read the topology of the local node from sysfs.
+  ///
+  /// \param sysfs_root The directory that sysfs is mounted on.
+  static NodeTopology FromSysfs(const std::string &sysfs_root);
+
+  /// Parse a list of IDs in the Linux cpulist format, e.g., "0-3,8,10-11".
+  ///
+  /// \return Whether the list is well formed.
+  static bool ParseIdList(const std::string &list, std::vector<int64_t> *ids);
+
+  /// Record that devices of a resource are attached to a socket.
+  void AddDevices(const std::string &resource_name, int64_t socket,
+                  const std::vector<int64_t> &device_ids);
+
+  /// The socket of each instance of a resource.
+  ///
+  /// \return The sockets, in instance order. Empty if the resource is unknown.
+  std::vector<int64_t> GetInstanceSockets(const std::string &resource_name) const;
+
+  /// The device ID of each instance of a resource, e.g., the logical CPU IDs.
+  ///
+  /// \return The device IDs, in instance order. Empty if the resource is unknown.
+  std::vector<int64_t> GetInstanceDeviceIds(const std::string &resource_name) const;
+
+  bool Empty() const { return sockets_.empty(); }
+
+  std::string DebugString() const;
+
+ private:
+  /// Map from resource name to the socket of each device, by device ID.
+  std::map<std::string, std::map<int64_t, int64_t>> sockets_;
+};
+
+/// Restrict a process to run on a set of logical CPUs. Only supported on Linux.
+///
+/// \param pid The process.
+/// \param cpu_ids The logical CPU IDs.
+/// \return Status::NotImplemented if the platform doesn't support CPU affinity.
+Status SetCpuAffinity(pid_t pid, const std::vector<int64_t> &cpu_ids);
+
+}  // namespace ray
@@ -0,0 +1,107 @@
+// Copyright 2017 The Ray Authors.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//  http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "ray/raylet/scheduling/node_topology.h"
+
+#ifdef __linux__
+#include <sys/stat.h>
+#endif
+
+#include <fstream>
+
+#include "gtest/gtest.h"
+#include "ray/common/id.h"
+
+namespace ray {
+
+TEST(NodeTopologyTest, TestParseIdList) {
+  std::vector<int64_t> ids;
+  ASSERT_TRUE(NodeTopology::ParseIdList("0-3,8,10-11", &ids));
+  ASSERT_EQ(ids, std::vector<int64_t>({0, 1, 2, 3, 8, 10, 11}));
+  for (const auto &list : {"", "3-1", "a", "1-", "-1", "1,,2", "0-99999999"}) {
+    ids.clear();
+    ASSERT_FALSE(NodeTopology::ParseIdList(list, &ids)) << list;
+  }
+}
+
+TEST(NodeTopologyTest, TestParse) {
+  NodeTopology topology;
+  RAY_CHECK_OK(NodeTopology::Parse(
+      "# Two sockets.\n"
+      "CPU 1 2-3\n"
+      "CPU 0 0-1\n"
+      "\n"
+      "GPU 1 1\n"
+      "GPU 0 0\n",
+      &topology));
+  ASSERT_EQ(topology.GetInstanceSockets("CPU"), std::vector<int64_t>({0, 0, 1, 1}));
+  ASSERT_EQ(topology.GetInstanceDeviceIds("CPU"), std::vector<int64_t>({0, 1, 2, 3}));
+  ASSERT_EQ(topology.GetInstanceSockets("GPU"), std::vector<int64_t>({0, 1}));
+  ASSERT_TRUE(topology.GetInstanceSockets("TPU").empty());
+
+  NodeTopology malformed;
+  ASSERT_TRUE(NodeTopology::Parse("CPU 0\n", &malformed).IsInvalid());
+  ASSERT_TRUE(NodeTopology::Parse("CPU x 0-1\n", &malformed).IsInvalid());
+}
+
+TEST(NodeTopologyTest, TestLoadFile) {
+  const std::string path = "/tmp/ray_node_topology_" + UniqueID::FromRandom().Hex();
+  ASSERT_TRUE(NodeTopology::Load(path).Empty());
+  {
+    std::ofstream file(path);
+    file << "GPU 0 0-1\nGPU 1 2-3\n";
+  }
+  auto topology = NodeTopology::Load(path);
+  ASSERT_EQ(topology.GetInstanceSockets("GPU"), std::vector<int64_t>({0, 0, 1, 1}));
+  std::remove(path.c_str());
+}
+
+#ifdef __linux__
+TEST(NodeTopologyTest, TestFromSysfs) {
+  const std::string root = "/tmp/ray_sysfs_" + UniqueID::FromRandom().Hex();
+  auto make_file = [&root](const std::string &path, const std::string &content) {
+    std::string dir;
+    for (size_t pos = 0; (pos = path.find('/', pos + 1)) != std::string::npos;) {
+      dir = root + path.substr(0, pos);
+      mkdir(dir.c_str(), 0755);
+    }
+    std::ofstream(root + path) << content << "\n";
+  };
+  mkdir(root.c_str(), 0755);
+  make_file("/devices/system/node/node0/cpulist", "0-1,4-5");
+  make_file("/devices/system/node/node1/cpulist", "2-3,6-7");
+  // A GPU on each socket, and a device that isn't a GPU.
+  make_file("/bus/pci/devices/0000:3b:00.0/vendor", "0x10de");
+  make_file("/bus/pci/devices/0000:3b:00.0/class", "0x030200");
+  make_file("/bus/pci/devices/0000:3b:00.0/numa_node", "0");
+  make_file("/bus/pci/devices/0000:86:00.0/vendor", "0x10de");
+  make_file("/bus/pci/devices/0000:86:00.0/class", "0x030200");
+  make_file("/bus/pci/devices/0000:86:00.0/numa_node", "1");
+  make_file("/bus/pci/devices/0000:00:1f.0/vendor", "0x8086");
+  make_file("/bus/pci/devices/0000:00:1f.0/class", "0x060100");
+
+  auto topology = NodeTopology::FromSysfs(root);
+  ASSERT_EQ(topology.GetInstanceSockets("CPU"),
+            std::vector<int64_t>({0, 0, 1, 1, 0, 0, 1, 1}));
+  ASSERT_EQ(topology.GetInstanceSockets("GPU"), std::vector<int64_t>({0, 1}));
+  ASSERT_EQ(system(("rm -rf " + root).c_str()), 0);
+}
+#endif
+
+}  // namespace ray
+
+int main(int argc, char **argv) {
+  ::testing::InitGoogleTest(&argc, argv);
+  return RUN_ALL_TESTS();
+}
@@ -0,0 +1,158 @@
+// Copyright 2017 The Ray Authors.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//  http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "ray/raylet/worker_demand_forecaster.h"
+
+#include <algorithm>
+#include <cmath>
+
+#include "ray/util/logging.h"
+
+namespace {
+
+/// The smallest autocorrelation at which the demand is considered periodic.
+const double kMinPeriodAutocorrelation = 0.6;
+
+}  // namespace
+
+namespace ray {
+
+namespace raylet {
+
+WorkerDemandForecaster::WorkerDemandForecaster(int64_t interval_ms, size_t history_size,
+                                               double ewma_alpha)
+    : interval_ms_(interval_ms), history_size_(history_size), ewma_alpha_(ewma_alpha) {
+  RAY_CHECK(interval_ms_ > 0);
+  RAY_CHECK(ewma_alpha_ > 0 && ewma_alpha_ <= 1);
+}
+
+void WorkerDemandForecaster::RecordDemand(const JobID &job_id, const Language &language,
+                                          int64_t num_workers, int64_t now_ms) {
+  Tick(now_ms);
+  auto &history = histories_[job_id][language];
+  history.current_peak = std::max(history.current_peak, num_workers);
+}
+
+void WorkerDemandForecaster::Tick(int64_t now_ms) {
+  if (interval_end_ms_ == 0) {
+    interval_end_ms_ = now_ms + interval_ms_;
+    return;
+  }
+  // After a long pause, all the intervals but the last few would be empty, and would
+  // only push the older demands out of the histories.
+  size_t num_closed = 0;
+  while (now_ms >= interval_end_ms_) {
+    if (num_closed < history_size_ + 1) {
+      for (auto &job_entry : histories_) {
+        for (auto &language_entry : job_entry.second) {
+          CloseInterval(&language_entry.second);
+        }
+      }
+      num_closed++;
+    }
+    interval_end_ms_ += interval_ms_;
+  }
+}
+
+void WorkerDemandForecaster::CloseInterval(DemandHistory *history) {
+  const int64_t peak = history->current_peak;
+  history->current_peak = 0;
+  history->past_peaks.push_back(peak);
+  if (history->past_peaks.size() > history_size_) {
+    history->past_peaks.pop_front();
+  }
+  history->ewma = ewma_alpha_ * peak + (1 - ewma_alpha_) * history->ewma;
+  history->period = DetectPeriod(history->past_peaks);
+
+  if (history->period > 0) {
+    // Keep the workers of the largest burst in the next period, instead of killing them
+    // between bursts and starting them again for the next one.
+    const auto &peaks = history->past_peaks;
+    history->forecast = *std::max_element(peaks.end() - history->period, peaks.end());
+  } else {
+    // Round to the nearest worker, so that the average decays to 0 once the demand
+    // stops.
+    history->forecast = std::llround(history->ewma);
+  }
+}
+
+size_t WorkerDemandForecaster::DetectPeriod(const std::deque<int64_t> &peaks) const {
+  const size_t n = peaks.size();
+  if (n < 4) {
+    return 0;
+  }
+  double mean = 0;
+  for (int64_t peak : peaks) {
+    mean += peak;
+  }
+  mean /= n;
+  double variance = 0;
+  for (int64_t peak : peaks) {
+    variance += (peak - mean) * (peak - mean);
+  }
+  variance /= n;
+  if (variance == 0) {
+    // Constant demand is handled by the moving average.
+    return 0;
+  }
+
+  // A lag of 1 only means that the demand changes slowly, which the moving average
+  // already follows. At least two full periods are needed to trust a period.
+  size_t best_period = 0;
+  double best_autocorrelation = kMinPeriodAutocorrelation;
+  for (size_t lag = 2; lag <= n / 2; lag++) {
+    double covariance = 0;
+    for (size_t i = lag; i < n; i++) {
+      covariance += (peaks[i] - mean) * (peaks[i - lag] - mean);
+    }
+    const double autocorrelation = covariance / (n - lag) / variance;
+    // Multiples of the period correlate as well as the period itself, so only a
+    // strictly better lag replaces a shorter one.
+    if (autocorrelation > best_autocorrelation) {
+      best_autocorrelation = autocorrelation;
+      best_period = lag;
+    }
+  }
+  return best_period;
+}
+
+int64_t WorkerDemandForecaster::Forecast(const JobID &job_id,
+                                         const Language &language) const {
+  auto job_it = histories_.find(job_id);
+  if (job_it == histories_.end()) {
+    return 0;
+  }
+  auto it = job_it->second.find(language);
+  if (it == job_it->second.end()) {
+    return 0;
+  }
+  return it->second.forecast;
+}
+
+void WorkerDemandForecaster::ForEachForecast(
+    const std::function<void(const JobID &, const Language &, int64_t)> &fn) const {
+  for (const auto &job_entry : histories_) {
+    for (const auto &language_entry : job_entry.second) {
+      if (language_entry.second.forecast > 0) {
+        fn(job_entry.first, language_entry.first, language_entry.second.forecast);
+      }
+    }
+  }
+}
+
+void WorkerDemandForecaster::RemoveJob(const JobID &job_id) { histories_.erase(job_id); }
+
+}  // namespace raylet
+
+}  // namespace ray
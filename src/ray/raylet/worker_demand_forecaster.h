@@ -0,0 +1,118 @@
+// Copyright 2017 The Ray Authors.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//  http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#pragma once
+
+#include <deque>
+#include <functional>
+#include <unordered_map>
+
+#include "absl/container/flat_hash_map.h"
+#include "ray/common/id.h"
+#include "ray/common/task/task_common.h"
+
+namespace ray {
+
+namespace raylet {
+
+/// \class WorkerDemandForecaster
+///
+/// Forecasts how many workers each job needs per language, so that the worker pool can
+/// keep a warm pool of idle workers of that size instead of reacting only to the current
+/// backlog.
+///
+/// Time is divided into fixed intervals. The demand of an interval is the peak number of
+/// workers that a job leased or waited for during the interval. If the history of demands
+/// is periodic, the forecast is the peak demand of the last period, so that the workers
+/// are kept between bursts. Otherwise, it is the exponentially weighted moving average
+/// (EWMA) of the demands.
+class WorkerDemandForecaster {
+ public:
+  /// \param interval_ms The length of an interval.
+  /// \param history_size The number of past intervals kept to detect periodic demand.
+  /// Periods of up to half this number of intervals are detected.
+  /// \param ewma_alpha The weight of the latest interval in the moving average.
+  WorkerDemandForecaster(int64_t interval_ms, size_t history_size,
+                         double ewma_alpha = 0.3);
+
+  /// Record the number of workers that a job needs right now. The demand of the
+  /// current interval is the largest number recorded during it.
+  ///
+  /// \param job_id The job that needs the workers.
+  /// \param language The language of the workers.
+  /// \param num_workers The number of workers the job is using or waiting for.
+  /// \param now_ms The current time.
+  void RecordDemand(const JobID &job_id, const Language &language, int64_t num_workers,
+                    int64_t now_ms);
+
+  /// Close the intervals that ended before the given time, and update the forecasts.
+  ///
+  /// \param now_ms The current time.
+  void Tick(int64_t now_ms);
+
+  /// Get the number of workers that a job is expected to need soon.
+  ///
+  /// \param job_id The job.
+  /// \param language The language of the workers.
+  /// \return The forecasted demand, or 0 if no demand was recorded for the job.
+  int64_t Forecast(const JobID &job_id, const Language &language) const;
+
+  /// Call the given function with the forecasted demand of each job and language that
+  /// has a nonzero forecast.
+  void ForEachForecast(
+      const std::function<void(const JobID &, const Language &, int64_t)> &fn) const;
+
+  /// Forget the demand of a finished job.
+  void RemoveJob(const JobID &job_id);
+
+ private:
+  /// The demand history of one job and language.
+  struct DemandHistory {
+    /// The peak demand of the current interval.
+    int64_t current_peak = 0;
+    /// The peak demands of the past intervals, oldest first.
+    std::deque<int64_t> past_peaks;
+    /// The moving average of the past peak demands.
+    double ewma = 0;
+    /// The detected period in intervals, or 0 if the demand is not periodic.
+    size_t period = 0;
+    /// The forecasted demand.
+    int64_t forecast = 0;
+  };
+
+  /// Close the current interval of a history and update its forecast.
+  void CloseInterval(DemandHistory *history);
+
+  /// Find the period of the past demands, i.e., the lag with the largest
+  /// autocorrelation, if it is large enough.
+  ///
+  /// \return The period in intervals, or 0 if the demand is not periodic.
+  size_t DetectPeriod(const std::deque<int64_t> &peaks) const;
+
+  /// The length of an interval.
+  const int64_t interval_ms_;
+  /// The number of past intervals kept per history.
+  const size_t history_size_;
+  /// The weight of the latest interval in the moving average.
+  const double ewma_alpha_;
+  /// The end of the current interval. 0 until the first demand is recorded.
+  int64_t interval_end_ms_ = 0;
+  /// The demand histories by job and language.
+  absl::flat_hash_map<JobID, std::unordered_map<Language, DemandHistory, std::hash<int>>>
+      histories_;
+};
+
+}  // namespace raylet
+
+}  // namespace ray
@@ -0,0 +1,101 @@
+// Copyright 2017 The Ray Authors.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//  http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "ray/raylet/worker_demand_forecaster.h"
+
+#include "gtest/gtest.h"
+
+namespace ray {
+
+namespace raylet {
+
+const int64_t kIntervalMs = 1000;
+const JobID kJobId = JobID::FromInt(1);
+
+class WorkerDemandForecasterTest : public ::testing::Test {
+ public:
+  WorkerDemandForecasterTest() : forecaster_(kIntervalMs, /*history_size=*/20) {}
+
+  /// Record the given demand in each of the next intervals.
+  void RecordDemands(const std::vector<int64_t> &demands) {
+    for (int64_t demand : demands) {
+      now_ms_ += kIntervalMs;
+      forecaster_.RecordDemand(kJobId, Language::PYTHON, demand, now_ms_);
+    }
+  }
+
+ protected:
+  WorkerDemandForecaster forecaster_;
+  int64_t now_ms_ = 0;
+};
+
+TEST_F(WorkerDemandForecasterTest, TestSteadyDemand) {
+  ASSERT_EQ(forecaster_.Forecast(kJobId, Language::PYTHON), 0);
+  RecordDemands(std::vector<int64_t>(15, 3));
+  ASSERT_EQ(forecaster_.Forecast(kJobId, Language::PYTHON), 3);
+  ASSERT_EQ(forecaster_.Forecast(kJobId, Language::JAVA), 0);
+
+  // Only the peak demand of an interval counts.
+  now_ms_ += kIntervalMs;
+  for (int i = 0; i < 10; i++) {
+    forecaster_.RecordDemand(kJobId, Language::PYTHON, i, now_ms_ + i);
+  }
+  forecaster_.Tick(now_ms_ + kIntervalMs);
+  ASSERT_GT(forecaster_.Forecast(kJobId, Language::PYTHON), 3);
+
+  // The forecast decays once the demand stops.
+  now_ms_ += 20 * kIntervalMs;
+  forecaster_.Tick(now_ms_);
+  ASSERT_EQ(forecaster_.Forecast(kJobId, Language::PYTHON), 0);
+}
+
+TEST_F(WorkerDemandForecasterTest, TestPeriodicDemand) {
+  // A burst of 5 workers every 4 intervals. The moving average alone would forecast
+  // about 1 worker between bursts.
+  std::vector<int64_t> demands;
+  for (int i = 0; i < 12; i++) {
+    demands.push_back(i % 4 == 0 ? 5 : 0);
+  }
+  RecordDemands(demands);
+  // Once the period is detected, the workers are kept between bursts.
+  for (int i = 0; i < 8; i++) {
+    RecordDemands({i % 4 == 0 ? 5 : 0});
+    ASSERT_EQ(forecaster_.Forecast(kJobId, Language::PYTHON), 5);
+  }
+}
+
+TEST_F(WorkerDemandForecasterTest, TestRemoveJob) {
+  for (int i = 0; i < 15; i++) {
+    RecordDemands({2});
+    forecaster_.RecordDemand(kJobId, Language::JAVA, 1, now_ms_);
+  }
+  int num_forecasts = 0;
+  forecaster_.ForEachForecast(
+      [&num_forecasts](const JobID &job_id, const Language &, int64_t) {
+        ASSERT_EQ(job_id, kJobId);
+        num_forecasts++;
+      });
+  ASSERT_EQ(num_forecasts, 2);
+
+  forecaster_.RemoveJob(kJobId);
+  ASSERT_EQ(forecaster_.Forecast(kJobId, Language::PYTHON), 0);
+  num_forecasts = 0;
+  forecaster_.ForEachForecast(
+      [&num_forecasts](const JobID &, const Language &, int64_t) { num_forecasts++; });
+  ASSERT_EQ(num_forecasts, 0);
+}
+
+}  // namespace raylet
+
+}  // namespace ray
@@ -14,6 +14,12 @@
 
 #include "ray/raylet/worker_pool.h"
 
+#ifndef _WIN32
+#include <fcntl.h>
+#include <signal.h>
+#include <sys/socket.h>
+#endif
+
 #include <algorithm>
 #include <boost/date_time/posix_time/posix_time.hpp>
 
@@ -22,6 +28,7 @@
 #include "ray/common/ray_config.h"
 #include "ray/common/status.h"
 #include "ray/gcs/pb_util.h"
+#include "ray/raylet/worker_zygote.h"
 #include "ray/stats/stats.h"
 #include "ray/util/logging.h"
 #include "ray/util/util.h"
@@ -72,7 +79,10 @@ WorkerPool::WorkerPool(boost::asio::io_service &io_service, int num_workers_soft
       first_job_driver_wait_num_python_workers_(std::min(
           num_initial_python_workers_for_first_job, maximum_startup_concurrency)),
       num_initial_python_workers_for_first_job_(num_initial_python_workers_for_first_job),
-      kill_idle_workers_timer_(io_service) {
+      kill_idle_workers_timer_(io_service),
+      demand_forecaster_(
+          RayConfig::instance().worker_demand_forecast_interval_ms(),
+          RayConfig::instance().worker_demand_forecast_history_size()) {
   RAY_CHECK(maximum_startup_concurrency > 0);
 #ifndef _WIN32
   // Ignore SIGCHLD signals. If we don't do this, then worker processes will
@@ -120,8 +130,8 @@ WorkerPool::~WorkerPool() {
       procs_to_kill.insert(starting_worker.first);
     }
   }
-  for (Process proc : procs_to_kill) {
-    proc.Kill();
+  for (const Process &proc : procs_to_kill) {
+    KillWorkerProcess(proc);
     // NOTE: Avoid calling Wait() here. It fails with ECHILD, as SIGCHLD is disabled.
   }
 }
@@ -130,6 +140,13 @@ Process WorkerPool::StartWorkerProcess(
     const Language &language, const rpc::WorkerType worker_type, const JobID &job_id,
     std::vector<std::string> dynamic_options,
     std::unordered_map<std::string, std::string> override_environment_variables) {
+  // Only the plain Python workers of a job are forked from its zygote, since the other
+  // workers are started with a different command or environment.
+  const bool fork_from_zygote = RayConfig::instance().worker_zygote_enabled() &&
+                                language == Language::PYTHON &&
+                                worker_type == rpc::WorkerType::WORKER &&
+                                dynamic_options.empty() &&
+                                override_environment_variables.empty();
   rpc::JobConfig *job_config = nullptr;
   if (!IsIOWorkerType(worker_type)) {
     RAY_CHECK(!job_id.IsNil());
@@ -277,16 +294,22 @@ Process WorkerPool::StartWorkerProcess(
   for (const auto &pair : override_environment_variables) {
     env[pair.first] = pair.second;
   }
-  // Start a process and measure the startup time.
-  auto start = std::chrono::high_resolution_clock::now();
-  Process proc = StartProcess(worker_command_args, env);
-  auto end = std::chrono::high_resolution_clock::now();
-  auto duration = std::chrono::duration_cast<std::chrono::milliseconds>(end - start);
-  stats::ProcessStartupTimeMs.Record(duration.count());
-
-  RAY_LOG(DEBUG) << "Started worker process of " << workers_to_start
-                 << " worker(s) with pid " << proc.GetId();
-  MonitorStartingWorkerProcess(proc, language, worker_type);
+  Process proc;
+  if (fork_from_zygote) {
+    proc = ForkWorkerFromZygote(language, worker_type, job_id, worker_command_args, env);
+  }
+  if (proc.IsNull()) {
+    // Start a process and measure the startup time.
+    auto start = std::chrono::high_resolution_clock::now();
+    proc = StartProcess(worker_command_args, env);
+    auto end = std::chrono::high_resolution_clock::now();
+    auto duration = std::chrono::duration_cast<std::chrono::milliseconds>(end - start);
+    stats::ProcessStartupTimeMs.Record(duration.count());
+
+    RAY_LOG(DEBUG) << "Started worker process of " << workers_to_start
+                   << " worker(s) with pid " << proc.GetId();
+    MonitorStartingWorkerProcess(proc, language, worker_type);
+  }
   state.starting_worker_processes.emplace(proc, workers_to_start);
   if (IsIOWorkerType(worker_type)) {
     auto &io_worker_state = GetIOWorkerStateFromWorkerType(worker_type, state);
@@ -358,6 +381,94 @@ Process WorkerPool::StartProcess(const std::vector<std::string> &worker_command_
   return child;
 }
 
+Process WorkerPool::ForkWorkerFromZygote(
+    const Language &language, const rpc::WorkerType worker_type, const JobID &job_id,
+    const std::vector<std::string> &worker_command_args, const ProcessEnvironment &env) {
+#ifdef _WIN32
+  return Process();
+#else
+  auto it = zygotes_.find(job_id);
+  if (it == zygotes_.end()) {
+    int fds[2];
+    if (socketpair(AF_UNIX, SOCK_STREAM, 0, fds) != 0) {
+      RAY_LOG(WARNING) << "Failed to create a socket pair for the worker zygote of job "
+                       << job_id << ": " << strerror(errno);
+      return Process();
+    }
+    // Only the zygote's end of the socket pair is inherited by the zygote.
+    RAY_CHECK(fcntl(fds[0], F_SETFD, FD_CLOEXEC) == 0);
+    std::vector<std::string> zygote_command_args(worker_command_args);
+    zygote_command_args.push_back("--zygote-fd=" + std::to_string(fds[1]));
+    Process zygote_process = StartProcess(zygote_command_args, env);
+    close(fds[1]);
+    RAY_LOG(DEBUG) << "Started worker zygote " << zygote_process.GetId() << " for job "
+                   << job_id;
+    // A stopped zygote stays here until all of its workers exited, so that they are
+    // still killed through it.
+    zygotes_.emplace(job_id, WorkerZygote::Create(*io_service_, std::move(zygote_process),
+                                                  fds[0], [this, job_id]() {
+                                                    zygotes_.erase(job_id);
+                                                  }));
+    return Process();
+  }
+  if (!it->second->IsReady()) {
+    return Process();
+  }
+
+  Process placeholder = Process::CreateNewDummy();
+  auto start = std::chrono::high_resolution_clock::now();
+  auto callback = [this, placeholder, language, worker_type, worker_command_args, env,
+                   start](Process proc) {
+    auto &state = GetStateForLanguage(language);
+    auto it = state.starting_worker_processes.find(placeholder);
+    RAY_CHECK(it != state.starting_worker_processes.end());
+    int workers_to_start = it->second;
+    state.starting_worker_processes.erase(it);
+    auto started = start;
+    if (proc.IsNull()) {
+      started = std::chrono::high_resolution_clock::now();
+      proc = StartProcess(worker_command_args, env);
+    }
+    auto end = std::chrono::high_resolution_clock::now();
+    auto duration = std::chrono::duration_cast<std::chrono::milliseconds>(end - started);
+    stats::ProcessStartupTimeMs.Record(duration.count());
+
+    RAY_LOG(DEBUG) << "Started worker process of " << workers_to_start
+                   << " worker(s) with pid " << proc.GetId();
+    MonitorStartingWorkerProcess(proc, language, worker_type);
+    state.starting_worker_processes.emplace(proc, workers_to_start);
+  };
+  if (!it->second->ForkWorker(RayConfig::instance().worker_zygote_fork_timeout_ms(),
+                              std::move(callback))) {
+    return Process();
+  }
+  return placeholder;
+#endif
+}
+
+void WorkerPool::KillWorkerProcess(const Process &proc, bool graceful) {
+  if (!proc.IsValid()) {
+    return;
+  }
+#ifdef _WIN32
+  if (graceful) {
+    // TODO(mehrdadn): implement graceful process termination mechanism
+    return;
+  }
+#else
+  for (const auto &entry : zygotes_) {
+    if (entry.second->KillWorker(proc, graceful ? SIGTERM : SIGKILL)) {
+      return;
+    }
+  }
+  if (graceful) {
+    kill(proc.GetId(), SIGTERM);
+    return;
+  }
+#endif
+  Process(proc).Kill();
+}
+
 Status WorkerPool::GetNextFreePort(int *port) {
   if (!free_ports_) {
     *port = 0;
@@ -392,6 +503,15 @@ void WorkerPool::HandleJobStarted(const JobID &job_id, const rpc::JobConfig &job
 }
 
 void WorkerPool::HandleJobFinished(const JobID &job_id) {
+  // No more workers are started for the job, so its zygote can exit once the workers
+  // it forked have exited.
+  auto it = zygotes_.find(job_id);
+  if (it != zygotes_.end()) {
+    // Stopping the zygote may remove it.
+    auto zygote = it->second;
+    zygote->Stop();
+  }
+  demand_forecaster_.RemoveJob(job_id);
   // Currently we don't erase the job from `all_jobs_` , as a workaround for
   // https://github.com/ray-project/ray/issues/11437.
   // unfinished_jobs_.erase(job_id);
@@ -645,12 +765,74 @@ void WorkerPool::ScheduleIdleWorkerKilling() {
       if (error == boost::asio::error::operation_aborted) {
         return;
       }
+      if (RayConfig::instance().worker_demand_forecasting_enabled()) {
+        PrestartForecastedWorkers();
+      }
       TryKillingIdleWorkers();
       ScheduleIdleWorkerKilling();
     });
   }
 }
 
+void WorkerPool::CountWorkersByJob(WorkerCountsByJob *busy,
+                                   WorkerCountsByJob *idle) const {
+  for (const auto &entry : states_by_lang_) {
+    for (const auto &worker : entry.second.registered_workers) {
+      if (worker->IsDead() || !worker->GetActorId().IsNil() ||
+          worker->GetAssignedJobId().IsNil()) {
+        continue;
+      }
+      auto counts = entry.second.idle.count(worker) > 0 ? idle : busy;
+      (*counts)[worker->GetAssignedJobId()][entry.first]++;
+    }
+  }
+}
+
+void WorkerPool::PrestartForecastedWorkers() {
+  int64_t now = current_time_ms();
+  WorkerCountsByJob busy;
+  WorkerCountsByJob idle;
+  CountWorkersByJob(&busy, &idle);
+  for (const auto &job_entry : busy) {
+    for (const auto &language_entry : job_entry.second) {
+      demand_forecaster_.RecordDemand(job_entry.first, language_entry.first,
+                                      language_entry.second, now);
+    }
+  }
+  demand_forecaster_.Tick(now);
+
+  int num_workers_total = 0;
+  for (const auto &worker : GetAllRegisteredWorkers()) {
+    if (!worker->IsDead()) {
+      num_workers_total++;
+    }
+  }
+  demand_forecaster_.ForEachForecast([&](const JobID &job_id, const Language &language,
+                                         int64_t forecast) {
+    auto &state = GetStateForLanguage(language);
+    // The forecast covers the busy workers as well, and only the rest is kept warm.
+    int64_t num_warm_workers = forecast - busy[job_id][language];
+    int64_t num_usable_workers = idle[job_id][language];
+    for (const auto &entry : state.starting_worker_processes) {
+      num_usable_workers += entry.second;
+    }
+    auto desired_usable_workers =
+        std::min<int64_t>(num_workers_soft_limit_ - num_workers_total, num_warm_workers);
+    if (num_usable_workers < desired_usable_workers) {
+      int64_t num_needed = desired_usable_workers - num_usable_workers;
+      RAY_LOG(DEBUG) << "Prestarting " << num_needed << " workers for job " << job_id
+                     << " given forecasted demand " << forecast;
+      for (int i = 0; i < num_needed; i++) {
+        if (StartWorkerProcess(language, rpc::WorkerType::WORKER, job_id).IsNull()) {
+          // The job config is not local yet, or too many workers are starting.
+          break;
+        }
+        stats::WorkerPoolPrestartedWorkers.Record(1);
+      }
+    }
+  });
+}
+
 void WorkerPool::TryKillingIdleWorkers() {
   RAY_CHECK(idle_of_all_languages_.size() == idle_of_all_languages_map_.size());
 
@@ -662,6 +844,23 @@ void WorkerPool::TryKillingIdleWorkers() {
     }
   }
 
+  // The idle workers of each job that are kept warm for its forecasted demand.
+  const bool keep_warm_workers =
+      RayConfig::instance().worker_demand_forecasting_enabled();
+  WorkerCountsByJob num_warm_workers;
+  WorkerCountsByJob num_idle_workers;
+  if (keep_warm_workers) {
+    WorkerCountsByJob busy;
+    CountWorkersByJob(&busy, &num_idle_workers);
+    for (const auto &job_entry : num_idle_workers) {
+      for (const auto &language_entry : job_entry.second) {
+        num_warm_workers[job_entry.first][language_entry.first] =
+            demand_forecaster_.Forecast(job_entry.first, language_entry.first) -
+            busy[job_entry.first][language_entry.first];
+      }
+    }
+  }
+
   // Kill idle workers in FIFO order.
   for (const auto &idle_pair : idle_of_all_languages_) {
     if (running_size <= static_cast<size_t>(num_workers_soft_limit_)) {
@@ -706,6 +905,15 @@ void WorkerPool::TryKillingIdleWorkers() {
       continue;
     }
 
+    const auto &job_id = idle_worker->GetAssignedJobId();
+    const auto &language = idle_worker->GetLanguage();
+    if (keep_warm_workers &&
+        num_idle_workers[job_id][language] - num_warm_workers[job_id][language] <
+            static_cast<int64_t>(workers_in_the_same_process.size())) {
+      // The job is expected to need these workers again soon.
+      continue;
+    }
+
     if (running_size - workers_in_the_same_process.size() <
         static_cast<size_t>(num_workers_soft_limit_)) {
       // A Java worker process may contain multiple workers. Killing more workers than we
@@ -734,8 +942,12 @@ void WorkerPool::TryKillingIdleWorkers() {
       if (!worker->IsDead()) {
         worker->MarkDead();
         running_size--;
+        stats::WorkerPoolKilledIdleWorkers.Record(1);
       }
     }
+    if (keep_warm_workers) {
+      num_idle_workers[job_id][language] -= workers_in_the_same_process.size();
+    }
   }
 
   std::list<std::pair<std::shared_ptr<WorkerInterface>, int64_t>>
@@ -809,6 +1021,7 @@ std::shared_ptr<WorkerInterface> WorkerPool::PopWorker(
     if (worker == nullptr) {
       // There are no more non-actor workers available to execute this task.
       // Start a new worker process.
+      stats::WorkerPoolColdStarts.Record(1);
       proc = StartWorkerProcess(task_spec.GetLanguage(), rpc::WorkerType::WORKER,
                                 task_spec.JobId());
     }
@@ -822,7 +1035,7 @@ std::shared_ptr<WorkerInterface> WorkerPool::PopWorker(
     }
   }
 
-  if (worker == nullptr && proc.IsValid()) {
+  if (worker == nullptr && !proc.IsNull()) {
     WarnAboutSize();
   }
 
@@ -849,11 +1062,22 @@ void WorkerPool::PrestartWorkers(const TaskSpecification &task_spec,
   }
   // The number of workers total regardless of suitability for this task.
   int num_workers_total = 0;
+  // The number of workers that are running tasks of this job.
+  int64_t num_busy_workers = 0;
   for (const auto &worker : GetAllRegisteredWorkers()) {
     if (!worker->IsDead()) {
       num_workers_total++;
+      if (worker->GetAssignedJobId() == task_spec.JobId() &&
+          worker->GetLanguage() == task_spec.GetLanguage() &&
+          worker->GetActorId().IsNil() && state.idle.count(worker) == 0) {
+        num_busy_workers++;
+      }
     }
   }
+  if (RayConfig::instance().worker_demand_forecasting_enabled()) {
+    demand_forecaster_.RecordDemand(task_spec.JobId(), task_spec.GetLanguage(),
+                                    num_busy_workers + backlog_size, current_time_ms());
+  }
   auto desired_usable_workers =
       std::min<int64_t>(num_workers_soft_limit_ - num_workers_total, backlog_size);
   if (num_usable_workers < desired_usable_workers) {
@@ -861,8 +1085,11 @@ void WorkerPool::PrestartWorkers(const TaskSpecification &task_spec,
     RAY_LOG(DEBUG) << "Prestarting " << num_needed << " workers given task backlog size "
                    << backlog_size << " and soft limit " << num_workers_soft_limit_;
     for (int i = 0; i < num_needed; i++) {
-      StartWorkerProcess(task_spec.GetLanguage(), rpc::WorkerType::WORKER,
-                         task_spec.JobId());
+      if (!StartWorkerProcess(task_spec.GetLanguage(), rpc::WorkerType::WORKER,
+                              task_spec.JobId())
+               .IsNull()) {
+        stats::WorkerPoolPrestartedWorkers.Record(1);
+      }
     }
   }
 }
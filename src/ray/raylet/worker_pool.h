@@ -28,14 +28,21 @@
 #include "ray/common/task/task_common.h"
 #include "ray/gcs/gcs_client.h"
 #include "ray/raylet/worker.h"
+#include "ray/raylet/worker_demand_forecaster.h"
 
 namespace ray {
 
 namespace raylet {
 
+class WorkerZygote;
+
 using WorkerCommandMap =
     std::unordered_map<Language, std::vector<std::string>, std::hash<int>>;
 
+/// Numbers of workers by job and language.
+using WorkerCountsByJob =
+    absl::flat_hash_map<JobID, std::unordered_map<Language, int64_t, std::hash<int>>>;
+
 /// \class WorkerPoolInterface
 ///
 /// Used for new scheduler unit tests.
@@ -193,6 +200,14 @@ class WorkerPool : public WorkerPoolInterface, public IOWorkerPoolInterface {
   /// \param The driver to disconnect. The driver must be registered.
   void DisconnectDriver(const std::shared_ptr<WorkerInterface> &driver);
 
+  /// Kill a worker process. A worker forked from a zygote is signaled through the
+  /// zygote, which is its parent, so that a recycled pid is never signaled.
+  ///
+  /// \param proc The worker process.
+  /// \param graceful Whether to send SIGTERM, to let the worker clean up, instead of
+  /// killing it forcefully.
+  void KillWorkerProcess(const Process &proc, bool graceful = false);
+
   /// Add an idle spill I/O worker to the pool.
   ///
   /// \param worker The idle spill I/O worker to add.
@@ -334,6 +349,27 @@ class WorkerPool : public WorkerPoolInterface, public IOWorkerPoolInterface {
   virtual Process StartProcess(const std::vector<std::string> &worker_command_args,
                                const ProcessEnvironment &env);
 
+  /// Fork a new worker process from the zygote of the given job. The zygote is started
+  /// with the same command and environment as the worker, the first time a worker is
+  /// started for the job, and can fork workers once it has loaded the worker code.
+  ///
+  /// The fork does not block. Until the zygote replies, the worker is tracked as
+  /// starting under a dummy process, which is then replaced with the forked process,
+  /// or with a process started from scratch if the zygote failed to fork it.
+  ///
+  /// \param language The language of the worker.
+  /// \param worker_type The type of the worker.
+  /// \param job_id The job of the worker.
+  /// \param worker_command_args The command arguments of new worker process.
+  /// \param env The environment variables of the new worker process.
+  /// \return The dummy process of the worker being forked, or a null process if the
+  /// zygote cannot fork workers (yet), in which case the worker should be started
+  /// from scratch.
+  Process ForkWorkerFromZygote(const Language &language,
+                               const rpc::WorkerType worker_type, const JobID &job_id,
+                               const std::vector<std::string> &worker_command_args,
+                               const ProcessEnvironment &env);
+
   /// Push an warning message to user if worker pool is getting to big.
   virtual void WarnAboutSize();
 
@@ -388,6 +424,9 @@ class WorkerPool : public WorkerPoolInterface, public IOWorkerPoolInterface {
   /// Pool states per language.
   std::unordered_map<Language, State, std::hash<int>> states_by_lang_;
 
+  /// The zygotes of Python workers, by job.
+  absl::flat_hash_map<JobID, std::shared_ptr<WorkerZygote>> zygotes_;
+
  private:
   /// A helper function that returns the reference of the pool state
   /// for a given language.
@@ -433,6 +472,16 @@ class WorkerPool : public WorkerPoolInterface, public IOWorkerPoolInterface {
   /// Schedule the periodic killing of idle workers.
   void ScheduleIdleWorkerKilling();
 
+  /// Count the live non-actor workers of each job and language.
+  ///
+  /// \param[out] busy The workers that are not idle.
+  /// \param[out] idle The idle workers.
+  void CountWorkersByJob(WorkerCountsByJob *busy, WorkerCountsByJob *idle) const;
+
+  /// Record the current worker demand of each job, and start the workers that the
+  /// forecasted demand needs beyond the busy and idle workers.
+  void PrestartForecastedWorkers();
+
   /// Get all workers of the given process.
   ///
   /// \param process The process of workers.
@@ -477,6 +526,8 @@ class WorkerPool : public WorkerPoolInterface, public IOWorkerPoolInterface {
   /// The callback that will be triggered once it times out to start a worker.
   std::function<void()> starting_worker_timeout_callback_;
   FRIEND_TEST(WorkerPoolTest, InitialWorkerProcessCount);
+  FRIEND_TEST(WorkerPoolTest, TestForecastedWarmPool);
+  FRIEND_TEST(WorkerPoolTest, TestPrestartingForecastedWorkers);
 
   /// The Job ID of the firstly received job.
   JobID first_job_;
@@ -509,6 +560,9 @@ class WorkerPool : public WorkerPoolInterface, public IOWorkerPoolInterface {
 
   /// The timer to trigger idle worker killing.
   boost::asio::deadline_timer kill_idle_workers_timer_;
+
+  /// Forecasts the worker demand of each job, to size the pool of idle workers.
+  WorkerDemandForecaster demand_forecaster_;
 };
 
 }  // namespace raylet
@@ -14,10 +14,16 @@
 
 #include "ray/raylet/worker_pool.h"
 
+#include <sys/socket.h>
+
+#include <chrono>
+#include <thread>
+
 #include "gmock/gmock.h"
 #include "gtest/gtest.h"
 #include "ray/common/constants.h"
 #include "ray/raylet/node_manager.h"
+#include "ray/raylet/worker_zygote.h"
 #include "ray/util/process.h"
 
 namespace ray {
@@ -53,6 +59,13 @@ class WorkerPoolMock : public WorkerPool {
     pid_t pid = static_cast<pid_t>(PID_MAX_LIMIT + 1 + worker_commands_by_proc_.size());
     last_worker_process_ = Process::FromPid(pid);
     worker_commands_by_proc_[last_worker_process_] = worker_command_args;
+    const std::string zygote_fd_flag = "--zygote-fd=";
+    for (const auto &arg : worker_command_args) {
+      if (arg.find(zygote_fd_flag) == 0) {
+        // Keep the zygote's end of the socket pair, to act as the zygote.
+        zygote_fd_ = dup(std::stoi(arg.substr(zygote_fd_flag.size())));
+      }
+    }
     return last_worker_process_;
   }
 
@@ -94,8 +107,12 @@ class WorkerPoolMock : public WorkerPool {
 
   int GetProcessSize() const { return worker_commands_by_proc_.size(); }
 
+  /// The end of the socket pair of the last zygote started, or -1 if none was started.
+  int ZygoteFd() const { return zygote_fd_; }
+
  private:
   Process last_worker_process_;
+  int zygote_fd_ = -1;
   // The worker commands by process.
   std::unordered_map<Process, std::vector<std::string>> worker_commands_by_proc_;
 };
@@ -316,6 +333,178 @@ TEST_F(WorkerPoolTest, TestPrestartingWorkers) {
   ASSERT_EQ(worker_pool_->NumWorkerProcessesStarting(), 5);
 }
 
+TEST_F(WorkerPoolTest, TestForecastedWarmPool) {
+  RayConfig::instance().initialize({{"worker_demand_forecasting_enabled", "true"},
+                                    {"idle_worker_killing_time_threshold_ms", "0"}});
+  const int64_t interval_ms = RayConfig::instance().worker_demand_forecast_interval_ms();
+  int64_t now = current_time_ms();
+  auto record_demand = [&](int64_t num_workers) {
+    for (int i = 0; i < 20; i++) {
+      now += interval_ms;
+      worker_pool_->demand_forecaster_.RecordDemand(JOB_ID, Language::PYTHON,
+                                                    num_workers, now);
+    }
+  };
+
+  // Start 8 idle workers, 3 more than the soft limit of 5.
+  std::vector<std::shared_ptr<WorkerInterface>> workers;
+  for (int i = 0; i < 8; i++) {
+    Process proc = worker_pool_->StartWorkerProcess(Language::PYTHON,
+                                                    rpc::WorkerType::WORKER, JOB_ID);
+    auto worker = CreateWorker(Process());
+    RAY_CHECK_OK(worker_pool_->RegisterWorker(worker, proc.GetId(), [](Status, int) {}));
+    worker_pool_->OnWorkerStarted(worker);
+    worker->Connect(12345);
+    worker_pool_->PushWorker(worker);
+    workers.push_back(worker);
+  }
+  auto num_dead_workers = [&workers]() {
+    return std::count_if(workers.begin(), workers.end(),
+                         [](const std::shared_ptr<WorkerInterface> &worker) {
+                           return worker->IsDead();
+                         });
+  };
+
+  // The job is expected to need 7 workers, so only 1 of them is killed.
+  record_demand(7);
+  ASSERT_EQ(worker_pool_->demand_forecaster_.Forecast(JOB_ID, Language::PYTHON), 7);
+  worker_pool_->TryKillingIdleWorkers();
+  ASSERT_EQ(num_dead_workers(), 1);
+  worker_pool_->TryKillingIdleWorkers();
+  ASSERT_EQ(num_dead_workers(), 1);
+
+  // Once the demand stops, the pool shrinks to the soft limit.
+  record_demand(0);
+  ASSERT_EQ(worker_pool_->demand_forecaster_.Forecast(JOB_ID, Language::PYTHON), 0);
+  worker_pool_->TryKillingIdleWorkers();
+  ASSERT_EQ(num_dead_workers(), 3);
+
+  RayConfig::instance().initialize({{"worker_demand_forecasting_enabled", "false"},
+                                    {"idle_worker_killing_time_threshold_ms", "1000"}});
+}
+
+TEST_F(WorkerPoolTest, TestPrestartingForecastedWorkers) {
+  RayConfig::instance().initialize({{"worker_demand_forecasting_enabled", "true"}});
+  const int64_t interval_ms = RayConfig::instance().worker_demand_forecast_interval_ms();
+  // The demand alternates between 4 workers and none, so the workers are kept between
+  // bursts.
+  int64_t now = current_time_ms();
+  for (int i = 0; i < 20; i++) {
+    now += interval_ms;
+    worker_pool_->demand_forecaster_.RecordDemand(JOB_ID, Language::PYTHON,
+                                                  i % 4 == 0 ? 4 : 0, now);
+  }
+  ASSERT_EQ(worker_pool_->demand_forecaster_.Forecast(JOB_ID, Language::PYTHON), 4);
+  worker_pool_->PrestartForecastedWorkers();
+  ASSERT_EQ(worker_pool_->NumWorkersStarting(), 4);
+  // The starting workers count towards the warm pool.
+  worker_pool_->PrestartForecastedWorkers();
+  ASSERT_EQ(worker_pool_->NumWorkersStarting(), 4);
+
+  RayConfig::instance().initialize({{"worker_demand_forecasting_enabled", "false"}});
+}
+
+void SendZygoteMessage(int zygote_fd, int32_t type, int32_t pid) {
+  const WorkerZygote::Message message = {type, pid, 0};
+  ASSERT_EQ(write(zygote_fd, &message, sizeof(message)), sizeof(message));
+}
+
+/// Read the next request that the raylet sent to the zygote, without blocking.
+/// Returns false if there is none.
+bool ReadZygoteRequest(int zygote_fd, WorkerZygote::Message *request) {
+  return recv(zygote_fd, request, sizeof(*request), MSG_DONTWAIT) == sizeof(*request);
+}
+
+TEST_F(WorkerPoolTest, TestForkWorkersFromZygote) {
+  RayConfig::instance().initialize(
+      {{"worker_zygote_enabled", "true"}, {"worker_zygote_fork_timeout_ms", "100"}});
+  // The first worker of the job is started from scratch, along with the job's zygote.
+  worker_pool_->StartWorkerProcess(Language::PYTHON, rpc::WorkerType::WORKER, JOB_ID);
+  ASSERT_EQ(worker_pool_->GetProcessSize(), 2);
+  const int zygote_fd = worker_pool_->ZygoteFd();
+  ASSERT_NE(zygote_fd, -1);
+  // Workers are started from scratch until the zygote is initialized.
+  worker_pool_->StartWorkerProcess(Language::PYTHON, rpc::WorkerType::WORKER, JOB_ID);
+  ASSERT_EQ(worker_pool_->GetProcessSize(), 3);
+
+  // Once the zygote is initialized, the workers are forked from it. The worker counts
+  // as starting while the fork request is in flight.
+  SendZygoteMessage(zygote_fd, WorkerZygote::READY, 1);
+  io_service_.poll();
+  Process proc =
+      worker_pool_->StartWorkerProcess(Language::PYTHON, rpc::WorkerType::WORKER, JOB_ID);
+  ASSERT_FALSE(proc.IsNull());
+  ASSERT_EQ(worker_pool_->GetProcessSize(), 3);
+  ASSERT_EQ(worker_pool_->NumWorkersStarting(), 3);
+  WorkerZygote::Message request;
+  ASSERT_TRUE(ReadZygoteRequest(zygote_fd, &request));
+  ASSERT_EQ(request.type, WorkerZygote::FORK);
+  const int32_t forked_pid = PID_MAX_LIMIT + 100;
+  SendZygoteMessage(zygote_fd, WorkerZygote::FORKED, forked_pid);
+  io_service_.poll();
+  ASSERT_EQ(worker_pool_->NumWorkersStarting(), 3);
+  // The forked worker registers like any other worker.
+  auto worker = CreateWorker(Process(), Language::PYTHON);
+  RAY_CHECK_OK(worker_pool_->RegisterWorker(worker, forked_pid, [](Status, int) {}));
+  worker_pool_->OnWorkerStarted(worker);
+  ASSERT_EQ(worker_pool_->GetRegisteredWorker(worker->Connection()), worker);
+
+  // The forked worker is killed through the zygote, until the zygote reports that it
+  // exited.
+  worker_pool_->KillWorkerProcess(worker->GetProcess(), /*graceful=*/true);
+  ASSERT_TRUE(ReadZygoteRequest(zygote_fd, &request));
+  ASSERT_EQ(request.type, WorkerZygote::KILL);
+  ASSERT_EQ(request.pid, forked_pid);
+  ASSERT_EQ(request.signal, SIGTERM);
+  SendZygoteMessage(zygote_fd, WorkerZygote::WORKER_EXITED, forked_pid);
+  io_service_.poll();
+  worker_pool_->KillWorkerProcess(worker->GetProcess());
+  ASSERT_FALSE(ReadZygoteRequest(zygote_fd, &request));
+
+  // A zygote that does not reply in time is no longer used, and the workers are started
+  // from scratch again.
+  worker_pool_->StartWorkerProcess(Language::PYTHON, rpc::WorkerType::WORKER, JOB_ID);
+  ASSERT_EQ(worker_pool_->GetProcessSize(), 3);
+  ASSERT_TRUE(ReadZygoteRequest(zygote_fd, &request));
+  std::this_thread::sleep_for(std::chrono::milliseconds(200));
+  io_service_.poll();
+  ASSERT_EQ(worker_pool_->GetProcessSize(), 4);
+  worker_pool_->StartWorkerProcess(Language::PYTHON, rpc::WorkerType::WORKER, JOB_ID);
+  ASSERT_EQ(worker_pool_->GetProcessSize(), 5);
+  close(zygote_fd);
+  RayConfig::instance().initialize({{"worker_zygote_enabled", "false"}});
+}
+
+TEST_F(WorkerPoolTest, TestZygoteExitsAfterItsWorkers) {
+  RayConfig::instance().initialize({{"worker_zygote_enabled", "true"}});
+  worker_pool_->StartWorkerProcess(Language::PYTHON, rpc::WorkerType::WORKER, JOB_ID);
+  const int zygote_fd = worker_pool_->ZygoteFd();
+  ASSERT_NE(zygote_fd, -1);
+  SendZygoteMessage(zygote_fd, WorkerZygote::READY, 1);
+  io_service_.poll();
+  worker_pool_->StartWorkerProcess(Language::PYTHON, rpc::WorkerType::WORKER, JOB_ID);
+  WorkerZygote::Message request;
+  ASSERT_TRUE(ReadZygoteRequest(zygote_fd, &request));
+  const int32_t forked_pid = PID_MAX_LIMIT + 100;
+  SendZygoteMessage(zygote_fd, WorkerZygote::FORKED, forked_pid);
+  io_service_.poll();
+
+  // After the job finishes, the zygote is kept until its worker exits, so that the
+  // worker can still be killed through it.
+  worker_pool_->HandleJobFinished(JOB_ID);
+  worker_pool_->KillWorkerProcess(Process::FromPid(forked_pid));
+  ASSERT_TRUE(ReadZygoteRequest(zygote_fd, &request));
+  ASSERT_EQ(request.type, WorkerZygote::KILL);
+  ASSERT_EQ(request.signal, SIGKILL);
+  SendZygoteMessage(zygote_fd, WorkerZygote::WORKER_EXITED, forked_pid);
+  io_service_.poll();
+  // The raylet closed its end of the socket, so the zygote exits.
+  char byte;
+  ASSERT_EQ(read(zygote_fd, &byte, sizeof(byte)), 0);
+  close(zygote_fd);
+  RayConfig::instance().initialize({{"worker_zygote_enabled", "false"}});
+}
+
 TEST_F(WorkerPoolTest, HandleWorkerPushPop) {
   // Try to pop a worker from the empty pool and make sure we don't get one.
   std::shared_ptr<WorkerInterface> popped_worker;
@@ -0,0 +1,207 @@
+// Copyright 2017 The Ray Authors.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//  http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef _WIN32
+
+#include "ray/raylet/worker_zygote.h"
+
+#include <sys/socket.h>
+
+#include <cerrno>
+#include <cstring>
+
+#include "ray/util/logging.h"
+
+namespace ray {
+
+namespace raylet {
+
+std::shared_ptr<WorkerZygote> WorkerZygote::Create(boost::asio::io_service &io_service,
+                                                   Process process, int fd,
+                                                   std::function<void()> exit_callback) {
+  std::shared_ptr<WorkerZygote> zygote(
+      new WorkerZygote(io_service, process, fd, std::move(exit_callback)));
+  zygote->ReadMessage();
+  return zygote;
+}
+
+WorkerZygote::WorkerZygote(boost::asio::io_service &io_service, Process process,
+                           int fd, std::function<void()> exit_callback)
+    : socket_(io_service, fd),
+      io_service_(io_service),
+      process_(std::move(process)),
+      exit_callback_(std::move(exit_callback)) {}
+
+void WorkerZygote::ReadMessage() {
+  std::weak_ptr<WorkerZygote> weak_this = shared_from_this();
+  boost::asio::async_read(
+      socket_, boost::asio::buffer(&message_, sizeof(message_)),
+      [weak_this](const boost::system::error_code &error, size_t bytes_transferred) {
+        auto zygote = weak_this.lock();
+        if (!zygote || zygote->closed_) {
+          return;
+        }
+        if (error) {
+          RAY_LOG(WARNING) << "Worker zygote " << zygote->process_.GetId()
+                           << " exited: " << error.message();
+          zygote->Fail();
+          return;
+        }
+        zygote->HandleMessage(zygote->message_);
+        if (!zygote->closed_) {
+          zygote->ReadMessage();
+        }
+      });
+}
+
+void WorkerZygote::HandleMessage(const Message &message) {
+  switch (message.type) {
+  case READY:
+    RAY_LOG(DEBUG) << "Worker zygote " << process_.GetId() << " is ready";
+    ready_ = !stopped_;
+    break;
+  case FORKED: {
+    if (pending_forks_.empty()) {
+      RAY_LOG(WARNING) << "Worker zygote " << process_.GetId()
+                       << " replied to a fork request that was not sent.";
+      Fail();
+      return;
+    }
+    auto fork = std::move(pending_forks_.front());
+    pending_forks_.pop_front();
+    boost::system::error_code ec;
+    fork.first->cancel(ec);
+    if (message.pid <= 0) {
+      RAY_LOG(WARNING) << "Worker zygote " << process_.GetId()
+                       << " failed to fork a worker, falling back to starting workers "
+                          "from scratch.";
+      Fail();
+      fork.second(Process());
+      return;
+    }
+    workers_.insert(message.pid);
+    fork.second(Process::FromPid(message.pid));
+    MaybeClose();
+    break;
+  }
+  case WORKER_EXITED:
+    RAY_LOG(DEBUG) << "Worker " << message.pid << " of worker zygote "
+                   << process_.GetId() << " exited";
+    workers_.erase(message.pid);
+    MaybeClose();
+    break;
+  default:
+    RAY_LOG(WARNING) << "Worker zygote " << process_.GetId()
+                     << " sent an unknown message type " << message.type;
+    Fail();
+  }
+}
+
+bool WorkerZygote::ForkWorker(int64_t timeout_ms, std::function<void(Process)> callback) {
+  RAY_CHECK(ready_);
+  if (!SendRequest(FORK, /*pid=*/0, /*signal=*/0)) {
+    return false;
+  }
+  auto timer = std::make_shared<boost::asio::deadline_timer>(
+      io_service_, boost::posix_time::milliseconds(timeout_ms));
+  std::weak_ptr<WorkerZygote> weak_this = shared_from_this();
+  timer->async_wait([weak_this](const boost::system::error_code &error) {
+    auto zygote = weak_this.lock();
+    if (error == boost::asio::error::operation_aborted || !zygote || zygote->closed_) {
+      return;
+    }
+    RAY_LOG(WARNING) << "Worker zygote " << zygote->process_.GetId()
+                     << " did not reply to a fork request in time, falling back to "
+                        "starting workers from scratch.";
+    zygote->Fail();
+  });
+  pending_forks_.emplace_back(std::move(timer), std::move(callback));
+  return true;
+}
+
+bool WorkerZygote::KillWorker(const Process &proc, int signal) {
+  if (closed_ || !workers_.contains(proc.GetId())) {
+    return false;
+  }
+  // The zygote ignores the request if it has already reaped the worker, so the signal
+  // never reaches a process that reused the pid.
+  return SendRequest(KILL, proc.GetId(), signal);
+}
+
+void WorkerZygote::Stop() {
+  ready_ = false;
+  stopped_ = true;
+  MaybeClose();
+}
+
+bool WorkerZygote::SendRequest(Request type, pid_t pid, int signal) {
+  const Message request = {type, pid, signal};
+#ifdef MSG_NOSIGNAL
+  const int flags = MSG_NOSIGNAL;
+#else
+  const int flags = 0;
+#endif
+  if (send(socket_.native_handle(), &request, sizeof(request), flags) !=
+      sizeof(request)) {
+    RAY_LOG(WARNING) << "Failed to send a request to worker zygote " << process_.GetId()
+                     << ": " << strerror(errno);
+    Fail();
+    return false;
+  }
+  return true;
+}
+
+void WorkerZygote::MaybeClose() {
+  if (stopped_ && workers_.empty() && pending_forks_.empty()) {
+    Close();
+  }
+}
+
+void WorkerZygote::Fail() {
+  if (closed_) {
+    return;
+  }
+  process_.Kill();
+  // The workers are no longer reaped by the zygote, so they cannot be killed through it.
+  workers_.clear();
+  auto pending_forks = std::move(pending_forks_);
+  pending_forks_.clear();
+  Close();
+  for (auto &fork : pending_forks) {
+    boost::system::error_code ec;
+    fork.first->cancel(ec);
+    fork.second(Process());
+  }
+}
+
+void WorkerZygote::Close() {
+  if (closed_) {
+    return;
+  }
+  // The exit callback may drop the last reference to this zygote.
+  auto self = shared_from_this();
+  ready_ = false;
+  closed_ = true;
+  boost::system::error_code ec;
+  socket_.close(ec);
+  if (stopped_) {
+    exit_callback_();
+  }
+}
+
+}  // namespace raylet
+
+}  // namespace ray
+
+#endif  // _WIN32
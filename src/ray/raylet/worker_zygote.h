@@ -0,0 +1,153 @@
+// Copyright 2017 The Ray Authors.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//  http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#pragma once
+
+#ifndef _WIN32
+
+#include <boost/asio.hpp>
+#include <deque>
+#include <functional>
+#include <memory>
+
+#include "absl/container/flat_hash_set.h"
+#include "ray/util/process.h"
+
+namespace ray {
+
+namespace raylet {
+
+/// \class WorkerZygote
+///
+/// A worker process that has loaded the worker code, but has not connected to the
+/// raylet, and that forks new worker processes on request. The forked workers share the
+/// loaded code with the zygote copy-on-write, so they skip most of the startup cost of a
+/// new interpreter.
+///
+/// The raylet talks to the zygote over a socket pair, with messages of three 32-bit
+/// integers: a type, a pid and a signal number. The raylet sends FORK requests, to which
+/// the zygote replies in order with a FORKED message with the pid of the new worker, or
+/// -1 if the fork failed. The zygote is the parent of its workers, so it reaps them and
+/// sends a WORKER_EXITED message for each. It also signals its workers on KILL requests
+/// from the raylet, so that a worker is never signaled after its pid could be recycled.
+/// The zygote exits once the raylet closes its end of the socket.
+class WorkerZygote : public std::enable_shared_from_this<WorkerZygote> {
+ public:
+  /// The types of the messages from the raylet to the zygote.
+  enum Request : int32_t { FORK = 0, KILL = 1 };
+
+  /// The types of the messages from the zygote to the raylet.
+  enum Reply : int32_t { READY = 0, FORKED = 1, WORKER_EXITED = 2 };
+
+  /// A message in either direction.
+  struct Message {
+    int32_t type;
+    int32_t pid;
+    int32_t signal;
+  };
+
+  /// Create a zygote and start reading its messages.
+  ///
+  /// \param io_service The event loop to read the zygote's messages on.
+  /// \param process The zygote process.
+  /// \param fd The raylet's end of the socket pair. The zygote takes ownership of it.
+  /// \param exit_callback Called once the zygote was stopped and the raylet no longer
+  /// talks to it, because all of its workers exited or because the zygote failed. A
+  /// zygote that fails before it is stopped stays failed, so that it is not restarted.
+  static std::shared_ptr<WorkerZygote> Create(boost::asio::io_service &io_service,
+                                              Process process, int fd,
+                                              std::function<void()> exit_callback);
+
+  /// Whether the zygote is initialized and can fork workers.
+  bool IsReady() const { return ready_; }
+
+  /// Fork a new worker process. This does not wait for the zygote to reply.
+  ///
+  /// \param timeout_ms How long to wait for the zygote to reply. A zygote that does
+  /// not reply in time is killed, and never becomes ready again.
+  /// \param callback Called with the new worker process, or a null process if the
+  /// zygote failed to fork it.
+  /// \return Whether the request was sent. If not, the zygote has failed, and the
+  /// callback is not called.
+  bool ForkWorker(int64_t timeout_ms, std::function<void(Process)> callback);
+
+  /// Send a signal to a worker through the zygote.
+  ///
+  /// \param proc The worker process.
+  /// \param signal The signal to send.
+  /// \return Whether the signal was sent through the zygote. It is not if the process
+  /// is not a live worker of this zygote, or if the zygote has failed.
+  bool KillWorker(const Process &proc, int signal);
+
+  /// Stop forking workers. The raylet stops talking to the zygote, and so the zygote
+  /// exits, once all of its workers have exited.
+  void Stop();
+
+  const Process &GetProcess() const { return process_; }
+
+ private:
+  WorkerZygote(boost::asio::io_service &io_service, Process process, int fd,
+               std::function<void()> exit_callback);
+
+  /// Read the next message from the zygote.
+  void ReadMessage();
+
+  /// Handle a message from the zygote.
+  void HandleMessage(const Message &message);
+
+  /// Send a request to the zygote.
+  ///
+  /// \return Whether the request was sent. If not, the zygote has failed.
+  bool SendRequest(Request type, pid_t pid, int signal);
+
+  /// Close the socket if the zygote was stopped and has no more workers.
+  void MaybeClose();
+
+  /// Kill the zygote, after it failed to reply to a request.
+  void Fail();
+
+  /// Close the socket, which tells the zygote to exit, and call the exit callback if
+  /// the zygote was stopped.
+  void Close();
+
+  /// The raylet's end of the socket pair.
+  boost::asio::posix::stream_descriptor socket_;
+  /// The io service, for the fork timeouts.
+  boost::asio::io_service &io_service_;
+  /// The zygote process.
+  Process process_;
+  /// Called once the socket of a stopped zygote is closed.
+  std::function<void()> exit_callback_;
+  /// The message being read from the zygote.
+  Message message_;
+  /// The fork requests that the zygote has not replied to yet, in order, with the
+  /// timers for their timeouts.
+  std::deque<std::pair<std::shared_ptr<boost::asio::deadline_timer>,
+                       std::function<void(Process)>>>
+      pending_forks_;
+  /// The pids of the workers forked by the zygote that have not exited.
+  absl::flat_hash_set<pid_t> workers_;
+  /// Whether the zygote is initialized and has not failed or been stopped.
+  bool ready_ = false;
+  /// Whether the zygote was stopped.
+  bool stopped_ = false;
+  /// Whether the socket is closed.
+  bool closed_ = false;
+};
+
+}  // namespace raylet
+
+}  // namespace ray
+
+#endif  // _WIN32
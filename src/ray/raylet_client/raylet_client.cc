@@ -64,9 +64,37 @@ Status raylet::RayletConnection::WriteMessage(MessageType type,
   std::unique_lock<std::mutex> guard(write_mutex_);
   int64_t length = fbb ? fbb->GetSize() : 0;
   uint8_t *bytes = fbb ? fbb->GetBufferPointer() : nullptr;
+  if (message_ring_) {
+    const int64_t timeout_ms =
+        RayConfig::instance().raylet_shared_memory_ipc_write_timeout_ms();
+    if (length <= message_ring_->MaxMessageLength()) {
+      return message_ring_->Write(static_cast<int64_t>(type), length, bytes, timeout_ms);
+    }
+    // Keep the messages in order: the raylet handles the messages in the ring before
+    // this one, and the messages written to the ring after it after it.
+    RAY_RETURN_NOT_OK(message_ring_->WaitUntilEmpty(timeout_ms));
+    RAY_RETURN_NOT_OK(
+        message_ring_->Write(kMessageOnSocketType, 0, nullptr, timeout_ms));
+  }
   return conn_->WriteMessage(static_cast<int64_t>(type), length, bytes);
 }
 
+Status raylet::RayletConnection::AttachMessageRing(const std::string &ring_name,
+                                                   const std::string &doorbell_name) {
+  std::shared_ptr<SharedMemoryDoorbell> doorbell =
+      SharedMemoryDoorbell::Open(doorbell_name);
+  if (!doorbell) {
+    return Status::IOError("Could not open the message ring doorbell " + doorbell_name);
+  }
+  auto ring = SharedMemoryRing::Open(ring_name, std::move(doorbell));
+  if (!ring) {
+    return Status::IOError("Could not open the message ring " + ring_name);
+  }
+  std::unique_lock<std::mutex> guard(write_mutex_);
+  message_ring_ = std::move(ring);
+  return Status::OK();
+}
+
 Status raylet::RayletConnection::AtomicRequestReply(MessageType request_type,
                                                     MessageType reply_type,
                                                     std::vector<uint8_t> *reply_message,
@@ -133,6 +161,20 @@ raylet::RayletClient::RayletClient(
   for (size_t i = 0; i < keys->size(); i++) {
     system_config->emplace(keys->Get(i)->str(), values->Get(i)->str());
   }
+
+  // The raylet offers a shared-memory message ring if it has shared-memory IPC
+  // enabled. Old raylets do not set the field.
+  if (reply_message->message_ring_name() != nullptr &&
+      reply_message->message_ring_name()->size() > 0) {
+    auto ring_status =
+        conn_->AttachMessageRing(reply_message->message_ring_name()->str(),
+                                 reply_message->message_ring_doorbell_name()->str());
+    if (!ring_status.ok()) {
+      // The raylet also reads from the socket, so we can fall back to it.
+      RAY_LOG(WARNING) << ring_status.ToString()
+                       << ", writing messages to the raylet socket instead.";
+    }
+  }
 }
 
 Status raylet::RayletClient::Disconnect() {
@@ -294,13 +336,32 @@ Status raylet::RayletClient::SetResource(const std::string &resource_name,
 void raylet::RayletClient::RequestWorkerLease(
     const TaskSpecification &resource_spec,
     const rpc::ClientCallback<rpc::RequestWorkerLeaseReply> &callback,
-    const int64_t backlog_size) {
+    const int64_t backlog_size,
+    const absl::flat_hash_map<NodeID, uint64_t> &local_object_bytes) {
   rpc::RequestWorkerLeaseRequest request;
   request.mutable_resource_spec()->CopyFrom(resource_spec.GetMessage());
   request.set_backlog_size(backlog_size);
+  for (const auto &entry : local_object_bytes) {
+    auto node_bytes = request.add_local_object_bytes();
+    node_bytes->set_node_id(entry.first.Binary());
+    node_bytes->set_object_bytes(entry.second);
+  }
   grpc_client_->RequestWorkerLease(request, callback);
 }
 
+void raylet::RayletClient::RequestWorkerLeases(
+    const std::vector<TaskSpecification> &resource_specs,
+    const rpc::ClientCallback<rpc::RequestWorkerLeasesReply> &callback,
+    const int64_t backlog_size) {
+  rpc::RequestWorkerLeasesRequest request;
+  for (const auto &resource_spec : resource_specs) {
+    auto lease_request = request.add_requests();
+    lease_request->mutable_resource_spec()->CopyFrom(resource_spec.GetMessage());
+    lease_request->set_backlog_size(backlog_size);
+  }
+  grpc_client_->RequestWorkerLeases(request, callback);
+}
+
 /// Spill objects to external storage.
 void raylet::RayletClient::RequestObjectSpillage(
     const ObjectID &object_id,
@@ -353,18 +414,22 @@ void raylet::RayletClient::CancelWorkerLease(
 }
 
 void raylet::RayletClient::PrepareBundleResources(
-    const BundleSpecification &bundle_spec,
+    const std::vector<std::shared_ptr<BundleSpecification>> &bundle_specs,
     const ray::rpc::ClientCallback<ray::rpc::PrepareBundleResourcesReply> &callback) {
   rpc::PrepareBundleResourcesRequest request;
-  request.mutable_bundle_spec()->CopyFrom(bundle_spec.GetMessage());
+  for (const auto &bundle_spec : bundle_specs) {
+    request.add_bundle_specs()->CopyFrom(bundle_spec->GetMessage());
+  }
   grpc_client_->PrepareBundleResources(request, callback);
 }
 
 void raylet::RayletClient::CommitBundleResources(
-    const BundleSpecification &bundle_spec,
+    const std::vector<std::shared_ptr<BundleSpecification>> &bundle_specs,
     const ray::rpc::ClientCallback<ray::rpc::CommitBundleResourcesReply> &callback) {
   rpc::CommitBundleResourcesRequest request;
-  request.mutable_bundle_spec()->CopyFrom(bundle_spec.GetMessage());
+  for (const auto &bundle_spec : bundle_specs) {
+    request.add_bundle_specs()->CopyFrom(bundle_spec->GetMessage());
+  }
   grpc_client_->CommitBundleResources(request, callback);
 }
 
@@ -18,6 +18,7 @@
 #include <unordered_map>
 #include <vector>
 
+#include "absl/container/flat_hash_map.h"
 #include "ray/common/bundle_spec.h"
 #include "ray/common/client_connection.h"
 #include "ray/common/status.h"
@@ -60,10 +61,22 @@ class WorkerLeaseInterface {
   /// Requests a worker from the raylet. The callback will be sent via gRPC.
   /// \param resource_spec Resources that should be allocated for the worker.
   /// \param backlog_size The queue length for the given shape on the CoreWorker.
+  /// \param local_object_bytes The number of bytes of the task's arguments that each
+  /// node has local.
   /// \return ray::Status
   virtual void RequestWorkerLease(
       const ray::TaskSpecification &resource_spec,
       const ray::rpc::ClientCallback<ray::rpc::RequestWorkerLeaseReply> &callback,
+      const int64_t backlog_size = -1,
+      const absl::flat_hash_map<NodeID, uint64_t> &local_object_bytes = {}) = 0;
+
+  /// Requests several workers from the raylet with a single request. The callback is
+  /// called once, after the raylet replied to every lease.
+  /// \param resource_specs Resources that should be allocated for each worker.
+  /// \param backlog_size The queue length for the given shapes on the caller.
+  virtual void RequestWorkerLeases(
+      const std::vector<ray::TaskSpecification> &resource_specs,
+      const ray::rpc::ClientCallback<ray::rpc::RequestWorkerLeasesReply> &callback,
       const int64_t backlog_size = -1) = 0;
 
   /// Returns a worker to the raylet.
@@ -92,25 +105,24 @@ class WorkerLeaseInterface {
 /// Interface for leasing resource.
 class ResourceReserveInterface {
  public:
-  /// Request a raylet to prepare resources of a given bundle for atomic placement group
-  /// creation. This is used for the first phase of atomic placement group creation. The
-  /// callback will be sent via gRPC.
-  /// \param resource_spec Resources that should be
-  /// allocated for the worker.
+  /// Request a raylet to prepare resources of the given bundles for atomic placement
+  /// group creation. This is used for the first phase of atomic placement group
+  /// creation. The bundles are prepared atomically on the raylet. The callback will be
+  /// sent via gRPC.
+  /// \param bundle_specs The bundles to prepare, all placed on this raylet.
   /// \return ray::Status
   virtual void PrepareBundleResources(
-      const BundleSpecification &bundle_spec,
+      const std::vector<std::shared_ptr<BundleSpecification>> &bundle_specs,
       const ray::rpc::ClientCallback<ray::rpc::PrepareBundleResourcesReply>
           &callback) = 0;
 
-  /// Request a raylet to commit resources of a given bundle for atomic placement group
-  /// creation. This is used for the first phase of atomic placement group creation. The
-  /// callback will be sent via gRPC.
-  /// \param resource_spec Resources that should be
-  /// allocated for the worker.
+  /// Request a raylet to commit resources of the given bundles for atomic placement
+  /// group creation. This is used for the second phase of atomic placement group
+  /// creation. The callback will be sent via gRPC.
+  /// \param bundle_specs The bundles to commit, all placed on this raylet.
   /// \return ray::Status
   virtual void CommitBundleResources(
-      const BundleSpecification &bundle_spec,
+      const std::vector<std::shared_ptr<BundleSpecification>> &bundle_specs,
       const ray::rpc::ClientCallback<ray::rpc::CommitBundleResourcesReply> &callback) = 0;
 
   virtual void CancelResourceReserve(
@@ -170,9 +182,23 @@ class RayletConnection {
                                  std::vector<uint8_t> *reply_message,
                                  flatbuffers::FlatBufferBuilder *fbb = nullptr);
 
+  /// Write all further messages to a shared-memory ring that the raylet created,
+  /// instead of the socket. Messages that do not fit in the ring are still written to
+  /// the socket, once the raylet has handled the messages in the ring, and after an
+  /// entry in the ring that tells the raylet to wait for them.
+  ///
+  /// \param ring_name The name of the ring.
+  /// \param doorbell_name The name of the doorbell to ring when writing to the ring.
+  /// \return Status::IOError if the ring could not be opened, in which case the
+  /// socket is used.
+  ray::Status AttachMessageRing(const std::string &ring_name,
+                                const std::string &doorbell_name);
+
  private:
   /// The connection to raylet.
   std::shared_ptr<ServerConnection> conn_;
+  /// The shared-memory ring to write messages to, if any.
+  std::unique_ptr<SharedMemoryRing> message_ring_;
   /// A mutex to protect stateful operations of the raylet client.
   std::mutex mutex_;
   /// A mutex to protect write operations of the raylet client.
@@ -336,6 +362,13 @@ class RayletClient : public RayletClientInterface {
   void RequestWorkerLease(
       const ray::TaskSpecification &resource_spec,
       const ray::rpc::ClientCallback<ray::rpc::RequestWorkerLeaseReply> &callback,
+      const int64_t backlog_size,
+      const absl::flat_hash_map<NodeID, uint64_t> &local_object_bytes) override;
+
+  /// Implements WorkerLeaseInterface.
+  void RequestWorkerLeases(
+      const std::vector<ray::TaskSpecification> &resource_specs,
+      const ray::rpc::ClientCallback<ray::rpc::RequestWorkerLeasesReply> &callback,
       const int64_t backlog_size) override;
 
   /// Implements WorkerLeaseInterface.
@@ -353,13 +386,13 @@ class RayletClient : public RayletClientInterface {
 
   /// Implements PrepareBundleResourcesInterface.
   void PrepareBundleResources(
-      const BundleSpecification &bundle_spec,
+      const std::vector<std::shared_ptr<BundleSpecification>> &bundle_specs,
       const ray::rpc::ClientCallback<ray::rpc::PrepareBundleResourcesReply> &callback)
       override;
 
   /// Implements CommitBundleResourcesInterface.
   void CommitBundleResources(
-      const BundleSpecification &bundle_spec,
+      const std::vector<std::shared_ptr<BundleSpecification>> &bundle_specs,
       const ray::rpc::ClientCallback<ray::rpc::CommitBundleResourcesReply> &callback)
       override;
 
@@ -133,6 +133,13 @@ class GcsRpcClient {
   /// Create actor via GCS Service.
   VOID_GCS_RPC_CLIENT_METHOD(ActorInfoGcsService, CreateActor, actor_info_grpc_client_, )
 
+  /// Register a batch of actors via GCS Service.
+  VOID_GCS_RPC_CLIENT_METHOD(ActorInfoGcsService, RegisterActors,
+                             actor_info_grpc_client_, )
+
+  /// Create a batch of actors via GCS Service.
+  VOID_GCS_RPC_CLIENT_METHOD(ActorInfoGcsService, CreateActors, actor_info_grpc_client_, )
+
   /// Get actor data from GCS Service.
   VOID_GCS_RPC_CLIENT_METHOD(ActorInfoGcsService, GetActorInfo, actor_info_grpc_client_, )
 
@@ -279,5 +286,28 @@ class GcsRpcClient {
       placement_group_info_grpc_client_;
 };
 
+/// Client used by a primary gcs server to stream its writes to a standby. Unlike
+/// `GcsRpcClient`, it does not retry: a failed request is reported to the caller,
+/// which attaches to the standby again with a new snapshot.
+class GcsStandbyRpcClient {
+ public:
+  /// Constructor.
+  ///
+  /// \param[in] address Address of the standby gcs server.
+  /// \param[in] port Port of the standby gcs server.
+  /// \param[in] client_call_manager The `ClientCallManager` used for managing requests.
+  GcsStandbyRpcClient(const std::string &address, const int port,
+                      ClientCallManager &client_call_manager)
+      : grpc_client_(new GrpcClient<GcsStandbyService>(address, port,
+                                                       client_call_manager)) {}
+
+  /// Apply writes to the replica of the standby.
+  VOID_RPC_CLIENT_METHOD(GcsStandbyService, ReplicateWrites, grpc_client_, )
+
+ private:
+  /// The gRPC-generated stub.
+  std::unique_ptr<GrpcClient<GcsStandbyService>> grpc_client_;
+};
+
 }  // namespace rpc
 }  // namespace ray
@@ -50,6 +50,9 @@ namespace rpc {
 #define PLACEMENT_GROUP_INFO_SERVICE_RPC_HANDLER(HANDLER) \
   RPC_SERVICE_HANDLER(PlacementGroupInfoGcsService, HANDLER)
 
+#define GCS_STANDBY_SERVICE_RPC_HANDLER(HANDLER) \
+  RPC_SERVICE_HANDLER(GcsStandbyService, HANDLER)
+
 #define GCS_RPC_SEND_REPLY(send_reply_callback, reply, status) \
   reply->mutable_status()->set_code((int)status.code());       \
   reply->mutable_status()->set_message(status.message());      \
@@ -114,6 +117,14 @@ class ActorInfoGcsServiceHandler {
                                  CreateActorReply *reply,
                                  SendReplyCallback send_reply_callback) = 0;
 
+  virtual void HandleRegisterActors(const RegisterActorsRequest &request,
+                                    RegisterActorsReply *reply,
+                                    SendReplyCallback send_reply_callback) = 0;
+
+  virtual void HandleCreateActors(const CreateActorsRequest &request,
+                                  CreateActorsReply *reply,
+                                  SendReplyCallback send_reply_callback) = 0;
+
   virtual void HandleGetActorInfo(const GetActorInfoRequest &request,
                                   GetActorInfoReply *reply,
                                   SendReplyCallback send_reply_callback) = 0;
@@ -145,6 +156,8 @@ class ActorInfoGrpcService : public GrpcService {
       std::vector<std::unique_ptr<ServerCallFactory>> *server_call_factories) override {
     ACTOR_INFO_SERVICE_RPC_HANDLER(RegisterActor);
     ACTOR_INFO_SERVICE_RPC_HANDLER(CreateActor);
+    ACTOR_INFO_SERVICE_RPC_HANDLER(RegisterActors);
+    ACTOR_INFO_SERVICE_RPC_HANDLER(CreateActors);
     ACTOR_INFO_SERVICE_RPC_HANDLER(GetActorInfo);
     ACTOR_INFO_SERVICE_RPC_HANDLER(GetNamedActorInfo);
     ACTOR_INFO_SERVICE_RPC_HANDLER(GetAllActorInfo);
@@ -554,6 +567,41 @@ class PlacementGroupInfoGrpcService : public GrpcService {
   PlacementGroupInfoGcsServiceHandler &service_handler_;
 };
 
+class GcsStandbyServiceHandler {
+ public:
+  virtual ~GcsStandbyServiceHandler() = default;
+
+  virtual void HandleReplicateWrites(const ReplicateWritesRequest &request,
+                                     ReplicateWritesReply *reply,
+                                     SendReplyCallback send_reply_callback) = 0;
+};
+
+/// The `GrpcService` for `GcsStandbyService`.
+class GcsStandbyGrpcService : public GrpcService {
+ public:
+  /// Constructor.
+  ///
+  /// \param[in] handler The service handler that actually handle the requests.
+  explicit GcsStandbyGrpcService(boost::asio::io_service &io_service,
+                                 GcsStandbyServiceHandler &handler)
+      : GrpcService(io_service), service_handler_(handler){};
+
+ protected:
+  grpc::Service &GetGrpcService() override { return service_; }
+
+  void InitServerCallFactories(
+      const std::unique_ptr<grpc::ServerCompletionQueue> &cq,
+      std::vector<std::unique_ptr<ServerCallFactory>> *server_call_factories) override {
+    GCS_STANDBY_SERVICE_RPC_HANDLER(ReplicateWrites);
+  }
+
+ private:
+  /// The grpc async service object.
+  GcsStandbyService::AsyncService service_;
+  /// The service handler that actually handle the requests.
+  GcsStandbyServiceHandler &service_handler_;
+};
+
 using JobInfoHandler = JobInfoGcsServiceHandler;
 using ActorInfoHandler = ActorInfoGcsServiceHandler;
 using NodeInfoHandler = NodeInfoGcsServiceHandler;
@@ -564,6 +612,7 @@ using TaskInfoHandler = TaskInfoGcsServiceHandler;
 using StatsHandler = StatsGcsServiceHandler;
 using WorkerInfoHandler = WorkerInfoGcsServiceHandler;
 using PlacementGroupInfoHandler = PlacementGroupInfoGcsServiceHandler;
+using GcsStandbyHandler = GcsStandbyServiceHandler;
 
 }  // namespace rpc
 }  // namespace ray
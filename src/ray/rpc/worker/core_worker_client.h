@@ -53,6 +53,15 @@ const static int64_t RequestSizeInBytes(const PushTaskRequest &request) {
   return size;
 }
 
+/// Get the estimated size in bytes of the given batch of tasks.
+const static int64_t RequestSizeInBytes(const PushTasksRequest &request) {
+  int64_t size = 0;
+  for (const auto &task_request : request.requests()) {
+    size += RequestSizeInBytes(task_request);
+  }
+  return size;
+}
+
 // Shared between direct actor and task submitters.
 class CoreWorkerClientInterface;
 
@@ -114,11 +123,28 @@ class CoreWorkerClientInterface {
   virtual void PushActorTask(std::unique_ptr<PushTaskRequest> request, bool skip_queue,
                              const ClientCallback<PushTaskReply> &callback) {}
 
+  /// Push a batch of actor tasks directly from worker to worker. The batch is queued
+  /// and sent like a single actor task, and the reply is sent once all of the tasks
+  /// are done, or as soon as one fails.
+  ///
+  /// \param[in] request The request message.
+  /// \param[in] callback The callback function that handles reply.
+  virtual void PushActorTasks(std::unique_ptr<PushTasksRequest> request,
+                              const ClientCallback<PushTasksReply> &callback) {}
+
   /// Similar to PushActorTask, but sets no ordering constraint. This is used to
   /// push non-actor tasks directly to a worker.
   virtual void PushNormalTask(std::unique_ptr<PushTaskRequest> request,
                               const ClientCallback<PushTaskReply> &callback) {}
 
+  /// Push a batch of non-actor tasks directly to a worker. The tasks are executed in
+  /// order, and the reply is sent once all of them are done, or as soon as one fails.
+  ///
+  /// \param[in] request The request message.
+  /// \param[in] callback The callback function that handles reply.
+  virtual void PushNormalTasks(std::unique_ptr<PushTasksRequest> request,
+                               const ClientCallback<PushTasksReply> &callback) {}
+
   /// Notify a wait has completed for direct actor call arguments.
   ///
   /// \param[in] request The request message.
@@ -154,6 +180,10 @@ class CoreWorkerClientInterface {
       const GetObjectLocationsOwnerRequest &request,
       const ClientCallback<GetObjectLocationsOwnerReply> &callback) {}
 
+  virtual void GetObjectLocationsUpdates(
+      const GetObjectLocationsUpdatesRequest &request,
+      const ClientCallback<GetObjectLocationsUpdatesReply> &callback) {}
+
   /// Tell this actor to exit immediately.
   virtual void KillActor(const KillActorRequest &request,
                          const ClientCallback<KillActorReply> &callback) {}
@@ -171,9 +201,9 @@ class CoreWorkerClientInterface {
   virtual void LocalGC(const LocalGCRequest &request,
                        const ClientCallback<LocalGCReply> &callback) {}
 
-  virtual void WaitForRefRemoved(const WaitForRefRemovedRequest &request,
-                                 const ClientCallback<WaitForRefRemovedReply> &callback) {
-  }
+  virtual void WaitForRefsRemoved(
+      const WaitForRefsRemovedRequest &request,
+      const ClientCallback<WaitForRefsRemovedReply> &callback) {}
 
   virtual void SpillObjects(const SpillObjectsRequest &request,
                             const ClientCallback<SpillObjectsReply> &callback) {}
@@ -239,11 +269,14 @@ class CoreWorkerClient : public std::enable_shared_from_this<CoreWorkerClient>,
   VOID_RPC_CLIENT_METHOD(CoreWorkerService, GetObjectLocationsOwner, grpc_client_,
                          override)
 
+  VOID_RPC_CLIENT_METHOD(CoreWorkerService, GetObjectLocationsUpdates, grpc_client_,
+                         override)
+
   VOID_RPC_CLIENT_METHOD(CoreWorkerService, GetCoreWorkerStats, grpc_client_, override)
 
   VOID_RPC_CLIENT_METHOD(CoreWorkerService, LocalGC, grpc_client_, override)
 
-  VOID_RPC_CLIENT_METHOD(CoreWorkerService, WaitForRefRemoved, grpc_client_, override)
+  VOID_RPC_CLIENT_METHOD(CoreWorkerService, WaitForRefsRemoved, grpc_client_, override)
 
   VOID_RPC_CLIENT_METHOD(CoreWorkerService, SpillObjects, grpc_client_, override)
 
@@ -268,7 +301,22 @@ class CoreWorkerClient : public std::enable_shared_from_this<CoreWorkerClient>,
 
     {
       absl::MutexLock lock(&mutex_);
-      send_queue_.push_back(std::make_pair(std::move(request), callback));
+      PendingPush push;
+      push.request = std::move(request);
+      push.callback = callback;
+      send_queue_.push_back(std::move(push));
+    }
+    SendRequests();
+  }
+
+  void PushActorTasks(std::unique_ptr<PushTasksRequest> request,
+                      const ClientCallback<PushTasksReply> &callback) override {
+    {
+      absl::MutexLock lock(&mutex_);
+      PendingPush push;
+      push.batch_request = std::move(request);
+      push.batch_callback = callback;
+      send_queue_.push_back(std::move(push));
     }
     SendRequests();
   }
@@ -280,6 +328,15 @@ class CoreWorkerClient : public std::enable_shared_from_this<CoreWorkerClient>,
     INVOKE_RPC_CALL(CoreWorkerService, PushTask, *request, callback, grpc_client_);
   }
 
+  void PushNormalTasks(std::unique_ptr<PushTasksRequest> request,
+                       const ClientCallback<PushTasksReply> &callback) override {
+    for (auto &task_request : *request->mutable_requests()) {
+      task_request.set_sequence_number(-1);
+      task_request.set_client_processed_up_to(-1);
+    }
+    INVOKE_RPC_CALL(CoreWorkerService, PushTasks, *request, callback, grpc_client_);
+  }
+
   /// Send as many pending tasks as possible. This method is thread-safe.
   ///
   /// The client will guarantee no more than kMaxBytesInFlight bytes of RPCs are being
@@ -290,11 +347,34 @@ class CoreWorkerClient : public std::enable_shared_from_this<CoreWorkerClient>,
     auto this_ptr = this->shared_from_this();
 
     while (!send_queue_.empty() && rpc_bytes_in_flight_ < kMaxBytesInFlight) {
-      auto pair = std::move(*send_queue_.begin());
+      auto push = std::move(send_queue_.front());
       send_queue_.pop_front();
 
-      auto request = std::move(pair.first);
-      auto callback = pair.second;
+      if (push.batch_request) {
+        // The tasks of a batch are in sequence number order, so the batch is done with
+        // the sequence number of its last task.
+        auto request = std::move(push.batch_request);
+        auto callback = push.batch_callback;
+        int64_t task_size = RequestSizeInBytes(*request);
+        int64_t seq_no = -1;
+        for (auto &task_request : *request->mutable_requests()) {
+          task_request.set_client_processed_up_to(max_finished_seq_no_);
+          seq_no = std::max(seq_no, task_request.sequence_number());
+        }
+        rpc_bytes_in_flight_ += task_size;
+
+        auto rpc_callback = [this, this_ptr, seq_no, task_size, callback](
+                                Status status, const rpc::PushTasksReply &reply) {
+          OnPushDone(seq_no, task_size);
+          callback(status, reply);
+        };
+        RAY_UNUSED(INVOKE_RPC_CALL(CoreWorkerService, PushTasks, *request, rpc_callback,
+                                   grpc_client_));
+        continue;
+      }
+
+      auto request = std::move(push.request);
+      auto callback = push.callback;
       int64_t task_size = RequestSizeInBytes(*request);
       int64_t seq_no = request->sequence_number();
       request->set_client_processed_up_to(max_finished_seq_no_);
@@ -302,15 +382,7 @@ class CoreWorkerClient : public std::enable_shared_from_this<CoreWorkerClient>,
 
       auto rpc_callback = [this, this_ptr, seq_no, task_size, callback](
                               Status status, const rpc::PushTaskReply &reply) {
-        {
-          absl::MutexLock lock(&mutex_);
-          if (seq_no > max_finished_seq_no_) {
-            max_finished_seq_no_ = seq_no;
-          }
-          rpc_bytes_in_flight_ -= task_size;
-          RAY_CHECK(rpc_bytes_in_flight_ >= 0);
-        }
-        SendRequests();
+        OnPushDone(seq_no, task_size);
         callback(status, reply);
       };
 
@@ -333,9 +405,30 @@ class CoreWorkerClient : public std::enable_shared_from_this<CoreWorkerClient>,
   /// The RPC client.
   std::unique_ptr<GrpcClient<CoreWorkerService>> grpc_client_;
 
+  /// An actor task push that is waiting to be sent. It holds either a single task or a
+  /// batch of tasks.
+  struct PendingPush {
+    std::unique_ptr<PushTaskRequest> request;
+    ClientCallback<PushTaskReply> callback;
+    std::unique_ptr<PushTasksRequest> batch_request;
+    ClientCallback<PushTasksReply> batch_callback;
+  };
+
+  /// Record that a push is done, and send the pushes that were waiting for it.
+  void OnPushDone(int64_t seq_no, int64_t task_size) LOCKS_EXCLUDED(mutex_) {
+    {
+      absl::MutexLock lock(&mutex_);
+      if (seq_no > max_finished_seq_no_) {
+        max_finished_seq_no_ = seq_no;
+      }
+      rpc_bytes_in_flight_ -= task_size;
+      RAY_CHECK(rpc_bytes_in_flight_ >= 0);
+    }
+    SendRequests();
+  }
+
   /// Queue of requests to send.
-  std::deque<std::pair<std::unique_ptr<PushTaskRequest>, ClientCallback<PushTaskReply>>>
-      send_queue_ GUARDED_BY(mutex_);
+  std::deque<PendingPush> send_queue_ GUARDED_BY(mutex_);
 
   /// The number of bytes currently in flight.
   int64_t rpc_bytes_in_flight_ GUARDED_BY(mutex_) = 0;
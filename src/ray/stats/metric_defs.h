@@ -79,6 +79,22 @@ static Histogram ProcessStartupTimeMs("process_startup_time_ms",
                                       "Time to start up a worker process.", "ms",
                                       {1, 10, 100, 1000, 10000});
 
+static Count WorkerPoolColdStarts(
+    "worker_pool_cold_starts",
+    "Number of worker leases for which no idle worker was available and a new worker "
+    "process had to be started.",
+    "leases");
+
+static Count WorkerPoolPrestartedWorkers(
+    "worker_pool_prestarted_workers",
+    "Number of worker processes started ahead of demand, for a task backlog or a "
+    "forecasted demand.",
+    "processes");
+
+static Count WorkerPoolKilledIdleWorkers("worker_pool_killed_idle_workers",
+                                         "Number of idle workers killed by the raylet.",
+                                         "workers");
+
 static Gauge AvgNumScheduledTasks(
     "avg_num_scheduled_tasks",
     "Number of tasks that are queued on this node per second. It doesn't guarantee "
@@ -0,0 +1,196 @@
+// Copyright 2017 The Ray Authors.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//  http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#pragma once
+
+#include <array>
+#include <functional>
+#include <vector>
+
+#include "absl/container/flat_hash_map.h"
+#include "absl/synchronization/mutex.h"
+
+namespace ray {
+
+/// \class ShardedMap
+///
+/// A concurrent hash map that is split into a fixed number of independently
+/// locked shards. Each shard is an `absl::flat_hash_map`, which probes its
+/// control bytes a group at a time with SIMD instructions. The same hash is
+/// used to select the shard and to probe within it. Ray IDs cache their hash
+/// inline, so neither step rehashes the ID's bytes after first use.
+///
+/// Operations on keys that fall into different shards never contend with each
+/// other. Values are returned by copy, so `V` should be cheap to copy (e.g. a
+/// `std::shared_ptr`). Operations that must observe several keys atomically
+/// need an external lock.
+template <typename K, typename V, typename Hash = std::hash<K>, size_t kNumShards = 64>
+class ShardedMap {
+  static_assert(kNumShards > 0 && (kNumShards & (kNumShards - 1)) == 0,
+                "The number of shards must be a power of two.");
+
+ public:
+  ShardedMap() {}
+
+  ShardedMap(const ShardedMap &other) = delete;
+
+  ShardedMap &operator=(const ShardedMap &other) = delete;
+
+  /// Insert a value if the key is not already present.
+  ///
+  /// \return Whether the value was inserted.
+  bool Insert(const K &key, V value) {
+    auto &shard = GetShard(key);
+    absl::MutexLock lock(&shard.mutex);
+    return shard.map.emplace(key, std::move(value)).second;
+  }
+
+  /// Insert a value, overwriting any existing value for the key.
+  void InsertOrAssign(const K &key, V value) {
+    auto &shard = GetShard(key);
+    absl::MutexLock lock(&shard.mutex);
+    shard.map[key] = std::move(value);
+  }
+
+  /// Look up a key.
+  ///
+  /// \param[out] value If not null, set to a copy of the value if found.
+  /// \return Whether the key was found.
+  bool Get(const K &key, V *value) const {
+    const auto &shard = GetShard(key);
+    absl::ReaderMutexLock lock(&shard.mutex);
+    auto it = shard.map.find(key);
+    if (it == shard.map.end()) {
+      return false;
+    }
+    if (value != nullptr) {
+      *value = it->second;
+    }
+    return true;
+  }
+
+  bool Contains(const K &key) const { return Get(key, nullptr); }
+
+  /// Run a function on the value of a key while holding its shard's lock.
+  /// The function must not access this map.
+  ///
+  /// \return Whether the key was found.
+  bool Update(const K &key, const std::function<void(V &)> &fn) {
+    auto &shard = GetShard(key);
+    absl::MutexLock lock(&shard.mutex);
+    auto it = shard.map.find(key);
+    if (it == shard.map.end()) {
+      return false;
+    }
+    fn(it->second);
+    return true;
+  }
+
+  /// Erase a key if it is present.
+  ///
+  /// \param[out] value If not null, set to the erased value if found.
+  /// \return Whether the key was erased.
+  bool Erase(const K &key, V *value = nullptr) {
+    auto &shard = GetShard(key);
+    absl::MutexLock lock(&shard.mutex);
+    auto it = shard.map.find(key);
+    if (it == shard.map.end()) {
+      return false;
+    }
+    if (value != nullptr) {
+      *value = std::move(it->second);
+    }
+    shard.map.erase(it);
+    return true;
+  }
+
+  /// Erase a key only if the predicate returns true for its current value.
+  ///
+  /// \return Whether the key was erased.
+  bool EraseIf(const K &key, const std::function<bool(const V &)> &predicate) {
+    auto &shard = GetShard(key);
+    absl::MutexLock lock(&shard.mutex);
+    auto it = shard.map.find(key);
+    if (it == shard.map.end() || !predicate(it->second)) {
+      return false;
+    }
+    shard.map.erase(it);
+    return true;
+  }
+
+  /// Visit every entry. Shards are locked one at a time, so this is not an
+  /// atomic snapshot of the whole map. The function must not access this map.
+  void ForEach(const std::function<void(const K &, const V &)> &fn) const {
+    for (const auto &shard : shards_) {
+      absl::ReaderMutexLock lock(&shard.mutex);
+      for (const auto &entry : shard.map) {
+        fn(entry.first, entry.second);
+      }
+    }
+  }
+
+  /// Return the total number of entries. Shards are locked one at a time.
+  size_t Size() const {
+    size_t size = 0;
+    for (const auto &shard : shards_) {
+      absl::ReaderMutexLock lock(&shard.mutex);
+      size += shard.map.size();
+    }
+    return size;
+  }
+
+  /// Pre-allocate space for the given total number of entries.
+  void Reserve(size_t size) {
+    for (auto &shard : shards_) {
+      absl::MutexLock lock(&shard.mutex);
+      shard.map.reserve(size / kNumShards + 1);
+    }
+  }
+
+  void Clear() {
+    for (auto &shard : shards_) {
+      absl::MutexLock lock(&shard.mutex);
+      shard.map.clear();
+    }
+  }
+
+  /// Return the shard index for a key. Exposed so that callers can keep
+  /// per-shard state of their own next to the map's shards.
+  static size_t ShardIndex(const K &key) { return ShardIndexForHash(Hash()(key)); }
+
+  static constexpr size_t NumShards() { return kNumShards; }
+
+ private:
+  struct Shard {
+    mutable absl::Mutex mutex;
+    absl::flat_hash_map<K, V, Hash> map;
+  };
+
+  /// Pick a shard from the high bits of the mixed hash. The flat hash map
+  /// consumes the low bits of the same hash for probing, so the shard choice
+  /// does not skew the slot distribution within a shard.
+  static size_t ShardIndexForHash(size_t hash) {
+    constexpr uint64_t kMul = 0x9E3779B97F4A7C15ULL;
+    return static_cast<size_t>((static_cast<uint64_t>(hash) * kMul) >> 32) &
+           (kNumShards - 1);
+  }
+
+  Shard &GetShard(const K &key) { return shards_[ShardIndex(key)]; }
+
+  const Shard &GetShard(const K &key) const { return shards_[ShardIndex(key)]; }
+
+  std::array<Shard, kNumShards> shards_;
+};
+
+}  // namespace ray
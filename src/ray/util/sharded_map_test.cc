@@ -0,0 +1,211 @@
+// Copyright 2017 The Ray Authors.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//  http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "ray/util/sharded_map.h"
+
+#include <chrono>
+#include <thread>
+#include <vector>
+
+#include "absl/container/flat_hash_set.h"
+#include "gtest/gtest.h"
+#include "ray/common/id.h"
+
+namespace ray {
+
+TEST(ShardedMapTest, TestBasicOperations) {
+  ShardedMap<ObjectID, int> map;
+  auto id1 = ObjectID::FromRandom();
+  auto id2 = ObjectID::FromRandom();
+
+  ASSERT_TRUE(map.Insert(id1, 1));
+  ASSERT_FALSE(map.Insert(id1, 2));
+  ASSERT_TRUE(map.Insert(id2, 3));
+  ASSERT_EQ(map.Size(), 2);
+
+  int value = 0;
+  ASSERT_TRUE(map.Get(id1, &value));
+  ASSERT_EQ(value, 1);
+  map.InsertOrAssign(id1, 4);
+  ASSERT_TRUE(map.Get(id1, &value));
+  ASSERT_EQ(value, 4);
+
+  ASSERT_TRUE(map.Update(id2, [](int &v) { v += 1; }));
+  ASSERT_TRUE(map.Get(id2, &value));
+  ASSERT_EQ(value, 4);
+  ASSERT_FALSE(map.Update(ObjectID::FromRandom(), [](int &v) { v += 1; }));
+
+  ASSERT_FALSE(map.EraseIf(id2, [](const int &v) { return v != 4; }));
+  ASSERT_TRUE(map.EraseIf(id2, [](const int &v) { return v == 4; }));
+  ASSERT_FALSE(map.Contains(id2));
+
+  ASSERT_TRUE(map.Erase(id1, &value));
+  ASSERT_EQ(value, 4);
+  ASSERT_FALSE(map.Erase(id1));
+  ASSERT_EQ(map.Size(), 0);
+}
+
+TEST(ShardedMapTest, TestForEachVisitsAllShards) {
+  ShardedMap<ObjectID, int> map;
+  map.Reserve(1000);
+  absl::flat_hash_set<size_t> shards_used;
+  for (int i = 0; i < 1000; i++) {
+    auto id = ObjectID::FromRandom();
+    shards_used.insert(decltype(map)::ShardIndex(id));
+    ASSERT_TRUE(map.Insert(id, i));
+  }
+  // Random IDs should be spread across all shards.
+  ASSERT_EQ(shards_used.size(), decltype(map)::NumShards());
+
+  int64_t sum = 0;
+  size_t count = 0;
+  map.ForEach([&sum, &count](const ObjectID &id, const int &v) {
+    sum += v;
+    count++;
+  });
+  ASSERT_EQ(count, 1000);
+  ASSERT_EQ(sum, 999 * 1000 / 2);
+
+  map.Clear();
+  ASSERT_EQ(map.Size(), 0);
+}
+
+TEST(ShardedMapTest, TestConcurrentInsertAndErase) {
+  ShardedMap<ObjectID, int> map;
+  const int num_threads = 8;
+  const int num_ids = 10000;
+  std::vector<std::vector<ObjectID>> ids(num_threads);
+  for (auto &thread_ids : ids) {
+    for (int i = 0; i < num_ids; i++) {
+      thread_ids.push_back(ObjectID::FromRandom());
+    }
+  }
+
+  std::vector<std::thread> threads;
+  for (int t = 0; t < num_threads; t++) {
+    threads.emplace_back([&map, &ids, t]() {
+      for (const auto &id : ids[t]) {
+        RAY_CHECK(map.Insert(id, t));
+      }
+      // Erase every other ID.
+      for (size_t i = 0; i < ids[t].size(); i += 2) {
+        RAY_CHECK(map.Erase(ids[t][i]));
+      }
+    });
+  }
+  for (auto &thread : threads) {
+    thread.join();
+  }
+
+  ASSERT_EQ(map.Size(), num_threads * num_ids / 2);
+  for (int t = 0; t < num_threads; t++) {
+    for (int i = 0; i < num_ids; i++) {
+      ASSERT_EQ(map.Contains(ids[t][i]), i % 2 == 1);
+    }
+  }
+}
+
+/// A baseline with the same interface as ShardedMap, protected by one mutex.
+/// This is how the hot object tables in the core worker were protected.
+template <typename K, typename V>
+class SingleMutexMap {
+ public:
+  bool Insert(const K &key, V value) {
+    absl::MutexLock lock(&mutex_);
+    return map_.emplace(key, std::move(value)).second;
+  }
+
+  bool Get(const K &key, V *value) const {
+    absl::MutexLock lock(&mutex_);
+    auto it = map_.find(key);
+    if (it == map_.end()) {
+      return false;
+    }
+    *value = it->second;
+    return true;
+  }
+
+  bool Erase(const K &key) {
+    absl::MutexLock lock(&mutex_);
+    return map_.erase(key) > 0;
+  }
+
+  void Reserve(size_t size) {
+    absl::MutexLock lock(&mutex_);
+    map_.reserve(size);
+  }
+
+ private:
+  mutable absl::Mutex mutex_;
+  absl::flat_hash_map<K, V> map_;
+};
+
+template <typename Map>
+int64_t RunBenchmark(const std::vector<ObjectID> &ids, int num_threads) {
+  Map map;
+  map.Reserve(ids.size());
+  auto start = std::chrono::steady_clock::now();
+  std::vector<std::thread> threads;
+  size_t per_thread = ids.size() / num_threads;
+  for (int t = 0; t < num_threads; t++) {
+    threads.emplace_back([&map, &ids, t, per_thread]() {
+      size_t begin = t * per_thread;
+      size_t end = begin + per_thread;
+      int value = 0;
+      for (size_t i = begin; i < end; i++) {
+        map.Insert(ids[i], static_cast<int>(i));
+      }
+      for (size_t i = begin; i < end; i++) {
+        map.Get(ids[i], &value);
+      }
+      for (size_t i = begin; i < end; i++) {
+        map.Erase(ids[i]);
+      }
+    });
+  }
+  for (auto &thread : threads) {
+    thread.join();
+  }
+  return std::chrono::duration_cast<std::chrono::milliseconds>(
+             std::chrono::steady_clock::now() - start)
+      .count();
+}
+
+// This is a microbenchmark over 10M ObjectIDs. Run it with
+// --gtest_also_run_disabled_tests.
+TEST(ShardedMapTest, DISABLED_BenchmarkObjectIDMap) {
+  const size_t num_ids = 10 * 1000 * 1000;
+  std::vector<ObjectID> ids;
+  ids.reserve(num_ids);
+  for (size_t i = 0; i < num_ids; i++) {
+    ids.push_back(ObjectID::FromRandom());
+    // Populate the cached hash up front, as a long-lived ID would have.
+    ids.back().Hash();
+  }
+
+  for (int num_threads : {1, 4, 16}) {
+    auto single_ms = RunBenchmark<SingleMutexMap<ObjectID, int>>(ids, num_threads);
+    auto sharded_ms = RunBenchmark<ShardedMap<ObjectID, int>>(ids, num_threads);
+    RAY_LOG(INFO) << num_threads << " thread(s), " << num_ids
+                  << " insert/get/erase: single mutex " << single_ms << "ms, sharded "
+                  << sharded_ms << "ms";
+  }
+}
+
+}  // namespace ray
+
+int main(int argc, char **argv) {
+  ::testing::InitGoogleTest(&argc, argv);
+  return RUN_ALL_TESTS();
+}
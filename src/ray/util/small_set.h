@@ -0,0 +1,172 @@
+// Copyright 2017 The Ray Authors.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//  http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#pragma once
+
+#include <algorithm>
+#include <functional>
+#include <memory>
+#include <utility>
+
+#include "absl/container/flat_hash_map.h"
+#include "absl/container/inlined_vector.h"
+
+namespace ray {
+
+/// \class SmallSet
+///
+/// A set that stores up to `N` elements inline, without a heap allocation. It is meant
+/// for sets that almost always hold zero or one element, where an empty
+/// `absl::flat_hash_set` alone is as large as several elements.
+///
+/// The elements are kept in a vector and looked up by a linear scan. Once the set grows
+/// past `kIndexThreshold` elements, a hash index from element to position is built, so
+/// that large sets keep constant time lookups. Erasing moves the last element into the
+/// erased position, so the iteration order is not stable across erases. Elements are
+/// only exposed as const, and iterators are invalidated by any insert or erase.
+template <typename T, size_t N = 1, typename Hash = std::hash<T>>
+class SmallSet {
+ public:
+  using value_type = T;
+  using const_iterator = typename absl::InlinedVector<T, N>::const_iterator;
+  using iterator = const_iterator;
+
+  /// The number of elements above which lookups go through a hash index.
+  static constexpr size_t kIndexThreshold = 16;
+
+  SmallSet() {}
+
+  SmallSet(std::initializer_list<T> values) {
+    for (const auto &value : values) {
+      insert(value);
+    }
+  }
+
+  SmallSet(const SmallSet &other) : elements_(other.elements_) { MaybeBuildIndex(); }
+
+  SmallSet &operator=(const SmallSet &other) {
+    if (this != &other) {
+      elements_ = other.elements_;
+      index_.reset();
+      MaybeBuildIndex();
+    }
+    return *this;
+  }
+
+  SmallSet(SmallSet &&other) = default;
+
+  SmallSet &operator=(SmallSet &&other) = default;
+
+  /// Insert an element if it is not already present.
+  ///
+  /// \return An iterator to the element, and whether it was inserted.
+  std::pair<const_iterator, bool> insert(const T &value) {
+    auto it = find(value);
+    if (it != end()) {
+      return {it, false};
+    }
+    elements_.push_back(value);
+    if (index_) {
+      index_->emplace(value, elements_.size() - 1);
+    } else {
+      MaybeBuildIndex();
+    }
+    return {end() - 1, true};
+  }
+
+  /// Erase an element.
+  ///
+  /// \return The number of elements erased, 0 or 1.
+  size_t erase(const T &value) {
+    auto it = find(value);
+    if (it == end()) {
+      return 0;
+    }
+    const size_t position = it - begin();
+    if (index_) {
+      index_->erase(value);
+    }
+    if (position != elements_.size() - 1) {
+      elements_[position] = std::move(elements_.back());
+      if (index_) {
+        (*index_)[elements_[position]] = position;
+      }
+    }
+    elements_.pop_back();
+    if (index_ && elements_.size() <= kIndexThreshold / 2) {
+      index_.reset();
+    }
+    return 1;
+  }
+
+  const_iterator find(const T &value) const {
+    if (index_) {
+      auto it = index_->find(value);
+      return it == index_->end() ? end() : begin() + it->second;
+    }
+    return std::find(begin(), end(), value);
+  }
+
+  size_t count(const T &value) const { return find(value) != end() ? 1 : 0; }
+
+  bool contains(const T &value) const { return find(value) != end(); }
+
+  void clear() {
+    elements_.clear();
+    elements_.shrink_to_fit();
+    index_.reset();
+  }
+
+  size_t size() const noexcept { return elements_.size(); }
+
+  bool empty() const noexcept { return elements_.empty(); }
+
+  const_iterator begin() const noexcept { return elements_.begin(); }
+
+  const_iterator end() const noexcept { return elements_.end(); }
+
+  /// The number of bytes this set has allocated on the heap, not counting the memory
+  /// owned by the elements themselves.
+  size_t HeapBytes() const {
+    size_t bytes = 0;
+    if (elements_.capacity() > N) {
+      bytes += elements_.capacity() * sizeof(T);
+    }
+    if (index_) {
+      bytes += sizeof(*index_) +
+               index_->capacity() * (sizeof(std::pair<const T, size_t>) + 1);
+    }
+    return bytes;
+  }
+
+ private:
+  void MaybeBuildIndex() {
+    if (index_ || elements_.size() <= kIndexThreshold) {
+      return;
+    }
+    index_.reset(new absl::flat_hash_map<T, size_t, Hash>());
+    index_->reserve(elements_.size());
+    for (size_t i = 0; i < elements_.size(); i++) {
+      index_->emplace(elements_[i], i);
+    }
+  }
+
+  /// The elements, in no particular order.
+  absl::InlinedVector<T, N> elements_;
+  /// A map from each element to its position in `elements_`. Only set when the set has
+  /// more than `kIndexThreshold` elements.
+  std::unique_ptr<absl::flat_hash_map<T, size_t, Hash>> index_;
+};
+
+}  // namespace ray
@@ -0,0 +1,90 @@
+// Copyright 2017 The Ray Authors.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//  http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "ray/util/small_set.h"
+
+#include <vector>
+
+#include "absl/container/flat_hash_set.h"
+#include "gtest/gtest.h"
+#include "ray/common/id.h"
+
+namespace ray {
+
+TEST(SmallSetTest, TestBasicOperations) {
+  SmallSet<ObjectID> set;
+  auto id1 = ObjectID::FromRandom();
+  auto id2 = ObjectID::FromRandom();
+  ASSERT_TRUE(set.empty());
+  ASSERT_EQ(set.HeapBytes(), 0);
+
+  ASSERT_TRUE(set.insert(id1).second);
+  ASSERT_FALSE(set.insert(id1).second);
+  ASSERT_EQ(set.size(), 1);
+  // A single element is stored inline.
+  ASSERT_EQ(set.HeapBytes(), 0);
+  ASSERT_TRUE(set.contains(id1));
+  ASSERT_EQ(set.count(id2), 0);
+
+  ASSERT_TRUE(set.insert(id2).second);
+  ASSERT_EQ(set.size(), 2);
+  ASSERT_GT(set.HeapBytes(), 0);
+  ASSERT_EQ(set.erase(id1), 1);
+  ASSERT_EQ(set.erase(id1), 0);
+  ASSERT_EQ(set.size(), 1);
+  ASSERT_EQ(*set.begin(), id2);
+
+  SmallSet<ObjectID> copy(set);
+  set.clear();
+  ASSERT_TRUE(set.empty());
+  ASSERT_TRUE(copy.contains(id2));
+}
+
+TEST(SmallSetTest, TestLargeSet) {
+  const size_t num_elements = 10 * SmallSet<ObjectID>::kIndexThreshold;
+  SmallSet<ObjectID> set;
+  std::vector<ObjectID> ids;
+  for (size_t i = 0; i < num_elements; i++) {
+    ids.push_back(ObjectID::FromRandom());
+    ASSERT_TRUE(set.insert(ids.back()).second);
+  }
+  ASSERT_EQ(set.size(), num_elements);
+  SmallSet<ObjectID> copy = set;
+
+  // Erase every other element, which moves elements around in the set.
+  for (size_t i = 0; i < num_elements; i += 2) {
+    ASSERT_EQ(set.erase(ids[i]), 1);
+  }
+  for (size_t i = 0; i < num_elements; i++) {
+    ASSERT_EQ(set.contains(ids[i]), i % 2 == 1);
+    ASSERT_TRUE(copy.contains(ids[i]));
+  }
+  absl::flat_hash_set<ObjectID> remaining(set.begin(), set.end());
+  ASSERT_EQ(remaining.size(), num_elements / 2);
+
+  // Shrink the set back below the index threshold.
+  for (size_t i = 1; i < num_elements - 2; i += 2) {
+    ASSERT_EQ(set.erase(ids[i]), 1);
+  }
+  ASSERT_EQ(set.size(), 1);
+  ASSERT_TRUE(set.contains(ids[num_elements - 1]));
+  ASSERT_FALSE(set.insert(ids[num_elements - 1]).second);
+}
+
+}  // namespace ray
+
+int main(int argc, char **argv) {
+  ::testing::InitGoogleTest(&argc, argv);
+  return RUN_ALL_TESTS();
+}